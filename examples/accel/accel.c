@@ -2,13 +2,18 @@
  * @file
  * @brief Accelerometer example for EFM32_Gxxx_DK
  * @details
- *   Use ADC/DMA in order to read accelerometer. Only one (X) axis used to
- *   indicate tilt on board, using leds.
+ *   Use TIMER/PRS/ADC/DMA in order to read accelerometer. Only one (X) axis
+ *   used to indicate tilt on board, using leds.
  *
  * @par Usage
  *   Hold the DK in front, with display in normal viewing position. Tilt
  *   DK left/right to move user LEDs.
  *
+ *   To calibrate, hold the DK still in normal viewing position and press
+ *   PB1, all LEDs are lit while calibrating (appr. 1.3 seconds). Repeat with
+ *   the DK lying flat to also measure the offset of the vertical axis. The
+ *   calibration is kept in the user data page.
+ *
  * @author Energy Micro AS
  * @version 3.20.0
  *******************************************************************************
@@ -40,6 +45,8 @@
  * arising from your use of this Software.
  *
  *****************************************************************************/
+#include <stddef.h>
+#include <string.h>
 #include "bsp.h"
 #include "bsp_trace.h"
 #include "em_chip.h"
@@ -47,8 +54,55 @@
 #include "em_cmu.h"
 #include "em_adc.h"
 #include "em_dma.h"
-#include "rtcdrv.h"
+#include "em_int.h"
+#include "em_msc.h"
+#include "em_prs.h"
+#include "em_timer.h"
 #include "dmactrl.h"
+#include "accelblock.h"
+
+/*
+   Accelerometer sampling:
+   -----------------------
+
+   +------+     +-----+     +------+     +-----+     +----------+
+   |TIMER0|---->| PRS |---->| ADC0 |---->| DMA |---->| Buffer 1 |
+   +------+     +-----+     +------+     +-----+  |  +----------+
+                                            |     |  +----------+
+                                            |     +->| Buffer 2 |
+                                            V        +----------+
+                                         +-----+          |
+                                         | DMA |          V
+                                         | IRQ |     Main loop, process
+                                         +-----+     block, update leds
+
+   1. TIMER0 overflows ACCEL_SAMPLE_RATE times per second, each overflow
+      pulsing PRS channel ACCEL_PRS_CHANNEL.
+
+   2. ADC0 starts a scan sequence of the X, Y and Z axis on each PRS pulse.
+
+   3. The DMA uses a ping-pong transfer to move the scan results into two
+      buffers of ACCEL_BLOCK_SCANS scans, in turn. When a buffer is full, the
+      DMA interrupt refreshes it for reuse and wakes up the main loop, which
+      processes the block while the DMA fills the other buffer.
+
+   The core thus wakes up once per block, instead of polling the ADC for
+   each scan. Sleep is EM1 since TIMER0, ADC0 and DMA need the HFPER clock,
+   the former loop slept in EM2 between single scans. Block processing is
+   done by accelblock.c, which can be run off target on recorded traces, see
+   host/accelrun.c.
+
+   Each axis is sampled at 400 Hz and decimated to 25 Hz by a CIC filter,
+   tilt is the angle of the calibrated X axis from horizontal.
+
+   Calibration storage:
+   --------------------
+
+   The calibration is stored in the user data page at ACCEL_CAL_OFFSET,
+   with a magic word and a check word. The first word of the page enables
+   eA Profiler trace (see BSP_TraceProfilerSetup()), so the page is copied
+   to RAM before erase and written back with the new calibration.
+*/
 
 /*******************************************************************************
  *******************************   DEFINES   ***********************************
@@ -57,6 +111,99 @@
 /** DMA channel used for scan sequence sampling accelerometer. */
 #define ACCEL_DMA_CHANNEL           0
 
+/** PRS channel used by TIMER to trigger ADC scan. */
+#define ACCEL_PRS_CHANNEL           0
+
+/** Scan sequences per second. */
+#define ACCEL_SAMPLE_RATE           400
+
+/**
+ * Scan sequences per DMA buffer. The block rate, appr. 12 per second, sets
+ * the speed of led movement.
+ */
+#define ACCEL_BLOCK_SCANS           32
+
+/** Offset of calibration record in user data page. */
+#define ACCEL_CAL_OFFSET            0x100
+
+/** Magic word of calibration record. */
+#define ACCEL_CAL_MAGIC             0x41434331
+
+/*******************************************************************************
+ *******************************   TYPEDEFS   **********************************
+ ******************************************************************************/
+
+/** Calibration record in user data page. */
+typedef struct
+{
+  uint32_t               magic;
+  ACCELBLOCK_Cal_TypeDef cal;
+  /** Complement of sum of preceding words. */
+  uint32_t               check;
+} ACCEL_CalRecord_TypeDef;
+
+/*******************************************************************************
+ ******************************   VARIABLES   **********************************
+ ******************************************************************************/
+
+/** Primary DMA buffer, X, Y and Z interleaved. */
+static uint16_t accelBuffer1[ACCEL_BLOCK_SCANS * ACCELBLOCK_AXES];
+/** Alternate DMA buffer, X, Y and Z interleaved. */
+static uint16_t accelBuffer2[ACCEL_BLOCK_SCANS * ACCELBLOCK_AXES];
+
+/** Callback config for DMA channel. */
+static DMA_CB_TypeDef cbData;
+
+/** Number of blocks filled by DMA. */
+static volatile uint32_t accelBlockCount;
+
+/** Variable indicate if primary or alternate buffer was filled last */
+static volatile bool accelProcessPrimary;
+
+/** Block processing state. */
+static ACCELBLOCK_State_TypeDef accelBlock;
+
+/*
+ * Monitor counters, for inspection with a debugger. Blocks filled again
+ * before the main loop got to process them are counted as overruns.
+ */
+
+/** Number of blocks processed. */
+static uint32_t accelMonProcessCount;
+/** Number of blocks skipped by processing. */
+static uint32_t accelMonOverrunCount;
+/** Core cycles used per scan by latest block processed. */
+static uint32_t accelMonCyclesPerScan;
+/** Status of latest calibration, see ACCELBLOCK_calibrateStatus(). */
+static int accelMonCalStatus;
+
+/*******************************************************************************
+ ************************   INTERRUPT FUNCTIONS   ******************************
+ ******************************************************************************/
+
+/***************************************************************************//**
+ * @brief
+ *   Callback invoked from DMA interrupt handler when DMA transfer has filled
+ *   a buffer with ACCEL_BLOCK_SCANS scans.
+ *******************************************************************************/
+static void accelDMACb(unsigned int channel, bool primary, void *user)
+{
+  (void)user; /* Unused parameter */
+
+  /* Refresh DMA for using this buffer. DMA ping-pong will */
+  /* halt if buffer not refreshed in time. */
+  DMA_RefreshPingPong(channel,
+                      primary,
+                      false,
+                      NULL,
+                      NULL,
+                      (ACCEL_BLOCK_SCANS * ACCELBLOCK_AXES) - 1,
+                      false);
+
+  /* Indicate buffer to be processed next */
+  accelProcessPrimary = primary;
+  accelBlockCount++;
+}
 
 /*******************************************************************************
  ***************************   LOCAL FUNCTIONS   *******************************
@@ -76,7 +223,10 @@ static void accelADCConfig(void)
   init.prescale = ADC_PrescaleCalc(4000000, 0);
   ADC_Init(ADC0, &init);
 
-  /* Init for scan sequence use (accelerometer X, Y and Z axis). */
+  /* Init for scan sequence use (accelerometer X, Y and Z axis), started */
+  /* by PRS pulse from TIMER0. */
+  scanInit.prsSel = adcPRSSELCh0;
+  scanInit.prsEnable = true;
   scanInit.reference = adcRefVDD;
   scanInit.input = ADC_SCANCTRL_INPUTMASK_CH2 |
                    ADC_SCANCTRL_INPUTMASK_CH3 |
@@ -101,18 +251,124 @@ static void accelDMAConfig(void)
   DMA_Init(&dmaInit);
 
   /* Configure DMA channel used */
+  cbData.cbFunc = accelDMACb;
+  cbData.userPtr = NULL;
+
   chnlCfg.highPri = false;
-  chnlCfg.enableInt = false;
+  chnlCfg.enableInt = true;
   chnlCfg.select = DMAREQ_ADC0_SCAN;
-  chnlCfg.cb = NULL;
+  chnlCfg.cb = &cbData;
   DMA_CfgChannel(ACCEL_DMA_CHANNEL, &chnlCfg);
 
-  descrCfg.dstInc = dmaDataInc4;
+  descrCfg.dstInc = dmaDataInc2;
   descrCfg.srcInc = dmaDataIncNone;
-  descrCfg.size = dmaDataSize4;
+  descrCfg.size = dmaDataSize2;
   descrCfg.arbRate = dmaArbitrate1;
   descrCfg.hprot = 0;
   DMA_CfgDescr(ACCEL_DMA_CHANNEL, true, &descrCfg);
+  DMA_CfgDescr(ACCEL_DMA_CHANNEL, false, &descrCfg);
+
+  DMA_ActivatePingPong(ACCEL_DMA_CHANNEL,
+                       false,
+                       accelBuffer1,
+                       (void *)((uint32_t)&(ADC0->SCANDATA)),
+                       (ACCEL_BLOCK_SCANS * ACCELBLOCK_AXES) - 1,
+                       accelBuffer2,
+                       (void *)((uint32_t)&(ADC0->SCANDATA)),
+                       (ACCEL_BLOCK_SCANS * ACCELBLOCK_AXES) - 1);
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *   Calculate check word of calibration record.
+ *******************************************************************************/
+static uint32_t accelCalCheck(const ACCEL_CalRecord_TypeDef *rec)
+{
+  const uint32_t *word = (const uint32_t *)rec;
+  uint32_t sum = 0;
+  unsigned int i;
+
+  for (i = 0; i < (offsetof(ACCEL_CalRecord_TypeDef, check) / 4); i++)
+  {
+    sum += word[i];
+  }
+  return ~sum;
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *   Load calibration from user data page.
+ *
+ * @param[out] cal
+ *   Calibration read.
+ *
+ * @return
+ *   true if a valid calibration was found.
+ *******************************************************************************/
+static bool accelCalLoad(ACCELBLOCK_Cal_TypeDef *cal)
+{
+  const ACCEL_CalRecord_TypeDef *rec =
+    (const ACCEL_CalRecord_TypeDef *)(USERDATA_BASE + ACCEL_CAL_OFFSET);
+
+  if ((rec->magic != ACCEL_CAL_MAGIC) || (rec->check != accelCalCheck(rec)))
+  {
+    return false;
+  }
+  *cal = rec->cal;
+  return true;
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *   Store calibration in user data page, keeping other content of page.
+ *
+ * @param[in] cal
+ *   Calibration to store.
+ *
+ * @return
+ *   true if stored.
+ *******************************************************************************/
+static bool accelCalSave(const ACCELBLOCK_Cal_TypeDef *cal)
+{
+  static uint32_t page[FLASH_PAGE_SIZE / 4];
+  ACCEL_CalRecord_TypeDef *rec =
+    (ACCEL_CalRecord_TypeDef *)((uint8_t *)page + ACCEL_CAL_OFFSET);
+  msc_Return_TypeDef ret;
+
+  memcpy(page, (void *)USERDATA_BASE, sizeof(page));
+  rec->magic = ACCEL_CAL_MAGIC;
+  rec->cal = *cal;
+  rec->check = accelCalCheck(rec);
+
+  MSC_Init();
+  ret = MSC_ErasePage((uint32_t *)USERDATA_BASE);
+  if (ret == mscReturnOk)
+  {
+    ret = MSC_WriteWord((uint32_t *)USERDATA_BASE, page, sizeof(page));
+  }
+  MSC_Deinit();
+
+  return ret == mscReturnOk;
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *   Configure PRS usage for this application.
+ *
+ * @param[in] prsChannel
+ *   PRS channel to use.
+ *******************************************************************************/
+static void accelPRSConfig(unsigned int prsChannel)
+{
+  PRS_LevelSet(0, 1 << (prsChannel + _PRS_SWLEVEL_CH0LEVEL_SHIFT));
+  PRS_SourceSignalSet(prsChannel,
+                      PRS_CH_CTRL_SOURCESEL_TIMER0,
+                      PRS_CH_CTRL_SIGSEL_TIMER0OF,
+                      prsEdgePos);
 }
 
 
@@ -122,33 +378,18 @@ static void accelDMAConfig(void)
 
 int main(void)
 {
-  /** Number of samples/channels taken from accelerometer. */
-  #define ACCEL_SAMPLES               3
-
-  /** X axis sample index. */
-  #define ACCEL_X                     0
-  /** Y axis sample index. */
-  #define ACCEL_Y                     1
-  /** Z axis sample index. */
-  #define ACCEL_Z                     2
-
-  /*
-   * Tilt levels: Midpoint is theoretically half value of max sampling value
-   * (ie 0x800 for 12 bit sampling). In real world, some sort of calibration
-   * is required if more accurate sensing is required. We just use set some
-   * fixed limit, that should be sufficient for this basic example.
-   */
-
-  /** Tilt left limit */
-  #define TILT_LEFT                   0x750
-  /** Tilt right limit */
-  #define TILT_RIGHT                  0x8b0
-
+  TIMER_Init_TypeDef timerInit = TIMER_INIT_DEFAULT;
   SYSTEM_ChipRevision_TypeDef chipRev;
+  ACCELBLOCK_Cal_TypeDef cal;
+  uint32_t processed = 0;
+  uint32_t blocks;
   uint32_t leds;
-  uint32_t samples[ACCEL_SAMPLES];
+  uint32_t start;
+  uint16_t buttons;
+  uint16_t prevButtons = 0;
+  bool calibrating = false;
+  bool primary;
   int errataShift = 0;
-  int i;
 
   /* Chip revision alignment and errata fixes */
   CHIP_Init();
@@ -161,6 +402,11 @@ int main(void)
     errataShift = 1;
   }
 
+  /* Use stored calibration if any, else nominal values */
+  ACCELBLOCK_init(&accelBlock,
+                  errataShift,
+                  accelCalLoad(&cal) ? &cal : NULL);
+
   /* Initialize DK board register access */
   BSP_Init(BSP_INIT_DEFAULT);
 
@@ -173,71 +419,77 @@ int main(void)
   /* Enable clocks required */
   CMU_ClockEnable(cmuClock_HFPER, true);
   CMU_ClockEnable(cmuClock_ADC0, true);
+  CMU_ClockEnable(cmuClock_PRS, true);
   CMU_ClockEnable(cmuClock_DMA, true);
+  CMU_ClockEnable(cmuClock_TIMER0, true);
 
-  /* Configure ADC and DMA used for scanning accelerometer */
-  accelADCConfig();
+  /* Enable cycle counter, used to measure processing time */
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+  /* Configure PRS, ADC and DMA used for scanning accelerometer */
+  accelPRSConfig(ACCEL_PRS_CHANNEL);
   accelDMAConfig();
+  accelADCConfig();
+
+  /* Trigger scans according to configured sample rate */
+  TIMER_TopSet(TIMER0, CMU_ClockFreqGet(cmuClock_HFPER) / ACCEL_SAMPLE_RATE);
+  TIMER_Init(TIMER0, &timerInit);
 
-  /* Main loop, keep polling accelerometer */
-  leds = 0x0180;
+  /* Main loop, process each block filled by DMA */
+  BSP_LedsSet((uint16_t)accelBlock.leds);
   while (1)
   {
-    DMA_ActivateBasic(ACCEL_DMA_CHANNEL,
-                      true,
-                      false,
-                      samples,
-                      (void *)((uint32_t)&(ADC0->SCANDATA)),
-                      ACCEL_SAMPLES - 1);
-
-    /* Scan all axis', even though this app only use the X axis */
-    ADC_IntClear(ADC0, ADC_IF_SCAN);
-    ADC_Start(ADC0, adcStartScan);
-
-    /* Poll for completion, entering EM2 when waiting for next poll */
-    while (!(ADC_IntGet(ADC0) & ADC_IF_SCAN))
+    /* Sleep until next block. An interrupt occurring after the check still */
+    /* wakes up the core, it is serviced when interrupts are enabled again. */
+    INT_Disable();
+    if (processed == accelBlockCount)
     {
-      RTCDRV_Trigger(5, NULL);
-      EMU_EnterEM2(true);
+      EMU_EnterEM1();
     }
+    blocks = accelBlockCount;
+    primary = accelProcessPrimary;
+    INT_Enable();
 
-    if (errataShift)
+    if (blocks == processed)
     {
-      for (i = 0; i < ACCEL_SAMPLES; i++)
-      {
-        samples[i] <<= errataShift;
-      }
+      continue;
     }
 
-    if (samples[ACCEL_X] < TILT_LEFT)
-    {
-      if (leds < 0xc000)
-      {
-        leds <<= 1;
-      }
-    }
-    else if (samples[ACCEL_X] > TILT_RIGHT)
+    /* Only latest block is processed if more than one has been filled */
+    accelMonOverrunCount += blocks - processed - 1;
+    processed = blocks;
+
+    start = DWT->CYCCNT;
+    leds = ACCELBLOCK_process(&accelBlock,
+                              primary ? accelBuffer1 : accelBuffer2,
+                              ACCEL_BLOCK_SCANS);
+    accelMonCyclesPerScan = (DWT->CYCCNT - start) / ACCEL_BLOCK_SCANS;
+    accelMonProcessCount++;
+
+    /* Calibration done, store it if successful */
+    if (calibrating)
     {
-      if (leds > 0x0003)
+      accelMonCalStatus = ACCELBLOCK_calibrateStatus(&accelBlock);
+      if (accelMonCalStatus != ACCELBLOCK_CAL_BUSY)
       {
-        leds >>= 1;
+        calibrating = false;
+        if (accelMonCalStatus == 0)
+        {
+          accelCalSave(&accelBlock.cal);
+        }
       }
     }
-    else
+
+    /* Start calibration when PB1 pressed */
+    buttons = BSP_PushButtonsGet();
+    if ((buttons & ~prevButtons & BC_UIF_PB1) && !calibrating)
     {
-      if (leds > 0x0180)
-      {
-        leds >>= 1;
-      }
-      else if (leds < 0x0180)
-      {
-        leds <<= 1;
-      }
+      ACCELBLOCK_calibrate(&accelBlock);
+      calibrating = true;
     }
+    prevButtons = buttons;
 
-    BSP_LedsSet((uint16_t)leds);
-    /* Delay to slow down led movement */
-    RTCDRV_Trigger(70, NULL);
-    EMU_EnterEM2(true);
+    BSP_LedsSet(calibrating ? 0xffff : (uint16_t)leds);
   }
 }
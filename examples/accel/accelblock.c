@@ -0,0 +1,503 @@
+/**************************************************************************//**
+ * @file
+ * @brief Accelerometer sample block processing
+ * @author Energy Micro AS
+ * @version 3.20.0
+ ******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 Energy Micro AS, http://www.energymicro.com</b>
+ *******************************************************************************
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ * 4. The source and compiled code may only be used on Energy Micro "EFM32"
+ *    microcontrollers and "EFR4" radios.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: Energy Micro AS has no
+ * obligation to support this Software. Energy Micro AS is providing the
+ * Software "AS IS", with no express or implied warranties of any kind,
+ * including, but not limited to, any implied warranties of merchantability
+ * or fitness for any particular purpose or warranties against infringement
+ * of any proprietary rights of a third party.
+ *
+ * Energy Micro AS will not be liable for any consequential, incidental, or
+ * special damages, or any other relief, or for any claim by any third party,
+ * arising from your use of this Software.
+ *
+ *****************************************************************************/
+#include "accelblock.h"
+
+/** Filter outputs discarded after init, until CIC comb stages are filled. */
+#define ACCELBLOCK_SETTLE_OUTPUTS 2
+
+/** Max range of each axis during calibration, 0.05 g nominal. */
+#define ACCELBLOCK_CAL_STILL      (ACCELBLOCK_ONE_G_NOMINAL / 20)
+
+/**
+ * atan(i / 64), i = 0..64, in 1/100 degrees. With linear interpolation
+ * between entries, atan2 is within 0.03 degrees.
+ */
+static const uint16_t atanTable[65] =
+{
+     0,   90,  179,  268,  358,  447,  536,  624,
+   713,  800,  888,  975, 1062, 1148, 1234, 1319,
+  1404, 1488, 1571, 1653, 1735, 1817, 1897, 1977,
+  2056, 2134, 2211, 2287, 2363, 2438, 2511, 2584,
+  2657, 2728, 2798, 2867, 2936, 3003, 3070, 3136,
+  3201, 3264, 3327, 3390, 3451, 3511, 3571, 3629,
+  3687, 3744, 3800, 3855, 3909, 3963, 4016, 4067,
+  4119, 4169, 4218, 4267, 4315, 4363, 4409, 4455,
+  4500
+};
+
+/***************************************************************************//**
+ * @brief
+ *   atan of ratio 0-1 with 12 fraction bits, in 1/100 degrees.
+ ******************************************************************************/
+static int32_t ACCELBLOCK_atanRatio(uint32_t ratio)
+{
+  uint32_t idx  = ratio >> 6;
+  int32_t  frac = (int32_t)(ratio & 63);
+
+  if (idx >= 64)
+  {
+    return atanTable[64];
+  }
+  return atanTable[idx] +
+         ((((int32_t)atanTable[idx + 1] - atanTable[idx]) * frac + 32) >> 6);
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Integer square root, rounded down.
+ ******************************************************************************/
+static uint32_t ACCELBLOCK_sqrt(uint32_t value)
+{
+  uint32_t root = 0;
+  uint32_t bit  = 1UL << 30;
+
+  while (bit > value)
+  {
+    bit >>= 2;
+  }
+  while (bit)
+  {
+    if (value >= root + bit)
+    {
+      value -= root + bit;
+      root   = (root >> 1) + bit;
+    }
+    else
+    {
+      root >>= 1;
+    }
+    bit >>= 2;
+  }
+  return root;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Absolute value.
+ ******************************************************************************/
+static uint32_t ACCELBLOCK_abs(int32_t value)
+{
+  return (value < 0) ? (uint32_t)-value : (uint32_t)value;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Orientation from acceleration: the axis within 30 degrees of vertical,
+ *   if any.
+ ******************************************************************************/
+static ACCELBLOCK_Orient_TypeDef ACCELBLOCK_orient(const int32_t *accel,
+                                                   ACCELBLOCK_Orient_TypeDef prev)
+{
+  uint32_t sq[ACCELBLOCK_AXES];
+  uint32_t total = 0;
+  int      axis;
+
+  for (axis = 0; axis < ACCELBLOCK_AXES; axis++)
+  {
+    int32_t a = accel[axis] / (1 << ACCELBLOCK_FRAC_BITS);
+    sq[axis]  = (uint32_t)(a * a);
+    total    += sq[axis];
+  }
+
+  /* tan(30 degrees)^2 = 1/3, other axes below 1/4 of total */
+  for (axis = 0; axis < ACCELBLOCK_AXES; axis++)
+  {
+    if ((total - sq[axis]) * 4 < total)
+    {
+      return (ACCELBLOCK_Orient_TypeDef)(accelOrientXUp + axis * 2 +
+                                         (accel[axis] < 0));
+    }
+  }
+  return prev;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Finish calibration on collected outputs.
+ ******************************************************************************/
+static int ACCELBLOCK_calibrateFinish(ACCELBLOCK_State_TypeDef *state)
+{
+  ACCELBLOCK_Cal_TypeDef cal = state->cal;
+  int32_t                mean[ACCELBLOCK_AXES];
+  int32_t                zero = 0;
+  uint32_t               dev;
+  uint32_t               maxDev = 0;
+  int                    vertical = 0;
+  int                    axis;
+
+  for (axis = 0; axis < ACCELBLOCK_AXES; axis++)
+  {
+    if ((state->calMax[axis] - state->calMin[axis]) > ACCELBLOCK_CAL_STILL)
+    {
+      return ACCELBLOCK_CAL_MOVED;
+    }
+    mean[axis] = (state->calSum[axis] + ACCELBLOCK_CAL_OUTPUTS / 2) /
+                 ACCELBLOCK_CAL_OUTPUTS;
+    dev = ACCELBLOCK_abs(mean[axis] - ACCELBLOCK_ZERO_NOMINAL);
+    if (dev > maxDev)
+    {
+      maxDev   = dev;
+      vertical = axis;
+    }
+  }
+
+  /* Vertical axis must read above 0.7 g, the others below 0.25 g */
+  if (maxDev < (ACCELBLOCK_ONE_G_NOMINAL * 7) / 10)
+  {
+    return ACCELBLOCK_CAL_POSITION;
+  }
+  for (axis = 0; axis < ACCELBLOCK_AXES; axis++)
+  {
+    if (axis == vertical)
+    {
+      continue;
+    }
+    if (ACCELBLOCK_abs(mean[axis] - ACCELBLOCK_ZERO_NOMINAL) >
+        ACCELBLOCK_ONE_G_NOMINAL / 4)
+    {
+      return ACCELBLOCK_CAL_POSITION;
+    }
+    cal.zero[axis]  = mean[axis];
+    cal.measured   |= 1 << axis;
+    zero           += mean[axis];
+  }
+
+  if (!(cal.measured & (1 << vertical)))
+  {
+    cal.zero[vertical] = zero / 2;
+  }
+  cal.oneG = (int32_t)ACCELBLOCK_abs(mean[vertical] - cal.zero[vertical]);
+  state->cal = cal;
+  return 0;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Use one filter output of all axis.
+ ******************************************************************************/
+static void ACCELBLOCK_output(ACCELBLOCK_State_TypeDef *state)
+{
+  int32_t  oneG = state->cal.oneG >> ACCELBLOCK_FRAC_BITS;
+  int32_t  a;
+  uint32_t total = 0;
+  int      axis;
+
+  for (axis = 0; axis < ACCELBLOCK_AXES; axis++)
+  {
+    state->accel[axis] = state->raw[axis] - state->cal.zero[axis];
+    a      = state->accel[axis] / (1 << ACCELBLOCK_FRAC_BITS);
+    total += (uint32_t)(a * a);
+  }
+
+  /* Total acceleration within 0.75-1.25 g when held still */
+  state->moving = (total < (uint32_t)((oneG * 3 / 4) * (oneG * 3 / 4))) ||
+                  (total > (uint32_t)((oneG * 5 / 4) * (oneG * 5 / 4)));
+
+  state->tilt = ACCELBLOCK_atan2(state->accel[ACCELBLOCK_X],
+                                 (int32_t)ACCELBLOCK_sqrt(
+                                   (uint32_t)(state->accel[ACCELBLOCK_Y] * state->accel[ACCELBLOCK_Y]) +
+                                   (uint32_t)(state->accel[ACCELBLOCK_Z] * state->accel[ACCELBLOCK_Z])));
+  state->orient = ACCELBLOCK_orient(state->accel, state->orient);
+
+  if (state->calRemaining)
+  {
+    for (axis = 0; axis < ACCELBLOCK_AXES; axis++)
+    {
+      a = state->raw[axis];
+      state->calSum[axis] += a;
+      if (a < state->calMin[axis])
+      {
+        state->calMin[axis] = a;
+      }
+      if (a > state->calMax[axis])
+      {
+        state->calMax[axis] = a;
+      }
+    }
+    if (!--state->calRemaining)
+    {
+      state->calStatus = ACCELBLOCK_calibrateFinish(state);
+    }
+  }
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Initialize block processing state, level.
+ *
+ * @param[in] state
+ *   State to initialize.
+ *
+ * @param[in] errataShift
+ *   Shift applied to samples, 1 for EFM32 rev B ADC errata with VDD
+ *   reference, else 0.
+ *
+ * @param[in] cal
+ *   Calibration to use, or NULL for nominal values.
+ ******************************************************************************/
+void ACCELBLOCK_init(ACCELBLOCK_State_TypeDef *state,
+                     int errataShift,
+                     const ACCELBLOCK_Cal_TypeDef *cal)
+{
+  int axis;
+
+  state->errataShift = errataShift;
+  if (cal)
+  {
+    state->cal = *cal;
+  }
+  else
+  {
+    for (axis = 0; axis < ACCELBLOCK_AXES; axis++)
+    {
+      state->cal.zero[axis] = ACCELBLOCK_ZERO_NOMINAL;
+    }
+    state->cal.oneG     = ACCELBLOCK_ONE_G_NOMINAL;
+    state->cal.measured = 0;
+  }
+
+  for (axis = 0; axis < ACCELBLOCK_AXES; axis++)
+  {
+    state->integ1[axis] = 0;
+    state->integ2[axis] = 0;
+    state->comb1[axis]  = 0;
+    state->comb2[axis]  = 0;
+    state->raw[axis]    = state->cal.zero[axis];
+    state->accel[axis]  = 0;
+  }
+  state->phase        = 0;
+  state->settle       = ACCELBLOCK_SETTLE_OUTPUTS;
+  state->tilt         = 0;
+  state->orient       = accelOrientUnknown;
+  state->moving       = false;
+  state->leds         = ACCELBLOCK_LEDS_LEVEL;
+  state->calRemaining = 0;
+  state->calStatus    = 0;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Process block of scans: filter and decimate each axis, update tilt and
+ *   orientation on each filter output, and take one step of tilt indicator.
+ *
+ * @param[in] state
+ *   Processing state.
+ *
+ * @param[in] scans
+ *   Scans of X, Y and Z, interleaved.
+ *
+ * @param[in] count
+ *   Number of scans in block.
+ *
+ * @return
+ *   LED pattern of tilt indicator.
+ ******************************************************************************/
+uint32_t ACCELBLOCK_process(ACCELBLOCK_State_TypeDef *state,
+                            const uint16_t *scans,
+                            unsigned int count)
+{
+  uint32_t     leds = state->leds;
+  uint32_t     i1[ACCELBLOCK_AXES];
+  uint32_t     i2[ACCELBLOCK_AXES];
+  uint32_t     d1;
+  uint32_t     d2;
+  unsigned int phase = state->phase;
+  int          axis;
+
+  for (axis = 0; axis < ACCELBLOCK_AXES; axis++)
+  {
+    i1[axis] = state->integ1[axis];
+    i2[axis] = state->integ2[axis];
+  }
+
+  while (count--)
+  {
+    /* Integrators, at scan rate */
+    i1[ACCELBLOCK_X] += scans[ACCELBLOCK_X];
+    i2[ACCELBLOCK_X] += i1[ACCELBLOCK_X];
+    i1[ACCELBLOCK_Y] += scans[ACCELBLOCK_Y];
+    i2[ACCELBLOCK_Y] += i1[ACCELBLOCK_Y];
+    i1[ACCELBLOCK_Z] += scans[ACCELBLOCK_Z];
+    i2[ACCELBLOCK_Z] += i1[ACCELBLOCK_Z];
+    scans += ACCELBLOCK_AXES;
+
+    if (++phase < ACCELBLOCK_DECIMATION)
+    {
+      continue;
+    }
+    phase = 0;
+
+    /* Combs, at output rate. Gain is DECIMATION^2, keep FRAC_BITS of it. */
+    for (axis = 0; axis < ACCELBLOCK_AXES; axis++)
+    {
+      d1                 = i2[axis] - state->comb1[axis];
+      state->comb1[axis] = i2[axis];
+      d2                 = d1 - state->comb2[axis];
+      state->comb2[axis] = d1;
+      state->raw[axis]   = (int32_t)((d2 >> (2 * ACCELBLOCK_DECIMATION_LOG -
+                                             ACCELBLOCK_FRAC_BITS)) <<
+                                     state->errataShift);
+    }
+
+    if (state->settle)
+    {
+      state->settle--;
+      continue;
+    }
+    ACCELBLOCK_output(state);
+  }
+
+  for (axis = 0; axis < ACCELBLOCK_AXES; axis++)
+  {
+    state->integ1[axis] = i1[axis];
+    state->integ2[axis] = i2[axis];
+  }
+  state->phase = phase;
+
+  /* Tilt indicator, held while board is moved or calibrated */
+  if (state->settle || state->moving || state->calRemaining)
+  {
+    return leds;
+  }
+
+  if (state->tilt < -ACCELBLOCK_TILT_LIMIT)
+  {
+    if (leds < 0xc000)
+    {
+      leds <<= 1;
+    }
+  }
+  else if (state->tilt > ACCELBLOCK_TILT_LIMIT)
+  {
+    if (leds > 0x0003)
+    {
+      leds >>= 1;
+    }
+  }
+  else
+  {
+    if (leds > ACCELBLOCK_LEDS_LEVEL)
+    {
+      leds >>= 1;
+    }
+    else if (leds < ACCELBLOCK_LEDS_LEVEL)
+    {
+      leds <<= 1;
+    }
+  }
+
+  state->leds = leds;
+  return leds;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Start calibration over the next ACCELBLOCK_CAL_OUTPUTS filter outputs.
+ *   Board must be held still, with one axis vertical.
+ *
+ * @param[in] state
+ *   Processing state.
+ ******************************************************************************/
+void ACCELBLOCK_calibrate(ACCELBLOCK_State_TypeDef *state)
+{
+  int axis;
+
+  for (axis = 0; axis < ACCELBLOCK_AXES; axis++)
+  {
+    state->calSum[axis] = 0;
+    state->calMin[axis] = INT32_MAX;
+    state->calMax[axis] = INT32_MIN;
+  }
+  state->calRemaining = ACCELBLOCK_CAL_OUTPUTS;
+  state->calStatus    = ACCELBLOCK_CAL_BUSY;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Get status of latest calibration.
+ *
+ * @param[in] state
+ *   Processing state.
+ *
+ * @return
+ *   ACCELBLOCK_CAL_BUSY while running, 0 when done and state->cal updated,
+ *   else ACCELBLOCK_CAL_MOVED or ACCELBLOCK_CAL_POSITION with calibration
+ *   unchanged.
+ ******************************************************************************/
+int ACCELBLOCK_calibrateStatus(const ACCELBLOCK_State_TypeDef *state)
+{
+  return state->calStatus;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Angle of vector (x, y), using table lookup.
+ *
+ * @param[in] y
+ *   Y component, magnitude below 2^19.
+ *
+ * @param[in] x
+ *   X component, magnitude below 2^19.
+ *
+ * @return
+ *   Angle from X axis in 1/100 degrees, -18000 to 18000. 0 for (0, 0).
+ ******************************************************************************/
+int32_t ACCELBLOCK_atan2(int32_t y, int32_t x)
+{
+  uint32_t ax = ACCELBLOCK_abs(x);
+  uint32_t ay = ACCELBLOCK_abs(y);
+  int32_t  angle;
+
+  if (!ax && !ay)
+  {
+    return 0;
+  }
+
+  /* First octant by ratio of smaller to larger component */
+  if (ay <= ax)
+  {
+    angle = ACCELBLOCK_atanRatio((ay << 12) / ax);
+  }
+  else
+  {
+    angle = 9000 - ACCELBLOCK_atanRatio((ax << 12) / ay);
+  }
+
+  if (x < 0)
+  {
+    angle = 18000 - angle;
+  }
+  return (y < 0) ? -angle : angle;
+}
@@ -0,0 +1,186 @@
+/**************************************************************************//**
+ * @file
+ * @brief Accelerometer sample block processing
+ * @author Energy Micro AS
+ * @version 3.20.0
+ ******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 Energy Micro AS, http://www.energymicro.com</b>
+ *******************************************************************************
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ * 4. The source and compiled code may only be used on Energy Micro "EFM32"
+ *    microcontrollers and "EFR4" radios.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: Energy Micro AS has no
+ * obligation to support this Software. Energy Micro AS is providing the
+ * Software "AS IS", with no express or implied warranties of any kind,
+ * including, but not limited to, any implied warranties of merchantability
+ * or fitness for any particular purpose or warranties against infringement
+ * of any proprietary rights of a third party.
+ *
+ * Energy Micro AS will not be liable for any consequential, incidental, or
+ * special damages, or any other relief, or for any claim by any third party,
+ * arising from your use of this Software.
+ *
+ *****************************************************************************/
+#ifndef __ACCELBLOCK_H
+#define __ACCELBLOCK_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+   Processing of accelerometer sample blocks, kept free of hardware
+   references so that it can run off target on recorded traces.
+
+   A block holds count ADC scans of X, Y and Z, interleaved as written by
+   DMA from ADC0 SCANDATA. Each axis is low-pass filtered and decimated by
+   ACCELBLOCK_DECIMATION with a second order CIC filter (moving average of
+   a moving average), giving outputs with 4 fraction bits. Outputs are
+   corrected by the zero g offsets of the calibration, and give the tilt
+   angle of the X axis from horizontal and the orientation of the board.
+   At the end of each block, the LED tilt indicator takes one step, so it
+   moves at the block rate whatever the sample rate.
+
+   Tilt is found with an integer atan2 on a 65 entry table, so only the
+   zero g offsets matter for the angle, not the gain of each axis. The gain
+   (output for 1 g) is used to ignore blocks where the board is being moved,
+   seen as total acceleration far from 1 g.
+
+   Calibration averages ACCELBLOCK_CAL_OUTPUTS outputs with the board held
+   still, in any position with one axis vertical. The two horizontal axes
+   give their zero g offsets, the vertical axis gives 1 g. The offset of
+   the vertical axis is kept from an earlier calibration that measured it,
+   else taken as the mean of the two others. Calibrating in two positions,
+   say upright and flat, thus measures all three offsets.
+*/
+
+/** Samples per ADC scan, and index of each axis in a scan */
+#define ACCELBLOCK_AXES           3
+#define ACCELBLOCK_X              0
+#define ACCELBLOCK_Y              1
+#define ACCELBLOCK_Z              2
+
+/** Decimation rate of CIC filter, scans per output. Power of 2. */
+#define ACCELBLOCK_DECIMATION     16
+/** log2 of ACCELBLOCK_DECIMATION. */
+#define ACCELBLOCK_DECIMATION_LOG 4
+
+/** Fraction bits of filter outputs and calibration values. */
+#define ACCELBLOCK_FRAC_BITS      4
+
+/** Nominal zero g output, half of 12 bit range at VDD reference. */
+#define ACCELBLOCK_ZERO_NOMINAL   (0x800 << ACCELBLOCK_FRAC_BITS)
+/** Nominal output for 1 g, 800 mV/g at 3.3 V VDD reference. */
+#define ACCELBLOCK_ONE_G_NOMINAL  (993 << ACCELBLOCK_FRAC_BITS)
+
+/**
+ * Tilt limit, in 1/100 degrees. Same as the former limits on raw samples,
+ * 0x800 -/+ 0xb0 at nominal gain.
+ */
+#define ACCELBLOCK_TILT_LIMIT     1000
+
+/** LED pattern when level */
+#define ACCELBLOCK_LEDS_LEVEL     0x0180
+
+/** Filter outputs averaged by calibration. */
+#define ACCELBLOCK_CAL_OUTPUTS    32
+
+/** Calibration status: running. */
+#define ACCELBLOCK_CAL_BUSY       1
+/** Calibration status: board moved during calibration. */
+#define ACCELBLOCK_CAL_MOVED      -1
+/** Calibration status: no axis close enough to vertical. */
+#define ACCELBLOCK_CAL_POSITION   -2
+
+/** Board orientation, axis pointing up (reading +1 g). */
+typedef enum
+{
+  accelOrientUnknown,
+  accelOrientXUp,
+  accelOrientXDown,
+  accelOrientYUp,
+  accelOrientYDown,
+  accelOrientZUp,
+  accelOrientZDown
+} ACCELBLOCK_Orient_TypeDef;
+
+/** Calibration, in ADC codes with ACCELBLOCK_FRAC_BITS fraction bits. */
+typedef struct
+{
+  /** Output of each axis at zero g. */
+  int32_t  zero[ACCELBLOCK_AXES];
+  /** Output change for 1 g. */
+  int32_t  oneG;
+  /** Bit mask of axes with zero g output measured, not estimated. */
+  uint32_t measured;
+} ACCELBLOCK_Cal_TypeDef;
+
+/** Block processing state */
+typedef struct
+{
+  /** Shift applied to samples (EFM32 rev B ADC errata). */
+  int                       errataShift;
+  /** Calibration in use. */
+  ACCELBLOCK_Cal_TypeDef    cal;
+
+  /** CIC integrator and comb stages, modulo 2^32. */
+  uint32_t                  integ1[ACCELBLOCK_AXES];
+  uint32_t                  integ2[ACCELBLOCK_AXES];
+  uint32_t                  comb1[ACCELBLOCK_AXES];
+  uint32_t                  comb2[ACCELBLOCK_AXES];
+  /** Scans into current output. */
+  unsigned int              phase;
+  /** Outputs until filter has settled. */
+  unsigned int              settle;
+
+  /** Latest filter output of each axis. */
+  int32_t                   raw[ACCELBLOCK_AXES];
+  /** Latest acceleration, zero g removed. */
+  int32_t                   accel[ACCELBLOCK_AXES];
+  /** Tilt of X axis from horizontal, 1/100 degrees, negative left. */
+  int32_t                   tilt;
+  /** Orientation of board. */
+  ACCELBLOCK_Orient_TypeDef orient;
+  /** Total acceleration not close to 1 g, board being moved. */
+  bool                      moving;
+  /** LED pattern of tilt indicator. */
+  uint32_t                  leds;
+
+  /** Calibration outputs remaining, and status. */
+  unsigned int              calRemaining;
+  int                       calStatus;
+  /** Calibration sums and ranges. */
+  int32_t                   calSum[ACCELBLOCK_AXES];
+  int32_t                   calMin[ACCELBLOCK_AXES];
+  int32_t                   calMax[ACCELBLOCK_AXES];
+} ACCELBLOCK_State_TypeDef;
+
+void ACCELBLOCK_init(ACCELBLOCK_State_TypeDef *state,
+                     int errataShift,
+                     const ACCELBLOCK_Cal_TypeDef *cal);
+uint32_t ACCELBLOCK_process(ACCELBLOCK_State_TypeDef *state,
+                            const uint16_t *scans,
+                            unsigned int count);
+void ACCELBLOCK_calibrate(ACCELBLOCK_State_TypeDef *state);
+int ACCELBLOCK_calibrateStatus(const ACCELBLOCK_State_TypeDef *state);
+int32_t ACCELBLOCK_atan2(int32_t y, int32_t x);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
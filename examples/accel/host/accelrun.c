@@ -0,0 +1,518 @@
+/**************************************************************************//**
+ * @file
+ * @brief Host runner for accelerometer block processing
+ * @author Energy Micro AS
+ * @version 3.20.0
+ ******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 Energy Micro AS, http://www.energymicro.com</b>
+ *******************************************************************************
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ * 4. The source and compiled code may only be used on Energy Micro "EFM32"
+ *    microcontrollers and "EFR4" radios.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: Energy Micro AS has no
+ * obligation to support this Software. Energy Micro AS is providing the
+ * Software "AS IS", with no express or implied warranties of any kind,
+ * including, but not limited to, any implied warranties of merchantability
+ * or fitness for any particular purpose or warranties against infringement
+ * of any proprietary rights of a third party.
+ *
+ * Energy Micro AS will not be liable for any consequential, incidental, or
+ * special damages, or any other relief, or for any claim by any third party,
+ * arising from your use of this Software.
+ *
+ *****************************************************************************/
+
+/*
+   Host runner for the accelerometer block processing (accelblock.c).
+
+   Reads a trace of ADC scans, one "X Y Z" line of 12 bit ADC codes per
+   scan at ACCEL_SAMPLE_RATE, and feeds it through the same ping-pong
+   buffering as accel.c: scans fill the primary and alternate buffers in
+   turn, and each full buffer is one DMA interrupt and one call of
+   ACCELBLOCK_process(). Processing starts from nominal calibration.
+
+   Lines starting with '#' are comments, except directives and checks on
+   the state after each block in a range:
+
+     #! <block>                            start calibration before block
+     #c <block> <status>                   calibration status
+     #@ <first> <last> <leds>              LED pattern (hex)
+     #^ <first> <last> <tilt> <tolerance>  tilt, 1/100 degrees
+     #o <first> <last> <orientation>       X+, X-, Y+, Y-, Z+ or Z-
+
+   A trace passes when all its checks hold.
+
+   For comparison, the former polled loop is run on the same trace: one
+   raw scan about every 75 ms against fixed limits. The number of LED
+   reversals shows how much each approach jitters on noise and vibration,
+   and wakeups per second what each costs in CPU activity.
+
+   With -b, each trace is also processed repeatedly for about a second to
+   measure time per scan, converted to cycles when the host core clock is
+   given with -m. On target, accel.c counts cycles per scan with the DWT
+   cycle counter (accelMonCyclesPerScan).
+
+   Usage: accelrun [-b] [-m <MHz>] <trace> [...]
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include "accelblock.h"
+
+/** Scan rate, same as on target. */
+#define ACCEL_SAMPLE_RATE    400
+/** Scans per DMA block, same as on target. */
+#define ACCEL_BLOCK_SCANS    32
+
+/** Scans between polls of former loop, 5 ms conversion poll + 70 ms delay. */
+#define POLL_INTERVAL        ((ACCEL_SAMPLE_RATE * 75) / 1000)
+/** Wakeups per poll of former loop, RTC poll tick and RTC delay. */
+#define POLL_WAKEUPS         2
+/** Former tilt limits on raw samples. */
+#define POLL_TILT_LEFT       0x750
+#define POLL_TILT_RIGHT      0x8b0
+
+/** Max number of directives and checks in one trace. */
+#define MAX_CHECKS           64
+/** Max number of scans in one trace. */
+#define MAX_SCANS            100000
+
+/** Directive or check from trace. */
+typedef struct
+{
+  char          kind;
+  unsigned long first;
+  unsigned long last;
+  long          value;
+  long          tolerance;
+} Check_TypeDef;
+
+/** Scans of trace. */
+static uint16_t traceScans[MAX_SCANS * ACCELBLOCK_AXES];
+
+/** Ping-pong buffers, as filled by DMA on target. */
+static uint16_t accelBuffer[2][ACCEL_BLOCK_SCANS * ACCELBLOCK_AXES];
+
+/** Orientation names, in ACCELBLOCK_Orient_TypeDef order. */
+static const char *orientNames[] = { "?", "X+", "X-", "Y+", "Y-", "Z+", "Z-" };
+
+/***************************************************************************//**
+ * @brief Count direction reversals of LED movement.
+ ******************************************************************************/
+static void countReversal(uint32_t prev, uint32_t leds, int *dir, unsigned long *reversals)
+{
+  int d = 0;
+
+  if (leds > prev)
+  {
+    d = 1;
+  }
+  else if (leds < prev)
+  {
+    d = -1;
+  }
+  if (d)
+  {
+    if (*dir && (d != *dir))
+    {
+      (*reversals)++;
+    }
+    *dir = d;
+  }
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Former polled loop, one step on a single scan.
+ ******************************************************************************/
+static uint32_t pollStep(uint32_t leds, uint32_t x)
+{
+  if (x < POLL_TILT_LEFT)
+  {
+    if (leds < 0xc000)
+    {
+      leds <<= 1;
+    }
+  }
+  else if (x > POLL_TILT_RIGHT)
+  {
+    if (leds > 0x0003)
+    {
+      leds >>= 1;
+    }
+  }
+  else
+  {
+    if (leds > ACCELBLOCK_LEDS_LEVEL)
+    {
+      leds >>= 1;
+    }
+    else if (leds < ACCELBLOCK_LEDS_LEVEL)
+    {
+      leds <<= 1;
+    }
+  }
+  return leds;
+}
+
+/***************************************************************************//**
+ * @brief Parse directive or check line, return 0 if not one.
+ ******************************************************************************/
+static int parseCheck(const char *line, Check_TypeDef *c)
+{
+  char name[4];
+  int  i;
+
+  c->kind      = line[1];
+  c->tolerance = 0;
+  switch (c->kind)
+  {
+  case '!':
+    if (sscanf(line + 2, "%lu", &c->first) != 1)
+    {
+      return 0;
+    }
+    c->last = c->first;
+    return 1;
+
+  case 'c':
+    if (sscanf(line + 2, "%lu %ld", &c->first, &c->value) != 2)
+    {
+      return 0;
+    }
+    c->last = c->first;
+    return 1;
+
+  case '@':
+    return sscanf(line + 2, "%lu %lu %lx", &c->first, &c->last,
+                  (unsigned long *)&c->value) == 3;
+
+  case '^':
+    return sscanf(line + 2, "%lu %lu %ld %ld", &c->first, &c->last,
+                  &c->value, &c->tolerance) == 4;
+
+  case 'o':
+    if (sscanf(line + 2, "%lu %lu %3s", &c->first, &c->last, name) != 3)
+    {
+      return 0;
+    }
+    for (i = 1; i < (int)(sizeof(orientNames) / sizeof(orientNames[0])); i++)
+    {
+      if (!strcmp(name, orientNames[i]))
+      {
+        c->value = i;
+        return 1;
+      }
+    }
+    return 0;
+
+  default:
+    return 0;
+  }
+}
+
+/***************************************************************************//**
+ * @brief Verify checks of kind other than directives after a block.
+ ******************************************************************************/
+static int verifyBlock(const ACCELBLOCK_State_TypeDef *state,
+                       const Check_TypeDef *checks,
+                       int numChecks,
+                       unsigned long block)
+{
+  const Check_TypeDef *c;
+  int                 failed = 0;
+  long                actual = 0;
+  int                 i;
+  int                 ok;
+
+  for (i = 0; i < numChecks; i++)
+  {
+    c = &checks[i];
+    if ((block < c->first) || (block > c->last))
+    {
+      continue;
+    }
+
+    switch (c->kind)
+    {
+    case 'c':
+      actual = ACCELBLOCK_calibrateStatus(state);
+      ok     = (actual == c->value);
+      break;
+    case '@':
+      actual = (long)state->leds;
+      ok     = (actual == c->value);
+      break;
+    case '^':
+      actual = state->tilt;
+      ok     = labs(actual - c->value) <= c->tolerance;
+      break;
+    case 'o':
+      actual = state->orient;
+      ok     = (actual == c->value);
+      break;
+    default:
+      continue;
+    }
+
+    if (!ok)
+    {
+      if (c->kind == 'o')
+      {
+        printf("  block %lu: orientation %s, expected %s\n",
+               block, orientNames[actual], orientNames[c->value]);
+      }
+      else
+      {
+        printf("  block %lu: #%c %ld, expected %ld\n",
+               block, c->kind, actual, c->value);
+      }
+      failed++;
+    }
+  }
+  return failed;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Process scans block by block through ping-pong buffers. Checks are
+ *   verified if given.
+ ******************************************************************************/
+static int processTrace(ACCELBLOCK_State_TypeDef *state,
+                        unsigned long scans,
+                        const Check_TypeDef *checks,
+                        int numChecks,
+                        unsigned long *reversals)
+{
+  unsigned long blocks = scans / ACCEL_BLOCK_SCANS;
+  unsigned long block;
+  uint32_t      prev;
+  int           dir    = 0;
+  int           failed = 0;
+  int           i;
+
+  ACCELBLOCK_init(state, 0, NULL);
+
+  for (block = 0; block < blocks; block++)
+  {
+    /* DMA fills buffers in turn */
+    uint16_t *buffer = accelBuffer[block & 1];
+    memcpy(buffer,
+           &traceScans[block * ACCEL_BLOCK_SCANS * ACCELBLOCK_AXES],
+           sizeof(accelBuffer[0]));
+
+    for (i = 0; i < numChecks; i++)
+    {
+      if ((checks[i].kind == '!') && (checks[i].first == block))
+      {
+        ACCELBLOCK_calibrate(state);
+      }
+    }
+
+    prev = state->leds;
+    ACCELBLOCK_process(state, buffer, ACCEL_BLOCK_SCANS);
+    if (reversals)
+    {
+      countReversal(prev, state->leds, &dir, reversals);
+    }
+    if (numChecks)
+    {
+      failed += verifyBlock(state, checks, numChecks, block);
+    }
+  }
+  return failed;
+}
+
+/***************************************************************************//**
+ * @brief Run one trace, return number of failed checks or -1 on error.
+ ******************************************************************************/
+static int runTrace(const char *name, int bench, double mhz)
+{
+  ACCELBLOCK_State_TypeDef state;
+  Check_TypeDef checks[MAX_CHECKS];
+  char          line[128];
+  FILE          *f;
+  unsigned long scans     = 0;
+  unsigned long blocks;
+  unsigned long n;
+  int           numChecks = 0;
+  int           failed;
+  int           i;
+  uint32_t      prev;
+  uint32_t      pollLeds  = ACCELBLOCK_LEDS_LEVEL;
+  unsigned long polls     = 0;
+  unsigned long blockRev  = 0;
+  unsigned long pollRev   = 0;
+  int           pollDir   = 0;
+  double        seconds;
+
+  f = fopen(name, "r");
+  if (!f)
+  {
+    fprintf(stderr, "%s: cannot open\n", name);
+    return -1;
+  }
+
+  while (fgets(line, sizeof(line), f))
+  {
+    unsigned long v[ACCELBLOCK_AXES];
+    char          *p = line;
+    char          *end;
+    int           axis;
+
+    if (line[0] == '#')
+    {
+      if ((numChecks < MAX_CHECKS) && parseCheck(line, &checks[numChecks]))
+      {
+        numChecks++;
+      }
+      continue;
+    }
+
+    for (axis = 0; axis < ACCELBLOCK_AXES; axis++)
+    {
+      v[axis] = strtoul(p, &end, 0);
+      if ((end == p) || (v[axis] > 0xfff))
+      {
+        break;
+      }
+      p = end;
+    }
+    if (axis == 0)
+    {
+      continue;
+    }
+    if ((axis < ACCELBLOCK_AXES) || (scans == MAX_SCANS))
+    {
+      fprintf(stderr, "%s: bad scan line %lu\n", name, scans + 1);
+      fclose(f);
+      return -1;
+    }
+
+    for (axis = 0; axis < ACCELBLOCK_AXES; axis++)
+    {
+      traceScans[scans * ACCELBLOCK_AXES + axis] = (uint16_t)v[axis];
+    }
+
+    /* Former loop, every POLL_INTERVAL scan */
+    if (!(scans % POLL_INTERVAL))
+    {
+      prev     = pollLeds;
+      pollLeds = pollStep(pollLeds, v[ACCELBLOCK_X]);
+      countReversal(prev, pollLeds, &pollDir, &pollRev);
+      polls++;
+    }
+    scans++;
+  }
+  fclose(f);
+
+  blocks = scans / ACCEL_BLOCK_SCANS;
+  failed = processTrace(&state, scans, checks, numChecks, &blockRev);
+
+  for (i = 0; i < numChecks; i++)
+  {
+    if (checks[i].last >= blocks)
+    {
+      printf("  check of blocks %lu-%lu beyond end of trace\n",
+             checks[i].first, checks[i].last);
+      failed++;
+    }
+  }
+
+  seconds = (double)scans / ACCEL_SAMPLE_RATE;
+  printf("%s: %lu scans, %.1f s, %d checks, %s\n",
+         name, scans, seconds, numChecks, failed ? "FAILED" : "passed");
+  printf("  block:  %lu blocks, %5.1f wakeups/s, %lu LED reversals\n",
+         blocks, blocks / seconds, blockRev);
+  printf("  polled: %lu polls,  %5.1f wakeups/s, %lu LED reversals\n",
+         polls, (polls * POLL_WAKEUPS) / seconds, pollRev);
+  printf("  cal: zero %ld %ld %ld, 1 g %ld (1/%d codes), tilt %ld, %s\n",
+         (long)state.cal.zero[ACCELBLOCK_X], (long)state.cal.zero[ACCELBLOCK_Y],
+         (long)state.cal.zero[ACCELBLOCK_Z], (long)state.cal.oneG,
+         1 << ACCELBLOCK_FRAC_BITS, (long)state.tilt, orientNames[state.orient]);
+
+  if (bench && blocks)
+  {
+    struct timespec t0, t1;
+    double          elapsed;
+    unsigned long   runs = 0;
+
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    do
+    {
+      for (n = 0; n < 100; n++)
+      {
+        processTrace(&state, blocks * ACCEL_BLOCK_SCANS, NULL, 0, NULL);
+      }
+      runs += n;
+      clock_gettime(CLOCK_MONOTONIC, &t1);
+      elapsed = (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) * 1e-9;
+    } while (elapsed < 1.0);
+
+    elapsed /= (double)runs * blocks * ACCEL_BLOCK_SCANS;
+    printf("  bench: %.1f ns/scan", elapsed * 1e9);
+    if (mhz > 0)
+    {
+      printf(", %.1f cycles/scan at %.0f MHz", elapsed * mhz * 1e6, mhz);
+    }
+    printf("\n");
+  }
+
+  return failed;
+}
+
+/***************************************************************************//**
+ * @brief Main function.
+ ******************************************************************************/
+int main(int argc, char **argv)
+{
+  double mhz    = 0;
+  int    bench  = 0;
+  int    status = 0;
+  int    i;
+
+  for (i = 1; (i < argc) && (argv[i][0] == '-'); i++)
+  {
+    if (!strcmp(argv[i], "-b"))
+    {
+      bench = 1;
+    }
+    else if (!strcmp(argv[i], "-m") && (i + 1 < argc))
+    {
+      mhz = atof(argv[++i]);
+    }
+    else
+    {
+      break;
+    }
+  }
+
+  if (i >= argc)
+  {
+    fprintf(stderr, "Usage: %s [-b] [-m <MHz>] <trace> [...]\n", argv[0]);
+    return 2;
+  }
+
+  for (; i < argc; i++)
+  {
+    if (runTrace(argv[i], bench, mhz))
+    {
+      status = 1;
+    }
+  }
+  return status;
+}
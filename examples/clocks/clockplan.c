@@ -0,0 +1,251 @@
+/**************************************************************************//**
+ * @file
+ * @brief Core clock configuration planner
+ * @author Energy Micro AS
+ * @version 3.20.0
+ ******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 Energy Micro AS, http://www.energymicro.com</b>
+ *******************************************************************************
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ * 4. The source and compiled code may only be used on Energy Micro "EFM32"
+ *    microcontrollers and "EFR4" radios.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: Energy Micro AS has no
+ * obligation to support this Software. Energy Micro AS is providing the
+ * Software "AS IS", with no express or implied warranties of any kind,
+ * including, but not limited to, any implied warranties of merchantability
+ * or fitness for any particular purpose or warranties against infringement
+ * of any proprietary rights of a third party.
+ *
+ * Energy Micro AS will not be liable for any consequential, incidental, or
+ * special damages, or any other relief, or for any claim by any third party,
+ * arising from your use of this Software.
+ *
+ *****************************************************************************/
+#include "clockplan.h"
+
+/**
+ * Oscillator/band characteristics, approximate typical values from the
+ * EFM32G datasheet. HFXO is the 32 MHz crystal on the DK.
+ */
+const CLOCKPLAN_Source_TypeDef CLOCKPLAN_oscTable[CLOCKPLAN_SOURCES] =
+{
+  /* osc                 band  freq      osc    core    tree  wake */
+  { clockplanOscLFRCO,   0,       32768,    190, 200000, 50000,   2 },
+  { clockplanOscLFXO,    0,       32768,    190, 200000, 50000,   2 },
+  { clockplanOscHFRCO,   0,     1200000,  13000, 170000, 50000,   2 },
+  { clockplanOscHFRCO,   1,     6600000,  55000, 150000, 48000,   2 },
+  { clockplanOscHFRCO,   2,    11000000,  88000, 142000, 46000,   2 },
+  { clockplanOscHFRCO,   3,    14000000,  99000, 140000, 45000,   2 },
+  { clockplanOscHFRCO,   4,    21000000, 125000, 138000, 45000,   2 },
+  { clockplanOscHFRCO,   5,    28000000, 158000, 136000, 45000,   2 },
+  { clockplanOscHFXO,    0,    32000000, 165000, 135000, 45000, 400 }
+};
+
+/***************************************************************************//**
+ * @brief
+ *   Evaluate configuration for workload.
+ *
+ * @return
+ *   false if configuration cannot meet workload.
+ ******************************************************************************/
+static bool clockplanEvaluate(const CLOCKPLAN_Workload_TypeDef *work,
+                              const CLOCKPLAN_Source_TypeDef *src,
+                              unsigned int div,
+                              CLOCKPLAN_Config_TypeDef *config)
+{
+  uint32_t coreFreq = src->freq >> div;
+  uint32_t entryUs;
+  uint64_t activeNa;
+  uint64_t idleNa;
+  uint64_t current;
+
+  if (coreFreq < work->cycles || coreFreq < work->coreFreqMin ||
+      src->freq < work->perFreqMin)
+  {
+    return false;
+  }
+
+  /* Handler entry, rounded up */
+  entryUs = (uint32_t)(((uint64_t)CLOCKPLAN_WAKE_CYCLES * 1000000 + coreFreq - 1) /
+                       coreFreq);
+
+  /* EM1 keeps HFCLK and oscillator running */
+  activeNa = CLOCKPLAN_STATIC_NA + src->oscNa +
+             ((uint64_t)src->coreNaPerMHz * coreFreq +
+              (uint64_t)src->treeNaPerMHz * src->freq) / 1000000;
+  idleNa = CLOCKPLAN_STATIC_NA + src->oscNa +
+           (uint64_t)src->treeNaPerMHz * src->freq / 1000000;
+
+  config->osc      = src->osc;
+  config->band     = src->band;
+  config->div      = (uint8_t)div;
+  config->coreFreq = coreFreq;
+
+  if (!work->perInSleep && src->em2WakeUs + entryUs <= work->wakeUs)
+  {
+    config->eMode = 2;
+    config->wakeUs = src->em2WakeUs + entryUs;
+    idleNa = CLOCKPLAN_EM2_NA;
+  }
+  else if (entryUs <= work->wakeUs)
+  {
+    config->eMode = 1;
+    config->wakeUs = entryUs;
+  }
+  else
+  {
+    return false;
+  }
+
+  /* Active cycles / coreFreq of each second */
+  current = (activeNa * work->cycles +
+             idleNa * (coreFreq - work->cycles) + coreFreq / 2) / coreFreq;
+  config->currentNa = current > 0xffffffff ? 0xffffffff : (uint32_t)current;
+
+  return true;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Enumerate configurations meeting workload.
+ *
+ * @param[in] work
+ *   Workload requirements.
+ *
+ * @param[out] configs
+ *   Configurations meeting workload, room for CLOCKPLAN_MAX_CONFIGS.
+ *
+ * @return
+ *   Number of configurations.
+ ******************************************************************************/
+int CLOCKPLAN_enumerate(const CLOCKPLAN_Workload_TypeDef *work,
+                        CLOCKPLAN_Config_TypeDef *configs)
+{
+  unsigned int src;
+  unsigned int div;
+  int          count = 0;
+
+  for (src = 0; src < CLOCKPLAN_SOURCES; src++)
+  {
+    for (div = 0; div < CLOCKPLAN_DIVS; div++)
+    {
+      if (clockplanEvaluate(work, &CLOCKPLAN_oscTable[src], div, &configs[count]))
+      {
+        count++;
+      }
+    }
+  }
+
+  return count;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Reduce configurations to Pareto set of current and wakeup latency.
+ *
+ * @details
+ *   Configurations that are matched or beaten on both current and wakeup
+ *   latency by another, and beaten on at least one, are removed. The rest
+ *   are sorted by increasing current. Among configurations equal on both,
+ *   the one with the highest core clock is kept.
+ *
+ * @param[in,out] configs
+ *   Configurations, Pareto set on return.
+ *
+ * @param[in] count
+ *   Number of configurations.
+ *
+ * @return
+ *   Number of configurations in Pareto set.
+ ******************************************************************************/
+int CLOCKPLAN_pareto(CLOCKPLAN_Config_TypeDef *configs, int count)
+{
+  CLOCKPLAN_Config_TypeDef tmp;
+  int i;
+  int j;
+  int kept = 0;
+
+  /* Sort by current, then latency, then decreasing core clock */
+  for (i = 1; i < count; i++)
+  {
+    tmp = configs[i];
+    for (j = i; j > 0; j--)
+    {
+      const CLOCKPLAN_Config_TypeDef *p = &configs[j - 1];
+
+      if (p->currentNa < tmp.currentNa ||
+          (p->currentNa == tmp.currentNa &&
+           (p->wakeUs < tmp.wakeUs ||
+            (p->wakeUs == tmp.wakeUs && p->coreFreq >= tmp.coreFreq))))
+      {
+        break;
+      }
+      configs[j] = configs[j - 1];
+    }
+    configs[j] = tmp;
+  }
+
+  /* In current order, each member must have lower latency than the last */
+  for (i = 0; i < count; i++)
+  {
+    if (!kept || configs[i].wakeUs < configs[kept - 1].wakeUs)
+    {
+      configs[kept++] = configs[i];
+    }
+  }
+
+  return kept;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Select lowest current configuration meeting workload.
+ *
+ * @details
+ *   Among equal current, the lowest wakeup latency is selected.
+ *
+ * @param[in] work
+ *   Workload requirements.
+ *
+ * @param[out] config
+ *   Selected configuration.
+ *
+ * @return
+ *   false if no configuration meets workload.
+ ******************************************************************************/
+bool CLOCKPLAN_select(const CLOCKPLAN_Workload_TypeDef *work,
+                      CLOCKPLAN_Config_TypeDef *config)
+{
+  CLOCKPLAN_Config_TypeDef candidate;
+  unsigned int src;
+  unsigned int div;
+  bool         found = false;
+
+  for (src = 0; src < CLOCKPLAN_SOURCES; src++)
+  {
+    for (div = 0; div < CLOCKPLAN_DIVS; div++)
+    {
+      if (clockplanEvaluate(work, &CLOCKPLAN_oscTable[src], div, &candidate) &&
+          (!found || candidate.currentNa < config->currentNa ||
+           (candidate.currentNa == config->currentNa &&
+            candidate.wakeUs < config->wakeUs)))
+      {
+        *config = candidate;
+        found = true;
+      }
+    }
+  }
+
+  return found;
+}
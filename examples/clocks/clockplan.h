@@ -0,0 +1,160 @@
+/**************************************************************************//**
+ * @file
+ * @brief Core clock configuration planner
+ * @author Energy Micro AS
+ * @version 3.20.0
+ ******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 Energy Micro AS, http://www.energymicro.com</b>
+ *******************************************************************************
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ * 4. The source and compiled code may only be used on Energy Micro "EFM32"
+ *    microcontrollers and "EFR4" radios.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: Energy Micro AS has no
+ * obligation to support this Software. Energy Micro AS is providing the
+ * Software "AS IS", with no express or implied warranties of any kind,
+ * including, but not limited to, any implied warranties of merchantability
+ * or fitness for any particular purpose or warranties against infringement
+ * of any proprietary rights of a third party.
+ *
+ * Energy Micro AS will not be liable for any consequential, incidental, or
+ * special damages, or any other relief, or for any claim by any third party,
+ * arising from your use of this Software.
+ *
+ *****************************************************************************/
+#ifndef __CLOCKPLAN_H
+#define __CLOCKPLAN_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+   Core clock configuration planner, kept free of hardware references so
+   that it can be verified off target.
+
+   A workload is described by the core cycles it needs per second, the
+   HFPERCLK its peripherals need, whether those peripherals must keep
+   running while idle, and the wakeup latency it tolerates. The planner
+   enumerates every oscillator, HFRCO band and core clock divisor
+   combination of the clocks example, drops those that cannot meet the
+   workload, and estimates the average current of the rest: the workload
+   runs in EM0 for cycles / core clock of each second, and the core
+   sleeps in EM2 the remaining time, or in EM1 if peripherals need
+   HFPERCLK while idle or EM2 wakeup is too slow.
+
+   The currents in CLOCKPLAN_oscTable[] are approximate typical values at
+   3 V with code executing from flash, taken from the EFM32G datasheet.
+   They rank the configurations; measure the application for absolute
+   figures.
+*/
+
+/** Oscillators, in order of oscSelectorTable in clocks.c. */
+typedef enum
+{
+  clockplanOscLFRCO,
+  clockplanOscLFXO,
+  clockplanOscHFRCO,
+  clockplanOscHFXO
+} CLOCKPLAN_Osc_TypeDef;
+
+/** Number of HFRCO bands, in order of bandSelectorTable in clocks.c. */
+#define CLOCKPLAN_BANDS          6
+
+/** Number of core clock divisors, 2^0 to 2^9. */
+#define CLOCKPLAN_DIVS           10
+
+/** Oscillator/band combinations, LFRCO, LFXO, HFRCO bands and HFXO. */
+#define CLOCKPLAN_SOURCES        (3 + CLOCKPLAN_BANDS)
+
+/** Maximum number of configurations. */
+#define CLOCKPLAN_MAX_CONFIGS    (CLOCKPLAN_SOURCES * CLOCKPLAN_DIVS)
+
+/** Core cycles from wakeup event to first instruction of handler. */
+#define CLOCKPLAN_WAKE_CYCLES    12
+
+/** EM2 current with LF oscillator and RTC running, nA. */
+#define CLOCKPLAN_EM2_NA         1100
+
+/** EM0/EM1 current not depending on clock, nA. */
+#define CLOCKPLAN_STATIC_NA      20000
+
+/** Oscillator/band characteristics. */
+typedef struct
+{
+  /** Oscillator. */
+  CLOCKPLAN_Osc_TypeDef osc;
+  /** HFRCO band index, 0 for other oscillators. */
+  uint8_t               band;
+  /** HFCLK frequency, Hz. */
+  uint32_t              freq;
+  /** Oscillator current, nA. */
+  uint32_t              oscNa;
+  /** EM0 core current per MHz of core clock, nA. */
+  uint32_t              coreNaPerMHz;
+  /** EM0/EM1 clock tree and bus current per MHz of HFCLK, nA. */
+  uint32_t              treeNaPerMHz;
+  /** EM2 wakeup until oscillator is running again, usec. */
+  uint32_t              em2WakeUs;
+} CLOCKPLAN_Source_TypeDef;
+
+/** Workload requirements. */
+typedef struct
+{
+  /** Core cycles needed per second. */
+  uint32_t cycles;
+  /** Lowest core clock, Hz, to remain responsive. */
+  uint32_t coreFreqMin;
+  /** Lowest HFPERCLK (HFCLK), Hz, 0 if no HF peripherals used. */
+  uint32_t perFreqMin;
+  /** true if HF peripherals must run while idle, requiring EM1. */
+  bool     perInSleep;
+  /** Longest wakeup latency tolerated, usec. */
+  uint32_t wakeUs;
+} CLOCKPLAN_Workload_TypeDef;
+
+/** Clock configuration meeting a workload. */
+typedef struct
+{
+  /** Oscillator. */
+  CLOCKPLAN_Osc_TypeDef osc;
+  /** HFRCO band index, 0 for other oscillators. */
+  uint8_t               band;
+  /** Core clock divisor, 2^div. */
+  uint8_t               div;
+  /** Energy mode used when idle, 1 or 2. */
+  uint8_t               eMode;
+  /** Core clock, Hz. */
+  uint32_t              coreFreq;
+  /** Wakeup latency, usec. */
+  uint32_t              wakeUs;
+  /** Estimated average current, nA. */
+  uint32_t              currentNa;
+} CLOCKPLAN_Config_TypeDef;
+
+extern const CLOCKPLAN_Source_TypeDef CLOCKPLAN_oscTable[CLOCKPLAN_SOURCES];
+
+int CLOCKPLAN_enumerate(const CLOCKPLAN_Workload_TypeDef *work,
+                        CLOCKPLAN_Config_TypeDef *configs);
+int CLOCKPLAN_pareto(CLOCKPLAN_Config_TypeDef *configs, int count);
+bool CLOCKPLAN_select(const CLOCKPLAN_Workload_TypeDef *work,
+                      CLOCKPLAN_Config_TypeDef *config);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -10,6 +10,7 @@
  *   (LFRCO/LFXO/HFRCO/HFXO)
  * @li Joystick Left and Right selects the core clock divisor, in 2^n steps
  * @li Joystick Push selects energy mode
+ * @li At startup, configuration is selected by the clock planner
  *
  * @note
  *   This example requires BSP version 1.0.6 or later.
@@ -52,14 +53,13 @@
 #include "em_emu.h"
 #include "em_cmu.h"
 #include "em_dbg.h"
-#include "em_gpio.h"
+#include "em_int.h"
 #include "em_lcd.h"
 #include "bsp.h"
 #include "bsp_trace.h"
 #include "segmentlcd.h"
-
-/** Interrupt pin used to detect joystick activity */
-#define GPIO_INT_PIN 14
+#include "clockplan.h"
+#include "keyinput.h"
 
 /** Minimum allowed core clock in Hz to inhibit becoming totally unresponsive */
 #define CORE_CLOCK_MIN 8000
@@ -114,42 +114,47 @@ static int bandIndex = 3; /* Set to HW reset default in bandSelectorTable */
 static int divIndex = 0; /* Set to HW reset default in clockDivTable */
 static int eMode = 0;
 
+/**
+ * Workload of this example, selecting startup configuration: updating the
+ * LCD after a joystick event takes some thousand cycles, and the joystick
+ * should respond within a millisecond.
+ */
+static const CLOCKPLAN_Workload_TypeDef clocksWorkload =
+{
+  20000,          /* Core cycles per second */
+  CORE_CLOCK_MIN, /* Lowest core clock */
+  0,              /* No HF peripherals */
+  false,          /* No HF peripherals when idle */
+  1000            /* Wakeup latency, usec */
+};
+
 /* Local prototypes */
-void clocksIRQInit(void);
+void clocksApply(void);
+void clocksPlan(const CLOCKPLAN_Workload_TypeDef *work);
+void clocksKey(const KEYQ_Event_TypeDef *event);
 void clocksUpdateLCD(void);
 
 /**************************************************************************//**
- * @brief GPIO Interrupt handler
- * This interrupt handler is not an example of good design, as it will do
- * a lot of operations inside the interrupt handler.
+ * @brief Handle joystick event
+ * Called from main loop, so the joystick interrupt handlers stay short and
+ * the core clock need not be raised while a key is held.
+ * @param[in] event Key event.
  *****************************************************************************/
-void GPIO_EVEN_IRQHandler(void)
+void clocksKey(const KEYQ_Event_TypeDef *event)
 {
   uint16_t joystick;
-  uint32_t freq;
-
-  /* Switch to HFRCO high frequency in order to finish interrupt as quickly */
-  /* as possible. HFRCO takes almost no time to start if disabled. This will */
-  /* cause energy consumption to go up during interrupt, but it improves */
-  /* joystick usage. */
-  CMU_ClockSelectSet(cmuClock_HF, cmuSelect_HFRCO);
-  CMU_HFRCOBandSet(cmuHFRCOBand_28MHz);
-  /* Important: Divisor must be 1 for handling towards end of this code */
-  CMU_ClockDivSet(cmuClock_CORE, cmuClkDiv_1);
-
-  /* Clear interrupt */
-  BSP_InterruptFlagsClear(BC_INTEN_JOYSTICK);
-  GPIO_IntClear(1 << GPIO_INT_PIN);
-
-  /* LEDs on to indicate joystick used */
-  BSP_LedsSet(0xffff);
 
-  /* Read and store joystick activity - wait for key release */
-  joystick = BSP_JoystickGet();
-  while (BSP_JoystickGet());
-
-  /* LEDs off to indicate joystick release */
-  BSP_LedsSet(0x0000);
+  /* LEDs on while joystick used */
+  if (event->type == keyqRelease)
+  {
+    BSP_LedsSet(0x0000);
+    return;
+  }
+  if (event->type == keyqPress)
+  {
+    BSP_LedsSet(0xffff);
+  }
+  joystick = event->key;
 
   /* LEFT/RIGHT selects core clock divisor */
   if (joystick & BC_JOYSTICK_LEFT)
@@ -224,8 +229,8 @@ void GPIO_EVEN_IRQHandler(void)
     }
   }
 
-  /* Push selects EM */
-  if (joystick & BC_JOYSTICK_CENTER)
+  /* Push selects EM, not repeated */
+  if ((joystick & BC_JOYSTICK_CENTER) && (event->type == keyqPress))
   {
     eMode++;
 
@@ -236,12 +241,23 @@ void GPIO_EVEN_IRQHandler(void)
   }
 
   /* Set to selected core clock */
+  clocksApply();
+}
+
+
+/**************************************************************************//**
+ * @brief Apply selected oscillator, HFRCO band and core clock divisor
+ *****************************************************************************/
+void clocksApply(void)
+{
+  uint32_t freq;
+
+  /* Divisor must be 1 in HW for below check to work */
+  CMU_ClockDivSet(cmuClock_CORE, cmuClkDiv_1);
+
   CMU_ClockSelectSet(cmuClock_HF, oscSelectorTable[oscIndex]);
   CMU_HFRCOBandSet(bandSelectorTable[bandIndex]);
 
-  /* Divisor must be 1 in HW for below check to work; */
-  /* has already been set to 1 at start of this function. */
-
   /* Make sure not going below min defined core clock in this app. */
   freq = CMU_ClockFreqGet(cmuClock_CORE);
   while (((freq >> divIndex) < CORE_CLOCK_MIN) && divIndex)
@@ -263,18 +279,27 @@ void GPIO_EVEN_IRQHandler(void)
 
 
 /**************************************************************************//**
- * @brief Initialize GPIO interrupt for joystick (ie FPGA signal)
+ * @brief Select and apply lowest current configuration meeting workload
+ *
+ * @param[in] work
+ *   Workload requirements, see clockplan.h.
  *****************************************************************************/
-void clocksIRQInit(void)
+void clocksPlan(const CLOCKPLAN_Workload_TypeDef *work)
 {
-  /* Configure interrupt pin as input with pull-up */
-  GPIO_PinModeSet(gpioPortC, GPIO_INT_PIN, gpioModeInputPull, 1);
+  CLOCKPLAN_Config_TypeDef config;
+
+  if (!CLOCKPLAN_select(work, &config))
+  {
+    return;
+  }
 
-  /* Set falling edge interrupt and clear/enable it */
-  GPIO_IntConfig(gpioPortC, GPIO_INT_PIN, false, true, true);
+  /* Planner oscillators and bands are in order of selector tables */
+  oscIndex = (int)config.osc;
+  bandIndex = config.band;
+  divIndex = config.div;
+  eMode = config.eMode;
 
-  NVIC_ClearPendingIRQ(GPIO_EVEN_IRQn);
-  NVIC_EnableIRQ(GPIO_EVEN_IRQn);
+  clocksApply();
 }
 
 /**************************************************************************//**
@@ -384,6 +409,9 @@ int main(void)
   BSP_TraceProfilerSetup();
   BSP_LedsSet(0xaaaa);
 
+  /* Start with lowest current configuration for this example */
+  clocksPlan(&clocksWorkload);
+
   /* Initialize LCD controller without boost */
   SegmentLCD_Init(false);
 
@@ -393,32 +421,41 @@ int main(void)
 
   SegmentLCD_Symbol(LCD_SYMBOL_COL5, 1);
 
-  /* Enable board control interrupts */
-  BSP_InterruptDisable(0xffff);
-  BSP_InterruptFlagsClear(0xffff);
-  BSP_InterruptEnable(BC_INTEN_JOYSTICK);
-  clocksIRQInit();
+  /* Joystick events, debounced on LETIMER0 clocked from LFRCO as LCD */
+  KEYINPUT_init(BC_INTEN_JOYSTICK);
   BSP_LedsSet(0xc003);
 
-  /* Main loop - just update LCD */
+  /* Main loop - handle joystick events and update LCD */
   while (1)
   {
+    KEYQ_Event_TypeDef event;
+
+    while (KEYINPUT_get(&event))
+    {
+      clocksKey(&event);
+    }
+
     /* Update LCD display with current settings */
     clocksUpdateLCD();
 
-    /* Enter EM as selected */
-    switch (eMode)
+    /* Enter EM as selected, unless an event arrived while updating LCD */
+    INT_Disable();
+    if (!KEYINPUT_pending())
     {
-    case 1:
-      EMU_EnterEM1();
-      break;
+      switch (eMode)
+      {
+      case 1:
+        EMU_EnterEM1();
+        break;
 
-    case 2:
-      EMU_EnterEM2(true);
-      break;
+      case 2:
+        EMU_EnterEM2(true);
+        break;
 
-    default: /* EM0 */
-      break;
+      default: /* EM0 */
+        break;
+      }
     }
+    INT_Enable();
   }
 }
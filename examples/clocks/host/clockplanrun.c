@@ -0,0 +1,291 @@
+/**************************************************************************//**
+ * @file
+ * @brief Host runner for core clock configuration planner
+ * @author Energy Micro AS
+ * @version 3.20.0
+ ******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 Energy Micro AS, http://www.energymicro.com</b>
+ *******************************************************************************
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ * 4. The source and compiled code may only be used on Energy Micro "EFM32"
+ *    microcontrollers and "EFR4" radios.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: Energy Micro AS has no
+ * obligation to support this Software. Energy Micro AS is providing the
+ * Software "AS IS", with no express or implied warranties of any kind,
+ * including, but not limited to, any implied warranties of merchantability
+ * or fitness for any particular purpose or warranties against infringement
+ * of any proprietary rights of a third party.
+ *
+ * Energy Micro AS will not be liable for any consequential, incidental, or
+ * special damages, or any other relief, or for any claim by any third party,
+ * arising from your use of this Software.
+ *
+ *****************************************************************************/
+
+/*
+   Host runner for the core clock configuration planner (clockplan.c).
+
+   Checks the enumeration against workloads with known valid sets,
+   checks that CLOCKPLAN_select() picks the lowest current of the
+   enumeration and that CLOCKPLAN_pareto() returns exactly the
+   non-dominated configurations, then reports the Pareto set of current
+   and wakeup latency for a few example workloads.
+*/
+
+#include <stdio.h>
+#include "clockplan.h"
+
+/** Oscillator names, as shown by clocks.c. */
+static const char * const clockplanrunOscName[] = { "LFRC", "LFX", "HFRC", "HFX" };
+
+/** Number of failed checks. */
+static int clockplanrunFailed;
+
+/***************************************************************************//**
+ * @brief
+ *   Record check result.
+ ******************************************************************************/
+static void clockplanrunCheck(bool ok, const char *what)
+{
+  if (!ok)
+  {
+    printf("check failed: %s\n", what);
+    clockplanrunFailed++;
+  }
+}
+
+/***************************************************************************//**
+ * @brief
+ *   true if a dominates b, matched or beaten on both, beaten on one.
+ ******************************************************************************/
+static bool clockplanrunDominates(const CLOCKPLAN_Config_TypeDef *a,
+                                  const CLOCKPLAN_Config_TypeDef *b)
+{
+  return a->currentNa <= b->currentNa && a->wakeUs <= b->wakeUs &&
+         (a->currentNa < b->currentNa || a->wakeUs < b->wakeUs);
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Check select and Pareto set against brute force over enumeration.
+ ******************************************************************************/
+static void clockplanrunCheckWorkload(const CLOCKPLAN_Workload_TypeDef *work)
+{
+  CLOCKPLAN_Config_TypeDef all[CLOCKPLAN_MAX_CONFIGS];
+  CLOCKPLAN_Config_TypeDef set[CLOCKPLAN_MAX_CONFIGS];
+  CLOCKPLAN_Config_TypeDef best;
+  bool found;
+  bool member;
+  bool dominated;
+  int  count;
+  int  kept;
+  int  lowest = -1;
+  int  i;
+  int  j;
+
+  count = CLOCKPLAN_enumerate(work, all);
+  for (i = 0; i < count; i++)
+  {
+    set[i] = all[i];
+    if (lowest < 0 || all[i].currentNa < all[lowest].currentNa)
+    {
+      lowest = i;
+    }
+  }
+
+  found = CLOCKPLAN_select(work, &best);
+  clockplanrunCheck(found == (count > 0), "select finds a configuration");
+  if (found && count)
+  {
+    clockplanrunCheck(best.currentNa == all[lowest].currentNa,
+                      "select picks lowest current");
+  }
+
+  kept = CLOCKPLAN_pareto(set, count);
+  for (i = 0; i < kept; i++)
+  {
+    for (j = 0; j < count; j++)
+    {
+      clockplanrunCheck(!clockplanrunDominates(&all[j], &set[i]),
+                        "Pareto member not dominated");
+    }
+    if (i)
+    {
+      clockplanrunCheck(set[i - 1].currentNa < set[i].currentNa,
+                        "Pareto set sorted, no duplicates");
+    }
+  }
+  for (j = 0; j < count; j++)
+  {
+    member = false;
+    dominated = false;
+    for (i = 0; i < kept; i++)
+    {
+      member |= set[i].currentNa == all[j].currentNa && set[i].wakeUs == all[j].wakeUs;
+      dominated |= clockplanrunDominates(&set[i], &all[j]);
+    }
+    clockplanrunCheck(member || dominated, "non-member dominated by member");
+  }
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Print Pareto set of workload.
+ ******************************************************************************/
+static void clockplanrunReport(const char *name, const CLOCKPLAN_Workload_TypeDef *work)
+{
+  CLOCKPLAN_Config_TypeDef set[CLOCKPLAN_MAX_CONFIGS];
+  int count;
+  int kept;
+  int i;
+
+  count = CLOCKPLAN_enumerate(work, set);
+  kept = CLOCKPLAN_pareto(set, count);
+
+  printf("\n%s: %lu cycles/s, core >= %lu Hz, HFPERCLK >= %lu Hz%s, wakeup <= %lu us\n",
+         name, (unsigned long)work->cycles, (unsigned long)work->coreFreqMin,
+         (unsigned long)work->perFreqMin, work->perInSleep ? " when idle" : "",
+         (unsigned long)work->wakeUs);
+  printf("  %d of %d configurations valid, Pareto set:\n", count, CLOCKPLAN_MAX_CONFIGS);
+  printf("  osc  band  div      core Hz  EM  wakeup us   current uA\n");
+  for (i = 0; i < kept; i++)
+  {
+    printf("  %-4s %4d %4d %12lu %3d %10lu %12.2f\n",
+           clockplanrunOscName[set[i].osc],
+           set[i].osc == clockplanOscHFRCO ? set[i].band : -1,
+           1 << set[i].div, (unsigned long)set[i].coreFreq, set[i].eMode,
+           (unsigned long)set[i].wakeUs, set[i].currentNa / 1000.0);
+  }
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Main function.
+ ******************************************************************************/
+int main(void)
+{
+  CLOCKPLAN_Config_TypeDef configs[CLOCKPLAN_MAX_CONFIGS];
+  CLOCKPLAN_Workload_TypeDef work;
+  int count;
+  int i;
+  bool ok;
+
+  /* Anything goes: all combinations valid */
+  work.cycles = 1;
+  work.coreFreqMin = 0;
+  work.perFreqMin = 0;
+  work.perInSleep = false;
+  work.wakeUs = 0xffffffff;
+  count = CLOCKPLAN_enumerate(&work, configs);
+  clockplanrunCheck(count == CLOCKPLAN_MAX_CONFIGS, "all configurations valid");
+  for (i = 0, ok = true; i < count; i++)
+  {
+    ok &= configs[i].eMode == 2;
+  }
+  clockplanrunCheck(ok, "EM2 when latency allows");
+  clockplanrunCheckWorkload(&work);
+
+  /* 20 MHz of cycles: HFRCO 21 and 28 MHz and HFXO, undivided */
+  work.cycles = 20000000;
+  count = CLOCKPLAN_enumerate(&work, configs);
+  clockplanrunCheck(count == 3, "20 MHz workload gives 3 configurations");
+  for (i = 0, ok = true; i < count; i++)
+  {
+    ok &= configs[i].div == 0 && configs[i].coreFreq >= 20000000;
+  }
+  clockplanrunCheck(ok, "20 MHz workload undivided");
+  clockplanrunCheckWorkload(&work);
+
+  /* Beyond HFXO: none */
+  work.cycles = 40000000;
+  clockplanrunCheck(CLOCKPLAN_enumerate(&work, configs) == 0, "40 MHz workload invalid");
+  clockplanrunCheckWorkload(&work);
+
+  /* 1 MHz HFPERCLK excludes LF oscillators */
+  work.cycles = 1;
+  work.perFreqMin = 1000000;
+  count = CLOCKPLAN_enumerate(&work, configs);
+  clockplanrunCheck(count == (CLOCKPLAN_SOURCES - 2) * CLOCKPLAN_DIVS,
+                    "HFPERCLK excludes LF oscillators");
+  for (i = 0, ok = true; i < count; i++)
+  {
+    ok &= configs[i].osc != clockplanOscLFRCO && configs[i].osc != clockplanOscLFXO;
+  }
+  clockplanrunCheck(ok, "no LF oscillator with HFPERCLK");
+
+  /* Peripherals running when idle: EM1 only */
+  work.perInSleep = true;
+  count = CLOCKPLAN_enumerate(&work, configs);
+  for (i = 0, ok = true; i < count; i++)
+  {
+    ok &= configs[i].eMode == 1;
+  }
+  clockplanrunCheck(ok, "EM1 when peripherals run when idle");
+  clockplanrunCheckWorkload(&work);
+
+  /* 100 us latency: HFXO only from EM1, LF core clock too slow to enter */
+  /* handler, as is 1.2 MHz divided by more than 8 */
+  work.perFreqMin = 0;
+  work.perInSleep = false;
+  work.wakeUs = 100;
+  count = CLOCKPLAN_enumerate(&work, configs);
+  for (i = 0, ok = true; i < count; i++)
+  {
+    ok &= configs[i].wakeUs <= 100;
+    ok &= configs[i].osc != clockplanOscLFRCO && configs[i].osc != clockplanOscLFXO;
+    ok &= configs[i].osc != clockplanOscHFXO || configs[i].eMode == 1;
+    ok &= configs[i].coreFreq >= 120000;
+  }
+  clockplanrunCheck(ok, "100 us latency limits");
+  /* Core clock >= 120 kHz: 4, 6, 7, 7, 8, 8 HFRCO band divisors, 9 HFXO */
+  clockplanrunCheck(count == 49, "100 us latency count");
+  clockplanrunCheckWorkload(&work);
+
+  /* Lowest core clock */
+  work.wakeUs = 0xffffffff;
+  work.coreFreqMin = 8000;
+  count = CLOCKPLAN_enumerate(&work, configs);
+  for (i = 0, ok = true; i < count; i++)
+  {
+    ok &= configs[i].coreFreq >= 8000;
+  }
+  clockplanrunCheck(ok, "core clock minimum");
+  clockplanrunCheckWorkload(&work);
+
+  /* Example workloads */
+  work.cycles = 50000;
+  work.coreFreqMin = 8000;
+  work.perFreqMin = 0;
+  work.perInSleep = false;
+  work.wakeUs = 1000;
+  clockplanrunReport("Sensor polling", &work);
+  clockplanrunCheckWorkload(&work);
+
+  work.cycles = 2000000;
+  work.perFreqMin = 1000000;
+  work.perInSleep = true;
+  work.wakeUs = 50;
+  clockplanrunReport("UART protocol", &work);
+  clockplanrunCheckWorkload(&work);
+
+  work.cycles = 12000000;
+  work.perFreqMin = 0;
+  work.perInSleep = false;
+  work.wakeUs = 5000;
+  clockplanrunReport("Signal processing", &work);
+  clockplanrunCheckWorkload(&work);
+
+  printf("\n%s\n", clockplanrunFailed ? "FAILED" : "passed");
+  return clockplanrunFailed != 0;
+}
@@ -0,0 +1,381 @@
+/**************************************************************************//**
+ * @file
+ * @brief Write-back cache for I2C EEPROM
+ * @author Energy Micro AS
+ * @version 3.20.0
+ ******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 Energy Micro AS, http://www.energymicro.com</b>
+ *******************************************************************************
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ * 4. The source and compiled code may only be used on Energy Micro "EFM32"
+ *    microcontrollers and "EFR4" radios.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: Energy Micro AS has no
+ * obligation to support this Software. Energy Micro AS is providing the
+ * Software "AS IS", with no express or implied warranties of any kind,
+ * including, but not limited to, any implied warranties of merchantability
+ * or fitness for any particular purpose or warranties against infringement
+ * of any proprietary rights of a third party.
+ *
+ * Energy Micro AS will not be liable for any consequential, incidental, or
+ * special damages, or any other relief, or for any claim by any third party,
+ * arising from your use of this Software.
+ *
+ *****************************************************************************/
+#include <string.h>
+#include "eepromq.h"
+#include "rtcdrv.h"
+#include "eecache.h"
+
+#if (EECACHE_PAGE_SIZE > 32)
+#error "Byte masks of a cache line hold at most 32 bytes"
+#endif
+
+/** Mask of all bytes in a line */
+#define EECACHE_ALL  (0xffffffffUL >> (32 - EECACHE_PAGE_SIZE))
+
+/** Cache line, holding one EEPROM page */
+typedef struct
+{
+  int      page;                     /**< Page held, -1 if none */
+  uint32_t valid;                    /**< Bytes holding EEPROM contents */
+  uint32_t dirty;                    /**< Bytes not yet written back */
+  uint32_t used;                     /**< Use count at last access */
+  uint8_t  data[EECACHE_PAGE_SIZE];
+} EECACHE_Line_TypeDef;
+
+static EECACHE_Line_TypeDef lines[EECACHE_LINES];
+
+static uint8_t       cacheAddr;
+static uint32_t      cacheDelay;
+static uint32_t      useCount;
+
+/** Flush delay is being timed */
+static volatile bool flushPending;
+/** Flush delay has passed */
+static volatile bool flushDue;
+
+/***************************************************************************//**
+ * @brief
+ *   RTCDRV callback at end of flush delay.
+ ******************************************************************************/
+static void EECACHE_timeout(void)
+{
+  flushPending = false;
+  flushDue     = true;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Write dirty bytes of line back. Dirty bytes separated only by valid
+ *   bytes are written in one burst, rewriting the valid bytes in between.
+ ******************************************************************************/
+static int EECACHE_writeBack(EECACHE_Line_TypeDef *line)
+{
+  unsigned int first;
+  unsigned int end;
+  int          ret;
+
+  while (line->dirty)
+  {
+    for (first = 0; !(line->dirty & (1UL << first)); first++)
+      ;
+    /* Extend burst while bytes are valid and dirty bytes remain beyond */
+    for (end = first + 1;
+         (end < EECACHE_PAGE_SIZE) && (line->valid & (1UL << end)) &&
+         (line->dirty >> end);
+         end++)
+      ;
+
+    ret = EEPROMQ_write(cacheAddr, line->page * EECACHE_PAGE_SIZE + first,
+                        &line->data[first], end - first);
+    if (ret < 0)
+    {
+      return ret;
+    }
+    line->dirty &= ~((EECACHE_ALL >> (EECACHE_PAGE_SIZE - (end - first))) << first);
+  }
+  return 0;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Find line holding page, or replace least recently used line with it.
+ ******************************************************************************/
+static int EECACHE_lookup(int page, EECACHE_Line_TypeDef **found)
+{
+  EECACHE_Line_TypeDef *line;
+  EECACHE_Line_TypeDef *victim = &lines[0];
+  int                  ret;
+  int                  i;
+
+  for (i = 0; i < EECACHE_LINES; i++)
+  {
+    line = &lines[i];
+    if (line->page == page)
+    {
+      line->used = ++useCount;
+      *found     = line;
+      return 0;
+    }
+    if ((victim->page >= 0) &&
+        ((line->page < 0) || (line->used < victim->used)))
+    {
+      victim = line;
+    }
+  }
+
+  ret = EECACHE_writeBack(victim);
+  if (ret < 0)
+  {
+    return ret;
+  }
+  victim->page  = page;
+  victim->valid = 0;
+  victim->used  = ++useCount;
+  *found        = victim;
+  return 0;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Read page into line, keeping bytes written but not yet written back.
+ ******************************************************************************/
+static int EECACHE_fill(EECACHE_Line_TypeDef *line)
+{
+  uint8_t      page[EECACHE_PAGE_SIZE];
+  unsigned int i;
+  int          ret;
+
+  ret = EEPROMQ_read(cacheAddr, line->page * EECACHE_PAGE_SIZE, page,
+                     EECACHE_PAGE_SIZE);
+  if (ret < 0)
+  {
+    return ret;
+  }
+  for (i = 0; i < EECACHE_PAGE_SIZE; i++)
+  {
+    if (!(line->valid & (1UL << i)))
+    {
+      line->data[i] = page[i];
+    }
+  }
+  line->valid = EECACHE_ALL;
+  return 0;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Initialize cache, empty.
+ *
+ * @param[in] addr
+ *   I2C address of EEPROM, in 8 bit format.
+ *
+ * @param[in] flushDelay
+ *   Milliseconds from first write to a clean cache until EECACHE_poll()
+ *   writes dirty data back. 0 to write back on EECACHE_sync() only.
+ ******************************************************************************/
+void EECACHE_init(uint8_t addr, uint32_t flushDelay)
+{
+  int i;
+
+  cacheAddr    = addr;
+  cacheDelay   = flushDelay;
+  useCount     = 0;
+  flushPending = false;
+  flushDue     = false;
+  for (i = 0; i < EECACHE_LINES; i++)
+  {
+    lines[i].page  = -1;
+    lines[i].valid = 0;
+    lines[i].dirty = 0;
+    lines[i].used  = 0;
+  }
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Read from EEPROM through cache.
+ *
+ * @return
+ *   Number of bytes read, less than len if reading beyond end of EEPROM.
+ *   Negative I2C transfer status on error.
+ ******************************************************************************/
+int EECACHE_read(unsigned int offset, uint8_t *data, unsigned int len)
+{
+  EECACHE_Line_TypeDef *line;
+  unsigned int         pos;
+  unsigned int         count;
+  uint32_t             mask;
+  int                  ret;
+
+  if (offset >= EECACHE_SIZE)
+  {
+    return 0;
+  }
+  if (len > EECACHE_SIZE - offset)
+  {
+    len = EECACHE_SIZE - offset;
+  }
+
+  for (pos = 0; pos < len; pos += count)
+  {
+    unsigned int start = (offset + pos) % EECACHE_PAGE_SIZE;
+
+    count = EECACHE_PAGE_SIZE - start;
+    if (count > len - pos)
+    {
+      count = len - pos;
+    }
+    ret = EECACHE_lookup((offset + pos) / EECACHE_PAGE_SIZE, &line);
+    if (ret < 0)
+    {
+      return ret;
+    }
+    mask = (EECACHE_ALL >> (EECACHE_PAGE_SIZE - count)) << start;
+    if ((line->valid & mask) != mask)
+    {
+      ret = EECACHE_fill(line);
+      if (ret < 0)
+      {
+        return ret;
+      }
+    }
+    memcpy(&data[pos], &line->data[start], count);
+  }
+  return (int) len;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Write to EEPROM through cache. Bytes are written back later, see
+ *   EECACHE_poll() and EECACHE_sync().
+ *
+ * @return
+ *   Number of bytes written, less than len if writing beyond end of EEPROM.
+ *   Negative I2C transfer status if a line could not be written back to
+ *   make room.
+ ******************************************************************************/
+int EECACHE_write(unsigned int offset, const uint8_t *data, unsigned int len)
+{
+  EECACHE_Line_TypeDef *line;
+  unsigned int         pos;
+  unsigned int         count;
+  unsigned int         i;
+  int                  ret;
+
+  if (offset >= EECACHE_SIZE)
+  {
+    return 0;
+  }
+  if (len > EECACHE_SIZE - offset)
+  {
+    len = EECACHE_SIZE - offset;
+  }
+
+  for (pos = 0; pos < len; pos += count)
+  {
+    unsigned int start = (offset + pos) % EECACHE_PAGE_SIZE;
+
+    count = EECACHE_PAGE_SIZE - start;
+    if (count > len - pos)
+    {
+      count = len - pos;
+    }
+    ret = EECACHE_lookup((offset + pos) / EECACHE_PAGE_SIZE, &line);
+    if (ret < 0)
+    {
+      return ret;
+    }
+    for (i = 0; i < count; i++)
+    {
+      uint32_t bit = 1UL << (start + i);
+
+      /* Rewriting a known byte with the same value costs no write cycle */
+      if ((line->valid & bit) && (line->data[start + i] == data[pos + i]))
+      {
+        continue;
+      }
+      line->data[start + i] = data[pos + i];
+      line->valid          |= bit;
+      line->dirty          |= bit;
+    }
+  }
+
+  if (cacheDelay && !flushPending && EECACHE_dirty())
+  {
+    flushPending = true;
+    RTCDRV_Trigger(cacheDelay, EECACHE_timeout);
+  }
+  return (int) len;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Write all dirty data back to EEPROM.
+ *
+ * @return
+ *   0 on success, negative I2C transfer status on error. Lines not written
+ *   back stay dirty.
+ ******************************************************************************/
+int EECACHE_sync(void)
+{
+  int ret;
+  int i;
+
+  flushDue = false;
+  for (i = 0; i < EECACHE_LINES; i++)
+  {
+    ret = EECACHE_writeBack(&lines[i]);
+    if (ret < 0)
+    {
+      return ret;
+    }
+  }
+  return 0;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Write dirty data back if the flush delay has passed. To be called from
+ *   the main loop, for instance after each wake up.
+ *
+ * @return
+ *   0 on success or nothing to do, negative I2C transfer status on error.
+ ******************************************************************************/
+int EECACHE_poll(void)
+{
+  if (!flushDue)
+  {
+    return 0;
+  }
+  return EECACHE_sync();
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Check if cache holds data not yet written back.
+ ******************************************************************************/
+bool EECACHE_dirty(void)
+{
+  int i;
+
+  for (i = 0; i < EECACHE_LINES; i++)
+  {
+    if (lines[i].dirty)
+    {
+      return true;
+    }
+  }
+  return false;
+}
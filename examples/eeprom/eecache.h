@@ -0,0 +1,92 @@
+/**************************************************************************//**
+ * @file
+ * @brief Write-back cache for I2C EEPROM
+ * @author Energy Micro AS
+ * @version 3.20.0
+ ******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 Energy Micro AS, http://www.energymicro.com</b>
+ *******************************************************************************
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ * 4. The source and compiled code may only be used on Energy Micro "EFM32"
+ *    microcontrollers and "EFR4" radios.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: Energy Micro AS has no
+ * obligation to support this Software. Energy Micro AS is providing the
+ * Software "AS IS", with no express or implied warranties of any kind,
+ * including, but not limited to, any implied warranties of merchantability
+ * or fitness for any particular purpose or warranties against infringement
+ * of any proprietary rights of a third party.
+ *
+ * Energy Micro AS will not be liable for any consequential, incidental, or
+ * special damages, or any other relief, or for any claim by any third party,
+ * arising from your use of this Software.
+ *
+ *****************************************************************************/
+#ifndef __EECACHE_H
+#define __EECACHE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "em_device.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+   RAM write-back cache in front of EEPROMQ_read() and EEPROMQ_write(),
+   so the core sleeps in EM1 through transfers and write cycles.
+
+   The cache holds EECACHE_LINES pages of the EEPROM. Reads are served from
+   the cache, a page missing from it is read in one transfer. Writes only
+   update the cache; bytes written with the value already stored are not
+   marked dirty. Dirty bytes of a page are written back in as few bursts
+   as possible, each within one page and so one EEPROM write cycle:
+
+   - by EECACHE_sync(),
+   - by EECACHE_poll() once the flush delay given to EECACHE_init() has
+     passed since the first write to a clean cache,
+   - when the line is needed for another page.
+
+   Data not yet written back is lost on reset or power failure. The flush
+   delay is timed with RTCDRV, which must not be used for anything else.
+   I2CQ_init() must have been called before use.
+*/
+
+/** EEPROM size, as the DVK EEPROM */
+#ifndef EECACHE_SIZE
+#define EECACHE_SIZE       0x100
+#endif
+
+/** EEPROM page size, the most bytes written in one write cycle */
+#ifndef EECACHE_PAGE_SIZE
+#define EECACHE_PAGE_SIZE  16
+#endif
+
+/** Number of pages held in the cache */
+#ifndef EECACHE_LINES
+#define EECACHE_LINES      4
+#endif
+
+void EECACHE_init(uint8_t addr, uint32_t flushDelay);
+int EECACHE_read(unsigned int offset, uint8_t *data, unsigned int len);
+int EECACHE_write(unsigned int offset, const uint8_t *data, unsigned int len);
+int EECACHE_sync(void);
+int EECACHE_poll(void);
+bool EECACHE_dirty(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,174 @@
+/**************************************************************************//**
+ * @file
+ * @brief EEPROM access on the I2C transaction queue
+ * @author Energy Micro AS
+ * @version 3.20.0
+ ******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 Energy Micro AS, http://www.energymicro.com</b>
+ *******************************************************************************
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ * 4. The source and compiled code may only be used on Energy Micro "EFM32"
+ *    microcontrollers and "EFR4" radios.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: Energy Micro AS has no
+ * obligation to support this Software. Energy Micro AS is providing the
+ * Software "AS IS", with no express or implied warranties of any kind,
+ * including, but not limited to, any implied warranties of merchantability
+ * or fitness for any particular purpose or warranties against infringement
+ * of any proprietary rights of a third party.
+ *
+ * Energy Micro AS will not be liable for any consequential, incidental, or
+ * special damages, or any other relief, or for any claim by any third party,
+ * arising from your use of this Software.
+ *
+ *****************************************************************************/
+#include <stddef.h>
+#include "em_device.h"
+#include "em_i2c.h"
+#include "i2cq.h"
+#include "eepromq.h"
+
+/** Transfer in progress, reused for polling the write cycle */
+static I2CQ_Transfer_TypeDef transfer;
+
+/** EEPROM word address sent first in transfer */
+static uint8_t               wordAddr;
+
+/** Polls left before giving up on the write cycle */
+static int                   pollsLeft;
+
+/***************************************************************************//**
+ * @brief
+ *   Callback of page write and write cycle polling. The EEPROM does not
+ *   acknowledge its address during a write cycle, so polling is submitted
+ *   again until it does. A page write is not acknowledged either while an
+ *   earlier write cycle is still running, and is retried the same way.
+ ******************************************************************************/
+static void EEPROMQ_writeDone(I2CQ_Transfer_TypeDef *t, int status)
+{
+  if ((status == i2cTransferNack) && (--pollsLeft > 0))
+  {
+    I2CQ_submit(t);
+    return;
+  }
+  if ((status == i2cTransferDone) && (t->seq.flags == I2C_FLAG_WRITE_WRITE))
+  {
+    /* Page written, poll with address only until the write cycle ends */
+    t->seq.flags      = I2C_FLAG_WRITE;
+    t->seq.buf[0].len = 0;
+    pollsLeft         = EEPROMQ_POLLS;
+    I2CQ_submit(t);
+  }
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Read from EEPROM.
+ *
+ * @param[in] addr
+ *   I2C address of EEPROM, in 8 bit format.
+ *
+ * @return
+ *   Number of bytes read, less than len if reading beyond end of EEPROM.
+ *   Negative I2C transfer status on error.
+ ******************************************************************************/
+int EEPROMQ_read(uint8_t addr, unsigned int offset, uint8_t *data,
+                 unsigned int len)
+{
+  int ret;
+
+  if (offset >= EEPROMQ_SIZE)
+  {
+    return 0;
+  }
+  if (len > EEPROMQ_SIZE - offset)
+  {
+    len = EEPROMQ_SIZE - offset;
+  }
+
+  wordAddr                 = (uint8_t) offset;
+  transfer.seq.addr        = addr;
+  transfer.seq.flags       = I2C_FLAG_WRITE_READ;
+  transfer.seq.buf[0].data = &wordAddr;
+  transfer.seq.buf[0].len  = 1;
+  transfer.seq.buf[1].data = data;
+  transfer.seq.buf[1].len  = len;
+  transfer.done            = NULL;
+  transfer.timeout         = 0;
+  I2CQ_submit(&transfer);
+  ret = I2CQ_wait(&transfer);
+  if (ret != i2cTransferDone)
+  {
+    return ret;
+  }
+  return (int) len;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Write to EEPROM, one transfer and write cycle per page written. Returns
+ *   when the last write cycle has ended.
+ *
+ * @param[in] addr
+ *   I2C address of EEPROM, in 8 bit format.
+ *
+ * @return
+ *   Number of bytes written, less than len if writing beyond end of EEPROM.
+ *   Negative I2C transfer status on error, pages before the failing one are
+ *   written.
+ ******************************************************************************/
+int EEPROMQ_write(uint8_t addr, unsigned int offset, const uint8_t *data,
+                  unsigned int len)
+{
+  unsigned int pos;
+  unsigned int count;
+  int          ret;
+
+  if (offset >= EEPROMQ_SIZE)
+  {
+    return 0;
+  }
+  if (len > EEPROMQ_SIZE - offset)
+  {
+    len = EEPROMQ_SIZE - offset;
+  }
+
+  for (pos = 0; pos < len; pos += count)
+  {
+    count = EEPROMQ_PAGE_SIZE - ((offset + pos) % EEPROMQ_PAGE_SIZE);
+    if (count > len - pos)
+    {
+      count = len - pos;
+    }
+
+    wordAddr                 = (uint8_t)(offset + pos);
+    transfer.seq.addr        = addr;
+    transfer.seq.flags       = I2C_FLAG_WRITE_WRITE;
+    transfer.seq.buf[0].data = &wordAddr;
+    transfer.seq.buf[0].len  = 1;
+    transfer.seq.buf[1].data = (uint8_t *) &data[pos];
+    transfer.seq.buf[1].len  = count;
+    transfer.done            = EEPROMQ_writeDone;
+    transfer.timeout         = 0;
+    pollsLeft                = EEPROMQ_POLLS;
+    I2CQ_submit(&transfer);
+
+    /* Callbacks keep the transfer in progress until the write cycle ends */
+    ret = I2CQ_wait(&transfer);
+    if (ret != i2cTransferDone)
+    {
+      return ret;
+    }
+  }
+  return (int) len;
+}
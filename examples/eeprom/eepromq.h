@@ -0,0 +1,83 @@
+/**************************************************************************//**
+ * @file
+ * @brief EEPROM access on the I2C transaction queue
+ * @author Energy Micro AS
+ * @version 3.20.0
+ ******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 Energy Micro AS, http://www.energymicro.com</b>
+ *******************************************************************************
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ * 4. The source and compiled code may only be used on Energy Micro "EFM32"
+ *    microcontrollers and "EFR4" radios.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: Energy Micro AS has no
+ * obligation to support this Software. Energy Micro AS is providing the
+ * Software "AS IS", with no express or implied warranties of any kind,
+ * including, but not limited to, any implied warranties of merchantability
+ * or fitness for any particular purpose or warranties against infringement
+ * of any proprietary rights of a third party.
+ *
+ * Energy Micro AS will not be liable for any consequential, incidental, or
+ * special damages, or any other relief, or for any claim by any third party,
+ * arising from your use of this Software.
+ *
+ *****************************************************************************/
+#ifndef __EEPROMQ_H
+#define __EEPROMQ_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+   EEPROM read and write on the I2C transaction queue, in place of the
+   polled EEPROM_Read() and EEPROM_Write().
+
+   Each call submits its transfers to the queue and sleeps in EM1 with
+   I2CQ_wait() until done. A write is split at page boundaries; the
+   callback of each page write chains polling for the end of the EEPROM
+   write cycle, repeated from its own callback until the EEPROM acknowledges
+   again, so the core also sleeps through the write cycle.
+
+   I2CQ_init() must have been called. Not to be called from interrupt, and
+   only one call at a time, as the transfer descriptor is shared.
+*/
+
+/** EEPROM size, as the DVK EEPROM */
+#ifndef EEPROMQ_SIZE
+#define EEPROMQ_SIZE       0x100
+#endif
+
+/** EEPROM page size, the most bytes written in one write cycle */
+#ifndef EEPROMQ_PAGE_SIZE
+#define EEPROMQ_PAGE_SIZE  16
+#endif
+
+/** Polls of the EEPROM before a write cycle is taken to have failed. A poll
+    takes some 110 us at standard rate, the write cycle at most 5 ms. */
+#ifndef EEPROMQ_POLLS
+#define EEPROMQ_POLLS      1000
+#endif
+
+int EEPROMQ_read(uint8_t addr, unsigned int offset, uint8_t *data,
+                 unsigned int len);
+int EEPROMQ_write(uint8_t addr, unsigned int offset, const uint8_t *data,
+                  unsigned int len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
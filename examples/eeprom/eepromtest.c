@@ -5,8 +5,8 @@
  *   Read/write data to EEPROM on DVK.
  *
  * @par Usage
- * @li Joystick Up/Down increases/decreases data stored in first 3 bytes.
- *       of EEPROM.
+ * @li Joystick Up/Down increases/decreases 3 bytes of data stored in
+ *       EEPROM, under a key of the wear-leveled key/value store.
  *
  * @note
  *   This example requires BSP version 1.0.6 or later.
@@ -47,7 +47,7 @@
 #include "em_device.h"
 #include "em_emu.h"
 #include "em_dbg.h"
-#include "em_gpio.h"
+#include "em_int.h"
 #include "em_chip.h"
 #include "bsp.h"
 #include "bsp_trace.h"
@@ -55,85 +55,65 @@
 #include "rtcdrv.h"
 #include "i2cdrv.h"
 #include "eeprom.h"
+#include "i2cq.h"
+#include "eecache.h"
+#include "kvstore.h"
+#include "keyinput.h"
 
-/** Interrupt pin used to detect joystick activity */
-#define GPIO_INT_PIN 14
+/** Milliseconds from a change until it is written to EEPROM */
+#define EEPROM_FLUSH_DELAY 2000
 
-/** Byte stored in first 3 bytes of EEPROM */
-static volatile uint8_t eepromData;
+/** Key/value store key of the 3 bytes of data */
+#define EEPROM_DATA_KEY 1
 
-/** Reset first 3 bytes of EEPROM to 0xFF */
-static volatile bool eepromReset = false;
+/** Byte stored in first of the 3 bytes of data */
+static uint8_t eepromData;
+
+/** Reset the 3 bytes of data to 0xFF */
+static bool eepromReset = false;
 
 /* Local prototypes */
-void eepromtestIRQInit(void);
+void eepromtestKey(const KEYQ_Event_TypeDef *event);
 void eepromtestUpdateLCD(uint8_t *data);
 
 /**************************************************************************//**
- * @brief GPIO Interrupt handler
- * This interrupt handler is not an example of good design, as it will do
- * a lot of operations inside the interrupt handler.
+ * @brief Handle joystick or push button event
+ * @param[in] event Key event.
  *****************************************************************************/
-void GPIO_EVEN_IRQHandler(void)
+void eepromtestKey(const KEYQ_Event_TypeDef *event)
 {
-  uint16_t joystick;
-  uint16_t pb;
-
-  /* Clear interrupt */
-  BSP_InterruptFlagsClear(BC_INTEN_JOYSTICK);
-  BSP_InterruptFlagsClear(BC_INTEN_PB);
-  GPIO_IntClear(1 << GPIO_INT_PIN);
-
-  /* LEDs on to indicate joystick used */
-  BSP_LedsSet(0xffff);
-
-  /* Read and store joystick activity - wait for key release */
-  joystick = BSP_JoystickGet();
-  while (BSP_JoystickGet());
-
-  /* Read and store pushbutton activity - wait for key release */
-  pb = BSP_PushButtonsGet();
-  while (BSP_PushButtonsGet());
-
-  /* LEDs off to indicate joystick release */
-  BSP_LedsSet(0x0000);
+  /* LEDs on while key used */
+  if (event->type == keyqRelease)
+  {
+    BSP_LedsSet(0x0000);
+    return;
+  }
+  if (event->type == keyqPress)
+  {
+    BSP_LedsSet(0xffff);
+  }
 
-  /* Up increases data to store in EEPROM */
-  if (joystick & BC_JOYSTICK_UP)
+  /* Up increases data to store in EEPROM, repeated while held */
+  if (event->key & BC_JOYSTICK_UP)
   {
     eepromData++;
   }
 
-  /* Down decreases data to store in EEPROM */
-  if (joystick & BC_JOYSTICK_DOWN)
+  /* Down decreases data to store in EEPROM, repeated while held */
+  if (event->key & BC_JOYSTICK_DOWN)
   {
     eepromData--;
   }
 
   /* Reset modified data to factory default */
-  if (pb & BC_PUSHBUTTON_SW4)
+  if ((event->key & (BC_PUSHBUTTON_SW4 << KEYINPUT_PB_SHIFT)) &&
+      (event->type == keyqPress))
   {
     eepromReset = true;
   }
 }
 
 
-/**************************************************************************//**
- * @brief Initialize GPIO interrupt for joystick (ie FPGA signal)
- *****************************************************************************/
-void eepromtestIRQInit(void)
-{
-  /* Configure interrupt pin as input with pull-up */
-  GPIO_PinModeSet(gpioPortC, GPIO_INT_PIN, gpioModeInputPull, 1);
-
-  /* Set falling edge interrupt and clear/enable it */
-  GPIO_IntConfig(gpioPortC, GPIO_INT_PIN, false, true, true);
-
-  NVIC_ClearPendingIRQ(GPIO_EVEN_IRQn);
-  NVIC_EnableIRQ(GPIO_EVEN_IRQn);
-}
-
-
 /**************************************************************************//**
  * @brief Update LCD with data stored
  * @param[in] data Data to dispaly in hex.
@@ -186,6 +166,7 @@ int main(void)
 {
   I2C_Init_TypeDef i2cInit = I2C_INIT_DEFAULT;
   uint8_t data[3];
+  KEYQ_Event_TypeDef event;
 
   /* Chip revision alignment and errata fixes */
   CHIP_Init();
@@ -201,18 +182,31 @@ int main(void)
 
   SegmentLCD_AllOff();
 
-  /* Enable board control interrupts */
-  BSP_InterruptDisable(0xffff);
-  BSP_InterruptFlagsClear(0xffff);
-  BSP_InterruptEnable(BC_INTEN_JOYSTICK);
-  BSP_InterruptEnable(BC_INTEN_PB);
-  eepromtestIRQInit();
+  /* Joystick and push button events */
+  KEYINPUT_init(BC_INTEN_JOYSTICK | BC_INTEN_PB);
 
   /* Initialize I2C driver, using standard rate. Devices on DVK itself */
   /* supports fast mode, but in case some slower devices are added on */
   /* prototype board, we use standard mode. */
   I2CDRV_Init(&i2cInit);
 
+  /* EEPROM transfers go through the interrupt driven queue, so the core */
+  /* sleeps in EM1 during transfers and write cycles instead of polling. */
+  I2CQ_init(I2C0);
+
+  /* Access EEPROM through write-back cache, so that a series of changes */
+  /* is written once, and data displayed is not read from the bus again. */
+  EECACHE_init(EEPROM_DVK_ADDR, EEPROM_FLUSH_DELAY);
+
+  /* Data is kept in a log-structured store, so that each change is */
+  /* written to the next free space instead of the same EEPROM page. */
+  if (KVSTORE_mount(EEPROM_DVK_ADDR) < 0)
+  {
+    SegmentLCD_Write("RD ERR");
+    /* Enter EM2, no wakeup scheduled */
+    EMU_EnterEM2(true);
+  }
+
   /* Main loop - just read data and update LCD */
   while (1)
   {
@@ -225,7 +219,7 @@ int main(void)
       data[0] = 0xFF;
       data[1] = 0xFF;
       data[2] = 0xFF;
-      if (EEPROM_Write(I2C0, EEPROM_DVK_ADDR, 0, data, 3) < 0)
+      if ((KVSTORE_put(EEPROM_DATA_KEY, data, 3) < 0) || (EECACHE_sync() < 0))
       {
         SegmentLCD_Write("RST ERR");
         /* Enter EM2, no wakeup scheduled */
@@ -233,18 +227,37 @@ int main(void)
       }
     }
 
-    if (EEPROM_Read(I2C0, EEPROM_DVK_ADDR, 0, data, 3) < 0)
+    /* Values are held in RAM once mounted. No value stored yet means */
+    /* factory default. */
+    if (KVSTORE_get(EEPROM_DATA_KEY, data, 3) != 3)
     {
-      SegmentLCD_Write("RD ERR");
-      /* Enter EM2, no wakeup scheduled */
-      EMU_EnterEM2(true);
+      data[0] = 0xFF;
+      data[1] = 0xFF;
+      data[2] = 0xFF;
     }
 
     eepromData = data[0];
     eepromtestUpdateLCD(data);
 
-    /* Just enter EM2 until joystick pressed */
-    EMU_EnterEM2(true);
+    /* Just enter EM2 until key event, or flush delay passed */
+    INT_Disable();
+    if (!KEYINPUT_pending())
+    {
+      EMU_EnterEM2(true);
+    }
+    INT_Enable();
+
+    while (KEYINPUT_get(&event))
+    {
+      eepromtestKey(&event);
+    }
+
+    if (EECACHE_poll() < 0)
+    {
+      SegmentLCD_Write("WR ERR");
+      /* Enter EM2, no wakeup scheduled */
+      EMU_EnterEM2(true);
+    }
 
     /* Data changed by user? */
     if (eepromData != data[0])
@@ -252,7 +265,7 @@ int main(void)
       data[0] = eepromData;
       data[1] = eepromData + 1;
       data[2] = eepromData + 2;
-      if (EEPROM_Write(I2C0, EEPROM_DVK_ADDR, 0, data, 3) < 0)
+      if (KVSTORE_put(EEPROM_DATA_KEY, data, 3) < 0)
       {
         SegmentLCD_Write("WR ERR");
         /* Enter EM2, no wakeup scheduled */
@@ -0,0 +1,234 @@
+/**************************************************************************//**
+ * @file
+ * @brief Host runner comparing EEPROM traffic with and without write-back cache
+ * @author Energy Micro AS
+ * @version 3.20.0
+ ******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 Energy Micro AS, http://www.energymicro.com</b>
+ *******************************************************************************
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ * 4. The source and compiled code may only be used on Energy Micro "EFM32"
+ *    microcontrollers and "EFR4" radios.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: Energy Micro AS has no
+ * obligation to support this Software. Energy Micro AS is providing the
+ * Software "AS IS", with no express or implied warranties of any kind,
+ * including, but not limited to, any implied warranties of merchantability
+ * or fitness for any particular purpose or warranties against infringement
+ * of any proprietary rights of a third party.
+ *
+ * Energy Micro AS will not be liable for any consequential, incidental, or
+ * special damages, or any other relief, or for any claim by any third party,
+ * arising from your use of this Software.
+ *
+ *****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "eeprom.h"
+#include "eepromsim.h"
+#include "eecache.h"
+
+/*
+   Runs the access pattern of eepromtest.c against the simulated EEPROM,
+   directly and through the write-back cache, and compares bus traffic and
+   write cycles. Joystick presses come in bursts; each one writes 3 bytes
+   and the main loop then reads them back. Finally checks the cache against
+   a plain copy of the EEPROM with random reads, writes and syncs.
+*/
+
+/** Workload, see usage */
+static int      events     = 100;
+static uint32_t interval   = 250;
+static int      burst      = 10;
+static uint32_t idle       = 10000;
+static uint32_t flushDelay = 2000;
+
+/***************************************************************************//**
+ * @brief
+ *   Print counters of a run.
+ ******************************************************************************/
+static void printStats(const char *name)
+{
+  printf("%-8s %10lu %10lu %12lu %10lu %10.1f\n", name,
+         (unsigned long) EEPROMSIM_stats.transfers,
+         (unsigned long) EEPROMSIM_stats.busBytes,
+         (unsigned long) EEPROMSIM_stats.writeCycles,
+         (unsigned long) EEPROMSIM_maxPageWrites(),
+         EEPROMSIM_busTime() / 1000.0);
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Run eepromtest main loop pattern, through cache or directly.
+ ******************************************************************************/
+static void runPattern(int cached, uint8_t *result)
+{
+  uint8_t data[3];
+  uint8_t value;
+  int     i;
+
+  EEPROMSIM_reset();
+  EECACHE_init(EEPROM_DVK_ADDR, flushDelay);
+
+  if (cached)
+  {
+    EECACHE_read(0, data, 3);
+  }
+  else
+  {
+    EEPROM_Read(I2C0, EEPROM_DVK_ADDR, 0, data, 3);
+  }
+  value = data[0];
+
+  for (i = 0; i < events; i++)
+  {
+    /* In EM2 until the next press, or woken by the flush delay */
+    EEPROMSIM_advance(((i % burst) == 0) ? idle : interval);
+
+    value++;
+    data[0] = value;
+    data[1] = value + 1;
+    data[2] = value + 2;
+    if (cached)
+    {
+      EECACHE_poll();
+      EECACHE_write(0, data, 3);
+      EECACHE_read(0, data, 3);
+    }
+    else
+    {
+      EEPROM_Write(I2C0, EEPROM_DVK_ADDR, 0, data, 3);
+      EEPROM_Read(I2C0, EEPROM_DVK_ADDR, 0, data, 3);
+    }
+  }
+
+  /* Let the last flush delay pass, and sync in case there is none */
+  EEPROMSIM_advance(idle);
+  EECACHE_poll();
+  EECACHE_sync();
+  memcpy(result, EEPROMSIM_memory, EEPROMSIM_SIZE);
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Random access check of cache against a plain copy of the EEPROM.
+ ******************************************************************************/
+static int randomCheck(int ops)
+{
+  static uint8_t copy[EEPROMSIM_SIZE];
+  uint8_t        data[64];
+  uint8_t        check[64];
+  unsigned int   offset;
+  unsigned int   len;
+  unsigned int   i;
+  int            n;
+
+  srand(1);
+  EEPROMSIM_reset();
+  EECACHE_init(EEPROM_DVK_ADDR, 0);
+  memcpy(copy, EEPROMSIM_memory, sizeof(copy));
+
+  for (n = 0; n < ops; n++)
+  {
+    offset = rand() % (EEPROMSIM_SIZE + 8);
+    len    = 1 + rand() % sizeof(data);
+    switch (rand() % 8)
+    {
+    case 0:
+      if ((EECACHE_sync() < 0) || memcmp(copy, EEPROMSIM_memory, sizeof(copy)))
+      {
+        printf("sync mismatch at operation %d\n", n);
+        return 0;
+      }
+      break;
+
+    case 1:
+    case 2:
+    case 3:
+      for (i = 0; i < len; i++)
+      {
+        data[i] = (uint8_t) rand();
+      }
+      if (EECACHE_write(offset, data, len) !=
+          (int)((offset >= EEPROMSIM_SIZE) ? 0 :
+                (len > EEPROMSIM_SIZE - offset) ? EEPROMSIM_SIZE - offset : len))
+      {
+        printf("write length wrong at operation %d\n", n);
+        return 0;
+      }
+      for (i = 0; (i < len) && (offset + i < EEPROMSIM_SIZE); i++)
+      {
+        copy[offset + i] = data[i];
+      }
+      break;
+
+    default:
+      memset(check, 0, sizeof(check));
+      EECACHE_read(offset, check, len);
+      for (i = 0; (i < len) && (offset + i < EEPROMSIM_SIZE); i++)
+      {
+        if (check[i] != copy[offset + i])
+        {
+          printf("read mismatch at operation %d, offset %u\n", n, offset + i);
+          return 0;
+        }
+      }
+      break;
+    }
+  }
+  EECACHE_sync();
+  return memcmp(copy, EEPROMSIM_memory, sizeof(copy)) == 0;
+}
+
+int main(int argc, char *argv[])
+{
+  static uint8_t direct[EEPROMSIM_SIZE];
+  static uint8_t cached[EEPROMSIM_SIZE];
+  int            ok;
+
+  if (argc > 1)
+  {
+    events = atoi(argv[1]);
+  }
+  if (argc > 2)
+  {
+    flushDelay = (uint32_t) atoi(argv[2]);
+  }
+  if ((argc > 3) || (events <= 0))
+  {
+    fprintf(stderr, "Usage: %s [events] [flush delay ms]\n", argv[0]);
+    return 1;
+  }
+
+  printf("%d presses, in bursts of %d %lu ms apart, %lu ms idle between bursts, "
+         "flush delay %lu ms\n\n", events, burst, (unsigned long) interval,
+         (unsigned long) idle, (unsigned long) flushDelay);
+  printf("%-8s %10s %10s %12s %10s %10s\n",
+         "", "transfers", "bus bytes", "write cycles", "max page", "bus ms");
+  runPattern(0, direct);
+  printStats("direct");
+  runPattern(1, cached);
+  printStats("cached");
+
+  ok = (memcmp(direct, cached, sizeof(direct)) == 0);
+  printf("\nEEPROM contents %s\n", ok ? "match" : "DIFFER");
+
+  if (!randomCheck(100000))
+  {
+    printf("Random access check FAILED\n");
+    return 1;
+  }
+  printf("Random access check ok\n");
+  return ok ? 0 : 1;
+}
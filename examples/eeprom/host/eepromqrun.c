@@ -0,0 +1,218 @@
+/**************************************************************************//**
+ * @file
+ * @brief Host runner for EEPROM access on the I2C transaction queue
+ * @author Energy Micro AS
+ * @version 3.20.0
+ ******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 Energy Micro AS, http://www.energymicro.com</b>
+ *******************************************************************************
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ * 4. The source and compiled code may only be used on Energy Micro "EFM32"
+ *    microcontrollers and "EFR4" radios.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: Energy Micro AS has no
+ * obligation to support this Software. Energy Micro AS is providing the
+ * Software "AS IS", with no express or implied warranties of any kind,
+ * including, but not limited to, any implied warranties of merchantability
+ * or fitness for any particular purpose or warranties against infringement
+ * of any proprietary rights of a third party.
+ *
+ * Energy Micro AS will not be liable for any consequential, incidental, or
+ * special damages, or any other relief, or for any claim by any third party,
+ * arising from your use of this Software.
+ *
+ *****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "em_device.h"
+#include "em_i2c.h"
+#include "eeprom.h"
+#include "eepromsim.h"
+#include "i2csim.h"
+#include "i2cq.h"
+#include "eepromq.h"
+#include "eecache.h"
+
+/*
+   Host runner for EEPROM access on the I2C transaction queue, on the
+   simulated DVK I2C bus.
+
+   Access: writes across page boundaries, each page written in its own write
+   cycle with polling chained from the callbacks, and reads, must match the
+   EEPROM contents. Shows the share of time the core sleeps in EM1.
+
+   Cache: the write-back cache on the queue, as in eepromtest, against a
+   plain copy of the EEPROM with random reads, writes and syncs.
+
+   Missing device: a write to an address nothing answers must fail with
+   NACK once the polls are used up, not hang.
+*/
+
+/** Operations of cache check */
+#define TEST_OPS  2000
+
+/***************************************************************************//**
+ * @brief
+ *   Write across pages and read back.
+ ******************************************************************************/
+static int accessTest(void)
+{
+  uint8_t  data[EEPROMSIM_SIZE];
+  uint8_t  read[EEPROMSIM_SIZE];
+  uint32_t writeTime;
+  int      i;
+
+  I2CSIM_reset();
+  EEPROMSIM_reset();
+  I2CQ_init(I2C0);
+
+  for (i = 0; i < EEPROMSIM_SIZE; i++)
+  {
+    data[i] = (uint8_t) rand();
+  }
+  /* First and last page partly, three whole pages in between */
+  if ((EEPROMQ_write(EEPROM_DVK_ADDR, 10, &data[10], 68) != 68) ||
+      (EEPROMQ_write(EEPROM_DVK_ADDR, 250, &data[250], 16) != 6))
+  {
+    printf("access: write failed\n");
+    return 0;
+  }
+  writeTime = I2CSIM_stats.time;
+  if (I2CSIM_stats.hangs || I2CQ_busy() ||
+      memcmp(&EEPROMSIM_memory[10], &data[10], 68) ||
+      memcmp(&EEPROMSIM_memory[250], &data[250], 6) ||
+      (EEPROMSIM_memory[9] != 0xff) || (EEPROMSIM_memory[78] != 0xff))
+  {
+    printf("access: EEPROM contents wrong after write\n");
+    return 0;
+  }
+  printf("access: 74 bytes in 6 write cycles, %.1f ms, core in EM1 %.1f%%\n",
+         writeTime / 1000.0, 100.0 * I2CSIM_stats.sleepTime / writeTime);
+
+  /* Write cycles ended before returning, so reads are acknowledged at once */
+  if ((EEPROMQ_read(EEPROM_DVK_ADDR, 0, read, EEPROMSIM_SIZE) != EEPROMSIM_SIZE) ||
+      memcmp(read, EEPROMSIM_memory, EEPROMSIM_SIZE) ||
+      (EEPROMQ_read(EEPROM_DVK_ADDR, 250, read, 16) != 6) ||
+      (EEPROMQ_read(EEPROM_DVK_ADDR, EEPROMSIM_SIZE, read, 1) != 0))
+  {
+    printf("access: read back wrong\n");
+    return 0;
+  }
+  return !I2CSIM_stats.hangs;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Cache on the queue against a copy, random reads, writes and syncs.
+ ******************************************************************************/
+static int cacheTest(void)
+{
+  static uint8_t copy[EEPROMSIM_SIZE];
+  uint8_t        data[24];
+  unsigned int   offset;
+  unsigned int   len;
+  unsigned int   i;
+  int            op;
+
+  I2CSIM_reset();
+  EEPROMSIM_reset();
+  I2CQ_init(I2C0);
+  EECACHE_init(EEPROM_DVK_ADDR, 0);
+  memcpy(copy, EEPROMSIM_memory, sizeof(copy));
+
+  for (op = 0; op < TEST_OPS; op++)
+  {
+    offset = (unsigned int)(rand() % (EEPROMSIM_SIZE - sizeof(data)));
+    len    = 1 + (unsigned int)(rand() % sizeof(data));
+    switch (rand() % 8)
+    {
+    case 0:
+      if ((EECACHE_sync() < 0) || memcmp(copy, EEPROMSIM_memory, sizeof(copy)))
+      {
+        printf("cache: EEPROM differs after sync\n");
+        return 0;
+      }
+      break;
+    case 1:
+    case 2:
+    case 3:
+      if ((EECACHE_read(offset, data, len) != (int) len) ||
+          memcmp(data, &copy[offset], len))
+      {
+        printf("cache: read wrong\n");
+        return 0;
+      }
+      break;
+    default:
+      for (i = 0; i < len; i++)
+      {
+        data[i] = (uint8_t)(rand() % 4);
+      }
+      if (EECACHE_write(offset, data, len) != (int) len)
+      {
+        printf("cache: write failed\n");
+        return 0;
+      }
+      memcpy(&copy[offset], data, len);
+      break;
+    }
+  }
+  if ((EECACHE_sync() < 0) || memcmp(copy, EEPROMSIM_memory, sizeof(copy)) ||
+      I2CSIM_stats.hangs)
+  {
+    printf("cache: EEPROM differs after sync\n");
+    return 0;
+  }
+  printf("cache: %d random operations, %.1f ms, core in EM1 %.1f%%\n",
+         TEST_OPS, I2CSIM_stats.time / 1000.0,
+         100.0 * I2CSIM_stats.sleepTime / I2CSIM_stats.time);
+  return 1;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Write to missing device.
+ ******************************************************************************/
+static int missingTest(void)
+{
+  uint8_t data = 0;
+  int     ret;
+
+  I2CSIM_reset();
+  I2CQ_init(I2C0);
+  ret = EEPROMQ_write(0xb0, 0, &data, 1);
+  if ((ret != i2cTransferNack) || I2CSIM_stats.hangs || I2CQ_busy())
+  {
+    printf("missing: write returned %d\n", ret);
+    return 0;
+  }
+  printf("missing: NACK after %d polls, %.1f ms\n", EEPROMQ_POLLS,
+         I2CSIM_stats.time / 1000.0);
+  return 1;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Main function.
+ ******************************************************************************/
+int main(void)
+{
+  if (!accessTest() || !cacheTest() || !missingTest())
+  {
+    printf("FAILED\n");
+    return 1;
+  }
+  printf("passed\n");
+  return 0;
+}
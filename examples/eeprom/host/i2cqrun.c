@@ -0,0 +1,419 @@
+/**************************************************************************//**
+ * @file
+ * @brief Host runner for ordering, timeouts and throughput of the I2C queue
+ * @author Energy Micro AS
+ * @version 3.20.0
+ ******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 Energy Micro AS, http://www.energymicro.com</b>
+ *******************************************************************************
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ * 4. The source and compiled code may only be used on Energy Micro "EFM32"
+ *    microcontrollers and "EFR4" radios.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: Energy Micro AS has no
+ * obligation to support this Software. Energy Micro AS is providing the
+ * Software "AS IS", with no express or implied warranties of any kind,
+ * including, but not limited to, any implied warranties of merchantability
+ * or fitness for any particular purpose or warranties against infringement
+ * of any proprietary rights of a third party.
+ *
+ * Energy Micro AS will not be liable for any consequential, incidental, or
+ * special damages, or any other relief, or for any claim by any third party,
+ * arising from your use of this Software.
+ *
+ *****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "em_device.h"
+#include "em_i2c.h"
+#include "eeprom.h"
+#include "eepromsim.h"
+#include "i2csim.h"
+#include "i2cq.h"
+
+/*
+   Host runner for the I2C transaction queue on the simulated DVK I2C bus.
+
+   Ordering: EEPROM page writes, each chained from its callback to polling
+   for the end of the write cycle, are queued together with temperature
+   reads. Transfers must complete in the order submitted, and the pages
+   read back as written.
+
+   Timeout: with the temperature sensor holding the clock low, its read
+   must time out while the EEPROM reads before and after it complete.
+
+   Throughput: temperature reads, each result taking some processing, run
+   one at a time and queued back to back. Shows transfers per second, bus
+   use, and the share of time the core sleeps in EM1; a polled driver keeps
+   the core awake all the time.
+*/
+
+/** Pages written in ordering test */
+#define TEST_PAGES      8
+
+/** Temperature reads, and core time to process each result, us */
+#define TEST_READS      200
+#define TEST_PROCESS_US 150
+
+/** Request: one transfer, or a write and the polling chained to it */
+typedef struct
+{
+  I2CQ_Transfer_TypeDef transfer;
+  uint8_t               offset;
+  uint8_t               data[EEPROMSIM_PAGE_SIZE];
+  uint8_t               temp[2];
+  int                   polls;
+  bool                  done;
+} TEST_Request_TypeDef;
+
+/** Submission and completion order of transfers */
+#define TEST_LOG        1024
+
+static I2CQ_Transfer_TypeDef *submitted[TEST_LOG];
+static I2CQ_Transfer_TypeDef *completed[TEST_LOG];
+static int                   submitCount;
+static int                   completeCount;
+
+/***************************************************************************//**
+ * @brief
+ *   Submit transfer, logging order.
+ ******************************************************************************/
+static void submit(I2CQ_Transfer_TypeDef *transfer)
+{
+  if (submitCount < TEST_LOG)
+  {
+    submitted[submitCount] = transfer;
+  }
+  submitCount++;
+  I2CQ_submit(transfer);
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Log completion order.
+ ******************************************************************************/
+static void logDone(I2CQ_Transfer_TypeDef *transfer)
+{
+  if (completeCount < TEST_LOG)
+  {
+    completed[completeCount] = transfer;
+  }
+  completeCount++;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Callback of transfer without follow up.
+ ******************************************************************************/
+static void requestDone(I2CQ_Transfer_TypeDef *transfer, int status)
+{
+  TEST_Request_TypeDef *req = transfer->user;
+
+  (void) status;
+  logDone(transfer);
+  req->done = true;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Callback of EEPROM write cycle polling: again until acknowledged.
+ ******************************************************************************/
+static void pollDone(I2CQ_Transfer_TypeDef *transfer, int status)
+{
+  TEST_Request_TypeDef *req = transfer->user;
+
+  logDone(transfer);
+  if (status == i2cTransferNack)
+  {
+    req->polls++;
+    submit(transfer);
+    return;
+  }
+  req->done = true;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Callback of EEPROM page write: chain polling for end of write cycle.
+ *   Not acknowledged while the EEPROM is still busy with an earlier write
+ *   queued before, so then try again.
+ ******************************************************************************/
+static void writeDone(I2CQ_Transfer_TypeDef *transfer, int status)
+{
+  TEST_Request_TypeDef *req = transfer->user;
+
+  logDone(transfer);
+  if (status == i2cTransferNack)
+  {
+    req->polls++;
+    submit(transfer);
+    return;
+  }
+  if (status != i2cTransferDone)
+  {
+    req->done = true;
+    return;
+  }
+  transfer->seq.flags      = I2C_FLAG_WRITE;
+  transfer->seq.buf[0].len = 0;
+  transfer->done           = pollDone;
+  submit(transfer);
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Set up EEPROM page write request.
+ ******************************************************************************/
+static void eepromWrite(TEST_Request_TypeDef *req, uint8_t offset)
+{
+  memset(req, 0, sizeof(*req));
+  req->offset                   = offset;
+  req->transfer.seq.addr        = EEPROM_DVK_ADDR;
+  req->transfer.seq.flags       = I2C_FLAG_WRITE_WRITE;
+  req->transfer.seq.buf[0].data = &req->offset;
+  req->transfer.seq.buf[0].len  = 1;
+  req->transfer.seq.buf[1].data = req->data;
+  req->transfer.seq.buf[1].len  = EEPROMSIM_PAGE_SIZE;
+  req->transfer.done            = writeDone;
+  req->transfer.user            = req;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Set up EEPROM read request.
+ ******************************************************************************/
+static void eepromRead(TEST_Request_TypeDef *req, uint8_t offset)
+{
+  memset(req, 0, sizeof(*req));
+  req->offset                   = offset;
+  req->transfer.seq.addr        = EEPROM_DVK_ADDR;
+  req->transfer.seq.flags       = I2C_FLAG_WRITE_READ;
+  req->transfer.seq.buf[0].data = &req->offset;
+  req->transfer.seq.buf[0].len  = 1;
+  req->transfer.seq.buf[1].data = req->data;
+  req->transfer.seq.buf[1].len  = EEPROMSIM_PAGE_SIZE;
+  req->transfer.done            = requestDone;
+  req->transfer.user            = req;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Set up temperature read request: pointer to register 0, read 2 bytes.
+ ******************************************************************************/
+static void tempRead(TEST_Request_TypeDef *req)
+{
+  memset(req, 0, sizeof(*req));
+  req->transfer.seq.addr        = I2CSIM_TEMP_ADDR;
+  req->transfer.seq.flags       = I2C_FLAG_WRITE_READ;
+  req->transfer.seq.buf[0].data = &req->offset;
+  req->transfer.seq.buf[0].len  = 1;
+  req->transfer.seq.buf[1].data = req->temp;
+  req->transfer.seq.buf[1].len  = 2;
+  req->transfer.done            = requestDone;
+  req->transfer.user            = req;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Sleep in EM1 until request is done.
+ ******************************************************************************/
+static void waitRequest(TEST_Request_TypeDef *req)
+{
+  while (!req->done && !I2CSIM_stats.hangs)
+  {
+    I2CQ_wait(&req->transfer);
+  }
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Queue page writes and temperature reads, check order and contents.
+ ******************************************************************************/
+static int orderTest(void)
+{
+  static TEST_Request_TypeDef writes[TEST_PAGES];
+  static TEST_Request_TypeDef temps[TEST_PAGES];
+  TEST_Request_TypeDef        read;
+  int                         polls = 0;
+  int                         i;
+  int                         j;
+
+  I2CSIM_reset();
+  EEPROMSIM_reset();
+  I2CSIM_temp = 0x1980;
+  I2CQ_init(I2C0);
+  submitCount   = 0;
+  completeCount = 0;
+
+  for (i = 0; i < TEST_PAGES; i++)
+  {
+    eepromWrite(&writes[i], (uint8_t)(i * EEPROMSIM_PAGE_SIZE));
+    for (j = 0; j < EEPROMSIM_PAGE_SIZE; j++)
+    {
+      writes[i].data[j] = (uint8_t) rand();
+    }
+    submit(&writes[i].transfer);
+    tempRead(&temps[i]);
+    submit(&temps[i].transfer);
+  }
+  for (i = 0; i < TEST_PAGES; i++)
+  {
+    waitRequest(&writes[i]);
+    waitRequest(&temps[i]);
+    polls += writes[i].polls;
+  }
+
+  if (I2CSIM_stats.hangs || (completeCount != submitCount) ||
+      (submitCount > TEST_LOG) || memcmp(submitted, completed, submitCount * sizeof(submitted[0])))
+  {
+    printf("transfers not completed in order submitted\n");
+    return 0;
+  }
+  for (i = 0; i < TEST_PAGES; i++)
+  {
+    if ((temps[i].temp[0] != 0x19) || (temps[i].temp[1] != 0x80))
+    {
+      printf("temperature read wrong\n");
+      return 0;
+    }
+    eepromRead(&read, (uint8_t)(i * EEPROMSIM_PAGE_SIZE));
+    I2CQ_submit(&read.transfer);
+    if ((I2CQ_wait(&read.transfer) != i2cTransferDone) ||
+        memcmp(read.data, writes[i].data, EEPROMSIM_PAGE_SIZE))
+    {
+      printf("page %d read back wrong\n", i);
+      return 0;
+    }
+  }
+  printf("order: %d transfers in order submitted, %d polls of busy EEPROM, "
+         "%d pages read back\n", submitCount, polls, TEST_PAGES);
+  return 1;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Check timeout of a stalled transfer, and NACK of a missing device.
+ ******************************************************************************/
+static int timeoutTest(void)
+{
+  TEST_Request_TypeDef before;
+  TEST_Request_TypeDef stalled;
+  TEST_Request_TypeDef after;
+  TEST_Request_TypeDef missing;
+
+  I2CSIM_reset();
+  I2CQ_init(I2C0);
+  I2CSIM_setTick(1000, I2CQ_tick);
+  I2CSIM_stall(I2CSIM_TEMP_ADDR);
+
+  eepromRead(&before, 0);
+  tempRead(&stalled);
+  eepromRead(&after, EEPROMSIM_PAGE_SIZE);
+  eepromRead(&missing, 0);
+  missing.transfer.seq.addr = 0xb0;
+  before.transfer.timeout   = 5;
+  stalled.transfer.timeout  = 5;
+  after.transfer.timeout    = 5;
+  missing.transfer.timeout  = 5;
+  I2CQ_submit(&before.transfer);
+  I2CQ_submit(&stalled.transfer);
+  I2CQ_submit(&after.transfer);
+  I2CQ_submit(&missing.transfer);
+  I2CQ_wait(&missing.transfer);
+
+  if (I2CSIM_stats.hangs || (before.transfer.status != i2cTransferDone) ||
+      (stalled.transfer.status != I2CQ_TIMEOUT) ||
+      (after.transfer.status != i2cTransferDone) ||
+      (missing.transfer.status != i2cTransferNack) ||
+      memcmp(after.data, &EEPROMSIM_memory[EEPROMSIM_PAGE_SIZE], EEPROMSIM_PAGE_SIZE))
+  {
+    printf("timeout: wrong status %d %d %d %d\n", before.transfer.status,
+           stalled.transfer.status, after.transfer.status,
+           missing.transfer.status);
+    return 0;
+  }
+  printf("timeout: stalled read timed out after %lu us, others done, "
+         "missing device NACK\n", (unsigned long) I2CSIM_stats.time);
+  return 1;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Print throughput counters of a run.
+ ******************************************************************************/
+static void printRun(const char *name)
+{
+  printf("%-12s %8lu %10.0f %7.1f%% %7.1f%%\n", name,
+         (unsigned long) I2CSIM_stats.time,
+         TEST_READS * 1e6 / I2CSIM_stats.time,
+         100.0 * I2CSIM_stats.busTime / I2CSIM_stats.time,
+         100.0 * I2CSIM_stats.sleepTime / I2CSIM_stats.time);
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Temperature reads one at a time, and queued back to back.
+ ******************************************************************************/
+static int throughputTest(void)
+{
+  static TEST_Request_TypeDef reads[TEST_READS];
+  int                         i;
+
+  printf("\n%d temperature reads, %d us processing each\n\n", TEST_READS,
+         TEST_PROCESS_US);
+  printf("%-12s %8s %10s %8s %8s\n", "", "time us", "reads/s", "bus", "EM1");
+
+  /* One at a time: bus idle while result is processed */
+  I2CSIM_reset();
+  I2CQ_init(I2C0);
+  for (i = 0; i < TEST_READS; i++)
+  {
+    tempRead(&reads[i]);
+    I2CQ_submit(&reads[i].transfer);
+    waitRequest(&reads[i]);
+    I2CSIM_run(TEST_PROCESS_US);
+  }
+  printRun("one at once");
+
+  /* Queued: next reads on the bus while a result is processed */
+  I2CSIM_reset();
+  I2CQ_init(I2C0);
+  for (i = 0; i < TEST_READS; i++)
+  {
+    tempRead(&reads[i]);
+    I2CQ_submit(&reads[i].transfer);
+  }
+  for (i = 0; i < TEST_READS; i++)
+  {
+    waitRequest(&reads[i]);
+    I2CSIM_run(TEST_PROCESS_US);
+  }
+  printRun("queued");
+
+  return !I2CSIM_stats.hangs;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Main function.
+ ******************************************************************************/
+int main(void)
+{
+  if (!orderTest() || !timeoutTest() || !throughputTest())
+  {
+    printf("FAILED\n");
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,333 @@
+/**************************************************************************//**
+ * @file
+ * @brief Host runner checking wear and power failure safety of the EEPROM key/value store
+ * @author Energy Micro AS
+ * @version 3.20.0
+ ******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 Energy Micro AS, http://www.energymicro.com</b>
+ *******************************************************************************
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ * 4. The source and compiled code may only be used on Energy Micro "EFM32"
+ *    microcontrollers and "EFR4" radios.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: Energy Micro AS has no
+ * obligation to support this Software. Energy Micro AS is providing the
+ * Software "AS IS", with no express or implied warranties of any kind,
+ * including, but not limited to, any implied warranties of merchantability
+ * or fitness for any particular purpose or warranties against infringement
+ * of any proprietary rights of a third party.
+ *
+ * Energy Micro AS will not be liable for any consequential, incidental, or
+ * special damages, or any other relief, or for any claim by any third party,
+ * arising from your use of this Software.
+ *
+ *****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "eeprom.h"
+#include "eepromsim.h"
+#include "eecache.h"
+#include "kvstore.h"
+
+/*
+   Host runner for the key/value store on the simulated DVK EEPROM.
+
+   Wear: the eepromtest value is written on every press, at a fixed address
+   as before and as a key of the store, with a few other keys changed now
+   and then. Every write is synced, and write cycles per page compared.
+
+   Power failure: random puts and syncs, with power failing in a random
+   write cycle. After each failure the store is mounted again, and every
+   key must have the value of the last sync, or one put after it. A torn
+   record passes its CRC-16 about once in 65536 tears, so far more trials
+   than the default will in the end find one.
+*/
+
+/** Keys of the power failure test, and values remembered per key */
+#define TEST_KEYS     8
+#define TEST_HISTORY  64
+
+/** Length marking that a key may have no value */
+#define TEST_NO_VALUE 0xff
+
+/** Values a key may have after power failure */
+typedef struct
+{
+  int     count;
+  uint8_t len[TEST_HISTORY];
+  uint8_t value[TEST_HISTORY][KVSTORE_MAX_VALUE];
+} TEST_Allowed_TypeDef;
+
+static TEST_Allowed_TypeDef allowed[TEST_KEYS];
+
+/***************************************************************************//**
+ * @brief
+ *   Print wear of a run.
+ ******************************************************************************/
+static void printWear(const char *name)
+{
+  uint32_t min = 0xffffffff;
+  int      i;
+
+  for (i = 0; i < EEPROMSIM_PAGES; i++)
+  {
+    if (EEPROMSIM_stats.pageWrites[i] < min)
+    {
+      min = EEPROMSIM_stats.pageWrites[i];
+    }
+  }
+  printf("%-10s %12lu %10lu %10lu %10lu\n", name,
+         (unsigned long) EEPROMSIM_stats.writeCycles,
+         (unsigned long) EEPROMSIM_maxPageWrites(), (unsigned long) min,
+         (unsigned long) EEPROMSIM_stats.busBytes);
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Compare wear of fixed address and store, for the given presses.
+ ******************************************************************************/
+static int wearTest(int presses)
+{
+  uint8_t  data[4];
+  uint32_t transfers;
+  int      keys;
+  int      i;
+
+  printf("%d presses, other keys changed every 50 presses\n\n", presses);
+  printf("%-10s %12s %10s %10s %10s\n",
+         "", "write cycles", "max page", "min page", "bus bytes");
+
+  EEPROMSIM_reset();
+  for (i = 0; i < presses; i++)
+  {
+    data[0] = (uint8_t) i;
+    data[1] = (uint8_t)(i + 1);
+    data[2] = (uint8_t)(i + 2);
+    EEPROM_Write(I2C0, EEPROM_DVK_ADDR, 0, data, 3);
+  }
+  printWear("fixed");
+
+  EEPROMSIM_reset();
+  EECACHE_init(EEPROM_DVK_ADDR, 0);
+  KVSTORE_mount(EEPROM_DVK_ADDR);
+  for (i = 0; i < presses; i++)
+  {
+    data[0] = (uint8_t) i;
+    data[1] = (uint8_t)(i + 1);
+    data[2] = (uint8_t)(i + 2);
+    if (KVSTORE_put(1, data, 3) < 0)
+    {
+      printf("put failed at press %d\n", i);
+      return 0;
+    }
+    if ((i % 50) == 0)
+    {
+      memset(data, (uint8_t) i, sizeof(data));
+      KVSTORE_put((uint8_t)(2 + (i / 50) % 4), data, 4);
+    }
+    EECACHE_sync();
+  }
+  printWear("kvstore");
+
+  /* Mount from scratch, and check the last value */
+  EECACHE_init(EEPROM_DVK_ADDR, 0);
+  transfers = EEPROMSIM_stats.transfers;
+  keys      = KVSTORE_mount(EEPROM_DVK_ADDR);
+  printf("\nmount: %d keys, %lu transfers\n", keys,
+         (unsigned long)(EEPROMSIM_stats.transfers - transfers));
+  i--;
+  if ((KVSTORE_get(1, data, sizeof(data)) != 3) || (data[0] != (uint8_t) i) ||
+      (data[2] != (uint8_t)(i + 2)))
+  {
+    printf("value lost\n");
+    return 0;
+  }
+  return 1;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Remember that key may have value after power failure.
+ ******************************************************************************/
+static void allow(int key, const uint8_t *value, unsigned int len)
+{
+  TEST_Allowed_TypeDef *a = &allowed[key];
+
+  if (a->count < TEST_HISTORY)
+  {
+    a->len[a->count] = (uint8_t) len;
+    memcpy(a->value[a->count], value, len);
+    a->count++;
+  }
+}
+
+/***************************************************************************//**
+ * @brief
+ *   After sync, or mount, only the current value of each key is allowed.
+ ******************************************************************************/
+static void allowCurrent(void)
+{
+  uint8_t value[KVSTORE_MAX_VALUE];
+  int     len;
+  int     key;
+
+  for (key = 0; key < TEST_KEYS; key++)
+  {
+    allowed[key].count = 0;
+    len = KVSTORE_get((uint8_t) key, value, sizeof(value));
+    if (len >= 0)
+    {
+      allow(key, value, (unsigned int) len);
+    }
+    else
+    {
+      allowed[key].len[0] = TEST_NO_VALUE;
+      allowed[key].count  = 1;
+    }
+  }
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Check values after mount against the allowed ones.
+ ******************************************************************************/
+static int checkAllowed(void)
+{
+  TEST_Allowed_TypeDef *a;
+  uint8_t              value[KVSTORE_MAX_VALUE];
+  int                  len;
+  int                  key;
+  int                  i;
+
+  for (key = 0; key < TEST_KEYS; key++)
+  {
+    a   = &allowed[key];
+    len = KVSTORE_get((uint8_t) key, value, sizeof(value));
+    if (len < 0)
+    {
+      if (a->len[0] != TEST_NO_VALUE)
+      {
+        return key + 1;
+      }
+      continue;
+    }
+    for (i = 0; i < a->count; i++)
+    {
+      if ((a->len[i] == len) && (memcmp(a->value[i], value, len) == 0))
+      {
+        break;
+      }
+    }
+    if (i == a->count)
+    {
+      return key + 1;
+    }
+  }
+  return 0;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Random puts and syncs with injected power failures.
+ ******************************************************************************/
+static int powerFailTest(int failures)
+{
+  uint8_t      value[KVSTORE_MAX_VALUE];
+  unsigned int len;
+  int          key;
+  int          bad;
+  int          puts = 0;
+  int          n;
+  int          i;
+
+  srand(1);
+  EEPROMSIM_reset();
+  EECACHE_init(EEPROM_DVK_ADDR, 0);
+  KVSTORE_mount(EEPROM_DVK_ADDR);
+  allowCurrent();
+
+  for (n = 0; n < failures; n++)
+  {
+    EEPROMSIM_failAfter((uint32_t)(rand() % 64));
+    while (!EEPROMSIM_powerFailed())
+    {
+      if ((rand() % 6) == 0)
+      {
+        if (EECACHE_sync() == 0)
+        {
+          allowCurrent();
+        }
+        continue;
+      }
+      key = rand() % TEST_KEYS;
+      len = 1 + (unsigned int) rand() % KVSTORE_MAX_VALUE;
+      for (i = 0; i < (int) len; i++)
+      {
+        value[i] = (uint8_t) rand();
+      }
+      allow(key, value, len);
+      KVSTORE_put((uint8_t) key, value, len);
+      puts++;
+    }
+
+    /* Reset: RAM is lost, EEPROM kept */
+    EEPROMSIM_powerOn();
+    EECACHE_init(EEPROM_DVK_ADDR, 0);
+    if (KVSTORE_mount(EEPROM_DVK_ADDR) < 0)
+    {
+      printf("mount failed after power failure %d\n", n);
+      return 0;
+    }
+    bad = checkAllowed();
+    if (bad)
+    {
+      printf("key %d has a value never put, after power failure %d\n", bad - 1, n);
+      return 0;
+    }
+    allowCurrent();
+  }
+  printf("%d power failures in %d puts, all values as put\n", failures, puts);
+  return 1;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Main function.
+ ******************************************************************************/
+int main(int argc, char *argv[])
+{
+  int presses  = 10000;
+  int failures = 10000;
+
+  if (argc > 1)
+  {
+    presses = atoi(argv[1]);
+  }
+  if (argc > 2)
+  {
+    failures = atoi(argv[2]);
+  }
+  if ((argc > 3) || (presses <= 0) || (failures < 0))
+  {
+    fprintf(stderr, "Usage: %s [presses] [power failures]\n", argv[0]);
+    return 1;
+  }
+
+  if (!wearTest(presses) || !powerFailTest(failures))
+  {
+    printf("FAILED\n");
+    return 1;
+  }
+  return 0;
+}
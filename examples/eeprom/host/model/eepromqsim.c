@@ -0,0 +1,54 @@
+/**************************************************************************//**
+ * @file
+ * @brief Host model of EEPROM access on the I2C transaction queue
+ * @author Energy Micro AS
+ * @version 3.20.0
+ ******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 Energy Micro AS, http://www.energymicro.com</b>
+ *******************************************************************************
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ * 4. The source and compiled code may only be used on Energy Micro "EFM32"
+ *    microcontrollers and "EFR4" radios.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: Energy Micro AS has no
+ * obligation to support this Software. Energy Micro AS is providing the
+ * Software "AS IS", with no express or implied warranties of any kind,
+ * including, but not limited to, any implied warranties of merchantability
+ * or fitness for any particular purpose or warranties against infringement
+ * of any proprietary rights of a third party.
+ *
+ * Energy Micro AS will not be liable for any consequential, incidental, or
+ * special damages, or any other relief, or for any claim by any third party,
+ * arising from your use of this Software.
+ *
+ *****************************************************************************/
+#include "em_device.h"
+#include "eeprom.h"
+#include "eepromq.h"
+
+/* Host model of the queued EEPROM access, passed on to the EEPROM model in
+   eepromsim.c, which counts bus traffic and write cycles and injects power
+   failure for the cache and store runners. eepromq.c itself runs on the
+   I2C bus model in eepromqrun. */
+
+int EEPROMQ_read(uint8_t addr, unsigned int offset, uint8_t *data,
+                 unsigned int len)
+{
+  return EEPROM_Read(I2C0, addr, offset, data, len);
+}
+
+int EEPROMQ_write(uint8_t addr, unsigned int offset, const uint8_t *data,
+                  unsigned int len)
+{
+  return EEPROM_Write(I2C0, addr, offset, (uint8_t *) data, len);
+}
@@ -0,0 +1,233 @@
+/**************************************************************************//**
+ * @file
+ * @brief Host simulation of DVK I2C EEPROM
+ * @author Energy Micro AS
+ * @version 3.20.0
+ ******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 Energy Micro AS, http://www.energymicro.com</b>
+ *******************************************************************************
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ * 4. The source and compiled code may only be used on Energy Micro "EFM32"
+ *    microcontrollers and "EFR4" radios.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: Energy Micro AS has no
+ * obligation to support this Software. Energy Micro AS is providing the
+ * Software "AS IS", with no express or implied warranties of any kind,
+ * including, but not limited to, any implied warranties of merchantability
+ * or fitness for any particular purpose or warranties against infringement
+ * of any proprietary rights of a third party.
+ *
+ * Energy Micro AS will not be liable for any consequential, incidental, or
+ * special damages, or any other relief, or for any claim by any third party,
+ * arising from your use of this Software.
+ *
+ *****************************************************************************/
+#include <stdlib.h>
+#include <string.h>
+#include "eeprom.h"
+#include "rtcdrv.h"
+#include "eepromsim.h"
+
+EEPROMSIM_Stats_TypeDef EEPROMSIM_stats;
+uint8_t                 EEPROMSIM_memory[EEPROMSIM_SIZE];
+
+/** Simulated time and pending RTCDRV trigger, ms */
+static uint32_t simTime;
+static uint32_t triggerTime;
+static void     (*triggerCb)(void);
+
+/** Write cycles until injected power failure, -1 if none, and power state */
+static int32_t  failCountdown = -1;
+static bool     powerFailed;
+
+/***************************************************************************//**
+ * @brief
+ *   Erase EEPROM to 0xff, and clear counters, time and trigger.
+ ******************************************************************************/
+void EEPROMSIM_reset(void)
+{
+  memset(EEPROMSIM_memory, 0xff, sizeof(EEPROMSIM_memory));
+  memset(&EEPROMSIM_stats, 0, sizeof(EEPROMSIM_stats));
+  simTime       = 0;
+  triggerCb     = NULL;
+  failCountdown = -1;
+  powerFailed   = false;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Fail power in the write cycle after the given number of cycles.
+ ******************************************************************************/
+void EEPROMSIM_failAfter(uint32_t cycles)
+{
+  failCountdown = (int32_t) cycles;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Restore power after injected failure, EEPROM contents are kept.
+ ******************************************************************************/
+void EEPROMSIM_powerOn(void)
+{
+  powerFailed = false;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Check if power has failed since EEPROMSIM_powerOn().
+ ******************************************************************************/
+bool EEPROMSIM_powerFailed(void)
+{
+  return powerFailed;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Advance simulated time, calling RTCDRV callback when due.
+ ******************************************************************************/
+void EEPROMSIM_advance(uint32_t msec)
+{
+  void (*cb)(void);
+
+  simTime += msec;
+  if (triggerCb && ((int32_t)(simTime - triggerTime) >= 0))
+  {
+    cb        = triggerCb;
+    triggerCb = NULL;
+    cb();
+  }
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Bus time of transfers and write cycles so far, us. Each byte takes
+ *   9 clocks, with acknowledge.
+ ******************************************************************************/
+uint32_t EEPROMSIM_busTime(void)
+{
+  return (uint32_t)(((uint64_t) EEPROMSIM_stats.busBytes * 9 * 1000000) / EEPROMSIM_I2C_RATE) +
+         EEPROMSIM_stats.writeCycles * EEPROMSIM_WRITE_US;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Most write cycles of any page.
+ ******************************************************************************/
+uint32_t EEPROMSIM_maxPageWrites(void)
+{
+  uint32_t max = 0;
+  int      i;
+
+  for (i = 0; i < EEPROMSIM_PAGES; i++)
+  {
+    if (EEPROMSIM_stats.pageWrites[i] > max)
+    {
+      max = EEPROMSIM_stats.pageWrites[i];
+    }
+  }
+  return max;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Read from EEPROM: device address and word address written, then device
+ *   address and data read after repeated start.
+ ******************************************************************************/
+int EEPROM_Read(I2C_TypeDef *i2c, uint8_t addr, unsigned int offset,
+                uint8_t *data, unsigned int len)
+{
+  (void) i2c;
+  (void) addr;
+
+  if (powerFailed)
+  {
+    return -1;
+  }
+  if (offset >= EEPROMSIM_SIZE)
+  {
+    return 0;
+  }
+  if (len > EEPROMSIM_SIZE - offset)
+  {
+    len = EEPROMSIM_SIZE - offset;
+  }
+  memcpy(data, &EEPROMSIM_memory[offset], len);
+  EEPROMSIM_stats.transfers++;
+  EEPROMSIM_stats.busBytes += 3 + len;
+  return (int) len;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Write to EEPROM, one transfer and write cycle per page written.
+ ******************************************************************************/
+int EEPROM_Write(I2C_TypeDef *i2c, uint8_t addr, unsigned int offset,
+                 uint8_t *data, unsigned int len)
+{
+  unsigned int pos;
+  unsigned int count;
+  unsigned int torn;
+
+  (void) i2c;
+  (void) addr;
+
+  if (powerFailed)
+  {
+    return -1;
+  }
+  if (offset >= EEPROMSIM_SIZE)
+  {
+    return 0;
+  }
+  if (len > EEPROMSIM_SIZE - offset)
+  {
+    len = EEPROMSIM_SIZE - offset;
+  }
+  for (pos = 0; pos < len; pos += count)
+  {
+    count = EEPROMSIM_PAGE_SIZE - ((offset + pos) % EEPROMSIM_PAGE_SIZE);
+    if (count > len - pos)
+    {
+      count = len - pos;
+    }
+    if (failCountdown == 0)
+    {
+      failCountdown = -1;
+      powerFailed   = true;
+      torn          = (unsigned int) rand() % count;
+      memcpy(&EEPROMSIM_memory[offset + pos], &data[pos], torn);
+      EEPROMSIM_memory[offset + pos + torn] = (uint8_t) rand();
+      return -1;
+    }
+    if (failCountdown > 0)
+    {
+      failCountdown--;
+    }
+    memcpy(&EEPROMSIM_memory[offset + pos], &data[pos], count);
+    EEPROMSIM_stats.transfers++;
+    EEPROMSIM_stats.busBytes += 2 + count;
+    EEPROMSIM_stats.writeCycles++;
+    EEPROMSIM_stats.pageWrites[(offset + pos) / EEPROMSIM_PAGE_SIZE]++;
+  }
+  return (int) len;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Call cb once msec of simulated time have passed.
+ ******************************************************************************/
+void RTCDRV_Trigger(uint32_t msec, void (*cb)(void))
+{
+  triggerTime = simTime + msec;
+  triggerCb   = cb;
+}
@@ -0,0 +1,81 @@
+/**************************************************************************//**
+ * @file
+ * @brief Host simulation of DVK I2C EEPROM
+ * @author Energy Micro AS
+ * @version 3.20.0
+ ******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 Energy Micro AS, http://www.energymicro.com</b>
+ *******************************************************************************
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ * 4. The source and compiled code may only be used on Energy Micro "EFM32"
+ *    microcontrollers and "EFR4" radios.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: Energy Micro AS has no
+ * obligation to support this Software. Energy Micro AS is providing the
+ * Software "AS IS", with no express or implied warranties of any kind,
+ * including, but not limited to, any implied warranties of merchantability
+ * or fitness for any particular purpose or warranties against infringement
+ * of any proprietary rights of a third party.
+ *
+ * Energy Micro AS will not be liable for any consequential, incidental, or
+ * special damages, or any other relief, or for any claim by any third party,
+ * arising from your use of this Software.
+ *
+ *****************************************************************************/
+#ifndef __EEPROMSIM_H
+#define __EEPROMSIM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+   Host simulation of the DVK I2C EEPROM behind EEPROM_Read() and
+   EEPROM_Write(), counting I2C bus traffic and write cycles. Writes are
+   split at page boundaries as by the EEPROM driver, each part taking one
+   write cycle of the page.
+
+   Power failure can be injected in a write cycle. The cycle is then torn:
+   bytes before a random position are written, the byte there is garbage,
+   and the rest are unchanged. Transfers fail until EEPROMSIM_powerOn().
+*/
+
+/** EEPROM size and page size of the DVK EEPROM */
+#define EEPROMSIM_SIZE       0x100
+#define EEPROMSIM_PAGE_SIZE  16
+#define EEPROMSIM_PAGES      (EEPROMSIM_SIZE / EEPROMSIM_PAGE_SIZE)
+
+/** Standard rate I2C clock, Hz, and page write cycle time, us */
+#define EEPROMSIM_I2C_RATE   100000
+#define EEPROMSIM_WRITE_US   5000
+
+/** Counters of simulated EEPROM activity */
+typedef struct
+{
+  uint32_t transfers;                   /**< I2C transfers */
+  uint32_t busBytes;                    /**< Bytes on bus, with addressing */
+  uint32_t writeCycles;                 /**< Page write cycles */
+  uint32_t pageWrites[EEPROMSIM_PAGES]; /**< Write cycles per page */
+} EEPROMSIM_Stats_TypeDef;
+
+extern EEPROMSIM_Stats_TypeDef EEPROMSIM_stats;
+extern uint8_t                 EEPROMSIM_memory[EEPROMSIM_SIZE];
+
+void EEPROMSIM_reset(void);
+void EEPROMSIM_failAfter(uint32_t cycles);
+void EEPROMSIM_powerOn(void);
+bool EEPROMSIM_powerFailed(void);
+void EEPROMSIM_advance(uint32_t msec);
+uint32_t EEPROMSIM_busTime(void);
+uint32_t EEPROMSIM_maxPageWrites(void);
+
+#endif
@@ -0,0 +1,577 @@
+/**************************************************************************//**
+ * @file
+ * @brief Host simulation of DVK I2C bus
+ * @author Energy Micro AS
+ * @version 3.20.0
+ ******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 Energy Micro AS, http://www.energymicro.com</b>
+ *******************************************************************************
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ * 4. The source and compiled code may only be used on Energy Micro "EFM32"
+ *    microcontrollers and "EFR4" radios.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: Energy Micro AS has no
+ * obligation to support this Software. Energy Micro AS is providing the
+ * Software "AS IS", with no express or implied warranties of any kind,
+ * including, but not limited to, any implied warranties of merchantability
+ * or fitness for any particular purpose or warranties against infringement
+ * of any proprietary rights of a third party.
+ *
+ * Energy Micro AS will not be liable for any consequential, incidental, or
+ * special damages, or any other relief, or for any claim by any third party,
+ * arising from your use of this Software.
+ *
+ *****************************************************************************/
+#include <stdbool.h>
+#include <stddef.h>
+#include "em_device.h"
+#include "em_emu.h"
+#include "em_i2c.h"
+#include "em_int.h"
+#include "eeprom.h"
+#include "eepromsim.h"
+#include "i2csim.h"
+
+/** Bus phases, each raising the interrupt when complete */
+typedef enum
+{
+  phaseIdle,
+  phaseAddrWrite,       /**< START and address byte, write */
+  phaseWrite,           /**< Data byte written */
+  phaseAddrRead,        /**< (Repeated) START and address byte, read */
+  phaseRead,            /**< Data byte read */
+  phaseStop             /**< STOP */
+} I2CSIM_Phase_TypeDef;
+
+I2CSIM_Stats_TypeDef I2CSIM_stats;
+int16_t              I2CSIM_temp;
+
+/** Interrupt handler of the code under test */
+void I2C0_IRQHandler(void);
+
+/** Transfer in progress, and position in it */
+static I2C_TransferSeq_TypeDef *seq;
+static I2CSIM_Phase_TypeDef    phase;
+static bool                    phaseDone;
+static bool                    acked;
+static int                     bufIndex;
+static unsigned int            bufPos;
+static I2C_TransferReturn_TypeDef result;
+
+/** Time the current phase completes, and its bus time */
+static uint32_t                phaseAt;
+static uint32_t                phaseLength;
+
+/** Interrupt state */
+static bool                    nvicEnabled;
+static bool                    i2cPending;
+static bool                    tickPending;
+static uint32_t                intDisabled;
+static bool                    inHandler;
+
+/** Periodic tick */
+static uint32_t                tickPeriod;
+static uint32_t                tickAt;
+static void                    (*tickCb)(void);
+
+/** Slaves */
+static uint8_t                 stallAddr;
+static bool                    stalled;
+static uint8_t                 eepromPointer;
+static uint8_t                 eepromPage[EEPROMSIM_PAGE_SIZE];
+static uint16_t                eepromWritten;
+static bool                    eepromPointerSet;
+static uint32_t                eepromBusyUntil;
+static uint8_t                 tempPointer;
+static unsigned int            tempRead;
+
+/***************************************************************************//**
+ * @brief
+ *   Reset bus, slaves, interrupts and counters. EEPROM contents are kept.
+ ******************************************************************************/
+void I2CSIM_reset(void)
+{
+  seq              = NULL;
+  phase            = phaseIdle;
+  phaseDone        = false;
+  nvicEnabled      = false;
+  i2cPending       = false;
+  tickPending      = false;
+  intDisabled      = 0;
+  inHandler        = false;
+  tickPeriod       = 0;
+  tickCb           = NULL;
+  stallAddr        = 0;
+  stalled          = false;
+  eepromBusyUntil  = 0;
+  eepromPointerSet = false;
+  I2C0->CMD        = 0;
+
+  I2CSIM_stats.time      = 0;
+  I2CSIM_stats.busTime   = 0;
+  I2CSIM_stats.sleepTime = 0;
+  I2CSIM_stats.irqs      = 0;
+  I2CSIM_stats.hangs     = 0;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Make slave at addr stretch the clock forever once addressed, 0 for none.
+ ******************************************************************************/
+void I2CSIM_stall(uint8_t addr)
+{
+  stallAddr = addr;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Call cb from a periodic interrupt every period us, 0 for none.
+ ******************************************************************************/
+void I2CSIM_setTick(uint32_t period, void (*cb)(void))
+{
+  tickPeriod = period;
+  tickCb     = cb;
+  tickAt     = I2CSIM_stats.time + period;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Start bus phase.
+ ******************************************************************************/
+static void I2CSIM_phase(I2CSIM_Phase_TypeDef next)
+{
+  phase     = next;
+  phaseDone = false;
+  switch (next)
+  {
+  case phaseAddrWrite:
+  case phaseAddrRead:
+    phaseLength = 10 * I2CSIM_BIT_US;
+    break;
+  case phaseStop:
+    phaseLength = I2CSIM_BIT_US;
+    break;
+  default:
+    phaseLength = 9 * I2CSIM_BIT_US;
+    break;
+  }
+  phaseAt = I2CSIM_stats.time + phaseLength;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Slave side of completed address phase, returns acknowledge.
+ ******************************************************************************/
+static bool I2CSIM_address(bool read)
+{
+  if ((seq->addr & 0xfe) == EEPROM_DVK_ADDR)
+  {
+    if (I2CSIM_stats.time < eepromBusyUntil)
+    {
+      return false;
+    }
+    eepromWritten    = 0;
+    eepromPointerSet = read;
+    return true;
+  }
+  if ((seq->addr & 0xfe) == I2CSIM_TEMP_ADDR)
+  {
+    tempRead = 0;
+    return true;
+  }
+  return false;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Slave side of byte written, returns acknowledge.
+ ******************************************************************************/
+static bool I2CSIM_write(uint8_t data)
+{
+  if ((seq->addr & 0xfe) == EEPROM_DVK_ADDR)
+  {
+    if (!eepromPointerSet)
+    {
+      eepromPointer    = data;
+      eepromPointerSet = true;
+      return true;
+    }
+    /* Bytes beyond the page wrap round within it, as in the EEPROM */
+    eepromPage[(eepromPointer + eepromWritten) % EEPROMSIM_PAGE_SIZE] = data;
+    eepromWritten++;
+    return true;
+  }
+  tempPointer = data;
+  return true;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Slave side of byte read.
+ ******************************************************************************/
+static uint8_t I2CSIM_read(void)
+{
+  uint8_t data;
+
+  if ((seq->addr & 0xfe) == EEPROM_DVK_ADDR)
+  {
+    return EEPROMSIM_memory[eepromPointer++];
+  }
+  data = 0;
+  if (tempPointer == 0)
+  {
+    data = (tempRead & 1) ? (uint8_t) I2CSIM_temp : (uint8_t)(I2CSIM_temp >> 8);
+  }
+  tempRead++;
+  return data;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Slave side of STOP: the EEPROM starts its write cycle.
+ ******************************************************************************/
+static void I2CSIM_stop(void)
+{
+  unsigned int page;
+  unsigned int i;
+
+  if (((seq->addr & 0xfe) == EEPROM_DVK_ADDR) && eepromWritten)
+  {
+    if (eepromWritten > EEPROMSIM_PAGE_SIZE)
+    {
+      eepromWritten = EEPROMSIM_PAGE_SIZE;
+    }
+    page = eepromPointer - eepromPointer % EEPROMSIM_PAGE_SIZE;
+    for (i = 0; i < eepromWritten; i++)
+    {
+      unsigned int offset = (eepromPointer + i) % EEPROMSIM_PAGE_SIZE;
+
+      EEPROMSIM_memory[page + offset] = eepromPage[offset];
+    }
+    eepromWritten   = 0;
+    eepromBusyUntil = I2CSIM_stats.time + EEPROMSIM_WRITE_US;
+  }
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Model of emlib I2C_TransferInit(): check sequence and start it.
+ ******************************************************************************/
+I2C_TransferReturn_TypeDef I2C_TransferInit(I2C_TypeDef *i2c,
+                                            I2C_TransferSeq_TypeDef *s)
+{
+  (void) i2c;
+
+  if (!s || !(s->flags & (I2C_FLAG_WRITE | I2C_FLAG_READ |
+                          I2C_FLAG_WRITE_READ | I2C_FLAG_WRITE_WRITE)))
+  {
+    return i2cTransferUsageFault;
+  }
+
+  /* A new transfer takes over the bus, as after abort */
+  I2C0->CMD  = 0;
+  stalled    = false;
+  i2cPending = false;
+  seq        = s;
+  bufIndex   = 0;
+  bufPos     = 0;
+  result     = i2cTransferDone;
+  I2CSIM_phase((s->flags & I2C_FLAG_READ) ? phaseAddrRead : phaseAddrWrite);
+  return i2cTransferInProgress;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Model of emlib I2C_Transfer(): act on completed phase, start next one.
+ ******************************************************************************/
+I2C_TransferReturn_TypeDef I2C_Transfer(I2C_TypeDef *i2c)
+{
+  (void) i2c;
+
+  if (!seq)
+  {
+    return i2cTransferUsageFault;
+  }
+  if (!phaseDone)
+  {
+    return i2cTransferInProgress;
+  }
+
+  switch (phase)
+  {
+  case phaseAddrWrite:
+  case phaseWrite:
+    if (!acked)
+    {
+      result = i2cTransferNack;
+      I2CSIM_phase(phaseStop);
+      break;
+    }
+    /* Move on to next buffer when current one is written */
+    while ((bufIndex < 2) && (bufPos >= seq->buf[bufIndex].len))
+    {
+      if ((bufIndex == 0) && (seq->flags & I2C_FLAG_WRITE_WRITE))
+      {
+        bufIndex = 1;
+        bufPos   = 0;
+      }
+      else
+      {
+        bufIndex = 2;
+      }
+    }
+    if (bufIndex < 2)
+    {
+      acked = I2CSIM_write(seq->buf[bufIndex].data[bufPos++]);
+      I2CSIM_phase(phaseWrite);
+    }
+    else if (seq->flags & I2C_FLAG_WRITE_READ)
+    {
+      bufIndex = 1;
+      bufPos   = 0;
+      I2CSIM_phase(phaseAddrRead);
+    }
+    else
+    {
+      I2CSIM_phase(phaseStop);
+    }
+    break;
+
+  case phaseAddrRead:
+  case phaseRead:
+    if ((phase == phaseAddrRead) && !acked)
+    {
+      result = i2cTransferNack;
+      I2CSIM_phase(phaseStop);
+      break;
+    }
+    if (phase == phaseRead)
+    {
+      seq->buf[bufIndex].data[bufPos++] = I2CSIM_read();
+    }
+    if (bufPos < seq->buf[bufIndex].len)
+    {
+      I2CSIM_phase(phaseRead);
+    }
+    else
+    {
+      I2CSIM_phase(phaseStop);
+    }
+    break;
+
+  case phaseStop:
+    I2CSIM_stop();
+    phase = phaseIdle;
+    seq   = NULL;
+    return result;
+
+  default:
+    return i2cTransferSwFault;
+  }
+  return i2cTransferInProgress;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Serve pending interrupts, unless disabled.
+ ******************************************************************************/
+static void I2CSIM_serve(void)
+{
+  if (intDisabled || inHandler)
+  {
+    return;
+  }
+  inHandler = true;
+  while (i2cPending || tickPending)
+  {
+    if (i2cPending)
+    {
+      i2cPending = false;
+      if (nvicEnabled)
+      {
+        I2CSIM_stats.irqs++;
+        I2CSIM_stats.time += I2CSIM_ISR_US;
+        I2C0_IRQHandler();
+      }
+    }
+    else
+    {
+      tickPending        = false;
+      I2CSIM_stats.time += I2CSIM_ISR_US;
+      tickCb();
+    }
+  }
+  inHandler = false;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Time of next event: phase completing, or tick. False if none.
+ ******************************************************************************/
+static bool I2CSIM_nextEvent(uint32_t *at)
+{
+  bool found = false;
+
+  /* An aborted transfer ends the phase in progress */
+  if (I2C0->CMD & I2C_CMD_ABORT)
+  {
+    I2C0->CMD = 0;
+    phase     = phaseIdle;
+    seq       = NULL;
+    stalled   = false;
+  }
+  if ((phase != phaseIdle) && !phaseDone && !stalled)
+  {
+    *at   = phaseAt;
+    found = true;
+  }
+  if (tickCb && (!found || (tickAt < *at)))
+  {
+    *at   = tickAt;
+    found = true;
+  }
+  return found;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Advance time to event at, and raise its interrupt.
+ ******************************************************************************/
+static void I2CSIM_event(uint32_t at)
+{
+  if (at > I2CSIM_stats.time)
+  {
+    I2CSIM_stats.time = at;
+  }
+  if (tickCb && (at == tickAt))
+  {
+    tickAt     += tickPeriod;
+    tickPending = true;
+    return;
+  }
+
+  I2CSIM_stats.busTime += phaseLength;
+  phaseDone             = true;
+  if (phase == phaseAddrWrite)
+  {
+    acked = I2CSIM_address(false);
+  }
+  else if (phase == phaseAddrRead)
+  {
+    acked = I2CSIM_address(true);
+  }
+  /* A stalling slave holds the clock low once addressed */
+  if (((phase == phaseAddrWrite) || (phase == phaseAddrRead)) &&
+      stallAddr && ((seq->addr & 0xfe) == stallAddr))
+  {
+    phaseDone = false;
+    stalled   = true;
+    return;
+  }
+  i2cPending = true;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Run the core for us, serving interrupts as they come.
+ ******************************************************************************/
+void I2CSIM_run(uint32_t us)
+{
+  uint32_t end = I2CSIM_stats.time + us;
+  uint32_t at;
+
+  while (I2CSIM_nextEvent(&at) && (at <= end))
+  {
+    I2CSIM_event(at);
+    I2CSIM_serve();
+  }
+  if (I2CSIM_stats.time < end)
+  {
+    I2CSIM_stats.time = end;
+  }
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Model of EM1: sleep until an interrupt is pending, served at once unless
+ *   interrupts are disabled.
+ ******************************************************************************/
+void EMU_EnterEM1(void)
+{
+  uint32_t at;
+
+  if (!i2cPending && !tickPending)
+  {
+    if (!I2CSIM_nextEvent(&at))
+    {
+      /* Nothing would ever wake the core */
+      I2CSIM_stats.hangs++;
+      return;
+    }
+    if (at > I2CSIM_stats.time)
+    {
+      I2CSIM_stats.sleepTime += at - I2CSIM_stats.time;
+    }
+    I2CSIM_event(at);
+  }
+  I2CSIM_serve();
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Model of emlib INT_Disable(), nesting.
+ ******************************************************************************/
+uint32_t INT_Disable(void)
+{
+  return ++intDisabled;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Model of emlib INT_Enable(), serving interrupts pending when the
+ *   outermost disable ends.
+ ******************************************************************************/
+uint32_t INT_Enable(void)
+{
+  if (intDisabled)
+  {
+    intDisabled--;
+  }
+  if (!intDisabled)
+  {
+    I2CSIM_serve();
+  }
+  return intDisabled;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Model of NVIC, only I2C0 interrupt.
+ ******************************************************************************/
+void NVIC_ClearPendingIRQ(IRQn_Type irq)
+{
+  (void) irq;
+  i2cPending = false;
+}
+
+void NVIC_EnableIRQ(IRQn_Type irq)
+{
+  (void) irq;
+  nvicEnabled = true;
+}
+
+void NVIC_DisableIRQ(IRQn_Type irq)
+{
+  (void) irq;
+  nvicEnabled = false;
+}
@@ -0,0 +1,86 @@
+/**************************************************************************//**
+ * @file
+ * @brief Host simulation of DVK I2C bus
+ * @author Energy Micro AS
+ * @version 3.20.0
+ ******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 Energy Micro AS, http://www.energymicro.com</b>
+ *******************************************************************************
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ * 4. The source and compiled code may only be used on Energy Micro "EFM32"
+ *    microcontrollers and "EFR4" radios.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: Energy Micro AS has no
+ * obligation to support this Software. Energy Micro AS is providing the
+ * Software "AS IS", with no express or implied warranties of any kind,
+ * including, but not limited to, any implied warranties of merchantability
+ * or fitness for any particular purpose or warranties against infringement
+ * of any proprietary rights of a third party.
+ *
+ * Energy Micro AS will not be liable for any consequential, incidental, or
+ * special damages, or any other relief, or for any claim by any third party,
+ * arising from your use of this Software.
+ *
+ *****************************************************************************/
+#ifndef __I2CSIM_H
+#define __I2CSIM_H
+
+#include <stdint.h>
+
+/*
+   Host model of the I2C0 bus on the DVK, behind the emlib I2C_TransferInit()
+   and I2C_Transfer() state machine, with the core sleeping and served
+   interrupts modelled in simulated time.
+
+   Each START, byte with acknowledge, and STOP completes after its bus time
+   at standard rate, and raises the I2C interrupt, which calls
+   I2C0_IRQHandler(). The master holds the clock until the handler has
+   called I2C_Transfer(), so handler latency shows as idle bus.
+
+   Slaves:
+   - the EEPROM at EEPROM_DVK_ADDR, on EEPROMSIM_memory: first byte written
+     sets the address, further bytes are written at STOP, within one page,
+     after which the EEPROM does not acknowledge for the write cycle time;
+   - the temperature sensor at I2CSIM_TEMP_ADDR: pointer byte, then
+     register 0 reads as I2CSIM_temp, high byte first.
+
+   A slave can be made to stretch the clock forever once addressed, until
+   the transfer is aborted with I2C_CMD_ABORT.
+*/
+
+/** I2C address of temperature sensor on DVK, 8 bit format */
+#define I2CSIM_TEMP_ADDR  0x90
+
+/** Bus time of one bit, us, and time to serve an interrupt, us */
+#define I2CSIM_BIT_US     10
+#define I2CSIM_ISR_US     4
+
+/** Counters of simulated time, us, and events */
+typedef struct
+{
+  uint32_t time;          /**< Simulated time */
+  uint32_t busTime;       /**< Bus in use by START, bytes or STOP */
+  uint32_t sleepTime;     /**< Core in EM1 */
+  uint32_t irqs;          /**< I2C interrupts served */
+  uint32_t hangs;         /**< EM1 entered with no interrupt to come */
+} I2CSIM_Stats_TypeDef;
+
+extern I2CSIM_Stats_TypeDef I2CSIM_stats;
+extern int16_t              I2CSIM_temp;
+
+void I2CSIM_reset(void);
+void I2CSIM_stall(uint8_t addr);
+void I2CSIM_setTick(uint32_t period, void (*cb)(void));
+void I2CSIM_run(uint32_t us);
+
+#endif
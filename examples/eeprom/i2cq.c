@@ -0,0 +1,222 @@
+/**************************************************************************//**
+ * @file
+ * @brief Interrupt driven I2C transaction queue
+ * @author Energy Micro AS
+ * @version 3.20.0
+ ******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 Energy Micro AS, http://www.energymicro.com</b>
+ *******************************************************************************
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ * 4. The source and compiled code may only be used on Energy Micro "EFM32"
+ *    microcontrollers and "EFR4" radios.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: Energy Micro AS has no
+ * obligation to support this Software. Energy Micro AS is providing the
+ * Software "AS IS", with no express or implied warranties of any kind,
+ * including, but not limited to, any implied warranties of merchantability
+ * or fitness for any particular purpose or warranties against infringement
+ * of any proprietary rights of a third party.
+ *
+ * Energy Micro AS will not be liable for any consequential, incidental, or
+ * special damages, or any other relief, or for any claim by any third party,
+ * arising from your use of this Software.
+ *
+ *****************************************************************************/
+#include <stddef.h>
+#include "em_device.h"
+#include "em_i2c.h"
+#include "em_emu.h"
+#include "em_int.h"
+#include "i2cq.h"
+
+/** I2C peripheral, its interrupt handler is I2C0_IRQHandler() */
+static I2C_TypeDef           *queueI2c;
+
+/** Queue, the head is the transfer on the bus when busy */
+static I2CQ_Transfer_TypeDef *queueHead;
+static I2CQ_Transfer_TypeDef *queueTail;
+static volatile bool         busy;
+
+/** Ticks left before the transfer on the bus times out, 0 for none */
+static uint32_t              ticksLeft;
+
+/***************************************************************************//**
+ * @brief
+ *   Remove head of queue and call its callback.
+ ******************************************************************************/
+static void I2CQ_complete(int status)
+{
+  I2CQ_Transfer_TypeDef *transfer = queueHead;
+
+  queueHead = transfer->next;
+  if (!queueHead)
+  {
+    queueTail = NULL;
+  }
+  transfer->next   = NULL;
+  transfer->status = status;
+  if (transfer->done)
+  {
+    transfer->done(transfer, status);
+  }
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Start transfer at head of queue, if bus is free. Transfers refused by
+ *   I2C_TransferInit() are completed at once. Called from interrupt, or with
+ *   interrupts disabled.
+ ******************************************************************************/
+static void I2CQ_start(void)
+{
+  I2C_TransferReturn_TypeDef ret;
+
+  while (queueHead && !busy)
+  {
+    ret = I2C_TransferInit(queueI2c, &queueHead->seq);
+    if (ret == i2cTransferInProgress)
+    {
+      busy      = true;
+      ticksLeft = queueHead->timeout;
+    }
+    else
+    {
+      I2CQ_complete(ret);
+    }
+  }
+}
+
+/***************************************************************************//**
+ * @brief
+ *   I2C interrupt, steps the transfer on the bus and starts the next one.
+ ******************************************************************************/
+void I2C0_IRQHandler(void)
+{
+  I2C_TransferReturn_TypeDef ret;
+
+  if (!busy)
+  {
+    return;
+  }
+  ret = I2C_Transfer(queueI2c);
+  if (ret != i2cTransferInProgress)
+  {
+    busy = false;
+    I2CQ_complete(ret);
+    I2CQ_start();
+  }
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Initialize queue, empty. The I2C peripheral must already be set up, as
+ *   by I2CDRV_Init().
+ *
+ * @param[in] i2c
+ *   I2C peripheral, I2C0.
+ ******************************************************************************/
+void I2CQ_init(I2C_TypeDef *i2c)
+{
+  queueI2c  = i2c;
+  queueHead = NULL;
+  queueTail = NULL;
+  busy      = false;
+  ticksLeft = 0;
+
+  /* I2C_TransferInit() enables the interrupt sources in the peripheral */
+  NVIC_ClearPendingIRQ(I2C0_IRQn);
+  NVIC_EnableIRQ(I2C0_IRQn);
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Queue transfer, starting it at once if the bus is free.
+ *
+ * @details
+ *   A transfer refused by I2C_TransferInit() has its callback called
+ *   before returning.
+ *
+ * @param[in] transfer
+ *   Transfer, owned by the queue until its callback is called.
+ ******************************************************************************/
+void I2CQ_submit(I2CQ_Transfer_TypeDef *transfer)
+{
+  transfer->status = i2cTransferInProgress;
+  transfer->next   = NULL;
+
+  INT_Disable();
+  if (queueTail)
+  {
+    queueTail->next = transfer;
+  }
+  else
+  {
+    queueHead = transfer;
+  }
+  queueTail = transfer;
+  I2CQ_start();
+  INT_Enable();
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Wait for transfer to complete, sleeping in EM1.
+ *
+ * @return
+ *   Status of transfer, as I2C_TransferReturn_TypeDef or I2CQ_TIMEOUT.
+ ******************************************************************************/
+int I2CQ_wait(I2CQ_Transfer_TypeDef *transfer)
+{
+  /* Check and sleep with interrupts disabled, so that completion just
+     after the check cannot leave the core sleeping. A pending interrupt
+     still wakes it, and is served once interrupts are enabled again. */
+  INT_Disable();
+  while (transfer->status == i2cTransferInProgress)
+  {
+    EMU_EnterEM1();
+    INT_Enable();
+    INT_Disable();
+  }
+  INT_Enable();
+
+  return transfer->status;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Check if transfers are queued or in progress.
+ ******************************************************************************/
+bool I2CQ_busy(void)
+{
+  return queueHead != NULL;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Count down timeout of transfer on bus, aborting it when passed. To be
+ *   called from a periodic interrupt.
+ ******************************************************************************/
+void I2CQ_tick(void)
+{
+  INT_Disable();
+  if (busy && ticksLeft && (--ticksLeft == 0))
+  {
+    /* Release the bus, the next transfer starts from idle */
+    queueI2c->CMD = I2C_CMD_ABORT;
+    NVIC_ClearPendingIRQ(I2C0_IRQn);
+    busy = false;
+    I2CQ_complete(I2CQ_TIMEOUT);
+    I2CQ_start();
+  }
+  INT_Enable();
+}
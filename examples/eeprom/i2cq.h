@@ -0,0 +1,101 @@
+/**************************************************************************//**
+ * @file
+ * @brief Interrupt driven I2C transaction queue
+ * @author Energy Micro AS
+ * @version 3.20.0
+ ******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 Energy Micro AS, http://www.energymicro.com</b>
+ *******************************************************************************
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ * 4. The source and compiled code may only be used on Energy Micro "EFM32"
+ *    microcontrollers and "EFR4" radios.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: Energy Micro AS has no
+ * obligation to support this Software. Energy Micro AS is providing the
+ * Software "AS IS", with no express or implied warranties of any kind,
+ * including, but not limited to, any implied warranties of merchantability
+ * or fitness for any particular purpose or warranties against infringement
+ * of any proprietary rights of a third party.
+ *
+ * Energy Micro AS will not be liable for any consequential, incidental, or
+ * special damages, or any other relief, or for any claim by any third party,
+ * arising from your use of this Software.
+ *
+ *****************************************************************************/
+#ifndef __I2CQ_H
+#define __I2CQ_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "em_device.h"
+#include "em_i2c.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+   Interrupt driven I2C transaction queue.
+
+   Transfers are described by I2CQ_Transfer_TypeDef, holding an emlib
+   transfer sequence, and queued with I2CQ_submit(). The queue runs them in
+   order, back to back: the I2C interrupt steps the emlib I2C_Transfer()
+   state machine, and on completion of one transfer calls its callback and
+   starts the next. The core may sleep in EM1 between bytes, I2CQ_wait()
+   does so until a given transfer is done.
+
+   Callbacks run in interrupt context, or within I2CQ_submit() for a
+   transfer refused by I2C_TransferInit(). They may submit further transfers,
+   which are queued after those already queued, so a request made of
+   several transfers, as a write followed by polling for the end of the
+   EEPROM write cycle, can be chained from its callbacks.
+
+   A transfer not done within its timeout, counted in calls to I2CQ_tick(),
+   is aborted with status I2CQ_TIMEOUT. I2CQ_tick() is to be called from a
+   periodic interrupt, if timeouts are used.
+
+   A descriptor belongs to the queue from I2CQ_submit() until completed,
+   with its status set and callback called, and must not be changed or
+   reused before that.
+*/
+
+/** Transfer status for timeout, other values as I2C_TransferReturn_TypeDef */
+#define I2CQ_TIMEOUT  (-10)
+
+struct I2CQ_Transfer;
+
+/** Completion callback, status as I2C_TransferReturn_TypeDef or I2CQ_TIMEOUT */
+typedef void (*I2CQ_Callback_TypeDef)(struct I2CQ_Transfer *transfer, int status);
+
+/** Queued I2C transfer */
+typedef struct I2CQ_Transfer
+{
+  I2C_TransferSeq_TypeDef seq;       /**< Address, flags and buffers */
+  I2CQ_Callback_TypeDef   done;      /**< Called on completion, or NULL */
+  void                    *user;     /**< For use by callback */
+  uint32_t                timeout;   /**< Ticks allowed, 0 for no timeout */
+  volatile int            status;    /**< i2cTransferInProgress until done */
+  struct I2CQ_Transfer    *next;     /**< Queue link, internal */
+} I2CQ_Transfer_TypeDef;
+
+void I2CQ_init(I2C_TypeDef *i2c);
+void I2CQ_submit(I2CQ_Transfer_TypeDef *transfer);
+int I2CQ_wait(I2CQ_Transfer_TypeDef *transfer);
+bool I2CQ_busy(void);
+void I2CQ_tick(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,416 @@
+/**************************************************************************//**
+ * @file
+ * @brief Log-structured key/value store on I2C EEPROM
+ * @author Energy Micro AS
+ * @version 3.20.0
+ ******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 Energy Micro AS, http://www.energymicro.com</b>
+ *******************************************************************************
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ * 4. The source and compiled code may only be used on Energy Micro "EFM32"
+ *    microcontrollers and "EFR4" radios.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: Energy Micro AS has no
+ * obligation to support this Software. Energy Micro AS is providing the
+ * Software "AS IS", with no express or implied warranties of any kind,
+ * including, but not limited to, any implied warranties of merchantability
+ * or fitness for any particular purpose or warranties against infringement
+ * of any proprietary rights of a third party.
+ *
+ * Energy Micro AS will not be liable for any consequential, incidental, or
+ * special damages, or any other relief, or for any claim by any third party,
+ * arising from your use of this Software.
+ *
+ *****************************************************************************/
+#include <string.h>
+#include "eepromq.h"
+#include "eecache.h"
+#include "kvstore.h"
+
+/** CRC-16 initial value, neither a blank nor a zeroed page has a valid header */
+#define KVSTORE_CRC_INIT  0xffff
+
+/** Current value of a key */
+typedef struct
+{
+  uint8_t key;
+  uint8_t page;                      /**< Page holding current record */
+  uint8_t len;
+  uint8_t value[KVSTORE_MAX_VALUE];
+} KVSTORE_Entry_TypeDef;
+
+static KVSTORE_Entry_TypeDef entries[KVSTORE_MAX_KEYS];
+static int                   entryCount;
+
+/** Head page, its sequence number and offset of free space in it */
+static int          head;
+static uint16_t     headSeq;
+static unsigned int headOffset;
+
+/***************************************************************************//**
+ * @brief
+ *   CRC-16, polynomial x^16 + x^12 + x^5 + 1.
+ ******************************************************************************/
+static uint16_t KVSTORE_crc(uint16_t crc, const uint8_t *data, unsigned int len)
+{
+  int i;
+
+  while (len--)
+  {
+    crc ^= (uint16_t)(*data++ << 8);
+    for (i = 0; i < 8; i++)
+    {
+      crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+    }
+  }
+  return crc;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Store CRC-16 low byte first. 0xffff, as blank EEPROM, is stored as 0, so
+ *   that a record torn before its CRC never passes.
+ ******************************************************************************/
+static void KVSTORE_crcStore(uint16_t crc, uint8_t *stored)
+{
+  if (crc == 0xffff)
+  {
+    crc = 0;
+  }
+  stored[0] = (uint8_t) crc;
+  stored[1] = (uint8_t)(crc >> 8);
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Check CRC-16 stored by KVSTORE_crcStore().
+ ******************************************************************************/
+static bool KVSTORE_crcValid(uint16_t crc, const uint8_t *stored)
+{
+  uint8_t expected[2];
+
+  KVSTORE_crcStore(crc, expected);
+  return (stored[0] == expected[0]) && (stored[1] == expected[1]);
+}
+
+/***************************************************************************//**
+ * @brief
+ *   CRC-16 of record in page with given sequence number.
+ ******************************************************************************/
+static uint16_t KVSTORE_recordCrc(uint16_t seq, const uint8_t *record, unsigned int len)
+{
+  uint8_t seqBytes[2];
+
+  seqBytes[0] = (uint8_t) seq;
+  seqBytes[1] = (uint8_t)(seq >> 8);
+  return KVSTORE_crc(KVSTORE_crc(KVSTORE_CRC_INIT, seqBytes, 2), record, len);
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Find entry of key, NULL if none.
+ ******************************************************************************/
+static KVSTORE_Entry_TypeDef *KVSTORE_find(uint8_t key)
+{
+  int i;
+
+  for (i = 0; i < entryCount; i++)
+  {
+    if (entries[i].key == key)
+    {
+      return &entries[i];
+    }
+  }
+  return NULL;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Append record of entry to head page, which must have room for it.
+ ******************************************************************************/
+static int KVSTORE_append(KVSTORE_Entry_TypeDef *entry)
+{
+  uint8_t      record[KVSTORE_RECORD_HEADER + KVSTORE_MAX_VALUE];
+  unsigned int size = KVSTORE_RECORD_HEADER + entry->len;
+  int          ret;
+
+  record[0] = entry->key;
+  record[1] = entry->len;
+  memcpy(&record[2], entry->value, entry->len);
+  KVSTORE_crcStore(KVSTORE_recordCrc(headSeq, record, size - 2), &record[size - 2]);
+
+  ret = EECACHE_write(head * EECACHE_PAGE_SIZE + headOffset, record, size);
+  if (ret < 0)
+  {
+    return ret;
+  }
+  entry->page = (uint8_t) head;
+  headOffset += size;
+  return 0;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Copy current values held in the page after the head into the head,
+ *   leaving the page after the head free.
+ ******************************************************************************/
+static int KVSTORE_reclaim(void)
+{
+  int next = (head + 1) % KVSTORE_PAGES;
+  int ret;
+  int i;
+
+  for (i = 0; i < entryCount; i++)
+  {
+    if (entries[i].page != next)
+    {
+      continue;
+    }
+    if (headOffset + KVSTORE_RECORD_HEADER + entries[i].len > EECACHE_PAGE_SIZE)
+    {
+      return KVSTORE_FULL;
+    }
+    ret = KVSTORE_append(&entries[i]);
+    if (ret < 0)
+    {
+      return ret;
+    }
+  }
+  return 0;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Take the next page as head, and free the page after it.
+ ******************************************************************************/
+static int KVSTORE_advance(void)
+{
+  uint8_t page[EECACHE_PAGE_SIZE];
+  int     next = (head + 1) % KVSTORE_PAGES;
+  int     ret;
+  int     i;
+
+  /* Never overwrite a page holding current values */
+  for (i = 0; i < entryCount; i++)
+  {
+    if (entries[i].page == next)
+    {
+      return KVSTORE_FULL;
+    }
+  }
+
+  /* Copies of values in the page must be written before it is erased */
+  ret = EECACHE_sync();
+  if (ret < 0)
+  {
+    return ret;
+  }
+
+  memset(page, 0xff, sizeof(page));
+  page[0] = (uint8_t)(headSeq + 1);
+  page[1] = (uint8_t)((headSeq + 1) >> 8);
+  KVSTORE_crcStore(KVSTORE_crc(KVSTORE_CRC_INIT, page, 2), &page[2]);
+  ret = EECACHE_write(next * EECACHE_PAGE_SIZE, page, sizeof(page));
+  if (ret < 0)
+  {
+    return ret;
+  }
+  head       = next;
+  headSeq   += 1;
+  headOffset = KVSTORE_PAGE_HEADER;
+
+  return KVSTORE_reclaim();
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Mount store: read the whole EEPROM and replay records, oldest page
+ *   first, into the values held in RAM. A blank EEPROM gives an empty store.
+ *
+ * @param[in] addr
+ *   I2C address of EEPROM, in 8 bit format.
+ *
+ * @return
+ *   Number of keys found, or negative I2C transfer status.
+ ******************************************************************************/
+int KVSTORE_mount(uint8_t addr)
+{
+  uint8_t               data[EECACHE_SIZE];
+  uint16_t              seq[KVSTORE_PAGES];
+  bool                  valid[KVSTORE_PAGES];
+  bool                  found = false;
+  KVSTORE_Entry_TypeDef *entry;
+  const uint8_t         *page;
+  unsigned int          offset;
+  unsigned int          len;
+  int                   ret;
+  int                   p;
+  int                   n;
+
+  entryCount = 0;
+  head       = KVSTORE_PAGES - 1;
+  headSeq    = 0;
+  headOffset = EECACHE_PAGE_SIZE;
+
+  /* Data still in the cache would not be seen by reading past it */
+  ret = EECACHE_sync();
+  if (ret < 0)
+  {
+    return ret;
+  }
+  ret = EEPROMQ_read(addr, 0, data, EECACHE_SIZE);
+  if (ret < 0)
+  {
+    return ret;
+  }
+
+  /* The head is the page with the newest header */
+  for (p = 0; p < KVSTORE_PAGES; p++)
+  {
+    page     = &data[p * EECACHE_PAGE_SIZE];
+    seq[p]   = (uint16_t)(page[0] | (page[1] << 8));
+    valid[p] = KVSTORE_crcValid(KVSTORE_crc(KVSTORE_CRC_INIT, page, 2), &page[2]);
+    if (valid[p] && (!found || ((int16_t)(seq[p] - headSeq) > 0)))
+    {
+      head    = p;
+      headSeq = seq[p];
+      found   = true;
+    }
+  }
+
+  /* Pages are taken in turn, so the page after the head is the oldest */
+  for (n = 1; found && (n <= KVSTORE_PAGES); n++)
+  {
+    p = (head + n) % KVSTORE_PAGES;
+    if (!valid[p])
+    {
+      continue;
+    }
+    page = &data[p * EECACHE_PAGE_SIZE];
+    for (offset = KVSTORE_PAGE_HEADER;
+         offset + KVSTORE_RECORD_HEADER <= EECACHE_PAGE_SIZE;
+         offset += KVSTORE_RECORD_HEADER + len)
+    {
+      len = page[offset + 1];
+      if ((page[offset] == KVSTORE_KEY_FREE) || (len > KVSTORE_MAX_VALUE) ||
+          (offset + KVSTORE_RECORD_HEADER + len > EECACHE_PAGE_SIZE) ||
+          !KVSTORE_crcValid(KVSTORE_recordCrc(seq[p], &page[offset], len + 2),
+                            &page[offset + len + 2]))
+      {
+        break;
+      }
+      entry = KVSTORE_find(page[offset]);
+      if (!entry && (entryCount < KVSTORE_MAX_KEYS))
+      {
+        entry      = &entries[entryCount++];
+        entry->key = page[offset];
+      }
+      if (entry)
+      {
+        entry->page = (uint8_t) p;
+        entry->len  = (uint8_t) len;
+        memcpy(entry->value, &page[offset + 2], len);
+      }
+    }
+    if (p == head)
+    {
+      headOffset = offset;
+    }
+  }
+
+  /* Complete a reclaim cut short by reset or power failure */
+  if (found)
+  {
+    KVSTORE_reclaim();
+  }
+  return entryCount;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Get value of key, from RAM.
+ *
+ * @return
+ *   Length of value, at most size bytes copied. KVSTORE_NOT_FOUND if the
+ *   key has no value.
+ ******************************************************************************/
+int KVSTORE_get(uint8_t key, uint8_t *value, unsigned int size)
+{
+  KVSTORE_Entry_TypeDef *entry = KVSTORE_find(key);
+
+  if (!entry)
+  {
+    return KVSTORE_NOT_FOUND;
+  }
+  memcpy(value, entry->value, (entry->len < size) ? entry->len : size);
+  return entry->len;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Put value of key, appending a record unless the value is unchanged.
+ *
+ * @return
+ *   0 on success, KVSTORE_INVALID, KVSTORE_FULL or negative I2C transfer
+ *   status on error.
+ ******************************************************************************/
+int KVSTORE_put(uint8_t key, const uint8_t *value, unsigned int len)
+{
+  KVSTORE_Entry_TypeDef *entry;
+  KVSTORE_Entry_TypeDef update;
+  int                   ret;
+  int                   n;
+
+  if ((key == KVSTORE_KEY_FREE) || (len > KVSTORE_MAX_VALUE))
+  {
+    return KVSTORE_INVALID;
+  }
+  entry = KVSTORE_find(key);
+  if (entry && (entry->len == len) && (memcmp(entry->value, value, len) == 0))
+  {
+    return 0;
+  }
+  if (!entry && (entryCount == KVSTORE_MAX_KEYS))
+  {
+    return KVSTORE_FULL;
+  }
+
+  /* Each page taken frees one, give up when going round without room */
+  for (n = 0; headOffset + KVSTORE_RECORD_HEADER + len > EECACHE_PAGE_SIZE; n++)
+  {
+    if (n == KVSTORE_PAGES)
+    {
+      return KVSTORE_FULL;
+    }
+    ret = KVSTORE_advance();
+    if (ret < 0)
+    {
+      return ret;
+    }
+  }
+
+  update.key = key;
+  update.len = (uint8_t) len;
+  memcpy(update.value, value, len);
+  ret = KVSTORE_append(&update);
+  if (ret < 0)
+  {
+    return ret;
+  }
+  if (!entry)
+  {
+    entry = &entries[entryCount++];
+  }
+  *entry = update;
+  return 0;
+}
@@ -0,0 +1,104 @@
+/**************************************************************************//**
+ * @file
+ * @brief Log-structured key/value store on I2C EEPROM
+ * @author Energy Micro AS
+ * @version 3.20.0
+ ******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 Energy Micro AS, http://www.energymicro.com</b>
+ *******************************************************************************
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ * 4. The source and compiled code may only be used on Energy Micro "EFM32"
+ *    microcontrollers and "EFR4" radios.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: Energy Micro AS has no
+ * obligation to support this Software. Energy Micro AS is providing the
+ * Software "AS IS", with no express or implied warranties of any kind,
+ * including, but not limited to, any implied warranties of merchantability
+ * or fitness for any particular purpose or warranties against infringement
+ * of any proprietary rights of a third party.
+ *
+ * Energy Micro AS will not be liable for any consequential, incidental, or
+ * special damages, or any other relief, or for any claim by any third party,
+ * arising from your use of this Software.
+ *
+ *****************************************************************************/
+#ifndef __KVSTORE_H
+#define __KVSTORE_H
+
+#include <stdint.h>
+#include "em_device.h"
+#include "eecache.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+   Log-structured key/value store on the I2C EEPROM.
+
+   Each put appends a record to the head page instead of rewriting the
+   value in place. Pages are taken in turn round the whole EEPROM, so
+   writes of a value changed often are spread over all pages. The page
+   after the head is kept free: when a page is taken, values still current
+   in the page after it are copied into the new head first.
+
+   Page layout:  [seq low][seq high][crc low][crc high] then records
+   Record:       [key][length][value...][crc low][crc high]
+
+   The CRC-16 of a record covers the page sequence number, key, length and
+   value, so a record torn by power failure, or left from an earlier use of
+   the page, ends the page. A torn record passes the check with odds of
+   about 1 in 65536. CRC-16 rather than CRC-8: a header torn in a way
+   passing an 8 bit check would also make all old records in the page pass.
+
+   On mount the whole EEPROM is read in one transfer, pages are replayed
+   oldest first, and values are kept in RAM, so gets cost no bus traffic.
+
+   Records are written through the write-back cache (eecache.c): a put is
+   durable once the cache has been written back, by EECACHE_sync() or
+   EECACHE_poll(). Before a page is reused the cache is synced, so that
+   copies of its current values are written before it is overwritten.
+*/
+
+/** Number of EEPROM pages used */
+#define KVSTORE_PAGES       (EECACHE_SIZE / EECACHE_PAGE_SIZE)
+
+/** Bytes of page header, and of record key, length and CRC */
+#define KVSTORE_PAGE_HEADER   4
+#define KVSTORE_RECORD_HEADER 4
+
+/** Largest value, a record filling a page */
+#define KVSTORE_MAX_VALUE   (EECACHE_PAGE_SIZE - KVSTORE_PAGE_HEADER - KVSTORE_RECORD_HEADER)
+
+/** Most keys held */
+#ifndef KVSTORE_MAX_KEYS
+#define KVSTORE_MAX_KEYS    16
+#endif
+
+/** Key value marking free space in a page */
+#define KVSTORE_KEY_FREE    0xff
+
+/** Errors, other negative values are I2C transfer status */
+#define KVSTORE_NOT_FOUND   (-100)  /**< No value for key */
+#define KVSTORE_FULL        (-101)  /**< No room for another key or value */
+#define KVSTORE_INVALID     (-102)  /**< Key or length not allowed */
+
+int KVSTORE_mount(uint8_t addr);
+int KVSTORE_get(uint8_t key, uint8_t *value, unsigned int size);
+int KVSTORE_put(uint8_t key, const uint8_t *value, unsigned int len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -49,6 +49,8 @@
 #include "bsp_trace.h"
 #include "segmentlcd.h"
 #include "rtcdrv.h"
+/* Clock and energy mode trace, when built with ETRACE_ENABLE */
+#include "etrace.h"
 
 #define GPIO_INT_PIN 14
 
@@ -186,6 +188,8 @@ int main(void)
 
   /* If first word of user data page is non-zero, enable eA Profiler trace */
   BSP_TraceProfilerSetup();
+  /* Start recording clock and energy mode transitions */
+  ETRACE_init();
   /* Initialize DK interrupt enable */
   DkIrqInit();
   /* Initialize GPIO interrupt */
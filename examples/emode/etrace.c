@@ -0,0 +1,386 @@
+/**************************************************************************//**
+ * @file
+ * @brief Clock and energy mode transition trace for the host energy model
+ * @author Energy Micro AS
+ * @version 3.20.0
+ ******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 Energy Micro AS, http://www.energymicro.com</b>
+ *******************************************************************************
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ * 4. The source and compiled code may only be used on Energy Micro "EFM32"
+ *    microcontrollers and "EFR4" radios.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: Energy Micro AS has no
+ * obligation to support this Software. Energy Micro AS is providing the
+ * Software "AS IS", with no express or implied warranties of any kind,
+ * including, but not limited to, any implied warranties of merchantability
+ * or fitness for any particular purpose or warranties against infringement
+ * of any proprietary rights of a third party.
+ *
+ * Energy Micro AS will not be liable for any consequential, incidental, or
+ * special damages, or any other relief, or for any claim by any third party,
+ * arising from your use of this Software.
+ *
+ *****************************************************************************/
+/* Calls in this file go to emlib, not through the redirection */
+#define ETRACE_NO_REDIRECT
+#include "etrace.h"
+
+#if defined(ETRACE_ENABLE)
+
+/** Trace flag if bit is set in register */
+#define ETRACE_MAP(reg, bit, flag)  (((reg) & (bit)) ? (flag) : 0)
+
+static ETRACE_Record_TypeDef records[ETRACE_RECORDS];
+static int recordCount;
+
+/***************************************************************************//**
+ * @brief
+ *   Fill in record with current clock state.
+ ******************************************************************************/
+static void ETRACE_snapshot(ETRACE_Record_TypeDef *rec, ETRACE_Event_TypeDef event, uint8_t arg)
+{
+  uint32_t status = CMU->STATUS;
+  uint32_t hfper  = CMU->HFPERCLKEN0;
+  uint32_t hfcore = CMU->HFCORECLKEN0;
+  uint32_t lfa    = CMU->LFACLKEN0;
+  uint32_t lfb    = CMU->LFBCLKEN0;
+
+  rec->cycles = DWT->CYCCNT;
+  rec->event  = (uint8_t) event;
+  rec->arg    = arg;
+
+  rec->osc = ETRACE_MAP(status, CMU_STATUS_HFRCOENS, ETRACE_OSC_HFRCO) |
+             ETRACE_MAP(status, CMU_STATUS_HFXOENS, ETRACE_OSC_HFXO) |
+             ETRACE_MAP(status, CMU_STATUS_AUXHFRCOENS, ETRACE_OSC_AUXHFRCO) |
+             ETRACE_MAP(status, CMU_STATUS_LFRCOENS, ETRACE_OSC_LFRCO) |
+             ETRACE_MAP(status, CMU_STATUS_LFXOENS, ETRACE_OSC_LFXO);
+
+  /* HFPERCLKDIV gates the clock of all high frequency peripherals */
+  if (!(CMU->HFPERCLKDIV & CMU_HFPERCLKDIV_HFPERCLKEN))
+  {
+    hfper = 0;
+  }
+  rec->per = 0;
+#if defined(CMU_HFPERCLKEN0_TIMER0)
+  rec->per |= ETRACE_MAP(hfper, CMU_HFPERCLKEN0_TIMER0, ETRACE_PER_TIMER);
+#endif
+#if defined(CMU_HFPERCLKEN0_TIMER1)
+  rec->per |= ETRACE_MAP(hfper, CMU_HFPERCLKEN0_TIMER1, ETRACE_PER_TIMER);
+#endif
+#if defined(CMU_HFPERCLKEN0_TIMER2)
+  rec->per |= ETRACE_MAP(hfper, CMU_HFPERCLKEN0_TIMER2, ETRACE_PER_TIMER);
+#endif
+#if defined(CMU_HFPERCLKEN0_USART0)
+  rec->per |= ETRACE_MAP(hfper, CMU_HFPERCLKEN0_USART0, ETRACE_PER_USART);
+#endif
+#if defined(CMU_HFPERCLKEN0_USART1)
+  rec->per |= ETRACE_MAP(hfper, CMU_HFPERCLKEN0_USART1, ETRACE_PER_USART);
+#endif
+#if defined(CMU_HFPERCLKEN0_USART2)
+  rec->per |= ETRACE_MAP(hfper, CMU_HFPERCLKEN0_USART2, ETRACE_PER_USART);
+#endif
+#if defined(CMU_HFPERCLKEN0_UART0)
+  rec->per |= ETRACE_MAP(hfper, CMU_HFPERCLKEN0_UART0, ETRACE_PER_UART);
+#endif
+#if defined(CMU_HFPERCLKEN0_ACMP0)
+  rec->per |= ETRACE_MAP(hfper, CMU_HFPERCLKEN0_ACMP0, ETRACE_PER_ACMP);
+#endif
+#if defined(CMU_HFPERCLKEN0_ACMP1)
+  rec->per |= ETRACE_MAP(hfper, CMU_HFPERCLKEN0_ACMP1, ETRACE_PER_ACMP);
+#endif
+#if defined(CMU_HFPERCLKEN0_PRS)
+  rec->per |= ETRACE_MAP(hfper, CMU_HFPERCLKEN0_PRS, ETRACE_PER_PRS);
+#endif
+#if defined(CMU_HFPERCLKEN0_DAC0)
+  rec->per |= ETRACE_MAP(hfper, CMU_HFPERCLKEN0_DAC0, ETRACE_PER_DAC);
+#endif
+#if defined(CMU_HFPERCLKEN0_GPIO)
+  rec->per |= ETRACE_MAP(hfper, CMU_HFPERCLKEN0_GPIO, ETRACE_PER_GPIO);
+#endif
+#if defined(CMU_HFPERCLKEN0_VCMP)
+  rec->per |= ETRACE_MAP(hfper, CMU_HFPERCLKEN0_VCMP, ETRACE_PER_VCMP);
+#endif
+#if defined(CMU_HFPERCLKEN0_ADC0)
+  rec->per |= ETRACE_MAP(hfper, CMU_HFPERCLKEN0_ADC0, ETRACE_PER_ADC);
+#endif
+#if defined(CMU_HFPERCLKEN0_I2C0)
+  rec->per |= ETRACE_MAP(hfper, CMU_HFPERCLKEN0_I2C0, ETRACE_PER_I2C);
+#endif
+#if defined(CMU_HFCORECLKEN0_DMA)
+  rec->per |= ETRACE_MAP(hfcore, CMU_HFCORECLKEN0_DMA, ETRACE_PER_DMA);
+#endif
+#if defined(CMU_HFCORECLKEN0_AES)
+  rec->per |= ETRACE_MAP(hfcore, CMU_HFCORECLKEN0_AES, ETRACE_PER_AES);
+#endif
+#if defined(CMU_HFCORECLKEN0_EBI)
+  rec->per |= ETRACE_MAP(hfcore, CMU_HFCORECLKEN0_EBI, ETRACE_PER_EBI);
+#endif
+
+  rec->lf = 0;
+#if defined(CMU_LFACLKEN0_RTC)
+  rec->lf |= ETRACE_MAP(lfa, CMU_LFACLKEN0_RTC, ETRACE_LF_RTC);
+#endif
+#if defined(CMU_LFACLKEN0_LETIMER0)
+  rec->lf |= ETRACE_MAP(lfa, CMU_LFACLKEN0_LETIMER0, ETRACE_LF_LETIMER);
+#endif
+#if defined(CMU_LFACLKEN0_LCD)
+  rec->lf |= ETRACE_MAP(lfa, CMU_LFACLKEN0_LCD, ETRACE_LF_LCD);
+#endif
+#if defined(CMU_LFBCLKEN0_LEUART0)
+  rec->lf |= ETRACE_MAP(lfb, CMU_LFBCLKEN0_LEUART0, ETRACE_LF_LEUART);
+#endif
+#if defined(CMU_LFBCLKEN0_LEUART1)
+  rec->lf |= ETRACE_MAP(lfb, CMU_LFBCLKEN0_LEUART1, ETRACE_LF_LEUART);
+#endif
+
+  /* RTC registers can only be read with the low energy interface clocked */
+  rec->rtc     = 0;
+  rec->rtcTop  = 0;
+  rec->rtcFreq = 0;
+  if ((hfcore & CMU_HFCORECLKEN0_LE) && (rec->lf & ETRACE_LF_RTC))
+  {
+    rec->rtc     = RTC->CNT;
+    rec->rtcFreq = CMU_ClockFreqGet(cmuClock_RTC);
+    if (RTC->CTRL & RTC_CTRL_EN)
+    {
+      /* With COMP0TOP, as set up by RTCDRV, the counter wraps after COMP0 */
+      rec->rtcTop = (RTC->CTRL & RTC_CTRL_COMP0TOP) ? RTC->COMP0 + 1 : _RTC_CNT_MASK + 1;
+    }
+  }
+
+  rec->coreFreq = CMU_ClockFreqGet(cmuClock_CORE);
+  rec->perFreq  = (rec->per != 0) ? CMU_ClockFreqGet(cmuClock_HFPER) : 0;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Write number to SWO, in decimal or hexadecimal.
+ ******************************************************************************/
+static void ETRACE_putNumber(uint32_t value, uint32_t base)
+{
+  char buffer[12];
+  int  i = sizeof(buffer) - 1;
+
+  buffer[i--] = '\0';
+  do
+  {
+    buffer[i--] = "0123456789abcdef"[value % base];
+    value      /= base;
+  } while (value);
+  buffer[i] = ' ';
+  for (; buffer[i]; i++)
+  {
+    ITM_SendChar(buffer[i]);
+  }
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Write record to SWO as a text line.
+ *   "ET <event> <arg> <cycles> <rtc> <rtcTop> <rtcFreq> <coreFreq> <perFreq>
+ *   <osc> <per> <lf>", with the last three fields in hexadecimal.
+ ******************************************************************************/
+static void ETRACE_write(const ETRACE_Record_TypeDef *rec)
+{
+  ITM_SendChar('E');
+  ITM_SendChar('T');
+  ITM_SendChar(' ');
+  ITM_SendChar(rec->event);
+  ETRACE_putNumber(rec->arg, 10);
+  ETRACE_putNumber(rec->cycles, 10);
+  ETRACE_putNumber(rec->rtc, 10);
+  ETRACE_putNumber(rec->rtcTop, 10);
+  ETRACE_putNumber(rec->rtcFreq, 10);
+  ETRACE_putNumber(rec->coreFreq, 10);
+  ETRACE_putNumber(rec->perFreq, 10);
+  ETRACE_putNumber(rec->osc, 16);
+  ETRACE_putNumber(rec->per, 16);
+  ETRACE_putNumber(rec->lf, 16);
+  ITM_SendChar('\n');
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Add record, writing the buffer out first if full.
+ ******************************************************************************/
+static void ETRACE_record(ETRACE_Event_TypeDef event, uint8_t arg)
+{
+  /* Keep one record free for the flush marker */
+  if (recordCount >= ETRACE_RECORDS - 1)
+  {
+    ETRACE_flush();
+  }
+  ETRACE_snapshot(&records[recordCount++], event, arg);
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Write records to SWO and empty the buffer.
+ ******************************************************************************/
+static void ETRACE_writeAll(void)
+{
+  int i;
+
+  for (i = 0; i < recordCount; i++)
+  {
+    ETRACE_write(&records[i]);
+  }
+  recordCount = 0;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Record energy mode entry. The buffer is written out before EM3 and EM4,
+ *   as there may be no wake up from them other than a reset.
+ ******************************************************************************/
+static void ETRACE_sleep(uint8_t mode)
+{
+  if (mode >= 3)
+  {
+    ETRACE_flush();
+    ETRACE_record(etraceEventSleep, mode);
+    ETRACE_writeAll();
+  }
+  else
+  {
+    ETRACE_record(etraceEventSleep, mode);
+  }
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Set up SWO on PC15 and enable ITM stimulus port 0, as setupSWO() of the
+ *   tftemode example, but without PC sampling. ITM_SendChar() drops
+ *   characters until this is done. The SWO clock, AUXHFRCO, stays enabled
+ *   and shows in the records.
+ ******************************************************************************/
+static void ETRACE_setupSwo(void)
+{
+  volatile uint32_t *tpiuPrescaler = (volatile uint32_t *) 0xE0040010;
+  volatile uint32_t *tpiuProtocol  = (volatile uint32_t *) 0xE00400F0;
+
+  CMU->HFPERCLKEN0 |= CMU_HFPERCLKEN0_GPIO;
+  /* Enable Serial wire output pin, location 1 */
+  GPIO->ROUTE = (GPIO->ROUTE & ~(_GPIO_ROUTE_SWLOCATION_MASK)) |
+                GPIO_ROUTE_SWOPEN | GPIO_ROUTE_SWLOCATION_LOC1;
+  GPIO->P[2].MODEH = (GPIO->P[2].MODEH & ~(_GPIO_P_MODEH_MODE15_MASK)) |
+                     GPIO_P_MODEH_MODE15_PUSHPULL;
+
+  /* Enable debug clock AUXHFRCO */
+  CMU->OSCENCMD = CMU_OSCENCMD_AUXHFRCOEN;
+  while (!(CMU->STATUS & CMU_STATUS_AUXHFRCORDY))
+    ;
+
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+
+  /* TPIU prescaler 16, NRZ protocol */
+  *tpiuPrescaler = 0xf;
+  *tpiuProtocol  = 2;
+
+  /* Unlock ITM, enable it with trace bus ID 1, and stimulus port 0 */
+  ITM->LAR  = 0xC5ACCE55;
+  ITM->TCR  = 0x10009;
+  ITM->TER |= 1;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Set up SWO, start the core cycle counter and record the initial clock
+ *   state.
+ ******************************************************************************/
+void ETRACE_init(void)
+{
+  ETRACE_setupSwo();
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+  recordCount = 0;
+  ETRACE_record(etraceEventResume, 0);
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Write buffered records to SWO. The time spent writing is marked, and
+ *   left out by the energy model.
+ ******************************************************************************/
+void ETRACE_flush(void)
+{
+  ETRACE_snapshot(&records[recordCount++], etraceEventFlush, 0);
+  ETRACE_writeAll();
+  ETRACE_snapshot(&records[recordCount++], etraceEventResume, 0);
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Select clock source, and record the new clock state.
+ ******************************************************************************/
+void ETRACE_clockSelectSet(CMU_Clock_TypeDef clock, CMU_Select_TypeDef ref)
+{
+  CMU_ClockSelectSet(clock, ref);
+  ETRACE_record(etraceEventClock, (uint8_t) ref);
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Select HFRCO band, and record the new clock state.
+ ******************************************************************************/
+void ETRACE_hfrcoBandSet(CMU_HFRCOBand_TypeDef band)
+{
+  CMU_HFRCOBandSet(band);
+  ETRACE_record(etraceEventBand, (uint8_t) band);
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Enter EM1, recording clock state before and after.
+ ******************************************************************************/
+void ETRACE_enterEM1(void)
+{
+  ETRACE_sleep(1);
+  EMU_EnterEM1();
+  ETRACE_record(etraceEventWake, 1);
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Enter EM2, recording clock state before and after.
+ ******************************************************************************/
+void ETRACE_enterEM2(bool restore)
+{
+  ETRACE_sleep(2);
+  EMU_EnterEM2(restore);
+  ETRACE_record(etraceEventWake, 2);
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Enter EM3, writing out the trace first.
+ ******************************************************************************/
+void ETRACE_enterEM3(bool restore)
+{
+  ETRACE_sleep(3);
+  EMU_EnterEM3(restore);
+  ETRACE_record(etraceEventWake, 3);
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Enter EM4, writing out the trace first. EM4 is left through reset only.
+ ******************************************************************************/
+void ETRACE_enterEM4(void)
+{
+  ETRACE_sleep(4);
+  EMU_EnterEM4();
+}
+
+#endif
@@ -0,0 +1,156 @@
+/**************************************************************************//**
+ * @file
+ * @brief Clock and energy mode transition trace for the host energy model
+ * @author Energy Micro AS
+ * @version 3.20.0
+ ******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 Energy Micro AS, http://www.energymicro.com</b>
+ *******************************************************************************
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ * 4. The source and compiled code may only be used on Energy Micro "EFM32"
+ *    microcontrollers and "EFR4" radios.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: Energy Micro AS has no
+ * obligation to support this Software. Energy Micro AS is providing the
+ * Software "AS IS", with no express or implied warranties of any kind,
+ * including, but not limited to, any implied warranties of merchantability
+ * or fitness for any particular purpose or warranties against infringement
+ * of any proprietary rights of a third party.
+ *
+ * Energy Micro AS will not be liable for any consequential, incidental, or
+ * special damages, or any other relief, or for any claim by any third party,
+ * arising from your use of this Software.
+ *
+ *****************************************************************************/
+#ifndef __ETRACE_H
+#define __ETRACE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "em_device.h"
+#include "em_cmu.h"
+#include "em_emu.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+   Capture of clock and energy mode transitions for the host energy model
+   in host/energy.
+
+   Define ETRACE_ENABLE for the project and include this file after the
+   emlib headers. CMU_ClockSelectSet(), CMU_HFRCOBandSet() and EMU_EnterEMx()
+   are then redirected through the functions below, which record enabled
+   oscillators and peripheral clocks together with the core cycle counter
+   and the RTC counter. Clock enable and OSCENCMD registers written directly
+   are picked up by the next record, at the latest when the next energy mode
+   is entered.
+
+   Records are written as text lines to SWO (ITM stimulus port 0) when the
+   buffer is full, and before EM3 or EM4 is entered. ETRACE_init() sets up
+   SWO on PC15, location 1, as on the DVK. Without ETRACE_ENABLE
+   nothing is redirected, ETRACE_init() and ETRACE_flush() do nothing,
+   and etrace.c is empty.
+*/
+
+/** Number of records buffered before they are written to SWO */
+#define ETRACE_RECORDS      32
+
+/** Oscillator flags of a record */
+#define ETRACE_OSC_HFRCO    0x01
+#define ETRACE_OSC_HFXO     0x02
+#define ETRACE_OSC_AUXHFRCO 0x04
+#define ETRACE_OSC_LFRCO    0x08
+#define ETRACE_OSC_LFXO     0x10
+
+/** High frequency peripheral clock flags of a record */
+#define ETRACE_PER_TIMER    0x0001
+#define ETRACE_PER_USART    0x0002
+#define ETRACE_PER_UART     0x0004
+#define ETRACE_PER_ACMP     0x0008
+#define ETRACE_PER_PRS      0x0010
+#define ETRACE_PER_DAC      0x0020
+#define ETRACE_PER_GPIO     0x0040
+#define ETRACE_PER_VCMP     0x0080
+#define ETRACE_PER_ADC      0x0100
+#define ETRACE_PER_I2C      0x0200
+#define ETRACE_PER_DMA      0x0400
+#define ETRACE_PER_AES      0x0800
+#define ETRACE_PER_EBI      0x1000
+
+/** Low frequency peripheral clock flags of a record */
+#define ETRACE_LF_RTC       0x01
+#define ETRACE_LF_LETIMER   0x02
+#define ETRACE_LF_LCD       0x04
+#define ETRACE_LF_LEUART    0x08
+
+/** Record events, written as the first field of a trace line */
+typedef enum
+{
+  etraceEventClock  = 'C', /**< Clock source selected, arg is CMU_Select_TypeDef */
+  etraceEventBand   = 'B', /**< HFRCO band selected, arg is band */
+  etraceEventSleep  = 'S', /**< Energy mode arg about to be entered */
+  etraceEventWake   = 'W', /**< Woken up from energy mode arg */
+  etraceEventFlush  = 'F', /**< Records are written to SWO from here... */
+  etraceEventResume = 'R'  /**< ...until here, time not part of the trace */
+} ETRACE_Event_TypeDef;
+
+/** Snapshot of clock state at an event */
+typedef struct
+{
+  uint8_t  event;        /**< ETRACE_Event_TypeDef */
+  uint8_t  arg;          /**< Energy mode, oscillator flag or HFRCO band */
+  uint8_t  osc;          /**< ETRACE_OSC_ flags of enabled oscillators */
+  uint8_t  lf;           /**< ETRACE_LF_ flags of clocked peripherals */
+  uint16_t per;          /**< ETRACE_PER_ flags of clocked peripherals */
+  uint32_t cycles;       /**< DWT core cycle counter */
+  uint32_t rtc;          /**< RTC counter */
+  uint32_t rtcTop;       /**< RTC counter wrap value, 0 if not counting */
+  uint32_t rtcFreq;      /**< RTC counter frequency, 0 if not readable */
+  uint32_t coreFreq;     /**< HFCORECLK frequency */
+  uint32_t perFreq;      /**< HFPERCLK frequency */
+} ETRACE_Record_TypeDef;
+
+#if defined(ETRACE_ENABLE)
+
+void ETRACE_init(void);
+void ETRACE_flush(void);
+void ETRACE_clockSelectSet(CMU_Clock_TypeDef clock, CMU_Select_TypeDef ref);
+void ETRACE_hfrcoBandSet(CMU_HFRCOBand_TypeDef band);
+void ETRACE_enterEM1(void);
+void ETRACE_enterEM2(bool restore);
+void ETRACE_enterEM3(bool restore);
+void ETRACE_enterEM4(void);
+
+#if !defined(ETRACE_NO_REDIRECT)
+#define CMU_ClockSelectSet(clock, ref)  ETRACE_clockSelectSet(clock, ref)
+#define CMU_HFRCOBandSet(band)          ETRACE_hfrcoBandSet(band)
+#define EMU_EnterEM1()                  ETRACE_enterEM1()
+#define EMU_EnterEM2(restore)           ETRACE_enterEM2(restore)
+#define EMU_EnterEM3(restore)           ETRACE_enterEM3(restore)
+#define EMU_EnterEM4()                  ETRACE_enterEM4()
+#endif
+
+#else
+
+#define ETRACE_init()    do {} while (0)
+#define ETRACE_flush()   do {} while (0)
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
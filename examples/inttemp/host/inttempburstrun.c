@@ -0,0 +1,388 @@
+/**************************************************************************//**
+ * @file
+ * @brief Host runner for internal temperature sensor burst reduction
+ * @author Energy Micro AS
+ * @version 3.20.0
+ ******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 Energy Micro AS, http://www.energymicro.com</b>
+ *******************************************************************************
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ * 4. The source and compiled code may only be used on Energy Micro "EFM32"
+ *    microcontrollers and "EFR4" radios.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: Energy Micro AS has no
+ * obligation to support this Software. Energy Micro AS is providing the
+ * Software "AS IS", with no express or implied warranties of any kind,
+ * including, but not limited to, any implied warranties of merchantability
+ * or fitness for any particular purpose or warranties against infringement
+ * of any proprietary rights of a third party.
+ *
+ * Energy Micro AS will not be liable for any consequential, incidental, or
+ * special damages, or any other relief, or for any claim by any third party,
+ * arising from your use of this Software.
+ *
+ *****************************************************************************/
+
+/*
+   Host runner for burst reduction of internal temperature sensor samples
+   (inttempburst.c), on synthetic data.
+
+   The sensor is modelled as the temperature slowly drifting around 25
+   degrees Celsius, converted to ADC codes with the datasheet gradient,
+   with gaussian noise of sigma codes added to each conversion. Each result
+   is the sum of 16 quantized conversions, as with the 16 times hardware
+   oversampling of ADC0 in inttemp.c. With -s, a fraction of the results
+   is replaced by disturbed results far off the rest.
+
+   For each noise level, readings are made with fixed bursts of 8, 16 and
+   64 results reduced by the mean and by INTTEMPBURST, and with bursts of
+   adaptive length as in inttemp.c. The RMS error in degrees Celsius
+   against the modelled temperature is shown with the mean burst length,
+   and the energy per reading from the model below.
+
+   The energy model covers the burst only: the core waits in EM1 at
+   HFRCO 14 MHz with ADC0 and DMA clocked, at INTTEMPBURSTRUN_ADC_UA of
+   ADC analog current, while each result takes 16 conversions of 14 ADC
+   clocks at 400 kHz. Currents are those of host/energy/energymodel.c; the
+   figures are for comparing burst lengths, not absolute.
+
+   The run fails unless, at each noise level:
+   - the noise estimate is within 25% of the modelled noise,
+   - adaptive bursts not at INTTEMPBURST_MAX_LENGTH reach the target
+     standard error within INTTEMPBURSTRUN_TARGET_MARGIN,
+   - adaptive bursts use no more energy than fixed bursts of 64, and
+   - with disturbed results, at most INTTEMPBURSTRUN_GROSS_MAX readings of
+     adaptive bursts are off by more than INTTEMPBURSTRUN_GROSS_C, which
+     happens when more than a quarter of a burst is disturbed.
+
+   Usage: inttempburstrun
+*/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <math.h>
+#include "inttempconv.h"
+#include "inttempburst.h"
+
+/** Readings per noise level. */
+#define INTTEMPBURSTRUN_READINGS        4000
+
+/** Factory calibration temperature, degrees Celsius. */
+#define INTTEMPBURSTRUN_CAL_TEMP        25
+/** Factory calibration ADC code. */
+#define INTTEMPBURSTRUN_CAL_VALUE       1880
+
+/** Fraction of results disturbed with -s, 1/1000. */
+#define INTTEMPBURSTRUN_SPIKE_RATE      20
+/** Offset of disturbed result, codes. */
+#define INTTEMPBURSTRUN_SPIKE_CODES     100
+
+/** Allowed RMS error relative to target standard error. */
+#define INTTEMPBURSTRUN_TARGET_MARGIN   1.3
+/** Error of reading counted as gross, degrees Celsius. */
+#define INTTEMPBURSTRUN_GROSS_C         0.1
+/** Allowed gross errors per noise level with disturbed results. */
+#define INTTEMPBURSTRUN_GROSS_MAX       4
+
+/** HFCORECLK and HFPERCLK, MHz. */
+#define INTTEMPBURSTRUN_HF_MHZ          14.0
+/** ADC clock, Hz. */
+#define INTTEMPBURSTRUN_ADC_HZ          400000.0
+/** ADC clocks per conversion, 1 acquisition and 13 conversion. */
+#define INTTEMPBURSTRUN_ADC_CLOCKS      14
+/** Conversions per result, hardware oversampling. */
+#define INTTEMPBURSTRUN_OVS             16
+/** ADC analog current while converting, uA (assumed). */
+#define INTTEMPBURSTRUN_ADC_UA          200.0
+/** Supply voltage. */
+#define INTTEMPBURSTRUN_SUPPLY_V        3.0
+
+/** Burst reduction compared. */
+typedef enum
+{
+  INTTEMPBURSTRUN_MEAN,
+  INTTEMPBURSTRUN_IQM
+} INTTEMPBURSTRUN_Reduce_TypeDef;
+
+/** Accumulated result of readings. */
+typedef struct
+{
+  double sumSq;
+  double sumLength;
+  double sumNoise;
+  int    gross;
+} INTTEMPBURSTRUN_Result_TypeDef;
+
+/** Random generator state. */
+static uint64_t inttempBurstRunSeed;
+
+/** Sensor conversion, as in inttemp.c. */
+static INTTEMPCONV_Cal_TypeDef inttempBurstRunCal;
+
+/***************************************************************************//**
+ * @brief
+ *   Uniform random number in (0, 1).
+ ******************************************************************************/
+static double inttempBurstRunUniform(void)
+{
+  inttempBurstRunSeed = inttempBurstRunSeed * 6364136223846793005ULL +
+                        1442695040888963407ULL;
+  return ((inttempBurstRunSeed >> 11) + 0.5) / 9007199254740992.0;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Gaussian random number, zero mean and unit variance (Box-Muller).
+ ******************************************************************************/
+static double inttempBurstRunGauss(void)
+{
+  double u = inttempBurstRunUniform();
+  double v = inttempBurstRunUniform();
+
+  return sqrt(-2.0 * log(u)) * cos(6.283185307179586 * v);
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Modelled temperature of reading, degrees Celsius.
+ ******************************************************************************/
+static double inttempBurstRunTemp(int reading)
+{
+  return INTTEMPBURSTRUN_CAL_TEMP + 3.0 * sin(reading * 0.0031) +
+         0.4 * sin(reading * 0.047);
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Fill burst with oversampled results of modelled sensor.
+ ******************************************************************************/
+static void inttempBurstRunSample(uint16_t *samples,
+                                  unsigned int count,
+                                  double temp,
+                                  double sigma,
+                                  bool spikes)
+{
+  double       code;
+  double       sum;
+  unsigned int i;
+  int          j;
+
+  code = INTTEMPBURSTRUN_CAL_VALUE -
+         (temp - INTTEMPBURSTRUN_CAL_TEMP) * INTTEMPCONV_GRAD_CENTI / 100.0;
+  for (i = 0; i < count; i++)
+  {
+    sum = 0;
+    for (j = 0; j < INTTEMPBURSTRUN_OVS; j++)
+    {
+      sum += floor(code + sigma * inttempBurstRunGauss() + 0.5);
+    }
+    if (spikes &&
+        (inttempBurstRunUniform() * 1000 < INTTEMPBURSTRUN_SPIKE_RATE))
+    {
+      sum += ((inttempBurstRunUniform() < 0.5) ? -1 : 1) *
+             INTTEMPBURSTRUN_SPIKE_CODES * INTTEMPBURSTRUN_OVS;
+    }
+    samples[i] = (uint16_t)sum;
+  }
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Energy of burst in the model, uJ.
+ ******************************************************************************/
+static double inttempBurstRunEnergy(double length)
+{
+  double seconds;
+  double uA;
+
+  seconds = length * INTTEMPBURSTRUN_OVS * INTTEMPBURSTRUN_ADC_CLOCKS /
+            INTTEMPBURSTRUN_ADC_HZ;
+  /* EM1, HFRCO, ADC and DMA clocks, and ADC analog current */
+  uA = INTTEMPBURSTRUN_HF_MHZ * (45.0 + 6.0 + 8.0) + 90.0 +
+       INTTEMPBURSTRUN_ADC_UA;
+
+  return seconds * uA * INTTEMPBURSTRUN_SUPPLY_V;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Make readings at one noise level.
+ *
+ * @param[in] length
+ *   Fixed burst length, or 0 for adaptive length.
+ ******************************************************************************/
+static void inttempBurstRunReadings(INTTEMPBURSTRUN_Result_TypeDef *result,
+                                    double sigma,
+                                    unsigned int length,
+                                    INTTEMPBURSTRUN_Reduce_TypeDef reduce,
+                                    bool spikes)
+{
+  INTTEMPBURST_State_TypeDef state;
+  uint16_t                   samples[INTTEMPBURST_MAX_LENGTH];
+  unsigned int               count;
+  unsigned int               i;
+  uint32_t                   sum;
+  uint32_t                   value;
+  double                     temp;
+  double                     err;
+  int                        reading;
+
+  inttempBurstRunSeed = 1;
+  INTTEMPBURST_init(&state);
+  memset(result, 0, sizeof(*result));
+
+  for (reading = 0; reading < INTTEMPBURSTRUN_READINGS; reading++)
+  {
+    count = length ? length : state.length;
+    temp  = inttempBurstRunTemp(reading);
+    inttempBurstRunSample(samples, count, temp, sigma, spikes);
+
+    if (reduce == INTTEMPBURSTRUN_MEAN)
+    {
+      for (sum = 0, i = 0; i < count; i++)
+      {
+        sum += samples[i];
+      }
+      value = (sum + count / 2) / count;
+    }
+    else
+    {
+      value = INTTEMPBURST_process(&state, samples, count);
+    }
+
+    err = INTTEMPCONV_centiCelsiusFrac(&inttempBurstRunCal,
+                                       value,
+                                       INTTEMPBURST_FRAC_BITS) / 100.0 - temp;
+    if (fabs(err) > INTTEMPBURSTRUN_GROSS_C)
+    {
+      result->gross++;
+    }
+    result->sumSq     += err * err;
+    result->sumLength += count;
+    result->sumNoise  += state.noise / 16.0;
+  }
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Print result of readings.
+ ******************************************************************************/
+static double inttempBurstRunPrint(const char *name,
+                                   const INTTEMPBURSTRUN_Result_TypeDef *result)
+{
+  double rms    = sqrt(result->sumSq / INTTEMPBURSTRUN_READINGS);
+  double length = result->sumLength / INTTEMPBURSTRUN_READINGS;
+
+  printf("  %-10s %8.4f %8.1f %8.2f %8d\n",
+         name, rms, length, inttempBurstRunEnergy(length), result->gross);
+
+  return rms;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Main function.
+ ******************************************************************************/
+int main(void)
+{
+  static const double            sigmas[] = { 0.5, 1.0, 2.0, 4.0 };
+  static const unsigned int      fixed[]  = { 8, 16, 64 };
+  INTTEMPBURSTRUN_Result_TypeDef result;
+  INTTEMPBURSTRUN_Result_TypeDef adaptive;
+  char                           name[16];
+  double                         target;
+  double                         noise;
+  double                         expected;
+  double                         rms;
+  double                         length;
+  double                         fixedEnergy = 0;
+  unsigned int                   s;
+  unsigned int                   f;
+  int                            failed = 0;
+
+  INTTEMPCONV_init(&inttempBurstRunCal,
+                   INTTEMPBURSTRUN_CAL_TEMP,
+                   INTTEMPBURSTRUN_CAL_VALUE);
+
+  /* Target standard error in degrees Celsius */
+  target = INTTEMPBURST_TARGET * 100.0 /
+           ((1 << INTTEMPBURST_FRAC_BITS) * INTTEMPCONV_GRAD_CENTI);
+
+  printf("%d readings per noise level, target standard error %.4f C\n",
+         INTTEMPBURSTRUN_READINGS, target);
+
+  for (s = 0; s < sizeof(sigmas) / sizeof(sigmas[0]); s++)
+  {
+    printf("\nnoise %.1f codes per conversion:\n", sigmas[s]);
+    printf("  %-10s %8s %8s %8s %8s\n",
+           "burst", "rms C", "length", "uJ", "gross");
+
+    for (f = 0; f < sizeof(fixed) / sizeof(fixed[0]); f++)
+    {
+      inttempBurstRunReadings(&result, sigmas[s], fixed[f],
+                              INTTEMPBURSTRUN_MEAN, false);
+      snprintf(name, sizeof(name), "mean %u", fixed[f]);
+      inttempBurstRunPrint(name, &result);
+      inttempBurstRunReadings(&result, sigmas[s], fixed[f],
+                              INTTEMPBURSTRUN_IQM, false);
+      snprintf(name, sizeof(name), "iqm %u", fixed[f]);
+      inttempBurstRunPrint(name, &result);
+      fixedEnergy = inttempBurstRunEnergy(fixed[f]);
+    }
+
+    inttempBurstRunReadings(&adaptive, sigmas[s], 0,
+                            INTTEMPBURSTRUN_IQM, false);
+    rms = inttempBurstRunPrint("adaptive", &adaptive);
+    length = adaptive.sumLength / INTTEMPBURSTRUN_READINGS;
+
+    inttempBurstRunReadings(&result, sigmas[s], 64,
+                            INTTEMPBURSTRUN_MEAN, true);
+    inttempBurstRunPrint("mean 64 -s", &result);
+    inttempBurstRunReadings(&result, sigmas[s], 0,
+                            INTTEMPBURSTRUN_IQM, true);
+    inttempBurstRunPrint("adapt -s", &result);
+
+    /* Noise of one result, in results: 16 conversions and quantization */
+    expected = sqrt(INTTEMPBURSTRUN_OVS * (sigmas[s] * sigmas[s] + 1.0 / 12));
+    noise = adaptive.sumNoise / INTTEMPBURSTRUN_READINGS;
+    printf("  noise estimate %.2f, modelled %.2f results\n", noise, expected);
+
+    if (fabs(noise - expected) > 0.25 * expected)
+    {
+      printf("  FAIL: noise estimate\n");
+      failed = 1;
+    }
+    if ((length < INTTEMPBURST_MAX_LENGTH) &&
+        (rms > INTTEMPBURSTRUN_TARGET_MARGIN * target))
+    {
+      printf("  FAIL: target standard error not reached\n");
+      failed = 1;
+    }
+    if (inttempBurstRunEnergy(length) > fixedEnergy)
+    {
+      printf("  FAIL: energy above fixed burst of %u\n",
+             fixed[sizeof(fixed) / sizeof(fixed[0]) - 1]);
+      failed = 1;
+    }
+    if (result.gross > INTTEMPBURSTRUN_GROSS_MAX)
+    {
+      printf("  FAIL: disturbed results not rejected\n");
+      failed = 1;
+    }
+  }
+
+  printf("\n%s\n", failed ? "FAILED" : "passed");
+  return failed;
+}
@@ -0,0 +1,77 @@
+/**************************************************************************//**
+ * @file
+ * @brief Former float conversion of internal temperature sensor samples
+ * @author Energy Micro AS
+ * @version 3.20.0
+ ******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 Energy Micro AS, http://www.energymicro.com</b>
+ *******************************************************************************
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ * 4. The source and compiled code may only be used on Energy Micro "EFM32"
+ *    microcontrollers and "EFR4" radios.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: Energy Micro AS has no
+ * obligation to support this Software. Energy Micro AS is providing the
+ * Software "AS IS", with no express or implied warranties of any kind,
+ * including, but not limited to, any implied warranties of merchantability
+ * or fitness for any particular purpose or warranties against infringement
+ * of any proprietary rights of a third party.
+ *
+ * Energy Micro AS will not be liable for any consequential, incidental, or
+ * special damages, or any other relief, or for any claim by any third party,
+ * arising from your use of this Software.
+ *
+ *****************************************************************************/
+#ifndef __INTTEMPFLOAT_H
+#define __INTTEMPFLOAT_H
+
+#include <stdint.h>
+
+/*
+   Former float conversion of inttemp.c, with the factory calibration as
+   parameters instead of read from DEVINFO. Reference for inttemprun.c and
+   inttempsize.c.
+*/
+
+/***************************************************************************//**
+ * @brief Former float conversion to Celsius.
+ ******************************************************************************/
+static float convertToCelsius(uint32_t adcSample, uint32_t calTemp, uint32_t calValue)
+{
+  float temp;
+  float cal_temp_0 = (float)calTemp;
+  float cal_value_0 = (float)calValue;
+
+  /* Temperature gradient (from datasheet) */
+  float t_grad = -6.27;
+
+  temp = (cal_temp_0 - ((cal_value_0 - adcSample)  / t_grad));
+
+  return temp;
+}
+
+/***************************************************************************//**
+ * @brief Former float conversion to Fahrenheit.
+ ******************************************************************************/
+static float convertToFahrenheit(uint32_t adcSample, uint32_t calTemp, uint32_t calValue)
+{
+  float celsius;
+  float fahrenheit;
+  celsius = convertToCelsius(adcSample, calTemp, calValue);
+
+  fahrenheit =  (celsius * (9.0/5.0)) + 32.0;
+
+  return fahrenheit;
+}
+
+#endif
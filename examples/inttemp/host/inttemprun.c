@@ -0,0 +1,239 @@
+/**************************************************************************//**
+ * @file
+ * @brief Host runner for internal temperature sensor conversion
+ * @author Energy Micro AS
+ * @version 3.20.0
+ ******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 Energy Micro AS, http://www.energymicro.com</b>
+ *******************************************************************************
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ * 4. The source and compiled code may only be used on Energy Micro "EFM32"
+ *    microcontrollers and "EFR4" radios.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: Energy Micro AS has no
+ * obligation to support this Software. Energy Micro AS is providing the
+ * Software "AS IS", with no express or implied warranties of any kind,
+ * including, but not limited to, any implied warranties of merchantability
+ * or fitness for any particular purpose or warranties against infringement
+ * of any proprietary rights of a third party.
+ *
+ * Energy Micro AS will not be liable for any consequential, incidental, or
+ * special damages, or any other relief, or for any claim by any third party,
+ * arising from your use of this Software.
+ *
+ *****************************************************************************/
+
+/*
+   Host runner for the internal temperature sensor conversion
+   (inttempconv.c).
+
+   For each factory calibration in a sweep, all 4096 ADC codes are
+   converted with INTTEMPCONV and with the former float conversion of
+   inttemp.c (inttempfloat.h), and both are compared with the exact
+   value computed in double. The fixed point results, rounded to 1/10
+   degree, must be within INTTEMPRUN_MAX_ERR_C and INTTEMPRUN_MAX_ERR_F
+   tenths of the exact value. The number of displayed values that change
+   is also shown: the former code truncated towards zero, and computed
+   Fahrenheit from the float Celsius value.
+
+   Time per display update (Celsius and Fahrenheit of one sample, as in the
+   main loop of inttemp.c) is measured on the host for both. The host has
+   an FPU, so this understates the gain on the Cortex-M3, where each float
+   operation is a library call; see "make size" for code size on target.
+
+   Usage: inttemprun
+*/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <math.h>
+#include <time.h>
+#include "inttempconv.h"
+#include "inttempfloat.h"
+
+/*
+ * Max errors, tenths: 0.5 from rounding to 1/10 degree, plus rounding of
+ * the 1/100 degree Celsius conversion (0.05 C, 0.09 F) and factor error.
+ */
+
+/** Max error of 1/10 degree Celsius result, tenths. */
+#define INTTEMPRUN_MAX_ERR_C    0.56
+/** Max error of 1/10 degree Fahrenheit result, tenths. */
+#define INTTEMPRUN_MAX_ERR_F    0.6
+
+/** Result of sweep. */
+typedef struct
+{
+  double        errC;
+  double        errF;
+  double        floatErrC;
+  double        floatErrF;
+  unsigned long conversions;
+  unsigned long changedC;
+  unsigned long changedF;
+} Sweep_TypeDef;
+
+/***************************************************************************//**
+ * @brief Convert all samples with one calibration, accumulate errors.
+ ******************************************************************************/
+static void sweepCal(Sweep_TypeDef *sweep, uint32_t calTemp, uint32_t calValue)
+{
+  INTTEMPCONV_Cal_TypeDef cal;
+  uint32_t                sample;
+  int32_t                 centi;
+  double                  exactC;
+  double                  exactF;
+  double                  err;
+
+  INTTEMPCONV_init(&cal, calTemp, calValue);
+
+  for (sample = 0; sample < 4096; sample++)
+  {
+    exactC = calTemp + ((double)calValue - sample) / 6.27;
+    exactF = exactC * 9.0 / 5.0 + 32.0;
+
+    centi = INTTEMPCONV_centiCelsius(&cal, sample);
+
+    err = fabs(INTTEMPCONV_deciCelsius(centi) - exactC * 10);
+    if (err > sweep->errC)
+    {
+      sweep->errC = err;
+    }
+    err = fabs(INTTEMPCONV_deciFahrenheit(centi) - exactF * 10);
+    if (err > sweep->errF)
+    {
+      sweep->errF = err;
+    }
+
+    err = fabs(convertToCelsius(sample, calTemp, calValue) - exactC) * 10;
+    if (err > sweep->floatErrC)
+    {
+      sweep->floatErrC = err;
+    }
+    err = fabs(convertToFahrenheit(sample, calTemp, calValue) - exactF) * 10;
+    if (err > sweep->floatErrF)
+    {
+      sweep->floatErrF = err;
+    }
+
+    /* Displayed values, former code truncated */
+    if (INTTEMPCONV_deciCelsius(centi) !=
+        (int)(convertToCelsius(sample, calTemp, calValue) * 10))
+    {
+      sweep->changedC++;
+    }
+    if (INTTEMPCONV_deciFahrenheit(centi) !=
+        (int)(convertToFahrenheit(sample, calTemp, calValue) * 10))
+    {
+      sweep->changedF++;
+    }
+    sweep->conversions++;
+  }
+}
+
+/***************************************************************************//**
+ * @brief Seconds since arbitrary start.
+ ******************************************************************************/
+static double now(void)
+{
+  struct timespec t;
+
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return t.tv_sec + t.tv_nsec * 1e-9;
+}
+
+/***************************************************************************//**
+ * @brief Main function.
+ ******************************************************************************/
+int main(void)
+{
+  Sweep_TypeDef           sweep = { 0, 0, 0, 0, 0, 0, 0 };
+  INTTEMPCONV_Cal_TypeDef cal;
+  volatile int32_t        sink;
+  volatile uint32_t       calTemp  = 25;
+  volatile uint32_t       calValue = 1950;
+  uint32_t                t;
+  uint32_t                v;
+  uint32_t                sample;
+  unsigned long           runs;
+  int32_t                 centi;
+  double                  start;
+  double                  fixedTime;
+  double                  floatTime;
+  int                     failed;
+
+  /* Calibration temperatures around room temperature, all values, and */
+  /* full 8 bit range of temperature for coarse steps of value */
+  for (t = 15; t <= 35; t++)
+  {
+    for (v = 0; v < 4096; v += 3)
+    {
+      sweepCal(&sweep, t, v);
+    }
+  }
+  for (t = 0; t < 256; t++)
+  {
+    for (v = 0; v < 4096; v += 97)
+    {
+      sweepCal(&sweep, t, v);
+    }
+  }
+
+  failed = (sweep.errC > INTTEMPRUN_MAX_ERR_C) || (sweep.errF > INTTEMPRUN_MAX_ERR_F);
+
+  printf("%lu conversions, max error in 1/10 degrees against exact value:\n",
+         sweep.conversions);
+  printf("  fixed point: %.3f C, %.3f F (limits %.2f, %.2f)\n",
+         sweep.errC, sweep.errF, INTTEMPRUN_MAX_ERR_C, INTTEMPRUN_MAX_ERR_F);
+  printf("  float:       %.3f C, %.3f F, before truncation\n",
+         sweep.floatErrC, sweep.floatErrF);
+  printf("  displayed value changed from former truncation: %.1f%% C, %.1f%% F\n",
+         100.0 * sweep.changedC / sweep.conversions,
+         100.0 * sweep.changedF / sweep.conversions);
+
+  /* Time per display update, Celsius and Fahrenheit of one sample */
+  runs = 0;
+  start = now();
+  do
+  {
+    INTTEMPCONV_init(&cal, calTemp, calValue);
+    for (sample = 0; sample < 4096; sample++)
+    {
+      centi = INTTEMPCONV_centiCelsius(&cal, sample);
+      sink  = INTTEMPCONV_deciCelsius(centi);
+      sink  = INTTEMPCONV_deciFahrenheit(centi);
+    }
+    runs += 4096;
+  } while ((fixedTime = now() - start) < 0.5);
+  fixedTime /= runs;
+
+  runs = 0;
+  start = now();
+  do
+  {
+    for (sample = 0; sample < 4096; sample++)
+    {
+      sink = (int)(convertToCelsius(sample, calTemp, calValue) * 10);
+      sink = (int)(convertToFahrenheit(sample, calTemp, calValue) * 10);
+    }
+    runs += 4096;
+  } while ((floatTime = now() - start) < 0.5);
+  floatTime /= runs;
+  (void)sink;
+
+  printf("host time per update: fixed point %.1f ns, float %.1f ns\n",
+         fixedTime * 1e9, floatTime * 1e9);
+
+  printf("%s\n", failed ? "FAILED" : "passed");
+  return failed;
+}
@@ -0,0 +1,75 @@
+/**************************************************************************//**
+ * @file
+ * @brief Code size comparison of temperature conversions
+ * @author Energy Micro AS
+ * @version 3.20.0
+ ******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 Energy Micro AS, http://www.energymicro.com</b>
+ *******************************************************************************
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ * 4. The source and compiled code may only be used on Energy Micro "EFM32"
+ *    microcontrollers and "EFR4" radios.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: Energy Micro AS has no
+ * obligation to support this Software. Energy Micro AS is providing the
+ * Software "AS IS", with no express or implied warranties of any kind,
+ * including, but not limited to, any implied warranties of merchantability
+ * or fitness for any particular purpose or warranties against infringement
+ * of any proprietary rights of a third party.
+ *
+ * Energy Micro AS will not be liable for any consequential, incidental, or
+ * special damages, or any other relief, or for any claim by any third party,
+ * arising from your use of this Software.
+ *
+ *****************************************************************************/
+
+/*
+   Minimal program converting one sample for display, as the main loop of
+   inttemp.c, with either the former float conversion (INTTEMPSIZE_FLOAT
+   defined) or inttempconv.c. Built for Cortex-M3 by "make size" to compare
+   code size, including the soft-float library functions pulled in.
+*/
+
+#include <stdint.h>
+#if defined(INTTEMPSIZE_FLOAT)
+#include "inttempfloat.h"
+#else
+#include "inttempconv.h"
+#endif
+
+/** Inputs and outputs, volatile to keep conversion. */
+volatile uint32_t sizeSample;
+volatile uint32_t sizeCalTemp;
+volatile uint32_t sizeCalValue;
+volatile int32_t  sizeDeciCelsius;
+volatile int32_t  sizeDeciFahrenheit;
+
+/***************************************************************************//**
+ * @brief Main function.
+ ******************************************************************************/
+int main(void)
+{
+#if defined(INTTEMPSIZE_FLOAT)
+  sizeDeciFahrenheit = (int)(convertToFahrenheit(sizeSample, sizeCalTemp, sizeCalValue) * 10);
+  sizeDeciCelsius    = (int)(convertToCelsius(sizeSample, sizeCalTemp, sizeCalValue) * 10);
+#else
+  INTTEMPCONV_Cal_TypeDef cal;
+  int32_t                 centi;
+
+  INTTEMPCONV_init(&cal, sizeCalTemp, sizeCalValue);
+  centi              = INTTEMPCONV_centiCelsius(&cal, sizeSample);
+  sizeDeciCelsius    = INTTEMPCONV_deciCelsius(centi);
+  sizeDeciFahrenheit = INTTEMPCONV_deciFahrenheit(centi);
+#endif
+  return 0;
+}
@@ -9,6 +9,8 @@
  *
  * @par Usage
  * @li Joystick Push toggles Celsius/Fahrenheit display mode.
+ * @li Joystick Up/Down cycles between current temperature, and lowest (L),
+ *     highest (H) and average (A) temperature of the last 24 hours.
  *
  * @author Energy Micro AS
  * @version 3.20.0
@@ -47,144 +49,294 @@
 #include "em_device.h"
 #include "em_chip.h"
 #include "em_emu.h"
-#include "em_gpio.h"
 #include "em_adc.h"
 #include "em_cmu.h"
+#include "em_dma.h"
+#include "em_int.h"
 #include "bsp.h"
 #include "bsp_trace.h"
 #include "segmentlcd.h"
 #include "rtcdrv.h"
-
-/** Interrupt pin used to detect joystick activity */
-#define GPIO_INT_PIN 14
+#include "dmactrl.h"
+#include "inttempconv.h"
+#include "inttempburst.h"
+#include "templog.h"
+#include "templogfile.h"
+#include "keyinput.h"
+#include "ff.h"
+#include "microsd.h"
+
+/*
+   Each reading is a burst of temperature sensor samples. ADC0 converts
+   repeatedly with 16 times hardware oversampling, giving 4 fraction bits
+   per result, and the DMA moves tempBurst.length results to tempSamples
+   while the core sleeps in EM1. The DMA interrupt stops the ADC at the end
+   of the burst. inttempburst.c reduces the burst to one reading, rejecting
+   disturbed results, and sets the length of the next burst from the noise
+   seen, so that quiet readings cost less energy. See host/inttempburstrun.c
+   for errors and energy per reading on synthetic data.
+*/
+
+/** DMA channel used for burst of temperature sensor samples */
+#define INTTEMP_DMA_CHANNEL 0
+
+/** Readings logged per day, one every 2 seconds */
+#define INTTEMP_LOG_DAY 43200
+
+/** File on microSD card keeping closed blocks of history */
+#define INTTEMP_LOG_FILE "INTTEMP.BIN"
 
 /** Flag used to indicate if displaying in Celsius or Fahrenheit */
 static int showFahrenheit;
 
+/** Display mode, 0 current, then lowest, highest and average of last day */
+static int showMode;
+
+/** Letter shown for display mode */
+static const char showModeLetter[] = " LHA";
+
+/** History of readings in 1/10 degree Celsius, the display resolution */
+static TEMPLOG_Log_TypeDef tempLog;
+
+/** File system on microSD card, and file the history is kept in */
+static FATFS tempFatfs;
+static TEMPLOGFILE_File_TypeDef tempLogFile;
+
+/** Conversion of sensor samples, from factory calibration */
+static INTTEMPCONV_Cal_TypeDef tempCal;
+
+/** Burst of oversampled sensor results, written by DMA */
+static uint16_t tempSamples[INTTEMPBURST_MAX_LENGTH];
+
+/** Burst reduction state, holding length of next burst */
+static INTTEMPBURST_State_TypeDef tempBurst;
+
+/** Callback config for DMA channel, must remain 'live' */
+static DMA_CB_TypeDef tempDMACb;
+
+/** Flag set by DMA callback when burst is complete */
+static volatile bool tempBurstDone;
+
+/** Flag set by RTC callback when next reading is due */
+static volatile bool tempReadDue;
+
+/** Length of latest burst, monitor with debugger */
+static uint32_t tempMonBurstLength;
+/** Noise of one result seen by latest burst, 1/16 results, monitor with debugger */
+static uint32_t tempMonNoise;
+
 /* Local Prototypes */
-void temperatureIRQInit(void);
+void temperatureTrigger(void);
+void temperatureKey(const KEYQ_Event_TypeDef *event);
+void temperatureDMACb(unsigned int channel, bool primary, void *user);
 void gpioSetup(void);
 void setupSensor(void);
-float convertToCelsius(uint32_t adcSample);
-float convertToFahrenheit(uint32_t adcSample);
+int32_t measureTemperature(void);
+void formatTemperature(char *string, int32_t deci, char unit, char mode);
+void temperatureLogError(void);
+DWORD get_fattime(void);
 
 /**************************************************************************//**
- * @brief GPIO Interrupt handler
- * This interrupt handler is not an example of good design, as it will do
- * a lot of operations inside the interrupt handler.
+ * @brief RTC callback, next reading due
  *****************************************************************************/
-void GPIO_EVEN_IRQHandler(void)
+void temperatureTrigger(void)
 {
-  uint16_t joystick;
+  tempReadDue = true;
+}
 
-  /* Clear interrupt */
-  BSP_InterruptFlagsClear(BC_INTEN_JOYSTICK);
-  GPIO_IntClear(1 << GPIO_INT_PIN);
 
-  /* LEDs on to indicate joystick used */
+/**************************************************************************//**
+ * @brief Handle joystick event
+ * @param[in] event Key event.
+ *****************************************************************************/
+void temperatureKey(const KEYQ_Event_TypeDef *event)
+{
+  /* LEDs on while joystick used */
+  if (event->type == keyqRelease)
+  {
+    BSP_LedsSet(0x0000);
+    return;
+  }
+  if (event->type != keyqPress)
+  {
+    return;
+  }
   BSP_LedsSet(0xffff);
 
-  /* Read and store joystick activity - wait for key release */
-  joystick = BSP_JoystickGet();
-  while (BSP_JoystickGet());
-
-  /* LEDs off to indicate joystick release */
-  BSP_LedsSet(0x0000);
-
   /* Push toggles celsius/fahrenheit */
-  if (joystick & BC_JOYSTICK_CENTER)
+  if (event->key & BC_JOYSTICK_CENTER)
   {
     showFahrenheit ^= 1;
   }
-}
-
-/**************************************************************************//**
- * @brief Initialize GPIO interrupt for joystick (ie FPGA signal)
- *****************************************************************************/
-void temperatureIRQInit(void)
-{
-  /* Configure interrupt pin as input with pull-up */
-  GPIO_PinModeSet(gpioPortC, GPIO_INT_PIN, gpioModeInputPull, 1);
 
-  /* Set falling edge interrupt and clear/enable it */
-  GPIO_IntConfig(gpioPortC, GPIO_INT_PIN, false, true, true);
-
-  NVIC_ClearPendingIRQ(GPIO_EVEN_IRQn);
-  NVIC_EnableIRQ(GPIO_EVEN_IRQn);
+  /* Up/down cycles display mode */
+  if (event->key & BC_JOYSTICK_UP)
+  {
+    showMode = (showMode + 1) % (sizeof(showModeLetter) - 1);
+  }
+  if (event->key & BC_JOYSTICK_DOWN)
+  {
+    showMode = (showMode + sizeof(showModeLetter) - 2) % (sizeof(showModeLetter) - 1);
+  }
 }
 
+
 /**************************************************************************//**
- * @brief ADC0 interrupt handler. Simply clears interrupt flag.
+ * @brief DMA callback at end of burst, stops repeated ADC conversions.
  *****************************************************************************/
-void ADC0_IRQHandler(void)
+void temperatureDMACb(unsigned int channel, bool primary, void *user)
 {
-  ADC_IntClear(ADC0, ADC_IF_SINGLE);
+  (void)channel; /* Unused parameter */
+  (void)primary; /* Unused parameter */
+  (void)user;    /* Unused parameter */
+
+  ADC0->CMD = ADC_CMD_SINGLESTOP;
+  tempBurstDone = true;
 }
 
 /**************************************************************************//**
- * @brief Initialize ADC for temperature sensor readings in single poin
+ * @brief Initialize ADC and DMA for bursts of temperature sensor readings
  *****************************************************************************/
 void setupSensor(void)
 {
   /* Base the ADC configuration on the default setup. */
   ADC_Init_TypeDef init = ADC_INIT_DEFAULT;
   ADC_InitSingle_TypeDef sInit = ADC_INITSINGLE_DEFAULT;
+  DMA_Init_TypeDef dmaInit;
+  DMA_CfgChannel_TypeDef chnlCfg;
+  DMA_CfgDescr_TypeDef descrCfg;
 
-  /* Initialize timebases */
+  /* Initialize timebases, 16 times oversampling */
   init.timebase = ADC_TimebaseCalc(0);
   init.prescale = ADC_PrescaleCalc(400000,0);
+  init.ovsRateSel = adcOvsRateSel16;
   ADC_Init(ADC0, &init);
 
   /* Set input to temperature sensor. Reference must be 1.25V */
+  /* Convert repeatedly until stopped at end of burst */
   sInit.reference = adcRef1V25;
   sInit.input = adcSingleInpTemp;
+  sInit.resolution = adcResOVS;
+  sInit.rep = true;
   ADC_InitSingle(ADC0, &sInit);
 
-  /* Setup interrupt generation on completed conversion. */
-  ADC_IntEnable(ADC0, ADC_IF_SINGLE);
-  NVIC_EnableIRQ(ADC0_IRQn);
+  /* Configure general DMA issues */
+  dmaInit.hprot = 0;
+  dmaInit.controlBlock = dmaControlBlock;
+  DMA_Init(&dmaInit);
+
+  /* Configure DMA channel moving single conversion results */
+  tempDMACb.cbFunc = temperatureDMACb;
+  tempDMACb.userPtr = NULL;
+
+  chnlCfg.highPri = false;
+  chnlCfg.enableInt = true;
+  chnlCfg.select = DMAREQ_ADC0_SINGLE;
+  chnlCfg.cb = &tempDMACb;
+  DMA_CfgChannel(INTTEMP_DMA_CHANNEL, &chnlCfg);
+
+  descrCfg.dstInc = dmaDataInc2;
+  descrCfg.srcInc = dmaDataIncNone;
+  descrCfg.size = dmaDataSize2;
+  descrCfg.arbRate = dmaArbitrate1;
+  descrCfg.hprot = 0;
+  DMA_CfgDescr(INTTEMP_DMA_CHANNEL, true, &descrCfg);
+
+  INTTEMPBURST_init(&tempBurst);
 }
 
 /**************************************************************************//**
- * @brief Convert ADC sample values to celsius.
- * @note See section 2.3.4 in the reference manual for details on this
- *       calculatoin
- * @param adcSample Raw value from ADC to be converted to celsius
- * @return The temperature in degrees Celsius.
+ * @brief Measure temperature with one burst of oversampled conversions
+ * @return Temperature in 1/100 degrees Celsius
  *****************************************************************************/
-float convertToCelsius(uint32_t adcSample)
+int32_t measureTemperature(void)
 {
-  float temp;
-  /* Factory calibration temperature from device information page. */
-  float cal_temp_0 = (float)((DEVINFO->CAL & _DEVINFO_CAL_TEMP_MASK)
-                            >> _DEVINFO_CAL_TEMP_SHIFT);
-
-  float cal_value_0 = (float)((DEVINFO->ADC0CAL2
-                            & _DEVINFO_ADC0CAL2_TEMP1V25_MASK)
-                            >> _DEVINFO_ADC0CAL2_TEMP1V25_SHIFT);
+  uint32_t length = tempBurst.length;
+  uint32_t temp;
 
-  /* Temperature gradient (from datasheet) */
-  float t_grad = -6.27;
+  /* Discard result left from previous burst, it would be moved at once */
+  ADC_DataSingleGet(ADC0);
+
+  tempBurstDone = false;
+  DMA_ActivateBasic(INTTEMP_DMA_CHANNEL,
+                    true,
+                    false,
+                    tempSamples,
+                    (void *)((uint32_t)&(ADC0->SINGLEDATA)),
+                    length - 1);
+  ADC_Start(ADC0, adcStartSingle);
+
+  /* Wait in EM1 for burst to complete. Interrupts are disabled while */
+  /* checking the flag, so that an interrupt in between still wakes up */
+  /* the core, it is serviced when interrupts are enabled again. */
+  INT_Disable();
+  while (!tempBurstDone)
+  {
+    EMU_EnterEM1();
+    INT_Enable();
+    INT_Disable();
+  }
+  INT_Enable();
 
-  temp = (cal_temp_0 - ((cal_value_0 - adcSample)  / t_grad));
+  temp = INTTEMPBURST_process(&tempBurst, tempSamples, length);
+  tempMonBurstLength = length;
+  tempMonNoise = tempBurst.noise;
 
-  return temp;
+  return INTTEMPCONV_centiCelsiusFrac(&tempCal, temp, INTTEMPBURST_FRAC_BITS);
 }
 
 /**************************************************************************//**
- * @brief Convert ADC sample values to fahrenheit
- * @param adcSample Raw value from ADC to be converted to fahrenheit
- * @return The temperature in degrees Fahrenheit
+ * @brief Format temperature for alphanumeric part of display
+ * @param string Buffer of 8 characters
+ * @param deci Temperature in 1/10 degrees
+ * @param unit 'C' or 'F'
+ * @param mode Display mode letter, shown instead of degree sign unless ' '
  *****************************************************************************/
-float convertToFahrenheit(uint32_t adcSample)
+void formatTemperature(char *string, int32_t deci, char unit, char mode)
 {
-  float celsius;
-  float fahrenheit;
-  celsius = convertToCelsius(adcSample);
+  if (mode != ' ')
+  {
+    /* Mode letter in front, no room for degree sign */
+    if (deci < 0)
+    {
+      snprintf(string, 8, "%c-%d,%1d%c", mode, (int)(-deci / 10), (int)(-deci % 10), unit);
+    }
+    else
+    {
+      snprintf(string, 8, "%c%d,%1d%c", mode, (int)(deci / 10), (int)(deci % 10), unit);
+    }
+  }
+  else if (deci < 0)
+  {
+    snprintf(string, 8, "-%d,%1d%%%c", (int)(-deci / 10), (int)(-deci % 10), unit);
+  }
+  else
+  {
+    snprintf(string, 8, "%2d,%1d%%%c", (int)(deci / 10), (int)(deci % 10), unit);
+  }
+}
 
-  fahrenheit =  (celsius * (9.0/5.0)) + 32.0;
+/**************************************************************************//**
+ * @brief Show that history is no longer kept on microSD card, for 2 seconds
+ *****************************************************************************/
+void temperatureLogError(void)
+{
+  SegmentLCD_Write("SD ERR");
+  RTCDRV_Trigger(2000, NULL);
+  EMU_EnterEM2(true);
+}
 
-  return fahrenheit;
+/**************************************************************************//**
+ * @brief
+ *   This function is required by the FAT file system in order to provide
+ *   timestamps for created files. Since we do not have a reliable clock we
+ *   hardcode a value here.
+ * @return
+ *    A DWORD containing the current time and date as a packed datastructure.
+ *****************************************************************************/
+DWORD get_fattime(void)
+{
+  return (28 << 25) | (2 << 21) | ( 1 << 16);
 }
 
 /**************************************************************************//**
@@ -194,8 +346,14 @@ int main(void)
 {
   SYSTEM_ChipRevision_TypeDef revision;
   char string[8];
-  int i;
-  uint32_t temp;
+  int32_t measured = 0;
+  int32_t centi;
+  int32_t celsius;
+  int32_t fahrenheit;
+  int16_t stat;
+  TEMPLOG_Stats_TypeDef stats;
+  KEYQ_Event_TypeDef event;
+  FRESULT res;
 
   /* Chip revision alignment and errata fixes */
   CHIP_Init();
@@ -208,6 +366,7 @@ int main(void)
 
   CMU_ClockEnable(cmuClock_HFPER, true);
   CMU_ClockEnable(cmuClock_ADC0, true);
+  CMU_ClockEnable(cmuClock_DMA, true);
   CMU_ClockEnable(cmuClock_GPIO, true);
 
   /* Initialize LCD controller without boost */
@@ -232,52 +391,120 @@ int main(void)
     EMU_EnterEM2(true);
   }
 
-  /* Enable board control interrupts */
-  BSP_InterruptDisable(0xffff);
-  BSP_InterruptFlagsClear(0xffff);
-  BSP_InterruptEnable(BC_INTEN_JOYSTICK);
-  temperatureIRQInit();
+  /* Joystick events */
+  KEYINPUT_init(BC_INTEN_JOYSTICK);
 
-  /* Setup ADC for sampling internal temperature sensor. */
+  /* Setup ADC and DMA for sampling internal temperature sensor. */
   setupSensor();
 
-  /* Main loop - just read temperature and update LCD */
+  /* Load factory calibration once, see section 2.3.4 in the reference */
+  /* manual for details on this calculation */
+  INTTEMPCONV_init(&tempCal,
+                   (DEVINFO->CAL & _DEVINFO_CAL_TEMP_MASK)
+                   >> _DEVINFO_CAL_TEMP_SHIFT,
+                   (DEVINFO->ADC0CAL2 & _DEVINFO_ADC0CAL2_TEMP1V25_MASK)
+                   >> _DEVINFO_ADC0CAL2_TEMP1V25_SHIFT);
+
+  /* Enable SPI access to MicroSD card */
+  BSP_RegisterWrite(BC_SPI_CFG, BC_SPI_CFG_MICROSD);
+  BSP_PeripheralAccess(BSP_SPI, true);
+  MICROSD_Init();
+
+  /* Closed blocks of history are appended to a file on the microSD card, */
+  /* and restored from it after reset. Without card the history is kept */
+  /* in RAM only. */
+  TEMPLOG_init(&tempLog, TEMPLOGFILE_flush, &tempLogFile);
+  res = f_mount(0, &tempFatfs);
+  if (res == FR_OK)
+  {
+    res = TEMPLOGFILE_open(&tempLogFile, INTTEMP_LOG_FILE, &tempLog);
+  }
+  if (res != FR_OK)
+  {
+    tempLogFile.status = res;
+    temperatureLogError();
+  }
+  tempReadDue = true;
+
+  /* Main loop - read temperature when due, handle joystick and update LCD */
   while (1)
   {
-    /* Start one ADC sample */
-    ADC_Start(ADC0, adcStartSingle);
+    if (tempReadDue)
+    {
+      tempReadDue = false;
+
+      /* Measure once, Fahrenheit / Celsius derived from it */
+      measured = measureTemperature();
+
+      /* Log reading, at most one day is queried */
+      res = tempLogFile.status;
+      TEMPLOG_append(&tempLog, (int16_t)INTTEMPCONV_deciCelsius(measured));
+      if ((res == FR_OK) && (tempLogFile.status != FR_OK))
+      {
+        /* Writing closed block failed */
+        temperatureLogError();
+      }
+
+      /* Next reading in 2 seconds */
+      RTCDRV_Trigger(2000, temperatureTrigger);
+    }
 
-    /* Wait in EM1 for ADC to complete */
-    EMU_EnterEM1();
+    while (KEYINPUT_get(&event))
+    {
+      temperatureKey(&event);
+    }
+    centi = measured;
+
+    /* Lowest, highest or average of last day replaces current reading */
+    if (showMode &&
+        TEMPLOG_query(&tempLog,
+                      (tempLog.next > INTTEMP_LOG_DAY) ? tempLog.next - INTTEMP_LOG_DAY : 0,
+                      tempLog.next,
+                      &stats))
+    {
+      if (showMode == 1)
+      {
+        stat = stats.min;
+      }
+      else if (showMode == 2)
+      {
+        stat = stats.max;
+      }
+      else
+      {
+        stat = TEMPLOG_average(&stats);
+      }
+      centi = stat * 10;
+    }
 
-    /* Read sensor value */
-    temp = ADC_DataSingleGet(ADC0);
+    celsius = INTTEMPCONV_deciCelsius(centi);
+    fahrenheit = INTTEMPCONV_deciFahrenheit(centi);
 
-    /* Convert ADC sample to Fahrenheit / Celsius and print string to display */
+    /* Print string to display */
     if (showFahrenheit)
     {
       /* Show Fahrenheit on alphanumeric part of display */
-      i = (int)(convertToFahrenheit(temp) * 10);
-      snprintf(string, 8, "%2d,%1d%%F", (i/10), i%10);
+      formatTemperature(string, fahrenheit, 'F', showModeLetter[showMode]);
       /* Show Celsius on numeric part of display */
-      i = (int)(convertToCelsius(temp) * 10);
-      SegmentLCD_Number(i*10);
+      SegmentLCD_Number(celsius*10);
       SegmentLCD_Symbol(LCD_SYMBOL_DP10, 1);
-   }
+    }
     else
     {
       /* Show Celsius on alphanumeric part of display */
-      i = (int)(convertToCelsius(temp) * 10);
-      snprintf(string, 8, "%2d,%1d%%C", (i/10), i%10);
+      formatTemperature(string, celsius, 'C', showModeLetter[showMode]);
       /* Show Fahrenheit on numeric part of display */
-      i = (int)(convertToFahrenheit(temp) * 10);
-      SegmentLCD_Number(i*10);
+      SegmentLCD_Number(fahrenheit*10);
       SegmentLCD_Symbol(LCD_SYMBOL_DP10, 1);
     }
     SegmentLCD_Write(string);
 
-    /* Sleep for 2 seconds in EM 2 */
-    RTCDRV_Trigger(2000, NULL);
-    EMU_EnterEM2(true);
+    /* Sleep in EM 2 until reading due or key event */
+    INT_Disable();
+    if (!tempReadDue && !KEYINPUT_pending())
+    {
+      EMU_EnterEM2(true);
+    }
+    INT_Enable();
   }
 }
@@ -0,0 +1,154 @@
+/**************************************************************************//**
+ * @file
+ * @brief Internal temperature sensor burst reduction
+ * @author Energy Micro AS
+ * @version 3.20.0
+ ******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 Energy Micro AS, http://www.energymicro.com</b>
+ *******************************************************************************
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ * 4. The source and compiled code may only be used on Energy Micro "EFM32"
+ *    microcontrollers and "EFR4" radios.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: Energy Micro AS has no
+ * obligation to support this Software. Energy Micro AS is providing the
+ * Software "AS IS", with no express or implied warranties of any kind,
+ * including, but not limited to, any implied warranties of merchantability
+ * or fitness for any particular purpose or warranties against infringement
+ * of any proprietary rights of a third party.
+ *
+ * Energy Micro AS will not be liable for any consequential, incidental, or
+ * special damages, or any other relief, or for any claim by any third party,
+ * arising from your use of this Software.
+ *
+ *****************************************************************************/
+#include "inttempburst.h"
+
+/**
+ * Variance of interquartile mean relative to mean of a normal distribution,
+ * 1/256 units (appr. 1.2).
+ */
+#define INTTEMPBURST_IQM_VARIANCE   306
+
+/**
+ * Standard deviation of normal distribution per range between the sorted
+ * results at count / 4 from either end, 1/256 units, for counts of
+ * INTTEMPBURST_MIN_LENGTH to INTTEMPBURST_MAX_LENGTH in steps of 4. Short
+ * bursts put these results well inside the quartiles, the factor is from
+ * their expected quantiles (Blom), tending to 190 for long bursts.
+ */
+static const uint16_t INTTEMPBURST_sigmaPerRange[] =
+{
+  271, 239, 225, 217, 212, 209, 206, 204, 203, 202, 201, 200, 199, 198, 198
+};
+
+/** Noise assumed before first burst, 1/16 results. */
+#define INTTEMPBURST_INITIAL_NOISE  (8 << 4)
+
+/***************************************************************************//**
+ * @brief
+ *   Sort samples in ascending order. Insertion sort, bursts are short.
+ ******************************************************************************/
+static void INTTEMPBURST_sort(uint16_t *samples, unsigned int count)
+{
+  unsigned int i;
+  unsigned int j;
+  uint16_t     v;
+
+  for (i = 1; i < count; i++)
+  {
+    v = samples[i];
+    for (j = i; (j > 0) && (samples[j - 1] > v); j--)
+    {
+      samples[j] = samples[j - 1];
+    }
+    samples[j] = v;
+  }
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Initialize burst reduction state.
+ *
+ * @param[out] state
+ *   State to initialize.
+ ******************************************************************************/
+void INTTEMPBURST_init(INTTEMPBURST_State_TypeDef *state)
+{
+  state->noise  = INTTEMPBURST_INITIAL_NOISE;
+  state->length = INTTEMPBURST_MAX_LENGTH;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Reduce burst to one reading, and set length of next burst from the
+ *   noise seen.
+ *
+ * @param[in] state
+ *   Burst reduction state.
+ *
+ * @param[in,out] samples
+ *   Oversampled results of burst, sorted on return.
+ *
+ * @param[in] count
+ *   Number of results, INTTEMPBURST_MIN_LENGTH to INTTEMPBURST_MAX_LENGTH
+ *   in steps of 4, as set in state->length.
+ *
+ * @return
+ *   Interquartile mean of burst, INTTEMPBURST_FRAC_BITS fraction bits.
+ ******************************************************************************/
+uint32_t INTTEMPBURST_process(INTTEMPBURST_State_TypeDef *state,
+                              uint16_t *samples,
+                              unsigned int count)
+{
+  unsigned int quarter = count / 4;
+  unsigned int middle  = count - 2 * quarter;
+  unsigned int i;
+  uint32_t     sum = 0;
+  uint32_t     noise;
+  uint32_t     length;
+
+  INTTEMPBURST_sort(samples, count);
+
+  for (i = quarter; i < quarter + middle; i++)
+  {
+    sum += samples[i];
+  }
+
+  /* Noise of one result from range of middle half, smoothed over bursts */
+  noise = ((uint32_t)(samples[count - 1 - quarter] - samples[quarter]) *
+           INTTEMPBURST_sigmaPerRange[(count - INTTEMPBURST_MIN_LENGTH) / 4]) >> 4;
+  state->noise = (3 * state->noise + noise + 2) / 4;
+
+  /* Length giving target standard error: IQM variance * noise^2 / target^2,
+     noise limited to keep the product within 32 bits */
+  noise = state->noise;
+  if (noise > 0x3fff)
+  {
+    noise = 0x3fff;
+  }
+  length = ((((noise * noise) >> 8) * INTTEMPBURST_IQM_VARIANCE) >> 8) /
+           (INTTEMPBURST_TARGET * INTTEMPBURST_TARGET);
+  length = (length + 3) & ~3UL;
+  if (length < INTTEMPBURST_MIN_LENGTH)
+  {
+    length = INTTEMPBURST_MIN_LENGTH;
+  }
+  else if (length > INTTEMPBURST_MAX_LENGTH)
+  {
+    length = INTTEMPBURST_MAX_LENGTH;
+  }
+  state->length = length;
+
+  return (sum + middle / 2) / middle;
+}
@@ -0,0 +1,91 @@
+/**************************************************************************//**
+ * @file
+ * @brief Internal temperature sensor burst reduction
+ * @author Energy Micro AS
+ * @version 3.20.0
+ ******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 Energy Micro AS, http://www.energymicro.com</b>
+ *******************************************************************************
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ * 4. The source and compiled code may only be used on Energy Micro "EFM32"
+ *    microcontrollers and "EFR4" radios.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: Energy Micro AS has no
+ * obligation to support this Software. Energy Micro AS is providing the
+ * Software "AS IS", with no express or implied warranties of any kind,
+ * including, but not limited to, any implied warranties of merchantability
+ * or fitness for any particular purpose or warranties against infringement
+ * of any proprietary rights of a third party.
+ *
+ * Energy Micro AS will not be liable for any consequential, incidental, or
+ * special damages, or any other relief, or for any claim by any third party,
+ * arising from your use of this Software.
+ *
+ *****************************************************************************/
+#ifndef __INTTEMPBURST_H
+#define __INTTEMPBURST_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+   Reduction of bursts of internal temperature sensor samples, kept free of
+   hardware references so that it can be verified off target.
+
+   A burst holds count oversampled ADC results with INTTEMPBURST_FRAC_BITS
+   fraction bits, as written by DMA from ADC0 SINGLEDATA with 16 times
+   hardware oversampling. The burst is sorted, and the mean of its middle
+   half (interquartile mean) is the reading, so single disturbed results
+   do not move it. The spread of the middle half gives the noise of one result,
+   smoothed over bursts, and the length of the next burst is the one that
+   gives INTTEMPBURST_TARGET standard error of the reading at that noise.
+   Quiet readings thus take short bursts, costing less energy, and noisy
+   readings take longer bursts up to INTTEMPBURST_MAX_LENGTH.
+*/
+
+/** Fraction bits of results, 12 bit ADC with 16 times oversampling. */
+#define INTTEMPBURST_FRAC_BITS    4
+
+/** Shortest burst, multiple of 4. */
+#define INTTEMPBURST_MIN_LENGTH   8
+/** Longest burst, multiple of 4. */
+#define INTTEMPBURST_MAX_LENGTH   64
+
+/**
+ * Target standard error of reading, in results (1/16 ADC codes). 2 is
+ * 1/8 code, 0.02 degrees Celsius at 6.27 codes per degree.
+ */
+#define INTTEMPBURST_TARGET       2
+
+/** Burst reduction state. */
+typedef struct
+{
+  /** Length of next burst. */
+  unsigned int length;
+  /** Smoothed noise (standard deviation) of one result, 1/16 results. */
+  uint32_t     noise;
+} INTTEMPBURST_State_TypeDef;
+
+void INTTEMPBURST_init(INTTEMPBURST_State_TypeDef *state);
+uint32_t INTTEMPBURST_process(INTTEMPBURST_State_TypeDef *state,
+                              uint16_t *samples,
+                              unsigned int count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
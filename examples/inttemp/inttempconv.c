@@ -0,0 +1,146 @@
+/**************************************************************************//**
+ * @file
+ * @brief Internal temperature sensor conversion
+ * @author Energy Micro AS
+ * @version 3.20.0
+ ******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 Energy Micro AS, http://www.energymicro.com</b>
+ *******************************************************************************
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ * 4. The source and compiled code may only be used on Energy Micro "EFM32"
+ *    microcontrollers and "EFR4" radios.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: Energy Micro AS has no
+ * obligation to support this Software. Energy Micro AS is providing the
+ * Software "AS IS", with no express or implied warranties of any kind,
+ * including, but not limited to, any implied warranties of merchantability
+ * or fitness for any particular purpose or warranties against infringement
+ * of any proprietary rights of a third party.
+ *
+ * Energy Micro AS will not be liable for any consequential, incidental, or
+ * special damages, or any other relief, or for any claim by any third party,
+ * arising from your use of this Software.
+ *
+ *****************************************************************************/
+#include "inttempconv.h"
+
+/***************************************************************************//**
+ * @brief
+ *   Divide, rounding to nearest, halves away from zero.
+ ******************************************************************************/
+static int32_t INTTEMPCONV_divRound(int32_t num, int32_t den)
+{
+  if (num < 0)
+  {
+    return -((-num + den / 2) / den);
+  }
+  return (num + den / 2) / den;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Set up conversion from factory calibration.
+ *
+ * @param[out] cal
+ *   Conversion calibration.
+ *
+ * @param[in] calTemp
+ *   Calibration temperature, degrees Celsius (DEVINFO CAL TEMP).
+ *
+ * @param[in] calValue
+ *   Sensor reading at calibration temperature, 1.25 V reference
+ *   (DEVINFO ADC0CAL2 TEMP1V25).
+ ******************************************************************************/
+void INTTEMPCONV_init(INTTEMPCONV_Cal_TypeDef *cal,
+                      uint32_t calTemp,
+                      uint32_t calValue)
+{
+  /* Half unit added for rounding of conversion result */
+  cal->offset = (int32_t)((calTemp * 100) << INTTEMPCONV_SHIFT) +
+                (int32_t)calValue * INTTEMPCONV_FACTOR +
+                (1 << (INTTEMPCONV_SHIFT - 1));
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Convert temperature sensor sample.
+ *
+ * @param[in] cal
+ *   Conversion calibration.
+ *
+ * @param[in] sample
+ *   12 bit ADC sample.
+ *
+ * @return
+ *   Temperature in 1/100 degrees Celsius.
+ ******************************************************************************/
+int32_t INTTEMPCONV_centiCelsius(const INTTEMPCONV_Cal_TypeDef *cal,
+                                 uint32_t sample)
+{
+  /* Arithmetic shift, rounds towards minus infinity below 0 degrees */
+  return (cal->offset - (int32_t)sample * INTTEMPCONV_FACTOR) >> INTTEMPCONV_SHIFT;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Convert temperature sensor sample with fraction bits.
+ *
+ * @param[in] cal
+ *   Conversion calibration.
+ *
+ * @param[in] sample
+ *   12 bit ADC sample with fracBits fraction bits.
+ *
+ * @param[in] fracBits
+ *   Fraction bits of sample, at most 15.
+ *
+ * @return
+ *   Temperature in 1/100 degrees Celsius.
+ ******************************************************************************/
+int32_t INTTEMPCONV_centiCelsiusFrac(const INTTEMPCONV_Cal_TypeDef *cal,
+                                     uint32_t sample,
+                                     unsigned int fracBits)
+{
+  uint32_t whole = sample >> fracBits;
+  uint32_t frac  = sample & ((1UL << fracBits) - 1);
+
+  /* Whole and fraction part multiplied separately to stay within 32 bits */
+  return (cal->offset -
+          (int32_t)whole * INTTEMPCONV_FACTOR -
+          (int32_t)((frac * INTTEMPCONV_FACTOR) >> fracBits)) >> INTTEMPCONV_SHIFT;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Temperature in 1/10 degrees Celsius.
+ *
+ * @param[in] centiCelsius
+ *   Temperature in 1/100 degrees Celsius.
+ ******************************************************************************/
+int32_t INTTEMPCONV_deciCelsius(int32_t centiCelsius)
+{
+  return INTTEMPCONV_divRound(centiCelsius, 10);
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Temperature in 1/10 degrees Fahrenheit.
+ *
+ * @param[in] centiCelsius
+ *   Temperature in 1/100 degrees Celsius.
+ ******************************************************************************/
+int32_t INTTEMPCONV_deciFahrenheit(int32_t centiCelsius)
+{
+  /* F = C * 9/5 + 32, 1/100 degrees C to 1/10 degrees F */
+  return INTTEMPCONV_divRound(centiCelsius * 9 + 16000, 50);
+}
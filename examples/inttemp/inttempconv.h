@@ -0,0 +1,98 @@
+/**************************************************************************//**
+ * @file
+ * @brief Internal temperature sensor conversion
+ * @author Energy Micro AS
+ * @version 3.20.0
+ ******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 Energy Micro AS, http://www.energymicro.com</b>
+ *******************************************************************************
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ * 4. The source and compiled code may only be used on Energy Micro "EFM32"
+ *    microcontrollers and "EFR4" radios.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: Energy Micro AS has no
+ * obligation to support this Software. Energy Micro AS is providing the
+ * Software "AS IS", with no express or implied warranties of any kind,
+ * including, but not limited to, any implied warranties of merchantability
+ * or fitness for any particular purpose or warranties against infringement
+ * of any proprietary rights of a third party.
+ *
+ * Energy Micro AS will not be liable for any consequential, incidental, or
+ * special damages, or any other relief, or for any claim by any third party,
+ * arising from your use of this Software.
+ *
+ *****************************************************************************/
+#ifndef __INTTEMPCONV_H
+#define __INTTEMPCONV_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+   Conversion of internal temperature sensor samples, kept free of hardware
+   references so that it can be verified off target.
+
+   The sensor reads calValue at the factory calibration temperature calTemp
+   (from DEVINFO), and falls by INTTEMPCONV_GRAD_CENTI/100 ADC codes per
+   degree Celsius with the 1.25 V reference:
+
+     celsius = calTemp + (calValue - sample) / 6.27
+
+   INTTEMPCONV_init() folds calibration and gradient into one offset, so
+   each conversion is a multiply, a subtract and a shift, giving 1/100
+   degrees Celsius with INTTEMPCONV_SHIFT fraction bits of precision in the
+   gradient. Display values in 1/10 degree Celsius and Fahrenheit are both
+   derived from this one conversion, rounded to nearest. Oversampled or
+   averaged samples with fraction bits are converted without truncation by
+   INTTEMPCONV_centiCelsiusFrac().
+*/
+
+/** Temperature gradient, ADC codes per 100 degrees Celsius (datasheet). */
+#define INTTEMPCONV_GRAD_CENTI  627
+
+/** Fraction bits of conversion factor. */
+#define INTTEMPCONV_SHIFT       12
+
+/**
+ * Conversion factor, 1/100 degrees Celsius per ADC code with
+ * INTTEMPCONV_SHIFT fraction bits, 100 / 6.27 rounded.
+ */
+#define INTTEMPCONV_FACTOR      \
+  (((10000L << INTTEMPCONV_SHIFT) + INTTEMPCONV_GRAD_CENTI / 2) / INTTEMPCONV_GRAD_CENTI)
+
+/** Conversion calibration. */
+typedef struct
+{
+  /** 1/100 degrees Celsius at sample 0, INTTEMPCONV_SHIFT fraction bits. */
+  int32_t offset;
+} INTTEMPCONV_Cal_TypeDef;
+
+void INTTEMPCONV_init(INTTEMPCONV_Cal_TypeDef *cal,
+                      uint32_t calTemp,
+                      uint32_t calValue);
+int32_t INTTEMPCONV_centiCelsius(const INTTEMPCONV_Cal_TypeDef *cal,
+                                 uint32_t sample);
+int32_t INTTEMPCONV_centiCelsiusFrac(const INTTEMPCONV_Cal_TypeDef *cal,
+                                     uint32_t sample,
+                                     unsigned int fracBits);
+int32_t INTTEMPCONV_deciCelsius(int32_t centiCelsius);
+int32_t INTTEMPCONV_deciFahrenheit(int32_t centiCelsius);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,350 @@
+/**************************************************************************//**
+ * @file
+ * @brief Host runner for debounced key event queue
+ * @author Energy Micro AS
+ * @version 3.20.0
+ ******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 Energy Micro AS, http://www.energymicro.com</b>
+ *******************************************************************************
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ * 4. The source and compiled code may only be used on Energy Micro "EFM32"
+ *    microcontrollers and "EFR4" radios.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: Energy Micro AS has no
+ * obligation to support this Software. Energy Micro AS is providing the
+ * Software "AS IS", with no express or implied warranties of any kind,
+ * including, but not limited to, any implied warranties of merchantability
+ * or fitness for any particular purpose or warranties against infringement
+ * of any proprietary rights of a third party.
+ *
+ * Energy Micro AS will not be liable for any consequential, incidental, or
+ * special damages, or any other relief, or for any claim by any third party,
+ * arising from your use of this Software.
+ *
+ *****************************************************************************/
+
+/*
+   Host runner for the debounced key event queue (keyq.c).
+
+   Drives the queue as the DK key interrupt and LETIMER0 handlers of
+   keyinput.c do: a key interrupt at each change of the simulated key
+   state puts the edge and runs the timer handler at once, and the timer
+   handler runs again after the ticks it returns. Synthetic key patterns
+   with contact bounce, glitches, long holds, overlapping keys, missed
+   release interrupts and tick counter wrap are checked against the
+   events expected.
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include "keyq.h"
+
+/** Largest number of events recorded per pattern. */
+#define KEYQRUN_MAX_EVENTS  64
+
+/** Number of changes of key state in a pattern. */
+#define KEYQRUN_MAX_CHANGES 128
+
+/** Key pattern, key state changes at given ticks. */
+typedef struct
+{
+  const char *name;
+  /** Tick of first change, to check counter wrap. */
+  uint16_t    start;
+  /** Length of pattern, ticks. */
+  int         length;
+  /** No key interrupt when keys are released. */
+  bool        noReleaseIrq;
+  int         changes;
+  int         at[KEYQRUN_MAX_CHANGES];
+  uint16_t    keys[KEYQRUN_MAX_CHANGES];
+} KEYQRUN_Pattern_TypeDef;
+
+/** Recorded event. */
+typedef struct
+{
+  int                time;
+  KEYQ_Event_TypeDef event;
+} KEYQRUN_Record_TypeDef;
+
+static KEYQ_Queue_TypeDef     keyqrunQueue;
+static KEYQRUN_Record_TypeDef keyqrunRecord[KEYQRUN_MAX_EVENTS];
+static int                    keyqrunEvents;
+static int                    keyqrunTimerRuns;
+static int                    keyqrunFailed;
+
+/***************************************************************************//**
+ * @brief
+ *   Record check result.
+ ******************************************************************************/
+static void keyqrunCheck(bool ok, const char *pattern, const char *what)
+{
+  if (!ok)
+  {
+    printf("%s: check failed: %s\n", pattern, what);
+    keyqrunFailed++;
+  }
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Add change to pattern, bouncing back and forth count times first.
+ *   Settles count * 2 ticks after start.
+ ******************************************************************************/
+static void keyqrunBounce(KEYQRUN_Pattern_TypeDef *p, int at, uint16_t from,
+                          uint16_t to, int count)
+{
+  int i;
+
+  for (i = 0; i < count; i++)
+  {
+    p->at[p->changes]     = at + 2 * i;
+    p->keys[p->changes++] = to;
+    p->at[p->changes]     = at + 2 * i + 1;
+    p->keys[p->changes++] = from;
+  }
+  p->at[p->changes]     = at + 2 * count;
+  p->keys[p->changes++] = to;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Run timer handler, record events.
+ ******************************************************************************/
+static uint16_t keyqrunTimer(int t, uint16_t now, uint16_t keys)
+{
+  KEYQ_Event_TypeDef event;
+  uint16_t next;
+
+  keyqrunTimerRuns++;
+  next = KEYQ_tick(&keyqrunQueue, now, keys);
+
+  /* Main loop */
+  while (KEYQ_get(&keyqrunQueue, &event))
+  {
+    if (keyqrunEvents < KEYQRUN_MAX_EVENTS)
+    {
+      keyqrunRecord[keyqrunEvents].time = t;
+      keyqrunRecord[keyqrunEvents++].event = event;
+    }
+  }
+  return next;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Run pattern, returns ticks after pattern end the timer stopped, -1 if
+ *   still running.
+ ******************************************************************************/
+static int keyqrunPattern(const KEYQRUN_Pattern_TypeDef *p)
+{
+  uint16_t keys = 0;
+  uint16_t next;
+  int      timer = -1;
+  int      change = 0;
+  int      t;
+
+  KEYQ_init(&keyqrunQueue);
+  keyqrunEvents = 0;
+  keyqrunTimerRuns = 0;
+
+  for (t = 0; t < p->length; t++)
+  {
+    bool edge = false;
+
+    /* Several changes within a tick give one interrupt per change */
+    while (change < p->changes && p->at[change] == t)
+    {
+      uint16_t old = keys;
+
+      keys = p->keys[change++];
+      if (!(p->noReleaseIrq && (old & ~keys)))
+      {
+        KEYQ_edge(&keyqrunQueue, (uint16_t)(p->start + t), keys);
+        edge = true;
+      }
+    }
+
+    /* Key interrupt handler pends timer handler */
+    if (edge || t == timer)
+    {
+      next = keyqrunTimer(t, (uint16_t)(p->start + t), keys);
+      timer = next ? t + next : -1;
+    }
+  }
+
+  return timer < 0 ? 0 : -1;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Count recorded events of type and key.
+ ******************************************************************************/
+static int keyqrunCount(KEYQ_EventType_TypeDef type, uint16_t key)
+{
+  int i;
+  int n = 0;
+
+  for (i = 0; i < keyqrunEvents; i++)
+  {
+    n += keyqrunRecord[i].event.type == type && keyqrunRecord[i].event.key == key;
+  }
+  return n;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Time of n'th recorded event of type and key, -1 if none.
+ ******************************************************************************/
+static int keyqrunTime(KEYQ_EventType_TypeDef type, uint16_t key, int n)
+{
+  int i;
+
+  for (i = 0; i < keyqrunEvents; i++)
+  {
+    if (keyqrunRecord[i].event.type == type && keyqrunRecord[i].event.key == key &&
+        !n--)
+    {
+      return keyqrunRecord[i].time;
+    }
+  }
+  return -1;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Single press of key with bounce, held, released with bounce.
+ ******************************************************************************/
+static void keyqrunPress(KEYQRUN_Pattern_TypeDef *p, const char *name,
+                         uint16_t start, int hold, int bounces, bool noReleaseIrq)
+{
+  memset(p, 0, sizeof(*p));
+  p->name = name;
+  p->start = start;
+  p->noReleaseIrq = noReleaseIrq;
+  keyqrunBounce(p, 100, 0, 1, bounces);
+  keyqrunBounce(p, 100 + hold, 1, 0, bounces);
+  p->length = 100 + hold + 1000;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Check single press pattern.
+ ******************************************************************************/
+static void keyqrunCheckPress(KEYQRUN_Pattern_TypeDef *p, int hold, int bounces,
+                              int releaseLatency)
+{
+  int repeats = 0;
+  int stopped;
+  int i;
+
+  stopped = keyqrunPattern(p);
+
+  /* Repeats while held after debounce, first after delay, then periodic */
+  if (hold > KEYQ_REPEAT_DELAY)
+  {
+    repeats = (hold - KEYQ_REPEAT_DELAY) / KEYQ_REPEAT_PERIOD + 1;
+  }
+
+  keyqrunCheck(keyqrunCount(keyqPress, 1) == 1, p->name, "one press");
+  keyqrunCheck(keyqrunCount(keyqRelease, 1) == 1, p->name, "one release");
+  keyqrunCheck(keyqrunTime(keyqPress, 1, 0) == 100 + 2 * bounces + KEYQ_DEBOUNCE,
+               p->name, "press debounced from last bounce");
+  keyqrunCheck(keyqrunTime(keyqRelease, 1, 0) >= 100 + hold + 2 * bounces + KEYQ_DEBOUNCE &&
+               keyqrunTime(keyqRelease, 1, 0) <= 100 + hold + 2 * bounces + releaseLatency,
+               p->name, "release debounced");
+  keyqrunCheck(keyqrunCount(keyqRepeat, 1) >= repeats - 1 &&
+               keyqrunCount(keyqRepeat, 1) <= repeats + 1, p->name, "repeat count");
+  for (i = 0; i < keyqrunCount(keyqRepeat, 1); i++)
+  {
+    int expected = keyqrunTime(keyqPress, 1, 0) + KEYQ_REPEAT_DELAY + i * KEYQ_REPEAT_PERIOD;
+
+    keyqrunCheck(keyqrunTime(keyqRepeat, 1, i) == expected, p->name, "repeat time");
+  }
+  keyqrunCheck(keyqrunEvents == 2 + keyqrunCount(keyqRepeat, 1), p->name, "no other events");
+  keyqrunCheck(stopped == 0, p->name, "timer stopped when released");
+
+  printf("%-24s %4d events %4d timer runs\n", p->name, keyqrunEvents, keyqrunTimerRuns);
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Main function.
+ ******************************************************************************/
+int main(void)
+{
+  KEYQRUN_Pattern_TypeDef p;
+  KEYQ_Event_TypeDef event;
+  int i;
+
+  keyqrunPress(&p, "clean press", 0, 300, 0, false);
+  keyqrunCheckPress(&p, 300, 0, KEYQ_DEBOUNCE);
+
+  keyqrunPress(&p, "bouncing press", 0, 300, 9, false);
+  keyqrunCheckPress(&p, 300, 9, KEYQ_DEBOUNCE);
+
+  keyqrunPress(&p, "long hold", 0, 1500, 5, false);
+  keyqrunCheckPress(&p, 1500, 5, KEYQ_DEBOUNCE);
+
+  keyqrunPress(&p, "no release interrupt", 0, 1500, 0, true);
+  keyqrunCheckPress(&p, 1500, 0, KEYQ_POLL + KEYQ_DEBOUNCE);
+
+  keyqrunPress(&p, "tick counter wrap", 0xff00, 1500, 5, false);
+  keyqrunCheckPress(&p, 1500, 5, KEYQ_DEBOUNCE);
+
+  /* Glitches shorter than debounce time give no events */
+  memset(&p, 0, sizeof(p));
+  p.name = "glitches";
+  for (i = 0; i < 10; i++)
+  {
+    keyqrunBounce(&p, 100 + 50 * i, 0, 4, 1);
+    keyqrunBounce(&p, 110 + 50 * i, 4, 0, 3);
+  }
+  p.length = 1000;
+  keyqrunCheck(keyqrunPattern(&p) == 0, p.name, "timer stopped");
+  keyqrunCheck(keyqrunEvents == 0, p.name, "no events");
+  printf("%-24s %4d events %4d timer runs\n", p.name, keyqrunEvents, keyqrunTimerRuns);
+
+  /* Second key pressed while first held, first released before second */
+  memset(&p, 0, sizeof(p));
+  p.name = "overlapping keys";
+  keyqrunBounce(&p, 100, 0, 1, 3);
+  keyqrunBounce(&p, 300, 1, 1 | 16, 3);
+  keyqrunBounce(&p, 400, 1 | 16, 16, 3);
+  keyqrunBounce(&p, 600, 16, 0, 3);
+  p.length = 1000;
+  keyqrunCheck(keyqrunPattern(&p) == 0, p.name, "timer stopped");
+  keyqrunCheck(keyqrunEvents == 4, p.name, "four events");
+  keyqrunCheck(keyqrunRecord[0].event.type == keyqPress && keyqrunRecord[0].event.key == 1 &&
+               keyqrunRecord[1].event.type == keyqPress && keyqrunRecord[1].event.key == 16 &&
+               keyqrunRecord[2].event.type == keyqRelease && keyqrunRecord[2].event.key == 1 &&
+               keyqrunRecord[3].event.type == keyqRelease && keyqrunRecord[3].event.key == 16,
+               p.name, "event order");
+  printf("%-24s %4d events %4d timer runs\n", p.name, keyqrunEvents, keyqrunTimerRuns);
+
+  /* Edges beyond ring size while timer handler blocked are dropped */
+  KEYQ_init(&keyqrunQueue);
+  for (i = 0; i < 40; i++)
+  {
+    KEYQ_edge(&keyqrunQueue, (uint16_t)i, (uint16_t)(i & 1));
+  }
+  keyqrunCheck(keyqrunQueue.edges.dropped == 40 - KEYQ_RING_SIZE, "ring overflow", "dropped count");
+  KEYQ_tick(&keyqrunQueue, 40, 2);
+  keyqrunCheck(KEYQ_tick(&keyqrunQueue, 40 + KEYQ_DEBOUNCE, 2) > 0, "ring overflow", "held");
+  keyqrunCheck(KEYQ_get(&keyqrunQueue, &event) && event.type == keyqPress && event.key == 2,
+               "ring overflow", "recovers from sampled state");
+  keyqrunCheck(!KEYQ_pending(&keyqrunQueue), "ring overflow", "single event");
+
+  printf("%s\n", keyqrunFailed ? "FAILED" : "passed");
+  return keyqrunFailed != 0;
+}
@@ -35,86 +35,49 @@
 #include "em_device.h"
 #include "em_chip.h"
 #include "em_cmu.h"
-#include "em_gpio.h"
+#include "em_emu.h"
+#include "em_int.h"
 #include "bsp.h"
 #include "bsp_trace.h"
-
-/** Interrupt pin used to detect joystick activity */
-#define GPIO_INT_PIN 14
-
-volatile uint32_t msTicks; /* counts 1ms timeTicks */
+#include "keyinput.h"
 
 /* Local prototypes */
-void Delay(uint32_t dlyTicks);
-void DkIrqInit(void);
-void GpioIrqInit(void);
+void joystickKey(const KEYQ_Event_TypeDef *event);
 
-/**************************************************************************//**
- * @brief SysTick_Handler
- * Interrupt Service Routine for system tick counter
- *****************************************************************************/
-void SysTick_Handler(void)
-{
-  msTicks++;       /* increment counter necessary in Delay()*/
-}
-
-/**************************************************************************//**
- * @brief Delays number of msTick Systicks (typically 1 ms)
- * @param dlyTicks Number of ticks to delay
- *****************************************************************************/
-void Delay(uint32_t dlyTicks)
-{
-  uint32_t curTicks;
+/** Joystick keys held, shown on lower LEDs */
+static uint16_t joystickHeld;
 
-  curTicks = msTicks;
-  while ((msTicks - curTicks) < dlyTicks) ;
-}
+/** Counter stepped by up/down, repeated while held, shown on upper LEDs */
+static uint8_t joystickCount;
 
 /**************************************************************************//**
- * @brief Initialize GPIO interrupt on PC14
+ * @brief Handle joystick event
+ * @param[in] event Key event.
  *****************************************************************************/
-void GPIO_EVEN_IRQHandler(void)
+void joystickKey(const KEYQ_Event_TypeDef *event)
 {
-  uint16_t data, joystick;
-
-  /* Clear intedvkrrupt */
-  data = BSP_InterruptFlagsGet();
-  BSP_InterruptFlagsClear(data);
-
-  /* Clear GPIO interrupt */
-  GPIO_IntClear(1 << GPIO_INT_PIN);
-
-  /* Read joystick status */
-  joystick = BSP_JoystickGet();
-
-  /* Light up LEDs according to joystick status */
-  BSP_LedsSet(joystick);
-}
-
-/**************************************************************************//**
- * @brief Initialize GPIO interrupt on PC14
- *****************************************************************************/
-void GpioIrqInit(void)
-{
-  /* Configure interrupt pin as input with pull-up */
-  GPIO_PinModeSet(gpioPortC, GPIO_INT_PIN, gpioModeInputPull, 1);
+  switch (event->type)
+  {
+  case keyqPress:
+    joystickHeld |= event->key;
+    break;
 
-  /* Set falling edge interrupt and clear/enable it */
-  GPIO_IntConfig(gpioPortC, GPIO_INT_PIN, false, true, true);
+  case keyqRelease:
+    joystickHeld &= ~event->key;
+    return;
 
-  NVIC_ClearPendingIRQ(GPIO_EVEN_IRQn);
-  NVIC_EnableIRQ(GPIO_EVEN_IRQn);
-}
+  default: /* Repeat */
+    break;
+  }
 
-/**************************************************************************//**
- * @brief Enable DK FPGA to generate GPIO PC14 trigger on control updates
- *****************************************************************************/
-void DkIrqInit(void)
-{
-  /* Enable interrupts on joystick events only */
-  BSP_InterruptDisable(0xffff);
-  BSP_InterruptFlagsClear(0xffff);
-  BSP_InterruptEnable(BC_INTEN_JOYSTICK);
+  if (event->key & BC_JOYSTICK_UP)
+  {
+    joystickCount++;
+  }
+  if (event->key & BC_JOYSTICK_DOWN)
+  {
+    joystickCount--;
+  }
 }
 
 /**************************************************************************//**
@@ -122,6 +85,8 @@ void DkIrqInit(void)
  *****************************************************************************/
 int main(void)
 {
+  KEYQ_Event_TypeDef event;
+
   /* Chip revision alignment and errata fixes */
   CHIP_Init();
 
@@ -131,28 +96,28 @@ int main(void)
   /* If first word of user data page is non-zero, enable eA Profiler trace */
   BSP_TraceProfilerSetup();
 
-  /* Setup SysTick Timer for 1 msec interrupts  */
-  if (SysTick_Config(CMU_ClockFreqGet(cmuClock_CORE) / 1000))
-  {
-    while (1) ;
-  }
-
-  /* Initialize DK interrupt enable */
-  DkIrqInit();
-
-  /* Initialize GPIO interrupt */
-  GpioIrqInit();
+  /* Joystick events, debounced on LETIMER0 so the core stays in EM2 */
+  KEYINPUT_init(BC_INTEN_JOYSTICK);
 
   /* Turn off LEDs */
   BSP_LedsSet(0x0000);
 
   while (1)
   {
-    /* Wait 5 seconds */
-    Delay(5000);
-    /* Quick flash to show we're alive */
-    BSP_LedsSet(0xffff);
-    Delay(20);
-    BSP_LedsSet(0x0000);
+    while (KEYINPUT_get(&event))
+    {
+      joystickKey(&event);
+    }
+
+    /* Light up LEDs according to joystick status and counter */
+    BSP_LedsSet((joystickCount << 8) | joystickHeld);
+
+    /* Enter EM2 until next event */
+    INT_Disable();
+    if (!KEYINPUT_pending())
+    {
+      EMU_EnterEM2(true);
+    }
+    INT_Enable();
   }
 }
@@ -0,0 +1,194 @@
+/**************************************************************************//**
+ * @file
+ * @brief DK key input through debounced key event queue
+ * @author Energy Micro AS
+ * @version 3.20.0
+ ******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 Energy Micro AS, http://www.energymicro.com</b>
+ *******************************************************************************
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ * 4. The source and compiled code may only be used on Energy Micro "EFM32"
+ *    microcontrollers and "EFR4" radios.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: Energy Micro AS has no
+ * obligation to support this Software. Energy Micro AS is providing the
+ * Software "AS IS", with no express or implied warranties of any kind,
+ * including, but not limited to, any implied warranties of merchantability
+ * or fitness for any particular purpose or warranties against infringement
+ * of any proprietary rights of a third party.
+ *
+ * Energy Micro AS will not be liable for any consequential, incidental, or
+ * special damages, or any other relief, or for any claim by any third party,
+ * arising from your use of this Software.
+ *
+ *****************************************************************************/
+#include "em_device.h"
+#include "em_cmu.h"
+#include "em_gpio.h"
+#include "em_letimer.h"
+#include "bsp.h"
+#include "keyinput.h"
+
+/** Key event queue. */
+static KEYQ_Queue_TypeDef keyinputQueue;
+
+/** Board controller interrupt flags in use, BC_INTEN_JOYSTICK/BC_INTEN_PB. */
+static uint16_t keyinputFlags;
+
+/***************************************************************************//**
+ * @brief
+ *   Read key state from board controller.
+ ******************************************************************************/
+static uint16_t keyinputRead(void)
+{
+  uint16_t keys = 0;
+
+  if (keyinputFlags & BC_INTEN_JOYSTICK)
+  {
+    keys |= BSP_JoystickGet();
+  }
+  if (keyinputFlags & BC_INTEN_PB)
+  {
+    keys |= BSP_PushButtonsGet() << KEYINPUT_PB_SHIFT;
+  }
+  return keys;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Current time, KEYQ_TICK_HZ ticks. LETIMER0 counts down from 0xffff.
+ ******************************************************************************/
+static uint16_t keyinputTime(void)
+{
+  return (uint16_t)(0xffff - LETIMER_CounterGet(LETIMER0));
+}
+
+/***************************************************************************//**
+ * @brief
+ *   GPIO interrupt handler, board controller key activity.
+ ******************************************************************************/
+void GPIO_EVEN_IRQHandler(void)
+{
+  /* Clear interrupt */
+  BSP_InterruptFlagsClear(keyinputFlags);
+  GPIO_IntClear(1 << KEYINPUT_GPIO_PIN);
+
+  /* Just record edge, debounced in LETIMER0 interrupt handler */
+  KEYQ_edge(&keyinputQueue, keyinputTime(), keyinputRead());
+  NVIC_SetPendingIRQ(LETIMER0_IRQn);
+}
+
+/***************************************************************************//**
+ * @brief
+ *   LETIMER0 interrupt handler, debounce and repeat.
+ ******************************************************************************/
+void LETIMER0_IRQHandler(void)
+{
+  uint16_t now;
+  uint16_t next;
+
+  LETIMER_IntClear(LETIMER0, LETIMER_IF_COMP1);
+
+  now = keyinputTime();
+  next = KEYQ_tick(&keyinputQueue, now, keyinputRead());
+
+  if (next)
+  {
+    /* Leave time for compare register synchronization */
+    if (next < 2)
+    {
+      next = 2;
+    }
+    LETIMER_CompareSet(LETIMER0, 1, 0xffff - (uint16_t)(now + next));
+    LETIMER_IntEnable(LETIMER0, LETIMER_IF_COMP1);
+  }
+  else
+  {
+    /* No keys in use, wait for next edge */
+    LETIMER_IntDisable(LETIMER0, LETIMER_IF_COMP1);
+  }
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Initialize key input.
+ *
+ * @details
+ *   Enables board controller interrupts for keys, and only those.
+ *
+ * @param[in] flags
+ *   BC_INTEN_JOYSTICK and/or BC_INTEN_PB.
+ ******************************************************************************/
+void KEYINPUT_init(uint16_t flags)
+{
+  LETIMER_Init_TypeDef letimerInit = LETIMER_INIT_DEFAULT;
+
+  KEYQ_init(&keyinputQueue);
+  keyinputFlags = flags;
+
+  /* LETIMER0 free running at KEYQ_TICK_HZ from LFACLK, keeping LFACLK */
+  /* source if already selected by RTC or LCD */
+  CMU_ClockEnable(cmuClock_CORELE, true);
+  if (CMU_ClockSelectGet(cmuClock_LFA) == cmuSelect_Disabled)
+  {
+    CMU_ClockSelectSet(cmuClock_LFA, cmuSelect_LFRCO);
+  }
+  CMU_ClockDivSet(cmuClock_LETIMER0, (CMU_ClkDiv_TypeDef)(32768 / KEYQ_TICK_HZ));
+  CMU_ClockEnable(cmuClock_LETIMER0, true);
+  LETIMER_Init(LETIMER0, &letimerInit);
+  LETIMER_IntClear(LETIMER0, LETIMER_IF_COMP1);
+  NVIC_ClearPendingIRQ(LETIMER0_IRQn);
+  NVIC_EnableIRQ(LETIMER0_IRQn);
+
+  /* Enable board control interrupts */
+  BSP_InterruptDisable(0xffff);
+  BSP_InterruptFlagsClear(0xffff);
+  BSP_InterruptEnable(flags);
+
+  /* Configure interrupt pin as input with pull-up */
+  GPIO_PinModeSet(gpioPortC, KEYINPUT_GPIO_PIN, gpioModeInputPull, 1);
+
+  /* Set falling edge interrupt and clear/enable it */
+  GPIO_IntConfig(gpioPortC, KEYINPUT_GPIO_PIN, false, true, true);
+
+  NVIC_ClearPendingIRQ(GPIO_EVEN_IRQn);
+  NVIC_EnableIRQ(GPIO_EVEN_IRQn);
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Take next key event.
+ *
+ * @param[out] event
+ *   Key event.
+ *
+ * @return
+ *   false if no event pending.
+ ******************************************************************************/
+bool KEYINPUT_get(KEYQ_Event_TypeDef *event)
+{
+  return KEYQ_get(&keyinputQueue, event);
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Check for pending key events.
+ *
+ * @details
+ *   Call with interrupts disabled before entering an energy mode, so that
+ *   an event put in between still wakes up the core.
+ ******************************************************************************/
+bool KEYINPUT_pending(void)
+{
+  return KEYQ_pending(&keyinputQueue);
+}
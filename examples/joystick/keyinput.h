@@ -0,0 +1,77 @@
+/**************************************************************************//**
+ * @file
+ * @brief DK key input through debounced key event queue
+ * @author Energy Micro AS
+ * @version 3.20.0
+ ******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 Energy Micro AS, http://www.energymicro.com</b>
+ *******************************************************************************
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ * 4. The source and compiled code may only be used on Energy Micro "EFM32"
+ *    microcontrollers and "EFR4" radios.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: Energy Micro AS has no
+ * obligation to support this Software. Energy Micro AS is providing the
+ * Software "AS IS", with no express or implied warranties of any kind,
+ * including, but not limited to, any implied warranties of merchantability
+ * or fitness for any particular purpose or warranties against infringement
+ * of any proprietary rights of a third party.
+ *
+ * Energy Micro AS will not be liable for any consequential, incidental, or
+ * special damages, or any other relief, or for any claim by any third party,
+ * arising from your use of this Software.
+ *
+ *****************************************************************************/
+#ifndef __KEYINPUT_H
+#define __KEYINPUT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "keyq.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+   DK joystick and push button input through the debounced key event
+   queue (keyq.c).
+
+   The board controller signals joystick and push button activity on
+   PC14. Its interrupt handler only reads the keys, and puts them with
+   the LETIMER0 time in the queue. Debouncing and repeat run in the
+   LETIMER0 interrupt handler, which is only active while keys are in use.
+   LETIMER0 runs on LFACLK, so the core may stay in EM2 in between. The
+   main loop takes press, release and repeat events with KEYINPUT_get().
+
+   Key bits are the BC_JOYSTICK_ bits, and the BC_PUSHBUTTON_ bits shifted
+   up by KEYINPUT_PB_SHIFT.
+
+   The RTC is left to the RTC driver; LETIMER0 keeps its own time base.
+*/
+
+/** Interrupt pin used to detect joystick and push button activity. */
+#define KEYINPUT_GPIO_PIN    14
+
+/** Shift of push button bits in key state. */
+#define KEYINPUT_PB_SHIFT    8
+
+void KEYINPUT_init(uint16_t flags);
+bool KEYINPUT_get(KEYQ_Event_TypeDef *event);
+bool KEYINPUT_pending(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
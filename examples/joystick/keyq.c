@@ -0,0 +1,253 @@
+/**************************************************************************//**
+ * @file
+ * @brief Debounced key event queue
+ * @author Energy Micro AS
+ * @version 3.20.0
+ ******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 Energy Micro AS, http://www.energymicro.com</b>
+ *******************************************************************************
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ * 4. The source and compiled code may only be used on Energy Micro "EFM32"
+ *    microcontrollers and "EFR4" radios.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: Energy Micro AS has no
+ * obligation to support this Software. Energy Micro AS is providing the
+ * Software "AS IS", with no express or implied warranties of any kind,
+ * including, but not limited to, any implied warranties of merchantability
+ * or fitness for any particular purpose or warranties against infringement
+ * of any proprietary rights of a third party.
+ *
+ * Energy Micro AS will not be liable for any consequential, incidental, or
+ * special damages, or any other relief, or for any claim by any third party,
+ * arising from your use of this Software.
+ *
+ *****************************************************************************/
+#include "keyq.h"
+
+/***************************************************************************//**
+ * @brief
+ *   Put entry in ring, producer side.
+ ******************************************************************************/
+static bool keyqPut(KEYQ_Ring_TypeDef *ring, uint16_t value, uint16_t keys)
+{
+  uint8_t head = ring->head;
+
+  if ((uint8_t)(head - ring->tail) >= KEYQ_RING_SIZE)
+  {
+    ring->dropped++;
+    return false;
+  }
+
+  ring->entry[head & (KEYQ_RING_SIZE - 1)].value = value;
+  ring->entry[head & (KEYQ_RING_SIZE - 1)].keys  = keys;
+
+  /* Entry written before it is published */
+  ring->head = head + 1;
+  return true;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Take entry from ring, consumer side.
+ ******************************************************************************/
+static bool keyqTake(KEYQ_Ring_TypeDef *ring, KEYQ_Entry_TypeDef *entry)
+{
+  uint8_t tail = ring->tail;
+
+  if (tail == ring->head)
+  {
+    return false;
+  }
+
+  *entry = ring->entry[tail & (KEYQ_RING_SIZE - 1)];
+
+  /* Entry read before it is released */
+  ring->tail = tail + 1;
+  return true;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Put one event per key set in keys.
+ ******************************************************************************/
+static void keyqEvents(KEYQ_Queue_TypeDef *queue,
+                       KEYQ_EventType_TypeDef type,
+                       uint16_t keys)
+{
+  uint16_t key;
+
+  for (key = 1; keys; key <<= 1)
+  {
+    if (keys & key)
+    {
+      keyqPut(&queue->events, (uint16_t)type, key);
+      keys &= ~key;
+    }
+  }
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Initialize key event queue, no keys held.
+ ******************************************************************************/
+void KEYQ_init(KEYQ_Queue_TypeDef *queue)
+{
+  queue->edges.head     = 0;
+  queue->edges.tail     = 0;
+  queue->edges.dropped  = 0;
+  queue->events.head    = 0;
+  queue->events.tail    = 0;
+  queue->events.dropped = 0;
+  queue->raw            = 0;
+  queue->rawTime        = 0;
+  queue->stable         = 0;
+  queue->repeatTime     = 0;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Record key state at edge, from key interrupt handler.
+ *
+ * @param[in] queue
+ *   Key event queue.
+ *
+ * @param[in] time
+ *   Time of edge, ticks.
+ *
+ * @param[in] keys
+ *   Key state read at edge.
+ *
+ * @return
+ *   false if edge ring was full, and edge dropped.
+ ******************************************************************************/
+bool KEYQ_edge(KEYQ_Queue_TypeDef *queue, uint16_t time, uint16_t keys)
+{
+  return keyqPut(&queue->edges, time, keys);
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Debounce edges and generate events, from timer handler.
+ *
+ * @param[in] queue
+ *   Key event queue.
+ *
+ * @param[in] now
+ *   Current time, ticks.
+ *
+ * @param[in] keys
+ *   Key state sampled now.
+ *
+ * @return
+ *   Ticks until next call, 0 if not needed before next edge.
+ ******************************************************************************/
+uint16_t KEYQ_tick(KEYQ_Queue_TypeDef *queue, uint16_t now, uint16_t keys)
+{
+  KEYQ_Entry_TypeDef edge;
+  uint16_t           changed;
+  uint16_t           next = 0;
+
+  /* Each change of key state restarts debounce time */
+  while (keyqTake(&queue->edges, &edge))
+  {
+    if (edge.keys != queue->raw)
+    {
+      queue->raw     = edge.keys;
+      queue->rawTime = edge.value;
+    }
+  }
+  if (keys != queue->raw)
+  {
+    queue->raw     = keys;
+    queue->rawTime = now;
+  }
+
+  if (queue->raw != queue->stable)
+  {
+    if ((uint16_t)(now - queue->rawTime) >= KEYQ_DEBOUNCE)
+    {
+      changed = queue->raw ^ queue->stable;
+      keyqEvents(queue, keyqRelease, changed & queue->stable);
+      keyqEvents(queue, keyqPress, changed & queue->raw);
+      if (changed & queue->raw)
+      {
+        queue->repeatTime = now + KEYQ_REPEAT_DELAY;
+      }
+      queue->stable = queue->raw;
+    }
+    else
+    {
+      next = KEYQ_DEBOUNCE - (uint16_t)(now - queue->rawTime);
+    }
+  }
+
+  if (queue->stable)
+  {
+    if ((int16_t)(now - queue->repeatTime) >= 0)
+    {
+      keyqEvents(queue, keyqRepeat, queue->stable);
+      queue->repeatTime += KEYQ_REPEAT_PERIOD;
+      if ((int16_t)(now - queue->repeatTime) >= 0)
+      {
+        /* Late, do not catch up */
+        queue->repeatTime = now + KEYQ_REPEAT_PERIOD;
+      }
+    }
+    if (!next || (uint16_t)(queue->repeatTime - now) < next)
+    {
+      next = queue->repeatTime - now;
+    }
+    if (next > KEYQ_POLL)
+    {
+      next = KEYQ_POLL;
+    }
+  }
+
+  return next;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Take next key event, from main loop.
+ *
+ * @param[in] queue
+ *   Key event queue.
+ *
+ * @param[out] event
+ *   Key event.
+ *
+ * @return
+ *   false if no event pending.
+ ******************************************************************************/
+bool KEYQ_get(KEYQ_Queue_TypeDef *queue, KEYQ_Event_TypeDef *event)
+{
+  KEYQ_Entry_TypeDef entry;
+
+  if (!keyqTake(&queue->events, &entry))
+  {
+    return false;
+  }
+
+  event->type = (KEYQ_EventType_TypeDef)entry.value;
+  event->key  = entry.keys;
+  return true;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Check for pending key events, from main loop.
+ ******************************************************************************/
+bool KEYQ_pending(const KEYQ_Queue_TypeDef *queue)
+{
+  return queue->events.tail != queue->events.head;
+}
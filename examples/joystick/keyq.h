@@ -0,0 +1,152 @@
+/**************************************************************************//**
+ * @file
+ * @brief Debounced key event queue
+ * @author Energy Micro AS
+ * @version 3.20.0
+ ******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 Energy Micro AS, http://www.energymicro.com</b>
+ *******************************************************************************
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ * 4. The source and compiled code may only be used on Energy Micro "EFM32"
+ *    microcontrollers and "EFR4" radios.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: Energy Micro AS has no
+ * obligation to support this Software. Energy Micro AS is providing the
+ * Software "AS IS", with no express or implied warranties of any kind,
+ * including, but not limited to, any implied warranties of merchantability
+ * or fitness for any particular purpose or warranties against infringement
+ * of any proprietary rights of a third party.
+ *
+ * Energy Micro AS will not be liable for any consequential, incidental, or
+ * special damages, or any other relief, or for any claim by any third party,
+ * arising from your use of this Software.
+ *
+ *****************************************************************************/
+#ifndef __KEYQ_H
+#define __KEYQ_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+   Debounced key event queue, kept free of hardware references so that it
+   can be verified off target.
+
+   Key state is a bit mask of keys held. Whenever the key interrupt fires,
+   the interrupt handler passes the time and the key state read to
+   KEYQ_edge(), which only puts them in a ring and returns. A low energy
+   timer handler then calls KEYQ_tick(). It takes the edges from the ring
+   and the key state sampled at the tick, and turns changes that have been
+   stable for KEYQ_DEBOUNCE ticks into press and release events. Keys held
+   give repeat events, first after KEYQ_REPEAT_DELAY, then every
+   KEYQ_REPEAT_PERIOD ticks. KEYQ_tick() returns the ticks until it must be
+   called again, or 0 when no keys are held and nothing is pending, so the
+   timer only runs while keys are in use. The main loop takes events with
+   KEYQ_get().
+
+   Each ring has a single producer and a single consumer, the edge ring
+   the key interrupt handler and the timer handler, the event ring the
+   timer handler and the main loop. The producer only writes the head
+   index, after the entry, and the consumer only the tail index, so no
+   locking is needed on a single core. When a ring is full, new entries
+   are dropped and counted.
+
+   Times are in ticks of KEYQ_TICK_HZ, wrapping at 16 bits.
+*/
+
+/** Tick rate, Hz. */
+#define KEYQ_TICK_HZ           1024
+
+/** Ticks a key state must be stable before it is accepted, 20 msec. */
+#define KEYQ_DEBOUNCE          20
+
+/** Ticks from press to first repeat, 500 msec. */
+#define KEYQ_REPEAT_DELAY      512
+
+/** Ticks between repeats, 100 msec. */
+#define KEYQ_REPEAT_PERIOD     102
+
+/** Ticks between samples while keys are held, in case an edge is missed. */
+#define KEYQ_POLL              51
+
+/** Ring entries, power of 2. */
+#define KEYQ_RING_SIZE         16
+
+/** Event types. */
+typedef enum
+{
+  keyqPress   = 1,
+  keyqRelease = 2,
+  keyqRepeat  = 3
+} KEYQ_EventType_TypeDef;
+
+/** Key event. */
+typedef struct
+{
+  /** Event type. */
+  KEYQ_EventType_TypeDef type;
+  /** Key, single bit of key state. */
+  uint16_t               key;
+} KEYQ_Event_TypeDef;
+
+/** Ring entry, time and key state of edge, or type and key of event. */
+typedef struct
+{
+  uint16_t value;
+  uint16_t keys;
+} KEYQ_Entry_TypeDef;
+
+/** Single producer, single consumer ring. */
+typedef struct
+{
+  /** Next entry to write, written by producer only. */
+  volatile uint8_t   head;
+  /** Next entry to read, written by consumer only. */
+  volatile uint8_t   tail;
+  /** Entries dropped since ring was full, written by producer only. */
+  volatile uint16_t  dropped;
+  KEYQ_Entry_TypeDef entry[KEYQ_RING_SIZE];
+} KEYQ_Ring_TypeDef;
+
+/** Key event queue. */
+typedef struct
+{
+  /** Edges from key interrupt handler to timer handler. */
+  KEYQ_Ring_TypeDef edges;
+  /** Events from timer handler to main loop. */
+  KEYQ_Ring_TypeDef events;
+  /** Last key state seen. */
+  uint16_t          raw;
+  /** Time of last change of key state seen. */
+  uint16_t          rawTime;
+  /** Debounced key state. */
+  uint16_t          stable;
+  /** Time of next repeat while keys held. */
+  uint16_t          repeatTime;
+} KEYQ_Queue_TypeDef;
+
+void KEYQ_init(KEYQ_Queue_TypeDef *queue);
+bool KEYQ_edge(KEYQ_Queue_TypeDef *queue, uint16_t time, uint16_t keys);
+uint16_t KEYQ_tick(KEYQ_Queue_TypeDef *queue, uint16_t now, uint16_t keys);
+bool KEYQ_get(KEYQ_Queue_TypeDef *queue, KEYQ_Event_TypeDef *event);
+bool KEYQ_pending(const KEYQ_Queue_TypeDef *queue);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,129 @@
+/**************************************************************************//**
+ * @file
+ * @brief Change detection for slowly sampled ADC inputs
+ * @author Energy Micro AS
+ * @version 3.20.0
+ ******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 Energy Micro AS, http://www.energymicro.com</b>
+ *******************************************************************************
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ * 4. The source and compiled code may only be used on Energy Micro "EFM32"
+ *    microcontrollers and "EFR4" radios.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: Energy Micro AS has no
+ * obligation to support this Software. Energy Micro AS is providing the
+ * Software "AS IS", with no express or implied warranties of any kind,
+ * including, but not limited to, any implied warranties of merchantability
+ * or fitness for any particular purpose or warranties against infringement
+ * of any proprietary rights of a third party.
+ *
+ * Energy Micro AS will not be liable for any consequential, incidental, or
+ * special damages, or any other relief, or for any claim by any third party,
+ * arising from your use of this Software.
+ *
+ *****************************************************************************/
+#include "adcwake.h"
+
+/***************************************************************************//**
+ * @brief
+ *   Initialize change detection.
+ *
+ * @param[out] state
+ *   Change detection state.
+ *
+ * @param[in] init
+ *   Configuration, copied.
+ *
+ * @param[in] sample
+ *   First conversion result, giving initial level.
+ ******************************************************************************/
+void ADCWAKE_init(ADCWAKE_State_TypeDef *state,
+                  const ADCWAKE_Init_TypeDef *init,
+                  uint32_t sample)
+{
+  state->init      = *init;
+  state->level     = init->level(sample);
+  state->interval  = init->minInterval;
+  state->reference = sample;
+  state->stable    = 0;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Process conversion result.
+ *
+ * @details
+ *   Updates level and interval to next conversion, state->interval.
+ *
+ * @param[in,out] state
+ *   Change detection state.
+ *
+ * @param[in] sample
+ *   Conversion result.
+ *
+ * @return
+ *   true if level changed, new level in state->level.
+ ******************************************************************************/
+bool ADCWAKE_sample(ADCWAKE_State_TypeDef *state, uint32_t sample)
+{
+  const ADCWAKE_Init_TypeDef *init = &state->init;
+  uint32_t level;
+  uint32_t edge;
+  bool     changed = false;
+
+  /* Level must also differ with result moved hysteresis codes back */
+  level = init->level(sample);
+  if (level > state->level)
+  {
+    edge = sample > init->hysteresis ? sample - init->hysteresis : 0;
+    changed = init->level(edge) > state->level;
+  }
+  else if (level < state->level)
+  {
+    edge = sample + init->hysteresis;
+    if (edge > init->maxSample)
+    {
+      edge = init->maxSample;
+    }
+    changed = init->level(edge) < state->level;
+  }
+
+  if (changed)
+  {
+    state->level = level;
+  }
+
+  /* Back off while stable, return to shortest interval on change */
+  if (!changed &&
+      (sample > state->reference ? sample - state->reference :
+                                   state->reference - sample) <= init->stableDelta)
+  {
+    if (++state->stable >= init->stableCount)
+    {
+      state->stable = 0;
+      state->interval *= 2;
+      if (state->interval > init->maxInterval)
+      {
+        state->interval = init->maxInterval;
+      }
+    }
+  }
+  else
+  {
+    state->interval  = init->minInterval;
+    state->reference = sample;
+    state->stable    = 0;
+  }
+
+  return changed;
+}
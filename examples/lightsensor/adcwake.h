@@ -0,0 +1,104 @@
+/**************************************************************************//**
+ * @file
+ * @brief Change detection for slowly sampled ADC inputs
+ * @author Energy Micro AS
+ * @version 3.20.0
+ ******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 Energy Micro AS, http://www.energymicro.com</b>
+ *******************************************************************************
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ * 4. The source and compiled code may only be used on Energy Micro "EFM32"
+ *    microcontrollers and "EFR4" radios.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: Energy Micro AS has no
+ * obligation to support this Software. Energy Micro AS is providing the
+ * Software "AS IS", with no express or implied warranties of any kind,
+ * including, but not limited to, any implied warranties of merchantability
+ * or fitness for any particular purpose or warranties against infringement
+ * of any proprietary rights of a third party.
+ *
+ * Energy Micro AS will not be liable for any consequential, incidental, or
+ * special damages, or any other relief, or for any claim by any third party,
+ * arising from your use of this Software.
+ *
+ *****************************************************************************/
+#ifndef __ADCWAKE_H
+#define __ADCWAKE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+   Change detection for slowly sampled ADC inputs shown as a level (LED bar),
+   kept free of hardware references so that it can be verified off target.
+
+   Each conversion result is passed to ADCWAKE_sample(), typically from the
+   ADC interrupt handler. It returns true only when the level shown should
+   change, so the application is only woken for an actual update. A level
+   boundary must be passed by hysteresis codes before the level changes,
+   so noise around a boundary does not toggle the level.
+
+   The interval to the next conversion is backed off while the input is
+   stable: after stableCount results within stableDelta codes of the first
+   one, the interval is doubled, up to maxInterval. Any larger change, or a
+   level change, returns to minInterval.
+*/
+
+/** Change detection configuration. */
+typedef struct
+{
+  /** Level shown for a conversion result. */
+  uint32_t (*level)(uint32_t sample);
+  /** Largest conversion result. */
+  uint32_t maxSample;
+  /** Codes a level boundary must be passed by before level changes. */
+  uint32_t hysteresis;
+  /** Largest change in codes considered stable. */
+  uint32_t stableDelta;
+  /** Stable results before interval is doubled. */
+  uint32_t stableCount;
+  /** Shortest interval between conversions, msec. */
+  uint32_t minInterval;
+  /** Longest interval between conversions, msec. */
+  uint32_t maxInterval;
+} ADCWAKE_Init_TypeDef;
+
+/** Change detection state. */
+typedef struct
+{
+  /** Configuration. */
+  ADCWAKE_Init_TypeDef init;
+  /** Level shown. */
+  uint32_t             level;
+  /** Interval to next conversion, msec. */
+  uint32_t             interval;
+  /** First result of stable period. */
+  uint32_t             reference;
+  /** Stable results at current interval. */
+  uint32_t             stable;
+} ADCWAKE_State_TypeDef;
+
+void ADCWAKE_init(ADCWAKE_State_TypeDef *state,
+                  const ADCWAKE_Init_TypeDef *init,
+                  uint32_t sample);
+bool ADCWAKE_sample(ADCWAKE_State_TypeDef *state, uint32_t sample);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,422 @@
+/**************************************************************************//**
+ * @file
+ * @brief Host simulation of ADC change detection sampling
+ * @author Energy Micro AS
+ * @version 3.20.0
+ ******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 Energy Micro AS, http://www.energymicro.com</b>
+ *******************************************************************************
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ * 4. The source and compiled code may only be used on Energy Micro "EFM32"
+ *    microcontrollers and "EFR4" radios.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: Energy Micro AS has no
+ * obligation to support this Software. Energy Micro AS is providing the
+ * Software "AS IS", with no express or implied warranties of any kind,
+ * including, but not limited to, any implied warranties of merchantability
+ * or fitness for any particular purpose or warranties against infringement
+ * of any proprietary rights of a third party.
+ *
+ * Energy Micro AS will not be liable for any consequential, incidental, or
+ * special damages, or any other relief, or for any claim by any third party,
+ * arising from your use of this Software.
+ *
+ *****************************************************************************/
+
+/*
+   Host simulation of change detection sampling (adcwake.c) for the light
+   sensor and potentiometer examples.
+
+   Counts conversions and application wakeups (LED updates) per hour for
+   the previous fixed interval polling, converting and updating LEDs every
+   200 msec (light sensor) or 100 msec (potentiometer), and for change
+   detection. The time the LEDs shown are more than one level off the
+   noise free input is reported for both, along with the longest such
+   period.
+
+   Without arguments, synthetic one hour traces are used:
+   - office: daylight drifting with clouds, lights switched a few times
+   - night:  dark room, only noise
+   - window: fast moving clouds and people passing the sensor
+   - knob:   potentiometer left alone, turned every few minutes
+
+   A recorded trace may be given instead, one conversion result per line
+   sampled every period msec:
+
+     ./adcwakerun light|pot trace.txt period
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "adcwake.h"
+#include "potlut.h"
+
+/** Trace resolution, msec. */
+#define ADCWAKERUN_STEP     10
+/** Steps in one hour. */
+#define ADCWAKERUN_HOUR     (3600000 / ADCWAKERUN_STEP)
+
+/** Trace, noise free input in codes per step. */
+typedef struct
+{
+  const char *name;
+  float      *value;
+  long       steps;
+  double     sigma;
+} ADCWAKERUN_Trace_TypeDef;
+
+/** Example being simulated. */
+typedef struct
+{
+  const char           *name;
+  ADCWAKE_Init_TypeDef init;
+  uint32_t             period;
+} ADCWAKERUN_Example_TypeDef;
+
+/** Random generator state. */
+static uint32_t adcwakerunSeed = 1;
+
+/***************************************************************************//**
+ * @brief
+ *   Uniform random number in [0, 1).
+ ******************************************************************************/
+static double adcwakerunUniform(void)
+{
+  adcwakerunSeed = adcwakerunSeed * 1664525 + 1013904223;
+  return (adcwakerunSeed >> 8) / 16777216.0;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Gaussian random number, zero mean, unit variance.
+ ******************************************************************************/
+static double adcwakerunGauss(void)
+{
+  double u = adcwakerunUniform();
+
+  return sqrt(-2.0 * log(1.0 - u)) * cos(6.283185307179586 * adcwakerunUniform());
+}
+
+/***************************************************************************//**
+ * @brief
+ *   LED level of light sensor example.
+ ******************************************************************************/
+static uint32_t adcwakerunLightLevel(uint32_t sample)
+{
+  uint32_t level = ((sample * 5 / 4) * 16) / 0x3f;
+
+  return level > 16 ? 16 : level;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   LED level of potentiometer example.
+ ******************************************************************************/
+static uint32_t adcwakerunPotLevel(uint32_t sample)
+{
+  return (16 * (POTLUT_ohm(sample, 0) + POTLUT_MAX_OHM / (16 * 2))) / POTLUT_MAX_OHM;
+}
+
+/** Light sensor example, as in lightsensor.c. */
+static const ADCWAKERUN_Example_TypeDef adcwakerunLight =
+{
+  "light", { adcwakerunLightLevel, 0x3f, 1, 1, 4, 200, 3200 }, 200
+};
+
+/** Potentiometer example, as in potentiometer.c. */
+static const ADCWAKERUN_Example_TypeDef adcwakerunPot =
+{
+  "pot", { adcwakerunPotLevel, 0xff, 2, 2, 4, 100, 400 }, 100
+};
+
+/***************************************************************************//**
+ * @brief
+ *   Conversion result at step, noise added, quantized.
+ ******************************************************************************/
+static uint32_t adcwakerunConvert(const ADCWAKERUN_Trace_TypeDef *trace,
+                                  const ADCWAKERUN_Example_TypeDef *ex,
+                                  long step)
+{
+  double v = trace->value[step] + trace->sigma * adcwakerunGauss();
+
+  if (v < 0.0)
+  {
+    return 0;
+  }
+  if (v > ex->init.maxSample)
+  {
+    return ex->init.maxSample;
+  }
+  return (uint32_t)(v + 0.5);
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Simulate trace, fixed interval if fixed is true, else change detection.
+ ******************************************************************************/
+static void adcwakerunSim(const ADCWAKERUN_Trace_TypeDef *trace,
+                          const ADCWAKERUN_Example_TypeDef *ex,
+                          int fixed,
+                          long *conversions,
+                          long *wakeups,
+                          double *offPercent,
+                          long *offLongest)
+{
+  ADCWAKE_State_TypeDef state;
+  uint32_t shown;
+  uint32_t truth;
+  long next;
+  long step;
+  long off = 0;
+  long run = 0;
+
+  adcwakerunSeed = 1;
+  *conversions = 1;
+  *wakeups = 1;
+  *offLongest = 0;
+  ADCWAKE_init(&state, &ex->init, adcwakerunConvert(trace, ex, 0));
+  shown = state.level;
+  next = (fixed ? ex->period : state.interval) / ADCWAKERUN_STEP;
+
+  for (step = 1; step < trace->steps; step++)
+  {
+    if (step == next)
+    {
+      uint32_t sample = adcwakerunConvert(trace, ex, step);
+
+      (*conversions)++;
+      if (fixed)
+      {
+        (*wakeups)++;
+        shown = ex->init.level(sample);
+        next += ex->period / ADCWAKERUN_STEP;
+      }
+      else
+      {
+        if (ADCWAKE_sample(&state, sample))
+        {
+          (*wakeups)++;
+          shown = state.level;
+        }
+        next += state.interval / ADCWAKERUN_STEP;
+      }
+    }
+
+    truth = ex->init.level(trace->value[step] < 0.0 ? 0 :
+                           (uint32_t)(trace->value[step] + 0.5));
+    if (shown > truth + 1 || truth > shown + 1)
+    {
+      off++;
+      if (++run > *offLongest)
+      {
+        *offLongest = run;
+      }
+    }
+    else
+    {
+      run = 0;
+    }
+  }
+
+  /* Per hour */
+  *conversions = (long)((double)*conversions * ADCWAKERUN_HOUR / trace->steps);
+  *wakeups = (long)((double)*wakeups * ADCWAKERUN_HOUR / trace->steps);
+  *offPercent = 100.0 * off / trace->steps;
+  *offLongest *= ADCWAKERUN_STEP;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Simulate and report trace, returns nonzero on failure.
+ ******************************************************************************/
+static int adcwakerunReport(const ADCWAKERUN_Trace_TypeDef *trace,
+                            const ADCWAKERUN_Example_TypeDef *ex)
+{
+  long   conv[2];
+  long   wake[2];
+  double offPercent[2];
+  long   offLongest[2];
+  int    fixed;
+
+  for (fixed = 1; fixed >= 0; fixed--)
+  {
+    adcwakerunSim(trace, ex, fixed, &conv[fixed], &wake[fixed],
+                  &offPercent[fixed], &offLongest[fixed]);
+  }
+
+  printf("%-7s %-6s %6ld %6ld %6.2f %6ld   %6ld %6ld %6.2f %6ld\n",
+         trace->name, ex->name,
+         conv[1], wake[1], offPercent[1], offLongest[1],
+         conv[0], wake[0], offPercent[0], offLongest[0]);
+
+  /* Fewer conversions, not much longer off, off no longer than backoff */
+  return conv[0] > conv[1] ||
+         offPercent[0] > offPercent[1] + 0.5 ||
+         offLongest[0] > (long)(ex->init.maxInterval + ex->init.minInterval);
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Generate synthetic one hour trace.
+ ******************************************************************************/
+static void adcwakerunGenerate(ADCWAKERUN_Trace_TypeDef *trace, const char *name)
+{
+  double base = 0.0;
+  double drift = 0.0;
+  double target = 0.0;
+  double lights = 0.0;
+  long   event = 0;
+  long   ramp = 0;
+  long   step;
+
+  trace->name = name;
+  trace->steps = ADCWAKERUN_HOUR;
+  trace->value = malloc(sizeof(float) * ADCWAKERUN_HOUR);
+  adcwakerunSeed = 12345;
+
+  for (step = 0; step < ADCWAKERUN_HOUR; step++)
+  {
+    double t = (double)step / ADCWAKERUN_HOUR;
+    double v;
+
+    if (!strcmp(name, "office"))
+    {
+      /* Daylight 12-22 codes, slow clouds, lights +15 codes */
+      drift += 0.002 * adcwakerunGauss() - 0.00001 * drift;
+      if (step == event)
+      {
+        lights = lights > 0.0 ? 0.0 : 15.0;
+        event += (long)(ADCWAKERUN_HOUR / 4 * (0.5 + adcwakerunUniform()));
+      }
+      v = 17.0 + 5.0 * sin(6.283185307179586 * t / 3.0) + drift + lights;
+      trace->sigma = 0.5;
+    }
+    else if (!strcmp(name, "night"))
+    {
+      v = 3.0;
+      trace->sigma = 0.3;
+    }
+    else if (!strcmp(name, "window"))
+    {
+      /* Clouds every half minute, people passing for a few seconds */
+      if (step == event)
+      {
+        target = 25.0 + 15.0 * adcwakerunUniform();
+        event += (long)(3000 * (0.5 + adcwakerunUniform()));
+      }
+      base += (target - base) * 0.002;
+      v = base;
+      if ((step % 30000) < 300)
+      {
+        v -= 12.0;
+      }
+      trace->sigma = 0.7;
+    }
+    else
+    {
+      /* Knob turned to a new position over 1.5 seconds every few minutes */
+      if (step == event)
+      {
+        drift = base;
+        target = 255.0 * adcwakerunUniform();
+        ramp = step + 150;
+        event += (long)(36000 * (0.5 + adcwakerunUniform()));
+      }
+      base = step < ramp ? target + (drift - target) * (ramp - step) / 150.0 : target;
+      v = base;
+      trace->sigma = 0.5;
+    }
+    trace->value[step] = (float)v;
+  }
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Read recorded trace, one result per line every period msec.
+ ******************************************************************************/
+static int adcwakerunRead(ADCWAKERUN_Trace_TypeDef *trace,
+                          const char *file,
+                          long period)
+{
+  FILE  *f = fopen(file, "r");
+  double v;
+  long   i;
+  long   size = 0;
+
+  if (!f || period < ADCWAKERUN_STEP)
+  {
+    return -1;
+  }
+  trace->name = "trace";
+  trace->sigma = 0.0;
+  trace->steps = 0;
+  trace->value = NULL;
+  while (fscanf(f, "%lf", &v) == 1)
+  {
+    if (trace->steps + period / ADCWAKERUN_STEP > size)
+    {
+      size = 2 * size + ADCWAKERUN_HOUR;
+      trace->value = realloc(trace->value, sizeof(float) * size);
+    }
+    for (i = 0; i < period / ADCWAKERUN_STEP; i++)
+    {
+      trace->value[trace->steps++] = (float)v;
+    }
+  }
+  fclose(f);
+  return trace->steps ? 0 : -1;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Main function.
+ ******************************************************************************/
+int main(int argc, char *argv[])
+{
+  static const char * const names[] = { "office", "night", "window" };
+  ADCWAKERUN_Trace_TypeDef trace;
+  unsigned int i;
+  int failed = 0;
+
+  printf("                 fixed interval               change detection\n");
+  printf("trace   input    conv   wake  off%%  longest    conv   wake  off%%  longest\n");
+
+  if (argc == 4)
+  {
+    if (adcwakerunRead(&trace, argv[2], atol(argv[3])))
+    {
+      fprintf(stderr, "Cannot read trace %s\n", argv[2]);
+      return 1;
+    }
+    failed = adcwakerunReport(&trace,
+                              strcmp(argv[1], "pot") ? &adcwakerunLight : &adcwakerunPot);
+    free(trace.value);
+  }
+  else
+  {
+    for (i = 0; i < sizeof(names) / sizeof(names[0]); i++)
+    {
+      adcwakerunGenerate(&trace, names[i]);
+      failed |= adcwakerunReport(&trace, &adcwakerunLight);
+      free(trace.value);
+    }
+    adcwakerunGenerate(&trace, "knob");
+    failed |= adcwakerunReport(&trace, &adcwakerunPot);
+    free(trace.value);
+  }
+
+  printf("%s\n", failed ? "FAILED" : "passed");
+  return failed;
+}
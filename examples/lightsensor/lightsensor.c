@@ -45,9 +45,81 @@
 #include "em_emu.h"
 #include "em_cmu.h"
 #include "em_adc.h"
+#include "em_int.h"
 #include "bsp.h"
 #include "bsp_trace.h"
 #include "rtcdrv.h"
+#include "adcwake.h"
+
+/*
+   Instead of converting and updating LEDs at a fixed interval, the light
+   level is sampled with change detection (adcwake.c). The RTC starts each
+   conversion, and the ADC interrupt handler only wakes the main loop for an
+   LED update when the number of LEDs lit changes. While the light level is
+   stable, the interval between conversions is backed off from 200 msec up
+   to 3.2 sec. In between, the core sleeps in EM2, or in EM1 while a
+   conversion is in progress, since the ADC is not clocked in EM2.
+*/
+
+/*******************************************************************************
+ **************************   LOCAL VARIABLES   ********************************
+ ******************************************************************************/
+
+/** Change detection of light level */
+static ADCWAKE_State_TypeDef lightWake;
+
+/** Set by ADC interrupt handler when number of LEDs lit has changed */
+static volatile bool lightChanged;
+
+/** Set while conversion in progress, requiring EM1 */
+static volatile bool lightConverting;
+
+/*******************************************************************************
+ **************************   LOCAL FUNCTIONS   ********************************
+ ******************************************************************************/
+
+/* Local prototypes */
+uint32_t lightLevel(uint32_t sample);
+void lightTrigger(void);
+
+/**************************************************************************//**
+ * @brief Number of LEDs lit for light sensor sample
+ *****************************************************************************/
+uint32_t lightLevel(uint32_t sample)
+{
+  /* Light sensor provides voltage in range 0.1-2V, whereas reference */
+  /* used is 2.5V. So, scale up sample value somewhat. */
+  sample *= 5;
+  sample /= 4;
+  sample = (sample * 16) / 0x3f;
+
+  return sample > 16 ? 16 : sample;
+}
+
+/**************************************************************************//**
+ * @brief RTC callback, start conversion
+ *****************************************************************************/
+void lightTrigger(void)
+{
+  lightConverting = true;
+  ADC_Start(ADC0, adcStartSingle);
+}
+
+/**************************************************************************//**
+ * @brief ADC interrupt handler, conversion complete
+ *****************************************************************************/
+void ADC0_IRQHandler(void)
+{
+  ADC_IntClear(ADC0, ADC_IF_SINGLE);
+  lightConverting = false;
+
+  if (ADCWAKE_sample(&lightWake, ADC_DataSingleGet(ADC0)))
+  {
+    lightChanged = true;
+  }
+
+  RTCDRV_Trigger(lightWake.interval, lightTrigger);
+}
 
 /**************************************************************************//**
  * @brief  Main function
@@ -56,7 +128,8 @@ int main(void)
 {
   ADC_Init_TypeDef init = ADC_INIT_DEFAULT;
   ADC_InitSingle_TypeDef singleInit = ADC_INITSINGLE_DEFAULT;
-  uint32_t sample;
+  ADCWAKE_Init_TypeDef wakeInit;
+  uint32_t level;
 
   /* Chip revision alignment and errata fixes */
   CHIP_Init();
@@ -78,12 +151,12 @@ int main(void)
 
   /* Init common issues for both single conversion and scan mode */
   init.timebase = ADC_TimebaseCalc(0);
-  /* Might as well finish conversion as quickly as possibly since polling */
-  /* for completion. */
+  /* Might as well finish conversion as quickly as possibly, since */
+  /* staying in EM1 until completion. */
   init.prescale = ADC_PrescaleCalc(7000000, 0);
   /* WARMUPMODE must be set to Normal according to ref manual before */
   /* entering EM2. In this example, the warmup time is not a big problem */
-  /* due to relatively infrequent polling. Leave at default NORMAL, */
+  /* due to relatively infrequent conversions. Leave at default NORMAL, */
   ADC_Init(ADC0, &init);
 
   /* Init for single conversion use. */
@@ -96,24 +169,53 @@ int main(void)
   RTCDRV_Trigger(1, NULL);
   EMU_EnterEM2(true);
 
-  /* Main loop - just check potmeter and update LEDs */
+  /* Change detection, see adcwake.h. A boundary between LED levels must */
+  /* be passed by 1 code, stable is within 1 code. */
+  wakeInit.level       = lightLevel;
+  wakeInit.maxSample   = 0x3f;
+  wakeInit.hysteresis  = 1;
+  wakeInit.stableDelta = 1;
+  wakeInit.stableCount = 4;
+  wakeInit.minInterval = 200;
+  wakeInit.maxInterval = 3200;
+
+  /* First conversion polled, giving initial level */
+  ADC_IntClear(ADC0, ADC_IF_SINGLE);
+  ADC_Start(ADC0, adcStartSingle);
+  while (!(ADC_IntGet(ADC0) & ADC_IF_SINGLE));
+  ADCWAKE_init(&lightWake, &wakeInit, ADC_DataSingleGet(ADC0));
+  lightChanged = true;
+
+  /* Further conversions started by RTC, completed in interrupt handler */
+  ADC_IntClear(ADC0, ADC_IF_SINGLE);
+  ADC_IntEnable(ADC0, ADC_IF_SINGLE);
+  NVIC_EnableIRQ(ADC0_IRQn);
+  RTCDRV_Trigger(lightWake.interval, lightTrigger);
+
+  /* Main loop - just update LEDs when level changed */
   while (1)
   {
-    ADC_IntClear(ADC0, ADC_IF_SINGLE);
-    ADC_Start(ADC0, adcStartSingle);
-
-    /* Wait for completion */
-    while (!(ADC_IntGet(ADC0) & ADC_IF_SINGLE));
-    sample = ADC_DataSingleGet(ADC0);
-
-    /* Light sensor provides voltage in range 0.1-2V, whereas reference */
-    /* used is 2.5V. So, scale up sample value somewhat. */
-    sample *= 5;
-    sample /= 4;
-    BSP_LedsSet(((uint16_t)1 << ((sample * 16) / 0x3f)) - 1);
-
-    /* Wait some time before polling again */
-    RTCDRV_Trigger(200, NULL);
-    EMU_EnterEM2(true);
+    /* Interrupts are disabled while checking the flags, so that an */
+    /* interrupt in between still wakes up the core, it is serviced when */
+    /* interrupts are enabled again. */
+    INT_Disable();
+    while (!lightChanged)
+    {
+      if (lightConverting)
+      {
+        EMU_EnterEM1();
+      }
+      else
+      {
+        EMU_EnterEM2(true);
+      }
+      INT_Enable();
+      INT_Disable();
+    }
+    lightChanged = false;
+    level = lightWake.level;
+    INT_Enable();
+
+    BSP_LedsSet((uint16_t)((1 << level) - 1));
   }
 }
@@ -0,0 +1,95 @@
+/**************************************************************************//**
+ * @file
+ * @brief Host generator for potentiometer linearization table
+ * @author Energy Micro AS
+ * @version 3.20.0
+ ******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 Energy Micro AS, http://www.energymicro.com</b>
+ *******************************************************************************
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ * 4. The source and compiled code may only be used on Energy Micro "EFM32"
+ *    microcontrollers and "EFR4" radios.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: Energy Micro AS has no
+ * obligation to support this Software. Energy Micro AS is providing the
+ * Software "AS IS", with no express or implied warranties of any kind,
+ * including, but not limited to, any implied warranties of merchantability
+ * or fitness for any particular purpose or warranties against infringement
+ * of any proprietary rights of a third party.
+ *
+ * Energy Micro AS will not be liable for any consequential, incidental, or
+ * special damages, or any other relief, or for any claim by any third party,
+ * arising from your use of this Software.
+ *
+ *****************************************************************************/
+
+/*
+   Generator for the potentiometer linearization table POTLUT_rpot[] in
+   potlut.c. Writes the table initializer to stdout, regenerate with
+
+     make table
+
+   For each 8 bit code, Rpot = Rpullup * code / (255 - code), rounded to
+   POTLUT_OHM_UNIT ohms, limited to POTLUT_MAX_OHM. Computed in integers
+   only, so the output does not depend on host floating point.
+*/
+
+#include <stdio.h>
+#include <stdint.h>
+#include "potlut.h"
+
+/***************************************************************************//**
+ * @brief
+ *   Table entry of code.
+ ******************************************************************************/
+static uint32_t potlutgenEntry(uint32_t code)
+{
+  uint64_t den;
+  uint64_t entry;
+
+  if (code >= POTLUT_CODES - 1)
+  {
+    return POTLUT_MAX_OHM / POTLUT_OHM_UNIT;
+  }
+
+  den   = (uint64_t)(POTLUT_CODES - 1 - code) * POTLUT_OHM_UNIT;
+  entry = ((uint64_t)POTLUT_PULLUP_OHM * code * 2 + den) / (den * 2);
+  if (entry > POTLUT_MAX_OHM / POTLUT_OHM_UNIT)
+  {
+    entry = POTLUT_MAX_OHM / POTLUT_OHM_UNIT;
+  }
+  return (uint32_t)entry;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Main function.
+ ******************************************************************************/
+int main(void)
+{
+  uint32_t code;
+
+  printf("/* Generated by host/potlutgen.c, do not edit. */\r\n");
+  printf("/* Rpot / %d ohm for 8 bit code 0-255, pullup %d ohm, max %d ohm. */\r\n",
+         POTLUT_OHM_UNIT, POTLUT_PULLUP_OHM, POTLUT_MAX_OHM);
+  for (code = 0; code < POTLUT_CODES; code++)
+  {
+    if (!(code % 8))
+    {
+      printf("  ");
+    }
+    printf("%5lu%s", (unsigned long)potlutgenEntry(code),
+           code == POTLUT_CODES - 1 ? "\r\n" : ((code % 8) == 7 ? ",\r\n" : ", "));
+  }
+  return 0;
+}
@@ -0,0 +1,245 @@
+/**************************************************************************//**
+ * @file
+ * @brief Host runner for potentiometer linearization table
+ * @author Energy Micro AS
+ * @version 3.20.0
+ ******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 Energy Micro AS, http://www.energymicro.com</b>
+ *******************************************************************************
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ * 4. The source and compiled code may only be used on Energy Micro "EFM32"
+ *    microcontrollers and "EFR4" radios.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: Energy Micro AS has no
+ * obligation to support this Software. Energy Micro AS is providing the
+ * Software "AS IS", with no express or implied warranties of any kind,
+ * including, but not limited to, any implied warranties of merchantability
+ * or fitness for any particular purpose or warranties against infringement
+ * of any proprietary rights of a third party.
+ *
+ * Energy Micro AS will not be liable for any consequential, incidental, or
+ * special damages, or any other relief, or for any claim by any third party,
+ * arising from your use of this Software.
+ *
+ *****************************************************************************/
+
+/*
+   Host runner for the potentiometer linearization table (potlut.c).
+
+   Checks POTLUT_ohm() for all 8 bit codes, with and without the rev B
+   errata shift, against Rpot = Rpullup * code / (255 - code) computed in
+   double precision, and the LED levels of potentiometer.c and volume
+   steps of preamp.c derived from it against the previous integer formula
+
+     vpot = (Vdd_mV * sample) / 0xff
+     rpot = (Rpullup * vpot) / (Vdd_mV - vpot)
+
+   where defined (vpot below Vdd). Then times both on the host, as a rough
+   indication only; on the Cortex-M3 the formula costs two UDIV of 2-12
+   cycles each, the table a single LDRH.
+*/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <time.h>
+#include "potlut.h"
+
+#define POTLUTRUN_VDD_mV    3300
+#define POTLUTRUN_ROUNDS    5000
+
+/** Prevents the compiler from folding the timed loops. */
+static volatile uint32_t potlutrunSink;
+
+/** Pseudo random codes 0-254 for timing, code 255 divides by zero in formula */
+static uint8_t potlutrunCodes[POTLUT_CODES * 4];
+
+/***************************************************************************//**
+ * @brief
+ *   Rpot in ohm with previous integer formula, vpot must be below Vdd.
+ ******************************************************************************/
+static uint32_t potlutrunFormula(uint32_t sample)
+{
+  uint32_t vpot;
+  uint32_t rpot;
+
+  vpot = (POTLUTRUN_VDD_mV * sample) / 0xff;
+  rpot = (POTLUT_PULLUP_OHM * vpot) / (POTLUTRUN_VDD_mV - vpot);
+  if (rpot > POTLUT_MAX_OHM)
+  {
+    rpot = POTLUT_MAX_OHM;
+  }
+  return rpot;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Rpot in ohm, exact.
+ ******************************************************************************/
+static double potlutrunExact(uint32_t sample)
+{
+  double rpot;
+
+  if (sample >= POTLUT_CODES - 1)
+  {
+    return POTLUT_MAX_OHM;
+  }
+  rpot = (double)POTLUT_PULLUP_OHM * sample / (POTLUT_CODES - 1 - sample);
+  return rpot > POTLUT_MAX_OHM ? POTLUT_MAX_OHM : rpot;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   LED level of potentiometer.c, 16 LEDs.
+ ******************************************************************************/
+static uint32_t potlutrunLeds(uint32_t rpot)
+{
+  return (16 * (rpot + POTLUT_MAX_OHM / (16 * 2))) / POTLUT_MAX_OHM;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Time in seconds since start.
+ ******************************************************************************/
+static double potlutrunSeconds(const struct timespec *start)
+{
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (now.tv_sec - start->tv_sec) + (now.tv_nsec - start->tv_nsec) * 1e-9;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Main function.
+ ******************************************************************************/
+int main(void)
+{
+  struct timespec start;
+  double tFormula;
+  double tTable;
+  double err;
+  double maxErr = 0.0;
+  uint32_t sample;
+  uint32_t code;
+  uint32_t rpot;
+  uint32_t old;
+  uint32_t formulaMax = 0;
+  uint32_t ledDiff = 0;
+  uint32_t stepDiff = 0;
+  uint32_t defined = 0;
+  uint32_t sum;
+  int shift;
+  int round;
+  int failed = 0;
+
+  for (shift = 0; shift <= 1; shift++)
+  {
+    for (sample = 0; sample < (uint32_t)(POTLUT_CODES >> shift); sample++)
+    {
+      code = sample << shift;
+      rpot = POTLUT_ohm(sample, shift);
+
+      /* Against exact Rpot, at most half a table unit off */
+      err = rpot - potlutrunExact(code);
+      if (err < 0.0)
+      {
+        err = -err;
+      }
+      if (err > maxErr)
+      {
+        maxErr = err;
+      }
+
+      /* Against previous formula, where it does not divide by zero */
+      if ((POTLUTRUN_VDD_mV * code) / 0xff < POTLUTRUN_VDD_mV)
+      {
+        old = potlutrunFormula(code);
+        defined++;
+        if (old > rpot ? old - rpot > formulaMax : rpot - old > formulaMax)
+        {
+          formulaMax = old > rpot ? old - rpot : rpot - old;
+        }
+        if (potlutrunLeds(old) != potlutrunLeds(rpot))
+        {
+          ledDiff++;
+        }
+        if (old / 1000 != rpot / 1000)
+        {
+          stepDiff++;
+        }
+      }
+    }
+  }
+
+  /* Codes at and above the errata limit must give max */
+  for (sample = POTLUT_CODES >> 1; sample < POTLUT_CODES; sample++)
+  {
+    if (POTLUT_ohm(sample, 1) != POTLUT_MAX_OHM)
+    {
+      failed = 1;
+    }
+  }
+  if (POTLUT_ohm(POTLUT_CODES - 1, 0) != POTLUT_MAX_OHM || POTLUT_ohm(0, 0) != 0)
+  {
+    failed = 1;
+  }
+  if (maxErr > POTLUT_OHM_UNIT / 2.0)
+  {
+    failed = 1;
+  }
+
+  printf("table vs exact: max error %.3f ohm\n", maxErr);
+  printf("table vs formula: %lu codes, max difference %lu ohm, "
+         "%lu LED levels and %lu volume steps differ\n",
+         (unsigned long)defined, (unsigned long)formulaMax,
+         (unsigned long)ledDiff, (unsigned long)stepDiff);
+
+  /* Timing */
+  sum = 12345;
+  for (sample = 0; sample < sizeof(potlutrunCodes); sample++)
+  {
+    sum = sum * 1103515245 + 12345;
+    potlutrunCodes[sample] = (uint8_t)(((sum >> 16) & 0xff) % (POTLUT_CODES - 1));
+  }
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  sum = 0;
+  for (round = 0; round < POTLUTRUN_ROUNDS; round++)
+  {
+    for (sample = 0; sample < sizeof(potlutrunCodes); sample++)
+    {
+      sum += potlutrunFormula(potlutrunCodes[sample]);
+    }
+  }
+  potlutrunSink = sum;
+  tFormula = potlutrunSeconds(&start);
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  sum = 0;
+  for (round = 0; round < POTLUTRUN_ROUNDS; round++)
+  {
+    for (sample = 0; sample < sizeof(potlutrunCodes); sample++)
+    {
+      sum += POTLUT_ohm(potlutrunCodes[sample], 0);
+    }
+  }
+  potlutrunSink = sum;
+  tTable = potlutrunSeconds(&start);
+
+  printf("formula %.2f ns, table %.2f ns per reading\n",
+         tFormula * 1e9 / (POTLUTRUN_ROUNDS * sizeof(potlutrunCodes)),
+         tTable * 1e9 / (POTLUTRUN_ROUNDS * sizeof(potlutrunCodes)));
+
+  printf("%s\n", failed ? "FAILED" : "passed");
+  return failed;
+}
@@ -50,14 +50,89 @@
 #include "em_cmu.h"
 #include "em_adc.h"
 #include "em_system.h"
+#include "em_int.h"
 #include "bsp.h"
 #include "bsp_trace.h"
 #include "rtcdrv.h"
+#include "potlut.h"
+#include "adcwake.h"
 
-/* Defines according to DVK design */
-#define POTENTIOMETER_PULLUP_OHM 10000
-#define POTENTIOMETER_MAX_OHM    100000
-#define POTENTIOMETER_VDD_mV     3300
+/*
+   Instead of converting and updating LEDs at a fixed interval, the
+   potentiometer is sampled with change detection (adcwake.c, from the
+   lightsensor example). The RTC starts each conversion, and the ADC
+   interrupt handler only wakes the main loop for an LED update when the
+   number of LEDs lit changes. While the potentiometer is left alone, the
+   interval between conversions is backed off from 100 to 400 msec. In
+   between, the core sleeps in EM2, or in EM1 while a conversion is in
+   progress, since the ADC is not clocked in EM2.
+*/
+
+/*******************************************************************************
+ **************************   LOCAL VARIABLES   ********************************
+ ******************************************************************************/
+
+/** EFM32 rev B ADC errata; when using VDD as reference, need to multiply by 2 */
+static int potErrataShift;
+
+/** Change detection of potentiometer setting */
+static ADCWAKE_State_TypeDef potWake;
+
+/** Set by ADC interrupt handler when number of LEDs lit has changed */
+static volatile bool potChanged;
+
+/** Set while conversion in progress, requiring EM1 */
+static volatile bool potConverting;
+
+/*******************************************************************************
+ **************************   LOCAL FUNCTIONS   ********************************
+ ******************************************************************************/
+
+/* Local prototypes */
+uint32_t potLevel(uint32_t sample);
+void potTrigger(void);
+
+/**************************************************************************//**
+ * @brief Number of LEDs lit for potentiometer sample
+ *****************************************************************************/
+uint32_t potLevel(uint32_t sample)
+{
+  uint32_t rpot;
+
+  /* Rpot is linear with respect to pot meter position, while the */
+  /* sampled voltage is not, see potlut.h. */
+  rpot = POTLUT_ohm(sample, potErrataShift);
+
+  /* We have 16 LEDs, add half interval for improving rounding effects. */
+  rpot += (POTLUT_MAX_OHM / (16 * 2));
+
+  return (16 * rpot) / POTLUT_MAX_OHM;
+}
+
+/**************************************************************************//**
+ * @brief RTC callback, start conversion
+ *****************************************************************************/
+void potTrigger(void)
+{
+  potConverting = true;
+  ADC_Start(ADC0, adcStartSingle);
+}
+
+/**************************************************************************//**
+ * @brief ADC interrupt handler, conversion complete
+ *****************************************************************************/
+void ADC0_IRQHandler(void)
+{
+  ADC_IntClear(ADC0, ADC_IF_SINGLE);
+  potConverting = false;
+
+  if (ADCWAKE_sample(&potWake, ADC_DataSingleGet(ADC0)))
+  {
+    potChanged = true;
+  }
+
+  RTCDRV_Trigger(potWake.interval, potTrigger);
+}
 
 /**************************************************************************//**
  * @brief  Main function
@@ -66,11 +141,9 @@ int main(void)
 {
   ADC_Init_TypeDef init = ADC_INIT_DEFAULT;
   ADC_InitSingle_TypeDef singleInit = ADC_INITSINGLE_DEFAULT;
-  uint32_t sample;
-  uint32_t vpot;
-  uint32_t rpot;
+  ADCWAKE_Init_TypeDef wakeInit;
   SYSTEM_ChipRevision_TypeDef chipRev;
-  int errataShift = 0;
+  uint32_t level;
 
   /* Chip revision alignment and errata fixes */
   CHIP_Init();
@@ -80,7 +153,7 @@ int main(void)
   SYSTEM_ChipRevisionGet(&chipRev);
   if ((chipRev.major == 1) && (chipRev.minor == 1))
   {
-    errataShift = 1;
+    potErrataShift = 1;
   }
 
   /* Initialize DVK board register access */
@@ -100,12 +173,12 @@ int main(void)
 
   /* Init common issues for both single conversion and scan mode */
   init.timebase = ADC_TimebaseCalc(0);
-  /* Might as well finish conversion as quickly as possibly since polling */
-  /* for completion. */
+  /* Might as well finish conversion as quickly as possibly, since */
+  /* staying in EM1 until completion. */
   init.prescale = ADC_PrescaleCalc(7000000, 0);
   /* WARMUPMODE must be set to Normal according to ref manual before */
   /* entering EM2. In this example, the warmup time is not a big problem */
-  /* due to relatively infrequent polling. Leave at default NORMAL, */
+  /* due to relatively infrequent conversions. Leave at default NORMAL, */
   ADC_Init(ADC0, &init);
 
   /* Init for single conversion use. */
@@ -118,59 +191,53 @@ int main(void)
   RTCDRV_Trigger(1, NULL);
   EMU_EnterEM2(true);
 
-  /* Main loop - just check potentiometer and update LEDs */
+  /* Change detection, see adcwake.h. A boundary between LED levels must */
+  /* be passed by 2 codes, stable is within 2 codes. */
+  wakeInit.level       = potLevel;
+  wakeInit.maxSample   = 0xff;
+  wakeInit.hysteresis  = 2;
+  wakeInit.stableDelta = 2;
+  wakeInit.stableCount = 4;
+  wakeInit.minInterval = 100;
+  wakeInit.maxInterval = 400;
+
+  /* First conversion polled, giving initial level */
+  ADC_IntClear(ADC0, ADC_IF_SINGLE);
+  ADC_Start(ADC0, adcStartSingle);
+  while (!(ADC_IntGet(ADC0) & ADC_IF_SINGLE));
+  ADCWAKE_init(&potWake, &wakeInit, ADC_DataSingleGet(ADC0));
+  potChanged = true;
+
+  /* Further conversions started by RTC, completed in interrupt handler */
+  ADC_IntClear(ADC0, ADC_IF_SINGLE);
+  ADC_IntEnable(ADC0, ADC_IF_SINGLE);
+  NVIC_EnableIRQ(ADC0_IRQn);
+  RTCDRV_Trigger(potWake.interval, potTrigger);
+
+  /* Main loop - just update LEDs when level changed */
   while (1)
   {
-    ADC_IntClear(ADC0, ADC_IF_SINGLE);
-    ADC_Start(ADC0, adcStartSingle);
-
-    /* Wait for completion */
-    while (!(ADC_IntGet(ADC0) & ADC_IF_SINGLE));
-    sample = ADC_DataSingleGet(ADC0) << errataShift;
-
-    /*
-      DVK potentiometer design:
-
-               | Vdd = 3.3V
-              +-+
-              | | Rpullup = 10kOhm
-              +-+
-               |
-               +------> Vpot (to ADC)
-               |
-              +-+
-              | | Rpot = 0-100kOhm
-              +-+
-               | Gnd
-
-       Vpot = Rpot * Vdd / (Rpullup + Rpot)
-
-       This gives a non-linear voltage level measured by ADC with respect to
-       pot meter position. In order to determine the actual Rpot setting, which
-       is linear with respect to position, rewrite the above formula to:
-
-       Rpot = Rpullup * Vpot / (Vdd - Vpot)
-    */
-
-    /* Vpot sampled with 8 bit, divide by max value */
-    vpot = (POTENTIOMETER_VDD_mV * sample) / 0xff;
-
-    /* Calculate Rpot determining volume */
-    rpot = (POTENTIOMETER_PULLUP_OHM * vpot) / (POTENTIOMETER_VDD_mV - vpot);
-    /* The potentiometer may not be exact in upper range, make sure we don't use a higher */
-    /* value than assumed by defines. */
-    if (rpot > POTENTIOMETER_MAX_OHM)
+    /* Interrupts are disabled while checking the flags, so that an */
+    /* interrupt in between still wakes up the core, it is serviced when */
+    /* interrupts are enabled again. */
+    INT_Disable();
+    while (!potChanged)
     {
-      rpot = POTENTIOMETER_MAX_OHM;
+      if (potConverting)
+      {
+        EMU_EnterEM1();
+      }
+      else
+      {
+        EMU_EnterEM2(true);
+      }
+      INT_Enable();
+      INT_Disable();
     }
+    potChanged = false;
+    level = potWake.level;
+    INT_Enable();
 
-    /* We have 16 LEDs, add half interval for improving rounding effects. */
-    rpot += (POTENTIOMETER_MAX_OHM / (16 * 2));
-
-    BSP_LedsSet((uint16_t)((1 << ((16 * rpot) / POTENTIOMETER_MAX_OHM)) - 1));
-
-    /* Wait some time before polling again */
-    RTCDRV_Trigger(100, NULL);
-    EMU_EnterEM2(true);
+    BSP_LedsSet((uint16_t)((1 << level) - 1));
   }
 }
@@ -0,0 +1,64 @@
+/**************************************************************************//**
+ * @file
+ * @brief Potentiometer linearization by table lookup
+ * @author Energy Micro AS
+ * @version 3.20.0
+ ******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 Energy Micro AS, http://www.energymicro.com</b>
+ *******************************************************************************
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ * 4. The source and compiled code may only be used on Energy Micro "EFM32"
+ *    microcontrollers and "EFR4" radios.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: Energy Micro AS has no
+ * obligation to support this Software. Energy Micro AS is providing the
+ * Software "AS IS", with no express or implied warranties of any kind,
+ * including, but not limited to, any implied warranties of merchantability
+ * or fitness for any particular purpose or warranties against infringement
+ * of any proprietary rights of a third party.
+ *
+ * Energy Micro AS will not be liable for any consequential, incidental, or
+ * special damages, or any other relief, or for any claim by any third party,
+ * arising from your use of this Software.
+ *
+ *****************************************************************************/
+#include "potlut.h"
+
+/** Rpot per 8 bit ADC code, POTLUT_OHM_UNIT ohms, see host/potlutgen.c. */
+const uint16_t POTLUT_rpot[POTLUT_CODES] =
+{
+#include "potluttable.h"
+};
+
+/***************************************************************************//**
+ * @brief
+ *   Potentiometer resistance of ADC sample.
+ *
+ * @param[in] sample
+ *   8 bit ADC sample of potentiometer, Vdd reference.
+ *
+ * @param[in] errataShift
+ *   1 on rev B devices, where the ADC result must be multiplied by 2, else 0.
+ *
+ * @return
+ *   Rpot in ohm, 0 to POTLUT_MAX_OHM.
+ ******************************************************************************/
+uint32_t POTLUT_ohm(uint32_t sample, int errataShift)
+{
+  sample <<= errataShift;
+  if (sample >= POTLUT_CODES)
+  {
+    sample = POTLUT_CODES - 1;
+  }
+  return POTLUT_rpot[sample] * POTLUT_OHM_UNIT;
+}
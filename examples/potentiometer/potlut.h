@@ -0,0 +1,94 @@
+/**************************************************************************//**
+ * @file
+ * @brief Potentiometer linearization by table lookup
+ * @author Energy Micro AS
+ * @version 3.20.0
+ ******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 Energy Micro AS, http://www.energymicro.com</b>
+ *******************************************************************************
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ * 4. The source and compiled code may only be used on Energy Micro "EFM32"
+ *    microcontrollers and "EFR4" radios.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: Energy Micro AS has no
+ * obligation to support this Software. Energy Micro AS is providing the
+ * Software "AS IS", with no express or implied warranties of any kind,
+ * including, but not limited to, any implied warranties of merchantability
+ * or fitness for any particular purpose or warranties against infringement
+ * of any proprietary rights of a third party.
+ *
+ * Energy Micro AS will not be liable for any consequential, incidental, or
+ * special damages, or any other relief, or for any claim by any third party,
+ * arising from your use of this Software.
+ *
+ *****************************************************************************/
+#ifndef __POTLUT_H
+#define __POTLUT_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+   Linearization of the DVK potentiometer by table lookup.
+
+   DVK potentiometer design:
+
+            | Vdd = 3.3V
+           +-+
+           | | Rpullup = 10kOhm
+           +-+
+            |
+            +------> Vpot (to ADC)
+            |
+           +-+
+           | | Rpot = 0-100kOhm
+           +-+
+            | Gnd
+
+   Vpot = Rpot * Vdd / (Rpullup + Rpot), which is non-linear with respect to
+   pot meter position, while Rpot is linear. With Vpot sampled with 8 bit
+   resolution and Vdd as reference, code = 255 * Vpot / Vdd, so
+
+     Rpot = Rpullup * Vpot / (Vdd - Vpot) = Rpullup * code / (255 - code)
+
+   independent of Vdd. POTLUT_rpot[] holds Rpot for each code, rounded to
+   POTLUT_OHM_UNIT ohms and limited to POTLUT_MAX_OHM, so a reading is one
+   table lookup instead of two divisions. Code 255 (Vpot at Vdd) gives
+   POTLUT_MAX_OHM. The table is generated by host/potlutgen.c into
+   potluttable.h.
+
+   On rev B devices the ADC result with Vdd reference must be multiplied
+   by 2 (errata), codes of 128 and above then give POTLUT_MAX_OHM.
+*/
+
+/** Pull-up resistor in ohm. */
+#define POTLUT_PULLUP_OHM   10000
+/** Potentiometer, max value. */
+#define POTLUT_MAX_OHM      100000
+/** Ohm per table unit, so that POTLUT_MAX_OHM fits in 16 bits. */
+#define POTLUT_OHM_UNIT     2
+/** Number of codes, 8 bit ADC resolution. */
+#define POTLUT_CODES        256
+
+extern const uint16_t POTLUT_rpot[POTLUT_CODES];
+
+uint32_t POTLUT_ohm(uint32_t sample, int errataShift);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
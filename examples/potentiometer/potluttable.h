@@ -0,0 +1,34 @@
+/* Generated by host/potlutgen.c, do not edit. */
+/* Rpot / 2 ohm for 8 bit code 0-255, pullup 10000 ohm, max 100000 ohm. */
+      0,    20,    40,    60,    80,   100,   120,   141,
+    162,   183,   204,   225,   247,   269,   290,   313,
+    335,   357,   380,   403,   426,   449,   472,   496,
+    519,   543,   568,   592,   617,   642,   667,   692,
+    717,   743,   769,   795,   822,   849,   876,   903,
+    930,   958,   986,  1014,  1043,  1071,  1100,  1130,
+   1159,  1189,  1220,  1250,  1281,  1312,  1343,  1375,
+   1407,  1439,  1472,  1505,  1538,  1572,  1606,  1641,
+   1675,  1711,  1746,  1782,  1818,  1855,  1892,  1929,
+   1967,  2005,  2044,  2083,  2123,  2163,  2203,  2244,
+   2286,  2328,  2370,  2413,  2456,  2500,  2544,  2589,
+   2635,  2681,  2727,  2774,  2822,  2870,  2919,  2969,
+   3019,  3070,  3121,  3173,  3226,  3279,  3333,  3388,
+   3444,  3500,  3557,  3615,  3673,  3733,  3793,  3854,
+   3916,  3979,  4043,  4107,  4173,  4239,  4307,  4375,
+   4444,  4515,  4586,  4659,  4733,  4808,  4884,  4961,
+   5039,  5119,  5200,  5282,  5366,  5451,  5537,  5625,
+   5714,  5805,  5897,  5991,  6087,  6184,  6283,  6384,
+   6486,  6591,  6697,  6806,  6916,  7028,  7143,  7260,
+   7379,  7500,  7624,  7750,  7879,  8010,  8144,  8281,
+   8421,  8564,  8710,  8859,  9011,  9167,  9326,  9489,
+   9655,  9826, 10000, 10179, 10361, 10549, 10741, 10938,
+  11139, 11346, 11558, 11776, 12000, 12230, 12466, 12708,
+  12958, 13214, 13478, 13750, 14030, 14318, 14615, 14922,
+  15238, 15565, 15902, 16250, 16610, 16983, 17368, 17768,
+  18182, 18611, 19057, 19519, 20000, 20500, 21020, 21563,
+  22128, 22717, 23333, 23977, 24651, 25357, 26098, 26875,
+  27692, 28553, 29459, 30417, 31429, 32500, 33636, 34844,
+  36129, 37500, 38966, 40536, 42222, 44038, 46000, 48125,
+  50000, 50000, 50000, 50000, 50000, 50000, 50000, 50000,
+  50000, 50000, 50000, 50000, 50000, 50000, 50000, 50000,
+  50000, 50000, 50000, 50000, 50000, 50000, 50000, 50000
@@ -40,6 +40,8 @@
 #include "em_wdog.h"
 #include "rtcdrv.h"
 #include "bsp_trace.h"
+/* Clock and energy mode trace, when built with ETRACE_ENABLE */
+#include "etrace.h"
 
 /** Counts 1ms timeTicks */
 volatile uint32_t msTicks;
@@ -91,6 +93,9 @@ int main(void)
   /* If first word of user data page is non-zero, enable eA Profiler trace */
   BSP_TraceProfilerSetup();
 
+  /* Start recording clock and energy mode transitions */
+  ETRACE_init();
+
   /* Watchdog setup - Use defaults, excepts for these :*/
   wInit.em2Run = true;
   wInit.em3Run = true;
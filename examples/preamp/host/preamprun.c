@@ -0,0 +1,297 @@
+/**************************************************************************//**
+ * @file
+ * @brief Host (Linux) command line runner for preamp audio processing
+ * @author Energy Micro AS
+ * @version 3.20.0
+ ******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 Energy Micro AS, http://www.energymicro.com</b>
+ *******************************************************************************
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ * 4. The source and compiled code may only be used on Energy Micro "EFM32"
+ *    microcontrollers and "EFR4" radios.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: Energy Micro AS has no
+ * obligation to support this Software. Energy Micro AS is providing the
+ * Software "AS IS", with no express or implied warranties of any kind,
+ * including, but not limited to, any implied warranties of merchantability
+ * or fitness for any particular purpose or warranties against infringement
+ * of any proprietary rights of a third party.
+ *
+ * Energy Micro AS will not be liable for any consequential, incidental, or
+ * special damages, or any other relief, or for any claim by any third party,
+ * arising from your use of this Software.
+ *
+ *****************************************************************************/
+
+/*
+   Off-target runner for the preamp audio processing (preampdsp.c).
+
+   Reads a 16 bit PCM WAV file (mono or stereo), converts it to 12 bit ADC
+   codes as delivered by ADC0 scan mode, runs it through PREAMPDSP_process()
+   in blocks of PREAMP_AUDIO_BUFFER_SIZE frames, and writes the unpacked DAC
+   COMBDATA words back as a 16 bit stereo WAV file. Processing throughput is
+   reported in frames per second.
+
+   Usage: preamprun <in.wav> <out.wav> [volume 0-100] [repeat]
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include "preampdsp.h"
+
+/** Number of frames processed per call, same as on target. */
+#define PREAMP_AUDIO_BUFFER_SIZE    64
+
+/** WAV format information needed by runner. */
+typedef struct
+{
+  uint16_t channels;
+  uint32_t sampleRate;
+  uint32_t frames;
+} WAV_Info_TypeDef;
+
+/***************************************************************************//**
+ * @brief Read little endian 16/32 bit value from byte buffer.
+ ******************************************************************************/
+static uint32_t rdLE(const uint8_t *p, int bytes)
+{
+  uint32_t v = 0;
+  while (bytes--)
+  {
+    v = (v << 8) | p[bytes];
+  }
+  return v;
+}
+
+/***************************************************************************//**
+ * @brief Write little endian 16/32 bit value to file.
+ ******************************************************************************/
+static void wrLE(FILE *f, uint32_t v, int bytes)
+{
+  while (bytes--)
+  {
+    fputc((int)(v & 0xff), f);
+    v >>= 8;
+  }
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Locate format and data chunk of a 16 bit PCM WAV file. On success, file
+ *   position is at start of sample data.
+ ******************************************************************************/
+static int wavOpen(FILE *f, WAV_Info_TypeDef *info)
+{
+  uint8_t  hdr[16];
+  uint32_t size;
+  int      haveFmt = 0;
+
+  if ((fread(hdr, 1, 12, f) != 12) ||
+      memcmp(hdr, "RIFF", 4) || memcmp(hdr + 8, "WAVE", 4))
+  {
+    return -1;
+  }
+
+  while (fread(hdr, 1, 8, f) == 8)
+  {
+    size = rdLE(hdr + 4, 4);
+    if (!memcmp(hdr, "fmt ", 4))
+    {
+      if ((size < 16) || (fread(hdr, 1, 16, f) != 16))
+      {
+        return -1;
+      }
+      /* Only PCM, 16 bit, mono/stereo supported */
+      if ((rdLE(hdr, 2) != 1) || (rdLE(hdr + 14, 2) != 16))
+      {
+        return -1;
+      }
+      info->channels   = (uint16_t)rdLE(hdr + 2, 2);
+      info->sampleRate = rdLE(hdr + 4, 4);
+      if ((info->channels < 1) || (info->channels > 2))
+      {
+        return -1;
+      }
+      haveFmt = 1;
+      fseek(f, (long)(size - 16 + (size & 1)), SEEK_CUR);
+    }
+    else if (!memcmp(hdr, "data", 4))
+    {
+      if (!haveFmt)
+      {
+        return -1;
+      }
+      info->frames = size / (2 * info->channels);
+      return 0;
+    }
+    else
+    {
+      fseek(f, (long)(size + (size & 1)), SEEK_CUR);
+    }
+  }
+
+  return -1;
+}
+
+/***************************************************************************//**
+ * @brief Write a 16 bit stereo PCM WAV header.
+ ******************************************************************************/
+static void wavWriteHeader(FILE *f, uint32_t sampleRate, uint32_t frames)
+{
+  uint32_t dataSize = frames * 4;
+
+  fwrite("RIFF", 1, 4, f);
+  wrLE(f, 36 + dataSize, 4);
+  fwrite("WAVEfmt ", 1, 8, f);
+  wrLE(f, 16, 4);
+  wrLE(f, 1, 2);               /* PCM */
+  wrLE(f, 2, 2);               /* Stereo */
+  wrLE(f, sampleRate, 4);
+  wrLE(f, sampleRate * 4, 4);  /* Byte rate */
+  wrLE(f, 4, 2);               /* Block align */
+  wrLE(f, 16, 2);              /* Bits per sample */
+  fwrite("data", 1, 4, f);
+  wrLE(f, dataSize, 4);
+}
+
+/***************************************************************************//**
+ * @brief Convert DAC output code to signed 16 bit PCM sample.
+ ******************************************************************************/
+static int16_t dacToPcm(uint32_t code)
+{
+  int32_t v = (int32_t)code - (PREAMPDSP_OUTPUT_RANGE / 2);
+
+  return (int16_t)((v * 32767) / (PREAMPDSP_OUTPUT_RANGE / 2));
+}
+
+int main(int argc, char **argv)
+{
+  PREAMPDSP_State_TypeDef state;
+  WAV_Info_TypeDef        info;
+  FILE                    *fin;
+  FILE                    *fout;
+  uint16_t                *in;
+  uint32_t                *out;
+  uint8_t                 *raw;
+  uint32_t                volume = PREAMPDSP_GAIN_DIVISOR;
+  uint32_t                frames;
+  uint32_t                i;
+  int                     repeat = 1;
+  int                     r;
+  int                     clipped = 0;
+  struct timespec         t0;
+  struct timespec         t1;
+  double                  secs;
+
+  if (argc < 3)
+  {
+    fprintf(stderr, "Usage: %s <in.wav> <out.wav> [volume 0-100] [repeat]\n", argv[0]);
+    return 1;
+  }
+  if (argc > 3)
+  {
+    volume = (uint32_t)strtoul(argv[3], NULL, 0);
+  }
+  if (argc > 4)
+  {
+    repeat = atoi(argv[4]);
+    if (repeat < 1)
+    {
+      repeat = 1;
+    }
+  }
+
+  memset(&info, 0, sizeof(info));
+  fin = fopen(argv[1], "rb");
+  if (!fin || wavOpen(fin, &info))
+  {
+    fprintf(stderr, "Unable to read 16 bit PCM WAV file %s\n", argv[1]);
+    return 1;
+  }
+
+  /* Round up to whole processing blocks, padding with silence */
+  frames = ((info.frames + PREAMP_AUDIO_BUFFER_SIZE - 1) / PREAMP_AUDIO_BUFFER_SIZE) *
+           PREAMP_AUDIO_BUFFER_SIZE;
+  raw = malloc((size_t)info.frames * info.channels * 2);
+  in  = malloc((size_t)frames * 2 * sizeof(uint16_t));
+  out = calloc(frames, sizeof(uint32_t));
+  if (!raw || !in || !out)
+  {
+    fprintf(stderr, "Out of memory\n");
+    return 1;
+  }
+  info.frames = (uint32_t)fread(raw, (size_t)info.channels * 2, info.frames, fin);
+  fclose(fin);
+
+  /* Convert to interleaved right/left 12 bit unsigned ADC codes */
+  for (i = 0; i < frames; i++)
+  {
+    int32_t left  = 0;
+    int32_t right = 0;
+
+    if (i < info.frames)
+    {
+      left  = (int16_t)rdLE(raw + (i * info.channels * 2), 2);
+      right = (info.channels == 2) ? (int16_t)rdLE(raw + (i * 4) + 2, 2) : left;
+    }
+    in[(i * 2)]     = (uint16_t)((right + 32768) >> 4);
+    in[(i * 2) + 1] = (uint16_t)((left + 32768) >> 4);
+  }
+
+  /* Process, timing only the DSP itself */
+  clock_gettime(CLOCK_MONOTONIC, &t0);
+  for (r = 0; r < repeat; r++)
+  {
+    PREAMPDSP_init(&state, 0);
+    for (i = 0; i < frames; i += PREAMP_AUDIO_BUFFER_SIZE)
+    {
+      if (PREAMPDSP_process(&state, in + (i * 2), out + i,
+                            PREAMP_AUDIO_BUFFER_SIZE, volume))
+      {
+        clipped++;
+      }
+    }
+  }
+  clock_gettime(CLOCK_MONOTONIC, &t1);
+  secs = (double)(t1.tv_sec - t0.tv_sec) + ((double)(t1.tv_nsec - t0.tv_nsec) / 1e9);
+
+  fout = fopen(argv[2], "wb");
+  if (!fout)
+  {
+    fprintf(stderr, "Unable to create %s\n", argv[2]);
+    return 1;
+  }
+  wavWriteHeader(fout, info.sampleRate, info.frames);
+  for (i = 0; i < info.frames; i++)
+  {
+    wrLE(fout, (uint16_t)dacToPcm(out[i] >> 16), 2);     /* Left */
+    wrLE(fout, (uint16_t)dacToPcm(out[i] & 0xffff), 2);  /* Right */
+  }
+  fclose(fout);
+
+  printf("frames:         %lu x %d\n", (unsigned long)frames, repeat);
+  printf("clipped blocks: %d\n", clipped / repeat);
+  printf("time:           %.6f s\n", secs);
+  printf("throughput:     %.0f frames/s (%.1f x realtime at %lu Hz)\n",
+         secs > 0 ? ((double)frames * repeat) / secs : 0.0,
+         (secs > 0) && info.sampleRate ? ((double)frames * repeat) / (secs * info.sampleRate) : 0.0,
+         (unsigned long)info.sampleRate);
+
+  free(raw);
+  free(in);
+  free(out);
+  return 0;
+}
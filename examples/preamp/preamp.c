@@ -65,6 +65,8 @@
 #include "em_dma.h"
 #include "dmactrl.h"
 #include "rtcdrv.h"
+#include "preampdsp.h"
+#include "potlut.h"
 
 /*
    Audio in/out handling:
@@ -166,19 +168,11 @@
  *******************************   DEFINES   ***********************************
  ******************************************************************************/
 
-/* Defines according to DVK design */
-/** Pull-up resistor in ohm. */
-#define POTENTIOMETER_PULLUP_OHM      10000
-/** Potentiometer, max value. */
-#define POTENTIOMETER_MAX_OHM         100000
 /**
- * Voltage applied over pullup and potentiometer. (Notice that this voltage is
- * actually adjustable on the DVK, we assume default value.) If changed, the only
- * consequence is slightly different volume levels measured.
+ * Rpot adjustment done, allowing for 100 volume steps if Rpot max is 100kOhm.
+ * (POTLUT_MAX_OHM / PREAMP_ADJUST_DIVISOR must equal
+ * PREAMPDSP_GAIN_DIVISOR.)
  */
-#define POTENTIOMETER_VDD_mV          3300
-
-/** Rpot adjustment done, allowing for 100 volume steps if Rpot max is 100kOhm */
 #define PREAMP_ADJUST_DIVISOR         1000
 
 /**
@@ -238,6 +232,9 @@ static DMA_CB_TypeDef cbOutData;
 /** EFM32 rev B ADC errata; when using VDD as reference, need to multiply by 2 */
 static int preampErrataShift;
 
+/** Audio processing state (DC offset measurement) used by PendSV handler */
+static PREAMPDSP_State_TypeDef preampDsp;
+
 /* Counters used to monitor IRQ handling, they should all be equal. If */
 /* preampMonProcessCount falls behind, it is an indication that the */
 /* system is unable to process incoming data with sufficient speed, and */
@@ -312,35 +309,10 @@ static void preampDMAOutCb(unsigned int channel, bool primary, void *user)
  *******************************************************************************/
 void PendSV_Handler(void)
 {
-  /* Define max DAC output value, clipping is done if audio-out signal is outside */
-  /* defined range. This is partly to limit max output volume, and partly to */
-  /* add as low DC offset to DAC output as possible. A smaller DC offset reduces */
-  /* the startup crack sound, although that could be avoided by more advanced */
-  /* init features. */
-  #define OUTPUT_RANGE       0xA0
-
-  /**
-   * Need to figure out average DC component in input signal (appr 1.65V
-   * according to DVK design), since DC offset needs to be removed before adjusting
-   * volume. If adjusting directly on input signal including DC offset, one would
-   * also scale (the significant) DC offset, causing sharp transissions (and audio
-   * out cracking noise) when adjusting volume. We only sample DC once during startup,
-   * one could make more advanced monitoring features.
-   */
-  #define SAMPLE_DC_OFFSET_COUNT 2048
-  static uint32_t dcOffsetSampleCount;
-  static uint32_t dcAccRight;
-  static uint32_t dcAccLeft;
-  static uint32_t dcRight;
-  static uint32_t dcLeft;
-
   static uint32_t volumeSampleCount;
 
   uint16_t *inBuf;
   uint32_t *outBuf;
-  int32_t right;
-  int32_t left;
-  int i;
 
   preampMonProcessCount++;
 
@@ -355,87 +327,15 @@ void PendSV_Handler(void)
     outBuf = preampAudioOutBuffer2;
   }
 
-  /* Set start sample index */
-  i = 0;
-
-  /* Are we measuring DC offset average? Only done initially. */
-  if (dcOffsetSampleCount < SAMPLE_DC_OFFSET_COUNT)
+  /* Remove DC offset, adjust volume and encode for DAC. The processing itself */
+  /* is kept hardware independent in preampdsp.c. */
+  if (PREAMPDSP_process(&preampDsp,
+                        inBuf,
+                        outBuf,
+                        PREAMP_AUDIO_BUFFER_SIZE,
+                        preampAdjustFactor))
   {
-    while (i < PREAMP_AUDIO_BUFFER_SIZE)
-    {
-      i++;
-
-      /* Right channel */
-      right = (int32_t)(*(inBuf++) << preampErrataShift);
-
-      /* Left channel */
-      left = (int32_t)(*(inBuf++) << preampErrataShift);
-
-      /* Avoid using input signal until first DC measurement done */
-      outBuf++;
-
-      /* Measure DC component of audio-in channels? */
-      dcAccRight += right;
-      dcAccLeft += left;
-
-      /* Finished measuring DC offset* */
-      if (++dcOffsetSampleCount == SAMPLE_DC_OFFSET_COUNT)
-      {
-        dcRight = dcAccRight / SAMPLE_DC_OFFSET_COUNT;
-        dcLeft  = dcAccLeft / SAMPLE_DC_OFFSET_COUNT;
-        break;
-      }
-    }
-  }
-
-  /* Process input data */
-  while (i < PREAMP_AUDIO_BUFFER_SIZE)
-  {
-    i++;
-
-    /* Right channel */
-    right = (int32_t)(*(inBuf++) << preampErrataShift);
-
-    /* Left channel */
-    left = (int32_t)(*(inBuf++) << preampErrataShift);
-
-    /* Remove DC component of input signal */
-    right -= dcRight;
-    left -= dcLeft;
-
-    /* Volume adjustment, using integer arithmetic */
-    right = (right * (int32_t)preampAdjustFactor) /
-            (POTENTIOMETER_MAX_OHM / PREAMP_ADJUST_DIVISOR);
-    left = (left * (int32_t)preampAdjustFactor) /
-           (POTENTIOMETER_MAX_OHM / PREAMP_ADJUST_DIVISOR);
-
-    /* Add midpoint DC offset of allowed output range */
-    right += OUTPUT_RANGE / 2;
-    if (right < 0)
-    {
-      right = 0;
-      preampAudioOutClipped = true;
-    }
-    else if (right > OUTPUT_RANGE)
-    {
-      right = OUTPUT_RANGE;
-      preampAudioOutClipped = true;
-    }
-
-    left += OUTPUT_RANGE / 2;
-    if (left < 0)
-    {
-      left = 0;
-      preampAudioOutClipped = true;
-    }
-    else if (left > OUTPUT_RANGE)
-    {
-      left = OUTPUT_RANGE;
-      preampAudioOutClipped = true;
-    }
-
-    /* Encode for use with DAC COMBDATA accessed by DMA */
-    *(outBuf++) = ((uint32_t)left << 16) | (uint32_t)right;
+    preampAudioOutClipped = true;
   }
 
   /* Trigger sampling of potentiometer used for volume control? */
@@ -608,8 +508,6 @@ int main(void)
   DMA_Init_TypeDef dmaInit;
   TIMER_Init_TypeDef timerInit = TIMER_INIT_DEFAULT;
   SYSTEM_ChipRevision_TypeDef chipRev;
-  uint32_t volSample;
-  uint32_t vpot;
   uint32_t rpot;
   uint32_t leds;
 
@@ -624,6 +522,9 @@ int main(void)
     preampErrataShift = 1;
   }
 
+  /* Audio processing state must be set up before first buffer is received */
+  PREAMPDSP_init(&preampDsp, preampErrataShift);
+
   /* Initialize DVK board register access */
   BSP_Init(BSP_INIT_DEFAULT);
 
@@ -701,43 +602,9 @@ int main(void)
         /* regularly). Thus, we don't need to enable ADC interrupt. */
         EMU_EnterEM1();
       }
-      volSample = ADC_DataSingleGet(ADC0) << preampErrataShift;
-
-      /*
-        DVK potentiometer design:
-
-                 | Vdd = 3.3V
-                +-+
-                | | Rpullup = 10kOhm
-                +-+
-                 |
-                 +------> Vpot (to ADC)
-                 |
-                +-+
-                | | Rpot = 0-100kOhm
-                +-+
-                 | Gnd
-
-         Vpot = Rpot * Vdd / (Rpullup + Rpot)
-
-         This gives a non-linear voltage level measured by ADC with respect to
-         pot meter position. In order to determine the actual Rpot setting, which
-         is linear with respect to position, rewrite the above formula to:
-
-         Rpot = Rpullup * Vpot / (Vdd - Vpot)
-      */
-
-      /* Vpot sampled with 8 bit, divide by max value */
-      vpot = (POTENTIOMETER_VDD_mV * volSample) / 0xff;
-
-      /* Calculate Rpot determining volume */
-      rpot = (POTENTIOMETER_PULLUP_OHM * vpot) / (POTENTIOMETER_VDD_mV - vpot);
-      /* The potentiometer may not be exact in upper range, make sure we don't use a higher */
-      /* value than assumed by defines. */
-      if (rpot > POTENTIOMETER_MAX_OHM)
-      {
-        rpot = POTENTIOMETER_MAX_OHM;
-      }
+      /* Rpot is linear with respect to pot meter position, while the */
+      /* sampled voltage is not, see potlut.h. */
+      rpot = POTLUT_ohm(ADC_DataSingleGet(ADC0), preampErrataShift);
 
       /* Precalculate adjustment factor to avoid repeated calculation when used. */
       /* Scale down Rpot a bit to use in integer calculation without overflowing 32 bit reg. */
@@ -746,8 +613,8 @@ int main(void)
       /* Use 14 right leds for volume control indicating. Leftmost led is used to indicate */
       /* clipping of audio out signal (in order to limit volume out). Add half interval */
       /* for improving integer rounding effects. */
-      leds = rpot + (POTENTIOMETER_MAX_OHM / (14 * 2));
-      leds = (1 << ((14 * leds) / POTENTIOMETER_MAX_OHM)) - 1;
+      leds = rpot + (POTLUT_MAX_OHM / (14 * 2));
+      leds = (1 << ((14 * leds) / POTLUT_MAX_OHM)) - 1;
 
       /* Audio out clipped? */
       if (preampAudioOutClipped)
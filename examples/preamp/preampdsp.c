@@ -0,0 +1,189 @@
+/**************************************************************************//**
+ * @file
+ * @brief Preamplifier audio processing, hardware independent
+ * @author Energy Micro AS
+ * @version 3.20.0
+ ******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 Energy Micro AS, http://www.energymicro.com</b>
+ *******************************************************************************
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ * 4. The source and compiled code may only be used on Energy Micro "EFM32"
+ *    microcontrollers and "EFR4" radios.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: Energy Micro AS has no
+ * obligation to support this Software. Energy Micro AS is providing the
+ * Software "AS IS", with no express or implied warranties of any kind,
+ * including, but not limited to, any implied warranties of merchantability
+ * or fitness for any particular purpose or warranties against infringement
+ * of any proprietary rights of a third party.
+ *
+ * Energy Micro AS will not be liable for any consequential, incidental, or
+ * special damages, or any other relief, or for any claim by any third party,
+ * arising from your use of this Software.
+ *
+ *****************************************************************************/
+#include <string.h>
+#include "preampdsp.h"
+
+/***************************************************************************//**
+ * @brief
+ *   Reset audio processing state.
+ *
+ * @param[out] state
+ *   Processing state to initialize.
+ *
+ * @param[in] errataShift
+ *   Number of bits to shift input samples left, 1 on EFM32 rev B when using
+ *   VDD as ADC reference, otherwise 0.
+ *******************************************************************************/
+void PREAMPDSP_init(PREAMPDSP_State_TypeDef *state, int errataShift)
+{
+  memset(state, 0, sizeof(PREAMPDSP_State_TypeDef));
+  state->errataShift = errataShift;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Process one block of sampled audio into DAC output data.
+ *
+ * @details
+ *   Need to figure out average DC component in input signal (appr 1.65V
+ *   according to DVK design), since DC offset needs to be removed before
+ *   adjusting volume. If adjusting directly on input signal including DC
+ *   offset, one would also scale (the significant) DC offset, causing sharp
+ *   transissions (and audio out cracking noise) when adjusting volume. DC is
+ *   only sampled during the first PREAMPDSP_DC_OFFSET_COUNT samples, output
+ *   words for those samples are left untouched.
+ *
+ *   This function does not access any hardware, and may thus also be used
+ *   for processing recorded audio off-target.
+ *
+ * @param[in,out] state
+ *   Processing state.
+ *
+ * @param[in] inBuf
+ *   ADC scan data, right and left channel interleaved (right first).
+ *
+ * @param[out] outBuf
+ *   Output buffer, encoded for use with DAC COMBDATA.
+ *
+ * @param[in] frames
+ *   Number of samples per channel to process.
+ *
+ * @param[in] adjustFactor
+ *   Volume adjustment factor, PREAMPDSP_GAIN_DIVISOR gives unity gain.
+ *
+ * @return
+ *   true if output was clipped in any of the channels, false otherwise.
+ *******************************************************************************/
+bool PREAMPDSP_process(PREAMPDSP_State_TypeDef *state,
+                       const uint16_t *inBuf,
+                       uint32_t *outBuf,
+                       unsigned int frames,
+                       uint32_t adjustFactor)
+{
+  bool         clipped = false;
+  int          shift   = state->errataShift;
+  int32_t      factor  = (int32_t)adjustFactor;
+  int32_t      dcRight;
+  int32_t      dcLeft;
+  int32_t      right;
+  int32_t      left;
+  unsigned int i;
+
+  /* Set start sample index */
+  i = 0;
+
+  /* Are we measuring DC offset average? Only done initially. */
+  if (state->dcOffsetSampleCount < PREAMPDSP_DC_OFFSET_COUNT)
+  {
+    while (i < frames)
+    {
+      i++;
+
+      /* Right channel */
+      right = (int32_t)(*(inBuf++) << shift);
+
+      /* Left channel */
+      left = (int32_t)(*(inBuf++) << shift);
+
+      /* Avoid using input signal until first DC measurement done */
+      outBuf++;
+
+      /* Measure DC component of audio-in channels */
+      state->dcAccRight += right;
+      state->dcAccLeft += left;
+
+      /* Finished measuring DC offset */
+      if (++state->dcOffsetSampleCount == PREAMPDSP_DC_OFFSET_COUNT)
+      {
+        state->dcRight = state->dcAccRight / PREAMPDSP_DC_OFFSET_COUNT;
+        state->dcLeft  = state->dcAccLeft / PREAMPDSP_DC_OFFSET_COUNT;
+        break;
+      }
+    }
+  }
+
+  dcRight = (int32_t)state->dcRight;
+  dcLeft  = (int32_t)state->dcLeft;
+
+  /* Process input data */
+  while (i < frames)
+  {
+    i++;
+
+    /* Right channel */
+    right = (int32_t)(*(inBuf++) << shift);
+
+    /* Left channel */
+    left = (int32_t)(*(inBuf++) << shift);
+
+    /* Remove DC component of input signal */
+    right -= dcRight;
+    left -= dcLeft;
+
+    /* Volume adjustment, using integer arithmetic */
+    right = (right * factor) / PREAMPDSP_GAIN_DIVISOR;
+    left = (left * factor) / PREAMPDSP_GAIN_DIVISOR;
+
+    /* Add midpoint DC offset of allowed output range */
+    right += PREAMPDSP_OUTPUT_RANGE / 2;
+    if (right < 0)
+    {
+      right = 0;
+      clipped = true;
+    }
+    else if (right > PREAMPDSP_OUTPUT_RANGE)
+    {
+      right = PREAMPDSP_OUTPUT_RANGE;
+      clipped = true;
+    }
+
+    left += PREAMPDSP_OUTPUT_RANGE / 2;
+    if (left < 0)
+    {
+      left = 0;
+      clipped = true;
+    }
+    else if (left > PREAMPDSP_OUTPUT_RANGE)
+    {
+      left = PREAMPDSP_OUTPUT_RANGE;
+      clipped = true;
+    }
+
+    /* Encode for use with DAC COMBDATA accessed by DMA */
+    *(outBuf++) = ((uint32_t)left << 16) | (uint32_t)right;
+  }
+
+  return clipped;
+}
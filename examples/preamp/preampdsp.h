@@ -0,0 +1,86 @@
+/**************************************************************************//**
+ * @file
+ * @brief Preamplifier audio processing, hardware independent
+ * @author Energy Micro AS
+ * @version 3.20.0
+ ******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 Energy Micro AS, http://www.energymicro.com</b>
+ *******************************************************************************
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ * 4. The source and compiled code may only be used on Energy Micro "EFM32"
+ *    microcontrollers and "EFR4" radios.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: Energy Micro AS has no
+ * obligation to support this Software. Energy Micro AS is providing the
+ * Software "AS IS", with no express or implied warranties of any kind,
+ * including, but not limited to, any implied warranties of merchantability
+ * or fitness for any particular purpose or warranties against infringement
+ * of any proprietary rights of a third party.
+ *
+ * Energy Micro AS will not be liable for any consequential, incidental, or
+ * special damages, or any other relief, or for any claim by any third party,
+ * arising from your use of this Software.
+ *
+ *****************************************************************************/
+#ifndef __PREAMPDSP_H
+#define __PREAMPDSP_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Max DAC output value, clipping is done if audio-out signal is outside
+ * defined range. This is partly to limit max output volume, and partly to
+ * add as low DC offset to DAC output as possible.
+ */
+#define PREAMPDSP_OUTPUT_RANGE       0xA0
+
+/** Number of samples per channel used for measuring input DC offset. */
+#define PREAMPDSP_DC_OFFSET_COUNT    2048
+
+/** Divisor applied to volume adjustment factor, 100 steps = unity gain */
+#define PREAMPDSP_GAIN_DIVISOR       100
+
+/** Audio processing state, no references to hardware or buffers. */
+typedef struct
+{
+  /** Number of samples included in DC offset measurement so far. */
+  uint32_t dcOffsetSampleCount;
+  /** Accumulated right channel samples during DC offset measurement. */
+  uint32_t dcAccRight;
+  /** Accumulated left channel samples during DC offset measurement. */
+  uint32_t dcAccLeft;
+  /** Measured right channel DC offset. */
+  uint32_t dcRight;
+  /** Measured left channel DC offset. */
+  uint32_t dcLeft;
+  /** Shift applied to input samples (EFM32 rev B ADC errata). */
+  int      errataShift;
+} PREAMPDSP_State_TypeDef;
+
+void PREAMPDSP_init(PREAMPDSP_State_TypeDef *state, int errataShift);
+bool PREAMPDSP_process(PREAMPDSP_State_TypeDef *state,
+                       const uint16_t *inBuf,
+                       uint32_t *outBuf,
+                       unsigned int frames,
+                       uint32_t adjustFactor);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,192 @@
+/**************************************************************************//**
+ * @file
+ * @brief Host (Linux) QOI decoder benchmark for slideshow
+ * @author Energy Micro AS
+ * @version 3.20.0
+ ******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 Energy Micro AS, http://www.energymicro.com</b>
+ *******************************************************************************
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ * 4. The source and compiled code may only be used on Energy Micro "EFM32"
+ *    microcontrollers and "EFR4" radios.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: Energy Micro AS has no
+ * obligation to support this Software. Energy Micro AS is providing the
+ * Software "AS IS", with no express or implied warranties of any kind,
+ * including, but not limited to, any implied warranties of merchantability
+ * or fitness for any particular purpose or warranties against infringement
+ * of any proprietary rights of a third party.
+ *
+ * Energy Micro AS will not be liable for any consequential, incidental, or
+ * special damages, or any other relief, or for any claim by any third party,
+ * arising from your use of this Software.
+ *
+ *****************************************************************************/
+
+/*
+   Host (Linux) benchmark for the slideshow QOI decoder.
+
+   Decodes a QOI slide with the same decoder (slideqoi.c) as used on target,
+   and reports decode throughput and the number of bytes read from file per
+   slide, compared with the same slide stored as 24 bit BMP and as raw
+   RGB565. The decoder is fed through a read callback as on target, with
+   pixels fetched in prefetch buffer sized blocks.
+
+   Usage: slidebench <in.qoi> [iterations]
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include "slides.h"
+#include "slideraw.h"
+#include "slideqoi.h"
+
+/** Encoded file contents */
+static uint8_t  *fileBuf;
+static uint32_t fileSize;
+static uint32_t filePos;
+
+/** Bytes delivered to decoder */
+static uint32_t bytesRead;
+
+/** Decoded pixels, one prefetch buffer */
+static uint16_t pixelBuf[PREFETCH_BUFFER_SIZE / 2];
+
+/** Decoder state, static as on target */
+static SLIDEQOI_Decoder_TypeDef decoder;
+
+/***************************************************************************//**
+ * @brief Decoder read callback, reading from file contents in memory.
+ ******************************************************************************/
+static uint32_t readQoi(uint8_t *buffer, uint32_t length)
+{
+  if (length > (fileSize - filePos))
+  {
+    length = fileSize - filePos;
+  }
+  memcpy(buffer, fileBuf + filePos, length);
+  filePos   += length;
+  bytesRead += length;
+  return length;
+}
+
+/***************************************************************************//**
+ * @brief Decode slide once.
+ * @return Number of pixels decoded.
+ ******************************************************************************/
+static uint32_t decodeSlide(void)
+{
+  uint32_t total = 0;
+  uint32_t n;
+
+  filePos   = SLIDEQOI_HEADER_SIZE;
+  bytesRead = SLIDEQOI_HEADER_SIZE;
+  if (!SLIDEQOI_init(&decoder, readQoi, fileBuf))
+  {
+    return 0;
+  }
+  while ((n = SLIDEQOI_decode(&decoder, pixelBuf, PREFETCH_BUFFER_SIZE / 2)) > 0)
+  {
+    total += n;
+  }
+  return total;
+}
+
+/***************************************************************************//**
+ * @brief Main function.
+ ******************************************************************************/
+int main(int argc, char *argv[])
+{
+  FILE     *f;
+  long     size;
+  long     iterations = 100;
+  long     i;
+  uint32_t pixels;
+  uint32_t bmpSize;
+  uint32_t rawSize;
+  clock_t  start;
+  double   seconds;
+
+  if ((argc < 2) || (argc > 3))
+  {
+    fprintf(stderr, "Usage: %s <in.qoi> [iterations]\n", argv[0]);
+    return 1;
+  }
+  if (argc == 3)
+  {
+    iterations = atol(argv[2]);
+    if (iterations < 1)
+    {
+      iterations = 1;
+    }
+  }
+
+  f = fopen(argv[1], "rb");
+  if (!f)
+  {
+    fprintf(stderr, "Unable to open %s\n", argv[1]);
+    return 1;
+  }
+  fseek(f, 0, SEEK_END);
+  size = ftell(f);
+  fseek(f, 0, SEEK_SET);
+  if (size < SLIDERAW_HEADER_SIZE)
+  {
+    fprintf(stderr, "%s: file too short\n", argv[1]);
+    return 1;
+  }
+  fileSize = (uint32_t)size;
+  fileBuf  = malloc(fileSize);
+  if (!fileBuf || (fread(fileBuf, 1, fileSize, f) != fileSize))
+  {
+    fprintf(stderr, "Unable to read %s\n", argv[1]);
+    return 1;
+  }
+  fclose(f);
+
+  pixels = decodeSlide();
+  if (!pixels || (pixels != decoder.width * decoder.height))
+  {
+    fprintf(stderr, "%s: not a valid QOI file\n", argv[1]);
+    return 1;
+  }
+
+  start = clock();
+  for (i = 0; i < iterations; i++)
+  {
+    decodeSlide();
+  }
+  seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+  /* 24 bit BMP rows are padded to 4 bytes, headers are 54 bytes */
+  bmpSize = 54 + (((decoder.width * 3) + 3) & ~3u) * decoder.height;
+  rawSize = SLIDERAW_DATA_OFFSET + (pixels * 2);
+
+  printf("%s: %ux%u\n", argv[1], (unsigned)decoder.width, (unsigned)decoder.height);
+  printf("  bytes read, QOI       : %8u\n", (unsigned)bytesRead);
+  printf("  bytes read, raw RGB565: %8u (%.2fx QOI)\n",
+         (unsigned)rawSize, (double)rawSize / bytesRead);
+  printf("  bytes read, 24 bit BMP: %8u (%.2fx QOI)\n",
+         (unsigned)bmpSize, (double)bmpSize / bytesRead);
+  if (seconds > 0)
+  {
+    printf("  decode throughput     : %.1f Mpixel/s, %.1f slides/s\n",
+           (pixels * (double)iterations) / (seconds * 1e6),
+           iterations / seconds);
+  }
+  free(fileBuf);
+  return 0;
+}
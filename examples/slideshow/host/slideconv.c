@@ -0,0 +1,524 @@
+/**************************************************************************//**
+ * @file
+ * @brief Host (Linux) image converter for slideshow
+ * @author Energy Micro AS
+ * @version 3.20.0
+ ******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 Energy Micro AS, http://www.energymicro.com</b>
+ *******************************************************************************
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ * 4. The source and compiled code may only be used on Energy Micro "EFM32"
+ *    microcontrollers and "EFR4" radios.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: Energy Micro AS has no
+ * obligation to support this Software. Energy Micro AS is providing the
+ * Software "AS IS", with no express or implied warranties of any kind,
+ * including, but not limited to, any implied warranties of merchantability
+ * or fitness for any particular purpose or warranties against infringement
+ * of any proprietary rights of a third party.
+ *
+ * Energy Micro AS will not be liable for any consequential, incidental, or
+ * special damages, or any other relief, or for any claim by any third party,
+ * arising from your use of this Software.
+ *
+ *****************************************************************************/
+
+/*
+   Host (Linux) converter for slideshow images.
+
+   Reads an uncompressed BMP (1, 4, 8, 24 or 32 bits per pixel) or a binary
+   PPM (P6) image, and writes it in the raw RGB565 slide format described in
+   slideraw.h. Pixel data is stored top-down in the order written to the
+   display, so the slideshow can stream it without any decoding.
+
+   With -q, the image is instead written in the lossless QOI format, decoded
+   on target by slideqoi.c. This typically reads far fewer bytes from the
+   microSD card than both BMP and raw RGB565. Colors are reduced to RGB565
+   precision before encoding, as that is all the display can show, which
+   gives longer runs and better compression.
+
+   Images larger than 320x240 are scaled down to fit, using the same
+   area-average downscaler (slidescale.c) as the slideshow uses for large
+   BMP files, and the source rows per second processed are reported.
+
+   Usage: slideconv [-q] <in.bmp|in.ppm> <out.565|out.qoi>
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include "slideraw.h"
+#include "slidescale.h"
+
+/** Decoded image, 24 bit RGB, top-down */
+typedef struct
+{
+  uint32_t width;
+  uint32_t height;
+  uint8_t  *rgb;
+} IMAGE_TypeDef;
+
+/***************************************************************************//**
+ * @brief Read little endian value from byte buffer.
+ ******************************************************************************/
+static uint32_t rdLE(const uint8_t *p, int bytes)
+{
+  uint32_t v = 0;
+  while (bytes--)
+  {
+    v = (v << 8) | p[bytes];
+  }
+  return v;
+}
+
+/***************************************************************************//**
+ * @brief Write little endian value to file.
+ ******************************************************************************/
+static void wrLE(FILE *f, uint32_t v, int bytes)
+{
+  while (bytes--)
+  {
+    fputc((int)(v & 0xff), f);
+    v >>= 8;
+  }
+}
+
+/***************************************************************************//**
+ * @brief Read whole file into memory.
+ ******************************************************************************/
+static uint8_t *readFile(const char *name, long *size)
+{
+  FILE    *f = fopen(name, "rb");
+  uint8_t *buf;
+
+  if (!f)
+  {
+    return NULL;
+  }
+  fseek(f, 0, SEEK_END);
+  *size = ftell(f);
+  fseek(f, 0, SEEK_SET);
+  buf = malloc((size_t)*size + 1);
+  if (buf && (fread(buf, 1, (size_t)*size, f) != (size_t)*size))
+  {
+    free(buf);
+    buf = NULL;
+  }
+  fclose(f);
+  return buf;
+}
+
+/***************************************************************************//**
+ * @brief Decode uncompressed BMP file.
+ ******************************************************************************/
+static int loadBmp(const uint8_t *buf, long size, IMAGE_TypeDef *img)
+{
+  uint32_t dataOffset;
+  uint32_t hdrSize;
+  int32_t  width;
+  int32_t  height;
+  uint32_t bpp;
+  uint32_t compression;
+  uint32_t colors;
+  uint32_t stride;
+  const uint8_t *palette;
+  const uint8_t *row;
+  uint32_t x;
+  uint32_t y;
+  uint32_t idx;
+  int      topDown = 0;
+
+  if ((size < 54) || (buf[0] != 'B') || (buf[1] != 'M'))
+  {
+    return -1;
+  }
+  dataOffset  = rdLE(buf + 10, 4);
+  hdrSize     = rdLE(buf + 14, 4);
+  width       = (int32_t)rdLE(buf + 18, 4);
+  height      = (int32_t)rdLE(buf + 22, 4);
+  bpp         = rdLE(buf + 28, 2);
+  compression = rdLE(buf + 30, 4);
+  colors      = rdLE(buf + 46, 4);
+
+  if ((compression != 0) && !((compression == 3) && (bpp == 32)))
+  {
+    fprintf(stderr, "Compressed BMP files not supported\n");
+    return -1;
+  }
+  if (height < 0)
+  {
+    topDown = 1;
+    height  = -height;
+  }
+  if ((width <= 0) || (height <= 0))
+  {
+    return -1;
+  }
+  if (!colors && (bpp <= 8))
+  {
+    colors = 1u << bpp;
+  }
+  palette = buf + 14 + hdrSize;
+  stride  = (((uint32_t)width * bpp + 31) / 32) * 4;
+  if ((long)(dataOffset + (stride * (uint32_t)height)) > size)
+  {
+    return -1;
+  }
+
+  img->width  = (uint32_t)width;
+  img->height = (uint32_t)height;
+  img->rgb    = malloc((size_t)width * (size_t)height * 3);
+  if (!img->rgb)
+  {
+    return -1;
+  }
+
+  for (y = 0; y < img->height; y++)
+  {
+    row = buf + dataOffset + (stride * (topDown ? y : (img->height - 1 - y)));
+    for (x = 0; x < img->width; x++)
+    {
+      uint8_t *dst = img->rgb + ((y * img->width) + x) * 3;
+
+      switch (bpp)
+      {
+      case 1:
+      case 4:
+      case 8:
+        idx = (row[(x * bpp) / 8] >> (8 - bpp - ((x * bpp) % 8))) & ((1u << bpp) - 1);
+        if (idx >= colors)
+        {
+          idx = 0;
+        }
+        dst[0] = palette[(idx * 4) + 2];
+        dst[1] = palette[(idx * 4) + 1];
+        dst[2] = palette[(idx * 4)];
+        break;
+      case 24:
+      case 32:
+        dst[0] = row[(x * (bpp / 8)) + 2];
+        dst[1] = row[(x * (bpp / 8)) + 1];
+        dst[2] = row[(x * (bpp / 8))];
+        break;
+      default:
+        fprintf(stderr, "%u bits per pixel not supported\n", (unsigned)bpp);
+        return -1;
+      }
+    }
+  }
+  return 0;
+}
+
+/***************************************************************************//**
+ * @brief Skip whitespace and comments in PPM header.
+ ******************************************************************************/
+static const uint8_t *ppmSkip(const uint8_t *p, const uint8_t *end)
+{
+  while (p < end)
+  {
+    if (*p == '#')
+    {
+      while ((p < end) && (*p != '\n'))
+      {
+        p++;
+      }
+    }
+    else if ((*p == ' ') || (*p == '\t') || (*p == '\r') || (*p == '\n'))
+    {
+      p++;
+    }
+    else
+    {
+      break;
+    }
+  }
+  return p;
+}
+
+/***************************************************************************//**
+ * @brief Decode binary (P6) PPM file with max value 255.
+ ******************************************************************************/
+static int loadPpm(const uint8_t *buf, long size, IMAGE_TypeDef *img)
+{
+  const uint8_t *p   = buf + 2;
+  const uint8_t *end = buf + size;
+  unsigned long v[3];
+  int           i;
+
+  if ((size < 3) || (buf[0] != 'P') || (buf[1] != '6'))
+  {
+    return -1;
+  }
+  for (i = 0; i < 3; i++)
+  {
+    p = ppmSkip(p, end);
+    v[i] = strtoul((const char *)p, (char **)&p, 10);
+  }
+  p++;  /* Single whitespace after max value */
+  if ((v[2] != 255) || !v[0] || !v[1] || ((long)(v[0] * v[1] * 3) > (end - p)))
+  {
+    return -1;
+  }
+  img->width  = (uint32_t)v[0];
+  img->height = (uint32_t)v[1];
+  img->rgb    = malloc((size_t)v[0] * v[1] * 3);
+  if (!img->rgb)
+  {
+    return -1;
+  }
+  memcpy(img->rgb, p, (size_t)v[0] * v[1] * 3);
+  return 0;
+}
+
+/** Downscaled image being built by scaleRow() */
+static uint8_t  *scaledRgb;
+static uint32_t scaledRows;
+
+/***************************************************************************//**
+ * @brief Downscaler output function, appending row to scaled image.
+ ******************************************************************************/
+static void scaleRow(uint8_t *rgb, uint32_t pixels)
+{
+  memcpy(scaledRgb + (scaledRows * pixels * 3), rgb, pixels * 3);
+  scaledRows++;
+}
+
+/***************************************************************************//**
+ * @brief Scale image down to fit display.
+ ******************************************************************************/
+static int scaleImage(IMAGE_TypeDef *img)
+{
+  static SLIDESCALE_TypeDef scaler;
+  uint32_t width;
+  uint32_t height;
+  clock_t  start;
+  double   seconds;
+
+  SLIDESCALE_fit(img->width, img->height, 320, 240, &width, &height);
+  scaledRgb  = malloc(width * height * 3);
+  scaledRows = 0;
+  if (!scaledRgb ||
+      !SLIDESCALE_init(&scaler, img->width, img->height, width, height, scaleRow))
+  {
+    return -1;
+  }
+
+  start = clock();
+  SLIDESCALE_push(&scaler, img->rgb, img->width * img->height);
+  seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+  printf("Scaled %ux%u to %ux%u", (unsigned)img->width, (unsigned)img->height,
+         (unsigned)width, (unsigned)height);
+  if (seconds > 0)
+  {
+    printf(", %.0f source rows/s", img->height / seconds);
+  }
+  printf("\n");
+
+  free(img->rgb);
+  img->rgb    = scaledRgb;
+  img->width  = width;
+  img->height = height;
+  return (scaledRows == height) ? 0 : -1;
+}
+
+/***************************************************************************//**
+ * @brief Write big endian 32 bit value to file.
+ ******************************************************************************/
+static void wrBE32(FILE *f, uint32_t v)
+{
+  fputc((int)(v >> 24), f);
+  fputc((int)((v >> 16) & 0xff), f);
+  fputc((int)((v >> 8) & 0xff), f);
+  fputc((int)(v & 0xff), f);
+}
+
+/***************************************************************************//**
+ * @brief Write image in QOI format, colors reduced to RGB565 precision.
+ ******************************************************************************/
+static int saveQoi(const char *name, const IMAGE_TypeDef *img)
+{
+  FILE     *f = fopen(name, "wb");
+  uint8_t  index[64][3];
+  uint8_t  prev[3] = { 0, 0, 0 };
+  uint8_t  px[3];
+  uint32_t run = 0;
+  uint32_t count = img->width * img->height;
+  uint32_t i;
+  int      h;
+  int      vr, vg, vb, vgr, vgb;
+
+  if (!f)
+  {
+    return -1;
+  }
+  memset(index, 0, sizeof(index));
+
+  fwrite("qoif", 1, 4, f);
+  wrBE32(f, img->width);
+  wrBE32(f, img->height);
+  fputc(3, f);                          /* RGB */
+  fputc(0, f);                          /* sRGB with linear alpha */
+
+  for (i = 0; i < count; i++)
+  {
+    px[0] = img->rgb[(i * 3)] & 0xf8;
+    px[1] = img->rgb[(i * 3) + 1] & 0xfc;
+    px[2] = img->rgb[(i * 3) + 2] & 0xf8;
+
+    if (!memcmp(px, prev, 3))
+    {
+      run++;
+      if ((run == 62) || (i == (count - 1)))
+      {
+        fputc(0xc0 | (int)(run - 1), f);
+        run = 0;
+      }
+      continue;
+    }
+    if (run)
+    {
+      fputc(0xc0 | (int)(run - 1), f);
+      run = 0;
+    }
+
+    /* Alpha is always 255 */
+    h = ((px[0] * 3) + (px[1] * 5) + (px[2] * 7) + (255 * 11)) & 63;
+    if (!memcmp(index[h], px, 3))
+    {
+      fputc(h, f);
+    }
+    else
+    {
+      memcpy(index[h], px, 3);
+      vr  = (int8_t)(px[0] - prev[0]);
+      vg  = (int8_t)(px[1] - prev[1]);
+      vb  = (int8_t)(px[2] - prev[2]);
+      vgr = vr - vg;
+      vgb = vb - vg;
+      if ((vr > -3) && (vr < 2) && (vg > -3) && (vg < 2) && (vb > -3) && (vb < 2))
+      {
+        fputc(0x40 | ((vr + 2) << 4) | ((vg + 2) << 2) | (vb + 2), f);
+      }
+      else if ((vgr > -9) && (vgr < 8) && (vg > -33) && (vg < 32) && (vgb > -9) && (vgb < 8))
+      {
+        fputc(0x80 | (vg + 32), f);
+        fputc(((vgr + 8) << 4) | (vgb + 8), f);
+      }
+      else
+      {
+        fputc(0xfe, f);
+        fwrite(px, 1, 3, f);
+      }
+    }
+    memcpy(prev, px, 3);
+  }
+
+  /* End marker */
+  for (i = 0; i < 7; i++)
+  {
+    fputc(0, f);
+  }
+  fputc(1, f);
+  return fclose(f);
+}
+
+/***************************************************************************//**
+ * @brief Write image in raw RGB565 slide format.
+ ******************************************************************************/
+static int saveRaw(const char *name, const IMAGE_TypeDef *img)
+{
+  FILE     *f = fopen(name, "wb");
+  uint32_t i;
+  const uint8_t *c;
+
+  if (!f)
+  {
+    return -1;
+  }
+  wrLE(f, SLIDERAW_MAGIC, 4);
+  wrLE(f, img->width, 2);
+  wrLE(f, img->height, 2);
+  wrLE(f, SLIDERAW_DATA_OFFSET, 4);
+  wrLE(f, 0, 4);
+  for (i = SLIDERAW_HEADER_SIZE; i < SLIDERAW_DATA_OFFSET; i++)
+  {
+    fputc(0, f);
+  }
+  for (i = 0; i < img->width * img->height; i++)
+  {
+    c = img->rgb + (i * 3);
+    wrLE(f, ((uint32_t)(c[0] & 0xf8) << 8) | ((uint32_t)(c[1] & 0xfc) << 3) | (c[2] >> 3), 2);
+  }
+  return fclose(f);
+}
+
+int main(int argc, char **argv)
+{
+  IMAGE_TypeDef img;
+  uint8_t       *buf;
+  long          size;
+  long          outSize;
+  int           qoi = 0;
+  int           rc;
+  FILE          *f;
+
+  if ((argc == 4) && !strcmp(argv[1], "-q"))
+  {
+    qoi = 1;
+    argv++;
+    argc--;
+  }
+  if (argc != 3)
+  {
+    fprintf(stderr, "Usage: %s [-q] <in.bmp|in.ppm> <out.565|out.qoi>\n", argv[0]);
+    return 1;
+  }
+
+  buf = readFile(argv[1], &size);
+  if (!buf)
+  {
+    fprintf(stderr, "Unable to read %s\n", argv[1]);
+    return 1;
+  }
+  if (loadBmp(buf, size, &img) && loadPpm(buf, size, &img))
+  {
+    fprintf(stderr, "%s is not a supported BMP or PPM file\n", argv[1]);
+    return 1;
+  }
+  if (((img.width > 320) || (img.height > 240)) && scaleImage(&img))
+  {
+    fprintf(stderr, "Unable to scale %s\n", argv[1]);
+    return 1;
+  }
+
+  rc = qoi ? saveQoi(argv[2], &img) : saveRaw(argv[2], &img);
+  f  = fopen(argv[2], "rb");
+  if (rc || !f)
+  {
+    fprintf(stderr, "Unable to write %s\n", argv[2]);
+    return 1;
+  }
+  fseek(f, 0, SEEK_END);
+  outSize = ftell(f);
+  fclose(f);
+
+  printf("%s: %ux%u, %ld bytes -> %s: %ld bytes\n",
+         argv[1], (unsigned)img.width, (unsigned)img.height, size, argv[2], outSize);
+
+  free(img.rgb);
+  free(buf);
+  return 0;
+}
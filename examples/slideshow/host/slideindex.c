@@ -0,0 +1,156 @@
+/**************************************************************************//**
+ * @file
+ * @brief Host (Linux) slide index tool for slideshow
+ * @author Energy Micro AS
+ * @version 3.20.0
+ ******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 Energy Micro AS, http://www.energymicro.com</b>
+ *******************************************************************************
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ * 4. The source and compiled code may only be used on Energy Micro "EFM32"
+ *    microcontrollers and "EFR4" radios.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: Energy Micro AS has no
+ * obligation to support this Software. Energy Micro AS is providing the
+ * Software "AS IS", with no express or implied warranties of any kind,
+ * including, but not limited to, any implied warranties of merchantability
+ * or fitness for any particular purpose or warranties against infringement
+ * of any proprietary rights of a third party.
+ *
+ * Energy Micro AS will not be liable for any consequential, incidental, or
+ * special damages, or any other relief, or for any claim by any third party,
+ * arising from your use of this Software.
+ *
+ *****************************************************************************/
+
+/*
+   Host (Linux) tool for building and listing the slide index file.
+
+   Builds slides.idx in the given directory, typically the root of the
+   microSD card, with the same code (slidelist.c and slideindex.c) as the
+   slideshow, run on the emulated file system of host/ffemu.c. Names are
+   taken from files.txt if present, otherwise from the directory, sorted
+   by name. The index holds a signature of the directory, and is used by
+   the slideshow until the card contents change, then built again on
+   target. Running this tool after changing the card avoids that build.
+
+   With -l, the index is instead read back and each entry listed, looking
+   it up by seek the same way as the slideshow does, and the signature is
+   checked against the directory.
+
+   Usage: slideindex [-l] <directory>
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include "ff.h"
+#include "ffemu.h"
+#include "slideindex.h"
+#include "slidelist.h"
+
+/***************************************************************************//**
+ * @brief List index file, looking up each entry by seek.
+ ******************************************************************************/
+static int list(void)
+{
+  static const char * const formats[] = { "?", "BMP", "RGB565", "QOI" };
+  SLIDEINDEX_Header_TypeDef header;
+  SLIDEINDEX_Entry_TypeDef  entry;
+  FIL                       idx;
+  UINT                      bytes;
+  uint32_t                  signature;
+  uint32_t                  files;
+  uint32_t                  i;
+
+  if ((f_open(&idx, SLIDEINDEX_FILE_NAME, FA_READ) != FR_OK) ||
+      (f_read(&idx, &header, SLIDEINDEX_ENTRY_SIZE, &bytes) != FR_OK) ||
+      (bytes != SLIDEINDEX_ENTRY_SIZE) ||
+      !SLIDEINDEX_checkHeader(&header))
+  {
+    return -1;
+  }
+
+  for (i = 0; i < header.count; i++)
+  {
+    if ((f_lseek(&idx, (i + 1) * SLIDEINDEX_ENTRY_SIZE) != FR_OK) ||
+        (f_read(&idx, &entry, SLIDEINDEX_ENTRY_SIZE, &bytes) != FR_OK) ||
+        (bytes != SLIDEINDEX_ENTRY_SIZE))
+    {
+      fprintf(stderr, "Entry %u missing\n", (unsigned)i);
+      f_close(&idx);
+      return -1;
+    }
+    entry.name[SLIDEINDEX_NAME_SIZE - 1] = '\0';
+    printf("%4u  %-19s  %-6s  %5ux%-5u  %u bytes\n", (unsigned)i, entry.name,
+           formats[(entry.format < 4) ? entry.format : 0],
+           (unsigned)entry.width, (unsigned)entry.height, (unsigned)entry.size);
+  }
+  f_close(&idx);
+
+  if ((SLIDELIST_signature(&signature, &files) == FR_OK) &&
+      ((header.signature != signature) || (header.files != files)))
+  {
+    printf("Card contents changed, index will be built again by slideshow\n");
+  }
+  return 0;
+}
+
+/***************************************************************************//**
+ * @brief Main function.
+ ******************************************************************************/
+int main(int argc, char **argv)
+{
+  FATFS fatfs;
+  int   listOnly = 0;
+  int   result;
+
+  if ((argc == 3) && !strcmp(argv[1], "-l"))
+  {
+    listOnly = 1;
+    argv++;
+    argc--;
+  }
+  if (argc != 2)
+  {
+    fprintf(stderr, "Usage: %s [-l] <directory>\n", argv[0]);
+    return 1;
+  }
+  if (!FFEMU_init(argv[1]) || (f_mount(0, &fatfs) != FR_OK))
+  {
+    fprintf(stderr, "Unable to open %s\n", argv[1]);
+    return 1;
+  }
+
+  if (listOnly)
+  {
+    result = list();
+  }
+  else
+  {
+    result = (SLIDELIST_build() == FR_OK) && (SLIDELIST_open() == FR_OK) ? 0 : -1;
+    if (result == 0)
+    {
+      printf("%s/%s: %u slides\n", argv[1], SLIDEINDEX_FILE_NAME,
+             (unsigned)SLIDELIST_count());
+      SLIDELIST_close();
+    }
+  }
+  if (result)
+  {
+    fprintf(stderr, "Unable to %s %s/%s\n", listOnly ? "read" : "build",
+            argv[1], SLIDEINDEX_FILE_NAME);
+    return 1;
+  }
+  return 0;
+}
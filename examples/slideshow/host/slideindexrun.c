@@ -0,0 +1,476 @@
+/**************************************************************************//**
+ * @file
+ * @brief Host runner checking slideshow index build, lookup and rebuild on card changes
+ * @author Energy Micro AS
+ * @version 3.20.0
+ ******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 Energy Micro AS, http://www.energymicro.com</b>
+ *******************************************************************************
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ * 4. The source and compiled code may only be used on Energy Micro "EFM32"
+ *    microcontrollers and "EFR4" radios.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: Energy Micro AS has no
+ * obligation to support this Software. Energy Micro AS is providing the
+ * Software "AS IS", with no express or implied warranties of any kind,
+ * including, but not limited to, any implied warranties of merchantability
+ * or fitness for any particular purpose or warranties against infringement
+ * of any proprietary rights of a third party.
+ *
+ * Energy Micro AS will not be liable for any consequential, incidental, or
+ * special damages, or any other relief, or for any claim by any third party,
+ * arising from your use of this Software.
+ *
+ *****************************************************************************/
+
+/*
+   Host (Linux) runner for the slide index and slide list (slideindex.c,
+   slidelist.c) on the emulated file system of host/ffemu.c.
+
+   A card is made up in a temporary directory with BMP, raw RGB565 and QOI
+   slides and a file that is no slide. The index must be built with the
+   slides only, in name order, with their size and format, and each slide
+   must be found with at most one sector read, wrapping around at the end.
+   Opening the index again with the card unchanged must not build it
+   again. Adding, deleting or changing a slide, adding or editing
+   files.txt, and an invalid index or one of an older version must each
+   make the index be built again, matching the card.
+
+   Changes are made with a new size, as FAT only keeps the modification
+   time to two seconds.
+
+   Usage: slideindexrun
+*/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include "ff.h"
+#include "ffemu.h"
+#include "slides.h"
+#include "slideraw.h"
+#include "slideqoi.h"
+#include "slideindex.h"
+#include "slidelist.h"
+
+/** Max number of files on test card */
+#define TEST_MAX_FILES  8
+
+/** Directory holding test card */
+static char cardDir[] = "/tmp/slideindexXXXXXX";
+
+/** Files written to test card, for clean up */
+static char cardFiles[TEST_MAX_FILES][13];
+static int  cardFileCount;
+
+/** File system of emulated card */
+static FATFS fatfs;
+
+/***************************************************************************//**
+ * @brief
+ *   Store little endian value.
+ ******************************************************************************/
+static void putLE(uint8_t *p, uint32_t value, int bytes)
+{
+  while (bytes--)
+  {
+    *p++    = (uint8_t) value;
+    value >>= 8;
+  }
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Write file to test card.
+ ******************************************************************************/
+static bool writeFile(const char *name, const void *data, size_t length)
+{
+  char path[300];
+  FILE *f;
+  bool ok;
+  int  i;
+
+  snprintf(path, sizeof(path), "%s/%s", cardDir, name);
+  f = fopen(path, "wb");
+  if (!f)
+  {
+    return false;
+  }
+  ok = (fwrite(data, 1, length, f) == length);
+  ok = (fclose(f) == 0) && ok;
+
+  for (i = 0; i < cardFileCount; i++)
+  {
+    if (!strcmp(cardFiles[i], name))
+    {
+      return ok;
+    }
+  }
+  if (cardFileCount < TEST_MAX_FILES)
+  {
+    strcpy(cardFiles[cardFileCount++], name);
+  }
+  return ok;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Write slide header of given format and size to test card. Only the
+ *   headers are needed for the index, the rest of the file is padding.
+ ******************************************************************************/
+static bool writeSlide(const char *name, int format, uint32_t width,
+                       uint32_t height, size_t length)
+{
+  static uint8_t data[4096];
+
+  memset(data, 0, sizeof(data));
+  if (format == SLIDEINDEX_FORMAT_BMP)
+  {
+    data[0] = 'B';
+    data[1] = 'M';
+    putLE(data + 2, length, 4);
+    putLE(data + 10, 54, 4);
+    putLE(data + 14, 40, 4);
+    putLE(data + 18, width, 4);
+    putLE(data + 22, height, 4);
+    putLE(data + 26, 1, 2);
+    putLE(data + 28, 24, 2);
+  }
+  else if (format == SLIDEINDEX_FORMAT_RAW)
+  {
+    putLE(data, SLIDERAW_MAGIC, 4);
+    putLE(data + 4, width, 2);
+    putLE(data + 6, height, 2);
+    putLE(data + 8, SLIDERAW_DATA_OFFSET, 4);
+  }
+  else if (format == SLIDEINDEX_FORMAT_QOI)
+  {
+    memcpy(data, "qoif", 4);
+    data[4]  = (uint8_t)(width >> 24);
+    data[5]  = (uint8_t)(width >> 16);
+    data[6]  = (uint8_t)(width >> 8);
+    data[7]  = (uint8_t) width;
+    data[8]  = (uint8_t)(height >> 24);
+    data[9]  = (uint8_t)(height >> 16);
+    data[10] = (uint8_t)(height >> 8);
+    data[11] = (uint8_t) height;
+    data[12] = 3;
+  }
+  else
+  {
+    memset(data, 'x', sizeof(data));
+  }
+  return writeFile(name, data, (length < sizeof(data)) ? length : sizeof(data));
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Remove file from test card.
+ ******************************************************************************/
+static void removeFile(const char *name)
+{
+  char path[300];
+
+  snprintf(path, sizeof(path), "%s/%s", cardDir, name);
+  remove(path);
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Open slide list, as at slideshow start.
+ * @param[out] rebuilt
+ *   Set if index had to be built.
+ * @return
+ *   true if opened.
+ ******************************************************************************/
+static bool openList(bool *rebuilt)
+{
+  uint32_t written = ffemuCount.sectorsWritten;
+  FRESULT  res     = SLIDELIST_open();
+
+  *rebuilt = (ffemuCount.sectorsWritten != written);
+  if (res != FR_OK)
+  {
+    printf("SLIDELIST_open() failed (%d)\n", (int) res);
+    return false;
+  }
+  return true;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Check that slide list holds the given names, in order, each found by
+ *   one sector read at most, wrapping around to the first, and that each
+ *   slide can be opened.
+ ******************************************************************************/
+static bool checkList(const char * const *names, uint32_t count)
+{
+  char     fileName[SLIDES_NAME_SIZE];
+  uint32_t sectors;
+  uint32_t i;
+  FIL      file;
+
+  if (SLIDELIST_count() != count)
+  {
+    printf("%lu slides listed, expected %lu\n",
+           (unsigned long) SLIDELIST_count(), (unsigned long) count);
+    return false;
+  }
+  for (i = 0; i <= count; i++)
+  {
+    sectors = ffemuCount.sectorsRead;
+    if (SLIDELIST_next(fileName) != FR_OK)
+    {
+      printf("slide %lu not found\n", (unsigned long) i);
+      return false;
+    }
+    if ((ffemuCount.sectorsRead - sectors) > 1)
+    {
+      printf("slide %lu took %lu sector reads\n", (unsigned long) i,
+             (unsigned long)(ffemuCount.sectorsRead - sectors));
+      return false;
+    }
+    if (strcmp(fileName, names[i % count]))
+    {
+      printf("slide %lu is %s, expected %s\n", (unsigned long) i,
+             fileName, names[i % count]);
+      return false;
+    }
+    if (f_open(&file, fileName, FA_READ) != FR_OK)
+    {
+      printf("slide %s cannot be opened\n", fileName);
+      return false;
+    }
+    f_close(&file);
+  }
+  return true;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Check index entry of slide, read from index file.
+ ******************************************************************************/
+static bool checkEntry(uint32_t index, const char *name, int format,
+                       uint32_t width, uint32_t height, uint32_t size)
+{
+  SLIDEINDEX_Entry_TypeDef entry;
+  FIL                      idx;
+  UINT                     bytes;
+  bool                     ok;
+
+  ok = (f_open(&idx, SLIDEINDEX_FILE_NAME, FA_READ) == FR_OK) &&
+       (f_lseek(&idx, (index + 1) * SLIDEINDEX_ENTRY_SIZE) == FR_OK) &&
+       (f_read(&idx, &entry, SLIDEINDEX_ENTRY_SIZE, &bytes) == FR_OK) &&
+       (bytes == SLIDEINDEX_ENTRY_SIZE);
+  f_close(&idx);
+
+  if (!ok || strcmp(entry.name, name) || (entry.format != format) ||
+      (entry.width != width) || (entry.height != height) || (entry.size != size))
+  {
+    printf("entry %lu is not %s, format %d, %lux%lu, %lu bytes\n",
+           (unsigned long) index, name, format, (unsigned long) width,
+           (unsigned long) height, (unsigned long) size);
+    return false;
+  }
+  return true;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Check that opening the list builds the index or not, as expected.
+ ******************************************************************************/
+static bool checkOpen(const char *what, bool expectRebuild)
+{
+  bool rebuilt;
+
+  SLIDELIST_close();
+  if (!openList(&rebuilt))
+  {
+    return false;
+  }
+  printf("%-28s %s\n", what, rebuilt ? "built" : "kept");
+  if (rebuilt != expectRebuild)
+  {
+    printf("index %s, expected it to be %s\n", rebuilt ? "built" : "kept",
+           expectRebuild ? "built" : "kept");
+    return false;
+  }
+  return true;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Overwrite header of index file.
+ ******************************************************************************/
+static bool writeHeader(const SLIDEINDEX_Header_TypeDef *header)
+{
+  FIL  idx;
+  UINT bytes;
+  bool ok;
+
+  SLIDELIST_close();
+  ok = (f_open(&idx, SLIDEINDEX_FILE_NAME, FA_READ | FA_WRITE) == FR_OK) &&
+       (f_write(&idx, header, SLIDEINDEX_ENTRY_SIZE, &bytes) == FR_OK);
+  return (f_close(&idx) == FR_OK) && ok;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Run tests on test card.
+ ******************************************************************************/
+static bool runTests(void)
+{
+  static const char * const initial[]  = { "A.BMP", "B.RAW", "C.QOI" };
+  static const char * const added[]    = { "A.BMP", "B.RAW", "C.QOI", "D.BMP" };
+  static const char * const deleted[]  = { "A.BMP", "C.QOI", "D.BMP" };
+  static const char * const listed[]   = { "C.QOI", "A.BMP" };
+  static const char * const relisted[] = { "C.QOI", "A.BMP", "D.BMP" };
+  static const char         manifest[]   = "C.QOI\r\nA.BMP\r\n\r\nNOTE.TXT\r\n";
+  static const char         manifest2[]  = "C.QOI\r\nA.BMP\r\nD.BMP\r\n";
+  SLIDEINDEX_Header_TypeDef header;
+  FIL                       idx;
+  UINT                      bytes;
+
+  if (!writeSlide("A.BMP", SLIDEINDEX_FORMAT_BMP, 320, 240, 3000) ||
+      !writeSlide("B.RAW", SLIDEINDEX_FORMAT_RAW, 160, 120, 2000) ||
+      !writeSlide("C.QOI", SLIDEINDEX_FORMAT_QOI, 640, 480, 1000) ||
+      !writeSlide("NOTE.TXT", SLIDEINDEX_FORMAT_UNKNOWN, 0, 0, 100))
+  {
+    printf("could not write test card\n");
+    return false;
+  }
+
+  /* Built on first start, slides only, in name order */
+  if (!checkOpen("new card", true) ||
+      !checkList(initial, 3) ||
+      !checkEntry(0, "A.BMP", SLIDEINDEX_FORMAT_BMP, 320, 240, 3000) ||
+      !checkEntry(1, "B.RAW", SLIDEINDEX_FORMAT_RAW, 160, 120, 2000) ||
+      !checkEntry(2, "C.QOI", SLIDEINDEX_FORMAT_QOI, 640, 480, 1000))
+  {
+    return false;
+  }
+
+  /* Kept while card is unchanged, also when built by host tool */
+  if (!checkOpen("unchanged", false) || !checkList(initial, 3))
+  {
+    return false;
+  }
+  SLIDELIST_close();
+  if ((SLIDELIST_build() != FR_OK) ||
+      !checkOpen("built by host tool", false) || !checkList(initial, 3))
+  {
+    return false;
+  }
+
+  /* Slide added */
+  if (!writeSlide("D.BMP", SLIDEINDEX_FORMAT_BMP, 100, 50, 600) ||
+      !checkOpen("slide added", true) || !checkList(added, 4) ||
+      !checkEntry(3, "D.BMP", SLIDEINDEX_FORMAT_BMP, 100, 50, 600))
+  {
+    return false;
+  }
+
+  /* Slide deleted, must no longer be opened */
+  removeFile("B.RAW");
+  if (!checkOpen("slide deleted", true) || !checkList(deleted, 3))
+  {
+    return false;
+  }
+
+  /* Slide replaced by one of another size */
+  if (!writeSlide("A.BMP", SLIDEINDEX_FORMAT_BMP, 200, 100, 2500) ||
+      !checkOpen("slide changed", true) || !checkList(deleted, 3) ||
+      !checkEntry(0, "A.BMP", SLIDEINDEX_FORMAT_BMP, 200, 100, 2500))
+  {
+    return false;
+  }
+
+  /* Manifest added, then edited */
+  if (!writeFile("FILES.TXT", manifest, strlen(manifest)) ||
+      !checkOpen("files.txt added", true) || !checkList(listed, 2) ||
+      !checkOpen("unchanged", false) || !checkList(listed, 2))
+  {
+    return false;
+  }
+  if (!writeFile("FILES.TXT", manifest2, strlen(manifest2)) ||
+      !checkOpen("files.txt edited", true) || !checkList(relisted, 3))
+  {
+    return false;
+  }
+
+  /* Index of older version, and interrupted build */
+  SLIDELIST_close();
+  if ((f_open(&idx, SLIDEINDEX_FILE_NAME, FA_READ) != FR_OK) ||
+      (f_read(&idx, &header, SLIDEINDEX_ENTRY_SIZE, &bytes) != FR_OK) ||
+      (f_close(&idx) != FR_OK))
+  {
+    printf("could not read index header\n");
+    return false;
+  }
+  header.version = 1;
+  if (!writeHeader(&header) ||
+      !checkOpen("index version 1", true) || !checkList(relisted, 3))
+  {
+    return false;
+  }
+  header.version = SLIDEINDEX_VERSION;
+  header.magic   = 0;
+  if (!writeHeader(&header) ||
+      !checkOpen("index build interrupted", true) || !checkList(relisted, 3))
+  {
+    return false;
+  }
+
+  /* Index deleted */
+  SLIDELIST_close();
+  f_unlink(SLIDEINDEX_FILE_NAME);
+  if (!checkOpen("index deleted", true) || !checkList(relisted, 3))
+  {
+    return false;
+  }
+  SLIDELIST_close();
+  return true;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Main function.
+ ******************************************************************************/
+int main(void)
+{
+  bool ok;
+  int  i;
+
+  if (!mkdtemp(cardDir) || !FFEMU_init(cardDir) || (f_mount(0, &fatfs) != FR_OK))
+  {
+    fprintf(stderr, "Could not make test card\n");
+    return 1;
+  }
+
+  ok = runTests();
+
+  for (i = 0; i < cardFileCount; i++)
+  {
+    removeFile(cardFiles[i]);
+  }
+  f_unlink(SLIDEINDEX_FILE_NAME);
+  rmdir(cardDir);
+
+  printf("\n%s\n", ok ? "passed" : "FAILED");
+  return ok ? 0 : 1;
+}
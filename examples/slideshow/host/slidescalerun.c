@@ -0,0 +1,337 @@
+/**************************************************************************//**
+ * @file
+ * @brief Host runner checking slideshow downscaler against a floating point reference
+ * @author Energy Micro AS
+ * @version 3.20.0
+ ******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 Energy Micro AS, http://www.energymicro.com</b>
+ *******************************************************************************
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ * 4. The source and compiled code may only be used on Energy Micro "EFM32"
+ *    microcontrollers and "EFR4" radios.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: Energy Micro AS has no
+ * obligation to support this Software. Energy Micro AS is providing the
+ * Software "AS IS", with no express or implied warranties of any kind,
+ * including, but not limited to, any implied warranties of merchantability
+ * or fitness for any particular purpose or warranties against infringement
+ * of any proprietary rights of a third party.
+ *
+ * Energy Micro AS will not be liable for any consequential, incidental, or
+ * special damages, or any other relief, or for any claim by any third party,
+ * arising from your use of this Software.
+ *
+ *****************************************************************************/
+
+/*
+   Host (Linux) runner for the slideshow downscaler (slidescale.c).
+
+   Scales test images of several sizes with the target code, pushing source
+   pixels in chunks of the slideshow row buffer (RGB_BUFFER_SIZE / 3), one
+   at a time and a row at a time, and compares each destination pixel with
+   a floating point area average of the source pixels it covers, weighted
+   by coverage. The fixed point result may be one level off, where the 8
+   fractional bits are truncated; for ratios of 1, 2 and 4 it must be
+   exact. Results must not depend on chunk size.
+
+   Then the throughput of the scaler is reported, in source and
+   destination rows per second on the host.
+
+   Usage: slidescalerun [iterations]
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include "slides.h"
+#include "slidescale.h"
+
+/** Largest test source image */
+#define TEST_MAX_WIDTH   1280
+#define TEST_MAX_HEIGHT  960
+
+/** Scaling tests */
+typedef struct
+{
+  uint32_t srcWidth;
+  uint32_t srcHeight;
+  bool     exact;       /**< Ratio where fixed point has no truncation */
+} TEST_Size_TypeDef;
+
+static const TEST_Size_TypeDef sizes[] =
+{
+  {  320,  240, true  },
+  {  640,  480, true  },
+  { 1280,  960, true  },
+  {  960,  720, false },
+  { 1024,  768, false },
+  {  400,  300, false },
+  {  333,  251, false },
+  { 1280,  100, false },
+  {  321,  959, false },
+};
+
+#define TEST_SIZES  (sizeof(sizes) / sizeof(sizes[0]))
+
+/** Source image, 24 bit RGB */
+static uint8_t src[TEST_MAX_WIDTH * TEST_MAX_HEIGHT * 3];
+
+/** Destination image, as delivered by scaler */
+static uint8_t  dst[240][SLIDESCALE_MAX_WIDTH * 3];
+static uint32_t dstRows;
+static uint32_t dstWidth;
+
+/** Scaler state, static as on target */
+static SLIDESCALE_TypeDef scaler;
+
+/***************************************************************************//**
+ * @brief
+ *   Fill source image with noise over a gradient, so that both smooth
+ *   areas and large steps between neighbors are scaled.
+ ******************************************************************************/
+static void makeSource(uint32_t width, uint32_t height)
+{
+  uint32_t seed = 12345;
+  uint32_t x, y;
+  int      c;
+  uint8_t  *p = src;
+
+  for (y = 0; y < height; y++)
+  {
+    for (x = 0; x < width; x++)
+    {
+      for (c = 0; c < 3; c++)
+      {
+        seed = (seed * 1103515245u) + 12345u;
+        if ((x / 16 + y / 16) % 2)
+        {
+          *p++ = (uint8_t)(seed >> 24);
+        }
+        else
+        {
+          *p++ = (uint8_t)(((x * 255) / width + (c * 80)) & 0xff);
+        }
+      }
+    }
+  }
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Scaler row callback, stores destination row.
+ ******************************************************************************/
+static void storeRow(uint8_t *rgb, uint32_t pixels)
+{
+  if ((dstRows < 240) && (pixels == dstWidth))
+  {
+    memcpy(dst[dstRows], rgb, pixels * 3);
+  }
+  dstRows++;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Scale source image, pushing pixels in chunks of given size.
+ ******************************************************************************/
+static bool scale(uint32_t srcWidth, uint32_t srcHeight,
+                  uint32_t width, uint32_t height, uint32_t chunk)
+{
+  uint32_t total = srcWidth * srcHeight;
+  uint32_t done;
+  uint32_t n;
+
+  dstRows  = 0;
+  dstWidth = width;
+  if (!SLIDESCALE_init(&scaler, srcWidth, srcHeight, width, height, storeRow))
+  {
+    return false;
+  }
+  for (done = 0; done < total; done += n)
+  {
+    n = total - done;
+    if (n > chunk)
+    {
+      n = chunk;
+    }
+    SLIDESCALE_push(&scaler, src + (done * 3), n);
+  }
+  return dstRows == height;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Area average of source pixels covered by destination pixel, in floating
+ *   point, rounded.
+ ******************************************************************************/
+static int reference(uint32_t srcWidth, uint32_t srcHeight,
+                     uint32_t width, uint32_t height,
+                     uint32_t dx, uint32_t dy, int c)
+{
+  double x0 = (double) dx * srcWidth / width;
+  double x1 = (double)(dx + 1) * srcWidth / width;
+  double y0 = (double) dy * srcHeight / height;
+  double y1 = (double)(dy + 1) * srcHeight / height;
+  double sum = 0.0;
+  double wx, wy;
+  uint32_t x, y;
+
+  for (y = (uint32_t) y0; (y < srcHeight) && (y < y1); y++)
+  {
+    wy = ((y + 1 < y1) ? (y + 1) : y1) - ((y > y0) ? y : y0);
+    for (x = (uint32_t) x0; (x < srcWidth) && (x < x1); x++)
+    {
+      wx   = ((x + 1 < x1) ? (x + 1) : x1) - ((x > x0) ? x : x0);
+      sum += wx * wy * src[(((y * srcWidth) + x) * 3) + c];
+    }
+  }
+  return (int)((sum / ((x1 - x0) * (y1 - y0))) + 0.5);
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Check one size, against reference and for every chunk size.
+ ******************************************************************************/
+static bool checkSize(const TEST_Size_TypeDef *size)
+{
+  static uint8_t first[240][SLIDESCALE_MAX_WIDTH * 3];
+  static const uint32_t chunks[] = { RGB_BUFFER_SIZE / 3, 1, 0 };
+  uint32_t width, height;
+  uint32_t x, y, i;
+  uint32_t off = 0;
+  int      maxErr = 0;
+  int      err;
+  int      c;
+
+  SLIDESCALE_fit(size->srcWidth, size->srcHeight, 320, 240, &width, &height);
+  makeSource(size->srcWidth, size->srcHeight);
+
+  for (i = 0; i < sizeof(chunks) / sizeof(chunks[0]); i++)
+  {
+    /* Chunk size 0 pushes a full source row at a time */
+    if (!scale(size->srcWidth, size->srcHeight, width, height,
+               chunks[i] ? chunks[i] : size->srcWidth))
+    {
+      printf("%lux%lu: %lu rows delivered, expected %lu\n",
+             (unsigned long) size->srcWidth, (unsigned long) size->srcHeight,
+             (unsigned long) dstRows, (unsigned long) height);
+      return false;
+    }
+    if (i == 0)
+    {
+      memcpy(first, dst, sizeof(first));
+    }
+    else if (memcmp(first, dst, sizeof(first)))
+    {
+      printf("%lux%lu: result depends on chunk size\n",
+             (unsigned long) size->srcWidth, (unsigned long) size->srcHeight);
+      return false;
+    }
+  }
+
+  for (y = 0; y < height; y++)
+  {
+    for (x = 0; x < width; x++)
+    {
+      for (c = 0; c < 3; c++)
+      {
+        err = abs(dst[y][(x * 3) + c] -
+                  reference(size->srcWidth, size->srcHeight, width, height, x, y, c));
+        if (err > maxErr)
+        {
+          maxErr = err;
+        }
+        if (err)
+        {
+          off++;
+        }
+      }
+    }
+  }
+
+  printf("%5lux%-5lu -> %3lux%-3lu %8lu %8lu\n",
+         (unsigned long) size->srcWidth, (unsigned long) size->srcHeight,
+         (unsigned long) width, (unsigned long) height,
+         (unsigned long) off, (unsigned long) maxErr);
+  return (maxErr <= 1) && (!size->exact || (maxErr == 0));
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Report scaler throughput for one size.
+ ******************************************************************************/
+static void benchSize(uint32_t srcWidth, uint32_t srcHeight, long iterations)
+{
+  uint32_t width, height;
+  clock_t  start;
+  double   seconds;
+  long     i;
+
+  SLIDESCALE_fit(srcWidth, srcHeight, 320, 240, &width, &height);
+  makeSource(srcWidth, srcHeight);
+
+  start = clock();
+  for (i = 0; i < iterations; i++)
+  {
+    scale(srcWidth, srcHeight, width, height, RGB_BUFFER_SIZE / 3);
+  }
+  seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+  if (seconds <= 0.0)
+  {
+    seconds = 1e-9;
+  }
+
+  printf("%5lux%-5lu -> %3lux%-3lu %12.0f %12.0f\n",
+         (unsigned long) srcWidth, (unsigned long) srcHeight,
+         (unsigned long) width, (unsigned long) height,
+         (srcHeight * iterations) / seconds, (height * iterations) / seconds);
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Main function.
+ ******************************************************************************/
+int main(int argc, char *argv[])
+{
+  long   iterations = 20;
+  bool   ok = true;
+  size_t i;
+
+  if (argc > 1)
+  {
+    iterations = atol(argv[1]);
+  }
+  if ((argc > 2) || (iterations <= 0))
+  {
+    fprintf(stderr, "Usage: %s [iterations]\n", argv[0]);
+    return 1;
+  }
+
+  printf("%-24s %8s %8s\n", "size", "off by 1", "max err");
+  for (i = 0; i < TEST_SIZES; i++)
+  {
+    if (!checkSize(&sizes[i]))
+    {
+      ok = false;
+    }
+  }
+
+  printf("\n%-24s %12s %12s\n", "size", "src rows/s", "dst rows/s");
+  benchSize(640, 480, iterations);
+  benchSize(1024, 768, iterations);
+  benchSize(1280, 960, iterations);
+
+  printf("\n%s\n", ok ? "passed" : "FAILED");
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,532 @@
+/**************************************************************************//**
+ * @file
+ * @brief Host simulation of slide switch latency on emulated microSD card and display
+ * @author Energy Micro AS
+ * @version 3.20.0
+ ******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 Energy Micro AS, http://www.energymicro.com</b>
+ *******************************************************************************
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ * 4. The source and compiled code may only be used on Energy Micro "EFM32"
+ *    microcontrollers and "EFR4" radios.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: Energy Micro AS has no
+ * obligation to support this Software. Energy Micro AS is providing the
+ * Software "AS IS", with no express or implied warranties of any kind,
+ * including, but not limited to, any implied warranties of merchantability
+ * or fitness for any particular purpose or warranties against infringement
+ * of any proprietary rights of a third party.
+ *
+ * Energy Micro AS will not be liable for any consequential, incidental, or
+ * special damages, or any other relief, or for any claim by any third party,
+ * arising from your use of this Software.
+ *
+ *****************************************************************************/
+
+/*
+   Host (Linux) simulation of slide switching.
+
+   Runs the slideshow drawing code (slides.c) unchanged on the emulated
+   microSD card and FAT file system (host/ffemu.c) and the emulated display
+   (host/dmdemu.c), and turns the card sectors and display writes counted
+   into time with the costs below. For each slide, the time from the slide
+   switch to the first row visible on the display is reported, both with
+   the slide prefetched during the dwell of the previous slide, as done by
+   the slideshow, and with the slide opened and decoded at the switch.
+   The time to show the whole prefetched slide, and the card sectors read
+   for it, are reported as well, comparing ms per slide of BMP and raw
+   RGB565 slides.
+
+   The costs are estimates for the DK, and may be changed with options to
+   match measurements on a board:
+
+     -s us  Per SD card sector, 512 bytes at 8 MHz SPI plus command
+            overhead, default 600 us
+     -t us  Per display transaction (DMD call), setting the write position
+            through the board controller SPI, default 20 us
+     -p ns  Per pixel written to the display, one 16 bit word through the
+            board controller SPI, default 2000 ns
+
+   CPU time of decoding is not included. It is small compared to the card
+   and display for BMP and raw slides, check QOI decoding with slidebench.
+   As the display is reached through the board controller SPI on the host,
+   see host/include/bsp.h, card reads and display writes do not overlap;
+   with DMA to an EBI mapped display, raw slides overlap them.
+
+   Without -d, test slides are written to a temporary directory: a 24 bit
+   BMP at display size, a smaller one with padded rows, the first one as
+   raw RGB565, and a BMP larger than the display to be scaled down. Every
+   slide is checked to be drawn correctly, except the scaled one, see
+   slidescalerun. With -d, the files in the given directory, the root
+   directory of a card, are shown in name order, without checking.
+
+   Usage: slidesim [-d dir] [-s us] [-t us] [-p ns]
+*/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include "ff.h"
+#include "ffemu.h"
+#include "dmdemu.h"
+#include "slides.h"
+#include "slideraw.h"
+#include "slidescale.h"
+#include "slideindex.h"
+
+/** Max number of slides shown */
+#define SIM_MAX_SLIDES  64
+
+/** Test slides written when no directory is given */
+typedef struct
+{
+  const char *name;
+  int        width;
+  int        height;
+  bool       raw;
+} SIM_TestSlide_TypeDef;
+
+static const SIM_TestSlide_TypeDef testSlides[] =
+{
+  { "PHOTO.BMP", 320, 240, false },
+  { "SMALL.BMP", 201, 151, false },
+  { "PHOTO.RAW", 320, 240, true  },
+  { "LARGE.BMP", 640, 480, false },
+};
+
+#define SIM_TEST_SLIDES  (sizeof(testSlides) / sizeof(testSlides[0]))
+
+/** Costs, in us per sector and transaction, ns per pixel */
+static double usPerSector      = 600.0;
+static double usPerTransaction = 20.0;
+static double nsPerPixel       = 2000.0;
+
+/** Pixels written and time when slide was switched */
+static uint32_t switchPixels;
+static double   switchTime;
+
+/** Width of slide on display, and time its first row was visible */
+static uint32_t rowPixels;
+static double   rowTime;
+
+/** File system of emulated card */
+static FATFS fatfs;
+
+/***************************************************************************//**
+ * @brief
+ *   Time in us spent on card and display since counters were reset.
+ ******************************************************************************/
+static double simTime(void)
+{
+  return ((ffemuCount.sectorsRead + ffemuCount.sectorsWritten) * usPerSector) +
+         (dmdemuCount.transactions * usPerTransaction) +
+         (dmdemuCount.pixels * nsPerPixel / 1000.0);
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Display write hook, notes time when a full row of the slide is written.
+ ******************************************************************************/
+static void rowHook(void)
+{
+  if ((rowTime < 0) && rowPixels &&
+      ((dmdemuCount.pixels - switchPixels) >= rowPixels))
+  {
+    rowTime = simTime();
+  }
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Note slide switch, for timing the first row of a slide of given width.
+ ******************************************************************************/
+static void startSwitch(uint32_t width)
+{
+  switchPixels = dmdemuCount.pixels;
+  switchTime   = simTime();
+  rowPixels    = width;
+  rowTime      = -1.0;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Color of test slide pixel, a gradient with some detail.
+ ******************************************************************************/
+static void testPixel(const SIM_TestSlide_TypeDef *slide, int x, int y, uint8_t *rgb)
+{
+  rgb[0] = (uint8_t)((x * 255) / (slide->width - 1));
+  rgb[1] = (uint8_t)((y * 255) / (slide->height - 1));
+  rgb[2] = (uint8_t)((x * 7) ^ (y * 13));
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Store little endian value.
+ ******************************************************************************/
+static void putLE(uint8_t *p, uint32_t value, int bytes)
+{
+  while (bytes--)
+  {
+    *p++    = (uint8_t) value;
+    value >>= 8;
+  }
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Write test slide as 24 bit BMP or raw RGB565 file.
+ ******************************************************************************/
+static bool writeTestSlide(const char *dir, const SIM_TestSlide_TypeDef *slide)
+{
+  char    path[300];
+  uint8_t header[SLIDERAW_DATA_OFFSET];
+  uint8_t rgb[3];
+  uint8_t out[3];
+  FILE    *f;
+  int     rowBytes = ((slide->width * 3) + 3) & ~3;
+  int     x, y, row;
+  bool    ok;
+
+  snprintf(path, sizeof(path), "%s/%s", dir, slide->name);
+  f = fopen(path, "wb");
+  if (!f)
+  {
+    return false;
+  }
+  memset(header, 0, sizeof(header));
+
+  if (slide->raw)
+  {
+    putLE(header, SLIDERAW_MAGIC, 4);
+    putLE(header + 4, slide->width, 2);
+    putLE(header + 6, slide->height, 2);
+    putLE(header + 8, SLIDERAW_DATA_OFFSET, 4);
+    fwrite(header, 1, SLIDERAW_DATA_OFFSET, f);
+    for (y = 0; y < slide->height; y++)
+    {
+      for (x = 0; x < slide->width; x++)
+      {
+        testPixel(slide, x, y, rgb);
+        putLE(out, ((rgb[0] & 0xf8) << 8) | ((rgb[1] & 0xfc) << 3) | (rgb[2] >> 3), 2);
+        fwrite(out, 1, 2, f);
+      }
+    }
+  }
+  else
+  {
+    header[0] = 'B';
+    header[1] = 'M';
+    putLE(header + 2, 54 + (rowBytes * slide->height), 4);
+    putLE(header + 10, 54, 4);
+    putLE(header + 14, 40, 4);
+    putLE(header + 18, slide->width, 4);
+    putLE(header + 22, slide->height, 4);
+    putLE(header + 26, 1, 2);
+    putLE(header + 28, 24, 2);
+    putLE(header + 34, rowBytes * slide->height, 4);
+    fwrite(header, 1, 54, f);
+
+    /* Bottom-up, blue first, rows padded to 4 bytes */
+    for (row = slide->height - 1; row >= 0; row--)
+    {
+      for (x = 0; x < slide->width; x++)
+      {
+        testPixel(slide, x, row, rgb);
+        out[0] = rgb[2];
+        out[1] = rgb[1];
+        out[2] = rgb[0];
+        fwrite(out, 1, 3, f);
+      }
+      memset(out, 0, sizeof(out));
+      fwrite(out, 1, rowBytes - (slide->width * 3), f);
+    }
+  }
+  ok = !ferror(f);
+  return (fclose(f) == 0) && ok;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Check that test slide is drawn at top left of display.
+ ******************************************************************************/
+static bool checkTestSlide(const SIM_TestSlide_TypeDef *slide)
+{
+  uint8_t  rgb[3];
+  uint16_t expected;
+  int      x, y;
+
+  for (y = 0; y < slide->height; y++)
+  {
+    for (x = 0; x < slide->width; x++)
+    {
+      testPixel(slide, x, y, rgb);
+      expected = (uint16_t)(((rgb[0] & 0xf8) << 8) | ((rgb[1] & 0xfc) << 3) | (rgb[2] >> 3));
+      if (dmdemuFramebuffer[y][x] != expected)
+      {
+        printf("%s: pixel (%d,%d) is %04x, expected %04x\n", slide->name,
+               x, y, dmdemuFramebuffer[y][x], expected);
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Find width of slide on display, from the same probe as the slide index.
+ * @return
+ *   Width in pixels, 0 if file is not a slide.
+ ******************************************************************************/
+static uint32_t slideWidth(const char *name)
+{
+  SLIDEINDEX_Entry_TypeDef entry;
+  uint8_t                  probe[SLIDEINDEX_PROBE_SIZE];
+  uint32_t                 width;
+  uint32_t                 height;
+  FIL                      file;
+  UINT                     bytes;
+  bool                     ok;
+
+  if (f_open(&file, name, FA_READ) != FR_OK)
+  {
+    return 0;
+  }
+  ok = (f_read(&file, probe, sizeof(probe), &bytes) == FR_OK) &&
+       SLIDEINDEX_identify(&entry, probe, bytes, f_size(&file));
+  f_close(&file);
+  if (!ok)
+  {
+    return 0;
+  }
+
+  width  = entry.width;
+  height = entry.height;
+  if ((entry.format == SLIDEINDEX_FORMAT_BMP) && ((width > 320) || (height > 240)))
+  {
+    SLIDESCALE_fit(entry.width, entry.height, 320, 240, &width, &height);
+  }
+  return width;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Print time in ms, or a dash if not reached.
+ ******************************************************************************/
+static void printTime(double us)
+{
+  if (us < 0)
+  {
+    printf(" %10s", "-");
+  }
+  else
+  {
+    printf(" %10.1f", us / 1000.0);
+  }
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Show slide opened at the switch, and prefetched before the switch.
+ * @param[out] slideTime
+ *   Time from switch until prefetched slide is shown completely, us.
+ * @return
+ *   false if a test slide was drawn incorrectly.
+ ******************************************************************************/
+static bool simSlide(char *name, const SIM_TestSlide_TypeDef *test, double *slideTime)
+{
+  uint32_t width = slideWidth(name);
+  uint32_t sectors;
+  double   openedRow;
+  double   aheadTime;
+  bool     ok = true;
+
+  /* Opened, decoded and drawn at switch */
+  startSwitch(width);
+  SLIDES_showBMP(name);
+  openedRow = (rowTime < 0) ? rowTime : (rowTime - switchTime);
+  if (test && (test->width <= 320))
+  {
+    ok = checkTestSlide(test);
+  }
+
+  /* Prefetched while previous slide is shown, drawn at switch */
+  aheadTime = simTime();
+  SLIDES_prefetchBMP(name);
+  aheadTime = simTime() - aheadTime;
+  startSwitch(width);
+  sectors = ffemuCount.sectorsRead;
+  SLIDES_showPrefetched();
+  *slideTime = simTime() - switchTime;
+  sectors    = ffemuCount.sectorsRead - sectors;
+  if (test && (test->width <= 320))
+  {
+    ok = ok && checkTestSlide(test);
+  }
+
+  printf("%-12s %5lu", name, (unsigned long) width);
+  printTime(openedRow);
+  printTime((rowTime < 0) ? rowTime : (rowTime - switchTime));
+  printTime(aheadTime);
+  printTime(*slideTime);
+  printf(" %8lu\n", (unsigned long) sectors);
+  return ok;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Remove test slides and their directory.
+ ******************************************************************************/
+static void removeTestSlides(const char *dir)
+{
+  char   path[300];
+  size_t i;
+
+  for (i = 0; i < SIM_TEST_SLIDES; i++)
+  {
+    snprintf(path, sizeof(path), "%s/%s", dir, testSlides[i].name);
+    remove(path);
+  }
+  rmdir(dir);
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Main function.
+ ******************************************************************************/
+int main(int argc, char *argv[])
+{
+  char     tempDir[] = "/tmp/slidesimXXXXXX";
+  char     names[SIM_MAX_SLIDES][13];
+  double   times[SIM_MAX_SLIDES];
+  double   bmpTime = -1.0;
+  double   rawTime = -1.0;
+  char     *dir = NULL;
+  const SIM_TestSlide_TypeDef *test;
+  FILINFO  info;
+  DIR      root;
+  size_t   count = 0;
+  size_t   i;
+  size_t   n;
+  bool     ok = true;
+  int      opt;
+
+  while ((opt = getopt(argc, argv, "d:s:t:p:")) != -1)
+  {
+    switch (opt)
+    {
+    case 'd':
+      dir = optarg;
+      break;
+    case 's':
+      usPerSector = atof(optarg);
+      break;
+    case 't':
+      usPerTransaction = atof(optarg);
+      break;
+    case 'p':
+      nsPerPixel = atof(optarg);
+      break;
+    default:
+      fprintf(stderr, "Usage: %s [-d dir] [-s us] [-t us] [-p ns]\n", argv[0]);
+      return 1;
+    }
+  }
+
+  if (!dir)
+  {
+    dir = mkdtemp(tempDir);
+    for (i = 0; dir && (i < SIM_TEST_SLIDES); i++)
+    {
+      if (!writeTestSlide(dir, &testSlides[i]))
+      {
+        dir = NULL;
+      }
+    }
+    if (!dir)
+    {
+      fprintf(stderr, "Could not write test slides\n");
+      removeTestSlides(tempDir);
+      return 1;
+    }
+  }
+  if (!FFEMU_init(dir) || (f_mount(0, &fatfs) != FR_OK))
+  {
+    fprintf(stderr, "Could not open %s\n", dir);
+    return 1;
+  }
+
+  /* Slides in name order */
+  if (f_opendir(&root, "") == FR_OK)
+  {
+    while ((count < SIM_MAX_SLIDES) && (f_readdir(&root, &info) == FR_OK) && info.fname[0])
+    {
+      if (!(info.fattrib & AM_DIR))
+      {
+        strcpy(names[count++], info.fname);
+      }
+    }
+  }
+
+  DMDEMU_reset();
+  dmdemuWriteHook = rowHook;
+  SLIDES_init();
+  FFEMU_resetCount();
+  DMDEMU_resetCount();
+
+  printf("%.0f us per sector, %.0f us per transaction, %.0f ns per pixel\n\n",
+         usPerSector, usPerTransaction, nsPerPixel);
+  printf("%-12s %5s %10s %10s %10s %10s %8s\n",
+         "", "", "first row", "first row", "prefetch", "slide", "slide");
+  printf("%-12s %5s %10s %10s %10s %10s %8s\n",
+         "slide", "width", "opened ms", "prefet. ms", "ahead ms", "ms", "sectors");
+
+  for (i = 0; i < count; i++)
+  {
+    test = NULL;
+    for (n = 0; (dir == tempDir) && (n < SIM_TEST_SLIDES); n++)
+    {
+      if (!strcmp(names[i], testSlides[n].name))
+      {
+        test = &testSlides[n];
+      }
+    }
+    ok = simSlide(names[i], test, &times[i]) && ok;
+    if (test && !strcmp(test->name, "PHOTO.BMP"))
+    {
+      bmpTime = times[i];
+    }
+    if (test && !strcmp(test->name, "PHOTO.RAW"))
+    {
+      rawTime = times[i];
+    }
+  }
+
+  /* Same image at display size, as BMP and as raw RGB565 */
+  if ((bmpTime > 0) && (rawTime > 0))
+  {
+    printf("\nPHOTO per slide: BMP %.1f ms, raw %.1f ms, raw saves %.1f%%\n",
+           bmpTime / 1000.0, rawTime / 1000.0, 100.0 * (bmpTime - rawTime) / bmpTime);
+  }
+
+  if (dir == tempDir)
+  {
+    removeTestSlides(tempDir);
+  }
+  printf("\n%s\n", ok ? "passed" : "FAILED");
+  return ok ? 0 : 1;
+}
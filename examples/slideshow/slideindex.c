@@ -0,0 +1,254 @@
+/**************************************************************************//**
+ * @file
+ * @brief Slide index file format for slideshow
+ * @author Energy Micro AS
+ * @version 3.20.0
+ ******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 Energy Micro AS, http://www.energymicro.com</b>
+ *******************************************************************************
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ * 4. The source and compiled code may only be used on Energy Micro "EFM32"
+ *    microcontrollers and "EFR4" radios.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: Energy Micro AS has no
+ * obligation to support this Software. Energy Micro AS is providing the
+ * Software "AS IS", with no express or implied warranties of any kind,
+ * including, but not limited to, any implied warranties of merchantability
+ * or fitness for any particular purpose or warranties against infringement
+ * of any proprietary rights of a third party.
+ *
+ * Energy Micro AS will not be liable for any consequential, incidental, or
+ * special damages, or any other relief, or for any claim by any third party,
+ * arising from your use of this Software.
+ *
+ *****************************************************************************/
+#include <string.h>
+#include "slideindex.h"
+#include "slideraw.h"
+#include "slideqoi.h"
+
+/***************************************************************************//**
+ * @brief
+ *   Get little endian 16 or 32 bit value.
+ ******************************************************************************/
+static uint32_t SLIDEINDEX_getLE(const uint8_t *p, int bytes)
+{
+  uint32_t v = 0;
+
+  while (bytes--)
+  {
+    v = (v << 8) | p[bytes];
+  }
+  return v;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Get big endian 32 bit value.
+ ******************************************************************************/
+static uint32_t SLIDEINDEX_getBE32(const uint8_t *p)
+{
+  return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) |
+         ((uint32_t)p[2] << 8) | p[3];
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Store image size in entry, saturated to 16 bits.
+ ******************************************************************************/
+static void SLIDEINDEX_setSize(SLIDEINDEX_Entry_TypeDef *entry,
+                               uint32_t width,
+                               uint32_t height)
+{
+  entry->width  = (uint16_t)((width > 0xffff) ? 0xffff : width);
+  entry->height = (uint16_t)((height > 0xffff) ? 0xffff : height);
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Initialize index file header.
+ *
+ * @param[out] header
+ *   Header to initialize.
+ *
+ * @param[in] count
+ *   Number of entries in index.
+ ******************************************************************************/
+void SLIDEINDEX_initHeader(SLIDEINDEX_Header_TypeDef *header, uint32_t count)
+{
+  memset(header, 0, sizeof(SLIDEINDEX_Header_TypeDef));
+  header->magic     = SLIDEINDEX_MAGIC;
+  header->version   = SLIDEINDEX_VERSION;
+  header->count     = count;
+  header->entrySize = SLIDEINDEX_ENTRY_SIZE;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Check if index file header is valid and supported.
+ *
+ * @param[in] header
+ *   Header read from index file.
+ *
+ * @return
+ *   true if index can be used, false otherwise.
+ ******************************************************************************/
+bool SLIDEINDEX_checkHeader(const SLIDEINDEX_Header_TypeDef *header)
+{
+  return (header->magic == SLIDEINDEX_MAGIC) &&
+         (header->version == SLIDEINDEX_VERSION) &&
+         (header->entrySize == SLIDEINDEX_ENTRY_SIZE);
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Clear entry and set its file name. Trailing line endings and white
+ *   space, as read from a manifest file, are removed.
+ *
+ * @param[out] entry
+ *   Entry to initialize.
+ *
+ * @param[in] name
+ *   File name.
+ *
+ * @return
+ *   false if name is empty or too long to fit in entry, true otherwise.
+ ******************************************************************************/
+bool SLIDEINDEX_setName(SLIDEINDEX_Entry_TypeDef *entry, const char *name)
+{
+  size_t length = strlen(name);
+
+  memset(entry, 0, sizeof(SLIDEINDEX_Entry_TypeDef));
+
+  while (length && ((name[length - 1] == '\n') || (name[length - 1] == '\r') ||
+                    (name[length - 1] == ' ') || (name[length - 1] == '\t')))
+  {
+    length--;
+  }
+  if ((length == 0) || (length >= SLIDEINDEX_NAME_SIZE))
+  {
+    return false;
+  }
+
+  memcpy(entry->name, name, length);
+  return true;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Identify slide format and image size from start of file.
+ *
+ * @param[in,out] entry
+ *   Entry receiving file size, image size and format.
+ *
+ * @param[in] data
+ *   First bytes of file, SLIDEINDEX_PROBE_SIZE bytes needed for BMP files.
+ *
+ * @param[in] length
+ *   Number of bytes in data.
+ *
+ * @param[in] fileSize
+ *   Size of file.
+ *
+ * @return
+ *   true if file is a supported slide, false otherwise.
+ ******************************************************************************/
+bool SLIDEINDEX_identify(SLIDEINDEX_Entry_TypeDef *entry,
+                         const uint8_t *data,
+                         uint32_t length,
+                         uint32_t fileSize)
+{
+  int32_t height;
+
+  entry->size   = fileSize;
+  entry->format = SLIDEINDEX_FORMAT_UNKNOWN;
+  SLIDEINDEX_setSize(entry, 0, 0);
+
+  if ((length >= SLIDEINDEX_PROBE_SIZE) && (data[0] == 'B') && (data[1] == 'M'))
+  {
+    /* Height is negative for top-down BMP files */
+    height = (int32_t)SLIDEINDEX_getLE(data + 22, 4);
+    SLIDEINDEX_setSize(entry, SLIDEINDEX_getLE(data + 18, 4),
+                       (uint32_t)((height < 0) ? -height : height));
+    entry->format = SLIDEINDEX_FORMAT_BMP;
+  }
+  else if ((length >= SLIDERAW_HEADER_SIZE) &&
+           (SLIDEINDEX_getLE(data, 4) == SLIDERAW_MAGIC))
+  {
+    SLIDEINDEX_setSize(entry, SLIDEINDEX_getLE(data + 4, 2),
+                       SLIDEINDEX_getLE(data + 6, 2));
+    entry->format = SLIDEINDEX_FORMAT_RAW;
+  }
+  else if ((length >= SLIDEQOI_HEADER_SIZE) &&
+           (SLIDEINDEX_getBE32(data) == SLIDEQOI_MAGIC))
+  {
+    SLIDEINDEX_setSize(entry, SLIDEINDEX_getBE32(data + 4),
+                       SLIDEINDEX_getBE32(data + 8));
+    entry->format = SLIDEINDEX_FORMAT_QOI;
+  }
+
+  return entry->format != SLIDEINDEX_FORMAT_UNKNOWN;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Add file in root directory to directory signature. Each file adds an
+ *   FNV-1a hash of its name, size and modification time, so the signature
+ *   does not depend on the order of directory entries.
+ *
+ * @param[in] signature
+ *   Signature of files added so far, 0 for none.
+ *
+ * @param[in] name
+ *   File name, as listed in directory.
+ *
+ * @param[in] fileSize
+ *   File size in bytes.
+ *
+ * @param[in] date
+ *   Modification date, FAT format.
+ *
+ * @param[in] time
+ *   Modification time, FAT format.
+ *
+ * @return
+ *   New signature.
+ ******************************************************************************/
+uint32_t SLIDEINDEX_addSignature(uint32_t signature,
+                                 const char *name,
+                                 uint32_t fileSize,
+                                 uint16_t date,
+                                 uint16_t time)
+{
+  uint32_t hash = 2166136261UL;
+  uint32_t value;
+  int      i;
+
+  while (*name)
+  {
+    hash = (hash ^ (uint8_t) *name++) * 16777619UL;
+  }
+  value = fileSize;
+  for (i = 0; i < 4; i++)
+  {
+    hash    = (hash ^ (value & 0xff)) * 16777619UL;
+    value >>= 8;
+  }
+  value = ((uint32_t) date << 16) | time;
+  for (i = 0; i < 4; i++)
+  {
+    hash    = (hash ^ (value & 0xff)) * 16777619UL;
+    value >>= 8;
+  }
+  return signature + hash;
+}
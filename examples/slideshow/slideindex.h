@@ -0,0 +1,129 @@
+/**************************************************************************//**
+ * @file
+ * @brief Slide index file format for slideshow
+ * @author Energy Micro AS
+ * @version 3.20.0
+ ******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 Energy Micro AS, http://www.energymicro.com</b>
+ *******************************************************************************
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ * 4. The source and compiled code may only be used on Energy Micro "EFM32"
+ *    microcontrollers and "EFR4" radios.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: Energy Micro AS has no
+ * obligation to support this Software. Energy Micro AS is providing the
+ * Software "AS IS", with no express or implied warranties of any kind,
+ * including, but not limited to, any implied warranties of merchantability
+ * or fitness for any particular purpose or warranties against infringement
+ * of any proprietary rights of a third party.
+ *
+ * Energy Micro AS will not be liable for any consequential, incidental, or
+ * special damages, or any other relief, or for any claim by any third party,
+ * arising from your use of this Software.
+ *
+ *****************************************************************************/
+#ifndef __SLIDEINDEX_H
+#define __SLIDEINDEX_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+   Slide index file format:
+
+   Offset  Size  Content
+   0       32    Header, SLIDEINDEX_Header_TypeDef
+   32      32    Entry for first slide, SLIDEINDEX_Entry_TypeDef
+   64      32    Entry for second slide, and so on
+
+   All fields are little endian. With fixed size entries, the entry for any
+   slide is found by a single seek, and 16 entries share an SD card sector.
+   The index is built by the slideshow if not present on the card, or by
+   the host tool host/slideindex.
+
+   The header holds a signature of the root directory, a sum of hashes of
+   the name, size and modification time of every file but the index
+   itself, and the number of those files. When a file is added, deleted
+   or changed, including files.txt, the signature no longer matches and
+   the index is built again, see slidelist.c.
+*/
+
+/** Name of index file on card */
+#define SLIDEINDEX_FILE_NAME   "slides.idx"
+
+/** "SIDX" read as a little endian 32 bit word */
+#define SLIDEINDEX_MAGIC       0x58444953UL
+
+/** Current index format version, 2 added the root directory signature */
+#define SLIDEINDEX_VERSION     2
+
+/** Size of header and of each entry */
+#define SLIDEINDEX_ENTRY_SIZE  32
+
+/** Size of name field, including terminating zero */
+#define SLIDEINDEX_NAME_SIZE   20
+
+/** Number of bytes from start of file needed to identify slide format */
+#define SLIDEINDEX_PROBE_SIZE  26
+
+/** Slide formats */
+#define SLIDEINDEX_FORMAT_UNKNOWN  0
+#define SLIDEINDEX_FORMAT_BMP      1
+#define SLIDEINDEX_FORMAT_RAW      2
+#define SLIDEINDEX_FORMAT_QOI      3
+
+/** Header of slide index file */
+typedef struct
+{
+  uint32_t magic;        /**< SLIDEINDEX_MAGIC */
+  uint32_t version;      /**< SLIDEINDEX_VERSION */
+  uint32_t count;        /**< Number of entries */
+  uint32_t entrySize;    /**< SLIDEINDEX_ENTRY_SIZE */
+  uint32_t signature;    /**< Signature of root directory */
+  uint32_t files;        /**< Files in root directory, index excluded */
+  uint32_t reserved[2];  /**< Reserved, 0 */
+} SLIDEINDEX_Header_TypeDef;
+
+/** Slide index entry */
+typedef struct
+{
+  char     name[SLIDEINDEX_NAME_SIZE];  /**< File name, zero terminated */
+  uint32_t size;                        /**< File size in bytes */
+  uint16_t width;                       /**< Width in pixels */
+  uint16_t height;                      /**< Height in pixels */
+  uint8_t  format;                      /**< SLIDEINDEX_FORMAT_xxx */
+  uint8_t  reserved[3];                 /**< Reserved, 0 */
+} SLIDEINDEX_Entry_TypeDef;
+
+void SLIDEINDEX_initHeader(SLIDEINDEX_Header_TypeDef *header, uint32_t count);
+bool SLIDEINDEX_checkHeader(const SLIDEINDEX_Header_TypeDef *header);
+bool SLIDEINDEX_setName(SLIDEINDEX_Entry_TypeDef *entry, const char *name);
+bool SLIDEINDEX_identify(SLIDEINDEX_Entry_TypeDef *entry,
+                         const uint8_t *data,
+                         uint32_t length,
+                         uint32_t fileSize);
+uint32_t SLIDEINDEX_addSignature(uint32_t signature,
+                                 const char *name,
+                                 uint32_t fileSize,
+                                 uint16_t date,
+                                 uint16_t time);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
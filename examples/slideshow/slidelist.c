@@ -0,0 +1,307 @@
+/**************************************************************************//**
+ * @file
+ * @brief Slide list of slideshow, read from slide index on microSD card
+ * @author Energy Micro AS
+ * @version 3.20.0
+ ******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 Energy Micro AS, http://www.energymicro.com</b>
+ *******************************************************************************
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ * 4. The source and compiled code may only be used on Energy Micro "EFM32"
+ *    microcontrollers and "EFR4" radios.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: Energy Micro AS has no
+ * obligation to support this Software. Energy Micro AS is providing the
+ * Software "AS IS", with no express or implied warranties of any kind,
+ * including, but not limited to, any implied warranties of merchantability
+ * or fitness for any particular purpose or warranties against infringement
+ * of any proprietary rights of a third party.
+ *
+ * Energy Micro AS will not be liable for any consequential, incidental, or
+ * special damages, or any other relief, or for any claim by any third party,
+ * arising from your use of this Software.
+ *
+ *****************************************************************************/
+#include <string.h>
+#include <stdbool.h>
+#include "ff.h"
+#include "slides.h"
+#include "slideindex.h"
+#include "slidelist.h"
+
+/* Slide index, kept open while slideshow runs */
+static FIL      indexFile;
+static bool     indexOpen;
+static uint32_t slideCount;
+static uint32_t slideNext;
+
+/* Manifest file or slide being probed, used while building index */
+static FIL      listFile;
+static char     listLine[100];
+
+/**************************************************************************//**
+ * @brief
+ *   Compute signature of root directory, over all files but the index, see
+ *   SLIDEINDEX_addSignature(). Reads one directory sector per 16 entries.
+ * @param[out] signature
+ *   Signature of root directory.
+ * @param[out] files
+ *   Number of files included.
+ * @return
+ *   FR_OK if root directory was read, otherwise FatFS error code.
+ *****************************************************************************/
+FRESULT SLIDELIST_signature(uint32_t *signature, uint32_t *files)
+{
+  FRESULT res;
+  FILINFO Finfo;
+  DIR     dir;
+
+  *signature = 0;
+  *files     = 0;
+
+  res = f_opendir(&dir, "");
+  while (res == FR_OK)
+  {
+    res = f_readdir(&dir, &Finfo);
+    if ((res != FR_OK) || !Finfo.fname[0])
+      break;
+    if ((Finfo.fattrib & AM_DIR) || !strcmp(Finfo.fname, "SLIDES.IDX"))
+      continue;
+    *signature = SLIDEINDEX_addSignature(*signature, Finfo.fname, Finfo.fsize,
+                                         Finfo.fdate, Finfo.ftime);
+    (*files)++;
+  }
+  return res;
+}
+
+/**************************************************************************//**
+ * @brief
+ *   Build slide index file. Names are taken from the manifest file, if
+ *   present, otherwise from the root directory. Each file is then opened
+ *   to find its format and image size, and files not recognized as slides
+ *   are left out. Names longer than SLIDEINDEX_NAME_SIZE - 1 characters
+ *   cannot be opened by the slideshow, and are also left out. The index
+ *   is closed when built.
+ * @return
+ *   FR_OK if index was built, otherwise FatFS error code.
+ *****************************************************************************/
+FRESULT SLIDELIST_build(void)
+{
+  FRESULT                   res;
+  FILINFO                   Finfo;
+  DIR                       dir;
+  SLIDEINDEX_Header_TypeDef header;
+  SLIDEINDEX_Entry_TypeDef  entry;
+  uint8_t                   probe[SLIDEINDEX_PROBE_SIZE];
+  uint32_t                  signature;
+  uint32_t                  files;
+  uint32_t                  count = 0;
+  uint32_t                  used = 0;
+  uint32_t                  i;
+  UINT                      bytes;
+
+  /* Signature of card contents the index is built from */
+  res = SLIDELIST_signature(&signature, &files);
+  if (res != FR_OK)
+    return res;
+
+  res = f_open(&indexFile, SLIDEINDEX_FILE_NAME, FA_READ | FA_WRITE | FA_CREATE_ALWAYS);
+  if (res != FR_OK)
+    return res;
+
+  /* Header is written last, an interrupted build leaves an invalid index */
+  SLIDEINDEX_initHeader(&header, 0);
+  header.magic = 0;
+  res = f_write(&indexFile, &header, SLIDEINDEX_ENTRY_SIZE, &bytes);
+
+  /* Pass 1: write an entry for each name */
+  if (f_open(&listFile, "files.txt", FA_READ) == FR_OK)
+  {
+    while ((res == FR_OK) && f_gets(listLine, sizeof(listLine), &listFile))
+    {
+      if (SLIDEINDEX_setName(&entry, listLine))
+      {
+        res = f_write(&indexFile, &entry, SLIDEINDEX_ENTRY_SIZE, &bytes);
+        count++;
+      }
+    }
+    f_close(&listFile);
+  }
+  else
+  {
+    if (res == FR_OK)
+      res = f_opendir(&dir, "");
+    while (res == FR_OK)
+    {
+      res = f_readdir(&dir, &Finfo);
+      if ((res != FR_OK) || !Finfo.fname[0])
+        break;
+      if ((Finfo.fattrib & AM_DIR) ||
+          !strcmp(Finfo.fname, "FILES.TXT") ||
+          !strcmp(Finfo.fname, "SLIDES.IDX"))
+        continue;
+      if (SLIDEINDEX_setName(&entry, Finfo.fname))
+      {
+        res = f_write(&indexFile, &entry, SLIDEINDEX_ENTRY_SIZE, &bytes);
+        count++;
+      }
+    }
+  }
+
+  /* Pass 2: identify each file, compacting the index to slides only. */
+  /* Only one file is opened at a time besides the index itself. */
+  for (i = 0; (res == FR_OK) && (i < count); i++)
+  {
+    res = f_lseek(&indexFile, (i + 1) * SLIDEINDEX_ENTRY_SIZE);
+    if (res == FR_OK)
+      res = f_read(&indexFile, &entry, SLIDEINDEX_ENTRY_SIZE, &bytes);
+    if ((res != FR_OK) || (f_open(&listFile, entry.name, FA_READ) != FR_OK))
+      continue;
+
+    if ((f_read(&listFile, probe, SLIDEINDEX_PROBE_SIZE, &bytes) == FR_OK) &&
+        SLIDEINDEX_identify(&entry, probe, bytes, f_size(&listFile)))
+    {
+      res = f_lseek(&indexFile, (used + 1) * SLIDEINDEX_ENTRY_SIZE);
+      if (res == FR_OK)
+        res = f_write(&indexFile, &entry, SLIDEINDEX_ENTRY_SIZE, &bytes);
+      used++;
+    }
+    f_close(&listFile);
+  }
+
+  /* Drop entries left over from compaction, and finally write header */
+  if (res == FR_OK)
+    res = f_lseek(&indexFile, (used + 1) * SLIDEINDEX_ENTRY_SIZE);
+  if (res == FR_OK)
+    res = f_truncate(&indexFile);
+  if (res == FR_OK)
+    res = f_lseek(&indexFile, 0);
+  if (res == FR_OK)
+  {
+    SLIDEINDEX_initHeader(&header, used);
+    header.signature = signature;
+    header.files     = files;
+    res = f_write(&indexFile, &header, SLIDEINDEX_ENTRY_SIZE, &bytes);
+  }
+
+  f_close(&indexFile);
+  return res;
+}
+
+/**************************************************************************//**
+ * @brief
+ *   Open slide index file, building it first if not present, invalid, or
+ *   built from other card contents than present.
+ * @return
+ *   FR_OK if index is ready, otherwise FatFS error code.
+ *****************************************************************************/
+FRESULT SLIDELIST_open(void)
+{
+  SLIDEINDEX_Header_TypeDef header;
+  FRESULT                   res;
+  UINT                      bytes;
+  uint32_t                  signature;
+  uint32_t                  files;
+  int                       attempt;
+
+  SLIDELIST_close();
+
+  res = SLIDELIST_signature(&signature, &files);
+  if (res != FR_OK)
+    return res;
+
+  for (attempt = 0; attempt < 2; attempt++)
+  {
+    res = f_open(&indexFile, SLIDEINDEX_FILE_NAME, FA_READ);
+    if (res == FR_OK)
+    {
+      res = f_read(&indexFile, &header, SLIDEINDEX_ENTRY_SIZE, &bytes);
+      if ((res == FR_OK) && (bytes == SLIDEINDEX_ENTRY_SIZE) &&
+          SLIDEINDEX_checkHeader(&header) &&
+          (header.signature == signature) && (header.files == files))
+      {
+        indexOpen  = true;
+        slideCount = header.count;
+        slideNext  = 0;
+        return FR_OK;
+      }
+      f_close(&indexFile);
+    }
+
+    if (attempt == 0)
+    {
+      res = SLIDELIST_build();
+      if (res != FR_OK)
+        return res;
+    }
+  }
+  return FR_INT_ERR;
+}
+
+/**************************************************************************//**
+ * @brief
+ *   Get file name of next slide from slide index. Wraps around to first
+ *   slide at end.
+ * @param fileName
+ *   Buffer receiving file name, must hold SLIDES_NAME_SIZE characters.
+ * @return
+ *   FR_OK if a file name was found, otherwise FatFS error code.
+ *****************************************************************************/
+FRESULT SLIDELIST_next(char *fileName)
+{
+  SLIDEINDEX_Entry_TypeDef entry;
+  FRESULT                  res;
+  UINT                     bytes;
+
+  if (slideCount == 0)
+    return FR_NO_FILE;
+  if (slideNext >= slideCount)
+    slideNext = 0;
+
+  /* Fixed size entries, a single seek finds any slide */
+  res = f_lseek(&indexFile, (slideNext + 1) * SLIDEINDEX_ENTRY_SIZE);
+  if (res == FR_OK)
+    res = f_read(&indexFile, &entry, SLIDEINDEX_ENTRY_SIZE, &bytes);
+  if (res != FR_OK)
+    return res;
+  if (bytes != SLIDEINDEX_ENTRY_SIZE)
+    return FR_INT_ERR;
+
+  slideNext++;
+  entry.name[SLIDEINDEX_NAME_SIZE - 1] = '\0';
+  strncpy(fileName, entry.name, SLIDES_NAME_SIZE - 1);
+  fileName[SLIDES_NAME_SIZE - 1] = '\0';
+  return FR_OK;
+}
+
+/**************************************************************************//**
+ * @brief
+ *   Get number of slides in index opened by SLIDELIST_open().
+ *****************************************************************************/
+uint32_t SLIDELIST_count(void)
+{
+  return slideCount;
+}
+
+/**************************************************************************//**
+ * @brief
+ *   Close slide index opened by SLIDELIST_open().
+ *****************************************************************************/
+void SLIDELIST_close(void)
+{
+  if (indexOpen)
+    f_close(&indexFile);
+  indexOpen  = false;
+  slideCount = 0;
+  slideNext  = 0;
+}
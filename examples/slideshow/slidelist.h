@@ -0,0 +1,67 @@
+/**************************************************************************//**
+ * @file
+ * @brief Slide list of slideshow, read from slide index on microSD card
+ * @author Energy Micro AS
+ * @version 3.20.0
+ ******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 Energy Micro AS, http://www.energymicro.com</b>
+ *******************************************************************************
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ * 4. The source and compiled code may only be used on Energy Micro "EFM32"
+ *    microcontrollers and "EFR4" radios.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: Energy Micro AS has no
+ * obligation to support this Software. Energy Micro AS is providing the
+ * Software "AS IS", with no express or implied warranties of any kind,
+ * including, but not limited to, any implied warranties of merchantability
+ * or fitness for any particular purpose or warranties against infringement
+ * of any proprietary rights of a third party.
+ *
+ * Energy Micro AS will not be liable for any consequential, incidental, or
+ * special damages, or any other relief, or for any claim by any third party,
+ * arising from your use of this Software.
+ *
+ *****************************************************************************/
+#ifndef __SLIDELIST_H
+#define __SLIDELIST_H
+
+#include <stdint.h>
+#include "ff.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+   Slide list of the slideshow, read from the slide index file (see
+   slideindex.h) on the microSD card through FatFS.
+
+   SLIDELIST_open() checks the signature of the root directory stored in
+   the index against the card, and builds the index again when it is
+   missing, invalid or stale, so slides added to or deleted from the card
+   are picked up at the next start. SLIDELIST_next() then finds the next
+   slide by a single seek. Only the index file is kept open.
+*/
+
+FRESULT SLIDELIST_signature(uint32_t *signature, uint32_t *files);
+FRESULT SLIDELIST_build(void);
+FRESULT SLIDELIST_open(void);
+FRESULT SLIDELIST_next(char *fileName);
+uint32_t SLIDELIST_count(void);
+void SLIDELIST_close(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,211 @@
+/**************************************************************************//**
+ * @file
+ * @brief Streaming QOI image decoder for slideshow
+ * @author Energy Micro AS
+ * @version 3.20.0
+ ******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 Energy Micro AS, http://www.energymicro.com</b>
+ *******************************************************************************
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ * 4. The source and compiled code may only be used on Energy Micro "EFM32"
+ *    microcontrollers and "EFR4" radios.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: Energy Micro AS has no
+ * obligation to support this Software. Energy Micro AS is providing the
+ * Software "AS IS", with no express or implied warranties of any kind,
+ * including, but not limited to, any implied warranties of merchantability
+ * or fitness for any particular purpose or warranties against infringement
+ * of any proprietary rights of a third party.
+ *
+ * Energy Micro AS will not be liable for any consequential, incidental, or
+ * special damages, or any other relief, or for any claim by any third party,
+ * arising from your use of this Software.
+ *
+ *****************************************************************************/
+#include <string.h>
+#include "slideqoi.h"
+
+/* QOI chunk tags */
+#define QOI_OP_INDEX  0x00
+#define QOI_OP_DIFF   0x40
+#define QOI_OP_LUMA   0x80
+#define QOI_OP_RUN    0xc0
+#define QOI_OP_RGB    0xfe
+#define QOI_OP_RGBA   0xff
+#define QOI_MASK_2    0xc0
+
+/** Position of pixel in color index */
+#define QOI_HASH(p)   (((p)[0] * 3 + (p)[1] * 5 + (p)[2] * 7 + (p)[3] * 11) & 63)
+
+/***************************************************************************//**
+ * @brief
+ *   Get next byte of encoded data, refilling input buffer when empty.
+ *   Returns 0 when input is exhausted, which decodes as QOI_OP_INDEX 0.
+ ******************************************************************************/
+static uint8_t SLIDEQOI_getByte(SLIDEQOI_Decoder_TypeDef *dec)
+{
+  if (dec->inPos >= dec->inLen)
+  {
+    dec->inLen = dec->read(dec->inBuf, SLIDEQOI_INPUT_SIZE);
+    dec->inPos = 0;
+    if (dec->inLen == 0)
+    {
+      return 0;
+    }
+  }
+  return dec->inBuf[dec->inPos++];
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Initialize decoder from QOI file header.
+ *
+ * @param[out] dec
+ *   Decoder state to initialize.
+ *
+ * @param[in] read
+ *   Function used for reading encoded data following the header.
+ *
+ * @param[in] header
+ *   First SLIDEQOI_HEADER_SIZE bytes of file.
+ *
+ * @return
+ *   true if header is a valid QOI header, false otherwise.
+ ******************************************************************************/
+bool SLIDEQOI_init(SLIDEQOI_Decoder_TypeDef *dec,
+                   SLIDEQOI_Read_TypeDef read,
+                   const uint8_t *header)
+{
+  uint32_t magic;
+
+  magic = ((uint32_t)header[0] << 24) | ((uint32_t)header[1] << 16) |
+          ((uint32_t)header[2] << 8) | header[3];
+  if (magic != SLIDEQOI_MAGIC)
+  {
+    return false;
+  }
+
+  memset(dec, 0, sizeof(SLIDEQOI_Decoder_TypeDef));
+  dec->width = ((uint32_t)header[4] << 24) | ((uint32_t)header[5] << 16) |
+               ((uint32_t)header[6] << 8) | header[7];
+  dec->height = ((uint32_t)header[8] << 24) | ((uint32_t)header[9] << 16) |
+                ((uint32_t)header[10] << 8) | header[11];
+  dec->pixelsLeft = dec->width * dec->height;
+  dec->px[3]      = 255;
+  dec->read       = read;
+
+  /* Channels must be 3 or 4 */
+  return (header[12] == 3) || (header[12] == 4);
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Decode next pixels of image.
+ *
+ * @param[in,out] dec
+ *   Decoder state.
+ *
+ * @param[out] buffer
+ *   Buffer receiving RGB565 pixels.
+ *
+ * @param[in] pixels
+ *   Max number of pixels to decode.
+ *
+ * @return
+ *   Number of pixels decoded, 0 when image is complete.
+ ******************************************************************************/
+uint32_t SLIDEQOI_decode(SLIDEQOI_Decoder_TypeDef *dec,
+                         uint16_t *buffer,
+                         uint32_t pixels)
+{
+  uint8_t  *px = dec->px;
+  uint8_t  b1;
+  uint8_t  b2;
+  uint8_t  vg;
+  uint16_t color;
+  uint32_t count;
+  uint32_t n;
+
+  if (pixels > dec->pixelsLeft)
+  {
+    pixels = dec->pixelsLeft;
+  }
+
+  n = 0;
+  while (n < pixels)
+  {
+    if (dec->run == 0)
+    {
+      b1 = SLIDEQOI_getByte(dec);
+
+      if (b1 == QOI_OP_RGB)
+      {
+        px[0] = SLIDEQOI_getByte(dec);
+        px[1] = SLIDEQOI_getByte(dec);
+        px[2] = SLIDEQOI_getByte(dec);
+      }
+      else if (b1 == QOI_OP_RGBA)
+      {
+        px[0] = SLIDEQOI_getByte(dec);
+        px[1] = SLIDEQOI_getByte(dec);
+        px[2] = SLIDEQOI_getByte(dec);
+        px[3] = SLIDEQOI_getByte(dec);
+      }
+      else if ((b1 & QOI_MASK_2) == QOI_OP_INDEX)
+      {
+        memcpy(px, dec->index[b1], 4);
+      }
+      else if ((b1 & QOI_MASK_2) == QOI_OP_DIFF)
+      {
+        px[0] += ((b1 >> 4) & 0x03) - 2;
+        px[1] += ((b1 >> 2) & 0x03) - 2;
+        px[2] += (b1 & 0x03) - 2;
+      }
+      else if ((b1 & QOI_MASK_2) == QOI_OP_LUMA)
+      {
+        b2 = SLIDEQOI_getByte(dec);
+        vg = (b1 & 0x3f) - 32;
+        px[0] += vg - 8 + ((b2 >> 4) & 0x0f);
+        px[1] += vg;
+        px[2] += vg - 8 + (b2 & 0x0f);
+      }
+      else
+      {
+        /* QOI_OP_RUN, repeat previous pixel */
+        dec->run = b1 & 0x3f;
+      }
+
+      memcpy(dec->index[QOI_HASH(px)], px, 4);
+      dec->run++;
+    }
+
+    /* Emit current pixel as many times as run allows */
+    color = (uint16_t)(((uint16_t)(px[0] & 0xf8) << 8) |
+                       ((uint16_t)(px[1] & 0xfc) << 3) |
+                       (px[2] >> 3));
+    count = dec->run;
+    if (count > (pixels - n))
+    {
+      count = pixels - n;
+    }
+    dec->run -= count;
+    n        += count;
+    while (count--)
+    {
+      *buffer++ = color;
+    }
+  }
+
+  dec->pixelsLeft -= n;
+  return n;
+}
@@ -0,0 +1,94 @@
+/**************************************************************************//**
+ * @file
+ * @brief Streaming QOI image decoder for slideshow
+ * @author Energy Micro AS
+ * @version 3.20.0
+ ******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 Energy Micro AS, http://www.energymicro.com</b>
+ *******************************************************************************
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ * 4. The source and compiled code may only be used on Energy Micro "EFM32"
+ *    microcontrollers and "EFR4" radios.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: Energy Micro AS has no
+ * obligation to support this Software. Energy Micro AS is providing the
+ * Software "AS IS", with no express or implied warranties of any kind,
+ * including, but not limited to, any implied warranties of merchantability
+ * or fitness for any particular purpose or warranties against infringement
+ * of any proprietary rights of a third party.
+ *
+ * Energy Micro AS will not be liable for any consequential, incidental, or
+ * special damages, or any other relief, or for any claim by any third party,
+ * arising from your use of this Software.
+ *
+ *****************************************************************************/
+#ifndef __SLIDEQOI_H
+#define __SLIDEQOI_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+   Streaming decoder for the lossless "Quite OK Image" (QOI) format.
+
+   Decoding only needs the 64 entry color index, the previous pixel and a
+   small input buffer. Pixels are delivered top-down as RGB565, ready to be
+   written to the display. The alpha channel is decoded, but ignored.
+*/
+
+/** "qoif" read as a big endian 32 bit word */
+#define SLIDEQOI_MAGIC        0x716f6966UL
+
+/** Size of QOI file header */
+#define SLIDEQOI_HEADER_SIZE  14
+
+/** Size of input buffer, one SD card sector */
+#define SLIDEQOI_INPUT_SIZE   512
+
+/**
+ * Function used by decoder for reading more encoded data. Returns number of
+ * bytes read, 0 on end of file or error.
+ */
+typedef uint32_t (*SLIDEQOI_Read_TypeDef)(uint8_t *buffer, uint32_t length);
+
+/** QOI decoder state */
+typedef struct
+{
+  uint32_t width;                      /**< Image width in pixels */
+  uint32_t height;                     /**< Image height in pixels */
+  uint32_t pixelsLeft;                 /**< Pixels not yet decoded */
+  uint32_t run;                        /**< Remaining repeats of px */
+  uint8_t  px[4];                      /**< Previous pixel, RGBA */
+  uint8_t  index[64][4];               /**< Previously seen pixels, RGBA */
+  SLIDEQOI_Read_TypeDef read;          /**< Input function */
+  uint32_t inPos;                      /**< Read position in inBuf */
+  uint32_t inLen;                      /**< Valid bytes in inBuf */
+  uint8_t  inBuf[SLIDEQOI_INPUT_SIZE]; /**< Encoded input data */
+} SLIDEQOI_Decoder_TypeDef;
+
+bool SLIDEQOI_init(SLIDEQOI_Decoder_TypeDef *dec,
+                   SLIDEQOI_Read_TypeDef read,
+                   const uint8_t *header);
+uint32_t SLIDEQOI_decode(SLIDEQOI_Decoder_TypeDef *dec,
+                         uint16_t *buffer,
+                         uint32_t pixels);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,82 @@
+/**************************************************************************//**
+ * @file
+ * @brief Raw RGB565 slide file format
+ * @author Energy Micro AS
+ * @version 3.20.0
+ ******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 Energy Micro AS, http://www.energymicro.com</b>
+ *******************************************************************************
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ * 4. The source and compiled code may only be used on Energy Micro "EFM32"
+ *    microcontrollers and "EFR4" radios.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: Energy Micro AS has no
+ * obligation to support this Software. Energy Micro AS is providing the
+ * Software "AS IS", with no express or implied warranties of any kind,
+ * including, but not limited to, any implied warranties of merchantability
+ * or fitness for any particular purpose or warranties against infringement
+ * of any proprietary rights of a third party.
+ *
+ * Energy Micro AS will not be liable for any consequential, incidental, or
+ * special damages, or any other relief, or for any claim by any third party,
+ * arising from your use of this Software.
+ *
+ *****************************************************************************/
+#ifndef __SLIDERAW_H
+#define __SLIDERAW_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+   Raw RGB565 slide format:
+
+   Offset  Size  Content
+   0       4     Magic "R565"
+   4       2     Width in pixels (little endian)
+   6       2     Height in pixels (little endian)
+   8       4     Offset of pixel data from start of file (little endian)
+   12      4     Reserved, 0
+
+   Pixel data is stored top-down, row by row, each pixel as a little endian
+   RGB565 word, exactly as written to the SSD2119 GRAM. The converter pads the
+   header to SLIDERAW_DATA_OFFSET, placing pixel data on a sector boundary.
+*/
+
+/** "R565" read as a little endian 32 bit word */
+#define SLIDERAW_MAGIC         0x35363552UL
+
+/** Size of header fields */
+#define SLIDERAW_HEADER_SIZE   16
+
+/** Default offset of pixel data, one SD card sector */
+#define SLIDERAW_DATA_OFFSET   512
+
+/** Header of raw RGB565 slide file */
+typedef struct
+{
+  uint32_t magic;       /**< SLIDERAW_MAGIC */
+  uint16_t width;       /**< Width in pixels */
+  uint16_t height;      /**< Height in pixels */
+  uint32_t dataOffset;  /**< Offset of pixel data in file */
+  uint32_t reserved;    /**< Reserved, 0 */
+} SLIDERAW_Header_TypeDef;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -45,6 +45,10 @@
 #include "dmd/ssd2119/dmd_ssd2119.h"
 
 #include "slides.h"
+#include "slideraw.h"
+#include "slideqoi.h"
+#include "slidescale.h"
+#include "tftdma.h"
 
 #include "diskio.h"
 #include "ff.h"
@@ -60,8 +64,56 @@ uint8_t rgbBuffer[RGB_BUFFER_SIZE];
 /* File to read bmp data from */
 FIL BMPfile;
 
-/* Local prototypes */
-EMSTATUS SLIDES_readData(uint8_t buffer[], uint32_t bufLength, uint32_t bytesToRead);
+/* Format of slide decoded ahead of time (while previous slide is shown) */
+typedef enum
+{
+  prefetchNone,        /* Nothing prefetched */
+  prefetchBmp,         /* BMP headers read, first pixels staged */
+  prefetchRaw,         /* Raw RGB565 header read, first pixels staged */
+  prefetchQoi,         /* QOI header read, first pixels decoded */
+  prefetchOpenFailed,  /* File could not be opened */
+  prefetchInitFailed,  /* BMP library could not be initialized */
+  prefetchNotBmp,      /* File is not a supported BMP file */
+  prefetchTooLarge     /* Raw RGB565 or QOI file larger than display */
+} SLIDES_Prefetch_TypeDef;
+
+static SLIDES_Prefetch_TypeDef prefetchState = prefetchNone;
+static char     prefetchName[SLIDES_NAME_SIZE];
+/* Prefetch buffer, also used as ping-pong buffer when streaming raw */
+/* RGB565 and QOI slides. Declared 16 bit for DMA alignment. */
+static uint16_t prefetchBuffer[PREFETCH_BUFFER_SIZE / 2];
+static uint32_t prefetchPixels;
+static bool     prefetchDone;
+
+/* Header of raw RGB565 or QOI slide */
+static union
+{
+  SLIDERAW_Header_TypeDef raw;
+  uint8_t                 bytes[SLIDERAW_HEADER_SIZE];
+} header;
+
+/* Format of RGB565 slide being fetched, prefetchRaw or prefetchQoi */
+static SLIDES_Prefetch_TypeDef rgb565Format;
+/* Size of RGB565 slide being fetched */
+static uint32_t rgb565Width;
+static uint32_t rgb565Height;
+/* Raw RGB565 pixels not yet read from file */
+static uint32_t rawRemaining;
+
+/* QOI decoder state */
+static SLIDEQOI_Decoder_TypeDef qoiDecoder;
+
+/* Downscaler state, for BMP slides larger than display */
+static SLIDESCALE_TypeDef scaler;
+
+/* Image geometry and draw position of slide being shown */
+static uint32_t nPixelsPerRow;
+static uint32_t nRows;
+static int32_t  xCursor;
+static int32_t  yCursor;
+/* Row increment, -1 for bottom-up BMP, 1 for top-down raw and QOI */
+static int32_t  yStep;
+
 
 /***************************************************************************//**
  * @brief
@@ -116,83 +168,511 @@ EMSTATUS SLIDES_readData(uint8_t buffer[], uint32_t bufLength, uint32_t bytesToR
 }
 
 /**************************************************************************//**
- * @brief Clears/updates entire background ready to be drawn
+ * @brief
+ *   Draw decoded pixels at current cursor position, and advance cursor.
+ * @param data
+ *   Decoded 24 bit RGB pixels.
+ * @param pixels
+ *   Number of pixels in data.
+ * @return
+ *   false if image is complete or display write failed, true otherwise.
  *****************************************************************************/
-void SLIDES_showBMP(char *fileName)
+static bool SLIDES_drawPixels(uint8_t *data, uint32_t pixels)
+{
+  uint32_t count;
+
+  while (pixels && nPixelsPerRow && (yCursor >= 0) && (yCursor < (int)nRows))
+  {
+    /* Do not write past end of row, DMD will not move upwards for us */
+    count = nPixelsPerRow - xCursor;
+    if (count > pixels)
+      count = pixels;
+
+    if (DMD_writeData(xCursor, yCursor, data, count) != DMD_OK)
+      return false;
+
+    data    += count * 3;
+    pixels  -= count;
+    xCursor += count;
+    if (xCursor >= (int)nPixelsPerRow)
+    {
+      yCursor += yStep;
+      xCursor  = 0;
+    }
+  }
+  return (yCursor >= 0) && (yCursor < (int)nRows);
+}
+
+/**************************************************************************//**
+ * @brief
+ *   Expand RGB565 pixels to 24 bit RGB and draw them through DMD.
+ * @param data
+ *   RGB565 pixels.
+ * @param pixels
+ *   Number of pixels in data.
+ * @return
+ *   false if image is complete or display write failed, true otherwise.
+ *****************************************************************************/
+static bool SLIDES_drawRgb565(const uint16_t *data, uint32_t pixels)
+{
+  uint32_t count;
+  uint32_t i;
+  uint16_t c;
+
+  while (pixels)
+  {
+    count = pixels;
+    if (count > (RGB_BUFFER_SIZE / 3))
+      count = RGB_BUFFER_SIZE / 3;
+
+    for (i = 0; i < count; i++)
+    {
+      c = *data++;
+      rgbBuffer[(i * 3)]     = (uint8_t)((c >> 8) & 0xf8);
+      rgbBuffer[(i * 3) + 1] = (uint8_t)((c >> 3) & 0xfc);
+      rgbBuffer[(i * 3) + 2] = (uint8_t)(c << 3);
+    }
+    if (!SLIDES_drawPixels(rgbBuffer, count))
+      return false;
+    pixels -= count;
+  }
+  return true;
+}
+
+/**************************************************************************//**
+ * @brief
+ *   Start writing RGB565 pixels to display. The display write pointer must
+ *   already be positioned and data access prepared. Uses DMA when the
+ *   display is accessed through EBI, returning before transfer is done.
+ * @param data
+ *   RGB565 pixels, must remain untouched until SLIDES_streamWait() returns.
+ * @param pixels
+ *   Number of pixels in data.
+ *****************************************************************************/
+static void SLIDES_streamStart(uint16_t *data, uint32_t pixels)
+{
+#if defined(BSP_BC_CTRL_EBI)
+  /* Waits for any previous transfer to complete before starting */
+  TFTDMA_blit(data, pixels);
+#else
+  /* Display accessed through board controller SPI, no DMA to display */
+  SLIDES_drawRgb565(data, pixels);
+#endif
+}
+
+/**************************************************************************//**
+ * @brief
+ *   Wait for transfer started by SLIDES_streamStart() to complete.
+ *****************************************************************************/
+static void SLIDES_streamWait(void)
+{
+#if defined(BSP_BC_CTRL_EBI)
+  TFTDMA_wait();
+#endif
+}
+
+/**************************************************************************//**
+ * @brief
+ *   Read encoded QOI data from slide file, used by QOI decoder.
+ *****************************************************************************/
+static uint32_t SLIDES_readQoi(uint8_t *buffer, uint32_t length)
+{
+  UINT bytesRead;
+
+  if (f_read(&BMPfile, buffer, length, &bytesRead) != FR_OK)
+    return 0;
+  return bytesRead;
+}
+
+/**************************************************************************//**
+ * @brief
+ *   Fetch next RGB565 pixels of raw RGB565 or QOI slide.
+ * @param buffer
+ *   Buffer receiving pixels.
+ * @param pixels
+ *   Max number of pixels to fetch.
+ * @return
+ *   Number of pixels fetched, 0 when slide is complete or on error.
+ *****************************************************************************/
+static uint32_t SLIDES_fetch565(uint16_t *buffer, uint32_t pixels)
+{
+  UINT bytesRead;
+
+  if (rgb565Format == prefetchQoi)
+  {
+    /* Decode straight into buffer, no full sector needed */
+    return SLIDEQOI_decode(&qoiDecoder, buffer, pixels);
+  }
+
+  if (pixels > rawRemaining)
+    pixels = rawRemaining;
+
+  /* Raw pixel data needs no decoding */
+  if (f_read(&BMPfile, buffer, pixels * 2, &bytesRead) != FR_OK)
+    bytesRead = 0;
+  rawRemaining -= bytesRead / 2;
+  return bytesRead / 2;
+}
+
+/**************************************************************************//**
+ * @brief
+ *   Read headers and first pixels of a raw RGB565 or QOI slide.
+ * @return
+ *   true if file is a raw RGB565 or QOI slide, false otherwise. File position
+ *   is restored to start of file if false.
+ *****************************************************************************/
+static bool SLIDES_prefetch565(void)
 {
-  int32_t  xCursor;
-  int32_t  yCursor;
+  UINT bytesRead;
+
+  if ((f_read(&BMPfile, header.bytes, SLIDERAW_HEADER_SIZE, &bytesRead) != FR_OK) ||
+      (bytesRead != SLIDERAW_HEADER_SIZE))
+  {
+    f_lseek(&BMPfile, 0);
+    return false;
+  }
+
+  if (header.raw.magic == SLIDERAW_MAGIC)
+  {
+    rgb565Format = prefetchRaw;
+    rgb565Width  = header.raw.width;
+    rgb565Height = header.raw.height;
+    rawRemaining = rgb565Width * rgb565Height;
+
+    /* Pixel data starts on a sector boundary, making these full sector reads */
+    f_lseek(&BMPfile, header.raw.dataOffset);
+  }
+  else if (SLIDEQOI_init(&qoiDecoder, SLIDES_readQoi, header.bytes))
+  {
+    rgb565Format = prefetchQoi;
+    rgb565Width  = qoiDecoder.width;
+    rgb565Height = qoiDecoder.height;
+
+    /* Encoded data follows immediately after the shorter QOI header */
+    f_lseek(&BMPfile, SLIDEQOI_HEADER_SIZE);
+  }
+  else
+  {
+    f_lseek(&BMPfile, 0);
+    return false;
+  }
+
+  if ((rgb565Width > 320) || (rgb565Height > 240))
+  {
+    prefetchState = prefetchTooLarge;
+    f_close(&BMPfile);
+    return true;
+  }
+  prefetchState = rgb565Format;
+
+  /* Fetch as many pixels as fits into prefetch buffer */
+  prefetchPixels = SLIDES_fetch565(prefetchBuffer, PREFETCH_BUFFER_SIZE / 2);
+  prefetchDone   = (prefetchPixels < (PREFETCH_BUFFER_SIZE / 2));
+  return true;
+}
+
+/**************************************************************************//**
+ * @brief
+ *   Open a slide file, read its headers and fetch the first pixels into
+ *   the prefetch buffer. Does not access the display, and may thus be used
+ *   while the previous slide is still being shown. Errors are reported
+ *   when the slide is shown by SLIDES_showPrefetched().
+ * @param fileName
+ *   Name of BMP, raw RGB565 or QOI file to prefetch.
+ *****************************************************************************/
+void SLIDES_prefetchBMP(char *fileName)
+{
+  uint8_t  *buffer = (uint8_t *)prefetchBuffer;
   uint32_t pixelsRead;
-  uint32_t nPixelsPerRow;
-  uint32_t nRows;
+  uint32_t length;
+  uint32_t used;
 
-  EMSTATUS status;
+  /* Close any slide prefetched, but never shown */
+  if ((prefetchState == prefetchBmp) ||
+      (prefetchState == prefetchRaw) ||
+      (prefetchState == prefetchQoi))
+  {
+    f_close(&BMPfile);
+  }
+
+  strncpy(prefetchName, fileName, SLIDES_NAME_SIZE - 1);
+  prefetchName[SLIDES_NAME_SIZE - 1] = '\0';
+  prefetchPixels = 0;
+  prefetchDone   = false;
 
   /* Open file */
   if (f_open(&BMPfile, fileName, FA_READ) != FR_OK)
   {
-    SLIDES_showError(true, "Fatal:\n  Failed to open file:\n  %s", fileName);
+    prefetchState = prefetchOpenFailed;
+    return;
+  }
+
+  /* Pre-converted raw RGB565 or QOI slide? */
+  if (SLIDES_prefetch565())
+  {
+    return;
   }
 
   /* Initialize BMP decoder */
   if (BMP_init(palette, 1024, &SLIDES_readData) != BMP_OK)
   {
-    SLIDES_showError(true, "Fatal:\n  Failed to init BMP library.");
+    prefetchState = prefetchInitFailed;
+    f_close(&BMPfile);
+    return;
   }
 
   /* Read headers */
-  if ((status = BMP_reset()) != BMP_OK)
+  if (BMP_reset() != BMP_OK)
+  {
+    prefetchState = prefetchNotBmp;
+    f_close(&BMPfile);
+    return;
+  }
+  prefetchState = prefetchBmp;
+
+  /* Decode as many pixels as fit into prefetch buffer */
+  used = 0;
+  while ((PREFETCH_BUFFER_SIZE - used) >= 3)
+  {
+    length = PREFETCH_BUFFER_SIZE - used;
+    if (length > RGB_BUFFER_SIZE)
+      length = RGB_BUFFER_SIZE;
+
+    if ((BMP_readRgbData(buffer + used, length, &pixelsRead) != BMP_OK) ||
+        (pixelsRead == 0))
+    {
+      /* Entire image (or all we will get from it) is prefetched */
+      prefetchDone = true;
+      break;
+    }
+    prefetchPixels += pixelsRead;
+    used           += pixelsRead * 3;
+  }
+}
+
+/**************************************************************************//**
+ * @brief
+ *   Check if a slide has been prefetched and is ready to be shown.
+ *****************************************************************************/
+bool SLIDES_prefetchPending(void)
+{
+  return prefetchState != prefetchNone;
+}
+
+/**************************************************************************//**
+ * @brief
+ *   Draw row completed by downscaler.
+ *****************************************************************************/
+static void SLIDES_drawScaledRow(uint8_t *rgb, uint32_t pixels)
+{
+  SLIDES_drawPixels(rgb, pixels);
+}
+
+/**************************************************************************//**
+ * @brief
+ *   Show prefetched BMP slide larger than display. Source rows are decoded
+ *   and passed through the downscaler, which draws each destination row as
+ *   soon as it is complete.
+ *****************************************************************************/
+static void SLIDES_showScaledBmp(void)
+{
+  uint32_t srcWidth  = BMP_getWidth();
+  uint32_t srcHeight = BMP_getHeight();
+  uint32_t pixelsRead;
+  EMSTATUS status;
+
+  SLIDESCALE_fit(srcWidth, srcHeight, 320, 240, &nPixelsPerRow, &nRows);
+  if (!SLIDESCALE_init(&scaler, srcWidth, srcHeight, nPixelsPerRow, nRows,
+                       SLIDES_drawScaledRow))
   {
-    SLIDES_showError(false, "Info:\n  %s is not a BMP file", fileName);
-    goto cleanup;
+    SLIDES_showError(false, "Info:\n  %s is too large.", prefetchName);
+    return;
   }
 
-  /* Get important BMP data */
+  /* BMP is stored bottom-up, and so are the scaled rows */
+  yCursor = nRows - 1;
+  xCursor = 0;
+  yStep   = -1;
+
+  DMD_setClippingArea(0, 0, nPixelsPerRow, nRows);
+
+  SLIDESCALE_push(&scaler, (uint8_t *)prefetchBuffer, prefetchPixels);
+  if (prefetchDone)
+    return;
+
+  while (1)
+  {
+    status = BMP_readRgbData(rgbBuffer, RGB_BUFFER_SIZE, &pixelsRead);
+    if (status != BMP_OK || pixelsRead == 0)
+      break;
+
+    SLIDESCALE_push(&scaler, rgbBuffer, pixelsRead);
+  }
+}
+
+/**************************************************************************//**
+ * @brief
+ *   Show prefetched BMP slide, prefetched pixels are drawn immediately,
+ *   remaining rows are decoded from file.
+ *****************************************************************************/
+static void SLIDES_showPrefetchedBmp(void)
+{
+  uint32_t pixelsRead;
+  EMSTATUS status;
+
+  /* Get important BMP data. Remember, BMP is stored bottom-up */
   nPixelsPerRow = BMP_getWidth();
   nRows         = BMP_getHeight();
   yCursor       = nRows - 1;
   xCursor       = 0;
+  yStep         = -1;
 
-  /* Check size of BMP */
+  /* Scale down BMP larger than display */
   if ((nPixelsPerRow > 320) || (nRows > 240))
   {
-    SLIDES_showError(false, "Info:\n  %s is larger than 320x240.", fileName);
+    SLIDES_showScaledBmp();
+    return;
   }
 
    /* Set clipping region */
   DMD_setClippingArea(0, 0, nPixelsPerRow, nRows);
 
-  /* Read in and draw row for row */
-  while (yCursor >= 0)
+  /* Draw prefetched rows first, then read in and draw rest row for row */
+  if (SLIDES_drawPixels((uint8_t *)prefetchBuffer, prefetchPixels) && !prefetchDone)
   {
-    /* Read in row buffer */
-    status = BMP_readRgbData(rgbBuffer, RGB_BUFFER_SIZE, &pixelsRead);
-    if (status != BMP_OK || pixelsRead == 0)
-      break;
+    while (1)
+    {
+      /* Read in row buffer */
+      status = BMP_readRgbData(rgbBuffer, RGB_BUFFER_SIZE, &pixelsRead);
+      if (status != BMP_OK || pixelsRead == 0)
+        break;
 
-    /* Draw row buffer. Remember, BMP is stored bottom-up */
-    status = DMD_writeData(xCursor, yCursor, rgbBuffer, pixelsRead);
-    if (status != DMD_OK)
-      break;
+      /* Draw row buffer */
+      if (!SLIDES_drawPixels(rgbBuffer, pixelsRead))
+        break;
+    }
+  }
+}
 
-    /* Update cursor */
-    xCursor += pixelsRead;
-    if (xCursor >= (int)nPixelsPerRow)
+/**************************************************************************//**
+ * @brief
+ *   Show prefetched raw RGB565 or QOI slide. Pixels are streamed to display
+ *   from one half of the prefetch buffer while the other half is read from
+ *   file (raw) or decoded (QOI).
+ *****************************************************************************/
+static void SLIDES_showPrefetched565(void)
+{
+  uint16_t *half[2];
+  uint32_t pixels[2];
+  int      cur;
+  int      other;
+
+  half[0] = prefetchBuffer;
+  half[1] = prefetchBuffer + (PREFETCH_BUFFER_SIZE / 4);
+
+  nPixelsPerRow = rgb565Width;
+  nRows         = rgb565Height;
+  yCursor       = 0;
+  xCursor       = 0;
+  yStep         = 1;
+
+  if (prefetchPixels == 0)
+    return;
+
+  pixels[0] = prefetchPixels;
+  if (pixels[0] > (PREFETCH_BUFFER_SIZE / 4))
+    pixels[0] = PREFETCH_BUFFER_SIZE / 4;
+  pixels[1] = prefetchPixels - pixels[0];
+
+  /* Display window wraps to next row, so the whole slide is one stream */
+  DMD_setClippingArea(0, 0, nPixelsPerRow, nRows);
+
+  /* Position display write pointer by drawing first pixel through DMD */
+  if (!SLIDES_drawRgb565(half[0], 1))
+    return;
+
+  SLIDES_streamStart(half[0] + 1, pixels[0] - 1);
+  cur = 0;
+  while (1)
+  {
+    other = cur ^ 1;
+
+    /* Refill other half while current half is sent to display */
+    if ((pixels[other] == 0) && !prefetchDone)
     {
-      yCursor -= xCursor / nPixelsPerRow;
-      xCursor  = xCursor % nPixelsPerRow;
+      pixels[other] = SLIDES_fetch565(half[other], PREFETCH_BUFFER_SIZE / 4);
+      if (pixels[other] == 0)
+        prefetchDone = true;
     }
+
+    SLIDES_streamWait();
+    pixels[cur] = 0;
+
+    if (pixels[other] == 0)
+      break;
+
+    SLIDES_streamStart(half[other], pixels[other]);
+    cur = other;
   }
-  /* Reset clipping area in DMD driver */
-  status = GLIB_resetDisplayClippingArea(&gc);
-  if (status != 0)
+}
+
+/**************************************************************************//**
+ * @brief
+ *   Show slide prepared by SLIDES_prefetchBMP().
+ *****************************************************************************/
+void SLIDES_showPrefetched(void)
+{
+  SLIDES_Prefetch_TypeDef state = prefetchState;
+
+  prefetchState = prefetchNone;
+
+  switch (state)
+  {
+  case prefetchNone:
+    return;
+
+  case prefetchOpenFailed:
+    SLIDES_showError(true, "Fatal:\n  Failed to open file:\n  %s", prefetchName);
+    return;
+
+  case prefetchInitFailed:
+    SLIDES_showError(true, "Fatal:\n  Failed to init BMP library.");
+    return;
+
+  case prefetchNotBmp:
+    SLIDES_showError(false, "Info:\n  %s is not a BMP file", prefetchName);
+    return;
+
+  case prefetchTooLarge:
+    SLIDES_showError(false, "Info:\n  %s is larger than 320x240.", prefetchName);
     return;
 
-cleanup:
+  case prefetchRaw:
+  case prefetchQoi:
+    SLIDES_showPrefetched565();
+    break;
+
+  default:
+    SLIDES_showPrefetchedBmp();
+    break;
+  }
+
+  /* Reset clipping area in DMD driver */
+  GLIB_resetDisplayClippingArea(&gc);
+
   /* Close the file */
   f_close(&BMPfile);
 }
 
+/**************************************************************************//**
+ * @brief Clears/updates entire background ready to be drawn
+ *****************************************************************************/
+void SLIDES_showBMP(char *fileName)
+{
+  SLIDES_prefetchBMP(fileName);
+  SLIDES_showPrefetched();
+}
+
 /**************************************************************************//**
  * @brief Initialize viewer
  *****************************************************************************/
@@ -212,6 +692,11 @@ void SLIDES_init(void)
   /* Make sure display is configured with correct rotation */
   if ((status == DMD_OK)) DMD_flipDisplay(1,1);
 
+#if defined(BSP_BC_CTRL_EBI)
+  /* Display data register is EBI mapped, DMA may write to it directly */
+  TFTDMA_init((volatile uint16_t *)(BC_SSD2119_BASE + 2));
+#endif
+
   /* Init graphics context - abort on failure */
   status = GLIB_contextInit(&gc);
   if (status != GLIB_OK) while (1) ;
@@ -39,8 +39,18 @@ extern "C" {
 #define RGB_BUFFER_SIZE 512
 #define PALETTE_SIZE 1024
 
+/* Size of buffer holding the first decoded pixels of the next slide. */
+/* 3840 bytes equals 4 full rows of 320 pixels, 24 bit. */
+#define PREFETCH_BUFFER_SIZE 3840
+
+/* Max length of slide file name, including terminating zero */
+#define SLIDES_NAME_SIZE 20
+
 void SLIDES_showError(bool fatal, const char* fmt, ...);
 void SLIDES_showBMP(char *fileName);
+void SLIDES_prefetchBMP(char *fileName);
+bool SLIDES_prefetchPending(void);
+void SLIDES_showPrefetched(void);
 void SLIDES_init(void);
 
 #ifdef __cplusplus
@@ -0,0 +1,275 @@
+/**************************************************************************//**
+ * @file
+ * @brief Streaming area-average image downscaler for slideshow
+ * @author Energy Micro AS
+ * @version 3.20.0
+ ******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 Energy Micro AS, http://www.energymicro.com</b>
+ *******************************************************************************
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ * 4. The source and compiled code may only be used on Energy Micro "EFM32"
+ *    microcontrollers and "EFR4" radios.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: Energy Micro AS has no
+ * obligation to support this Software. Energy Micro AS is providing the
+ * Software "AS IS", with no express or implied warranties of any kind,
+ * including, but not limited to, any implied warranties of merchantability
+ * or fitness for any particular purpose or warranties against infringement
+ * of any proprietary rights of a third party.
+ *
+ * Energy Micro AS will not be liable for any consequential, incidental, or
+ * special damages, or any other relief, or for any claim by any third party,
+ * arising from your use of this Software.
+ *
+ *****************************************************************************/
+#include <string.h>
+#include "slidescale.h"
+
+/*
+   Coordinates are kept in units where a source pixel is dstWidth long and
+   a destination pixel is srcWidth long (likewise for rows), making both
+   pixel grids integer. When downscaling, a source pixel thus overlaps at
+   most two destination pixels.
+*/
+
+/***************************************************************************//**
+ * @brief
+ *   Compute largest destination size fitting within given bounds, keeping
+ *   aspect ratio. Images already fitting are left at their original size.
+ *
+ * @param[in] srcWidth
+ *   Source image width.
+ *
+ * @param[in] srcHeight
+ *   Source image height.
+ *
+ * @param[in] maxWidth
+ *   Max destination width.
+ *
+ * @param[in] maxHeight
+ *   Max destination height.
+ *
+ * @param[out] dstWidth
+ *   Destination width.
+ *
+ * @param[out] dstHeight
+ *   Destination height.
+ ******************************************************************************/
+void SLIDESCALE_fit(uint32_t srcWidth, uint32_t srcHeight,
+                    uint32_t maxWidth, uint32_t maxHeight,
+                    uint32_t *dstWidth, uint32_t *dstHeight)
+{
+  *dstWidth  = srcWidth;
+  *dstHeight = srcHeight;
+
+  if (*dstWidth > maxWidth)
+  {
+    *dstWidth  = maxWidth;
+    *dstHeight = (srcHeight * maxWidth + (srcWidth / 2)) / srcWidth;
+  }
+  if (*dstHeight > maxHeight)
+  {
+    *dstHeight = maxHeight;
+    *dstWidth  = (srcWidth * maxHeight + (srcHeight / 2)) / srcHeight;
+  }
+  if (*dstWidth == 0)
+  {
+    *dstWidth = 1;
+  }
+  if (*dstHeight == 0)
+  {
+    *dstHeight = 1;
+  }
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Initialize downscaler.
+ *
+ * @param[out] scale
+ *   Downscaler state to initialize.
+ *
+ * @param[in] srcWidth
+ *   Source image width, max 65535.
+ *
+ * @param[in] srcHeight
+ *   Source image height, max 65535.
+ *
+ * @param[in] dstWidth
+ *   Destination image width, max SLIDESCALE_MAX_WIDTH and srcWidth.
+ *
+ * @param[in] dstHeight
+ *   Destination image height, max srcHeight.
+ *
+ * @param[in] row
+ *   Function receiving destination rows.
+ *
+ * @return
+ *   true if sizes are supported, false otherwise.
+ ******************************************************************************/
+bool SLIDESCALE_init(SLIDESCALE_TypeDef *scale,
+                     uint32_t srcWidth, uint32_t srcHeight,
+                     uint32_t dstWidth, uint32_t dstHeight,
+                     SLIDESCALE_Row_TypeDef row)
+{
+  if ((dstWidth == 0) || (dstHeight == 0) ||
+      (dstWidth > SLIDESCALE_MAX_WIDTH) ||
+      (dstWidth > srcWidth) || (dstHeight > srcHeight) ||
+      (srcWidth > 0xffff) || (srcHeight > 0xffff))
+  {
+    return false;
+  }
+
+  scale->srcWidth  = srcWidth;
+  scale->srcHeight = srcHeight;
+  scale->dstWidth  = dstWidth;
+  scale->dstHeight = dstHeight;
+  scale->srcX      = 0;
+  scale->srcY      = 0;
+  scale->row       = row;
+  memset(scale->hRow, 0, sizeof(scale->hRow));
+  memset(scale->acc, 0, sizeof(scale->acc));
+  return true;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Add weighted horizontally reduced row to destination row accumulator.
+ ******************************************************************************/
+static void SLIDESCALE_accumulate(SLIDESCALE_TypeDef *scale, uint32_t weight)
+{
+  uint32_t i;
+
+  for (i = 0; i < scale->dstWidth * 3; i++)
+  {
+    scale->acc[i] += (uint16_t)((scale->hRow[i] * weight) / scale->srcHeight);
+  }
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Round accumulated destination row to 24 bit RGB, pass it on and clear
+ *   accumulator.
+ ******************************************************************************/
+static void SLIDESCALE_emit(SLIDESCALE_TypeDef *scale)
+{
+  uint8_t  *rgb = (uint8_t *)scale->acc;
+  uint32_t i;
+  uint32_t v;
+
+  /* Converted in place, byte i is written after acc[i / 2] has been read */
+  for (i = 0; i < scale->dstWidth * 3; i++)
+  {
+    v = (scale->acc[i] + 128) >> 8;
+    rgb[i] = (uint8_t)((v > 255) ? 255 : v);
+  }
+  scale->row(rgb, scale->dstWidth);
+  memset(scale->acc, 0, sizeof(scale->acc));
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Complete current source row, adding it to the destination row(s) it
+ *   covers and emitting completed destination rows.
+ ******************************************************************************/
+static void SLIDESCALE_endRow(SLIDESCALE_TypeDef *scale)
+{
+  uint32_t start    = scale->srcY * scale->dstHeight;
+  uint32_t end      = start + scale->dstHeight;
+  uint32_t boundary = ((start / scale->srcHeight) + 1) * scale->srcHeight;
+
+  if (end < boundary)
+  {
+    SLIDESCALE_accumulate(scale, scale->dstHeight);
+  }
+  else
+  {
+    /* Row completes a destination row, and may extend into the next */
+    SLIDESCALE_accumulate(scale, boundary - start);
+    SLIDESCALE_emit(scale);
+    if (end > boundary)
+    {
+      SLIDESCALE_accumulate(scale, end - boundary);
+    }
+  }
+
+  memset(scale->hRow, 0, sizeof(scale->hRow));
+  scale->srcX = 0;
+  scale->srcY++;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Push source pixels to downscaler. Pixels continue where the previous
+ *   push ended, wrapping to the next row at the end of each source row.
+ *   Pixels beyond the end of the source image are ignored.
+ *
+ * @param[in] scale
+ *   Downscaler state.
+ *
+ * @param[in] rgb
+ *   Source pixels, 24 bit RGB.
+ *
+ * @param[in] pixels
+ *   Number of pixels in rgb.
+ ******************************************************************************/
+void SLIDESCALE_push(SLIDESCALE_TypeDef *scale,
+                     const uint8_t *rgb,
+                     uint32_t pixels)
+{
+  uint32_t srcWidth = scale->srcWidth;
+  uint32_t dstWidth = scale->dstWidth;
+  uint32_t start;
+  uint32_t end;
+  uint32_t boundary;
+  uint32_t w0;
+  uint32_t w1;
+  uint16_t *h;
+  int      c;
+
+  while (pixels && (scale->srcY < scale->srcHeight))
+  {
+    /* Split source pixel between the destination pixels it overlaps */
+    start    = scale->srcX * dstWidth;
+    end      = start + dstWidth;
+    boundary = ((start / srcWidth) + 1) * srcWidth;
+    h        = &scale->hRow[(start / srcWidth) * 3];
+
+    if (end <= boundary)
+    {
+      w0 = dstWidth;
+      w1 = 0;
+    }
+    else
+    {
+      w0 = boundary - start;
+      w1 = end - boundary;
+    }
+
+    for (c = 0; c < 3; c++)
+    {
+      h[c] += (uint16_t)(((uint32_t)rgb[c] * w0 * 256) / srcWidth);
+      if (w1)
+      {
+        h[c + 3] += (uint16_t)(((uint32_t)rgb[c] * w1 * 256) / srcWidth);
+      }
+    }
+
+    rgb += 3;
+    pixels--;
+    if (++scale->srcX == srcWidth)
+    {
+      SLIDESCALE_endRow(scale);
+    }
+  }
+}
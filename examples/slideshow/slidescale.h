@@ -0,0 +1,99 @@
+/**************************************************************************//**
+ * @file
+ * @brief Streaming area-average image downscaler for slideshow
+ * @author Energy Micro AS
+ * @version 3.20.0
+ ******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 Energy Micro AS, http://www.energymicro.com</b>
+ *******************************************************************************
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ * 4. The source and compiled code may only be used on Energy Micro "EFM32"
+ *    microcontrollers and "EFR4" radios.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: Energy Micro AS has no
+ * obligation to support this Software. Energy Micro AS is providing the
+ * Software "AS IS", with no express or implied warranties of any kind,
+ * including, but not limited to, any implied warranties of merchantability
+ * or fitness for any particular purpose or warranties against infringement
+ * of any proprietary rights of a third party.
+ *
+ * Energy Micro AS will not be liable for any consequential, incidental, or
+ * special damages, or any other relief, or for any claim by any third party,
+ * arising from your use of this Software.
+ *
+ *****************************************************************************/
+#ifndef __SLIDESCALE_H
+#define __SLIDESCALE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+   Streaming area-average (box filter) downscaler.
+
+   Source pixels are pushed in any chunk size, row by row, and destination
+   rows are delivered through a callback as soon as they are complete. Only
+   one row of horizontally reduced pixels and one row of accumulated
+   destination pixels are kept, so no frame buffer is needed. Any integer
+   or fractional ratio is supported, each destination pixel is the average
+   of the source area it covers, weighted by coverage.
+
+   Intermediate values have 8 fractional bits, source images must thus not
+   be wider or taller than 65535 pixels.
+*/
+
+/** Max width of destination image */
+#define SLIDESCALE_MAX_WIDTH  320
+
+/**
+ * Function receiving a completed destination row, 24 bit RGB. Rows are
+ * delivered in the same order as the source rows.
+ */
+typedef void (*SLIDESCALE_Row_TypeDef)(uint8_t *rgb, uint32_t pixels);
+
+/** Downscaler state */
+typedef struct
+{
+  uint32_t srcWidth;                   /**< Source image width */
+  uint32_t srcHeight;                  /**< Source image height */
+  uint32_t dstWidth;                   /**< Destination image width */
+  uint32_t dstHeight;                  /**< Destination image height */
+  uint32_t srcX;                       /**< Column of next source pixel */
+  uint32_t srcY;                       /**< Row of next source pixel */
+  SLIDESCALE_Row_TypeDef row;          /**< Output function */
+  /** Current source row reduced to destination width, 8.8 fixed point */
+  uint16_t hRow[SLIDESCALE_MAX_WIDTH * 3];
+  /** Destination row being accumulated, 8.8 fixed point */
+  uint16_t acc[SLIDESCALE_MAX_WIDTH * 3];
+} SLIDESCALE_TypeDef;
+
+void SLIDESCALE_fit(uint32_t srcWidth, uint32_t srcHeight,
+                    uint32_t maxWidth, uint32_t maxHeight,
+                    uint32_t *dstWidth, uint32_t *dstHeight);
+bool SLIDESCALE_init(SLIDESCALE_TypeDef *scale,
+                     uint32_t srcWidth, uint32_t srcHeight,
+                     uint32_t dstWidth, uint32_t dstHeight,
+                     SLIDESCALE_Row_TypeDef row);
+void SLIDESCALE_push(SLIDESCALE_TypeDef *scale,
+                     const uint8_t *rgb,
+                     uint32_t pixels);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -39,6 +39,7 @@
 #include "bsp.h"
 #include "bsp_trace.h"
 #include "slides.h"
+#include "slidelist.h"
 #include "ff.h"
 #include "microsd.h"
 #include "diskio.h"
@@ -48,10 +49,9 @@ volatile uint32_t msTicks;
 
 /* File system */
 FATFS Fatfs;
-char path[ 100 ];
 
-/* Manifest file */
-FIL manifest;
+/* Time in ms each slide is shown before switching to next */
+#define SLIDE_DELAY 150
 
 /* Local prototypes */
 int initFatFS(void);
@@ -117,17 +117,12 @@ int main(void)
 {
   uint16_t aemState  = 0;
   int      firstRun  = 1;
-  FRESULT res;
-  int mountStatus;
-
-  /* Used when iterating through directory */
-  FILINFO Finfo;
-  DIR dir;
-  FRESULT listDirStatus = FR_OK;
-
-  /* Used for manifest operation */
-  bool useManifest = false;
-  char buffer[20];
+  int      mountStatus;
+  uint32_t dwellStart;
+  uint32_t dwellUsed;
+  FRESULT  res;
+  FRESULT  indexStatus = FR_OK;
+  char     fileName[SLIDES_NAME_SIZE];
 
   /* Chip revision alignment and errata fixes */
   CHIP_Init();
@@ -154,82 +149,75 @@ int main(void)
   /* Initialize filesystem */
   mountStatus = initFatFS();
 
-  /* Open Manifest file. If a manifest file is not present, iterate through the
-   * File system in filesystem order. */
-  if (f_open(&manifest, "files.txt", FA_READ) == FR_OK)
-    useManifest = true;
+  /* Open slide index, built from the manifest file or the root directory */
+  /* if not present on the card, or if the card contents have changed */
+  if (mountStatus == 0)
+  {
+    indexStatus = SLIDELIST_open();
+  }
 
   /* Update TFT display forever */
   while (1)
   {
-    if (!useManifest)
+    /* Check if we should control TFT display instead of
+     * AEM/board control application. Read state of AEM pushbutton */
+    aemState = BSP_RegisterRead(BC_AEMSTATE);
+    if (aemState == 1)
     {
-      /* Open root directory */
-      strcpy(path, "");
-      listDirStatus = f_opendir(&dir, path);
-    }
-    /* Iterate through files */
-    while(1)
-    {
-      /* Check if we should control TFT display instead of
-       * AEM/board control application. Read state of AEM pushbutton */
-      aemState = BSP_RegisterRead(BC_AEMSTATE);
-      if (aemState == 1)
+      /* Make sure TFT init is run at least once */
+      if ((BSP_RegisterRead(BC_BUS_CFG) == BC_BUS_CFG_FSMC) || firstRun)
       {
-        /* Make sure TFT init is run at least once */
-        if ((BSP_RegisterRead(BC_BUS_CFG) == BC_BUS_CFG_FSMC) || firstRun)
-        {
-          SLIDES_init();
-          firstRun = 0;
-        }
+        SLIDES_init();
+        firstRun = 0;
+      }
 
-        /* Check disk status */
-        if (disk_status(0) != 0)
-        {
-          /* Filesystem not mounted, show fatal error. */
-          SLIDES_showError(true, "Fatal:\n  Filesystem is not ready.\n  (%d)", disk_status(0));
-        }
+      /* Check disk status */
+      if (disk_status(0) != 0)
+      {
+        /* Filesystem not mounted, show fatal error. */
+        SLIDES_showError(true, "Fatal:\n  Filesystem is not ready.\n  (%d)", disk_status(0));
+      }
 
-        /* Check if filesystem was successfully mounted. */
-        if (mountStatus != 0)
-        {
-          /* Filesystem not mounted, show fatal error. */
-          SLIDES_showError(true, "Fatal:\n  Filesystem could not be mounted.\n  (%d)", mountStatus);
-        }
+      /* Check if filesystem was successfully mounted. */
+      if (mountStatus != 0)
+      {
+        /* Filesystem not mounted, show fatal error. */
+        SLIDES_showError(true, "Fatal:\n  Filesystem could not be mounted.\n  (%d)", mountStatus);
+      }
 
-        /* Is there a manifest file present? */
-        if (useManifest)
-        {
-          /* If we are at the end of the file, reset filepointer */
-          if (f_eof(&manifest))
-             f_lseek(&manifest, 0);
-          /* Read next file from manifest file */
-          f_gets(buffer, 20, &manifest);
-          /* Display Bitmap */
-          SLIDES_showBMP(buffer);
-        }
-        else
+      /* Check to see if the slide index was correctly opened. */
+      if (indexStatus != FR_OK)
+      {
+        SLIDES_showError(true, "Fatal:\n  Could not read slide index.\n  (%d)", indexStatus);
+      }
+
+      /* Only the very first slide has not been prefetched */
+      if (!SLIDES_prefetchPending())
+      {
+        res = SLIDELIST_next(fileName);
+        if (res != FR_OK)
         {
-          /* Check to see if the root directory was correctly opened. */
-          if (listDirStatus != FR_OK)
-          {
-            SLIDES_showError(true, "Fatal:\n  Could not read root directory.\n  (%d)", listDirStatus);
-          }
-
-          /* Open the next entry in directory */
-          res = f_readdir(&dir, &Finfo);
-          if ((res != FR_OK) || !Finfo.fname[0])
-          {
-            /* End of directory listing. Break out of inner loop and reopen
-             * directory entry */
-            break;
-          }
-          /* Update display */
-          SLIDES_showBMP(Finfo.fname);
+          SLIDES_showError(true, "Fatal:\n  Could not find any slides.\n  (%d)", res);
         }
+        SLIDES_prefetchBMP(fileName);
+      }
 
-        /* Delay to allow the user to see the BMP file. */
-        Delay(150);
+      /* Update display */
+      SLIDES_showPrefetched();
+
+      /* While the user is looking at the slide, open the next one and */
+      /* decode its first rows, making the switch appear instantly. */
+      dwellStart = msTicks;
+      if (SLIDELIST_next(fileName) == FR_OK)
+      {
+        SLIDES_prefetchBMP(fileName);
+      }
+
+      /* Delay to allow the user to see the BMP file. */
+      dwellUsed = msTicks - dwellStart;
+      if (dwellUsed < SLIDE_DELAY)
+      {
+        Delay(SLIDE_DELAY - dwellUsed);
       }
     }
   }
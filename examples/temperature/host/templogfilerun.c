@@ -0,0 +1,382 @@
+/**************************************************************************//**
+ * @file
+ * @brief Host runner for temperature log kept on microSD
+ * @author Energy Micro AS
+ * @version 3.20.0
+ ******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 Energy Micro AS, http://www.energymicro.com</b>
+ *******************************************************************************
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ * 4. The source and compiled code may only be used on Energy Micro "EFM32"
+ *    microcontrollers and "EFR4" radios.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: Energy Micro AS has no
+ * obligation to support this Software. Energy Micro AS is providing the
+ * Software "AS IS", with no express or implied warranties of any kind,
+ * including, but not limited to, any implied warranties of merchantability
+ * or fitness for any particular purpose or warranties against infringement
+ * of any proprietary rights of a third party.
+ *
+ * Energy Micro AS will not be liable for any consequential, incidental, or
+ * special damages, or any other relief, or for any claim by any third party,
+ * arising from your use of this Software.
+ *
+ *****************************************************************************/
+/*
+   Host (Linux) runner for the temperature log file (templogfile.c) on the
+   emulated file system of host/ffemu.c.
+
+   A random walk with large steps is logged, so that blocks close often
+   and the file holds more blocks than the RAM ring. At each simulated
+   reset the log is initialized again and restored from the file: the
+   readings must be numbered on from the last closed block, the newest
+   blocks that fit in the ring must be restored, and random windows
+   queried must match the readings kept in an array. Logging then goes on
+   past the reset. The checks are repeated after garbage is appended to the
+   file, as by a reset while writing a record, and after the last record
+   is changed to not follow the one before it: the file must be truncated
+   to whole valid records. Without a card, and after a write has failed,
+   the log must go on in RAM.
+
+   Usage: templogfilerun
+*/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include "ff.h"
+#include "ffemu.h"
+#include "templog.h"
+#include "templogfile.h"
+
+/** Name of log file on test card */
+#define TEST_FILE_NAME  "TEMPLOG.BIN"
+
+/** Readings logged between resets */
+#define TEST_READINGS   12000
+
+/** Resets */
+#define TEST_RESETS     3
+
+/** Random windows queried after each reset */
+#define TEST_QUERIES    2000
+
+/** Directory holding test card */
+static char cardDir[] = "/tmp/templogfileXXXXXX";
+
+/** File system of emulated card */
+static FATFS fatfs;
+
+/** Log and its file under test */
+static TEMPLOG_Log_TypeDef      tempLog;
+static TEMPLOGFILE_File_TypeDef logFile;
+
+/** Readings appended, for comparison */
+static int16_t values[(TEST_RESETS + 1) * TEST_READINGS];
+
+/** Blocks flushed to file */
+static uint32_t flushes;
+
+/** Random generator state */
+static uint32_t seed = 1;
+
+/** Value of random walk */
+static int32_t walk;
+
+/***************************************************************************//**
+ * @brief
+ *   Random number in 0 to range - 1.
+ ******************************************************************************/
+static uint32_t randomBelow(uint32_t range)
+{
+  seed = seed * 1103515245 + 12345;
+  return (seed >> 8) % range;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Append readings of random walk to log, numbered on from its next.
+ ******************************************************************************/
+static void appendReadings(uint32_t count)
+{
+  while (count--)
+  {
+    if (randomBelow(4) == 0)
+    {
+      walk += (int32_t)randomBelow(601) - 300;
+      if ((walk > 30000) || (walk < -30000))
+      {
+        walk = 0;
+      }
+    }
+    values[tempLog.next] = (int16_t)walk;
+    TEMPLOG_append(&tempLog, (int16_t)walk);
+  }
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Flush of closed block, counts blocks written to file.
+ ******************************************************************************/
+static void countFlush(const TEMPLOG_Summary_TypeDef *summary,
+                       const uint8_t *data,
+                       void *user)
+{
+  if (((TEMPLOGFILE_File_TypeDef *)user)->status == FR_OK)
+  {
+    flushes++;
+  }
+  TEMPLOGFILE_flush(summary, data, user);
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Number of first reading of open block, readings before it are in file.
+ ******************************************************************************/
+static uint32_t closedReadings(void)
+{
+  return tempLog.summary[(tempLog.tail + tempLog.used - 1) % TEMPLOG_BLOCKS].first;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Initialize log and restore it from file, as at start of example.
+ ******************************************************************************/
+static FRESULT restart(void)
+{
+  /* Records are synced when written, closing writes nothing more */
+  if (logFile.status == FR_OK)
+  {
+    f_close(&logFile.file);
+  }
+  TEMPLOG_init(&tempLog, countFlush, &logFile);
+  return TEMPLOGFILE_open(&logFile, TEST_FILE_NAME, &tempLog);
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Compare random windows queried with readings kept, from oldest reading
+ *   held in tempLog.
+ ******************************************************************************/
+static bool checkQueries(void)
+{
+  TEMPLOG_Stats_TypeDef stats;
+  uint32_t              oldest = TEMPLOG_oldest(&tempLog);
+  uint32_t              from;
+  uint32_t              to;
+  uint32_t              count;
+  uint32_t              i;
+  uint32_t              n;
+  int16_t               min;
+  int16_t               max;
+  int64_t               sum;
+
+  for (n = 0; (n < TEST_QUERIES) && tempLog.next; n++)
+  {
+    from = randomBelow(tempLog.next);
+    to   = from + 1 + randomBelow(tempLog.next - from);
+    TEMPLOG_query(&tempLog, from, to, &stats);
+
+    count = 0;
+    min   = 0;
+    max   = 0;
+    sum   = 0;
+    for (i = (from < oldest) ? oldest : from; i < to; i++)
+    {
+      if ((count == 0) || (values[i] < min))
+      {
+        min = values[i];
+      }
+      if ((count == 0) || (values[i] > max))
+      {
+        max = values[i];
+      }
+      sum += values[i];
+      count++;
+    }
+    if ((stats.count != count) || (stats.sum != sum) ||
+        (count && ((stats.min != min) || (stats.max != max))))
+    {
+      printf("window %lu to %lu: %lu readings, expected %lu\n",
+             (unsigned long) from, (unsigned long) to,
+             (unsigned long) stats.count, (unsigned long) count);
+      return false;
+    }
+  }
+  return true;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Records restored from file of given records, those that fit in the ring
+ *   besides the open block.
+ ******************************************************************************/
+static uint32_t restorable(uint32_t records)
+{
+  return (records < (TEMPLOG_BLOCKS - 1)) ? records : TEMPLOG_BLOCKS - 1;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Reset and check log restored from file.
+ * @param[in] what
+ *   Case shown.
+ * @param[in] next
+ *   Number of reading expected to be appended next.
+ * @param[in] records
+ *   Records expected in file.
+ * @param[in] expected
+ *   Records expected to be restored.
+ ******************************************************************************/
+static bool checkRestart(const char *what, uint32_t next, uint32_t records,
+                         uint32_t expected)
+{
+  FRESULT res = restart();
+
+  printf("%-24s %6lu readings, %3lu records, %2lu restored\n", what,
+         (unsigned long) tempLog.next, (unsigned long) records,
+         (unsigned long) logFile.restored);
+  if (res != FR_OK)
+  {
+    printf("TEMPLOGFILE_open() failed (%d)\n", (int) res);
+    return false;
+  }
+  if ((tempLog.next != next) || (logFile.restored != expected) ||
+      (f_size(&logFile.file) != records * TEMPLOGFILE_RECORD_BYTES))
+  {
+    printf("expected %lu readings, %lu restored and %lu bytes of file\n",
+           (unsigned long) next, (unsigned long) expected,
+           (unsigned long)(records * TEMPLOGFILE_RECORD_BYTES));
+    return false;
+  }
+  return checkQueries();
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Change log file on host, at given offset from end.
+ ******************************************************************************/
+static bool changeFile(long offset, const void *data, size_t length)
+{
+  char path[300];
+  FILE *f;
+  bool ok;
+
+  snprintf(path, sizeof(path), "%s/%s", cardDir, TEST_FILE_NAME);
+  f = fopen(path, "r+b");
+  if (!f)
+  {
+    return false;
+  }
+  ok = (fseek(f, offset, SEEK_END) == 0) && (fwrite(data, 1, length, f) == length);
+  return (fclose(f) == 0) && ok;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Run tests on test card.
+ ******************************************************************************/
+static bool runTests(void)
+{
+  static const uint8_t    garbage[100] = { 0x5a };
+  TEMPLOG_Summary_TypeDef summary;
+  uint32_t                records = 0;
+  uint32_t                closed;
+  int                     i;
+
+  if (!checkRestart("new card", 0, 0, 0))
+  {
+    return false;
+  }
+
+  for (i = 0; i < TEST_RESETS; i++)
+  {
+    appendReadings(TEST_READINGS);
+    closed  = closedReadings();
+    records = flushes;
+    if (!checkQueries() || !checkRestart("reset", closed, records, restorable(records)))
+    {
+      return false;
+    }
+  }
+
+  /* Reset while writing a record */
+  if (!changeFile(0, garbage, sizeof(garbage)) ||
+      !checkRestart("torn record", closed, records, restorable(records)))
+  {
+    return false;
+  }
+
+  /* Last record does not follow the one before it */
+  summary       = tempLog.summary[(tempLog.tail + tempLog.used - 2) % TEMPLOG_BLOCKS];
+  closed        = summary.first;
+  summary.first = summary.first + 1;
+  if (!changeFile(-(long)TEMPLOGFILE_RECORD_BYTES, &summary, sizeof(summary)) ||
+      !checkRestart("broken record", closed, records - 1,
+                    restorable(records) - 1))
+  {
+    return false;
+  }
+
+  /* Failed write, file is closed and log goes on in RAM */
+  f_close(&logFile.file);
+  appendReadings(TEST_READINGS);
+  printf("%-24s %6lu readings, status %d\n", "failed write",
+         (unsigned long) tempLog.next, (int) logFile.status);
+  if ((logFile.status == FR_OK) || !checkQueries())
+  {
+    return false;
+  }
+
+  /* No card */
+  FFEMU_init("");
+  if (restart() == FR_OK)
+  {
+    printf("log file opened without card\n");
+    return false;
+  }
+  appendReadings(TEST_READINGS);
+  printf("%-24s %6lu readings, status %d\n", "no card",
+         (unsigned long) tempLog.next, (int) logFile.status);
+  return (tempLog.next == TEST_READINGS) && checkQueries();
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Main function.
+ ******************************************************************************/
+int main(void)
+{
+  char path[300];
+  bool ok;
+
+  if (!mkdtemp(cardDir) || !FFEMU_init(cardDir) || (f_mount(0, &fatfs) != FR_OK))
+  {
+    fprintf(stderr, "Could not make test card\n");
+    return 1;
+  }
+
+  ok = runTests();
+
+  snprintf(path, sizeof(path), "%s/%s", cardDir, TEST_FILE_NAME);
+  remove(path);
+  rmdir(cardDir);
+
+  printf("\n%s\n", ok ? "passed" : "FAILED");
+  return ok ? 0 : 1;
+}
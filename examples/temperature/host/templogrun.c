@@ -0,0 +1,422 @@
+/**************************************************************************//**
+ * @file
+ * @brief Host runner for compressed temperature history
+ * @author Energy Micro AS
+ * @version 3.20.0
+ ******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 Energy Micro AS, http://www.energymicro.com</b>
+ *******************************************************************************
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ * 4. The source and compiled code may only be used on Energy Micro "EFM32"
+ *    microcontrollers and "EFR4" radios.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: Energy Micro AS has no
+ * obligation to support this Software. Energy Micro AS is providing the
+ * Software "AS IS", with no express or implied warranties of any kind,
+ * including, but not limited to, any implied warranties of merchantability
+ * or fitness for any particular purpose or warranties against infringement
+ * of any proprietary rights of a third party.
+ *
+ * Energy Micro AS will not be liable for any consequential, incidental, or
+ * special damages, or any other relief, or for any claim by any third party,
+ * arising from your use of this Software.
+ *
+ *****************************************************************************/
+
+/*
+   Host runner for the compressed temperature history (templog.c).
+
+   Density: a day of readings every 2 seconds is logged for synthetic
+   traces of each example, and the bytes used and bits per reading are
+   shown. The day must fit in the RAM ring, so that the oldest reading is
+   still held at the end of the day:
+   - "ds75 9 bit": the DVK temperature sensor at its default 0.5 degree
+     resolution, logged in 1/2 degrees as by temperature.c,
+   - "ds75 12 bit": the same at 1/16 degree resolution, logged in 1/16
+     degrees, shown only,
+   - "inttemp": the internal sensor averaged as by inttemp.c, logged in
+     1/10 degrees.
+   The traces are a daily swing of 3 degrees, heating cycling 0.4 degrees
+   every 20 minutes and gaussian noise before rounding.
+
+   Queries: for each trace, and for a random walk with large steps run for
+   several days so the ring wraps and old blocks are dropped, windows of
+   random position and length are queried and compared with the readings
+   kept in an array. The flushed blocks must cover each closed block once.
+   The time per query is shown against summing the same window of an
+   uncompressed array, for one hour and one day windows.
+
+   Usage: templogrun
+*/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+#include "templog.h"
+
+/** Readings per day, one every 2 seconds. */
+#define TEMPLOGRUN_DAY          43200
+/** Readings per hour. */
+#define TEMPLOGRUN_HOUR         1800
+/** Days of random walk. */
+#define TEMPLOGRUN_WALK_DAYS    4
+/** Random windows queried per trace. */
+#define TEMPLOGRUN_QUERIES      20000
+/** Queries timed per window length. */
+#define TEMPLOGRUN_TIMED        200000
+
+/** Synthetic trace. */
+typedef struct
+{
+  const char *name;
+  /** Resolution in degrees Celsius. */
+  double     step;
+  /** Log units per degree Celsius. */
+  double     units;
+  /** Noise, degrees Celsius. */
+  double     noise;
+  /** Must fit a day in ring. */
+  bool       fit;
+} TEMPLOGRUN_Trace_TypeDef;
+
+static const TEMPLOGRUN_Trace_TypeDef templogRunTraces[] =
+{
+  { "ds75 9 bit",  0.5,    2,  0.05, true  },
+  { "ds75 12 bit", 0.0625, 16, 0.05, false },
+  { "inttemp",     0.1,    10, 0.02, true  },
+};
+
+/** Readings appended, for comparison. */
+static int16_t templogRunValues[TEMPLOGRUN_WALK_DAYS * TEMPLOGRUN_DAY];
+
+/** Log under test. */
+static TEMPLOG_Log_TypeDef templogRunLog;
+
+/** Number of next reading expected in flushed block, and blocks flushed. */
+static uint32_t templogRunFlushNext;
+static uint32_t templogRunFlushCount;
+static int      templogRunFlushErrors;
+
+/** Random generator state. */
+static uint64_t templogRunSeed;
+
+/***************************************************************************//**
+ * @brief
+ *   Uniform random number in (0, 1).
+ ******************************************************************************/
+static double templogRunUniform(void)
+{
+  templogRunSeed = templogRunSeed * 6364136223846793005ULL +
+                   1442695040888963407ULL;
+  return ((templogRunSeed >> 11) + 0.5) / 9007199254740992.0;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Gaussian random number, zero mean and unit variance (Box-Muller).
+ ******************************************************************************/
+static double templogRunGauss(void)
+{
+  double u = templogRunUniform();
+  double v = templogRunUniform();
+
+  return sqrt(-2.0 * log(u)) * cos(6.283185307179586 * v);
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Seconds of monotonic clock.
+ ******************************************************************************/
+static double templogRunSeconds(void)
+{
+  struct timespec t;
+
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return t.tv_sec + t.tv_nsec * 1e-9;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Flush of closed block, checks blocks are passed once and in order.
+ ******************************************************************************/
+static void templogRunFlush(const TEMPLOG_Summary_TypeDef *summary,
+                            const uint8_t *data,
+                            void *user)
+{
+  (void)data;
+  (void)user;
+
+  if ((summary->first != templogRunFlushNext) || (summary->count == 0) ||
+      (summary->bytes > TEMPLOG_BLOCK_BYTES))
+  {
+    templogRunFlushErrors++;
+  }
+  templogRunFlushNext = summary->first + summary->count;
+  templogRunFlushCount++;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Log readings of day of synthetic trace.
+ ******************************************************************************/
+static uint32_t templogRunDay(const TEMPLOGRUN_Trace_TypeDef *trace)
+{
+  double   temp;
+  uint32_t i;
+
+  for (i = 0; i < TEMPLOGRUN_DAY; i++)
+  {
+    temp = 21.0 + 1.5 * sin(6.283185307179586 * i / TEMPLOGRUN_DAY) +
+           0.2 * sin(6.283185307179586 * i / (20 * 30)) +
+           trace->noise * templogRunGauss();
+    templogRunValues[i] = (int16_t)lround(floor(temp / trace->step + 0.5) *
+                                          trace->step * trace->units);
+    TEMPLOG_append(&templogRunLog, templogRunValues[i]);
+  }
+  return TEMPLOGRUN_DAY;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Log readings of random walk with large steps, over full int16 range.
+ ******************************************************************************/
+static uint32_t templogRunWalk(void)
+{
+  int32_t  value = 0;
+  uint32_t i;
+  double   u;
+
+  for (i = 0; i < TEMPLOGRUN_WALK_DAYS * TEMPLOGRUN_DAY; i++)
+  {
+    u = templogRunUniform();
+    if (u < 0.01)
+    {
+      value = (templogRunUniform() < 0.5) ? INT16_MIN : INT16_MAX;
+    }
+    else if (u < 0.1)
+    {
+      value += (int32_t)(templogRunGauss() * 3000);
+    }
+    else if (u < 0.5)
+    {
+      value += (int32_t)(templogRunGauss() * 4);
+    }
+    if (value > INT16_MAX)
+    {
+      value = INT16_MAX;
+    }
+    if (value < INT16_MIN)
+    {
+      value = INT16_MIN;
+    }
+    templogRunValues[i] = (int16_t)value;
+    TEMPLOG_append(&templogRunLog, (int16_t)value);
+  }
+  return TEMPLOGRUN_WALK_DAYS * TEMPLOGRUN_DAY;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Compare random window queries with readings, returning errors.
+ ******************************************************************************/
+static int templogRunQueries(uint32_t count)
+{
+  TEMPLOG_Stats_TypeDef stats;
+  uint32_t              oldest = TEMPLOG_oldest(&templogRunLog);
+  uint32_t              from;
+  uint32_t              to;
+  uint32_t              i;
+  uint32_t              n;
+  int64_t               sum;
+  int16_t               min;
+  int16_t               max;
+  bool                  found;
+  int                   errors = 0;
+
+  for (n = 0; n < TEMPLOGRUN_QUERIES; n++)
+  {
+    /* Windows may start before oldest reading held */
+    from = (uint32_t)(templogRunUniform() * count);
+    if (templogRunUniform() < 0.5)
+    {
+      to = from + (uint32_t)(templogRunUniform() * 100);
+    }
+    else
+    {
+      to = from + (uint32_t)(templogRunUniform() * (count - from));
+    }
+    if (to > count)
+    {
+      to = count;
+    }
+
+    found = TEMPLOG_query(&templogRunLog, from, to, &stats);
+
+    if (from < oldest)
+    {
+      from = oldest;
+    }
+    sum = 0;
+    min = INT16_MAX;
+    max = INT16_MIN;
+    for (i = from; i < to; i++)
+    {
+      sum += templogRunValues[i];
+      min  = (templogRunValues[i] < min) ? templogRunValues[i] : min;
+      max  = (templogRunValues[i] > max) ? templogRunValues[i] : max;
+    }
+
+    if ((found != (to > from)) ||
+        (stats.count != ((to > from) ? to - from : 0)) ||
+        (found && ((stats.sum != sum) || (stats.min != min) ||
+                   (stats.max != max))))
+    {
+      if (errors < 5)
+      {
+        printf("  query %lu..%lu: count %lu sum %lld min %d max %d, "
+               "expected count %lu sum %lld min %d max %d\n",
+               (unsigned long)from, (unsigned long)to,
+               (unsigned long)stats.count, (long long)stats.sum,
+               stats.min, stats.max,
+               (unsigned long)((to > from) ? to - from : 0), (long long)sum,
+               min, max);
+      }
+      errors++;
+    }
+  }
+  return errors;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Time queries of windows of given length ending at latest reading,
+ *   against summing an uncompressed array, ns per query.
+ ******************************************************************************/
+static void templogRunTime(const char *name, uint32_t count, uint32_t length)
+{
+  TEMPLOG_Stats_TypeDef stats;
+  volatile int64_t      sink = 0;
+  double                start;
+  double                logNs;
+  double                arrayNs;
+  uint32_t              from;
+  uint32_t              i;
+  uint32_t              n;
+  int64_t               sum;
+  int                   runs = TEMPLOGRUN_TIMED / 100;
+
+  start = templogRunSeconds();
+  for (n = 0; n < (uint32_t)TEMPLOGRUN_TIMED; n++)
+  {
+    /* Vary start, so that the window ends mostly fall inside blocks */
+    from = count - length + (n % 97);
+    TEMPLOG_query(&templogRunLog, from, from + length, &stats);
+    sink += stats.sum;
+  }
+  logNs = (templogRunSeconds() - start) * 1e9 / TEMPLOGRUN_TIMED;
+
+  start = templogRunSeconds();
+  for (n = 0; n < (uint32_t)runs; n++)
+  {
+    from = count - length + (n % 97);
+    for (sum = 0, i = from; i < from + length; i++)
+    {
+      sum += templogRunValues[i];
+    }
+    sink += sum;
+  }
+  arrayNs = (templogRunSeconds() - start) * 1e9 / runs;
+
+  printf("  %-5s window: %8.0f ns per query, array sum %8.0f ns\n",
+         name, logNs, arrayNs);
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Main function.
+ ******************************************************************************/
+int main(void)
+{
+  const TEMPLOGRUN_Trace_TypeDef *trace;
+  unsigned int                   t;
+  unsigned int                   b;
+  uint32_t                       count;
+  uint32_t                       bytes;
+  uint32_t                       closed;
+  int                            errors;
+  int                            failed = 0;
+
+  printf("RAM ring %d blocks of %d bytes, summary index %d bytes\n",
+         TEMPLOG_BLOCKS, TEMPLOG_BLOCK_BYTES,
+         (int)(TEMPLOG_BLOCKS * sizeof(TEMPLOG_Summary_TypeDef)));
+
+  for (t = 0; t <= sizeof(templogRunTraces) / sizeof(templogRunTraces[0]); t++)
+  {
+    trace = (t < sizeof(templogRunTraces) / sizeof(templogRunTraces[0])) ?
+            &templogRunTraces[t] : NULL;
+
+    templogRunSeed        = 1;
+    templogRunFlushNext   = 0;
+    templogRunFlushCount  = 0;
+    templogRunFlushErrors = 0;
+    TEMPLOG_init(&templogRunLog, templogRunFlush, NULL);
+
+    count = trace ? templogRunDay(trace) : templogRunWalk();
+    printf("\n%s:\n", trace ? trace->name : "random walk");
+
+    for (bytes = 0, b = 0; b < templogRunLog.used; b++)
+    {
+      bytes += templogRunLog.summary[(templogRunLog.tail + b) % TEMPLOG_BLOCKS].bytes;
+    }
+    printf("  %lu readings, %u blocks, %lu bytes, %.2f bits per reading, "
+           "oldest reading %lu\n",
+           (unsigned long)count, templogRunLog.used, (unsigned long)bytes,
+           8.0 * bytes / (count - TEMPLOG_oldest(&templogRunLog)),
+           (unsigned long)TEMPLOG_oldest(&templogRunLog));
+    if (trace && trace->fit && (TEMPLOG_oldest(&templogRunLog) != 0))
+    {
+      printf("  FAIL: day does not fit in ring\n");
+      failed = 1;
+    }
+
+    closed = templogRunFlushNext;
+    if (templogRunFlushErrors ||
+        (closed != templogRunLog.summary[(templogRunLog.tail + templogRunLog.used - 1) %
+                                         TEMPLOG_BLOCKS].first) ||
+        (templogRunFlushCount < templogRunLog.used - 1))
+    {
+      printf("  FAIL: flushed blocks\n");
+      failed = 1;
+    }
+
+    errors = templogRunQueries(count);
+    printf("  %d queries, %d errors\n", TEMPLOGRUN_QUERIES, errors);
+    if (errors)
+    {
+      printf("  FAIL: queries\n");
+      failed = 1;
+    }
+
+    if (trace && trace->fit)
+    {
+      templogRunTime("hour", count, TEMPLOGRUN_HOUR);
+      templogRunTime("day", count, TEMPLOGRUN_DAY);
+    }
+  }
+
+  printf("\n%s\n", failed ? "FAILED" : "passed");
+  return failed;
+}
@@ -6,6 +6,8 @@
  *
  * @par Usage
  * @li Joystick Push toggles Celsius/Fahrenheit display mode.
+ * @li Joystick Up/Down cycles between current temperature, and lowest (L),
+ *     highest (H) and average (A) temperature of the last 24 hours.
  *
  * @note
  *   This example requires BSP version 1.0.6 or later.
@@ -47,68 +49,94 @@
 #include "em_chip.h"
 #include "em_emu.h"
 #include "em_dbg.h"
-#include "em_gpio.h"
+#include "em_int.h"
 #include "bsp.h"
 #include "bsp_trace.h"
 #include "segmentlcd.h"
 #include "rtcdrv.h"
 #include "i2cdrv.h"
 #include "tempsens.h"
+#include "templog.h"
+#include "templogfile.h"
+#include "keyinput.h"
+#include "ff.h"
+#include "microsd.h"
 
-/** Interrupt pin used to detect joystick activity */
-#define GPIO_INT_PIN 14
+/** Readings logged per day, one every 2 seconds */
+#define TEMP_LOG_DAY 43200
+
+/** File on microSD card keeping closed blocks of history */
+#define TEMP_LOG_FILE "TEMPLOG.BIN"
 
 /** Flag used to indicate if displaying in Celsius or Fahrenheit */
 static int showFahrenheit;
 
+/** Display mode, 0 current, then lowest, highest and average of last day */
+static int showMode;
+
+/** Letter shown for display mode */
+static const char showModeLetter[] = " LHA";
+
+/** History of readings in 1/2 degree Celsius, the display resolution */
+static TEMPLOG_Log_TypeDef tempLog;
+
+/** File system on microSD card, and file the history is kept in */
+static FATFS tempFatfs;
+static TEMPLOGFILE_File_TypeDef tempLogFile;
+
+/** Set by RTC callback when next reading is due */
+static volatile bool tempReadDue;
+
 /* Local prototypes */
-void temperatureIRQInit(void);
+void temperatureTrigger(void);
+void temperatureKey(const KEYQ_Event_TypeDef *event);
 void temperatureUpdateLCD(TEMPSENS_Temp_TypeDef *temp);
+int16_t temperatureToHalf(const TEMPSENS_Temp_TypeDef *temp);
+void temperatureLogError(void);
+DWORD get_fattime(void);
 
 /**************************************************************************//**
- * @brief GPIO Interrupt handler
- * This interrupt handler is not an example of good design, as it will do
- * a lot of operations inside the interrupt handler.
+ * @brief RTC callback, next reading due
  *****************************************************************************/
-void GPIO_EVEN_IRQHandler(void)
+void temperatureTrigger(void)
 {
-  uint16_t joystick;
+  tempReadDue = true;
+}
 
-  /* Clear interrupt */
-  BSP_InterruptFlagsClear(BC_INTEN_JOYSTICK);
-  GPIO_IntClear(1 << GPIO_INT_PIN);
 
-  /* LEDs on to indicate joystick used */
+/**************************************************************************//**
+ * @brief Handle joystick event
+ * @param[in] event Key event.
+ *****************************************************************************/
+void temperatureKey(const KEYQ_Event_TypeDef *event)
+{
+  /* LEDs on while joystick used */
+  if (event->type == keyqRelease)
+  {
+    BSP_LedsSet(0x0000);
+    return;
+  }
+  if (event->type != keyqPress)
+  {
+    return;
+  }
   BSP_LedsSet(0xffff);
 
-  /* Read and store joystick activity - wait for key release */
-  joystick = BSP_JoystickGet();
-  while (BSP_JoystickGet());
-
-  /* LEDs off to indicate joystick release */
-  BSP_LedsSet(0x0000);
-
   /* Push toggles celsius/fahrenheit */
-  if (joystick & BC_JOYSTICK_CENTER)
+  if (event->key & BC_JOYSTICK_CENTER)
   {
     showFahrenheit ^= 1;
   }
-}
-
-
-/**************************************************************************//**
- * @brief Initialize GPIO interrupt for joystick (ie FPGA signal)
- *****************************************************************************/
-void temperatureIRQInit(void)
-{
-  /* Configure interrupt pin as input with pull-up */
-  GPIO_PinModeSet(gpioPortC, GPIO_INT_PIN, gpioModeInputPull, 1);
-
-  /* Set falling edge interrupt and clear/enable it */
-  GPIO_IntConfig(gpioPortC, GPIO_INT_PIN, false, true, true);
 
-  NVIC_ClearPendingIRQ(GPIO_EVEN_IRQn);
-  NVIC_EnableIRQ(GPIO_EVEN_IRQn);
+  /* Up/down cycles display mode */
+  if (event->key & BC_JOYSTICK_UP)
+  {
+    showMode = (showMode + 1) % (sizeof(showModeLetter) - 1);
+  }
+  if (event->key & BC_JOYSTICK_DOWN)
+  {
+    showMode = (showMode + sizeof(showModeLetter) - 2) % (sizeof(showModeLetter) - 1);
+  }
 }
 
 
@@ -174,6 +202,9 @@ void temperatureUpdateLCD(TEMPSENS_Temp_TypeDef *temp)
   /* 0.1s */
   text[3] = '0' + (abs(dtemp.f) / 1000);
 
+  /* Display mode */
+  text[6] = showModeLetter[showMode];
+
   SegmentLCD_Write(text);
   SegmentLCD_Symbol(LCD_SYMBOL_DP4, 1);
 
@@ -187,6 +218,41 @@ void temperatureUpdateLCD(TEMPSENS_Temp_TypeDef *temp)
   }
 }
 
+/**************************************************************************//**
+ * @brief Convert temperature to 1/2 degrees, rounded to nearest
+ * @param temp Temperature
+ * @return Temperature in 1/2 degrees
+ *****************************************************************************/
+int16_t temperatureToHalf(const TEMPSENS_Temp_TypeDef *temp)
+{
+  int32_t t = temp->i * 10000 + temp->f;
+
+  return (int16_t)(((t >= 0) ? (t + 2500) : (t - 2500)) / 5000);
+}
+
+/**************************************************************************//**
+ * @brief Show that history is no longer kept on microSD card, for 2 seconds
+ *****************************************************************************/
+void temperatureLogError(void)
+{
+  SegmentLCD_Write("SD ERR");
+  RTCDRV_Trigger(2000, NULL);
+  EMU_EnterEM2(true);
+}
+
+/**************************************************************************//**
+ * @brief
+ *   This function is required by the FAT file system in order to provide
+ *   timestamps for created files. Since we do not have a reliable clock we
+ *   hardcode a value here.
+ * @return
+ *    A DWORD containing the current time and date as a packed datastructure.
+ *****************************************************************************/
+DWORD get_fattime(void)
+{
+  return (28 << 25) | (2 << 21) | ( 1 << 16);
+}
+
 /**************************************************************************//**
  * @brief  Main function
  *****************************************************************************/
@@ -194,9 +260,15 @@ int main(void)
 {
   I2C_Init_TypeDef i2cInit = I2C_INIT_DEFAULT;
   TEMPSENS_Temp_TypeDef temp;
+  TEMPSENS_Temp_TypeDef shown;
+  TEMPLOG_Stats_TypeDef stats;
   /* Define previous temp to invalid, just to ensure update first time */
   TEMPSENS_Temp_TypeDef prevTemp = { 1000, 0};
+  KEYQ_Event_TypeDef event;
   int prevShowFahrenheit = showFahrenheit;
+  int prevShowMode = showMode;
+  int16_t half;
+  FRESULT res;
 
   /* Chip revision alignment and errata fixes */
   CHIP_Init();
@@ -212,44 +284,115 @@ int main(void)
 
   SegmentLCD_AllOff();
 
-  /* Enable board control interrupts */
-  BSP_InterruptDisable(0xffff);
-  BSP_InterruptFlagsClear(0xffff);
-  BSP_InterruptEnable(BC_INTEN_JOYSTICK);
-  temperatureIRQInit();
+  /* Joystick events */
+  KEYINPUT_init(BC_INTEN_JOYSTICK);
 
   /* Initialize I2C driver, using standard rate. Devices on DVK itself */
   /* supports fast mode, but in case some slower devices are added on */
   /* prototype board, we use standard mode. */
   I2CDRV_Init(&i2cInit);
 
-  /* Main loop - just read temperature and update LCD */
+  /* Enable SPI access to MicroSD card */
+  BSP_RegisterWrite(BC_SPI_CFG, BC_SPI_CFG_MICROSD);
+  BSP_PeripheralAccess(BSP_SPI, true);
+  MICROSD_Init();
+
+  /* Closed blocks of history are appended to a file on the microSD card, */
+  /* and restored from it after reset. Without card the history is kept */
+  /* in RAM only. The DVK EEPROM is left to the eeprom example. */
+  TEMPLOG_init(&tempLog, TEMPLOGFILE_flush, &tempLogFile);
+  res = f_mount(0, &tempFatfs);
+  if (res == FR_OK)
+  {
+    res = TEMPLOGFILE_open(&tempLogFile, TEMP_LOG_FILE, &tempLog);
+  }
+  if (res != FR_OK)
+  {
+    tempLogFile.status = res;
+    temperatureLogError();
+  }
+  tempReadDue = true;
+
+  /* Main loop - read temperature when due, handle joystick and update LCD */
   while (1)
   {
-    if (TEMPSENS_TemperatureGet(I2C0,
-                                TEMPSENS_DK_ADDR,
-                                &temp) < 0)
+    if (tempReadDue)
     {
-      SegmentLCD_Write("ERROR");
-      /* Enter EM2, no wakeup scheduled */
-      EMU_EnterEM2(true);
+      tempReadDue = false;
+
+      if (TEMPSENS_TemperatureGet(I2C0,
+                                  TEMPSENS_DK_ADDR,
+                                  &temp) < 0)
+      {
+        SegmentLCD_Write("ERROR");
+        /* Enter EM2, no wakeup scheduled */
+        EMU_EnterEM2(true);
+      }
+
+      /* Log reading, at most one day is queried */
+      res = tempLogFile.status;
+      TEMPLOG_append(&tempLog, temperatureToHalf(&temp));
+      if ((res == FR_OK) && (tempLogFile.status != FR_OK))
+      {
+        /* Writing closed block failed, redraw after error shown */
+        temperatureLogError();
+        prevTemp.i = 1000;
+      }
+
+      /* Read every 2 seconds which is more than it takes worstcase to */
+      /* finish measurement inside sensor. */
+      RTCDRV_Trigger(2000, temperatureTrigger);
+    }
+
+    while (KEYINPUT_get(&event))
+    {
+      temperatureKey(&event);
+    }
+
+    /* Current temperature, or lowest, highest or average of last day */
+    shown = temp;
+    if (showMode &&
+        TEMPLOG_query(&tempLog,
+                      (tempLog.next > TEMP_LOG_DAY) ? tempLog.next - TEMP_LOG_DAY : 0,
+                      tempLog.next,
+                      &stats))
+    {
+      if (showMode == 1)
+      {
+        half = stats.min;
+      }
+      else if (showMode == 2)
+      {
+        half = stats.max;
+      }
+      else
+      {
+        half = TEMPLOG_average(&stats);
+      }
+      shown.i = half / 2;
+      shown.f = (half % 2) * 5000;
     }
 
     /* Update LCD display if any change. This is just an example of how */
     /* to save some energy, since the temperature normally is quite static. */
     /* The compare overhead is much smaller than actually updating the display. */
-    if ((prevTemp.i != temp.i) ||
-        (prevTemp.f != temp.f) ||
-        (prevShowFahrenheit != showFahrenheit))
+    if ((prevTemp.i != shown.i) ||
+        (prevTemp.f != shown.f) ||
+        (prevShowFahrenheit != showFahrenheit) ||
+        (prevShowMode != showMode))
     {
-      temperatureUpdateLCD(&temp);
+      temperatureUpdateLCD(&shown);
     }
-    prevTemp = temp;
+    prevTemp = shown;
     prevShowFahrenheit = showFahrenheit;
+    prevShowMode = showMode;
 
-    /* Read every 2 seconds which is more than it takes worstcase to */
-    /* finish measurement inside sensor. */
-    RTCDRV_Trigger(2000, NULL);
-    EMU_EnterEM2(true);
+    /* Enter EM2 until reading due or key event */
+    INT_Disable();
+    if (!tempReadDue && !KEYINPUT_pending())
+    {
+      EMU_EnterEM2(true);
+    }
+    INT_Enable();
   }
 }
@@ -0,0 +1,663 @@
+/**************************************************************************//**
+ * @file
+ * @brief Compressed temperature history with block summary index
+ * @author Energy Micro AS
+ * @version 3.20.0
+ ******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 Energy Micro AS, http://www.energymicro.com</b>
+ *******************************************************************************
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ * 4. The source and compiled code may only be used on Energy Micro "EFM32"
+ *    microcontrollers and "EFR4" radios.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: Energy Micro AS has no
+ * obligation to support this Software. Energy Micro AS is providing the
+ * Software "AS IS", with no express or implied warranties of any kind,
+ * including, but not limited to, any implied warranties of merchantability
+ * or fitness for any particular purpose or warranties against infringement
+ * of any proprietary rights of a third party.
+ *
+ * Energy Micro AS will not be liable for any consequential, incidental, or
+ * special damages, or any other relief, or for any claim by any third party,
+ * arising from your use of this Software.
+ *
+ *****************************************************************************/
+#include "templog.h"
+
+/** Token classes, by the top bits of their first byte. */
+#define TEMPLOG_TOKEN_GENERAL   0x80
+#define TEMPLOG_TOKEN_PAIR      0x40
+
+/** Longest run of small token, and of each change of pair token. */
+#define TEMPLOG_SMALL_RUN_MAX   31
+#define TEMPLOG_PAIR_RUN_MAX    3
+
+/** Run of general token marking run extension. */
+#define TEMPLOG_RUN_EXT         127
+
+/** Most bytes of run extension, varint of run up to TEMPLOG_BLOCK_MAX. */
+#define TEMPLOG_RUN_EXT_MAX     3
+
+/** No change held for pairing. */
+#define TEMPLOG_HELD_NONE       (-1)
+
+/***************************************************************************//**
+ * @brief
+ *   Zigzag encoding of delta, small magnitudes give small values.
+ ******************************************************************************/
+static uint32_t TEMPLOG_zigzag(int32_t delta)
+{
+  return (delta >= 0) ? ((uint32_t)delta << 1) : (((uint32_t)-delta << 1) - 1);
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Decode zigzag encoded delta.
+ ******************************************************************************/
+static int32_t TEMPLOG_unzigzag(uint32_t value)
+{
+  return (value & 1) ? -(int32_t)((value + 1) >> 1) : (int32_t)(value >> 1);
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Bytes of varint.
+ ******************************************************************************/
+static unsigned int TEMPLOG_varintSize(uint32_t value)
+{
+  unsigned int size = 1;
+
+  while (value >= 0x80)
+  {
+    value >>= 7;
+    size++;
+  }
+  return size;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Write varint, returning bytes written.
+ ******************************************************************************/
+static unsigned int TEMPLOG_varintWrite(uint8_t *data, uint32_t value)
+{
+  unsigned int size = 0;
+
+  while (value >= 0x80)
+  {
+    data[size++] = (uint8_t)(value | 0x80);
+    value >>= 7;
+  }
+  data[size++] = (uint8_t)value;
+  return size;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Read varint, returning bytes read.
+ ******************************************************************************/
+static unsigned int TEMPLOG_varintRead(const uint8_t *data, uint32_t *value)
+{
+  unsigned int size  = 0;
+  unsigned int shift = 0;
+  uint32_t     v     = 0;
+
+  do
+  {
+    v |= (uint32_t)(data[size] & 0x7f) << shift;
+    shift += 7;
+  } while (data[size++] & 0x80);
+
+  *value = v;
+  return size;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   true if change is +1 or -1 with run short enough for given token.
+ ******************************************************************************/
+static bool TEMPLOG_small(int32_t delta, unsigned int run, unsigned int runMax)
+{
+  return ((delta == 1) || (delta == -1)) && (run <= runMax);
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Longest token of change with given delta and any run.
+ ******************************************************************************/
+static unsigned int TEMPLOG_tokenMax(int32_t delta)
+{
+  return 1 + TEMPLOG_RUN_EXT_MAX + TEMPLOG_varintSize(TEMPLOG_zigzag(delta));
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Write token of change, small or general, returning bytes written.
+ ******************************************************************************/
+static unsigned int TEMPLOG_tokenWrite(uint8_t *data, int32_t delta, unsigned int run)
+{
+  unsigned int size = 1;
+
+  if (TEMPLOG_small(delta, run, TEMPLOG_SMALL_RUN_MAX))
+  {
+    data[0] = (uint8_t)(((delta < 0) ? 0x20 : 0) | run);
+    return 1;
+  }
+
+  if (run < TEMPLOG_RUN_EXT)
+  {
+    data[0] = (uint8_t)(TEMPLOG_TOKEN_GENERAL | run);
+  }
+  else
+  {
+    data[0] = TEMPLOG_TOKEN_GENERAL | TEMPLOG_RUN_EXT;
+    size   += TEMPLOG_varintWrite(data + size, run - TEMPLOG_RUN_EXT);
+  }
+  return size + TEMPLOG_varintWrite(data + size, TEMPLOG_zigzag(delta));
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Bytes of token of change.
+ ******************************************************************************/
+static unsigned int TEMPLOG_tokenSize(int32_t delta, unsigned int run)
+{
+  uint8_t data[1 + TEMPLOG_RUN_EXT_MAX + 3];
+
+  return TEMPLOG_tokenWrite(data, delta, run);
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Index of open block, the newest one.
+ ******************************************************************************/
+static unsigned int TEMPLOG_head(const TEMPLOG_Log_TypeDef *log)
+{
+  return (log->tail + log->used - 1) % TEMPLOG_BLOCKS;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Bytes written by TEMPLOG_writeChange() of pending change, not closing
+ *   block, and whether a change is held after.
+ ******************************************************************************/
+static unsigned int TEMPLOG_changeSize(const TEMPLOG_Log_TypeDef *log, bool *held)
+{
+  *held = false;
+  if (TEMPLOG_small(log->delta, log->run, TEMPLOG_PAIR_RUN_MAX))
+  {
+    *held = (log->held == TEMPLOG_HELD_NONE);
+    return *held ? 0 : 1;
+  }
+  return ((log->held == TEMPLOG_HELD_NONE) ? 0 : 1) +
+         TEMPLOG_tokenSize(log->delta, log->run);
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Write pending change to open block, which has room for it. A short +1
+ *   or -1 change is held to be paired with the next one, unless the block
+ *   is being closed.
+ ******************************************************************************/
+static void TEMPLOG_writeChange(TEMPLOG_Log_TypeDef *log, bool closing)
+{
+  TEMPLOG_Summary_TypeDef *summary = &log->summary[TEMPLOG_head(log)];
+  uint8_t                 *data    = log->data[TEMPLOG_head(log)];
+  int                     change;
+
+  if (TEMPLOG_small(log->delta, log->run, TEMPLOG_PAIR_RUN_MAX))
+  {
+    change = ((log->delta < 0) ? 4 : 0) | log->run;
+    if (log->held != TEMPLOG_HELD_NONE)
+    {
+      data[summary->bytes++] = (uint8_t)(TEMPLOG_TOKEN_PAIR | (log->held << 3) | change);
+      log->held = TEMPLOG_HELD_NONE;
+      return;
+    }
+    if (!closing)
+    {
+      log->held = (int8_t)change;
+      return;
+    }
+  }
+
+  if (log->held != TEMPLOG_HELD_NONE)
+  {
+    data[summary->bytes++] = (uint8_t)(((log->held & 4) << 3) | (log->held & 3));
+    log->held = TEMPLOG_HELD_NONE;
+  }
+  summary->bytes += TEMPLOG_tokenWrite(data + summary->bytes, log->delta, log->run);
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Open a new block after the open one, dropping the oldest block if the
+ *   ring is full.
+ ******************************************************************************/
+static void TEMPLOG_openBlock(TEMPLOG_Log_TypeDef *log)
+{
+  TEMPLOG_Summary_TypeDef *summary;
+
+  if (log->used == TEMPLOG_BLOCKS)
+  {
+    log->tail = (log->tail + 1) % TEMPLOG_BLOCKS;
+    log->used--;
+  }
+  log->used++;
+
+  summary        = &log->summary[TEMPLOG_head(log)];
+  summary->first = log->next;
+  summary->count = 0;
+  summary->bytes = 0;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Close open block, passing it to flush, and open a new one.
+ ******************************************************************************/
+static void TEMPLOG_closeBlock(TEMPLOG_Log_TypeDef *log)
+{
+  unsigned int head = TEMPLOG_head(log);
+
+  TEMPLOG_writeChange(log, true);
+  if (log->flush)
+  {
+    log->flush(&log->summary[head], log->data[head], log->user);
+  }
+  TEMPLOG_openBlock(log);
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Add readings of one token within window to statistics.
+ ******************************************************************************/
+static void TEMPLOG_addRun(TEMPLOG_Stats_TypeDef *stats,
+                           int32_t value,
+                           uint32_t first,
+                           uint32_t count,
+                           uint32_t from,
+                           uint32_t to)
+{
+  uint32_t end = first + count;
+
+  if (first < from)
+  {
+    first = from;
+  }
+  if (end > to)
+  {
+    end = to;
+  }
+  if (first >= end)
+  {
+    return;
+  }
+
+  if ((stats->count == 0) || (value < stats->min))
+  {
+    stats->min = (int16_t)value;
+  }
+  if ((stats->count == 0) || (value > stats->max))
+  {
+    stats->max = (int16_t)value;
+  }
+  stats->count += end - first;
+  stats->sum   += (int64_t)value * (end - first);
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Decode block, adding its readings within window to statistics.
+ ******************************************************************************/
+static void TEMPLOG_scan(const TEMPLOG_Log_TypeDef *log,
+                         unsigned int block,
+                         uint32_t from,
+                         uint32_t to,
+                         TEMPLOG_Stats_TypeDef *stats)
+{
+  const TEMPLOG_Summary_TypeDef *summary = &log->summary[block];
+  const uint8_t                 *data    = log->data[block];
+  unsigned int                  offset   = 0;
+  uint32_t                      number   = summary->first;
+  uint32_t                      token;
+  uint32_t                      run;
+  uint32_t                      ext;
+  int32_t                       value    = 0;
+
+  while ((offset < summary->bytes) && (number < to))
+  {
+    token = data[offset++];
+    if (token & TEMPLOG_TOKEN_GENERAL)
+    {
+      run = token & TEMPLOG_RUN_EXT;
+      if (run == TEMPLOG_RUN_EXT)
+      {
+        offset += TEMPLOG_varintRead(data + offset, &ext);
+        run    += ext;
+      }
+      offset += TEMPLOG_varintRead(data + offset, &ext);
+      value  += TEMPLOG_unzigzag(ext);
+    }
+    else if (token & TEMPLOG_TOKEN_PAIR)
+    {
+      value += (token & 0x20) ? -1 : 1;
+      run    = (token >> 3) & TEMPLOG_PAIR_RUN_MAX;
+      TEMPLOG_addRun(stats, value, number, run + 1, from, to);
+      number += run + 1;
+      value  += (token & 0x04) ? -1 : 1;
+      run     = token & TEMPLOG_PAIR_RUN_MAX;
+    }
+    else
+    {
+      value += (token & 0x20) ? -1 : 1;
+      run    = token & TEMPLOG_SMALL_RUN_MAX;
+    }
+    TEMPLOG_addRun(stats, value, number, run + 1, from, to);
+    number += run + 1;
+  }
+
+  /* Held and pending changes of open block */
+  if ((block == TEMPLOG_head(log)) && (summary->count > 0))
+  {
+    if (log->held != TEMPLOG_HELD_NONE)
+    {
+      value += (log->held & 4) ? -1 : 1;
+      run    = log->held & TEMPLOG_PAIR_RUN_MAX;
+      TEMPLOG_addRun(stats, value, number, run + 1, from, to);
+      number += run + 1;
+    }
+    TEMPLOG_addRun(stats, log->last, number, log->run + 1, from, to);
+  }
+}
+/***************************************************************************//**
+ * @brief
+ *   Initialize empty log.
+ *
+ * @param[out] log
+ *   Log to initialize.
+ *
+ * @param[in] flush
+ *   Function called with each closed block, NULL if none.
+ *
+ * @param[in] user
+ *   User pointer passed to flush.
+ ******************************************************************************/
+void TEMPLOG_init(TEMPLOG_Log_TypeDef *log,
+                  TEMPLOG_Flush_TypeDef flush,
+                  void *user)
+{
+  log->tail  = 0;
+  log->used  = 1;
+  log->next  = 0;
+  log->last  = 0;
+  log->delta = 0;
+  log->run   = 0;
+  log->held  = TEMPLOG_HELD_NONE;
+  log->flush = flush;
+  log->user  = user;
+
+  log->summary[0].first = 0;
+  log->summary[0].count = 0;
+  log->summary[0].bytes = 0;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Append reading to log.
+ *
+ * @param[in] log
+ *   Log to append to.
+ *
+ * @param[in] value
+ *   Reading, numbered log->next.
+ ******************************************************************************/
+void TEMPLOG_append(TEMPLOG_Log_TypeDef *log, int16_t value)
+{
+  TEMPLOG_Summary_TypeDef *summary = &log->summary[TEMPLOG_head(log)];
+  unsigned int            need;
+  bool                    held;
+
+  if (summary->count == TEMPLOG_BLOCK_MAX)
+  {
+    TEMPLOG_closeBlock(log);
+    summary = &log->summary[TEMPLOG_head(log)];
+  }
+
+  if (summary->count == 0)
+  {
+    /* First token of block is relative to 0 */
+    log->delta = value;
+  }
+  else if (value == log->last)
+  {
+    log->run++;
+  }
+  else
+  {
+    /* Room for pending change, a held change and the new change */
+    need = TEMPLOG_changeSize(log, &held);
+    need += (held ? 1 : 0) + TEMPLOG_tokenMax(value - log->last);
+    if (summary->bytes + need > TEMPLOG_BLOCK_BYTES)
+    {
+      TEMPLOG_closeBlock(log);
+      summary    = &log->summary[TEMPLOG_head(log)];
+      log->delta = value;
+    }
+    else
+    {
+      TEMPLOG_writeChange(log, false);
+      log->delta = value - log->last;
+    }
+  }
+
+  if (summary->count == 0)
+  {
+    log->run     = 0;
+    summary->min = value;
+    summary->max = value;
+    summary->sum = 0;
+  }
+  else if (value != log->last)
+  {
+    log->run = 0;
+  }
+  if (value < summary->min)
+  {
+    summary->min = value;
+  }
+  if (value > summary->max)
+  {
+    summary->max = value;
+  }
+  summary->sum += value;
+  summary->count++;
+
+  log->last = value;
+  log->next++;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Restore closed block, as passed to flush, e.g. read back from
+ *   non-volatile memory after reset. Blocks are restored oldest first,
+ *   before any reading is appended. Readings appended after are numbered
+ *   on from the last block restored, and the oldest blocks are dropped if
+ *   more blocks are restored than the ring holds.
+ *
+ * @param[in] log
+ *   Log to restore block to.
+ *
+ * @param[in] summary
+ *   Summary of block.
+ *
+ * @param[in] data
+ *   Encoded readings of block, summary->bytes bytes.
+ *
+ * @return
+ *   true if restored, false if readings have been appended, or the block
+ *   is not valid or does not follow the block restored before it.
+ ******************************************************************************/
+bool TEMPLOG_restore(TEMPLOG_Log_TypeDef *log,
+                     const TEMPLOG_Summary_TypeDef *summary,
+                     const uint8_t *data)
+{
+  unsigned int head = TEMPLOG_head(log);
+  unsigned int i;
+
+  if ((log->summary[head].count != 0) ||
+      ((log->used > 1) && (summary->first != log->next)) ||
+      (summary->count == 0) ||
+      (summary->bytes == 0) ||
+      (summary->bytes > TEMPLOG_BLOCK_BYTES) ||
+      (summary->min > summary->max) ||
+      ((uint32_t)(summary->first + summary->count) < summary->first))
+  {
+    return false;
+  }
+
+  log->summary[head] = *summary;
+  for (i = 0; i < summary->bytes; i++)
+  {
+    log->data[head][i] = data[i];
+  }
+  log->next = summary->first + summary->count;
+  TEMPLOG_openBlock(log);
+  return true;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Number of oldest reading held in log.
+ ******************************************************************************/
+uint32_t TEMPLOG_oldest(const TEMPLOG_Log_TypeDef *log)
+{
+  return log->summary[log->tail].first;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Statistics of readings in window.
+ *
+ * @param[in] log
+ *   Log to query.
+ *
+ * @param[in] from
+ *   Number of first reading of window.
+ *
+ * @param[in] to
+ *   Number of reading after window, at most log->next. Readings of the
+ *   window dropped from the log are not counted.
+ *
+ * @param[out] stats
+ *   Statistics of readings found.
+ *
+ * @return
+ *   true if any reading found.
+ ******************************************************************************/
+bool TEMPLOG_query(const TEMPLOG_Log_TypeDef *log,
+                   uint32_t from,
+                   uint32_t to,
+                   TEMPLOG_Stats_TypeDef *stats)
+{
+  const TEMPLOG_Summary_TypeDef *summary;
+  unsigned int                  lo = 0;
+  unsigned int                  hi = log->used - 1;
+  unsigned int                  mid;
+  unsigned int                  block;
+  uint32_t                      end;
+
+  stats->count = 0;
+  stats->min   = 0;
+  stats->max   = 0;
+  stats->sum   = 0;
+
+  if (from < TEMPLOG_oldest(log))
+  {
+    from = TEMPLOG_oldest(log);
+  }
+  if (to > log->next)
+  {
+    to = log->next;
+  }
+
+  /* Newest block starting at or before first reading of window */
+  while (lo < hi)
+  {
+    mid = (lo + hi + 1) / 2;
+    if (log->summary[(log->tail + mid) % TEMPLOG_BLOCKS].first <= from)
+    {
+      lo = mid;
+    }
+    else
+    {
+      hi = mid - 1;
+    }
+  }
+
+  for (; lo < log->used; lo++)
+  {
+    block   = (log->tail + lo) % TEMPLOG_BLOCKS;
+    summary = &log->summary[block];
+    end     = summary->first + summary->count;
+    if (summary->first >= to)
+    {
+      break;
+    }
+
+    if ((summary->first >= from) && (end <= to))
+    {
+      /* Wholly inside window, from summary */
+      if ((stats->count == 0) || (summary->min < stats->min))
+      {
+        stats->min = summary->min;
+      }
+      if ((stats->count == 0) || (summary->max > stats->max))
+      {
+        stats->max = summary->max;
+      }
+      stats->count += summary->count;
+      stats->sum   += summary->sum;
+    }
+    else if (summary->count > 0)
+    {
+      TEMPLOG_scan(log, block, from, to, stats);
+    }
+  }
+
+  return stats->count > 0;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Average of readings, rounded to nearest.
+ *
+ * @param[in] stats
+ *   Statistics from TEMPLOG_query().
+ *
+ * @return
+ *   Average, 0 if no readings.
+ ******************************************************************************/
+int16_t TEMPLOG_average(const TEMPLOG_Stats_TypeDef *stats)
+{
+  int64_t half = stats->count / 2;
+
+  if (stats->count == 0)
+  {
+    return 0;
+  }
+  if (stats->sum < 0)
+  {
+    half = -half;
+  }
+  return (int16_t)((stats->sum + half) / (int64_t)stats->count);
+}
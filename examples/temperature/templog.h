@@ -0,0 +1,186 @@
+/**************************************************************************//**
+ * @file
+ * @brief Compressed temperature history with block summary index
+ * @author Energy Micro AS
+ * @version 3.20.0
+ ******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 Energy Micro AS, http://www.energymicro.com</b>
+ *******************************************************************************
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ * 4. The source and compiled code may only be used on Energy Micro "EFM32"
+ *    microcontrollers and "EFR4" radios.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: Energy Micro AS has no
+ * obligation to support this Software. Energy Micro AS is providing the
+ * Software "AS IS", with no express or implied warranties of any kind,
+ * including, but not limited to, any implied warranties of merchantability
+ * or fitness for any particular purpose or warranties against infringement
+ * of any proprietary rights of a third party.
+ *
+ * Energy Micro AS will not be liable for any consequential, incidental, or
+ * special damages, or any other relief, or for any claim by any third party,
+ * arising from your use of this Software.
+ *
+ *****************************************************************************/
+#ifndef __TEMPLOG_H
+#define __TEMPLOG_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+   Compressed history of temperature readings, kept free of hardware
+   references so that it can be verified off target.
+
+   Readings are int16_t values in units chosen by the caller, numbered from
+   0 in the order appended. They are encoded into a RAM ring of
+   TEMPLOG_BLOCKS blocks of TEMPLOG_BLOCK_BYTES bytes. When the ring is
+   full, the oldest block is dropped to open a new one.
+
+   A block is a sequence of tokens, each giving a reading as a delta from
+   the previous one, followed by a run of readings equal to it:
+
+     00srrrrr                  delta +1 (s = 0) or -1 (s = 1), run r
+     01sRRtQQ                  two such changes, delta s run RR then
+                               delta t run QQ, runs 0 to 3
+     1rrrrrrr [n] d            any delta, run r (0 to 126), or 127 + n
+                               when r is 127; n and zigzag(delta) d are
+                               varints (7 bits per byte, least significant
+                               first, top bit set if more bytes follow)
+
+   The first token of a block is relative to 0, so each block decodes on
+   its own. A reading unchanged since the previous one only extends the
+   run of the pending change, which is written when the value changes or
+   the block is closed. A slowly changing temperature thus costs a byte per
+   change, and a reading flickering between two values by noise about half
+   a byte per change, rather than a byte or more per reading.
+
+   Each block has a summary holding the number of its first reading, count,
+   min, max and sum, updated as readings are appended. Queries over a
+   window of readings find the first block by binary search of the
+   summaries, take blocks wholly inside the window from their summaries,
+   and decode only the blocks at the window ends.
+
+   When a block is closed, its summary and data are passed to the flush
+   function given to TEMPLOG_init(), for writing to non-volatile memory.
+   After reset, blocks read back are given to TEMPLOG_restore(), oldest
+   first, before readings are appended.
+*/
+
+/** Bytes per block. */
+#define TEMPLOG_BLOCK_BYTES   128
+
+/** Blocks in RAM ring. */
+#ifndef TEMPLOG_BLOCKS
+#define TEMPLOG_BLOCKS        64
+#endif
+
+/** Most readings per block, count of summary. */
+#define TEMPLOG_BLOCK_MAX     0xffff
+
+/** Summary of block. */
+typedef struct
+{
+  /** Number of first reading. */
+  uint32_t first;
+  /** Number of readings. */
+  uint16_t count;
+  /** Bytes of block data used. */
+  uint16_t bytes;
+  /** Smallest reading. */
+  int16_t  min;
+  /** Largest reading. */
+  int16_t  max;
+  /** Sum of readings. */
+  int32_t  sum;
+} TEMPLOG_Summary_TypeDef;
+
+/** Statistics of readings in window. */
+typedef struct
+{
+  /** Number of readings found in window. */
+  uint32_t count;
+  /** Smallest reading. */
+  int16_t  min;
+  /** Largest reading. */
+  int16_t  max;
+  /** Sum of readings. */
+  int64_t  sum;
+} TEMPLOG_Stats_TypeDef;
+
+/**
+ * Flush of closed block.
+ *
+ * @param[in] summary
+ *   Summary of block.
+ *
+ * @param[in] data
+ *   Encoded readings of block, summary->bytes bytes.
+ *
+ * @param[in] user
+ *   User pointer given to TEMPLOG_init().
+ */
+typedef void (*TEMPLOG_Flush_TypeDef)(const TEMPLOG_Summary_TypeDef *summary,
+                                      const uint8_t *data,
+                                      void *user);
+
+/** Temperature log. */
+typedef struct
+{
+  /** Encoded readings of blocks. */
+  uint8_t                 data[TEMPLOG_BLOCKS][TEMPLOG_BLOCK_BYTES];
+  /** Summary index, one entry per block. */
+  TEMPLOG_Summary_TypeDef summary[TEMPLOG_BLOCKS];
+  /** Oldest block. */
+  unsigned int            tail;
+  /** Blocks used, including the open one. */
+  unsigned int            used;
+  /** Number of next reading. */
+  uint32_t                next;
+  /** Latest reading. */
+  int16_t                 last;
+  /** Delta of pending change, not yet written. */
+  int32_t                 delta;
+  /** Run of pending change. */
+  uint16_t                run;
+  /** Change held for pairing, -1 if none, else sign << 2 | run. */
+  int8_t                  held;
+  /** Flush of closed blocks, may be NULL. */
+  TEMPLOG_Flush_TypeDef   flush;
+  /** User pointer passed to flush. */
+  void                    *user;
+} TEMPLOG_Log_TypeDef;
+
+void TEMPLOG_init(TEMPLOG_Log_TypeDef *log,
+                  TEMPLOG_Flush_TypeDef flush,
+                  void *user);
+void TEMPLOG_append(TEMPLOG_Log_TypeDef *log, int16_t value);
+bool TEMPLOG_restore(TEMPLOG_Log_TypeDef *log,
+                     const TEMPLOG_Summary_TypeDef *summary,
+                     const uint8_t *data);
+uint32_t TEMPLOG_oldest(const TEMPLOG_Log_TypeDef *log);
+bool TEMPLOG_query(const TEMPLOG_Log_TypeDef *log,
+                   uint32_t from,
+                   uint32_t to,
+                   TEMPLOG_Stats_TypeDef *stats);
+int16_t TEMPLOG_average(const TEMPLOG_Stats_TypeDef *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
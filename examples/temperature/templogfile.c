@@ -0,0 +1,176 @@
+/**************************************************************************//**
+ * @file
+ * @brief Temperature log blocks kept in a file on the microSD card
+ * @author Energy Micro AS
+ * @version 3.20.0
+ ******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 Energy Micro AS, http://www.energymicro.com</b>
+ *******************************************************************************
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ * 4. The source and compiled code may only be used on Energy Micro "EFM32"
+ *    microcontrollers and "EFR4" radios.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: Energy Micro AS has no
+ * obligation to support this Software. Energy Micro AS is providing the
+ * Software "AS IS", with no express or implied warranties of any kind,
+ * including, but not limited to, any implied warranties of merchantability
+ * or fitness for any particular purpose or warranties against infringement
+ * of any proprietary rights of a third party.
+ *
+ * Energy Micro AS will not be liable for any consequential, incidental, or
+ * special damages, or any other relief, or for any claim by any third party,
+ * arising from your use of this Software.
+ *
+ *****************************************************************************/
+#include "templogfile.h"
+
+/***************************************************************************//**
+ * @brief
+ *   Close log file after failed operation, keeping the result.
+ ******************************************************************************/
+static FRESULT TEMPLOGFILE_fail(TEMPLOGFILE_File_TypeDef *logFile, FRESULT res)
+{
+  f_close(&logFile->file);
+  logFile->status = res;
+  return res;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Open log file, creating it if not present, and restore the newest blocks
+ *   in it to log. The log must be initialized, with TEMPLOGFILE_flush() as
+ *   flush function and logFile as user pointer, and no readings appended.
+ *
+ * @param[out] logFile
+ *   Log file.
+ *
+ * @param[in] name
+ *   Name of file on card.
+ *
+ * @param[in] log
+ *   Log to restore blocks to.
+ *
+ * @return
+ *   FR_OK if file is open for appending blocks, else FatFS error code.
+ ******************************************************************************/
+FRESULT TEMPLOGFILE_open(TEMPLOGFILE_File_TypeDef *logFile,
+                         const char *name,
+                         TEMPLOG_Log_TypeDef *log)
+{
+  TEMPLOG_Summary_TypeDef summary;
+  uint8_t                 data[TEMPLOG_BLOCK_BYTES];
+  uint32_t                records;
+  uint32_t                record;
+  UINT                    bytes;
+  FRESULT                 res;
+
+  logFile->restored = 0;
+  res = f_open(&logFile->file, name, FA_READ | FA_WRITE | FA_OPEN_ALWAYS);
+  if (res != FR_OK)
+  {
+    logFile->status = res;
+    return res;
+  }
+
+  /* Blocks beyond those the ring holds, besides the open one, are skipped */
+  records = f_size(&logFile->file) / TEMPLOGFILE_RECORD_BYTES;
+  record  = (records > (TEMPLOG_BLOCKS - 1)) ? records - (TEMPLOG_BLOCKS - 1) : 0;
+
+  res = f_lseek(&logFile->file, record * TEMPLOGFILE_RECORD_BYTES);
+  for (; (res == FR_OK) && (record < records); record++)
+  {
+    res = f_read(&logFile->file, &summary, sizeof(summary), &bytes);
+    if ((res != FR_OK) || (bytes != sizeof(summary)))
+    {
+      break;
+    }
+    res = f_read(&logFile->file, data, TEMPLOG_BLOCK_BYTES, &bytes);
+    if ((res != FR_OK) || (bytes != TEMPLOG_BLOCK_BYTES) ||
+        !TEMPLOG_restore(log, &summary, data))
+    {
+      break;
+    }
+    logFile->restored++;
+  }
+
+  /* Next block is appended after the last one restored */
+  if (res == FR_OK)
+  {
+    res = f_lseek(&logFile->file, record * TEMPLOGFILE_RECORD_BYTES);
+  }
+  if (res == FR_OK)
+  {
+    res = f_truncate(&logFile->file);
+  }
+  if (res == FR_OK)
+  {
+    res = f_sync(&logFile->file);
+  }
+  if (res != FR_OK)
+  {
+    return TEMPLOGFILE_fail(logFile, res);
+  }
+
+  logFile->status = FR_OK;
+  return FR_OK;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Flush of closed block, given to TEMPLOG_init(). Appends block to log
+ *   file and syncs it, closing the file if this fails.
+ *
+ * @param[in] summary
+ *   Summary of block.
+ *
+ * @param[in] data
+ *   Encoded readings of block.
+ *
+ * @param[in] user
+ *   Log file, opened by TEMPLOGFILE_open().
+ ******************************************************************************/
+void TEMPLOGFILE_flush(const TEMPLOG_Summary_TypeDef *summary,
+                       const uint8_t *data,
+                       void *user)
+{
+  TEMPLOGFILE_File_TypeDef *logFile = (TEMPLOGFILE_File_TypeDef *)user;
+  UINT                     bytes;
+  FRESULT                  res;
+
+  if (logFile->status != FR_OK)
+  {
+    return;
+  }
+
+  res = f_write(&logFile->file, summary, sizeof(*summary), &bytes);
+  if ((res == FR_OK) && (bytes != sizeof(*summary)))
+  {
+    res = FR_DISK_ERR;
+  }
+  if (res == FR_OK)
+  {
+    res = f_write(&logFile->file, data, TEMPLOG_BLOCK_BYTES, &bytes);
+  }
+  if ((res == FR_OK) && (bytes != TEMPLOG_BLOCK_BYTES))
+  {
+    res = FR_DISK_ERR;
+  }
+  if (res == FR_OK)
+  {
+    res = f_sync(&logFile->file);
+  }
+  if (res != FR_OK)
+  {
+    TEMPLOGFILE_fail(logFile, res);
+  }
+}
@@ -0,0 +1,90 @@
+/**************************************************************************//**
+ * @file
+ * @brief Temperature log blocks kept in a file on the microSD card
+ * @author Energy Micro AS
+ * @version 3.20.0
+ ******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 Energy Micro AS, http://www.energymicro.com</b>
+ *******************************************************************************
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ * 4. The source and compiled code may only be used on Energy Micro "EFM32"
+ *    microcontrollers and "EFR4" radios.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: Energy Micro AS has no
+ * obligation to support this Software. Energy Micro AS is providing the
+ * Software "AS IS", with no express or implied warranties of any kind,
+ * including, but not limited to, any implied warranties of merchantability
+ * or fitness for any particular purpose or warranties against infringement
+ * of any proprietary rights of a third party.
+ *
+ * Energy Micro AS will not be liable for any consequential, incidental, or
+ * special damages, or any other relief, or for any claim by any third party,
+ * arising from your use of this Software.
+ *
+ *****************************************************************************/
+#ifndef __TEMPLOGFILE_H
+#define __TEMPLOGFILE_H
+
+#include <stdint.h>
+#include "ff.h"
+#include "templog.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+   Closed blocks of a temperature log (templog.c) kept in a file on the
+   DVK microSD card through FatFS, so that the history survives reset.
+
+   Each closed block is appended as a record of its summary, as held in
+   memory, followed by the TEMPLOG_BLOCK_BYTES bytes of its data, and the
+   file is synced. TEMPLOGFILE_open() restores the newest records that fit
+   in the RAM ring of the log. A record cut short by reset while being
+   written, or one not following the record before it, ends the file, which
+   is truncated there, so that the next block is appended in its place.
+
+   Readings are numbered on across resets; the time the board was off is
+   not in the log.
+
+   A failed write closes the file, and the log is kept in RAM only from
+   then on. The result is kept in status, FR_OK while the file is written.
+*/
+
+/** Bytes of record of block in file */
+#define TEMPLOGFILE_RECORD_BYTES \
+  (sizeof(TEMPLOG_Summary_TypeDef) + TEMPLOG_BLOCK_BYTES)
+
+/** Log file. */
+typedef struct
+{
+  /** File, open while status is FR_OK. */
+  FIL      file;
+  /** Result of last file operation, FR_OK if file is open. */
+  FRESULT  status;
+  /** Blocks restored from file by TEMPLOGFILE_open(). */
+  uint32_t restored;
+} TEMPLOGFILE_File_TypeDef;
+
+FRESULT TEMPLOGFILE_open(TEMPLOGFILE_File_TypeDef *logFile,
+                         const char *name,
+                         TEMPLOG_Log_TypeDef *log);
+void TEMPLOGFILE_flush(const TEMPLOG_Summary_TypeDef *summary,
+                       const uint8_t *data,
+                       void *user);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
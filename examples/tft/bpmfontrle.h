@@ -0,0 +1,187 @@
+/* bpmfont: 120x17 image, 64 colors, made by host/assetconv from bpmfont.h */
+
+#ifndef __BPMFONTRLE_H
+#define __BPMFONTRLE_H
+
+#include "tftasset.h"
+
+static const uint8_t bpmfontPalette[] = {
+    0,  40,  32,   0,  30,  33,   0,  35,  33,   0,  49,  31,
+    0,  46,  31,   0,  32,  33,   0,  33,  33,   0,  38,  32,
+    0,  39,  32,   0,  29,  34,   0,  37,  32,   0,  54,  30,
+    0,  41,  32,   0,  36,  33,   0,  30,  34,   0,  43,  32,
+    0, 107,  22,   0, 197,   8,   0, 238,   3,   0, 234,   3,
+    0, 180,  11,   0,  70,  27,   0,  65,  28,   0, 189,  10,
+    0,  45,  31,   0, 230,   4,   0,  94,  24,   0, 120,  20,
+    0, 207,   7,   0, 232,   3,   0, 202,   8,   0,  74,  27,
+    0, 125,  19,   0, 170,  13,   0, 132,  18,   0, 213,   6,
+    0, 224,   5,   0, 154,  15,   0, 115,  21,   0, 242,   2,
+    0, 140,  17,   0, 218,   6,   0, 160,  14,   0,  29,  33,
+    0, 255,   0,   0,  26,  34,   0, 248,   1,   0, 252,   0,
+    0, 147,  16,   0, 101,  23,   0,  79,  26,   0, 184,  11,
+    0, 164,  14,   0, 254,   0,   0,  90,  25,   0,  84,  25,
+    0,  24,  34,   0,  60,  29,   0,  22,  35,   0,  69,  28,
+    0,  20,  35,   0,  15,  36,   0, 175,  12,   0,  18,  35
+};
+
+static const uint8_t bpmfontData[] = {
+  129,   0,   1,   2,   3,   4,   5,   6, 132,   0, 128,   2,
+    7, 131,   0,   8,   1,   2, 128,   3,   6,   5, 130,   0,
+    8,   9,  10, 128,   3,   6,   5, 133,   0,  10,   4, 128,
+   11,  12, 129,   0,  13, 133,   6, 130,   0,   7,   9,   0,
+   11,  12,   9,  13, 129,   0, 134,   6,  10, 128,   0,   8,
+   14,   2, 128,   3,  13,   9,   8, 129,   0,  10,   9,   0,
+   11,  15,   1,   2,  12, 138,   0, 128,   0,   1,  16,  17,
+   18,  19,  20,  21,   5, 130,   0,   9,  22,  17,  23,  24,
+    7, 128,   0,   8,   5,  16,  17,  19,  25,  23,  26,  14,
+  128,   0,   7,   2,  27,  28,  18,  29,  23,  26,   1, 131,
+    0,  10,  24,  30,  29,  25,  31,   6,   0,   5,  32, 132,
+   23,  33,   4,   7,   0,  10,  13,  34,  35,  18,  36,  37,
+    3,   6, 128,   8,  37, 133,  23,  16,   5,   8,   6,  38,
+   17,  18,  39,  30,  32,  10,   7,   0,  10,  24,  40,  41,
+   18,  36,  42,  11,   6, 138,   0,   0,  43,  38, 128,  44,
+   35,  25,  44,  29,  22,   6, 128,   0,  45,  22,  41,  44,
+   18,   4,  10, 128,   0,   9,  34, 128,  44,  46, 128,  44,
+   47,  16,  14,   0,   1,  48, 128,  44,  36,  46,  44,  46,
+   49,   5, 130,   0,  45,  34, 129,  44,  50,   5,   0,  45,
+   51, 132,  44,  19,   0,   7,   8,   6,  52,  44,  53,  36,
+  128,  44,  30,  15,   2,   4,  18, 133,  44,  40,  45,  14,
+   40, 128,  44,  30,  17, 128,  44,  48,   5,   7,   8,  23,
+  128,  44,  36,  46,  44,  28,   3,  13, 137,   0,  10,  11,
+   19,  44,  37,   9,   4,  28,  44,  20,  14,   8,  10,  16,
+   19, 128,  44,  25,   4,  10,   0,   6,  22,  46,  44,  37,
+   11,  50,  41,  44,  36,  24,   9,  54,  44,  47,  16,   5,
+   22,  41,  44,  28,  10,   8, 128,   0,   2,  11,  19,  36,
+   39,  53,  50,   5,   0,  14,  23,  44,  48,  38, 129,  27,
+   49, 128,   8,   9,  16,  44,  25,  31,   5,  55,  18,  44,
+   34,  45,  24,  38, 129,  27,  38,  27,  18,  39,  21,   9,
+   22,  46,  44,  32, 128,  45,  38,  53,  46,  22,  56,  27,
+   44,  39,  49,   5,  22,  41,  44,  40,   9, 137,   0,   9,
+   38,  44,  18,  11,   6,  56,  16,  44,  39,  57,   5,   3,
+   46,  47,  23,  44,  25,   4,  10,   0,  45,  48,  44,  35,
+    6,   5,  58,  16, 128,  44,  55,  56,  49,  28,  33,  45,
+    7,  58,  34,  44,  39,  57,   2, 128,   0,  45,  37,  44,
+   38,  39,  44,  50,   5,   8,   6,  17,  44,  59,  60,  56,
+   45,   9,   5,   0,   8,   6,  30,  44,  32,  58,   8,  58,
+   48,  35,  32,   6,   8,  14, 129,   9,  61,  32,  44,  32,
+   45,   9,  16,  44,  39,   4,   2,  10,   7,  25,  44,  26,
+   58,  17,  44,  62,  58,   7,  58,  38,  44,  35, 138,   0,
+   45,  42,  44,  28,   2,   8,   6,  21,  46,  44,  49,  45,
+   11,  30,  54,  38,  44,  25,   4,  10,   0,   6,  27,  17,
+   34,   9,   0,   5,  50, 128,  44,  26,   5,   2,   7,  12,
+    8,   0,  56,  27,  44,  18,  11,  13,   0,   6,  22,  46,
+   51,  57,  46,  44,  50,   5,   7,   8,  28,  44,  11,   5,
+   11,   4,   1,  10,   0,   2,  22,  46,  47,  22,  58,  14,
+    9,  10,  12,   5, 131,   0,   6,  59,  46,  36,  12,  10,
+   14,  16,  44,  46,  55,  58,  45,  22,  39,  44,  50,   2,
+   41,  44,  34,  45,   0,   5,  55,  44,  46,  22, 137,   0,
+    5,  51,  44,  51,   5,   8,  13,  11,  39,  44,  32,  45,
+   24,   3,  63,  32,  44,  25,   4,  10,   0,  12,   5,  13,
+  129,   0,  45,  27,  44,  46,  59,   6,   0,   8,   7,   5,
+   45,  10,  17,  44,  51,   5,   8,   0,   9,  33,  44,  31,
+   57,  46,  44,  50,   5,   7,  15,  41,  46,  16,  17,  18,
+   36,  37,   4,   2,   5,  26,  44,  36,  24,  38,  62,  52,
+   26,  43,   7, 130,   0,   8,  14,  62,  44,  27,  45,   0,
+   13,  11,  18,  44,  36,  55,  57,  30,  44,  51,   6,   8,
+   41,  44,  48,  56,  12,   9,  26, 128,  44,  55, 137,   0,
+   10,  30,  44,  33,   9,   0,  10,   3,  25,  44,  40,   9,
+    8,  10,   9,  32,  44,  25,   4,  10, 129,   0, 128,   8,
+    0,  10,  13,  28,  44,  17,   6,   8,   0, 128,   8,  40,
+   62,  35,  44,  23,  11,   2,   0,   5,  50,  44,  20,  58,
+   59,  46,  44,  50,   5,  10,   3,  36,  46, 128,  44,  46,
+  128,  44,  23,   7,  45,  38,  44,  30,  33, 130,  44,  48,
+    5,   8, 129,   0,   5,  31,  47,  18,  11,  13, 128,   0,
+   14,  49,  19,  44,  53,  39,  44,  33,   8,  10,   1,  51,
+   44,  35,   8,  56,  58,  33, 128,  44,  26, 137,   0,  10,
+   28,  44,  33,   9,   0,  10,   3,  25,  44,  40,   9, 128,
+    0,   9,  32,  44,  25,   4,  10, 131,   0,   8,  56,  40,
+   44,  47,  55,   5, 128,   0, 128,   7,  35, 129,  44,  33,
+   11,   6,   0,  14,  23,  53,  31,  45,  59,  46,  44,  50,
+    5,  13,  11,  39,  44,  52,  57,  11,  37, 128,  44,  49,
+   63,  27,  44,  39,  18,  27,  50,  42, 128,  44,  26,   1,
+  129,   0,  45,  42,  44,  62,   9, 128,   0,  12,   6,  10,
+   51, 130,  44,  30,  21, 128,   5,  49, 128,  44,  17,  27,
+   62,  53,  47,  44,  26, 137,   0,  10,  30,  44,  33,   9,
+    0,  10,   3,  25,  44,  34,   9, 128,   0,   9,  32,  44,
+   25,   4,  10, 131,   0,  56,  16,  53,  44,  32,   9, 131,
+    0,  22,  31,  49,  35,  44,  35,   4,   9,  26,  44,  37,
+   61,  60,  57,  46,  44,  59,  63,   8,  12,  49,  34,  12,
+  128,   5,  10,  41,  44,  42,  61,  27, 128,  44,  32,  63,
+   43,   5,  30,  44,  62,   9,   8,   0,  10,   4,  25,  44,
+   16,   9, 128,   0,  10,   3,  30,  44,  17,  16,  51, 128,
+   44,  25,  57,   6,   5,  48, 130,  44,  37,  39,  44,  50,
+  137,   0,   6,  23,  44,  51,   5,   8,  13,  11,  39,  44,
+   38,   9, 128,   0,   9,  32,  44,  25,   4,  10, 129,   0,
+    8,  45,  16,  46,  44,  34,   9,   8, 128,   0,   2,   1,
+    7,   2,   6,  58,  50,  46,  44,  16,  60,  23,  44,  62,
+  128,  48,  33,  47,  44,  51,  37,  24,  10,  56,  58,   8,
+    0,   8,   1,  20,  44,  20,  60,  49,  44,  46,  22,   6,
+    0,  45,  37,  44,  28, 128,   7,   0,   5,  54,  44,  46,
+   22,   2, 128,   0,   9,  37,  44,  17,   7,  56,   9,  38,
+   46,  44,  48,   9,   7,   5,  26, 128,  37, 128,  50,  44,
+   46,  22, 137,   0,  45,  42,  44,  28,   2,   8,   6,  21,
+   47,  44,  26,   5, 128,   0,   9,  32,  44,  25,   4,  10,
+  128,   0,   7,  45,  27,  44,  47,  27,  43,   7, 129,   0,
+   22,  49,   3,  10,   0,  13,   3,  25,  44,  40,  58,  30,
+  134,  44,  46,   3,   0,  59,  21,  13,   0,   8,   1,  20,
+   44,  62,  58,  50,  44,  46,  57,   2,   0,  45,  48,  44,
+   28, 128,   7,   0,   9,  40,  44,  41,  12,   7,   0,   8,
+    7,  35,  44,  16,  45,  12,   7,  45,  23,  44,  51,   5,
+    6,   9,  45, 128,   9,  63,  27,  44,  36,  24, 129,   0,
+  128,   7, 128,   6,   7, 129,   0,   9,  38,  44,  39,  11,
+    5,  56,  38,  44,  18,  11,  13,   0,   2,  60,  27,  44,
+   25,   0,   5,   7,   8,   5,  34,  44,  41,  50,  61,  45,
+    9,  45,   6,  15,  35,  44,  27,  60,  10,   9,  22,  39,
+   44,  32,  45,  31, 129,  54,  55,  27,  44,  53,  27,  50,
+    5,  34,  46,  41,   2,   1,   9,  12,  36,  44,  40,  56,
+   24,  36,  44,  49,  58,  10,  56,  51,  44,  20,  14, 128,
+    0,   9,  20,  44,  23,   5, 128,   0,   8,   7,  35,  44,
+   27,  60,   8,  10,  56,  23,  44,  33,  56,  50,  42,  34,
+   56,  10,  56,  20,  44,  33,   9, 129,   0,   8,   3, 128,
+   31,   4,   8, 128,   0,  10,  11,  29,  44,  52,   2,  11,
+   35,  44,  33,   9, 128,   0,  22,  57,  40,  44,  19,  31,
+   22,   4,  14,  40,  44,  46,  37,  27, 130,  34,  59,  56,
+   42,  44,  19,  26,  15,  57,  51,  44,  46,  59, 128,   6,
+  129,   5,  56,  31,  44,  53,  21,  56,   5,  54, 128,  44,
+   33,  21,  59,  33,  44,  46,  21,   6,   9,  40,  44,  35,
+   21,  12,  16,  46,  44,  16,   9,   0,   8,  10,  30,  44,
+   52,   9, 129,   0,   9,  42,  44,  36,  50,   2,   7,  27,
+   46,  44,  49,  63,  27,  44,  39,  54,   8,  16,  46,  44,
+   55,   5, 129,   0,   5,  54, 128,  46,  55,   5, 128,   0,
+    0,  43,  16,  53,  44,  25,  39,  44,  36,  57,   6,   7,
+    0,  36, 132,  44,  26,  60,  30, 134,  44,  16,  56,  11,
+   28, 128,  44,  25,  46,  44,  53,  32,   1, 131,   0,   5,
+   55, 128,  44,  50,   5,   0,   5,  48, 131,  44,  53,  32,
+   43,   0,  10,  12,  23, 128,  44,  29, 128,  44,  33,   2,
+    8,   0,  10,  24,  25,  44,  37,  45, 129,   0,   2,  57,
+   41, 128,  44,  36,  25, 128,  44,  37,   6,   7,   0,  17,
+  128,  44,  29, 128,  44,  37,   5, 130,   0,   5,  54, 128,
+   44,  54,   1, 128,   0, 128,   0,   1,  26,  23,  29,  36,
+   52,  57,   5,  12,   8,   0,  37,  20, 130,  62,  20,  31,
+    9,  34, 134,  62,  21,   2,   6,   4,  34,  30,  25,  36,
+   20,  54,   1,   8, 131,   0,   2,  22, 128,  62,  22,   2,
+    0,   7,   5,  16,  23,  25,  36,  20,  26,   1,   8, 128,
+    0,   2,  15,  40,  28,  25,  30,  32, 128,  10, 128,   0,
+    7,  24,  37,  62,  16,   5, 129,   0,  12,   6,  11,  48,
+   28,  19,  25,  51,  16,   6,   7,  12,   2,   3,  37,  35,
+   25,  17,  38,   6,   7, 130,   0,   2,  21, 128,  62,  59,
+    6, 128,   0, 129,   0,   5,   6,  15,  12,   1,   6,  12,
+  129,   0,   5, 132,   1,  10,  12,   6, 134,   1,   7, 128,
+    0,  10,   9,  13,  15,  12, 128,   5, 134,   0,   7, 128,
+    1,   7, 129,   0,   8,  14,   6,  15,  12, 128,   5, 131,
+    0,  10,   9,   7,  15,  10,   9,   7, 131,   0,   5,   1,
+    2,  12, 131,   0,  13,   9,  10,  15,  12,   5,  14,   8,
+  129,   0,  13,   9,   8,  15,  13,   9,   8, 132,   0,   7,
+  128,   1,   7, 129,   0
+};
+
+static const TFTASSET_TypeDef bpmfontAsset = {
+  .width   = 120,
+  .height  = 17,
+  .colors  = 64,
+  .palette = bpmfontPalette,
+  .data    = bpmfontData,
+  .size    = 1769,
+};
+
+#endif
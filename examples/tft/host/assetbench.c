@@ -0,0 +1,178 @@
+/**************************************************************************//**
+ * @file
+ * @brief Host (Linux) benchmark for compressed TFT image assets
+ * @author Energy Micro AS
+ * @version 3.20.0
+ ******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 Energy Micro AS, http://www.energymicro.com</b>
+ *******************************************************************************
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ * 4. The source and compiled code may only be used on Energy Micro "EFM32"
+ *    microcontrollers and "EFR4" radios.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: Energy Micro AS has no
+ * obligation to support this Software. Energy Micro AS is providing the
+ * Software "AS IS", with no express or implied warranties of any kind,
+ * including, but not limited to, any implied warranties of merchantability
+ * or fitness for any particular purpose or warranties against infringement
+ * of any proprietary rights of a third party.
+ *
+ * Energy Micro AS will not be liable for any consequential, incidental, or
+ * special damages, or any other relief, or for any claim by any third party,
+ * arising from your use of this Software.
+ *
+ *****************************************************************************/
+/*
+   Host (Linux) benchmark for compressed TFT image assets.
+
+   Draws bpmfont.h both from the raw array, one DMD_writeData() call per
+   row straight from the array, and from bpmfontrle.h through the streaming
+   decoder (tftasset.c), to the host display emulation (host/dmdemu.c at
+   the top of the kit). Checks that both give the same
+   image, and reports flash size, bytes streamed from the asset and palette
+   colors looked up per draw, and time per draw.
+
+   Usage: assetbench [draws]
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include "glib/glib.h"
+#include "dmd/ssd2119/dmd_ssd2119.h"
+#include "dmdemu.h"
+#include "tftasset.h"
+#include "bpmfont.h"
+#include "bpmfontrle.h"
+
+#define BPP     3
+
+/** Image drawn from raw array, for comparison */
+static uint16_t reference[DMDEMU_HEIGHT][DMDEMU_WIDTH];
+
+/***************************************************************************//**
+ * @brief Clear display to a color not in the image.
+ ******************************************************************************/
+static void clearDisplay(void)
+{
+  DMDEMU_reset();
+  DMD_init(0, 0);
+  memset(dmdemuFramebuffer, 0x5a, sizeof(dmdemuFramebuffer));
+}
+
+/***************************************************************************//**
+ * @brief Draw raw image, one write per row straight from the array.
+ ******************************************************************************/
+static EMSTATUS drawRaw(uint16_t x, uint16_t y)
+{
+  EMSTATUS status;
+  uint32_t row;
+
+  status = DMD_setClippingArea(x, y, bpmfontAsset.width, bpmfontAsset.height);
+  for (row = 0; (row < bpmfontAsset.height) && (status == DMD_OK); row++)
+  {
+    status = DMD_writeData(0, row, &bpmfont[row * bpmfontAsset.width * BPP],
+                           bpmfontAsset.width);
+  }
+  return status;
+}
+
+/***************************************************************************//**
+ * @brief Count tokens in coded rows, each reads one palette color.
+ ******************************************************************************/
+static uint32_t tokens(void)
+{
+  uint32_t i, n = 0;
+
+  for (i = 0; i < bpmfontAsset.size; i++)
+  {
+    if (bpmfontAsset.data[i] & TFTASSET_RUN)
+    {
+      i++;
+    }
+    n++;
+  }
+  return n;
+}
+
+/***************************************************************************//**
+ * @brief Main function
+ ******************************************************************************/
+int main(int argc, char *argv[])
+{
+  uint32_t rawSize = sizeof(bpmfont);
+  uint32_t rleSize = (bpmfontAsset.colors * BPP) + bpmfontAsset.size;
+  int      draws   = (argc > 1) ? atoi(argv[1]) : 100000;
+  double   rawTime, rleTime;
+  clock_t  start;
+  int      errors  = 0;
+  int      i;
+
+  if (draws < 1)
+  {
+    draws = 1;
+  }
+
+  /* Same image both ways, at two positions */
+  clearDisplay();
+  if ((drawRaw(0, 0) != DMD_OK) || (drawRaw(196, 219) != DMD_OK))
+  {
+    printf("FAIL: raw draw\n");
+    errors++;
+  }
+  memcpy(reference, dmdemuFramebuffer, sizeof(reference));
+  clearDisplay();
+  if ((TFTASSET_draw(&bpmfontAsset, 0, 0) != DMD_OK) ||
+      (TFTASSET_draw(&bpmfontAsset, 196, 219) != DMD_OK))
+  {
+    printf("FAIL: compressed draw\n");
+    errors++;
+  }
+  if (memcmp(reference, dmdemuFramebuffer, sizeof(reference)) != 0)
+  {
+    printf("FAIL: decoded image differs from raw image\n");
+    errors++;
+  }
+
+  start = clock();
+  for (i = 0; i < draws; i++)
+  {
+    drawRaw(0, 0);
+  }
+  rawTime = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+  start = clock();
+  for (i = 0; i < draws; i++)
+  {
+    TFTASSET_draw(&bpmfontAsset, 0, 0);
+  }
+  rleTime = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+  printf("bpmfont %ux%u, %u colors, %d draws\n\n",
+         bpmfontAsset.width, bpmfontAsset.height, bpmfontAsset.colors, draws);
+  printf("%-12s %8s %12s %12s %10s\n",
+         "", "flash", "stream read", "color reads", "us/draw");
+  printf("%-12s %8u %12u %12u %10.2f\n", "raw", rawSize, rawSize, 0,
+         rawTime * 1e6 / draws);
+  /* Decoder reads each coded byte once and one palette color per token */
+  printf("%-12s %8u %12u %12u %10.2f\n", "compressed", rleSize,
+         bpmfontAsset.size, tokens(), rleTime * 1e6 / draws);
+  printf("\nCompression %.2fx, decode %.1f Mpixel/s\n",
+         (double)rawSize / rleSize,
+         (double)bpmfontAsset.width * bpmfontAsset.height * draws / rleTime / 1e6);
+
+  printf("%s\n", errors ? "FAILED" : "All checks passed");
+  return errors ? 1 : 0;
+}
@@ -0,0 +1,259 @@
+/**************************************************************************//**
+ * @file
+ * @brief Host (Linux) converter for TFT image assets
+ * @author Energy Micro AS
+ * @version 3.20.0
+ ******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 Energy Micro AS, http://www.energymicro.com</b>
+ *******************************************************************************
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ * 4. The source and compiled code may only be used on Energy Micro "EFM32"
+ *    microcontrollers and "EFR4" radios.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: Energy Micro AS has no
+ * obligation to support this Software. Energy Micro AS is providing the
+ * Software "AS IS", with no express or implied warranties of any kind,
+ * including, but not limited to, any implied warranties of merchantability
+ * or fitness for any particular purpose or warranties against infringement
+ * of any proprietary rights of a third party.
+ *
+ * Energy Micro AS will not be liable for any consequential, incidental, or
+ * special damages, or any other relief, or for any claim by any third party,
+ * arising from your use of this Software.
+ *
+ *****************************************************************************/
+/*
+   Host (Linux) converter for TFT image assets.
+
+   Reads a C source file holding an array of 3 byte pixels, such as
+   bpmfont.h, and writes a header with the image compressed as described
+   in tftasset.h: a palette of the colors used, and each row run length
+   coded in palette indices. The header defines a TFTASSET_TypeDef named
+   <name>Asset, to be drawn with TFTASSET_draw(), and is normally named
+   <name>rle.h.
+
+   Only the numbers of the first array initializer, between "= {" and
+   the following '}', are used. The image must use no more than 128 colors.
+
+   Usage: assetconv <width> <name> <in.h> <out.h>
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <ctype.h>
+#include "tftasset.h"
+
+#define BPP  3
+
+/***************************************************************************//**
+ * @brief Read numbers of first array initializer in C source file.
+ ******************************************************************************/
+static uint8_t *readArray(const char *name, uint32_t *size)
+{
+  FILE    *f = fopen(name, "r");
+  uint8_t *buf = NULL;
+  uint32_t alloc = 0;
+  uint32_t value;
+  int      c;
+  int      assign = 0;
+  int      inArray = 0;
+  int      inNumber = 0;
+
+  *size = 0;
+  if (!f)
+  {
+    return NULL;
+  }
+  value = 0;
+  while ((c = fgetc(f)) != EOF)
+  {
+    if (!inArray)
+    {
+      inArray = assign && (c == '{');
+      if (!isspace(c))
+      {
+        assign = (c == '=');
+      }
+      continue;
+    }
+    if (isdigit(c))
+    {
+      value    = (value * 10) + (uint32_t)(c - '0');
+      inNumber = 1;
+      continue;
+    }
+    if (inNumber)
+    {
+      if (*size == alloc)
+      {
+        alloc = alloc ? alloc * 2 : 4096;
+        buf   = realloc(buf, alloc);
+        if (!buf)
+        {
+          break;
+        }
+      }
+      buf[(*size)++] = (uint8_t)value;
+      value          = 0;
+      inNumber       = 0;
+    }
+    if (c == '}')
+    {
+      break;
+    }
+  }
+  fclose(f);
+  return buf;
+}
+
+/***************************************************************************//**
+ * @brief Find color in palette, adding it if not present.
+ * @return Palette index, or -1 if palette is full.
+ ******************************************************************************/
+static int paletteIndex(uint8_t *palette, uint32_t *colors, const uint8_t *pixel)
+{
+  uint32_t i;
+
+  for (i = 0; i < *colors; i++)
+  {
+    if (memcmp(&palette[i * BPP], pixel, BPP) == 0)
+    {
+      return (int)i;
+    }
+  }
+  if (*colors == TFTASSET_MAX_COLORS)
+  {
+    return -1;
+  }
+  memcpy(&palette[*colors * BPP], pixel, BPP);
+  return (int)(*colors)++;
+}
+
+/***************************************************************************//**
+ * @brief Write bytes as C array initializer, 12 per line.
+ ******************************************************************************/
+static void writeBytes(FILE *f, const uint8_t *data, uint32_t size)
+{
+  uint32_t i;
+
+  for (i = 0; i < size; i++)
+  {
+    fprintf(f, "%s%3u%s", (i % 12) ? " " : "  ", data[i],
+            (i == size - 1) ? "\n" : (((i % 12) == 11) ? ",\n" : ","));
+  }
+}
+
+/***************************************************************************//**
+ * @brief Main function
+ ******************************************************************************/
+int main(int argc, char *argv[])
+{
+  uint8_t  palette[TFTASSET_MAX_COLORS * BPP];
+  uint8_t  *pixels;
+  uint8_t  *index;
+  uint8_t  *coded;
+  uint32_t size, width, height, colors = 0, codedSize = 0;
+  uint32_t i, x, y, run;
+  const char *name;
+  char     guard[32];
+  FILE     *f;
+  int      idx;
+
+  if (argc != 5)
+  {
+    fprintf(stderr, "Usage: assetconv <width> <name> <in.h> <out.h>\n");
+    return 1;
+  }
+  width = (uint32_t)atoi(argv[1]);
+  name  = argv[2];
+  for (i = 0; name[i] && (i < sizeof(guard) - 1); i++)
+  {
+    guard[i] = (char)toupper((unsigned char)name[i]);
+  }
+  guard[i] = '\0';
+
+  pixels = readArray(argv[3], &size);
+  if (!pixels || (width == 0) || (width > TFTASSET_MAX_WIDTH) ||
+      (size % (width * BPP)))
+  {
+    fprintf(stderr, "%s: not an array of %u pixel rows\n", argv[3], width);
+    return 1;
+  }
+  height = size / (width * BPP);
+
+  /* Palette indices */
+  index = malloc(width * height);
+  coded = malloc(width * height * 2);
+  if (!index || !coded)
+  {
+    fprintf(stderr, "Out of memory\n");
+    return 1;
+  }
+  for (i = 0; i < width * height; i++)
+  {
+    idx = paletteIndex(palette, &colors, &pixels[i * BPP]);
+    if (idx < 0)
+    {
+      fprintf(stderr, "%s: more than %d colors\n", argv[3], TFTASSET_MAX_COLORS);
+      return 1;
+    }
+    index[i] = (uint8_t)idx;
+  }
+
+  /* Run length code each row */
+  for (y = 0; y < height; y++)
+  {
+    const uint8_t *row = &index[y * width];
+
+    for (x = 0; x < width; x += run)
+    {
+      for (run = 1; ((x + run) < width) && (run < TFTASSET_MAX_RUN) &&
+                    (row[x + run] == row[x]); run++)
+        ;
+      if (run >= TFTASSET_MIN_RUN)
+      {
+        coded[codedSize++] = (uint8_t)(TFTASSET_RUN | (run - TFTASSET_MIN_RUN));
+      }
+      coded[codedSize++] = row[x];
+    }
+  }
+
+  f = fopen(argv[4], "w");
+  if (!f)
+  {
+    fprintf(stderr, "%s: cannot create\n", argv[4]);
+    return 1;
+  }
+  fprintf(f, "/* %s: %ux%u image, %u colors, made by host/assetconv from %s */\n",
+          name, width, height, colors, argv[3]);
+  fprintf(f, "\n#ifndef __%sRLE_H\n#define __%sRLE_H\n", guard, guard);
+  fprintf(f, "\n#include \"tftasset.h\"\n\n");
+  fprintf(f, "static const uint8_t %sPalette[] = {\n", name);
+  writeBytes(f, palette, colors * BPP);
+  fprintf(f, "};\n\nstatic const uint8_t %sData[] = {\n", name);
+  writeBytes(f, coded, codedSize);
+  fprintf(f, "};\n\nstatic const TFTASSET_TypeDef %sAsset = {\n", name);
+  fprintf(f, "  .width   = %u,\n  .height  = %u,\n  .colors  = %u,\n",
+          width, height, colors);
+  fprintf(f, "  .palette = %sPalette,\n  .data    = %sData,\n  .size    = %u,\n};\n",
+          name, name, codedSize);
+  fprintf(f, "\n#endif\n");
+  fclose(f);
+
+  printf("%s: %ux%u, %u colors, %u bytes raw, %u bytes compressed (%.2fx)\n",
+         name, width, height, colors, size, (colors * BPP) + codedSize,
+         (double)size / ((colors * BPP) + codedSize));
+  return 0;
+}
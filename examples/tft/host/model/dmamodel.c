@@ -0,0 +1,265 @@
+/**************************************************************************//**
+ * @file
+ * @brief Host model of DMA controller for TFT DMA runner
+ * @author Energy Micro AS
+ * @version 3.20.0
+ ******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 Energy Micro AS, http://www.energymicro.com</b>
+ *******************************************************************************
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ * 4. The source and compiled code may only be used on Energy Micro "EFM32"
+ *    microcontrollers and "EFR4" radios.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: Energy Micro AS has no
+ * obligation to support this Software. Energy Micro AS is providing the
+ * Software "AS IS", with no express or implied warranties of any kind,
+ * including, but not limited to, any implied warranties of merchantability
+ * or fitness for any particular purpose or warranties against infringement
+ * of any proprietary rights of a third party.
+ *
+ * Energy Micro AS will not be liable for any consequential, incidental, or
+ * special damages, or any other relief, or for any claim by any third party,
+ * arising from your use of this Software.
+ *
+ *****************************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include "em_cmu.h"
+#include "em_dma.h"
+#include "em_emu.h"
+#include "em_int.h"
+#include "dmactrl.h"
+#include "dmamodel.h"
+
+#define CHANNELS  8
+
+/** Modelled channel state */
+typedef struct
+{
+  bool                 configured;
+  DMA_CB_TypeDef       *cb;
+  bool                 descrValid;
+  DMA_CfgDescr_TypeDef descr;
+  bool                 active;
+  uint8_t              *dst;
+  const uint8_t        *src;
+  uint32_t             n;
+} CHANNEL_TypeDef;
+
+DMA_DESCRIPTOR_TypeDef dmaControlBlock[CHANNELS * 2];
+DMAMODEL_Stats_TypeDef DMAMODEL_stats;
+uint32_t               INT_LockCnt;
+
+static CHANNEL_TypeDef   channels[CHANNELS];
+static bool              initialized;
+static bool              clockEnabled;
+static volatile uint16_t *displayReg;
+static uint16_t          *displayGram;
+static uint32_t          displaySize;
+static uint32_t          displayPos;
+
+/***************************************************************************//**
+ * @brief Report API misuse.
+ ******************************************************************************/
+static void error(const char *msg)
+{
+  fprintf(stderr, "DMA model: %s\n", msg);
+  DMAMODEL_stats.errors++;
+}
+
+/***************************************************************************//**
+ * @brief Bytes per increment step.
+ ******************************************************************************/
+static uint32_t incBytes(DMA_DataInc_TypeDef inc)
+{
+  return (inc == dmaDataIncNone) ? 0 : (1u << inc);
+}
+
+/***************************************************************************//**
+ * @brief Route display data register writes to model GRAM.
+ ******************************************************************************/
+void DMAMODEL_setDisplay(volatile uint16_t *dataReg, uint16_t *gram, uint32_t size)
+{
+  displayReg  = dataReg;
+  displayGram = gram;
+  displaySize = size;
+  displayPos  = 0;
+}
+
+/***************************************************************************//**
+ * @brief Clear counters and restart GRAM write position.
+ ******************************************************************************/
+void DMAMODEL_reset(void)
+{
+  memset(&DMAMODEL_stats, 0, sizeof(DMAMODEL_stats));
+  displayPos = 0;
+}
+
+/***************************************************************************//**
+ * @brief Number of pixels written to model GRAM.
+ ******************************************************************************/
+uint32_t DMAMODEL_gramPos(void)
+{
+  return displayPos;
+}
+
+void CMU_ClockEnable(CMU_Clock_TypeDef clock, bool enable)
+{
+  if (clock == cmuClock_DMA)
+  {
+    clockEnabled = enable;
+  }
+}
+
+void DMA_Init(DMA_Init_TypeDef *init)
+{
+  if (!clockEnabled)
+  {
+    error("DMA_Init() with DMA clock disabled");
+  }
+  if (init->controlBlock != dmaControlBlock)
+  {
+    error("unexpected control block");
+  }
+  memset(channels, 0, sizeof(channels));
+  initialized = true;
+}
+
+void DMA_CfgChannel(unsigned int channel, DMA_CfgChannel_TypeDef *cfg)
+{
+  if (!initialized || (channel >= CHANNELS))
+  {
+    error("DMA_CfgChannel() before DMA_Init() or bad channel");
+    return;
+  }
+  if (!cfg->enableInt || !cfg->cb)
+  {
+    error("channel configured without completion callback");
+  }
+  channels[channel].configured = true;
+  channels[channel].cb         = cfg->cb;
+}
+
+void DMA_CfgDescr(unsigned int channel, bool primary, DMA_CfgDescr_TypeDef *cfg)
+{
+  if ((channel >= CHANNELS) || !primary)
+  {
+    error("DMA_CfgDescr() bad channel or alternate descriptor");
+    return;
+  }
+  if (channels[channel].active)
+  {
+    error("descriptor reconfigured while channel active");
+  }
+  if ((cfg->dstInc != dmaDataIncNone) && (cfg->dstInc != (DMA_DataInc_TypeDef)cfg->size))
+  {
+    error("destination increment differs from data size");
+  }
+  if ((cfg->srcInc != dmaDataIncNone) && (cfg->srcInc != (DMA_DataInc_TypeDef)cfg->size))
+  {
+    error("source increment differs from data size");
+  }
+  channels[channel].descr      = *cfg;
+  channels[channel].descrValid = true;
+  DMAMODEL_stats.descrCfgs++;
+}
+
+void DMA_ActivateAuto(unsigned int channel, bool primary, void *dst, void *src,
+                      unsigned int nMinus1)
+{
+  CHANNEL_TypeDef *ch = &channels[channel];
+
+  if ((channel >= CHANNELS) || !primary || !ch->configured || !ch->descrValid)
+  {
+    error("DMA_ActivateAuto() on unconfigured channel");
+    return;
+  }
+  if (ch->active)
+  {
+    error("DMA_ActivateAuto() while channel active");
+  }
+  if (nMinus1 >= 1024)
+  {
+    error("more than 1024 transfers in one cycle");
+  }
+  ch->active = true;
+  ch->dst    = dst;
+  ch->src    = src;
+  ch->n      = nMinus1 + 1;
+  DMAMODEL_stats.activations++;
+}
+
+bool DMA_ChannelEnabled(unsigned int channel)
+{
+  return (channel < CHANNELS) && channels[channel].active;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Sleep until next interrupt. The DMA controller completes one active
+ *   cycle, then its completion interrupt invokes the channel callback.
+ ******************************************************************************/
+void EMU_EnterEM1(void)
+{
+  CHANNEL_TypeDef *ch;
+  uint32_t        size;
+  uint32_t        i;
+  unsigned int    c;
+  uint16_t        v16;
+  uint32_t        v32;
+
+  DMAMODEL_stats.sleeps++;
+  for (c = 0; c < CHANNELS; c++)
+  {
+    ch = &channels[c];
+    if (!ch->active)
+    {
+      continue;
+    }
+
+    size = 1u << ch->descr.size;
+    for (i = 0; i < ch->n; i++)
+    {
+      if ((size == 2) && (ch->dst == (uint8_t *)displayReg))
+      {
+        memcpy(&v16, ch->src, 2);
+        if (displayPos < displaySize)
+        {
+          displayGram[displayPos] = v16;
+        }
+        displayPos++;
+        DMAMODEL_stats.displayWrites++;
+      }
+      else if (size == 4)
+      {
+        memcpy(&v32, ch->src, 4);
+        memcpy(ch->dst, &v32, 4);
+      }
+      else
+      {
+        memcpy(ch->dst, ch->src, size);
+      }
+      ch->src += incBytes(ch->descr.srcInc);
+      ch->dst += incBytes(ch->descr.dstInc);
+      DMAMODEL_stats.transfers++;
+    }
+    ch->active = false;
+
+    /* Completion interrupt */
+    ch->cb->cbFunc(c, true, ch->cb->userPtr);
+    return;
+  }
+
+  /* Nothing active, would sleep until some unrelated interrupt */
+  error("EM1 entered with no DMA cycle active");
+}
@@ -0,0 +1,60 @@
+/**************************************************************************//**
+ * @file
+ * @brief Host model of DMA controller for TFT DMA runner
+ * @author Energy Micro AS
+ * @version 3.20.0
+ ******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 Energy Micro AS, http://www.energymicro.com</b>
+ *******************************************************************************
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ * 4. The source and compiled code may only be used on Energy Micro "EFM32"
+ *    microcontrollers and "EFR4" radios.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: Energy Micro AS has no
+ * obligation to support this Software. Energy Micro AS is providing the
+ * Software "AS IS", with no express or implied warranties of any kind,
+ * including, but not limited to, any implied warranties of merchantability
+ * or fitness for any particular purpose or warranties against infringement
+ * of any proprietary rights of a third party.
+ *
+ * Energy Micro AS will not be liable for any consequential, incidental, or
+ * special damages, or any other relief, or for any claim by any third party,
+ * arising from your use of this Software.
+ *
+ *****************************************************************************/
+#ifndef __DMAMODEL_H
+#define __DMAMODEL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Functional model of the DMA controller, for running tftdma.c on host */
+
+/** Counters of modelled DMA activity */
+typedef struct
+{
+  uint32_t activations;  /**< DMA cycles started */
+  uint32_t transfers;    /**< Elements transferred */
+  uint32_t displayWrites;/**< Elements written to display data register */
+  uint32_t sleeps;       /**< EM1 entries */
+  uint32_t descrCfgs;    /**< Descriptor configurations */
+  uint32_t errors;       /**< API misuse detected */
+} DMAMODEL_Stats_TypeDef;
+
+extern DMAMODEL_Stats_TypeDef DMAMODEL_stats;
+
+void DMAMODEL_setDisplay(volatile uint16_t *dataReg, uint16_t *gram, uint32_t size);
+void DMAMODEL_reset(void);
+uint32_t DMAMODEL_gramPos(void);
+
+#endif
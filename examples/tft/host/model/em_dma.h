@@ -0,0 +1,107 @@
+/**************************************************************************//**
+ * @file
+ * @brief Host model of em_dma.h for TFT DMA runner
+ * @author Energy Micro AS
+ * @version 3.20.0
+ ******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 Energy Micro AS, http://www.energymicro.com</b>
+ *******************************************************************************
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ * 4. The source and compiled code may only be used on Energy Micro "EFM32"
+ *    microcontrollers and "EFR4" radios.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: Energy Micro AS has no
+ * obligation to support this Software. Energy Micro AS is providing the
+ * Software "AS IS", with no express or implied warranties of any kind,
+ * including, but not limited to, any implied warranties of merchantability
+ * or fitness for any particular purpose or warranties against infringement
+ * of any proprietary rights of a third party.
+ *
+ * Energy Micro AS will not be liable for any consequential, incidental, or
+ * special damages, or any other relief, or for any claim by any third party,
+ * arising from your use of this Software.
+ *
+ *****************************************************************************/
+#ifndef __EM_DMA_H
+#define __EM_DMA_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Host model of the emlib DMA API subset used by tftdma.c */
+
+typedef struct
+{
+  uint32_t word[4];
+} DMA_DESCRIPTOR_TypeDef;
+
+typedef void (*DMA_FuncPtr_TypeDef)(unsigned int channel, bool primary, void *user);
+
+typedef struct
+{
+  DMA_FuncPtr_TypeDef cbFunc;
+  void                *userPtr;
+  uint8_t             primary;
+} DMA_CB_TypeDef;
+
+typedef struct
+{
+  uint8_t                hprot;
+  DMA_DESCRIPTOR_TypeDef *controlBlock;
+} DMA_Init_TypeDef;
+
+typedef struct
+{
+  bool           highPri;
+  bool           enableInt;
+  uint32_t       select;
+  DMA_CB_TypeDef *cb;
+} DMA_CfgChannel_TypeDef;
+
+typedef enum
+{
+  dmaDataInc1    = 0,
+  dmaDataInc2    = 1,
+  dmaDataInc4    = 2,
+  dmaDataIncNone = 3
+} DMA_DataInc_TypeDef;
+
+typedef enum
+{
+  dmaDataSize1 = 0,
+  dmaDataSize2 = 1,
+  dmaDataSize4 = 2
+} DMA_DataSize_TypeDef;
+
+typedef enum
+{
+  dmaArbitrate1 = 0
+} DMA_ArbiterConfig_TypeDef;
+
+typedef struct
+{
+  DMA_DataInc_TypeDef       dstInc;
+  DMA_DataInc_TypeDef       srcInc;
+  DMA_DataSize_TypeDef      size;
+  DMA_ArbiterConfig_TypeDef arbRate;
+  uint8_t                   hprot;
+} DMA_CfgDescr_TypeDef;
+
+void DMA_Init(DMA_Init_TypeDef *init);
+void DMA_CfgChannel(unsigned int channel, DMA_CfgChannel_TypeDef *cfg);
+void DMA_CfgDescr(unsigned int channel, bool primary, DMA_CfgDescr_TypeDef *cfg);
+void DMA_ActivateAuto(unsigned int channel, bool primary, void *dst, void *src,
+                      unsigned int nMinus1);
+bool DMA_ChannelEnabled(unsigned int channel);
+
+#endif
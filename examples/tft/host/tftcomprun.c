@@ -0,0 +1,217 @@
+/**************************************************************************//**
+ * @file
+ * @brief Host (Linux) runner for TFT rectangle compositor
+ * @author Energy Micro AS
+ * @version 3.20.0
+ ******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 Energy Micro AS, http://www.energymicro.com</b>
+ *******************************************************************************
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ * 4. The source and compiled code may only be used on Energy Micro "EFM32"
+ *    microcontrollers and "EFR4" radios.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: Energy Micro AS has no
+ * obligation to support this Software. Energy Micro AS is providing the
+ * Software "AS IS", with no express or implied warranties of any kind,
+ * including, but not limited to, any implied warranties of merchantability
+ * or fitness for any particular purpose or warranties against infringement
+ * of any proprietary rights of a third party.
+ *
+ * Energy Micro AS will not be liable for any consequential, incidental, or
+ * special damages, or any other relief, or for any claim by any third party,
+ * arising from your use of this Software.
+ *
+ *****************************************************************************/
+
+/*
+   Host (Linux) runner for the TFT rectangle compositor.
+
+   Draws the demo's random rectangle pattern to a mock 320x240 display
+   that counts pixel writes, once with each rectangle filled directly as
+   GLIB_drawRectFilled() does, and once through the compositor (tftcomp.c).
+   Checks that both give the same image and that the compositor writes no
+   pixel more than once, and reports pixel writes, display window setups
+   and time per frame for both.
+
+   Usage: tftcomprun [frames]
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include "tftcomp.h"
+
+#define WIDTH   320
+#define HEIGHT  240
+#define RECTS   20
+
+/** Mock display */
+static uint32_t pixels[HEIGHT][WIDTH];
+static uint8_t  writes[HEIGHT][WIDTH];
+static uint32_t pixelWrites;
+static uint32_t windows;
+
+/** Image drawn directly, for comparison */
+static uint32_t reference[HEIGHT][WIDTH];
+
+/***************************************************************************//**
+ * @brief Random number generator, same as in tftdraw.c.
+ ******************************************************************************/
+static int randomGenerator(int limit)
+{
+  static uint32_t rnum = 0xabcd7381;
+
+  rnum = ((rnum * 27) << 8) | (((rnum / 13) & 0xa5a7f196) + (rnum >> 13));
+
+  return(rnum % limit);
+}
+
+/***************************************************************************//**
+ * @brief Fill rectangle on mock display, as one display window.
+ ******************************************************************************/
+static void fillRect(const TFTCOMP_Rect_TypeDef *rect)
+{
+  int32_t x, y;
+
+  windows++;
+  for (y = rect->yMin; y <= rect->yMax; y++)
+  {
+    for (x = rect->xMin; x <= rect->xMax; x++)
+    {
+      pixels[y][x] = rect->color;
+      if (writes[y][x] < 255)
+      {
+        writes[y][x]++;
+      }
+      pixelWrites++;
+    }
+  }
+}
+
+/***************************************************************************//**
+ * @brief Generate rectangle pattern as in TFT_displayUpdate().
+ ******************************************************************************/
+static void generate(TFTCOMP_Stack_TypeDef *stack)
+{
+  TFTCOMP_Rect_TypeDef rect;
+  int                  i;
+
+  TFTCOMP_init(stack);
+  for (i = 0; i < RECTS; i++)
+  {
+    rect.xMin  = randomGenerator(320);
+    rect.xMax  = randomGenerator(320);
+    rect.yMin  = randomGenerator(230) + 10;
+    rect.yMax  = randomGenerator(230) + 10;
+    rect.color = ((uint32_t)(128 + randomGenerator(127)) << 16) |
+                 ((uint32_t)randomGenerator(200) << 8) |
+                 (uint32_t)randomGenerator(255);
+    TFTCOMP_add(stack, &rect);
+  }
+}
+
+/***************************************************************************//**
+ * @brief Main function.
+ ******************************************************************************/
+int main(int argc, char **argv)
+{
+  static TFTCOMP_Stack_TypeDef stack;
+  long     frames = 1000;
+  long     f;
+  uint32_t i;
+  uint32_t directWrites = 0, directWindows = 0;
+  uint32_t compWrites = 0, compWindows = 0;
+  clock_t  start;
+  double   directTime = 0, compTime = 0;
+  int      x, y;
+
+  if (argc > 1)
+  {
+    frames = atol(argv[1]);
+    if (frames < 1)
+    {
+      frames = 1;
+    }
+  }
+
+  for (f = 0; f < frames; f++)
+  {
+    generate(&stack);
+
+    /* Direct drawing, bottom to top */
+    memset(writes, 0, sizeof(writes));
+    pixelWrites = 0;
+    windows     = 0;
+    start       = clock();
+    for (i = 0; i < stack.count; i++)
+    {
+      fillRect(&stack.rects[i]);
+    }
+    directTime    += (double)(clock() - start) / CLOCKS_PER_SEC;
+    directWrites  += pixelWrites;
+    directWindows += windows;
+    memcpy(reference, pixels, sizeof(pixels));
+
+    /* Through compositor, on top of a different background */
+    memset(pixels, 0xff, sizeof(pixels));
+    memset(writes, 0, sizeof(writes));
+    pixelWrites = 0;
+    windows     = 0;
+    start       = clock();
+    TFTCOMP_draw(&stack, fillRect);
+    compTime    += (double)(clock() - start) / CLOCKS_PER_SEC;
+    compWrites  += pixelWrites;
+    compWindows += windows;
+
+    for (y = 0; y < HEIGHT; y++)
+    {
+      for (x = 0; x < WIDTH; x++)
+      {
+        if ((writes[y][x] > 1) || (writes[y][x] && (pixels[y][x] != reference[y][x])))
+        {
+          fprintf(stderr, "Frame %ld: pixel %d,%d wrong or written %d times\n",
+                  f, x, y, writes[y][x]);
+          return 1;
+        }
+        if (!writes[y][x] && (pixels[y][x] != 0xffffffff))
+        {
+          fprintf(stderr, "Frame %ld: pixel %d,%d written outside rectangles\n", f, x, y);
+          return 1;
+        }
+      }
+    }
+    for (i = 0; i < stack.count; i++)
+    {
+      x = (stack.rects[i].xMin + stack.rects[i].xMax) / 2;
+      y = (stack.rects[i].yMin + stack.rects[i].yMax) / 2;
+      if (!writes[y][x])
+      {
+        fprintf(stderr, "Frame %ld: rectangle %u not drawn\n", f, (unsigned)i);
+        return 1;
+      }
+    }
+  }
+
+  printf("%ld frames of %d rectangles, images identical\n", frames, RECTS);
+  printf("  direct    : %8.0f pixel writes, %6.1f windows, %7.1f us per frame\n",
+         (double)directWrites / frames, (double)directWindows / frames,
+         directTime * 1e6 / frames);
+  printf("  compositor: %8.0f pixel writes, %6.1f windows, %7.1f us per frame\n",
+         (double)compWrites / frames, (double)compWindows / frames,
+         compTime * 1e6 / frames);
+  printf("  overdraw  : %.2fx before, 1.00x after\n",
+         (double)directWrites / compWrites);
+  return 0;
+}
@@ -0,0 +1,155 @@
+/**************************************************************************//**
+ * @file
+ * @brief Host (Linux) runner for TFT DMA transfers
+ * @author Energy Micro AS
+ * @version 3.20.0
+ ******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 Energy Micro AS, http://www.energymicro.com</b>
+ *******************************************************************************
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ * 4. The source and compiled code may only be used on Energy Micro "EFM32"
+ *    microcontrollers and "EFR4" radios.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: Energy Micro AS has no
+ * obligation to support this Software. Energy Micro AS is providing the
+ * Software "AS IS", with no express or implied warranties of any kind,
+ * including, but not limited to, any implied warranties of merchantability
+ * or fitness for any particular purpose or warranties against infringement
+ * of any proprietary rights of a third party.
+ *
+ * Energy Micro AS will not be liable for any consequential, incidental, or
+ * special damages, or any other relief, or for any claim by any third party,
+ * arising from your use of this Software.
+ *
+ *****************************************************************************/
+
+/*
+   Host (Linux) runner for the TFT DMA transfer service.
+
+   Runs tftdma.c against a functional model of the DMA controller
+   (model/dmamodel.c), which executes DMA cycles when the CPU sleeps in
+   EM1, writes pixels sent to the display data register into a model GRAM,
+   and flags misuse of the DMA API. Checks fills and blits of various sizes
+   for correct GRAM contents and DMA cycle counts.
+
+   Usage: tftdmarun
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include "tftdma.h"
+#include "dmamodel.h"
+
+#define GRAM_SIZE  (320 * 240)
+
+/** Model display data register and GRAM */
+static volatile uint16_t dataReg;
+static uint16_t          gram[GRAM_SIZE];
+
+/** Blit source */
+static uint16_t pattern[GRAM_SIZE];
+
+/***************************************************************************//**
+ * @brief Check result of one transfer.
+ ******************************************************************************/
+static int check(const char *what, uint32_t pixels, const uint16_t *expect,
+                 uint16_t color, uint32_t descrCfgs)
+{
+  uint32_t cycles = (pixels + TFTDMA_MAX_TRANSFERS - 1) / TFTDMA_MAX_TRANSFERS;
+  uint32_t i;
+  int      ok = 1;
+
+  if (TFTDMA_busy() || (DMAMODEL_gramPos() != pixels) ||
+      (DMAMODEL_stats.displayWrites != pixels) ||
+      (DMAMODEL_stats.activations != cycles) ||
+      (DMAMODEL_stats.descrCfgs != descrCfgs) ||
+      DMAMODEL_stats.errors)
+  {
+    ok = 0;
+  }
+  for (i = 0; ok && (i < pixels); i++)
+  {
+    if (gram[i] != (expect ? expect[i] : color))
+    {
+      ok = 0;
+    }
+  }
+
+  printf("  %-5s %6u pixels: %3u cycles, %6u transfers, %3u sleeps  %s\n",
+         what, (unsigned)pixels, (unsigned)DMAMODEL_stats.activations,
+         (unsigned)DMAMODEL_stats.transfers, (unsigned)DMAMODEL_stats.sleeps,
+         ok ? "ok" : "FAILED");
+  return ok ? 0 : 1;
+}
+
+/***************************************************************************//**
+ * @brief Main function.
+ ******************************************************************************/
+int main(void)
+{
+  static const uint32_t sizes[] = { 0, 1, 2, 1023, 1024, 1025, 4096, 5000, GRAM_SIZE };
+  uint32_t i, n;
+  int      failed = 0;
+
+  for (i = 0; i < GRAM_SIZE; i++)
+  {
+    pattern[i] = (uint16_t)(i * 40503u);
+  }
+
+  DMAMODEL_setDisplay(&dataReg, gram, GRAM_SIZE);
+  TFTDMA_init(&dataReg);
+
+  printf("TFT DMA transfers on DMA model\n");
+  for (n = 0; n < sizeof(sizes) / sizeof(sizes[0]); n++)
+  {
+    /* Blit first, descriptor left configured for blits by TFTDMA_init() */
+    memset(gram, 0, sizeof(gram));
+    DMAMODEL_reset();
+    TFTDMA_blit(pattern, sizes[n]);
+    TFTDMA_wait();
+    failed += check("blit", sizes[n], pattern, 0, 0);
+
+    /* Fill switches descriptor to fixed source, unless nothing to do */
+    memset(gram, 0, sizeof(gram));
+    DMAMODEL_reset();
+    TFTDMA_fill(0xf81f, sizes[n]);
+    TFTDMA_wait();
+    failed += check("fill", sizes[n], NULL, 0xf81f, sizes[n] ? 1 : 0);
+
+    /* Back to blits for next size */
+    DMAMODEL_reset();
+    TFTDMA_blit(pattern, 1);
+    TFTDMA_wait();
+  }
+
+  /* Back-to-back transfers, second must wait for the first */
+  memset(gram, 0, sizeof(gram));
+  DMAMODEL_reset();
+  TFTDMA_fill(0x1234, 3000);
+  TFTDMA_blit(pattern, 3000);
+  TFTDMA_wait();
+  if ((DMAMODEL_gramPos() != 6000) || (gram[2999] != 0x1234) ||
+      memcmp(&gram[3000], pattern, 3000 * 2) || DMAMODEL_stats.errors)
+  {
+    printf("  fill followed by blit: FAILED\n");
+    failed++;
+  }
+  else
+  {
+    printf("  fill followed by blit: ok\n");
+  }
+
+  printf("%s\n", failed ? "FAILED" : "All transfers correct");
+  return failed ? 1 : 0;
+}
@@ -0,0 +1,95 @@
+/**************************************************************************//**
+ * @file
+ * @brief Compressed images for the TFT display
+ * @author Energy Micro AS
+ * @version 3.20.0
+ ******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 Energy Micro AS, http://www.energymicro.com</b>
+ *******************************************************************************
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ * 4. The source and compiled code may only be used on Energy Micro "EFM32"
+ *    microcontrollers and "EFR4" radios.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: Energy Micro AS has no
+ * obligation to support this Software. Energy Micro AS is providing the
+ * Software "AS IS", with no express or implied warranties of any kind,
+ * including, but not limited to, any implied warranties of merchantability
+ * or fitness for any particular purpose or warranties against infringement
+ * of any proprietary rights of a third party.
+ *
+ * Energy Micro AS will not be liable for any consequential, incidental, or
+ * special damages, or any other relief, or for any claim by any third party,
+ * arising from your use of this Software.
+ *
+ *****************************************************************************/
+#include "glib/glib.h"
+#include "dmd/ssd2119/dmd_ssd2119.h"
+#include "tftasset.h"
+
+/** Bytes per pixel written by DMD_writeData() */
+#define TFTASSET_BPP  3
+
+/** One decoded pixel row */
+static uint8_t rowBuffer[TFTASSET_MAX_WIDTH * TFTASSET_BPP];
+
+/***************************************************************************//**
+ * @brief
+ *   Draw compressed image, decoding one row at a time. The DMD clipping
+ *   area is left at the image, to be reset by the caller.
+ *
+ * @param[in] asset
+ *   Compressed image, made by host/assetconv.
+ *
+ * @param[in] x
+ *   Left column.
+ *
+ * @param[in] y
+ *   Top row.
+ *
+ * @return
+ *   DMD_OK, or error code from DMD.
+ ******************************************************************************/
+EMSTATUS TFTASSET_draw(const TFTASSET_TypeDef *asset, uint16_t x, uint16_t y)
+{
+  const uint8_t *data = asset->data;
+  const uint8_t *color;
+  EMSTATUS      status;
+  uint8_t       *pixel;
+  uint32_t      row;
+  uint32_t      run;
+
+  status = DMD_setClippingArea(x, y, asset->width, asset->height);
+  for (row = 0; (row < asset->height) && (status == DMD_OK); row++)
+  {
+    pixel = rowBuffer;
+    while (pixel < &rowBuffer[asset->width * TFTASSET_BPP])
+    {
+      run = 1;
+      if (*data & TFTASSET_RUN)
+      {
+        run = (*data++ & ~TFTASSET_RUN) + TFTASSET_MIN_RUN;
+      }
+      color = &asset->palette[*data++ * TFTASSET_BPP];
+      while (run--)
+      {
+        pixel[0] = color[0];
+        pixel[1] = color[1];
+        pixel[2] = color[2];
+        pixel   += TFTASSET_BPP;
+      }
+    }
+    status = DMD_writeData(0, row, rowBuffer, asset->width);
+  }
+
+  return status;
+}
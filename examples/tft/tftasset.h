@@ -0,0 +1,90 @@
+/**************************************************************************//**
+ * @file
+ * @brief Compressed images for the TFT display
+ * @author Energy Micro AS
+ * @version 3.20.0
+ ******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 Energy Micro AS, http://www.energymicro.com</b>
+ *******************************************************************************
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ * 4. The source and compiled code may only be used on Energy Micro "EFM32"
+ *    microcontrollers and "EFR4" radios.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: Energy Micro AS has no
+ * obligation to support this Software. Energy Micro AS is providing the
+ * Software "AS IS", with no express or implied warranties of any kind,
+ * including, but not limited to, any implied warranties of merchantability
+ * or fitness for any particular purpose or warranties against infringement
+ * of any proprietary rights of a third party.
+ *
+ * Energy Micro AS will not be liable for any consequential, incidental, or
+ * special damages, or any other relief, or for any claim by any third party,
+ * arising from your use of this Software.
+ *
+ *****************************************************************************/
+#ifndef __TFTASSET_H
+#define __TFTASSET_H
+
+#include <stdint.h>
+#include "glib/glib.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+   Compressed images for the TFT display.
+
+   Images are stored with a palette of up to 128 colors and each row run
+   length coded in palette indices. The encoding is made on the host by
+   host/assetconv from a C array of 3 byte pixels, such as bpmfont.h,
+   into a header holding a TFTASSET_TypeDef (see bpmfontrle.h).
+
+   Coded row data is a sequence of tokens:
+     0x00-0x7f         one pixel of that palette index
+     0x80-0xff, index  (token & 0x7f) + 2 pixels of palette index
+   Runs do not extend past the end of a row.
+
+   TFTASSET_draw() decodes one row at a time into a row buffer, which is
+   written to the display with a single DMD_writeData() call.
+*/
+
+/** Max number of palette colors */
+#define TFTASSET_MAX_COLORS  128
+
+/** Max image width in pixels, the display width */
+#define TFTASSET_MAX_WIDTH   320
+
+/** Token values */
+#define TFTASSET_RUN         0x80
+#define TFTASSET_MIN_RUN     2
+#define TFTASSET_MAX_RUN     (0x7f + TFTASSET_MIN_RUN)
+
+/** Compressed image */
+typedef struct
+{
+  uint16_t      width;         /**< Width in pixels */
+  uint16_t      height;        /**< Height in pixels */
+  uint16_t      colors;        /**< Number of palette colors */
+  const uint8_t *palette;      /**< Palette, 3 bytes per color as DMD_writeData() */
+  const uint8_t *data;         /**< Run length coded rows */
+  uint32_t      size;          /**< Bytes of coded rows */
+} TFTASSET_TypeDef;
+
+EMSTATUS TFTASSET_draw(const TFTASSET_TypeDef *asset, uint16_t x, uint16_t y);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
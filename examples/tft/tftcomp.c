@@ -0,0 +1,292 @@
+/**************************************************************************//**
+ * @file
+ * @brief Rectangle compositor for TFT drawing
+ * @author Energy Micro AS
+ * @version 3.20.0
+ ******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 Energy Micro AS, http://www.energymicro.com</b>
+ *******************************************************************************
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ * 4. The source and compiled code may only be used on Energy Micro "EFM32"
+ *    microcontrollers and "EFR4" radios.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: Energy Micro AS has no
+ * obligation to support this Software. Energy Micro AS is providing the
+ * Software "AS IS", with no express or implied warranties of any kind,
+ * including, but not limited to, any implied warranties of merchantability
+ * or fitness for any particular purpose or warranties against infringement
+ * of any proprietary rights of a third party.
+ *
+ * Energy Micro AS will not be liable for any consequential, incidental, or
+ * special damages, or any other relief, or for any claim by any third party,
+ * arising from your use of this Software.
+ *
+ *****************************************************************************/
+#include "tftcomp.h"
+
+/** Visible span of a row, or a rectangle under construction */
+typedef struct
+{
+  int32_t  xMin;
+  int32_t  xMax;
+  int32_t  yMin;   /* First row of rectangle being merged */
+  uint32_t color;
+} TFTCOMP_Span_TypeDef;
+
+/** Covered interval of a row */
+typedef struct
+{
+  int32_t xMin;
+  int32_t xMax;
+} TFTCOMP_Interval_TypeDef;
+
+/* Visible spans of current row, and rectangles still open at previous row */
+static TFTCOMP_Span_TypeDef rowSpans[TFTCOMP_MAX_SPANS];
+static TFTCOMP_Span_TypeDef openSpans[TFTCOMP_MAX_SPANS];
+/* Covered intervals of current row, sorted and disjoint */
+static TFTCOMP_Interval_TypeDef covered[TFTCOMP_MAX_SPANS];
+
+/***************************************************************************//**
+ * @brief
+ *   Initialize empty rectangle stack.
+ *
+ * @param[out] stack
+ *   Stack to initialize.
+ ******************************************************************************/
+void TFTCOMP_init(TFTCOMP_Stack_TypeDef *stack)
+{
+  stack->count = 0;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Add rectangle on top of stack. Coordinates may be given in any order.
+ *
+ * @param[in] stack
+ *   Stack to add rectangle to.
+ *
+ * @param[in] rect
+ *   Rectangle to add.
+ *
+ * @return
+ *   false if stack is full, true otherwise.
+ ******************************************************************************/
+bool TFTCOMP_add(TFTCOMP_Stack_TypeDef *stack, const TFTCOMP_Rect_TypeDef *rect)
+{
+  TFTCOMP_Rect_TypeDef *r;
+
+  if (stack->count >= TFTCOMP_MAX_RECTS)
+  {
+    return false;
+  }
+
+  r        = &stack->rects[stack->count++];
+  r->xMin  = (rect->xMin < rect->xMax) ? rect->xMin : rect->xMax;
+  r->xMax  = (rect->xMin < rect->xMax) ? rect->xMax : rect->xMin;
+  r->yMin  = (rect->yMin < rect->yMax) ? rect->yMin : rect->yMax;
+  r->yMax  = (rect->yMin < rect->yMax) ? rect->yMax : rect->yMin;
+  r->color = rect->color;
+  return true;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Compute visible spans of a row, sorted left to right.
+ *
+ * @return
+ *   Number of spans in rowSpans.
+ ******************************************************************************/
+static uint32_t TFTCOMP_resolveRow(const TFTCOMP_Stack_TypeDef *stack, int32_t y)
+{
+  const TFTCOMP_Rect_TypeDef *r;
+  uint32_t nSpans   = 0;
+  uint32_t nCovered = 0;
+  uint32_t i, j, k, m;
+  int32_t  x;
+
+  /* Topmost rectangle first, each gets what is not already covered */
+  for (i = stack->count; i-- > 0;)
+  {
+    r = &stack->rects[i];
+    if ((y < r->yMin) || (y > r->yMax))
+    {
+      continue;
+    }
+
+    /* Emit gaps between covered intervals within [xMin, xMax] */
+    x = r->xMin;
+    for (j = 0; (j < nCovered) && (x <= r->xMax); j++)
+    {
+      if (covered[j].xMax < x)
+      {
+        continue;
+      }
+      if (covered[j].xMin > x)
+      {
+        rowSpans[nSpans].xMin  = x;
+        rowSpans[nSpans].xMax  = (covered[j].xMin - 1 < r->xMax) ? covered[j].xMin - 1 : r->xMax;
+        rowSpans[nSpans].yMin  = y;
+        rowSpans[nSpans].color = r->color;
+        nSpans++;
+      }
+      x = covered[j].xMax + 1;
+    }
+    if (x <= r->xMax)
+    {
+      rowSpans[nSpans].xMin  = x;
+      rowSpans[nSpans].xMax  = r->xMax;
+      rowSpans[nSpans].yMin  = y;
+      rowSpans[nSpans].color = r->color;
+      nSpans++;
+    }
+
+    /* Merge [xMin, xMax] into covered intervals */
+    for (j = 0; (j < nCovered) && (covered[j].xMax < r->xMin - 1); j++)
+      ;
+    for (k = j; (k < nCovered) && (covered[k].xMin <= r->xMax + 1); k++)
+      ;
+    if (j == k)
+    {
+      /* No overlap, insert new interval at j */
+      for (k = nCovered; k > j; k--)
+      {
+        covered[k] = covered[k - 1];
+      }
+      covered[j].xMin = r->xMin;
+      covered[j].xMax = r->xMax;
+      nCovered++;
+    }
+    else
+    {
+      /* Intervals j to k - 1 are joined into interval j */
+      if (r->xMin < covered[j].xMin)
+      {
+        covered[j].xMin = r->xMin;
+      }
+      covered[j].xMax = (r->xMax > covered[k - 1].xMax) ? r->xMax : covered[k - 1].xMax;
+      for (m = j + 1; k < nCovered; m++, k++)
+      {
+        covered[m] = covered[k];
+      }
+      nCovered = m;
+    }
+  }
+
+  /* Sort spans left to right, few enough for insertion sort */
+  for (i = 1; i < nSpans; i++)
+  {
+    TFTCOMP_Span_TypeDef s = rowSpans[i];
+
+    for (j = i; (j > 0) && (rowSpans[j - 1].xMin > s.xMin); j--)
+    {
+      rowSpans[j] = rowSpans[j - 1];
+    }
+    rowSpans[j] = s;
+  }
+  return nSpans;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Draw rectangle stack, each visible pixel written once.
+ *
+ * @param[in] stack
+ *   Stack to draw.
+ *
+ * @param[in] draw
+ *   Function drawing each resolved rectangle.
+ *
+ * @return
+ *   Number of rectangles drawn.
+ ******************************************************************************/
+uint32_t TFTCOMP_draw(const TFTCOMP_Stack_TypeDef *stack, TFTCOMP_Draw_TypeDef draw)
+{
+  TFTCOMP_Rect_TypeDef out;
+  uint32_t nOpen  = 0;
+  uint32_t nSpans = 0;
+  uint32_t drawn  = 0;
+  uint32_t i, j;
+  int32_t  yFirst, yLast, y;
+  bool     changed;
+
+  if (stack->count == 0)
+  {
+    return 0;
+  }
+
+  yFirst = stack->rects[0].yMin;
+  yLast  = stack->rects[0].yMax;
+  for (i = 1; i < stack->count; i++)
+  {
+    if (stack->rects[i].yMin < yFirst)
+    {
+      yFirst = stack->rects[i].yMin;
+    }
+    if (stack->rects[i].yMax > yLast)
+    {
+      yLast = stack->rects[i].yMax;
+    }
+  }
+
+  /* One row past the last, closing all open rectangles */
+  for (y = yFirst; y <= yLast + 1; y++)
+  {
+    /* Visible spans only change where a rectangle starts or ends */
+    changed = (y == yFirst) || (y > yLast);
+    for (i = 0; !changed && (i < stack->count); i++)
+    {
+      changed = (stack->rects[i].yMin == y) || (stack->rects[i].yMax + 1 == y);
+    }
+    if (!changed)
+    {
+      continue;
+    }
+
+    nSpans = (y > yLast) ? 0 : TFTCOMP_resolveRow(stack, y);
+
+    /* Open rectangles continuing unchanged are kept, others are drawn. */
+    /* Both lists are sorted left to right. */
+    for (i = 0, j = 0; i < nOpen; i++)
+    {
+      while ((j < nSpans) && (rowSpans[j].xMin < openSpans[i].xMin))
+      {
+        j++;
+      }
+      if ((j < nSpans) &&
+          (rowSpans[j].xMin == openSpans[i].xMin) &&
+          (rowSpans[j].xMax == openSpans[i].xMax) &&
+          (rowSpans[j].color == openSpans[i].color))
+      {
+        rowSpans[j].yMin = openSpans[i].yMin;
+        j++;
+        continue;
+      }
+
+      out.xMin  = openSpans[i].xMin;
+      out.xMax  = openSpans[i].xMax;
+      out.yMin  = openSpans[i].yMin;
+      out.yMax  = y - 1;
+      out.color = openSpans[i].color;
+      draw(&out);
+      drawn++;
+    }
+
+    /* Spans not continuing an open rectangle start a new one at this row */
+    for (j = 0; j < nSpans; j++)
+    {
+      openSpans[j] = rowSpans[j];
+    }
+    nOpen = nSpans;
+  }
+  return drawn;
+}
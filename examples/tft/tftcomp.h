@@ -0,0 +1,94 @@
+/**************************************************************************//**
+ * @file
+ * @brief Rectangle compositor for TFT drawing
+ * @author Energy Micro AS
+ * @version 3.20.0
+ ******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 Energy Micro AS, http://www.energymicro.com</b>
+ *******************************************************************************
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ * 4. The source and compiled code may only be used on Energy Micro "EFM32"
+ *    microcontrollers and "EFR4" radios.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: Energy Micro AS has no
+ * obligation to support this Software. Energy Micro AS is providing the
+ * Software "AS IS", with no express or implied warranties of any kind,
+ * including, but not limited to, any implied warranties of merchantability
+ * or fitness for any particular purpose or warranties against infringement
+ * of any proprietary rights of a third party.
+ *
+ * Energy Micro AS will not be liable for any consequential, incidental, or
+ * special damages, or any other relief, or for any claim by any third party,
+ * arising from your use of this Software.
+ *
+ *****************************************************************************/
+#ifndef __TFTCOMP_H
+#define __TFTCOMP_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+   Compositor for stacks of opaque filled rectangles.
+
+   Rectangles are added in painter's order, later rectangles covering
+   earlier ones. When drawn, the stack is resolved into non-overlapping
+   rectangles showing only the visible parts, so each pixel is written at
+   most once. Rows are split into visible spans only where a rectangle
+   starts or ends, and spans that continue unchanged over several rows are
+   merged into a single rectangle, keeping the number of output rectangles,
+   and thus display window setups, low.
+
+   The compositor does not access the display itself, output rectangles are
+   passed to a function drawing them, e.g. with GLIB_drawRectFilled().
+*/
+
+/** Max number of rectangles in stack */
+#define TFTCOMP_MAX_RECTS  32
+
+/** Max number of visible spans on one row */
+#define TFTCOMP_MAX_SPANS  (2 * TFTCOMP_MAX_RECTS)
+
+/** Filled rectangle, coordinates inclusive as for GLIB_Rectangle */
+typedef struct
+{
+  int32_t  xMin;   /**< Left column */
+  int32_t  yMin;   /**< Top row */
+  int32_t  xMax;   /**< Right column */
+  int32_t  yMax;   /**< Bottom row */
+  uint32_t color;  /**< Fill color, as used by the draw function */
+} TFTCOMP_Rect_TypeDef;
+
+/** Function drawing a resolved, non-overlapping rectangle */
+typedef void (*TFTCOMP_Draw_TypeDef)(const TFTCOMP_Rect_TypeDef *rect);
+
+/** Rectangle stack */
+typedef struct
+{
+  uint32_t             count;                     /**< Rectangles in stack */
+  TFTCOMP_Rect_TypeDef rects[TFTCOMP_MAX_RECTS];  /**< Bottom to top */
+} TFTCOMP_Stack_TypeDef;
+
+void TFTCOMP_init(TFTCOMP_Stack_TypeDef *stack);
+bool TFTCOMP_add(TFTCOMP_Stack_TypeDef *stack, const TFTCOMP_Rect_TypeDef *rect);
+uint32_t TFTCOMP_draw(const TFTCOMP_Stack_TypeDef *stack, TFTCOMP_Draw_TypeDef draw);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
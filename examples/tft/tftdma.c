@@ -0,0 +1,237 @@
+/**************************************************************************//**
+ * @file
+ * @brief DMA transfers to SSD2119 TFT display
+ * @author Energy Micro AS
+ * @version 3.20.0
+ ******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 Energy Micro AS, http://www.energymicro.com</b>
+ *******************************************************************************
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ * 4. The source and compiled code may only be used on Energy Micro "EFM32"
+ *    microcontrollers and "EFR4" radios.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: Energy Micro AS has no
+ * obligation to support this Software. Energy Micro AS is providing the
+ * Software "AS IS", with no express or implied warranties of any kind,
+ * including, but not limited to, any implied warranties of merchantability
+ * or fitness for any particular purpose or warranties against infringement
+ * of any proprietary rights of a third party.
+ *
+ * Energy Micro AS will not be liable for any consequential, incidental, or
+ * special damages, or any other relief, or for any claim by any third party,
+ * arising from your use of this Software.
+ *
+ *****************************************************************************/
+#include <stddef.h>
+#include "em_device.h"
+#include "em_cmu.h"
+#include "em_dma.h"
+#include "em_emu.h"
+#include "em_int.h"
+#include "dmactrl.h"
+#include "tftdma.h"
+
+/** Display data register */
+static volatile uint16_t *tftData;
+
+/** Callback config for DMA, must remain 'live' */
+static DMA_CB_TypeDef tftCb;
+
+/** Set by DMA callback when transfer is complete */
+static volatile bool tftDone = true;
+
+/** Source of next DMA cycle, and pixels not yet started */
+static const uint16_t *tftNext;
+static uint32_t       tftRemaining;
+static bool           tftIncrement;
+
+/** Source of solid fills, must remain 'live' during transfer */
+static uint16_t tftFillColor;
+
+/***************************************************************************//**
+ * @brief
+ *   Callback invoked from DMA interrupt handler when a DMA cycle has
+ *   completed. Starts next cycle of transfer, if any.
+ ******************************************************************************/
+static void TFTDMA_cb(unsigned int channel, bool primary, void *user)
+{
+  uint32_t count;
+
+  (void)primary;                            /* Unused parameter */
+  (void)user;                               /* Unused parameter */
+
+  if (tftRemaining)
+  {
+    count = tftRemaining;
+    if (count > TFTDMA_MAX_TRANSFERS)
+    {
+      count = TFTDMA_MAX_TRANSFERS;
+    }
+
+    DMA_ActivateAuto(channel,
+                     true,
+                     (void *)tftData,
+                     (void *)tftNext,
+                     count - 1);
+    if (tftIncrement)
+    {
+      tftNext += count;
+    }
+    tftRemaining -= count;
+  }
+  else
+  {
+    tftDone = true;
+  }
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Start transfer to display, after previous transfer has completed.
+ ******************************************************************************/
+static void TFTDMA_start(const uint16_t *src, uint32_t pixels, bool increment)
+{
+  DMA_CfgDescr_TypeDef descrCfg;
+
+  /* Descriptor is reconfigured only when switching between fill and blit */
+  if (increment != tftIncrement)
+  {
+    descrCfg.dstInc  = dmaDataIncNone;
+    descrCfg.srcInc  = increment ? dmaDataInc2 : dmaDataIncNone;
+    descrCfg.size    = dmaDataSize2;
+    descrCfg.arbRate = dmaArbitrate1;
+    descrCfg.hprot   = 0;
+    DMA_CfgDescr(TFTDMA_CHANNEL, true, &descrCfg);
+    tftIncrement = increment;
+  }
+
+  tftDone      = false;
+  tftNext      = src;
+  tftRemaining = pixels;
+  TFTDMA_cb(TFTDMA_CHANNEL, true, NULL);
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Initialize DMA for transfers to display.
+ *
+ * @param[in] dataReg
+ *   Address of display data register, BC_SSD2119_BASE + 2.
+ ******************************************************************************/
+void TFTDMA_init(volatile uint16_t *dataReg)
+{
+  DMA_Init_TypeDef       dmaInit;
+  DMA_CfgChannel_TypeDef chnlCfg;
+  DMA_CfgDescr_TypeDef   descrCfg;
+
+  tftData = dataReg;
+
+  CMU_ClockEnable(cmuClock_DMA, true);
+
+  dmaInit.hprot        = 0;
+  dmaInit.controlBlock = dmaControlBlock;
+  DMA_Init(&dmaInit);
+
+  tftCb.cbFunc  = TFTDMA_cb;
+  tftCb.userPtr = NULL;
+
+  /* Memory to memory transfer, no peripheral request */
+  chnlCfg.highPri   = false;
+  chnlCfg.enableInt = true;
+  chnlCfg.select    = 0;
+  chnlCfg.cb        = &tftCb;
+  DMA_CfgChannel(TFTDMA_CHANNEL, &chnlCfg);
+
+  /* Display data register is at a fixed address, start out with blits */
+  descrCfg.dstInc  = dmaDataIncNone;
+  descrCfg.srcInc  = dmaDataInc2;
+  descrCfg.size    = dmaDataSize2;
+  descrCfg.arbRate = dmaArbitrate1;
+  descrCfg.hprot   = 0;
+  DMA_CfgDescr(TFTDMA_CHANNEL, true, &descrCfg);
+  tftIncrement = true;
+  tftDone      = true;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Write the same color to a number of pixels. The source is not
+ *   incremented, so a fill of any size needs no buffer.
+ *
+ * @param[in] color
+ *   RGB565 color.
+ *
+ * @param[in] pixels
+ *   Number of pixels to write.
+ ******************************************************************************/
+void TFTDMA_fill(uint16_t color, uint32_t pixels)
+{
+  TFTDMA_wait();
+  if (pixels == 0)
+  {
+    return;
+  }
+
+  tftFillColor = color;
+  TFTDMA_start(&tftFillColor, pixels, false);
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Copy pixels from RAM to display. The source must not be modified until
+ *   the transfer has completed.
+ *
+ * @param[in] src
+ *   RGB565 pixels.
+ *
+ * @param[in] pixels
+ *   Number of pixels to write.
+ ******************************************************************************/
+void TFTDMA_blit(const uint16_t *src, uint32_t pixels)
+{
+  TFTDMA_wait();
+  if (pixels == 0)
+  {
+    return;
+  }
+
+  TFTDMA_start(src, pixels, true);
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Check if a transfer to display is in progress.
+ ******************************************************************************/
+bool TFTDMA_busy(void)
+{
+  return !tftDone;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Wait for transfer to display to complete, sleeping in EM1.
+ ******************************************************************************/
+void TFTDMA_wait(void)
+{
+  /* Interrupts are disabled while checking the flag, so that DMA */
+  /* completion in between still wakes up the core, it is serviced when */
+  /* interrupts are enabled again. */
+  INT_Disable();
+  while (!tftDone)
+  {
+    EMU_EnterEM1();
+    INT_Enable();
+    INT_Disable();
+  }
+  INT_Enable();
+}
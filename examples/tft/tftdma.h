@@ -0,0 +1,78 @@
+/**************************************************************************//**
+ * @file
+ * @brief DMA transfers to SSD2119 TFT display
+ * @author Energy Micro AS
+ * @version 3.20.0
+ ******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 Energy Micro AS, http://www.energymicro.com</b>
+ *******************************************************************************
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ * 4. The source and compiled code may only be used on Energy Micro "EFM32"
+ *    microcontrollers and "EFR4" radios.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: Energy Micro AS has no
+ * obligation to support this Software. Energy Micro AS is providing the
+ * Software "AS IS", with no express or implied warranties of any kind,
+ * including, but not limited to, any implied warranties of merchantability
+ * or fitness for any particular purpose or warranties against infringement
+ * of any proprietary rights of a third party.
+ *
+ * Energy Micro AS will not be liable for any consequential, incidental, or
+ * special damages, or any other relief, or for any claim by any third party,
+ * arising from your use of this Software.
+ *
+ *****************************************************************************/
+#ifndef __TFTDMA_H
+#define __TFTDMA_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+   DMA driven solid fills and block copies to the SSD2119 display.
+
+   Only usable when the display data register is memory mapped through
+   EBI (BSP_BC_CTRL_EBI). The caller positions the display write pointer
+   first, e.g. by setting a DMD clipping area and writing the first pixel
+   through DMD, after which pixels are written by DMA, 1024 per DMA cycle.
+
+   Transfers run in the background. A new transfer, and any other display
+   access, must wait for the previous one to complete with TFTDMA_wait(),
+   which sleeps in EM1. TFTDMA_fill() and TFTDMA_blit() wait by themselves.
+*/
+
+/** DMA channel used for display transfers */
+#define TFTDMA_CHANNEL        0
+
+/** Max number of pixels in one DMA cycle */
+#define TFTDMA_MAX_TRANSFERS  1024
+
+/** Convert 24 bit 0xRRGGBB color, as used by GLIB, to RGB565 */
+#define TFTDMA_RGB565(c) \
+  ((uint16_t)((((c) >> 8) & 0xf800) | (((c) >> 5) & 0x07e0) | (((c) >> 3) & 0x001f)))
+
+void TFTDMA_init(volatile uint16_t *dataReg);
+void TFTDMA_fill(uint16_t color, uint32_t pixels);
+void TFTDMA_blit(const uint16_t *src, uint32_t pixels);
+bool TFTDMA_busy(void);
+void TFTDMA_wait(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -45,10 +45,18 @@
 #include "dmd/ssd2119/dmd_ssd2119.h"
 
 #include "tftdraw.h"
+#include "tftcomp.h"
+#include "tftdma.h"
+#include "tftglyph.h"
+#include "tftasset.h"
+#include "bpmfontrle.h"
 
 /** Graphics context */
 GLIB_Context gc;
 
+/** Rectangles of the pattern being drawn */
+static TFTCOMP_Stack_TypeDef rectStack;
+
 /**************************************************************************//**
  * @brief Really simple and silly random number generator
  * @param limit Upper limit of return value
@@ -63,13 +71,57 @@ static int randomGenerator(int limit)
 }
 
 
+/**************************************************************************//**
+ * @brief Draw one visible part of the rectangle pattern
+ * @param compRect Rectangle resolved by compositor
+ *****************************************************************************/
+static void TFT_drawRect(const TFTCOMP_Rect_TypeDef *compRect)
+{
+#if defined(BSP_BC_CTRL_EBI)
+  uint32_t width  = compRect->xMax - compRect->xMin + 1;
+  uint32_t height = compRect->yMax - compRect->yMin + 1;
+  uint32_t color  = compRect->color;
+
+  /* Display must not be accessed while previous fill is in progress */
+  TFTDMA_wait();
+
+  /* Position display write pointer by drawing first pixel through DMD, */
+  /* the rest is filled by DMA while the next rectangle is resolved */
+  DMD_setClippingArea(compRect->xMin, compRect->yMin, width, height);
+  DMD_writeColor(0, 0, (color >> 16) & 0xff, (color >> 8) & 0xff, color & 0xff, 1);
+  TFTDMA_fill(TFTDMA_RGB565(color), (width * height) - 1);
+#else
+  GLIB_Rectangle rect;
+
+  /* Display accessed through board controller SPI, no DMA to display */
+  rect.xMin          = compRect->xMin;
+  rect.yMin          = compRect->yMin;
+  rect.xMax          = compRect->xMax;
+  rect.yMax          = compRect->yMax;
+  gc.foregroundColor = compRect->color;
+  GLIB_drawRectFilled(&gc, &rect);
+#endif
+}
+
+/**************************************************************************//**
+ * @brief Wait for rectangles drawn by TFT_drawRect() to complete
+ *****************************************************************************/
+static void TFT_drawRectDone(void)
+{
+#if defined(BSP_BC_CTRL_EBI)
+  TFTDMA_wait();
+  GLIB_resetDisplayClippingArea(&gc);
+#endif
+}
+
 /**************************************************************************//**
  * @brief Clears/updates entire background ready to be drawn
  *****************************************************************************/
 void TFT_displayUpdate(void)
 {
-  int            i, tmp;
-  GLIB_Rectangle rect = {
+  int                  i;
+  TFTCOMP_Rect_TypeDef compRect;
+  GLIB_Rectangle       rect = {
     .xMin =   0,
     .yMin =   0,
     .xMax = 319,
@@ -80,29 +132,28 @@ void TFT_displayUpdate(void)
   GLIB_resetDisplayClippingArea(&gc);
 
   /* Generate "wild" rectangle pattern  */
+  TFTCOMP_init(&rectStack);
   for (i = 0; i < 20; i++)
   {
-    rect.xMin = randomGenerator(320);
-    rect.xMax = randomGenerator(320);
-    rect.yMin = randomGenerator(230) + 10;
-    rect.yMax = randomGenerator(230) + 10;
-    if (rect.xMin > rect.xMax)
-    {
-      tmp       = rect.xMin;
-      rect.xMin = rect.xMax;
-      rect.xMax = tmp;
-    }
-    if (rect.yMin > rect.yMax)
-    {
-      tmp       = rect.yMin;
-      rect.yMin = rect.yMax;
-      rect.yMax = tmp;
-    }
-    gc.foregroundColor = GLIB_rgbColor(128 + randomGenerator(127),
-                                       randomGenerator(200),
-                                       randomGenerator(255));
-    GLIB_drawRectFilled(&gc, &rect);
+    compRect.xMin  = randomGenerator(320);
+    compRect.xMax  = randomGenerator(320);
+    compRect.yMin  = randomGenerator(230) + 10;
+    compRect.yMax  = randomGenerator(230) + 10;
+    compRect.color = GLIB_rgbColor(128 + randomGenerator(127),
+                                   randomGenerator(200),
+                                   randomGenerator(255));
+    TFTCOMP_add(&rectStack, &compRect);
   }
+
+  /* Only the visible parts of the overlapping rectangles are drawn, */
+  /* writing each pixel once */
+  TFTCOMP_draw(&rectStack, TFT_drawRect);
+  TFT_drawRectDone();
+
+  /* Digits image in lower right corner, decoded from compressed flash */
+  /* data one row at a time */
+  TFTASSET_draw(&bpmfontAsset, 316 - bpmfontAsset.width, 236 - bpmfontAsset.height);
+  GLIB_resetDisplayClippingArea(&gc);
 }
 
 /**************************************************************************//**
@@ -112,11 +163,12 @@ void TFT_init(void)
 {
   static char    *efm32_hello = "EFM32 @ 32MHz / SSD2119 TFT demo\n";
   EMSTATUS       status;
-  GLIB_Rectangle rect = {
-    .xMin =   0,
-    .yMin =   0,
-    .xMax = 319,
-    .yMax = 239,
+  TFTCOMP_Rect_TypeDef background = {
+    .xMin  =   0,
+    .yMin  =   0,
+    .xMax  = 319,
+    .yMax  = 239,
+    .color =   0,
   };
 
   /* Initialize graphics - abort on failure */
@@ -126,17 +178,24 @@ void TFT_init(void)
   /* Make sure display is configured with correct rotation */
   if ((status == DMD_OK)) DMD_flipDisplay(1,1);
 
+#if defined(BSP_BC_CTRL_EBI)
+  /* Display data register is EBI mapped, DMA may write to it directly */
+  TFTDMA_init((volatile uint16_t *)(BC_SSD2119_BASE + 2));
+#endif
+
   /* Init graphics context - abort on failure */
   status = GLIB_contextInit(&gc);
   if (status != GLIB_OK) while (1) ;
+  TFTGLYPH_init();
 
   /* Clear framebuffer */
-  gc.foregroundColor = GLIB_rgbColor(20, 40, 20);
-  GLIB_drawRectFilled(&gc, &rect);
+  background.color = GLIB_rgbColor(20, 40, 20);
+  TFT_drawRect(&background);
+  TFT_drawRectDone();
 
   /* Update drawing regions of picture  */
   gc.foregroundColor = GLIB_rgbColor(200, 200, 200);
-  GLIB_drawString(&gc, efm32_hello, strlen(efm32_hello), 0, 0, 1);
+  TFTGLYPH_drawString(&gc, efm32_hello, strlen(efm32_hello), 0, 0, 1);
 
   TFT_displayUpdate();
 }
@@ -0,0 +1,262 @@
+/**************************************************************************//**
+ * @file
+ * @brief Cached glyph text drawing for the TFT display
+ * @author Energy Micro AS
+ * @version 3.20.0
+ ******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 Energy Micro AS, http://www.energymicro.com</b>
+ *******************************************************************************
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ * 4. The source and compiled code may only be used on Energy Micro "EFM32"
+ *    microcontrollers and "EFR4" radios.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: Energy Micro AS has no
+ * obligation to support this Software. Energy Micro AS is providing the
+ * Software "AS IS", with no express or implied warranties of any kind,
+ * including, but not limited to, any implied warranties of merchantability
+ * or fitness for any particular purpose or warranties against infringement
+ * of any proprietary rights of a third party.
+ *
+ * Energy Micro AS will not be liable for any consequential, incidental, or
+ * special damages, or any other relief, or for any claim by any third party,
+ * arising from your use of this Software.
+ *
+ *****************************************************************************/
+#include <string.h>
+#include "glib/glib.h"
+#include "glib/glib_font.h"
+#include "dmd/ssd2119/dmd_ssd2119.h"
+#include "tftglyph.h"
+
+/** Bytes per pixel written by DMD_writeData() */
+#define TFTGLYPH_BPP  3
+
+/** Cached glyph, expanded to display pixels */
+typedef struct
+{
+  bool     valid;                  /**< Glyph holds expanded character */
+  char     c;                      /**< Character */
+  uint32_t block;                  /**< Last block of text using glyph */
+  uint8_t  pixels[TFTGLYPH_HEIGHT][TFTGLYPH_WIDTH * TFTGLYPH_BPP];
+} TFTGLYPH_Glyph_TypeDef;
+
+/** Glyph cache, fully associative */
+static TFTGLYPH_Glyph_TypeDef cache[TFTGLYPH_CACHE_SIZE];
+
+/** Next cache entry to replace, round robin */
+static uint32_t nextReplace;
+
+/** Current block of text, its glyphs must not be replaced */
+static uint32_t currentBlock;
+
+/** Colors the cached glyphs were expanded with */
+static uint32_t cacheForeground;
+static uint32_t cacheBackground;
+
+/** One pixel row of a string, last glyph may be cut by the display edge */
+static uint8_t rowBuffer[(TFTGLYPH_MAX_WIDTH + TFTGLYPH_WIDTH) * TFTGLYPH_BPP];
+
+/***************************************************************************//**
+ * @brief
+ *   Store 24 bit color as display pixel.
+ ******************************************************************************/
+static void TFTGLYPH_setPixel(uint8_t *p, uint32_t color)
+{
+  p[0] = (uint8_t)(color >> 16);
+  p[1] = (uint8_t)(color >> 8);
+  p[2] = (uint8_t)color;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Get glyph from cache, expanding it from the GLIB font if not present.
+ *   Characters outside the font are drawn as background.
+ * @return
+ *   Glyph, or NULL if all cache entries are used by the current block.
+ ******************************************************************************/
+static const TFTGLYPH_Glyph_TypeDef *TFTGLYPH_get(char c)
+{
+  TFTGLYPH_Glyph_TypeDef *glyph = NULL;
+  uint32_t               fontIdx;
+  uint32_t               bits;
+  uint32_t               i;
+  int                    row, col;
+  bool                   valid;
+
+  for (i = 0; i < TFTGLYPH_CACHE_SIZE; i++)
+  {
+    if (cache[i].valid && (cache[i].c == c))
+    {
+      cache[i].block = currentBlock;
+      return &cache[i];
+    }
+  }
+
+  /* Replace a glyph not used by the current block */
+  for (i = 0; (i < TFTGLYPH_CACHE_SIZE) && !glyph; i++)
+  {
+    if (!cache[nextReplace].valid || (cache[nextReplace].block != currentBlock))
+    {
+      glyph = &cache[nextReplace];
+    }
+    nextReplace = (nextReplace + 1) % TFTGLYPH_CACHE_SIZE;
+  }
+  if (!glyph)
+  {
+    return NULL;
+  }
+
+  /* Same font layout as used by GLIB_drawChar() */
+  valid   = ((uint8_t)c >= FONT_ASCII_START) &&
+            ((uint8_t)c < (FONT_ASCII_START + FONT_CHARACTERS));
+  fontIdx = (uint8_t)c - FONT_ASCII_START;
+  for (row = 0; row < TFTGLYPH_HEIGHT; row++)
+  {
+    bits = valid ? fontBits[fontIdx] : 0;
+    for (col = 0; col < TFTGLYPH_WIDTH; col++)
+    {
+      TFTGLYPH_setPixel(&glyph->pixels[row][col * TFTGLYPH_BPP],
+                        (bits & (FONT_BITS_MASK << col)) ? cacheForeground : cacheBackground);
+    }
+    fontIdx += FONT_BITS_LINE_SKIP;
+  }
+  glyph->valid = true;
+  glyph->c     = c;
+  glyph->block = currentBlock;
+  return glyph;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Empty glyph cache.
+ ******************************************************************************/
+void TFTGLYPH_init(void)
+{
+  int i;
+
+  for (i = 0; i < TFTGLYPH_CACHE_SIZE; i++)
+  {
+    cache[i].valid = false;
+  }
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Draw string, same parameters and result as GLIB_drawString(). A newline
+ *   character starts a new line of text below the first character.
+ *
+ * @param[in] pContext
+ *   Graphics context, providing colors.
+ *
+ * @param[in] pString
+ *   String to draw.
+ *
+ * @param[in] sLength
+ *   Number of characters in string.
+ *
+ * @param[in] x0
+ *   Start column.
+ *
+ * @param[in] y0
+ *   Start row.
+ *
+ * @param[in] opaque
+ *   Draw background of glyphs if true, only foreground if false.
+ *
+ * @return
+ *   GLIB_OK, or error code from DMD.
+ ******************************************************************************/
+EMSTATUS TFTGLYPH_drawString(GLIB_Context *pContext, const char *pString,
+                             uint32_t sLength, int32_t x0, int32_t y0,
+                             bool opaque)
+{
+  const TFTGLYPH_Glyph_TypeDef *glyphs[(TFTGLYPH_MAX_WIDTH / TFTGLYPH_WIDTH) + 1];
+  EMSTATUS status = GLIB_OK;
+  uint32_t start, end, n, i, done, count;
+  int32_t  x, width, height;
+  int      row;
+
+  if (!opaque)
+  {
+    return GLIB_drawString(pContext, (char *)pString, sLength, x0, y0, opaque);
+  }
+
+  /* Colors changed, cached glyphs are no longer valid */
+  if ((pContext->foregroundColor != cacheForeground) ||
+      (pContext->backgroundColor != cacheBackground))
+  {
+    cacheForeground = pContext->foregroundColor;
+    cacheBackground = pContext->backgroundColor;
+    TFTGLYPH_init();
+  }
+
+  for (start = 0; (start < sLength) && (status == GLIB_OK); start = end + 1)
+  {
+    /* Find end of this line of text */
+    for (end = start; (end < sLength) && (pString[end] != '\n'); end++)
+      ;
+
+    /* Pixels beyond the right and bottom edges of the display are not drawn */
+    n = end - start;
+    if ((x0 < 0) || (y0 < 0) ||
+        (x0 >= TFTGLYPH_MAX_WIDTH) || (y0 >= TFTGLYPH_MAX_HEIGHT))
+    {
+      n = 0;
+    }
+    else if (n > (uint32_t)((TFTGLYPH_MAX_WIDTH - x0 + TFTGLYPH_WIDTH - 1) / TFTGLYPH_WIDTH))
+    {
+      n = (TFTGLYPH_MAX_WIDTH - x0 + TFTGLYPH_WIDTH - 1) / TFTGLYPH_WIDTH;
+    }
+    height = TFTGLYPH_MAX_HEIGHT - y0;
+    if (height > TFTGLYPH_HEIGHT)
+    {
+      height = TFTGLYPH_HEIGHT;
+    }
+
+    /* Draw line in blocks of characters whose glyphs all fit in cache, */
+    /* usually the whole line */
+    for (done = 0; (done < n) && (status == GLIB_OK); done += count)
+    {
+      currentBlock++;
+      for (count = 0; (done + count) < n; count++)
+      {
+        glyphs[count] = TFTGLYPH_get(pString[start + done + count]);
+        if (!glyphs[count])
+          break;
+      }
+
+      x     = x0 + (done * TFTGLYPH_WIDTH);
+      width = count * TFTGLYPH_WIDTH;
+      if (width > (TFTGLYPH_MAX_WIDTH - x))
+      {
+        width = TFTGLYPH_MAX_WIDTH - x;
+      }
+
+      /* One display window for the block, one write per pixel row */
+      status = DMD_setClippingArea(x, y0, width, height);
+      for (row = 0; (row < height) && (status == DMD_OK); row++)
+      {
+        for (i = 0; i < count; i++)
+        {
+          memcpy(&rowBuffer[i * TFTGLYPH_WIDTH * TFTGLYPH_BPP],
+                 glyphs[i]->pixels[row], TFTGLYPH_WIDTH * TFTGLYPH_BPP);
+        }
+        status = DMD_writeData(0, row, rowBuffer, width);
+      }
+    }
+    y0 += TFTGLYPH_HEIGHT;
+  }
+
+  GLIB_resetDisplayClippingArea(pContext);
+  return status;
+}
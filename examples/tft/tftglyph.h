@@ -0,0 +1,84 @@
+/**************************************************************************//**
+ * @file
+ * @brief Cached glyph text drawing for the TFT display
+ * @author Energy Micro AS
+ * @version 3.20.0
+ ******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 Energy Micro AS, http://www.energymicro.com</b>
+ *******************************************************************************
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ * 4. The source and compiled code may only be used on Energy Micro "EFM32"
+ *    microcontrollers and "EFR4" radios.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: Energy Micro AS has no
+ * obligation to support this Software. Energy Micro AS is providing the
+ * Software "AS IS", with no express or implied warranties of any kind,
+ * including, but not limited to, any implied warranties of merchantability
+ * or fitness for any particular purpose or warranties against infringement
+ * of any proprietary rights of a third party.
+ *
+ * Energy Micro AS will not be liable for any consequential, incidental, or
+ * special damages, or any other relief, or for any claim by any third party,
+ * arising from your use of this Software.
+ *
+ *****************************************************************************/
+#ifndef __TFTGLYPH_H
+#define __TFTGLYPH_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "glib/glib.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+   Cached text drawing for the TFT display.
+
+   GLIB_drawString() draws every pixel of every character as a separate
+   display access. Here, characters are expanded once to display pixels
+   for the current foreground and background colors, and kept in a small
+   cache. A string is then assembled one pixel row at a time from the
+   cached glyphs, and each row written with a single DMD_writeData() call,
+   8 calls for an 8 pixel high line of text. Lines using more different
+   characters than the cache holds are drawn in several blocks.
+
+   Glyphs are stored in the 24 bit pixel format taken by DMD_writeData(),
+   so rows are assembled by plain copying.
+
+   Only opaque text is drawn this way, transparent text is passed on to
+   GLIB_drawString().
+*/
+
+/** Glyph size in pixels, as the GLIB font */
+#define TFTGLYPH_WIDTH   8
+#define TFTGLYPH_HEIGHT  8
+
+/** Number of cached glyphs, 192 bytes each */
+#define TFTGLYPH_CACHE_SIZE  16
+
+/** Display size in pixels, text is clipped to it */
+#define TFTGLYPH_MAX_WIDTH   320
+#define TFTGLYPH_MAX_HEIGHT  240
+
+void TFTGLYPH_init(void);
+EMSTATUS TFTGLYPH_drawString(GLIB_Context *pContext, const char *pString,
+                             uint32_t sLength, int32_t x0, int32_t y0,
+                             bool opaque);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
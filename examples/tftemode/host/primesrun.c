@@ -0,0 +1,135 @@
+/**************************************************************************//**
+ * @file
+ * @brief Host (Linux) runner for prime number kernels
+ * @author Energy Micro AS
+ * @version 3.20.0
+ ******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 Energy Micro AS, http://www.energymicro.com</b>
+ *******************************************************************************
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ * 4. The source and compiled code may only be used on Energy Micro "EFM32"
+ *    microcontrollers and "EFR4" radios.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: Energy Micro AS has no
+ * obligation to support this Software. Energy Micro AS is providing the
+ * Software "AS IS", with no express or implied warranties of any kind,
+ * including, but not limited to, any implied warranties of merchantability
+ * or fitness for any particular purpose or warranties against infringement
+ * of any proprietary rights of a third party.
+ *
+ * Energy Micro AS will not be liable for any consequential, incidental, or
+ * special damages, or any other relief, or for any claim by any third party,
+ * arising from your use of this Software.
+ *
+ *****************************************************************************/
+/*
+   Host (Linux) runner for the prime number kernels of the energy mode 0
+   demos (primes.c).
+
+   Checks that all kernels find the same primes, and times each one
+   finding the first primes as the demo does, reporting primes per second
+   and nanoseconds per prime. The legacy kernel is slow for many primes,
+   and is only run up to 4096.
+
+   Usage: primesrun [count]
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include "primes.h"
+
+/** Min time to run each kernel */
+#define MIN_SECONDS  0.5
+
+/** Largest count run with legacy kernel */
+#define LEGACY_MAX   4096
+
+/***************************************************************************//**
+ * @brief Main function
+ ******************************************************************************/
+int main(int argc, char *argv[])
+{
+  uint32_t *reference;
+  uint32_t *primes;
+  uint32_t count = (argc > 1) ? (uint32_t)atoi(argv[1]) : 256;
+  uint32_t runs;
+  uint32_t i;
+  double   seconds;
+  clock_t  start;
+  int      kernel;
+  int      errors = 0;
+
+  if (count < 1)
+  {
+    count = 1;
+  }
+  reference = malloc(count * sizeof(uint32_t));
+  primes    = malloc(count * sizeof(uint32_t));
+  if (!reference || !primes)
+  {
+    fprintf(stderr, "Out of memory\n");
+    return 1;
+  }
+  PRIMES_find(primesKernelTrial, reference, count);
+
+  printf("First %u primes, largest %u\n\n", count, reference[count - 1]);
+  printf("%-8s %10s %14s %12s\n", "kernel", "runs", "primes/s", "ns/prime");
+  for (kernel = 0; kernel < PRIMES_KERNELS; kernel++)
+  {
+    if ((kernel == primesKernelLegacy) && (count > LEGACY_MAX))
+    {
+      printf("%-8s %10s\n", PRIMES_name(kernel), "skipped");
+      continue;
+    }
+
+    memset(primes, 0, count * sizeof(uint32_t));
+    PRIMES_find(kernel, primes, count);
+    for (i = 0; (i < count) && (primes[i] == reference[i]); i++)
+      ;
+    if (i < count)
+    {
+      printf("FAIL: %s prime %u is %u, expected %u\n",
+             PRIMES_name(kernel), i, primes[i], reference[i]);
+      errors++;
+      continue;
+    }
+
+    /* Double runs until timing is long enough */
+    for (runs = 1; ; runs *= 2)
+    {
+      start = clock();
+      for (i = 0; i < runs; i++)
+      {
+        PRIMES_find(kernel, primes, count);
+      }
+      seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+      if (seconds >= MIN_SECONDS)
+        break;
+    }
+    printf("%-8s %10u %14.0f %12.1f\n", PRIMES_name(kernel), runs,
+           (double)count * runs / seconds, seconds * 1e9 / ((double)count * runs));
+  }
+
+  /* Known values */
+  if ((count >= 64) && (reference[63] != 311))
+  {
+    printf("FAIL: 64th prime is %u, expected 311\n", reference[63]);
+    errors++;
+  }
+
+  printf("%s\n", errors ? "FAILED" : "All kernels agree");
+  return errors ? 1 : 0;
+}
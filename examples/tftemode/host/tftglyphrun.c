@@ -0,0 +1,250 @@
+/**************************************************************************//**
+ * @file
+ * @brief Host (Linux) runner for cached glyph text drawing
+ * @author Energy Micro AS
+ * @version 3.20.0
+ ******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 Energy Micro AS, http://www.energymicro.com</b>
+ *******************************************************************************
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ * 4. The source and compiled code may only be used on Energy Micro "EFM32"
+ *    microcontrollers and "EFR4" radios.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: Energy Micro AS has no
+ * obligation to support this Software. Energy Micro AS is providing the
+ * Software "AS IS", with no express or implied warranties of any kind,
+ * including, but not limited to, any implied warranties of merchantability
+ * or fitness for any particular purpose or warranties against infringement
+ * of any proprietary rights of a third party.
+ *
+ * Energy Micro AS will not be liable for any consequential, incidental, or
+ * special damages, or any other relief, or for any claim by any third party,
+ * arising from your use of this Software.
+ *
+ *****************************************************************************/
+/*
+   Host (Linux) runner for the cached glyph text drawing.
+
+   Draws the text of the energy mode demo screen to the host emulation of
+   the display and GLIB (host/dmdemu.c, host/glibemu.c at the top of the
+   kit), once per pixel as GLIB_drawString() does, and once through the
+   glyph cache (tftglyph.c). Checks that both give
+   the same image, and reports display accesses and time per string for
+   both. Also checks a multi-line string and a line using more different
+   characters than the cache holds.
+
+   Usage: tftglyphrun [frames]
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include "glib/glib.h"
+#include "dmd/ssd2119/dmd_ssd2119.h"
+#include "dmdemu.h"
+#include "tftglyph.h"
+
+/** Text of the demo screen, as in tftemode.c */
+static char *description[] =
+{
+  "Use joystick Up and Down to select     ",
+  "various energy mode demos.             ",
+  "Press PB1 to activate demo.            ",
+  "After activition, press AEM button to  ",
+  "go back to board control and AEM screen",
+  "The EFM32 display will not be          ",
+  "refreshed until restart.               ",
+  "Reset MCU to try other demos.          ",
+  "Make sure debugger is disconnected.    ",
+};
+static const int32_t descriptionY[] = { 0, 8, 24, 40, 48, 64, 72, 88, 104 };
+
+static char *selected = "Energy Mode 0 - 32MHz / Primes";
+
+/** Extra checks */
+static char *multiLine  = "First line\nSecond, longer line\n\nFourth";
+static char *manyChars  = "ABCDEFGHIJKLMNOPQRSTUVWXYZ abcdefghijklmnopqrstuvwxyz";
+
+#define STRINGS  (10)
+
+/** Estimated display bus writes on target: setting the display window
+    writes 4 registers, each write call first sets the 2 address registers
+    and the GRAM index, then writes one word per pixel. A register write is
+    an index and a data write. */
+#define BUS_WINDOW  8
+#define BUS_CALL    5
+
+/** Image drawn per pixel, for comparison */
+static uint16_t reference[DMDEMU_HEIGHT][DMDEMU_WIDTH];
+
+static GLIB_Context gc;
+
+typedef EMSTATUS (*drawString_TypeDef)(GLIB_Context *pContext, char *pString,
+                                       uint32_t sLength, int32_t x0,
+                                       int32_t y0, bool opaque);
+
+/***************************************************************************//**
+ * @brief Draw through glyph cache, with GLIB_drawString() parameters.
+ ******************************************************************************/
+static EMSTATUS drawCached(GLIB_Context *pContext, char *pString,
+                           uint32_t sLength, int32_t x0, int32_t y0,
+                           bool opaque)
+{
+  return TFTGLYPH_drawString(pContext, pString, sLength, x0, y0, opaque);
+}
+
+/***************************************************************************//**
+ * @brief Draw demo screen text, as tftemode.c does on a control transfer.
+ ******************************************************************************/
+static void drawScreen(drawString_TypeDef drawString)
+{
+  int i;
+
+  gc.foregroundColor = GLIB_rgbColor(200, 200, 200);
+  gc.backgroundColor = GLIB_rgbColor(0, 0, 0);
+  for (i = 0; i < 9; i++)
+  {
+    if (i == 7)
+    {
+      gc.foregroundColor = GLIB_rgbColor(200, 200, 100);
+    }
+    drawString(&gc, description[i], strlen(description[i]), 0, descriptionY[i], 1);
+  }
+  gc.foregroundColor = GLIB_rgbColor(100, 200, 100);
+  gc.backgroundColor = GLIB_rgbColor(50, 50, 50);
+  drawString(&gc, selected, strlen(selected), 40, 150, 1);
+}
+
+/***************************************************************************//**
+ * @brief Draw extra check strings.
+ ******************************************************************************/
+static void drawExtra(drawString_TypeDef drawString)
+{
+  gc.foregroundColor = GLIB_rgbColor(255, 255, 255);
+  gc.backgroundColor = GLIB_rgbColor(0, 0, 128);
+  drawString(&gc, multiLine, strlen(multiLine), 16, 170, 1);
+  drawString(&gc, manyChars, strlen(manyChars), 0, 210, 1);
+  /* Clipped at the right and bottom edges of the display */
+  drawString(&gc, manyChars, strlen(manyChars), 100, 236, 1);
+}
+
+/***************************************************************************//**
+ * @brief Clear display to a color never drawn, and reset counters.
+ ******************************************************************************/
+static void clearDisplay(void)
+{
+  DMDEMU_reset();
+  DMD_init(0, 0);
+  memset(dmdemuFramebuffer, 0x5a, sizeof(dmdemuFramebuffer));
+}
+
+/***************************************************************************//**
+ * @brief Time frames of the demo screen text.
+ ******************************************************************************/
+static double timeScreen(drawString_TypeDef drawString, int frames)
+{
+  clock_t start;
+  int     i;
+
+  start = clock();
+  for (i = 0; i < frames; i++)
+  {
+    drawScreen(drawString);
+  }
+  return (double)(clock() - start) / CLOCKS_PER_SEC;
+}
+
+/***************************************************************************//**
+ * @brief DMD_writeData() and DMD_writeColor() calls.
+ ******************************************************************************/
+static uint32_t writeCalls(const DMDEMU_Count_TypeDef *count)
+{
+  return count->transactions - count->windows;
+}
+
+/***************************************************************************//**
+ * @brief Estimated display bus writes.
+ ******************************************************************************/
+static uint32_t busWrites(const DMDEMU_Count_TypeDef *count)
+{
+  return (count->windows * BUS_WINDOW) + (writeCalls(count) * BUS_CALL) +
+         count->pixels;
+}
+
+/***************************************************************************//**
+ * @brief Print display accesses per screen.
+ ******************************************************************************/
+static void printCount(const char *name, const DMDEMU_Count_TypeDef *count,
+                       double seconds, int frames)
+{
+  printf("%-10s %8lu %8lu %8lu %10lu %10.2f\n", name,
+         (unsigned long)count->windows, (unsigned long)writeCalls(count),
+         (unsigned long)count->pixels, (unsigned long)busWrites(count),
+         seconds * 1e6 / ((double)frames * STRINGS));
+}
+
+/***************************************************************************//**
+ * @brief Main function
+ ******************************************************************************/
+int main(int argc, char *argv[])
+{
+  DMDEMU_Count_TypeDef perPixel;
+  DMDEMU_Count_TypeDef cached;
+  double               perPixelTime, cachedTime;
+  int                  frames = (argc > 1) ? atoi(argv[1]) : 1000;
+  int                  errors = 0;
+
+  if (frames < 1)
+  {
+    frames = 1;
+  }
+
+  clearDisplay();
+  GLIB_contextInit(&gc);
+  TFTGLYPH_init();
+
+  /* Same image both ways */
+  drawScreen(GLIB_drawString);
+  perPixel = dmdemuCount;
+  drawExtra(GLIB_drawString);
+  memcpy(reference, dmdemuFramebuffer, sizeof(reference));
+
+  clearDisplay();
+  drawScreen(drawCached);
+  cached = dmdemuCount;
+  drawExtra(drawCached);
+  if (memcmp(reference, dmdemuFramebuffer, sizeof(reference)) != 0)
+  {
+    printf("FAIL: cached text differs from per pixel text\n");
+    errors++;
+  }
+
+  /* Time per string */
+  perPixelTime = timeScreen(GLIB_drawString, frames);
+  cachedTime   = timeScreen(drawCached, frames);
+
+  printf("Demo screen, %d strings, %d frames\n\n", STRINGS, frames);
+  printf("%-10s %8s %8s %8s %10s %10s\n",
+         "", "windows", "calls", "pixels", "bus writes", "us/string");
+  printCount("per pixel", &perPixel, perPixelTime, frames);
+  printCount("cached", &cached, cachedTime, frames);
+  printf("\nDisplay calls reduced %.1fx, bus writes %.1fx, host time %.1fx\n",
+         (double)writeCalls(&perPixel) / cached.transactions,
+         (double)busWrites(&perPixel) / busWrites(&cached),
+         perPixelTime / cachedTime);
+
+  printf("%s\n", errors ? "FAILED" : "All checks passed");
+  return errors ? 1 : 0;
+}
@@ -0,0 +1,220 @@
+/**************************************************************************//**
+ * @file
+ * @brief Prime number kernels for energy mode demos
+ * @author Energy Micro AS
+ * @version 3.20.0
+ ******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 Energy Micro AS, http://www.energymicro.com</b>
+ *******************************************************************************
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ * 4. The source and compiled code may only be used on Energy Micro "EFM32"
+ *    microcontrollers and "EFR4" radios.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: Energy Micro AS has no
+ * obligation to support this Software. Energy Micro AS is providing the
+ * Software "AS IS", with no express or implied warranties of any kind,
+ * including, but not limited to, any implied warranties of merchantability
+ * or fitness for any particular purpose or warranties against infringement
+ * of any proprietary rights of a third party.
+ *
+ * Energy Micro AS will not be liable for any consequential, incidental, or
+ * special damages, or any other relief, or for any claim by any third party,
+ * arising from your use of this Software.
+ *
+ *****************************************************************************/
+#include <string.h>
+#include "primes.h"
+
+/** Sieve segment, one bit per odd number */
+#define PRIMES_SEGMENT_WORDS  32
+#define PRIMES_SEGMENT_BITS   (PRIMES_SEGMENT_WORDS * 32)
+
+static uint32_t segment[PRIMES_SEGMENT_WORDS];
+
+/** Square of n is below limit, without overflow */
+#define PRIMES_SQUARE_BELOW(n, limit)  (((n) <= 0xffff) && (((n) * (n)) < (limit)))
+
+/***************************************************************************//**
+ * @brief
+ *   Mark odd multiples of prime from start in current segment.
+ ******************************************************************************/
+static void PRIMES_mark(uint32_t prime, uint32_t start, uint32_t low)
+{
+  uint32_t bit;
+
+  for (bit = (start - low) / 2; bit < PRIMES_SEGMENT_BITS; bit += prime)
+  {
+    segment[bit / 32] |= 1UL << (bit % 32);
+  }
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Segmented sieve of odd numbers.
+ *   Each segment is first sieved with the primes of earlier segments.
+ *   Primes found in the segment are then used for the rest of it as they
+ *   are found, as their first odd multiple to mark, p * p, is further on.
+ ******************************************************************************/
+static void PRIMES_sieve(uint32_t *primes, uint32_t count)
+{
+  uint32_t found = 0;
+  uint32_t known;
+  uint32_t low;
+  uint32_t high;
+  uint32_t start;
+  uint32_t bit;
+  uint32_t n;
+  uint32_t i;
+
+  primes[found++] = 2;
+  for (low = 3; found < count; low = high)
+  {
+    /* Segment holds odd numbers low .. high - 2 */
+    high  = low + (2 * PRIMES_SEGMENT_BITS);
+    known = found;
+    memset(segment, 0, sizeof(segment));
+
+    for (i = 1; (i < known) && PRIMES_SQUARE_BELOW(primes[i], high); i++)
+    {
+      /* First odd multiple in segment, not below p * p */
+      start = ((low + primes[i] - 1) / primes[i]) * primes[i];
+      if (!(start & 1))
+      {
+        start += primes[i];
+      }
+      if (start < (primes[i] * primes[i]))
+      {
+        start = primes[i] * primes[i];
+      }
+      PRIMES_mark(primes[i], start, low);
+    }
+
+    for (bit = 0; (bit < PRIMES_SEGMENT_BITS) && (found < count); bit++)
+    {
+      if (!(segment[bit / 32] & (1UL << (bit % 32))))
+      {
+        n               = low + (2 * bit);
+        primes[found++] = n;
+        if (PRIMES_SQUARE_BELOW(n, high))
+        {
+          PRIMES_mark(n, n * n, low);
+        }
+      }
+    }
+  }
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Trial division of odd numbers by the primes found so far, up to the
+ *   square root of the number.
+ ******************************************************************************/
+static void PRIMES_trial(uint32_t *primes, uint32_t count)
+{
+  uint32_t found = 0;
+  uint32_t n;
+  uint32_t i;
+
+  primes[found++] = 2;
+  for (n = 3; found < count; n += 2)
+  {
+    for (i = 1; (i < found) && PRIMES_SQUARE_BELOW(primes[i], n + 1); i++)
+    {
+      if ((n % primes[i]) == 0)
+        break;
+    }
+    if ((i == found) || !PRIMES_SQUARE_BELOW(primes[i], n + 1))
+    {
+      primes[found++] = n;
+    }
+  }
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Trial division by every number up to the number itself, the loop of
+ *   the original demo.
+ ******************************************************************************/
+static void PRIMES_legacy(uint32_t *primes, uint32_t count)
+{
+  uint32_t i, d, n;
+
+  primes[0] = 2;
+  for (i = 1; i < count;)
+  {
+    for (n = primes[i - 1] + 1; ;n++)
+    {
+      for (d = 2; d <= n; d++)
+      {
+        if (n == d)
+        {
+          primes[i] = n;
+          goto nexti;
+        }
+        if (n%d == 0) break;
+      }
+    }
+  nexti:
+    i++;
+  }
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Find the first prime numbers.
+ *
+ * @param[in] kernel
+ *   Algorithm to use.
+ *
+ * @param[out] primes
+ *   The primes found, 2 first.
+ *
+ * @param[in] count
+ *   Number of primes to find.
+ ******************************************************************************/
+void PRIMES_find(PRIMES_Kernel_TypeDef kernel, uint32_t *primes, uint32_t count)
+{
+  if (count == 0)
+  {
+    return;
+  }
+  switch (kernel)
+  {
+  case primesKernelSieve:
+    PRIMES_sieve(primes, count);
+    break;
+  case primesKernelTrial:
+    PRIMES_trial(primes, count);
+    break;
+  default:
+    PRIMES_legacy(primes, count);
+    break;
+  }
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Short name of kernel, for display and trace output.
+ ******************************************************************************/
+const char *PRIMES_name(PRIMES_Kernel_TypeDef kernel)
+{
+  switch (kernel)
+  {
+  case primesKernelSieve:
+    return "sieve";
+  case primesKernelTrial:
+    return "trial";
+  default:
+    return "legacy";
+  }
+}
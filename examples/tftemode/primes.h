@@ -0,0 +1,77 @@
+/**************************************************************************//**
+ * @file
+ * @brief Prime number kernels for energy mode demos
+ * @author Energy Micro AS
+ * @version 3.20.0
+ ******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 Energy Micro AS, http://www.energymicro.com</b>
+ *******************************************************************************
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ * 4. The source and compiled code may only be used on Energy Micro "EFM32"
+ *    microcontrollers and "EFR4" radios.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: Energy Micro AS has no
+ * obligation to support this Software. Energy Micro AS is providing the
+ * Software "AS IS", with no express or implied warranties of any kind,
+ * including, but not limited to, any implied warranties of merchantability
+ * or fitness for any particular purpose or warranties against infringement
+ * of any proprietary rights of a third party.
+ *
+ * Energy Micro AS will not be liable for any consequential, incidental, or
+ * special damages, or any other relief, or for any claim by any third party,
+ * arising from your use of this Software.
+ *
+ *****************************************************************************/
+#ifndef __PRIMES_H
+#define __PRIMES_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+   Prime number kernels for the energy mode 0 demos.
+
+   Each kernel finds the first count primes, in order. They do the same
+   work in different ways, so the energy used per prime can be compared
+   both across clock configurations and across algorithms:
+
+   - Segmented sieve: marks odd composites in a bit array covering 2048
+     numbers at a time, 128 bytes of RAM whatever the number of primes.
+   - Trial division: divides by the primes found so far, up to the square
+     root of the candidate.
+   - Legacy: divides each candidate by every number up to itself, as the
+     original demo did.
+*/
+
+/** Prime number kernel */
+typedef enum
+{
+  primesKernelSieve,       /**< Segmented bit sieve */
+  primesKernelTrial,       /**< Trial division up to square root */
+  primesKernelLegacy,      /**< Trial division by every number */
+} PRIMES_Kernel_TypeDef;
+
+/** Number of kernels */
+#define PRIMES_KERNELS  3
+
+void PRIMES_find(PRIMES_Kernel_TypeDef kernel, uint32_t *primes, uint32_t count);
+const char *PRIMES_name(PRIMES_Kernel_TypeDef kernel);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
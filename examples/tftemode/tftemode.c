@@ -44,9 +44,13 @@
 #include "bsp_trace.h"
 /* Address Mapped TFT mode initialization code */
 #include "tftamapped.h"
+#include "tftglyph.h"
+#include "primes.h"
 #include "rtcdrv.h"
 /* Graphics library */
 #include "glib/glib.h"
+/* Clock and energy mode trace, when built with ETRACE_ENABLE */
+#include "etrace.h"
 
 /** Counts 1ms timeTicks */
 static volatile uint32_t msTicks;
@@ -62,6 +66,12 @@ static GLIB_Context    gc;
 static int eModeDemo = 0;
 static bool runDemo = false;
 
+/** Selected prime number kernel for energy mode 0 demos */
+static PRIMES_Kernel_TypeDef primesKernel = primesKernelSieve;
+
+/** Number of primes found in each run of the prime number kernel */
+#define PRIMES_COUNT  256
+
 /** Available demos */
 static char *eModeDesc[] =
 {
@@ -90,6 +100,16 @@ static char *description[] =
   "refreshed until restart.               ",
   "Reset MCU to try other demos.          ",
   "Make sure debugger is disconnected.    ",
+  "Joystick Left and Right select primes  ",
+  "algorithm, throughput is output on SWO.",
+};
+
+/** Prime number kernels, in PRIMES_Kernel_TypeDef order */
+static char *primesKernelDesc[] =
+{
+  "   Primes: segmented sieve    ",
+  "   Primes: trial division     ",
+  "   Primes: legacy loop        ",
 };
 
 /**************************************************************************//**
@@ -160,6 +180,14 @@ void GPIO_EVEN_IRQHandler(void)
     {
       if(eModeDemo<8) eModeDemo=eModeDemo+1;
     }
+    if(joystick == BC_JOYSTICK_LEFT)
+    {
+      primesKernel = (PRIMES_Kernel_TypeDef)((primesKernel + PRIMES_KERNELS - 1) % PRIMES_KERNELS);
+    }
+    if(joystick == BC_JOYSTICK_RIGHT)
+    {
+      primesKernel = (PRIMES_Kernel_TypeDef)((primesKernel + 1) % PRIMES_KERNELS);
+    }
   }
 
   /* Activate demo */
@@ -188,6 +216,38 @@ void DVK_IRQInit(void)
 }
 
 
+/**************************************************************************//**
+ * @brief Write string to SWO, on ITM stimulus port 0
+ * @param[in] s String
+ *****************************************************************************/
+static void SWO_puts(const char *s)
+{
+  while (*s)
+  {
+    ITM_SendChar(*s++);
+  }
+}
+
+
+/**************************************************************************//**
+ * @brief Write unsigned decimal number to SWO
+ * @param[in] value Number
+ *****************************************************************************/
+static void SWO_putu(uint32_t value)
+{
+  char buffer[11];
+  int  i = sizeof(buffer) - 1;
+
+  buffer[i] = '\0';
+  do
+  {
+    buffer[--i] = '0' + (value % 10);
+    value      /= 10;
+  } while (value);
+  SWO_puts(&buffer[i]);
+}
+
+
 /**************************************************************************//**
  * @brief Run demo calculating prime numbers at given clock frequency
  * @param[in] clock Select oscillator to use
@@ -231,31 +291,34 @@ void Demo_Primes(CMU_Select_TypeDef clock, CMU_HFRCOBand_TypeDef band)
   CMU->LFACLKEN0    = 0x00000000;
   CMU->LFBCLKEN0    = 0x00000000;
   {
-#define PRIM_NUMS 64
-    uint32_t i, d, n;
-    uint32_t primes[PRIM_NUMS];
-
-    /* Find prime numbers forever */
+    static uint32_t primes[PRIMES_COUNT];
+    uint32_t coreFreq = CMU_ClockFreqGet(cmuClock_CORE);
+    uint32_t start, cycles, runs, r;
+
+    /* Time one run to find number of runs in about one second */
+    start = DWT->CYCCNT;
+    PRIMES_find(primesKernel, primes, PRIMES_COUNT);
+    cycles = DWT->CYCCNT - start;
+    runs   = coreFreq / (cycles ? cycles : 1);
+    if (runs == 0) runs = 1;
+
+    /* Find prime numbers forever, reporting throughput on SWO after each */
+    /* second of work, for comparison with energy used in profiler */
     while (1)
     {
-      primes[0] = 1;
-      for (i = 1; i < PRIM_NUMS;)
+      start = DWT->CYCCNT;
+      for (r = 0; r < runs; r++)
       {
-        for (n = primes[i - 1] + 1; ;n++)
-        {
-          for (d = 2; d <= n; d++)
-          {
-            if (n == d)
-            {
-              primes[i] = n;
-              goto nexti;
-            }
-            if (n%d == 0) break;
-          }
-        }
-      nexti:
-        i++;
+        PRIMES_find(primesKernel, primes, PRIMES_COUNT);
       }
+      cycles = DWT->CYCCNT - start;
+
+      SWO_puts(PRIMES_name(primesKernel));
+      SWO_puts(": ");
+      SWO_putu((uint32_t)(((uint64_t)runs * PRIMES_COUNT * coreFreq) / cycles));
+      SWO_puts(" primes/s, ");
+      SWO_putu(cycles / (runs * PRIMES_COUNT));
+      SWO_puts(" cycles/prime\n");
     }
   }
 }
@@ -461,6 +524,8 @@ void setupSWO(void)
   /* Unlock ITM and output data */
   ITM->LAR = 0xC5ACCE55;
   ITM->TCR = 0x10009;
+  /* Enable stimulus port 0, used for text output */
+  ITM->TER |= 1;
 }
 
 
@@ -494,6 +559,9 @@ int main(void)
 
   setupSWO();
 
+  /* Start recording clock and energy mode transitions */
+  ETRACE_init();
+
   /* Wait until we have control over display */
   while(!redraw)
   {
@@ -503,6 +571,7 @@ int main(void)
   /* Init graphics context - abort on failure */
   status = GLIB_contextInit(&gc);
   if (status != GLIB_OK) while (1) ;
+  TFTGLYPH_init();
 
   /* Update TFT display forever */
   while (1)
@@ -517,21 +586,26 @@ int main(void)
         /* Update information message */
         gc.foregroundColor = GLIB_rgbColor(200, 200, 200);
         gc.backgroundColor = GLIB_rgbColor(0, 0, 0);
-        GLIB_drawString(&gc, description[0], strlen(description[0]), 0, 0, 1);
-        GLIB_drawString(&gc, description[1], strlen(description[1]), 0, 8, 1);
-        GLIB_drawString(&gc, description[2], strlen(description[2]), 0, 24, 1);
-        GLIB_drawString(&gc, description[3], strlen(description[3]), 0, 40, 1);
-        GLIB_drawString(&gc, description[4], strlen(description[4]), 0, 48, 1);
-        GLIB_drawString(&gc, description[5], strlen(description[5]), 0, 64, 1);
-        GLIB_drawString(&gc, description[6], strlen(description[6]), 0, 72, 1);
+        TFTGLYPH_drawString(&gc, description[0], strlen(description[0]), 0, 0, 1);
+        TFTGLYPH_drawString(&gc, description[1], strlen(description[1]), 0, 8, 1);
+        TFTGLYPH_drawString(&gc, description[2], strlen(description[2]), 0, 24, 1);
+        TFTGLYPH_drawString(&gc, description[3], strlen(description[3]), 0, 40, 1);
+        TFTGLYPH_drawString(&gc, description[4], strlen(description[4]), 0, 48, 1);
+        TFTGLYPH_drawString(&gc, description[5], strlen(description[5]), 0, 64, 1);
+        TFTGLYPH_drawString(&gc, description[6], strlen(description[6]), 0, 72, 1);
         gc.foregroundColor = GLIB_rgbColor(200, 200, 100);
-        GLIB_drawString(&gc, description[7], strlen(description[7]), 0, 88, 1);
-        GLIB_drawString(&gc, description[8], strlen(description[8]), 0, 104, 1);
+        TFTGLYPH_drawString(&gc, description[7], strlen(description[7]), 0, 88, 1);
+        TFTGLYPH_drawString(&gc, description[8], strlen(description[8]), 0, 104, 1);
+        TFTGLYPH_drawString(&gc, description[9], strlen(description[9]), 0, 120, 1);
+        TFTGLYPH_drawString(&gc, description[10], strlen(description[10]), 0, 128, 1);
       }
       /* Update selected demo  */
       gc.foregroundColor = GLIB_rgbColor(100, 200, 100);
       gc.backgroundColor = GLIB_rgbColor(50, 50, 50);
-      GLIB_drawString(&gc, eModeDesc[eModeDemo], strlen(eModeDesc[eModeDemo]), 40, 150, 1);
+      TFTGLYPH_drawString(&gc, eModeDesc[eModeDemo], strlen(eModeDesc[eModeDemo]), 40, 150, 1);
+      /* Update selected prime number kernel, same colors keep glyphs cached */
+      TFTGLYPH_drawString(&gc, primesKernelDesc[primesKernel],
+                          strlen(primesKernelDesc[primesKernel]), 40, 166, 1);
     }
     else
     {
@@ -542,7 +616,7 @@ int main(void)
     {
       gc.foregroundColor = GLIB_rgbColor(50, 50, 50);
       gc.backgroundColor = GLIB_rgbColor(100, 200, 100);
-      GLIB_drawString(&gc, eModeDesc[eModeDemo], strlen(eModeDesc[eModeDemo]), 40, 150, 1);
+      TFTGLYPH_drawString(&gc, eModeDesc[eModeDemo], strlen(eModeDesc[eModeDemo]), 40, 150, 1);
       for(i=0; i<14000; i++) ;
       break;
     }
@@ -0,0 +1,244 @@
+/**************************************************************************//**
+ * @file
+ * @brief Host (Linux) emulation of the GLIB BMP decoder
+ * @author Energy Micro AS
+ * @version 3.20.0
+ ******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 Energy Micro AS, http://www.energymicro.com</b>
+ *******************************************************************************
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ * 4. The source and compiled code may only be used on Energy Micro "EFM32"
+ *    microcontrollers and "EFR4" radios.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: Energy Micro AS has no
+ * obligation to support this Software. Energy Micro AS is providing the
+ * Software "AS IS", with no express or implied warranties of any kind,
+ * including, but not limited to, any implied warranties of merchantability
+ * or fitness for any particular purpose or warranties against infringement
+ * of any proprietary rights of a third party.
+ *
+ * Energy Micro AS will not be liable for any consequential, incidental, or
+ * special damages, or any other relief, or for any claim by any third party,
+ * arising from your use of this Software.
+ *
+ *****************************************************************************/
+#include <string.h>
+#include "glib/bmp.h"
+
+/** Size of file header and of supported info header */
+#define BMPEMU_FILE_HEADER_SIZE  14
+#define BMPEMU_INFO_HEADER_SIZE  40
+
+/** Decoder state */
+static uint8_t  *bmpPalette;
+static uint32_t bmpPaletteSize;
+static EMSTATUS (*bmpRead)(uint8_t buffer[], uint32_t bufLength, uint32_t bytesToRead);
+static bool     bmpReset;
+static int32_t  bmpWidth;
+static int32_t  bmpHeight;
+static uint16_t bmpBits;
+/** Pixels left of current row, and rows left of image */
+static int32_t  bmpRowLeft;
+static int32_t  bmpRowsLeft;
+
+/***************************************************************************//**
+ * @brief
+ *   Get little endian values from header.
+ ******************************************************************************/
+static uint32_t BMP_get32(const uint8_t *p)
+{
+  return p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static uint16_t BMP_get16(const uint8_t *p)
+{
+  return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+EMSTATUS BMP_init(uint8_t *palette, uint32_t paletteSize,
+                  EMSTATUS (*fp)(uint8_t buffer[], uint32_t bufLength,
+                                 uint32_t bytesToRead))
+{
+  if (!fp)
+  {
+    return BMP_ERROR_INVALID_ARGUMENT;
+  }
+  bmpPalette     = palette;
+  bmpPaletteSize = paletteSize;
+  bmpRead        = fp;
+  bmpReset       = false;
+  return BMP_OK;
+}
+
+EMSTATUS BMP_reset(void)
+{
+  uint8_t  header[BMPEMU_FILE_HEADER_SIZE + BMPEMU_INFO_HEADER_SIZE];
+  uint8_t  skip[64];
+  uint32_t dataOffset;
+  uint32_t colors;
+  uint32_t pos;
+  uint32_t n;
+
+  if (!bmpRead)
+  {
+    return BMP_ERROR_MODULE_NOT_INITIALIZED;
+  }
+  bmpReset = false;
+
+  if (bmpRead(header, sizeof(header), sizeof(header)) != BMP_OK)
+  {
+    return BMP_ERROR_IO;
+  }
+  if ((header[0] != 'B') || (header[1] != 'M'))
+  {
+    return BMP_ERROR_INVALID_BMP;
+  }
+  if (BMP_get32(header + 14) != BMPEMU_INFO_HEADER_SIZE)
+  {
+    return BMP_ERROR_HEADER_SIZE_MISMATCH;
+  }
+  dataOffset = BMP_get32(header + 10);
+  bmpWidth   = (int32_t) BMP_get32(header + 18);
+  bmpHeight  = (int32_t) BMP_get32(header + 22);
+  bmpBits    = BMP_get16(header + 28);
+  colors     = BMP_get32(header + 46);
+
+  /* Only bottom-up, uncompressed 24 bit and 8 bit palette images */
+  if ((bmpWidth <= 0) || (bmpHeight <= 0) || (BMP_get32(header + 30) != 0) ||
+      ((bmpBits != 24) && (bmpBits != 8)))
+  {
+    return BMP_ERROR_ENCODING_NOT_SUPPORTED;
+  }
+  pos = sizeof(header);
+
+  if (bmpBits == 8)
+  {
+    if (colors == 0)
+    {
+      colors = 256;
+    }
+    if ((colors > 256) || (colors * 4 > bmpPaletteSize) || !bmpPalette)
+    {
+      return BMP_ERROR_PALETTE_SIZE_TOO_SMALL;
+    }
+    if (bmpRead(bmpPalette, bmpPaletteSize, colors * 4) != BMP_OK)
+    {
+      return BMP_ERROR_IO;
+    }
+    pos += colors * 4;
+  }
+
+  /* Skip to pixel data */
+  if (dataOffset < pos)
+  {
+    return BMP_ERROR_INVALID_BMP;
+  }
+  while (pos < dataOffset)
+  {
+    n = dataOffset - pos;
+    if (n > sizeof(skip))
+    {
+      n = sizeof(skip);
+    }
+    if (bmpRead(skip, sizeof(skip), n) != BMP_OK)
+    {
+      return BMP_ERROR_IO;
+    }
+    pos += n;
+  }
+
+  bmpRowLeft  = bmpWidth;
+  bmpRowsLeft = bmpHeight;
+  bmpReset    = true;
+  return BMP_OK;
+}
+
+EMSTATUS BMP_readRgbData(uint8_t buffer[], uint32_t bufLength,
+                         uint32_t *pixelsRead)
+{
+  uint8_t  pad[4];
+  uint32_t pixels = bufLength / 3;
+  uint32_t bytesPerPixel = bmpBits / 8;
+  uint32_t rowBytes;
+  uint32_t i;
+  uint8_t  *src;
+  uint8_t  t;
+
+  *pixelsRead = 0;
+  if (!bmpReset)
+  {
+    return BMP_ERROR_FILE_NOT_RESET;
+  }
+  if (bmpRowsLeft == 0)
+  {
+    return BMP_END_OF_FILE;
+  }
+  if (pixels == 0)
+  {
+    return BMP_ERROR_BUFFER_TOO_SMALL;
+  }
+  if (pixels > (uint32_t) bmpRowLeft)
+  {
+    pixels = bmpRowLeft;
+  }
+
+  /* Read into end of buffer and expand to RGB from start */
+  src = buffer + (pixels * 3) - (pixels * bytesPerPixel);
+  if (bmpRead(src, pixels * bytesPerPixel, pixels * bytesPerPixel) != BMP_OK)
+  {
+    return BMP_ERROR_IO;
+  }
+  for (i = 0; i < pixels; i++)
+  {
+    if (bmpBits == 24)
+    {
+      /* Stored as blue, green, red */
+      t                    = buffer[(i * 3)];
+      buffer[(i * 3)]     = buffer[(i * 3) + 2];
+      buffer[(i * 3) + 2] = t;
+    }
+    else
+    {
+      t                    = src[i];
+      buffer[(i * 3)]     = bmpPalette[(t * 4) + 2];
+      buffer[(i * 3) + 1] = bmpPalette[(t * 4) + 1];
+      buffer[(i * 3) + 2] = bmpPalette[(t * 4)];
+    }
+  }
+
+  /* Rows are padded to 4 bytes */
+  bmpRowLeft -= pixels;
+  if (bmpRowLeft == 0)
+  {
+    rowBytes = bmpWidth * bytesPerPixel;
+    if ((rowBytes % 4) &&
+        (bmpRead(pad, sizeof(pad), 4 - (rowBytes % 4)) != BMP_OK))
+    {
+      return BMP_ERROR_IO;
+    }
+    bmpRowLeft = bmpWidth;
+    bmpRowsLeft--;
+  }
+  *pixelsRead = pixels;
+  return BMP_OK;
+}
+
+int32_t BMP_getWidth(void)
+{
+  return bmpWidth;
+}
+
+int32_t BMP_getHeight(void)
+{
+  return bmpHeight;
+}
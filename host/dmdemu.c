@@ -0,0 +1,243 @@
+/**************************************************************************//**
+ * @file
+ * @brief Host (Linux) emulation of SSD2119 display driver
+ * @author Energy Micro AS
+ * @version 3.20.0
+ ******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 Energy Micro AS, http://www.energymicro.com</b>
+ *******************************************************************************
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ * 4. The source and compiled code may only be used on Energy Micro "EFM32"
+ *    microcontrollers and "EFR4" radios.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: Energy Micro AS has no
+ * obligation to support this Software. Energy Micro AS is providing the
+ * Software "AS IS", with no express or implied warranties of any kind,
+ * including, but not limited to, any implied warranties of merchantability
+ * or fitness for any particular purpose or warranties against infringement
+ * of any proprietary rights of a third party.
+ *
+ * Energy Micro AS will not be liable for any consequential, incidental, or
+ * special damages, or any other relief, or for any claim by any third party,
+ * arising from your use of this Software.
+ *
+ *****************************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include "dmd/ssd2119/dmd_ssd2119.h"
+#include "dmdemu.h"
+
+uint16_t                 dmdemuFramebuffer[DMDEMU_HEIGHT][DMDEMU_WIDTH];
+DMDEMU_Count_TypeDef     dmdemuCount;
+DMDEMU_WriteHook_TypeDef dmdemuWriteHook;
+
+/** Driver state */
+static bool     initialized;
+
+/** Clipping area, writes wrap inside it */
+static uint16_t areaX;
+static uint16_t areaY;
+static uint16_t areaWidth;
+static uint16_t areaHeight;
+
+/***************************************************************************//**
+ * @brief
+ *   Uninitialize driver and clear framebuffer to black, as after reset.
+ ******************************************************************************/
+void DMDEMU_reset(void)
+{
+  memset(dmdemuFramebuffer, 0, sizeof(dmdemuFramebuffer));
+  initialized = false;
+  areaX       = 0;
+  areaY       = 0;
+  areaWidth   = DMDEMU_WIDTH;
+  areaHeight  = DMDEMU_HEIGHT;
+  DMDEMU_resetCount();
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Reset display access counters.
+ ******************************************************************************/
+void DMDEMU_resetCount(void)
+{
+  memset(&dmdemuCount, 0, sizeof(dmdemuCount));
+}
+
+/***************************************************************************//**
+ * @brief
+ *   FNV-1a hash of framebuffer contents.
+ ******************************************************************************/
+uint32_t DMDEMU_checksum(void)
+{
+  uint32_t hash = 2166136261u;
+  int      x, y;
+
+  for (y = 0; y < DMDEMU_HEIGHT; y++)
+  {
+    for (x = 0; x < DMDEMU_WIDTH; x++)
+    {
+      hash = (hash ^ (dmdemuFramebuffer[y][x] & 0xff)) * 16777619u;
+      hash = (hash ^ (dmdemuFramebuffer[y][x] >> 8)) * 16777619u;
+    }
+  }
+  return hash;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Save framebuffer as binary PPM image, colors expanded to 8 bits.
+ * @return
+ *   true if written.
+ ******************************************************************************/
+bool DMDEMU_writePpm(const char *fileName)
+{
+  FILE     *f = fopen(fileName, "wb");
+  uint16_t pixel;
+  uint8_t  rgb[3];
+  int      x, y;
+  bool     ok;
+
+  if (!f)
+  {
+    return false;
+  }
+  fprintf(f, "P6\n%d %d\n255\n", DMDEMU_WIDTH, DMDEMU_HEIGHT);
+  for (y = 0; y < DMDEMU_HEIGHT; y++)
+  {
+    for (x = 0; x < DMDEMU_WIDTH; x++)
+    {
+      pixel  = dmdemuFramebuffer[y][x];
+      rgb[0] = (uint8_t)(((pixel >> 11) << 3) | (pixel >> 13));
+      rgb[1] = (uint8_t)((((pixel >> 5) & 0x3f) << 2) | ((pixel >> 9) & 0x03));
+      rgb[2] = (uint8_t)(((pixel & 0x1f) << 3) | ((pixel >> 2) & 0x07));
+      fwrite(rgb, 1, sizeof(rgb), f);
+    }
+  }
+  ok = !ferror(f);
+  return (fclose(f) == 0) && ok;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Write pixels from clipping area relative position, from data if given,
+ *   else of a single color.
+ ******************************************************************************/
+static EMSTATUS DMDEMU_write(uint16_t x, uint16_t y, const uint8_t *data,
+                             uint8_t red, uint8_t green, uint8_t blue,
+                             uint32_t numPixels)
+{
+  uint16_t pixel = 0;
+
+  if (!initialized)
+  {
+    return DMD_ERROR_DRIVER_NOT_INITIALIZED;
+  }
+  if ((x >= areaWidth) || (y >= areaHeight))
+  {
+    return DMD_ERROR_PIXEL_OUT_OF_BOUNDS;
+  }
+  dmdemuCount.transactions++;
+  dmdemuCount.pixels += numPixels;
+
+  if (!data)
+  {
+    pixel = (uint16_t)(((red & 0xf8) << 8) | ((green & 0xfc) << 3) | (blue >> 3));
+  }
+  while (numPixels--)
+  {
+    if (data)
+    {
+      pixel = (uint16_t)(((data[0] & 0xf8) << 8) | ((data[1] & 0xfc) << 3) | (data[2] >> 3));
+      data += 3;
+    }
+    dmdemuFramebuffer[areaY + y][areaX + x] = pixel;
+    if (++x == areaWidth)
+    {
+      x = 0;
+      if (++y == areaHeight)
+      {
+        y = 0;
+      }
+    }
+  }
+  if (dmdemuWriteHook)
+  {
+    dmdemuWriteHook();
+  }
+  return DMD_OK;
+}
+
+EMSTATUS DMD_init(uint32_t cmdRegAddr, uint32_t dataRegAddr)
+{
+  (void)cmdRegAddr;
+  (void)dataRegAddr;
+
+  if (initialized)
+  {
+    return DMD_ERROR_DRIVER_ALREADY_INITIALIZED;
+  }
+  initialized = true;
+  areaX       = 0;
+  areaY       = 0;
+  areaWidth   = DMDEMU_WIDTH;
+  areaHeight  = DMDEMU_HEIGHT;
+  return DMD_OK;
+}
+
+EMSTATUS DMD_flipDisplay(int horizontal, int vertical)
+{
+  if (!initialized)
+  {
+    return DMD_ERROR_DRIVER_NOT_INITIALIZED;
+  }
+  (void)horizontal;
+  (void)vertical;
+
+  /* Only sets scan direction of the panel, framebuffer is kept as drawn */
+  dmdemuCount.transactions++;
+  return DMD_OK;
+}
+
+EMSTATUS DMD_setClippingArea(uint16_t xStart, uint16_t yStart,
+                             uint16_t width, uint16_t height)
+{
+  if (!initialized)
+  {
+    return DMD_ERROR_DRIVER_NOT_INITIALIZED;
+  }
+  if ((width == 0) || (height == 0) ||
+      ((xStart + width) > DMDEMU_WIDTH) || ((yStart + height) > DMDEMU_HEIGHT))
+  {
+    return DMD_ERROR_PIXEL_OUT_OF_BOUNDS;
+  }
+  areaX      = xStart;
+  areaY      = yStart;
+  areaWidth  = width;
+  areaHeight = height;
+  dmdemuCount.transactions++;
+  dmdemuCount.windows++;
+  return DMD_OK;
+}
+
+EMSTATUS DMD_writeData(uint16_t x, uint16_t y, const uint8_t data[],
+                       uint32_t numPixels)
+{
+  return DMDEMU_write(x, y, data, 0, 0, 0, numPixels);
+}
+
+EMSTATUS DMD_writeColor(uint16_t x, uint16_t y, uint8_t red,
+                        uint8_t green, uint8_t blue, uint32_t numPixels)
+{
+  return DMDEMU_write(x, y, NULL, red, green, blue, numPixels);
+}
@@ -0,0 +1,90 @@
+/**************************************************************************//**
+ * @file
+ * @brief Host (Linux) emulation of SSD2119 display driver
+ * @author Energy Micro AS
+ * @version 3.20.0
+ ******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 Energy Micro AS, http://www.energymicro.com</b>
+ *******************************************************************************
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ * 4. The source and compiled code may only be used on Energy Micro "EFM32"
+ *    microcontrollers and "EFR4" radios.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: Energy Micro AS has no
+ * obligation to support this Software. Energy Micro AS is providing the
+ * Software "AS IS", with no express or implied warranties of any kind,
+ * including, but not limited to, any implied warranties of merchantability
+ * or fitness for any particular purpose or warranties against infringement
+ * of any proprietary rights of a third party.
+ *
+ * Energy Micro AS will not be liable for any consequential, incidental, or
+ * special damages, or any other relief, or for any claim by any third party,
+ * arising from your use of this Software.
+ *
+ *****************************************************************************/
+#ifndef __DMDEMU_H
+#define __DMDEMU_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+   Host (Linux) emulation of the SSD2119 TFT display driver (DMD).
+
+   Implements the DMD entry points used by the TFT examples on a 320x240
+   RGB565 framebuffer in memory, so their drawing code can run on a PC.
+   Pixels written through DMD are reduced to RGB565 as on the display.
+   Like the display controller, writes start at a position inside the
+   clipping area and wrap to the next row of the area at its right edge.
+
+   Every DMD call is counted as one display transaction, together with
+   the number of pixels written, and a hook may be set to be called after
+   each write, e.g. to time display updates. The framebuffer can be saved
+   as a binary PPM (P6) image, and reduced to a checksum for golden image
+   tests.
+*/
+
+/** Display size */
+#define DMDEMU_WIDTH   320
+#define DMDEMU_HEIGHT  240
+
+/** Display access counters */
+typedef struct
+{
+  uint32_t transactions;     /**< DMD calls accessing the display */
+  uint32_t windows;          /**< DMD_setClippingArea() calls */
+  uint32_t pixels;           /**< Pixels written */
+} DMDEMU_Count_TypeDef;
+
+/** Called after each DMD write, with counters updated */
+typedef void (*DMDEMU_WriteHook_TypeDef)(void);
+
+/** Framebuffer, RGB565 */
+extern uint16_t                 dmdemuFramebuffer[DMDEMU_HEIGHT][DMDEMU_WIDTH];
+extern DMDEMU_Count_TypeDef     dmdemuCount;
+extern DMDEMU_WriteHook_TypeDef dmdemuWriteHook;
+
+void DMDEMU_reset(void);
+void DMDEMU_resetCount(void);
+uint32_t DMDEMU_checksum(void);
+bool DMDEMU_writePpm(const char *fileName);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
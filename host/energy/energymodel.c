@@ -0,0 +1,655 @@
+/**************************************************************************//**
+ * @file
+ * @brief Energy model for clock and energy mode traces
+ * @author Energy Micro AS
+ * @version 3.20.0
+ ******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 Energy Micro AS, http://www.energymicro.com</b>
+ *******************************************************************************
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ * 4. The source and compiled code may only be used on Energy Micro "EFM32"
+ *    microcontrollers and "EFR4" radios.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: Energy Micro AS has no
+ * obligation to support this Software. Energy Micro AS is providing the
+ * Software "AS IS", with no express or implied warranties of any kind,
+ * including, but not limited to, any implied warranties of merchantability
+ * or fitness for any particular purpose or warranties against infringement
+ * of any proprietary rights of a third party.
+ *
+ * Energy Micro AS will not be liable for any consequential, incidental, or
+ * special damages, or any other relief, or for any claim by any third party,
+ * arising from your use of this Software.
+ *
+ *****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+/*
+   Host energy model for clock and energy mode traces.
+
+   Reads traces recorded by etrace.c of the tftemode, emode and powertest
+   examples ("ET" lines as written to SWO), or scenarios written by hand
+   ("S" lines), and estimates the current in each clock state from a table
+   of energy mode, oscillator and peripheral currents. Prints time and
+   charge per state, average current and battery life.
+*/
+
+/** Most distinct clock states reported */
+#define MODEL_MAX_STATES  64
+
+/** Table entry kinds */
+#define MODEL_PER_MHZ     0x01  /**< Current per MHz of the clock */
+#define MODEL_EM          0x02  /**< Base current of energy mode */
+#define MODEL_OSC         0x04  /**< Oscillator, flag in osc */
+#define MODEL_HF          0x08  /**< HFPERCLK peripheral, flag in per */
+#define MODEL_CORE        0x10  /**< HFCORECLK peripheral, flag in per */
+#define MODEL_LF          0x20  /**< LFACLK/LFBCLK peripheral, flag in lf */
+
+/** Oscillator flags of HFRCO, HFXO and AUXHFRCO, which stop in EM2 */
+#define MODEL_OSC_HF      0x07
+
+/** Current table entry */
+typedef struct
+{
+  const char *name;    /**< Name in table files and scenarios */
+  int        kind;     /**< MODEL_ flags */
+  uint32_t   flag;     /**< Energy mode, or flag as in etrace.h */
+  double     current;  /**< uA, or uA/MHz for MODEL_PER_MHZ */
+} MODEL_Current_TypeDef;
+
+/*
+   Typical currents at 3 V and room temperature for EFM32 Gecko, in the
+   order of the device datasheet. Energy mode currents are for the core
+   running from flash (EM0) or sleeping (EM1) per MHz of HFCORECLK, and
+   exclude oscillators and peripheral clocks, which are added as enabled.
+   EM2 with LFRCO and RTC adds up to about 0.9 uA. The figures are good
+   for comparing choices; use -t with figures measured on the board, for
+   instance with the energyAware Profiler, to estimate battery life.
+*/
+static MODEL_Current_TypeDef currents[] =
+{
+  { "em0",      MODEL_EM | MODEL_PER_MHZ, 0, 180.0  },
+  { "em1",      MODEL_EM | MODEL_PER_MHZ, 1,  45.0  },
+  { "em2",      MODEL_EM,                 2,   0.6  },
+  { "em3",      MODEL_EM,                 3,   0.59 },
+  { "em4",      MODEL_EM,                 4,   0.02 },
+  { "hfrco",    MODEL_OSC,             0x01,  90.0  },
+  { "hfxo",     MODEL_OSC,             0x02, 150.0  },
+  { "auxhfrco", MODEL_OSC,             0x04,  90.0  },
+  { "lfrco",    MODEL_OSC,             0x08,   0.2  },
+  { "lfxo",     MODEL_OSC,             0x10,   0.2  },
+  { "timer",    MODEL_HF | MODEL_PER_MHZ, 0x0001, 8.3 },
+  { "usart",    MODEL_HF | MODEL_PER_MHZ, 0x0002, 7.5 },
+  { "uart",     MODEL_HF | MODEL_PER_MHZ, 0x0004, 7.5 },
+  { "acmp",     MODEL_HF | MODEL_PER_MHZ, 0x0008, 1.0 },
+  { "prs",      MODEL_HF | MODEL_PER_MHZ, 0x0010, 2.0 },
+  { "dac",      MODEL_HF | MODEL_PER_MHZ, 0x0020, 6.0 },
+  { "gpio",     MODEL_HF | MODEL_PER_MHZ, 0x0040, 3.0 },
+  { "vcmp",     MODEL_HF | MODEL_PER_MHZ, 0x0080, 1.0 },
+  { "adc",      MODEL_HF | MODEL_PER_MHZ, 0x0100, 6.0 },
+  { "i2c",      MODEL_HF | MODEL_PER_MHZ, 0x0200, 6.0 },
+  { "dma",      MODEL_CORE | MODEL_PER_MHZ, 0x0400, 8.0 },
+  { "aes",      MODEL_CORE | MODEL_PER_MHZ, 0x0800, 4.0 },
+  { "ebi",      MODEL_CORE | MODEL_PER_MHZ, 0x1000, 4.0 },
+  { "rtc",      MODEL_LF,                 0x01,   0.1  },
+  { "letimer",  MODEL_LF,                 0x02,   0.15 },
+  { "lcd",      MODEL_LF,                 0x04,   0.55 },
+  { "leuart",   MODEL_LF,                 0x08,   0.15 },
+};
+
+#define MODEL_CURRENTS  (sizeof(currents) / sizeof(currents[0]))
+
+/** Clock state, as recorded by etrace.c */
+typedef struct
+{
+  int      em;         /**< Energy mode */
+  uint32_t coreFreq;   /**< HFCORECLK, Hz */
+  uint32_t perFreq;    /**< HFPERCLK, Hz */
+  uint32_t osc;        /**< Enabled oscillators */
+  uint32_t per;        /**< Clocked high frequency peripherals */
+  uint32_t lf;         /**< Clocked low frequency peripherals */
+} MODEL_Clock_TypeDef;
+
+/** Time spent in a clock state */
+typedef struct
+{
+  MODEL_Clock_TypeDef clock;
+  double              seconds;
+} MODEL_State_TypeDef;
+
+/** Trace record, as written by etrace.c */
+typedef struct
+{
+  char                event;
+  int                 arg;
+  uint32_t            cycles;
+  uint32_t            rtc;
+  uint32_t            rtcTop;
+  uint32_t            rtcFreq;
+  MODEL_Clock_TypeDef clock;
+} MODEL_Record_TypeDef;
+
+static MODEL_State_TypeDef states[MODEL_MAX_STATES];
+static int                 stateCount;
+static double              endSeconds = 1.0;
+static int                 unknownCount;
+
+/***************************************************************************//**
+ * @brief
+ *   Estimate current of clock state, uA.
+ ******************************************************************************/
+static double MODEL_current(const MODEL_Clock_TypeDef *clock)
+{
+  double   current = 0;
+  double   mhz;
+  uint32_t i;
+  int      on;
+
+  for (i = 0; i < MODEL_CURRENTS; i++)
+  {
+    const MODEL_Current_TypeDef *c = &currents[i];
+
+    mhz = clock->coreFreq / 1e6;
+    if (c->kind & MODEL_EM)
+    {
+      on = ((int) c->flag == clock->em);
+    }
+    else if (c->kind & MODEL_OSC)
+    {
+      /* High frequency oscillators stop in EM2, low frequency ones in EM3 */
+      on = (c->flag & clock->osc) &&
+           (clock->em <= ((c->flag & MODEL_OSC_HF) ? 1 : 2));
+    }
+    else if (c->kind & MODEL_LF)
+    {
+      on = (c->flag & clock->lf) && (clock->em <= 2);
+    }
+    else
+    {
+      on = (c->flag & clock->per) && (clock->em <= 1);
+      if (c->kind & MODEL_HF)
+      {
+        mhz = clock->perFreq / 1e6;
+      }
+    }
+    if (on)
+    {
+      current += (c->kind & MODEL_PER_MHZ) ? c->current * mhz : c->current;
+    }
+  }
+  return current;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Add time spent in clock state.
+ ******************************************************************************/
+static void MODEL_add(const MODEL_Clock_TypeDef *clock, double seconds)
+{
+  MODEL_Clock_TypeDef running = *clock;
+  int                 i;
+
+  /* Leave out clocks stopped in the energy mode, so that states differing
+     only in those are reported together */
+  if (running.em >= 2)
+  {
+    running.coreFreq = 0;
+    running.perFreq  = 0;
+    running.per      = 0;
+    running.osc     &= ~MODEL_OSC_HF;
+  }
+  if (running.em >= 3)
+  {
+    running.osc = 0;
+    running.lf  = 0;
+  }
+
+  for (i = 0; i < stateCount; i++)
+  {
+    if (memcmp(&states[i].clock, &running, sizeof(running)) == 0)
+    {
+      states[i].seconds += seconds;
+      return;
+    }
+  }
+  if (stateCount == MODEL_MAX_STATES)
+  {
+    fprintf(stderr, "more than %d clock states, rest ignored\n", MODEL_MAX_STATES);
+    return;
+  }
+  states[stateCount].clock   = running;
+  states[stateCount].seconds = seconds;
+  stateCount++;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Find table entry by name.
+ ******************************************************************************/
+static MODEL_Current_TypeDef *MODEL_find(const char *name)
+{
+  uint32_t i;
+
+  for (i = 0; i < MODEL_CURRENTS; i++)
+  {
+    if (strcmp(currents[i].name, name) == 0)
+    {
+      return &currents[i];
+    }
+  }
+  return NULL;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Parse comma separated names into flags of given kind.
+ ******************************************************************************/
+static int MODEL_flags(const char *list, int kind, uint32_t *flags)
+{
+  char                  name[32];
+  MODEL_Current_TypeDef *c;
+  size_t                len;
+
+  *flags = 0;
+  while (*list)
+  {
+    len = strcspn(list, ",");
+    if ((len == 0) || (len >= sizeof(name)))
+    {
+      return 0;
+    }
+    memcpy(name, list, len);
+    name[len] = '\0';
+    list     += len + (list[len] == ',');
+
+    if (strcmp(name, "none") == 0)
+    {
+      continue;
+    }
+    c = MODEL_find(name);
+    if (!c || !(c->kind & kind))
+    {
+      return 0;
+    }
+    *flags |= c->flag;
+  }
+  return 1;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Parse scenario line:
+ *   "S <seconds> EM<n> [core=<MHz>] [per=<MHz>] [osc=<names>] [hf=<names>]
+ *   [lf=<names>]", names separated by commas.
+ ******************************************************************************/
+static int MODEL_scenario(char *line)
+{
+  MODEL_Clock_TypeDef clock;
+  double              seconds;
+  char                *tok;
+
+  memset(&clock, 0, sizeof(clock));
+  tok = strtok(line + 1, " \t\r\n");
+  if (!tok || (sscanf(tok, "%lf", &seconds) != 1))
+  {
+    return 0;
+  }
+  tok = strtok(NULL, " \t\r\n");
+  if (!tok || (sscanf(tok, "EM%d", &clock.em) != 1) || (clock.em < 0) || (clock.em > 4))
+  {
+    return 0;
+  }
+  while ((tok = strtok(NULL, " \t\r\n")) != NULL)
+  {
+    double mhz;
+
+    if (sscanf(tok, "core=%lf", &mhz) == 1)
+    {
+      clock.coreFreq = (uint32_t)(mhz * 1e6 + 0.5);
+    }
+    else if (sscanf(tok, "per=%lf", &mhz) == 1)
+    {
+      clock.perFreq = (uint32_t)(mhz * 1e6 + 0.5);
+    }
+    else if (strncmp(tok, "osc=", 4) == 0)
+    {
+      if (!MODEL_flags(tok + 4, MODEL_OSC, &clock.osc))
+      {
+        return 0;
+      }
+    }
+    else if (strncmp(tok, "hf=", 3) == 0)
+    {
+      if (!MODEL_flags(tok + 3, MODEL_HF | MODEL_CORE, &clock.per))
+      {
+        return 0;
+      }
+    }
+    else if (strncmp(tok, "lf=", 3) == 0)
+    {
+      if (!MODEL_flags(tok + 3, MODEL_LF, &clock.lf))
+      {
+        return 0;
+      }
+    }
+    else
+    {
+      return 0;
+    }
+  }
+  /* Peripherals run from the core clock unless given otherwise */
+  if (clock.perFreq == 0)
+  {
+    clock.perFreq = clock.coreFreq;
+  }
+  MODEL_add(&clock, seconds);
+  return 1;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Parse trace record line, as written by etrace.c.
+ ******************************************************************************/
+static int MODEL_parseRecord(const char *line, MODEL_Record_TypeDef *rec)
+{
+  unsigned long v[8];
+  unsigned long osc, per, lf;
+
+  if (sscanf(line, "ET %c %lu %lu %lu %lu %lu %lu %lu %lx %lx %lx",
+             &rec->event, &v[0], &v[1], &v[2], &v[3], &v[4], &v[5], &v[6],
+             &osc, &per, &lf) != 11)
+  {
+    return 0;
+  }
+  rec->arg            = (int) v[0];
+  rec->cycles         = (uint32_t) v[1];
+  rec->rtc            = (uint32_t) v[2];
+  rec->rtcTop         = (uint32_t) v[3];
+  rec->rtcFreq        = (uint32_t) v[4];
+  rec->clock.coreFreq = (uint32_t) v[5];
+  rec->clock.perFreq  = (uint32_t) v[6];
+  rec->clock.osc      = (uint32_t) osc;
+  rec->clock.per      = (uint32_t) per;
+  rec->clock.lf       = (uint32_t) lf;
+  rec->clock.em       = 0;
+  return 1;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Account time from previous record to this one.
+ *   Sleeps are timed with the RTC when it was counting, other intervals
+ *   with the core cycle counter, which stops while the core sleeps.
+ ******************************************************************************/
+static void MODEL_interval(const MODEL_Record_TypeDef *prev, const MODEL_Record_TypeDef *rec)
+{
+  MODEL_Clock_TypeDef clock = prev->clock;
+  uint32_t            ticks;
+
+  /* Time spent writing the trace out is not part of it */
+  if ((prev->event == 'F') && (rec->event == 'R'))
+  {
+    return;
+  }
+
+  if (prev->event == 'S')
+  {
+    clock.em = prev->arg;
+    if (prev->rtcTop && rec->rtcFreq)
+    {
+      ticks = (rec->rtc >= prev->rtc) ? rec->rtc - prev->rtc
+                                      : rec->rtc + prev->rtcTop - prev->rtc;
+      MODEL_add(&clock, (double) ticks / prev->rtcFreq);
+    }
+    else
+    {
+      unknownCount++;
+      MODEL_add(&clock, endSeconds);
+    }
+  }
+  else if (prev->clock.coreFreq)
+  {
+    MODEL_add(&clock, (double)(uint32_t)(rec->cycles - prev->cycles) / prev->clock.coreFreq);
+  }
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Read trace or scenario file. Lines other than records and scenario
+ *   lines, such as other SWO output, are skipped.
+ ******************************************************************************/
+static int MODEL_read(const char *fileName)
+{
+  FILE                 *f;
+  char                 line[256];
+  MODEL_Record_TypeDef prev;
+  MODEL_Record_TypeDef rec;
+  int                  havePrev = 0;
+  int                  lineNo   = 0;
+
+  f = fopen(fileName, "r");
+  if (!f)
+  {
+    fprintf(stderr, "%s: cannot open\n", fileName);
+    return 0;
+  }
+  while (fgets(line, sizeof(line), f))
+  {
+    lineNo++;
+    if (strncmp(line, "ET ", 3) == 0)
+    {
+      if (!MODEL_parseRecord(line, &rec))
+      {
+        fprintf(stderr, "%s:%d: bad trace record\n", fileName, lineNo);
+        fclose(f);
+        return 0;
+      }
+      if (havePrev)
+      {
+        MODEL_interval(&prev, &rec);
+      }
+      prev     = rec;
+      havePrev = 1;
+    }
+    else if ((line[0] == 'S') && ((line[1] == ' ') || (line[1] == '\t')))
+    {
+      if (!MODEL_scenario(line))
+      {
+        fprintf(stderr, "%s:%d: bad scenario line\n", fileName, lineNo);
+        fclose(f);
+        return 0;
+      }
+    }
+  }
+  fclose(f);
+
+  /* The last state of a trace lasts as long as given on the command line */
+  if (havePrev && (prev.event != 'F'))
+  {
+    prev.clock.em = (prev.event == 'S') ? prev.arg : 0;
+    MODEL_add(&prev.clock, endSeconds);
+  }
+  return 1;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Read table of currents, "<name> <current>" per line.
+ ******************************************************************************/
+static int MODEL_readTable(const char *fileName)
+{
+  FILE                  *f;
+  char                  line[256];
+  char                  name[32];
+  double                current;
+  MODEL_Current_TypeDef *c;
+  int                   lineNo = 0;
+
+  f = fopen(fileName, "r");
+  if (!f)
+  {
+    fprintf(stderr, "%s: cannot open\n", fileName);
+    return 0;
+  }
+  while (fgets(line, sizeof(line), f))
+  {
+    lineNo++;
+    if ((line[0] == '#') || (strspn(line, " \t\r\n") == strlen(line)))
+    {
+      continue;
+    }
+    if ((sscanf(line, "%31s %lf", name, &current) != 2) || !(c = MODEL_find(name)))
+    {
+      fprintf(stderr, "%s:%d: bad current\n", fileName, lineNo);
+      fclose(f);
+      return 0;
+    }
+    c->current = current;
+  }
+  fclose(f);
+  return 1;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Format names of flags set, of given kind.
+ ******************************************************************************/
+static void MODEL_names(char *buffer, size_t size, int kind, uint32_t flags)
+{
+  uint32_t i;
+  size_t   len = 0;
+
+  buffer[0] = '\0';
+  for (i = 0; i < MODEL_CURRENTS; i++)
+  {
+    if ((currents[i].kind & kind) && (currents[i].flag & flags))
+    {
+      len += snprintf(buffer + len, (len < size) ? size - len : 0, "%s%s",
+                      len ? "," : "", currents[i].name);
+    }
+  }
+  if (len == 0)
+  {
+    snprintf(buffer, size, "none");
+  }
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Print time and charge per state, average current and battery life.
+ ******************************************************************************/
+static void MODEL_report(double capacity)
+{
+  char   osc[64], per[96], lf[48];
+  double current[MODEL_MAX_STATES];
+  double seconds = 0;
+  double charge  = 0;
+  double average;
+  double hours;
+  int    i;
+
+  for (i = 0; i < stateCount; i++)
+  {
+    current[i] = MODEL_current(&states[i].clock);
+    seconds   += states[i].seconds;
+    charge    += states[i].seconds * current[i];
+  }
+  if (seconds <= 0)
+  {
+    printf("no time in trace\n");
+    return;
+  }
+
+  printf("%-3s %6s %6s %10s %6s %10s %6s  %s\n",
+         "em", "core", "per", "seconds", "time%", "uA", "chrg%", "clocks");
+  for (i = 0; i < stateCount; i++)
+  {
+    const MODEL_State_TypeDef *s = &states[i];
+
+    MODEL_names(osc, sizeof(osc), MODEL_OSC, s->clock.osc);
+    MODEL_names(per, sizeof(per), MODEL_HF | MODEL_CORE, s->clock.per);
+    MODEL_names(lf, sizeof(lf), MODEL_LF, s->clock.lf);
+    printf("EM%d %6.2f %6.2f %10.6f %6.2f %10.2f %6.2f  osc=%s hf=%s lf=%s\n",
+           s->clock.em, s->clock.coreFreq / 1e6, s->clock.perFreq / 1e6,
+           s->seconds, 100 * s->seconds / seconds, current[i],
+           (charge > 0) ? 100 * s->seconds * current[i] / charge : 0.0,
+           osc, per, lf);
+  }
+
+  average = charge / seconds;
+  printf("\n%.6f s, average %.2f uA\n", seconds, average);
+  if (average > 0)
+  {
+    hours = capacity * 1000 / average;
+    printf("%.0f mAh battery: %.0f hours, %.1f days, %.2f years\n",
+           capacity, hours, hours / 24, hours / (24 * 365));
+  }
+  if (unknownCount)
+  {
+    printf("%d sleeps without RTC counting taken as %g s each (-e)\n",
+           unknownCount, endSeconds);
+  }
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Estimate average current and battery life of a trace.
+ ******************************************************************************/
+int main(int argc, char *argv[])
+{
+  double capacity = 225;
+  int    files    = 0;
+  int    i;
+
+  for (i = 1; i < argc; i++)
+  {
+    if ((strcmp(argv[i], "-b") == 0) && ((i + 1) < argc))
+    {
+      capacity = atof(argv[++i]);
+    }
+    else if ((strcmp(argv[i], "-e") == 0) && ((i + 1) < argc))
+    {
+      endSeconds = atof(argv[++i]);
+    }
+    else if ((strcmp(argv[i], "-t") == 0) && ((i + 1) < argc))
+    {
+      if (!MODEL_readTable(argv[++i]))
+      {
+        return 1;
+      }
+    }
+    else if (argv[i][0] == '-')
+    {
+      break;
+    }
+    else
+    {
+      if (!MODEL_read(argv[i]))
+      {
+        return 1;
+      }
+      files++;
+    }
+  }
+  if ((i < argc) || (files == 0))
+  {
+    fprintf(stderr, "Usage: %s [-b mAh] [-e seconds] [-t table] trace...\n", argv[0]);
+    return 1;
+  }
+
+  MODEL_report(capacity);
+  return 0;
+}
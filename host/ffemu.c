@@ -0,0 +1,635 @@
+/**************************************************************************//**
+ * @file
+ * @brief Host (Linux) emulation of the FAT file system on the microSD card
+ * @author Energy Micro AS
+ * @version 3.20.0
+ ******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 Energy Micro AS, http://www.energymicro.com</b>
+ *******************************************************************************
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ * 4. The source and compiled code may only be used on Energy Micro "EFM32"
+ *    microcontrollers and "EFR4" radios.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: Energy Micro AS has no
+ * obligation to support this Software. Energy Micro AS is providing the
+ * Software "AS IS", with no express or implied warranties of any kind,
+ * including, but not limited to, any implied warranties of merchantability
+ * or fitness for any particular purpose or warranties against infringement
+ * of any proprietary rights of a third party.
+ *
+ * Energy Micro AS will not be liable for any consequential, incidental, or
+ * special damages, or any other relief, or for any claim by any third party,
+ * arising from your use of this Software.
+ *
+ *****************************************************************************/
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <ctype.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+/* ff.h and dirent.h both define DIR, the FatFS one is renamed here */
+#define DIR FF_DIR
+#include "ff.h"
+#undef DIR
+#include <dirent.h>
+
+#include "ffemu.h"
+
+FFEMU_Count_TypeDef ffemuCount;
+
+/** Host directory holding root directory of card, empty if not given */
+static char rootDir[256];
+
+/** Marks file window as empty */
+#define FFEMU_NO_SECTOR  0xffffffffUL
+
+/** File written since opened or last synced, see FA__WRITTEN of FatFS */
+#define FFEMU_WRITTEN    0x20
+
+/** Directory entries per sector */
+#define FFEMU_DIR_ENTRIES  16
+
+/** Name of a directory entry, as on host, 8.3 characters */
+typedef char FFEMU_Name_TypeDef[13];
+
+/***************************************************************************//**
+ * @brief
+ *   Give host directory holding root directory of card, and reset counters.
+ * @return
+ *   true if directory can be opened.
+ ******************************************************************************/
+bool FFEMU_init(const char *root)
+{
+  DIR *dir = opendir(root);
+
+  if (!dir || (strlen(root) >= sizeof(rootDir)))
+  {
+    if (dir)
+    {
+      closedir(dir);
+    }
+    rootDir[0] = '\0';
+    return false;
+  }
+  closedir(dir);
+  strcpy(rootDir, root);
+  FFEMU_resetCount();
+  return true;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Reset card access counters.
+ ******************************************************************************/
+void FFEMU_resetCount(void)
+{
+  memset(&ffemuCount, 0, sizeof(ffemuCount));
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Check that name is a valid 8.3 name, the only ones seen by FatFS when
+ *   long file names are not enabled.
+ ******************************************************************************/
+static bool FFEMU_validName(const char *name)
+{
+  const char *dot = strchr(name, '.');
+  size_t     base = dot ? (size_t)(dot - name) : strlen(name);
+  size_t     ext  = dot ? strlen(dot + 1) : 0;
+
+  if ((base == 0) || (base > 8) || (ext > 3) || (dot && (ext == 0)))
+  {
+    return false;
+  }
+  for (; *name; name++)
+  {
+    if ((*name != '.') && !isalnum((unsigned char)*name) &&
+        !strchr("!#$%&'()-@^_`{}~", *name))
+    {
+      return false;
+    }
+    if ((*name == '.') && (name != dot))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Compare names of directory entries, as seen by FatFS.
+ ******************************************************************************/
+static int FFEMU_compareNames(const void *a, const void *b)
+{
+  return strcasecmp((const char *)a, (const char *)b);
+}
+
+/***************************************************************************//**
+ * @brief
+ *   List valid names in root directory of card, sorted.
+ * @param[out] count
+ *   Number of names.
+ * @return
+ *   Names, to be freed by caller. NULL if none.
+ ******************************************************************************/
+static FFEMU_Name_TypeDef *FFEMU_listNames(UINT *count)
+{
+  FFEMU_Name_TypeDef *names = NULL;
+  FFEMU_Name_TypeDef *more;
+  struct dirent      *entry;
+  DIR                *dir = opendir(rootDir);
+  UINT               size = 0;
+
+  *count = 0;
+  if (!dir)
+  {
+    return NULL;
+  }
+  while ((entry = readdir(dir)) != NULL)
+  {
+    if (!FFEMU_validName(entry->d_name))
+    {
+      continue;
+    }
+    if (*count == size)
+    {
+      size = size ? (size * 2) : 32;
+      more = realloc(names, size * sizeof(FFEMU_Name_TypeDef));
+      if (!more)
+      {
+        break;
+      }
+      names = more;
+    }
+    strcpy(names[(*count)++], entry->d_name);
+  }
+  closedir(dir);
+  if (names)
+  {
+    qsort(names, *count, sizeof(FFEMU_Name_TypeDef), FFEMU_compareNames);
+  }
+  return names;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Find entry of root directory by name, without regard to case.
+ * @param[out] hostPath
+ *   Path of entry on host, also when not found, then with name in upper case.
+ * @return
+ *   FR_OK if found, FR_NO_FILE if not, or error if name is not valid.
+ ******************************************************************************/
+static FRESULT FFEMU_find(const TCHAR *path, char *hostPath, size_t size)
+{
+  FFEMU_Name_TypeDef *names;
+  FFEMU_Name_TypeDef name;
+  UINT               count;
+  UINT               i;
+  FRESULT            res = FR_NO_FILE;
+
+  if (!rootDir[0])
+  {
+    return FR_NOT_READY;
+  }
+  while (*path == '/')
+  {
+    path++;
+  }
+  if (strchr(path, '/'))
+  {
+    return FR_NO_PATH;
+  }
+  if (!FFEMU_validName(path))
+  {
+    return FR_INVALID_NAME;
+  }
+
+  /* Directory lookup */
+  ffemuCount.sectorsRead++;
+
+  for (i = 0; path[i]; i++)
+  {
+    name[i] = (char)toupper((unsigned char)path[i]);
+  }
+  name[i] = '\0';
+
+  names = FFEMU_listNames(&count);
+  for (i = 0; i < count; i++)
+  {
+    if (!strcasecmp(names[i], name))
+    {
+      strcpy(name, names[i]);
+      res = FR_OK;
+      break;
+    }
+  }
+  free(names);
+
+  snprintf(hostPath, size, "%s/%s", rootDir, name);
+  return res;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Fill in file status from host file.
+ ******************************************************************************/
+static FRESULT FFEMU_fillInfo(const char *hostPath, const char *name, FILINFO *fno)
+{
+  struct stat st;
+  struct tm   *tm;
+  int         i;
+
+  if (stat(hostPath, &st) != 0)
+  {
+    return FR_NO_FILE;
+  }
+  tm = localtime(&st.st_mtime);
+
+  fno->fsize   = S_ISDIR(st.st_mode) ? 0 : (DWORD) st.st_size;
+  fno->fattrib = S_ISDIR(st.st_mode) ? AM_DIR : AM_ARC;
+  fno->fdate   = (WORD)(((tm->tm_year - 80) << 9) | ((tm->tm_mon + 1) << 5) | tm->tm_mday);
+  fno->ftime   = (WORD)((tm->tm_hour << 11) | (tm->tm_min << 5) | (tm->tm_sec / 2));
+  for (i = 0; name[i] && (i < 12); i++)
+  {
+    fno->fname[i] = (TCHAR) toupper((unsigned char)name[i]);
+  }
+  fno->fname[i] = '\0';
+  return FR_OK;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Count sectors accessed when transferring bytes from or to file, through
+ *   the file window for parts of a sector, directly for whole sectors.
+ ******************************************************************************/
+static void FFEMU_access(FIL *fp, DWORD ofs, UINT len, bool write)
+{
+  DWORD sect;
+  DWORD in;
+  DWORD n;
+
+  while (len)
+  {
+    sect = ofs / FFEMU_SECTOR_SIZE;
+    in   = ofs % FFEMU_SECTOR_SIZE;
+    n    = FFEMU_SECTOR_SIZE - in;
+    if (n > len)
+    {
+      n = len;
+    }
+
+    if (n == FFEMU_SECTOR_SIZE)
+    {
+      if (write)
+      {
+        ffemuCount.sectorsWritten++;
+        if (fp->sect == sect)
+        {
+          fp->dirty = 0;
+        }
+      }
+      else
+      {
+        ffemuCount.sectorsRead++;
+      }
+    }
+    else
+    {
+      if (fp->sect != sect)
+      {
+        if (fp->dirty)
+        {
+          ffemuCount.sectorsWritten++;
+          fp->dirty = 0;
+        }
+        /* Sector is read unless written beyond end of file */
+        if (!write || ((ofs - in) < fp->fsize))
+        {
+          ffemuCount.sectorsRead++;
+        }
+        fp->sect = sect;
+      }
+      if (write)
+      {
+        fp->dirty = 1;
+      }
+    }
+    ofs += n;
+    len -= n;
+  }
+}
+
+FRESULT f_mount(BYTE vol, FATFS *fs)
+{
+  if (vol != 0)
+  {
+    return FR_INVALID_DRIVE;
+  }
+  if (fs)
+  {
+    fs->mounted = rootDir[0] ? 1 : 0;
+  }
+  return FR_OK;
+}
+
+FRESULT f_open(FIL *fp, const TCHAR *path, BYTE mode)
+{
+  char    hostPath[300];
+  FRESULT res;
+
+  fp->file = NULL;
+  res = FFEMU_find(path, hostPath, sizeof(hostPath));
+  if ((res != FR_OK) && (res != FR_NO_FILE))
+  {
+    return res;
+  }
+  if (res == FR_OK)
+  {
+    if (mode & FA_CREATE_NEW)
+    {
+      return FR_EXIST;
+    }
+    fp->file = fopen(hostPath, (mode & FA_CREATE_ALWAYS) ? "w+b" :
+                               ((mode & FA_WRITE) ? "r+b" : "rb"));
+  }
+  else if (mode & (FA_CREATE_NEW | FA_CREATE_ALWAYS | FA_OPEN_ALWAYS))
+  {
+    fp->file = fopen(hostPath, "w+b");
+  }
+  else
+  {
+    return FR_NO_FILE;
+  }
+  if (!fp->file)
+  {
+    return FR_DENIED;
+  }
+
+  ffemuCount.opens++;
+  fseek(fp->file, 0, SEEK_END);
+  fp->fsize = (DWORD) ftell(fp->file);
+  fp->fptr  = 0;
+  fp->sect  = FFEMU_NO_SECTOR;
+  fp->dirty = 0;
+  fp->flag  = mode & (FA_READ | FA_WRITE);
+  if (mode & (FA_CREATE_NEW | FA_CREATE_ALWAYS))
+  {
+    fp->flag |= FFEMU_WRITTEN;
+  }
+  return FR_OK;
+}
+
+FRESULT f_read(FIL *fp, void *buff, UINT btr, UINT *br)
+{
+  *br = 0;
+  if (!fp->file)
+  {
+    return FR_INVALID_OBJECT;
+  }
+  if (!(fp->flag & FA_READ))
+  {
+    return FR_DENIED;
+  }
+  if (btr > (fp->fsize - fp->fptr))
+  {
+    btr = fp->fsize - fp->fptr;
+  }
+  fseek(fp->file, fp->fptr, SEEK_SET);
+  if (fread(buff, 1, btr, fp->file) != btr)
+  {
+    return FR_DISK_ERR;
+  }
+  FFEMU_access(fp, fp->fptr, btr, false);
+  fp->fptr += btr;
+  *br       = btr;
+  return FR_OK;
+}
+
+FRESULT f_write(FIL *fp, const void *buff, UINT btw, UINT *bw)
+{
+  *bw = 0;
+  if (!fp->file)
+  {
+    return FR_INVALID_OBJECT;
+  }
+  if (!(fp->flag & FA_WRITE))
+  {
+    return FR_DENIED;
+  }
+  fseek(fp->file, fp->fptr, SEEK_SET);
+  if (fwrite(buff, 1, btw, fp->file) != btw)
+  {
+    return FR_DISK_ERR;
+  }
+  FFEMU_access(fp, fp->fptr, btw, true);
+  fp->fptr += btw;
+  if (fp->fptr > fp->fsize)
+  {
+    fp->fsize = fp->fptr;
+  }
+  fp->flag |= FFEMU_WRITTEN;
+  *bw       = btw;
+  return FR_OK;
+}
+
+FRESULT f_lseek(FIL *fp, DWORD ofs)
+{
+  if (!fp->file)
+  {
+    return FR_INVALID_OBJECT;
+  }
+  if (ofs > fp->fsize)
+  {
+    /* File is extended in write mode, as by FatFS */
+    if (!(fp->flag & FA_WRITE))
+    {
+      ofs = fp->fsize;
+    }
+    else
+    {
+      fflush(fp->file);
+      if (ftruncate(fileno(fp->file), ofs) != 0)
+      {
+        return FR_DISK_ERR;
+      }
+      fp->fsize = ofs;
+      fp->flag |= FFEMU_WRITTEN;
+    }
+  }
+  fp->fptr = ofs;
+  return FR_OK;
+}
+
+FRESULT f_truncate(FIL *fp)
+{
+  if (!fp->file)
+  {
+    return FR_INVALID_OBJECT;
+  }
+  if (!(fp->flag & FA_WRITE))
+  {
+    return FR_DENIED;
+  }
+  if (fp->fptr < fp->fsize)
+  {
+    fflush(fp->file);
+    if (ftruncate(fileno(fp->file), fp->fptr) != 0)
+    {
+      return FR_DISK_ERR;
+    }
+    fp->fsize = fp->fptr;
+    fp->flag |= FFEMU_WRITTEN;
+
+    /* Clusters released in FAT */
+    ffemuCount.sectorsWritten++;
+  }
+  return FR_OK;
+}
+
+FRESULT f_sync(FIL *fp)
+{
+  if (!fp->file)
+  {
+    return FR_INVALID_OBJECT;
+  }
+  if (fp->dirty)
+  {
+    ffemuCount.sectorsWritten++;
+    fp->dirty = 0;
+  }
+  if (fp->flag & FFEMU_WRITTEN)
+  {
+    /* Directory entry updated with size and time */
+    ffemuCount.sectorsWritten++;
+    fp->flag &= ~FFEMU_WRITTEN;
+  }
+  return (fflush(fp->file) == 0) ? FR_OK : FR_DISK_ERR;
+}
+
+FRESULT f_close(FIL *fp)
+{
+  FRESULT res = f_sync(fp);
+
+  if (res == FR_INVALID_OBJECT)
+  {
+    return res;
+  }
+  if ((fclose(fp->file) != 0) && (res == FR_OK))
+  {
+    res = FR_DISK_ERR;
+  }
+  fp->file = NULL;
+  return res;
+}
+
+FRESULT f_opendir(FF_DIR *dj, const TCHAR *path)
+{
+  if (!rootDir[0])
+  {
+    return FR_NOT_READY;
+  }
+  while (*path == '/')
+  {
+    path++;
+  }
+  if (*path)
+  {
+    return FR_NO_PATH;
+  }
+  dj->index = 0;
+  return FR_OK;
+}
+
+FRESULT f_readdir(FF_DIR *dj, FILINFO *fno)
+{
+  FFEMU_Name_TypeDef *names;
+  char               hostPath[300];
+  UINT               count;
+  FRESULT            res = FR_OK;
+
+  if ((dj->index % FFEMU_DIR_ENTRIES) == 0)
+  {
+    ffemuCount.sectorsRead++;
+  }
+
+  names = FFEMU_listNames(&count);
+  if (dj->index < count)
+  {
+    snprintf(hostPath, sizeof(hostPath), "%s/%s", rootDir, names[dj->index]);
+    res = FFEMU_fillInfo(hostPath, names[dj->index], fno);
+    dj->index++;
+  }
+  else
+  {
+    fno->fname[0] = '\0';
+  }
+  free(names);
+  return res;
+}
+
+FRESULT f_stat(const TCHAR *path, FILINFO *fno)
+{
+  char    hostPath[300];
+  FRESULT res = FFEMU_find(path, hostPath, sizeof(hostPath));
+
+  if (res != FR_OK)
+  {
+    return res;
+  }
+  return FFEMU_fillInfo(hostPath, strrchr(hostPath, '/') + 1, fno);
+}
+
+FRESULT f_unlink(const TCHAR *path)
+{
+  char    hostPath[300];
+  FRESULT res = FFEMU_find(path, hostPath, sizeof(hostPath));
+
+  if (res != FR_OK)
+  {
+    return res;
+  }
+  if (remove(hostPath) != 0)
+  {
+    return FR_DENIED;
+  }
+  ffemuCount.sectorsWritten++;
+  return FR_OK;
+}
+
+TCHAR *f_gets(TCHAR *buff, int len, FIL *fp)
+{
+  int  n = 0;
+  UINT rc;
+  char c;
+
+  while (n < (len - 1))
+  {
+    if ((f_read(fp, &c, 1, &rc) != FR_OK) || (rc != 1))
+    {
+      break;
+    }
+    buff[n++] = c;
+    if (c == '\n')
+    {
+      break;
+    }
+  }
+  buff[n] = '\0';
+  return n ? buff : NULL;
+}
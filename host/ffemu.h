@@ -0,0 +1,81 @@
+/**************************************************************************//**
+ * @file
+ * @brief Host (Linux) emulation of the FAT file system on the microSD card
+ * @author Energy Micro AS
+ * @version 3.20.0
+ ******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 Energy Micro AS, http://www.energymicro.com</b>
+ *******************************************************************************
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ * 4. The source and compiled code may only be used on Energy Micro "EFM32"
+ *    microcontrollers and "EFR4" radios.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: Energy Micro AS has no
+ * obligation to support this Software. Energy Micro AS is providing the
+ * Software "AS IS", with no express or implied warranties of any kind,
+ * including, but not limited to, any implied warranties of merchantability
+ * or fitness for any particular purpose or warranties against infringement
+ * of any proprietary rights of a third party.
+ *
+ * Energy Micro AS will not be liable for any consequential, incidental, or
+ * special damages, or any other relief, or for any claim by any third party,
+ * arising from your use of this Software.
+ *
+ *****************************************************************************/
+#ifndef __FFEMU_H
+#define __FFEMU_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+   Host (Linux) emulation of the FatFS file system on the microSD card.
+
+   Implements the FatFS entry points used by the slideshow (include/ff.h)
+   on files in a host directory, which is the root directory of the card.
+
+   Card traffic is counted in 512 byte sectors the way FatFS accesses
+   them: each open file has a one sector window, so reads and writes of
+   parts of a sector only access the card when they leave the window,
+   while whole sectors are transferred directly. Opening a file or looking
+   up its status reads one directory sector, listing a directory one
+   sector per 16 entries, and updating the directory entry of a file
+   written writes one sector. FAT sectors read when following a cluster
+   chain are not counted, as FatFS keeps the FAT sector last used.
+*/
+
+/** Sector size of card */
+#define FFEMU_SECTOR_SIZE  512
+
+/** Card access counters */
+typedef struct
+{
+  uint32_t sectorsRead;     /**< Sectors read from card */
+  uint32_t sectorsWritten;  /**< Sectors written to card */
+  uint32_t opens;           /**< Files opened */
+} FFEMU_Count_TypeDef;
+
+extern FFEMU_Count_TypeDef ffemuCount;
+
+bool FFEMU_init(const char *root);
+void FFEMU_resetCount(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
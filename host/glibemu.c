@@ -0,0 +1,217 @@
+/**************************************************************************//**
+ * @file
+ * @brief Host (Linux) emulation of GLIB graphics library
+ * @author Energy Micro AS
+ * @version 3.20.0
+ ******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 Energy Micro AS, http://www.energymicro.com</b>
+ *******************************************************************************
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ * 4. The source and compiled code may only be used on Energy Micro "EFM32"
+ *    microcontrollers and "EFR4" radios.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: Energy Micro AS has no
+ * obligation to support this Software. Energy Micro AS is providing the
+ * Software "AS IS", with no express or implied warranties of any kind,
+ * including, but not limited to, any implied warranties of merchantability
+ * or fitness for any particular purpose or warranties against infringement
+ * of any proprietary rights of a third party.
+ *
+ * Energy Micro AS will not be liable for any consequential, incidental, or
+ * special damages, or any other relief, or for any claim by any third party,
+ * arising from your use of this Software.
+ *
+ *****************************************************************************/
+#include "glib/glib.h"
+#include "glib/glib_font.h"
+#include "dmd/ssd2119/dmd_ssd2119.h"
+#include "glib/glib_color.h"
+#include "dmdemu.h"
+
+uint8_t fontBits[FONT_CHARACTERS * FONT_HEIGHT];
+
+/***************************************************************************//**
+ * @brief
+ *   Make up font bitmaps: a blank top and bottom row, and 6 rows of pixels
+ *   different for every character. Space is left blank.
+ ******************************************************************************/
+static void GLIB_initFont(void)
+{
+  uint32_t seed;
+  int      c, row;
+
+  for (c = 0; c < FONT_CHARACTERS; c++)
+  {
+    seed = 0x9e3779b9u * (uint32_t)(c + 1);
+    for (row = 0; row < FONT_HEIGHT; row++)
+    {
+      seed = (seed * 1103515245u) + 12345u;
+      fontBits[(row * FONT_BITS_LINE_SKIP) + c] =
+        ((c == 0) || (row == 0) || (row == (FONT_HEIGHT - 1))) ?
+        0 : (uint8_t)((seed >> 16) & 0x7e);
+    }
+  }
+}
+
+EMSTATUS GLIB_contextInit(GLIB_Context *pContext)
+{
+  GLIB_initFont();
+  pContext->foregroundColor = White;
+  pContext->backgroundColor = Black;
+  return GLIB_resetClippingRegion(pContext);
+}
+
+uint32_t GLIB_rgbColor(uint8_t red, uint8_t green, uint8_t blue)
+{
+  return ((uint32_t)red << 16) | ((uint32_t)green << 8) | blue;
+}
+
+EMSTATUS GLIB_clear(GLIB_Context *pContext)
+{
+  uint32_t color = pContext->backgroundColor;
+  EMSTATUS status;
+
+  status = GLIB_resetDisplayClippingArea(pContext);
+  if (status != DMD_OK)
+  {
+    return status;
+  }
+  return DMD_writeColor(0, 0, color >> 16, color >> 8, color,
+                        DMDEMU_WIDTH * DMDEMU_HEIGHT);
+}
+
+EMSTATUS GLIB_setClippingRegion(GLIB_Context *pContext, const GLIB_Rectangle *pRect)
+{
+  if ((pRect->xMin > pRect->xMax) || (pRect->yMin > pRect->yMax) ||
+      (pRect->xMin < 0) || (pRect->yMin < 0) ||
+      (pRect->xMax >= DMDEMU_WIDTH) || (pRect->yMax >= DMDEMU_HEIGHT))
+  {
+    return GLIB_ERROR_INVALID_REGION;
+  }
+  pContext->clippingRegion = *pRect;
+  return GLIB_OK;
+}
+
+EMSTATUS GLIB_resetClippingRegion(GLIB_Context *pContext)
+{
+  pContext->clippingRegion.xMin = 0;
+  pContext->clippingRegion.yMin = 0;
+  pContext->clippingRegion.xMax = DMDEMU_WIDTH - 1;
+  pContext->clippingRegion.yMax = DMDEMU_HEIGHT - 1;
+  return GLIB_OK;
+}
+
+EMSTATUS GLIB_resetDisplayClippingArea(GLIB_Context *pContext)
+{
+  (void)pContext;
+  return DMD_setClippingArea(0, 0, DMDEMU_WIDTH, DMDEMU_HEIGHT);
+}
+
+EMSTATUS GLIB_drawPixelColor(GLIB_Context *pContext, int32_t x, int32_t y, uint32_t color)
+{
+  if ((x < pContext->clippingRegion.xMin) || (x > pContext->clippingRegion.xMax) ||
+      (y < pContext->clippingRegion.yMin) || (y > pContext->clippingRegion.yMax))
+  {
+    return GLIB_ERROR_PIXEL_OUT_OF_BOUNDS;
+  }
+  return DMD_writeColor(x, y, color >> 16, color >> 8, color, 1);
+}
+
+EMSTATUS GLIB_drawPixelRGB(int32_t x, int32_t y, uint8_t red, uint8_t green, uint8_t blue)
+{
+  if ((x < 0) || (x >= DMDEMU_WIDTH) || (y < 0) || (y >= DMDEMU_HEIGHT))
+  {
+    return GLIB_ERROR_PIXEL_OUT_OF_BOUNDS;
+  }
+  return DMD_writeColor(x, y, red, green, blue, 1);
+}
+
+EMSTATUS GLIB_drawRectFilled(GLIB_Context *pContext, const GLIB_Rectangle *pRect)
+{
+  GLIB_Rectangle rect = *pRect;
+  uint32_t       color = pContext->foregroundColor;
+  EMSTATUS       status;
+
+  /* Clip to clipping region */
+  if (rect.xMin < pContext->clippingRegion.xMin) rect.xMin = pContext->clippingRegion.xMin;
+  if (rect.yMin < pContext->clippingRegion.yMin) rect.yMin = pContext->clippingRegion.yMin;
+  if (rect.xMax > pContext->clippingRegion.xMax) rect.xMax = pContext->clippingRegion.xMax;
+  if (rect.yMax > pContext->clippingRegion.yMax) rect.yMax = pContext->clippingRegion.yMax;
+  if ((rect.xMin > rect.xMax) || (rect.yMin > rect.yMax))
+  {
+    return GLIB_OK;
+  }
+
+  status = DMD_setClippingArea(rect.xMin, rect.yMin,
+                               rect.xMax - rect.xMin + 1, rect.yMax - rect.yMin + 1);
+  if (status == DMD_OK)
+  {
+    status = DMD_writeColor(0, 0, color >> 16, color >> 8, color,
+                            (rect.xMax - rect.xMin + 1) * (rect.yMax - rect.yMin + 1));
+  }
+  if (status == DMD_OK)
+  {
+    status = GLIB_resetDisplayClippingArea(pContext);
+  }
+  return status;
+}
+
+EMSTATUS GLIB_drawChar(GLIB_Context *pContext, char myChar, int32_t x, int32_t y,
+                       bool opaque)
+{
+  uint32_t fontIdx;
+  int      row, col;
+
+  if (((uint8_t)myChar < FONT_ASCII_START) ||
+      ((uint8_t)myChar >= (FONT_ASCII_START + FONT_CHARACTERS)))
+  {
+    return GLIB_ERROR_INVALID_CHAR;
+  }
+  fontIdx = (uint8_t)myChar - FONT_ASCII_START;
+  for (row = 0; row < FONT_HEIGHT; row++)
+  {
+    for (col = 0; col < FONT_WIDTH; col++)
+    {
+      if (fontBits[fontIdx] & (FONT_BITS_MASK << col))
+      {
+        GLIB_drawPixelColor(pContext, x + col, y + row, pContext->foregroundColor);
+      }
+      else if (opaque)
+      {
+        GLIB_drawPixelColor(pContext, x + col, y + row, pContext->backgroundColor);
+      }
+    }
+    fontIdx += FONT_BITS_LINE_SKIP;
+  }
+  return GLIB_OK;
+}
+
+EMSTATUS GLIB_drawString(GLIB_Context *pContext, char *pString, uint32_t sLength,
+                         int32_t x0, int32_t y0, bool opaque)
+{
+  int32_t  x = x0;
+  uint32_t i;
+
+  for (i = 0; i < sLength; i++)
+  {
+    if (pString[i] == '\n')
+    {
+      x   = x0;
+      y0 += FONT_HEIGHT;
+      continue;
+    }
+    GLIB_drawChar(pContext, pString[i], x, y0, opaque);
+    x += FONT_WIDTH;
+  }
+  return GLIB_OK;
+}
@@ -0,0 +1,142 @@
+/**************************************************************************//**
+ * @file
+ * @brief Golden image tests for TFT examples
+ * @author Energy Micro AS
+ * @version 3.20.0
+ ******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 Energy Micro AS, http://www.energymicro.com</b>
+ *******************************************************************************
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ * 4. The source and compiled code may only be used on Energy Micro "EFM32"
+ *    microcontrollers and "EFR4" radios.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: Energy Micro AS has no
+ * obligation to support this Software. Energy Micro AS is providing the
+ * Software "AS IS", with no express or implied warranties of any kind,
+ * including, but not limited to, any implied warranties of merchantability
+ * or fitness for any particular purpose or warranties against infringement
+ * of any proprietary rights of a third party.
+ *
+ * Energy Micro AS will not be liable for any consequential, incidental, or
+ * special damages, or any other relief, or for any claim by any third party,
+ * arising from your use of this Software.
+ *
+ *****************************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "dmdemu.h"
+#include "golden.h"
+
+/***************************************************************************//**
+ * @brief
+ *   Run golden image test.
+ *
+ * @param[in] test
+ *   Test name, used in file names.
+ *
+ * @param[in] scenes
+ *   Scenes to draw, in order.
+ *
+ * @param[in] count
+ *   Number of scenes.
+ *
+ * @param[in] argc
+ *   Number of command line arguments.
+ *
+ * @param[in] argv
+ *   Command line arguments, see golden.h.
+ *
+ * @return
+ *   Number of failed scenes, to be used as exit status.
+ ******************************************************************************/
+int GOLDEN_run(const char *test, const GOLDEN_Scene_TypeDef *scenes,
+               int count, int argc, char *argv[])
+{
+  const char *ppmDir = NULL;
+  char       fileName[256];
+  uint32_t   checksum[GOLDEN_MAX_SCENES];
+  clock_t    start;
+  double     ms;
+  int        update = 0;
+  int        errors = 0;
+  int        i;
+
+  for (i = 1; i < argc; i++)
+  {
+    if ((strcmp(argv[i], "-w") == 0) && ((i + 1) < argc))
+    {
+      ppmDir = argv[++i];
+    }
+    else if (strcmp(argv[i], "-u") == 0)
+    {
+      update = 1;
+    }
+    else
+    {
+      fprintf(stderr, "Usage: %s [-w dir] [-u]\n", argv[0]);
+      return 1;
+    }
+  }
+
+  if (count > GOLDEN_MAX_SCENES)
+  {
+    count = GOLDEN_MAX_SCENES;
+  }
+
+  DMDEMU_reset();
+  printf("%-12s %12s %8s %8s %10s %10s\n",
+         test, "transactions", "windows", "pixels", "ms", "checksum");
+  for (i = 0; i < count; i++)
+  {
+    DMDEMU_resetCount();
+    start = clock();
+    scenes[i].draw();
+    ms       = (double)(clock() - start) * 1000 / CLOCKS_PER_SEC;
+    checksum[i] = DMDEMU_checksum();
+
+    printf("%-12s %12lu %8lu %8lu %10.3f   %08lx %s\n", scenes[i].name,
+           (unsigned long)dmdemuCount.transactions,
+           (unsigned long)dmdemuCount.windows,
+           (unsigned long)dmdemuCount.pixels, ms, (unsigned long)checksum[i],
+           (checksum[i] == scenes[i].checksum) ? "ok" : "FAIL");
+    if (checksum[i] != scenes[i].checksum)
+    {
+      errors++;
+    }
+
+    if (ppmDir)
+    {
+      snprintf(fileName, sizeof(fileName), "%s/%s_%s.ppm",
+               ppmDir, test, scenes[i].name);
+      if (!DMDEMU_writePpm(fileName))
+      {
+        fprintf(stderr, "%s: cannot write\n", fileName);
+        errors++;
+      }
+    }
+  }
+
+  if (update)
+  {
+    printf("\n");
+    for (i = 0; i < count; i++)
+    {
+      printf("  { \"%s\", ..., 0x%08lx },\n", scenes[i].name,
+             (unsigned long)checksum[i]);
+    }
+  }
+
+  printf("%s\n", errors ? "FAILED" : "All scenes match golden images");
+  return errors;
+}
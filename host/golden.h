@@ -0,0 +1,76 @@
+/**************************************************************************//**
+ * @file
+ * @brief Golden image tests for TFT examples
+ * @author Energy Micro AS
+ * @version 3.20.0
+ ******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 Energy Micro AS, http://www.energymicro.com</b>
+ *******************************************************************************
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ * 4. The source and compiled code may only be used on Energy Micro "EFM32"
+ *    microcontrollers and "EFR4" radios.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: Energy Micro AS has no
+ * obligation to support this Software. Energy Micro AS is providing the
+ * Software "AS IS", with no express or implied warranties of any kind,
+ * including, but not limited to, any implied warranties of merchantability
+ * or fitness for any particular purpose or warranties against infringement
+ * of any proprietary rights of a third party.
+ *
+ * Energy Micro AS will not be liable for any consequential, incidental, or
+ * special damages, or any other relief, or for any claim by any third party,
+ * arising from your use of this Software.
+ *
+ *****************************************************************************/
+#ifndef __GOLDEN_H
+#define __GOLDEN_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+   Golden image tests for the TFT examples on the emulated display.
+
+   A test is a sequence of scenes, each calling example drawing code. The
+   framebuffer is kept from one scene to the next, as on the display.
+   After each scene, the framebuffer checksum is compared with the golden
+   value recorded from a known good image, and display transactions,
+   pixels written and host time are reported.
+
+   Options:
+     -w <dir>  save framebuffer after each scene as <dir>/<test>_<scene>.ppm
+     -u        print checksums in golden table form, to update the tables
+*/
+
+/** Max number of scenes in a test */
+#define GOLDEN_MAX_SCENES  16
+
+/** Scene of a golden image test */
+typedef struct
+{
+  const char *name;          /**< Scene name */
+  void       (*draw)(void);  /**< Drawing code */
+  uint32_t   checksum;       /**< Golden framebuffer checksum */
+} GOLDEN_Scene_TypeDef;
+
+int GOLDEN_run(const char *test, const GOLDEN_Scene_TypeDef *scenes,
+               int count, int argc, char *argv[]);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
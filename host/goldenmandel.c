@@ -0,0 +1,57 @@
+/**************************************************************************//**
+ * @file
+ * @brief Golden image test for mandel example
+ * @author Energy Micro AS
+ * @version 3.20.0
+ ******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 Energy Micro AS, http://www.energymicro.com</b>
+ *******************************************************************************
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ * 4. The source and compiled code may only be used on Energy Micro "EFM32"
+ *    microcontrollers and "EFR4" radios.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: Energy Micro AS has no
+ * obligation to support this Software. Energy Micro AS is providing the
+ * Software "AS IS", with no express or implied warranties of any kind,
+ * including, but not limited to, any implied warranties of merchantability
+ * or fitness for any particular purpose or warranties against infringement
+ * of any proprietary rights of a third party.
+ *
+ * Energy Micro AS will not be liable for any consequential, incidental, or
+ * special damages, or any other relief, or for any claim by any third party,
+ * arising from your use of this Software.
+ *
+ *****************************************************************************/
+/*
+   Golden image test for the mandel example: the start screen with its
+   caption, and the mandelbrot image drawn one pixel per DMD call.
+
+   Usage: goldenmandel [-w dir] [-u]
+*/
+
+#include "mandeldraw.h"
+#include "golden.h"
+
+static const GOLDEN_Scene_TypeDef scenes[] =
+{
+  { "init",  TFT_init,      0x1a5150a5 },
+  { "image", TFT_drawImage, 0xf95152b6 },
+};
+
+/***************************************************************************//**
+ * @brief Main function
+ ******************************************************************************/
+int main(int argc, char *argv[])
+{
+  return GOLDEN_run("mandel", scenes, sizeof(scenes) / sizeof(scenes[0]), argc, argv);
+}
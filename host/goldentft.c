@@ -0,0 +1,59 @@
+/**************************************************************************//**
+ * @file
+ * @brief Golden image test for tft example
+ * @author Energy Micro AS
+ * @version 3.20.0
+ ******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 Energy Micro AS, http://www.energymicro.com</b>
+ *******************************************************************************
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ * 4. The source and compiled code may only be used on Energy Micro "EFM32"
+ *    microcontrollers and "EFR4" radios.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: Energy Micro AS has no
+ * obligation to support this Software. Energy Micro AS is providing the
+ * Software "AS IS", with no express or implied warranties of any kind,
+ * including, but not limited to, any implied warranties of merchantability
+ * or fitness for any particular purpose or warranties against infringement
+ * of any proprietary rights of a third party.
+ *
+ * Energy Micro AS will not be liable for any consequential, incidental, or
+ * special damages, or any other relief, or for any claim by any third party,
+ * arising from your use of this Software.
+ *
+ *****************************************************************************/
+/*
+   Golden image test for the tft example: the start screen, and two more
+   rectangle patterns drawn through the compositor, with the compressed
+   digits image.
+
+   Usage: goldentft [-w dir] [-u]
+*/
+
+#include "tftdraw.h"
+#include "golden.h"
+
+static const GOLDEN_Scene_TypeDef scenes[] =
+{
+  { "init",    TFT_init,          0x2ba8e979 },
+  { "update1", TFT_displayUpdate, 0x58f337ea },
+  { "update2", TFT_displayUpdate, 0x5288cecf },
+};
+
+/***************************************************************************//**
+ * @brief Main function
+ ******************************************************************************/
+int main(int argc, char *argv[])
+{
+  return GOLDEN_run("tft", scenes, sizeof(scenes) / sizeof(scenes[0]), argc, argv);
+}
@@ -0,0 +1,133 @@
+/**************************************************************************//**
+ * @file
+ * @brief Golden image test for tftemode example
+ * @author Energy Micro AS
+ * @version 3.20.0
+ ******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 Energy Micro AS, http://www.energymicro.com</b>
+ *******************************************************************************
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ * 4. The source and compiled code may only be used on Energy Micro "EFM32"
+ *    microcontrollers and "EFR4" radios.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: Energy Micro AS has no
+ * obligation to support this Software. Energy Micro AS is providing the
+ * Software "AS IS", with no express or implied warranties of any kind,
+ * including, but not limited to, any implied warranties of merchantability
+ * or fitness for any particular purpose or warranties against infringement
+ * of any proprietary rights of a third party.
+ *
+ * Energy Micro AS will not be liable for any consequential, incidental, or
+ * special damages, or any other relief, or for any claim by any third party,
+ * arising from your use of this Software.
+ *
+ *****************************************************************************/
+/*
+   Golden image test for the tftemode example text. tftemode.c itself
+   needs the board controller and is not run; its demo screen text is
+   drawn here, once per pixel with GLIB_drawString() and once through the
+   glyph cache (tftglyph.c). Both must give the same golden image.
+
+   Usage: goldentftemode [-w dir] [-u]
+*/
+
+#include <string.h>
+#include "glib/glib.h"
+#include "dmd/ssd2119/dmd_ssd2119.h"
+#include "bsp.h"
+#include "tftglyph.h"
+#include "golden.h"
+
+/** Text of the demo screen, as in tftemode.c */
+static char *description[] =
+{
+  "Use joystick Up and Down to select     ",
+  "various energy mode demos.             ",
+  "Press PB1 to activate demo.            ",
+  "After activition, press AEM button to  ",
+  "go back to board control and AEM screen",
+  "The EFM32 display will not be          ",
+  "refreshed until restart.               ",
+  "Reset MCU to try other demos.          ",
+  "Make sure debugger is disconnected.    ",
+};
+static const int32_t descriptionY[] = { 0, 8, 24, 40, 48, 64, 72, 88, 104 };
+
+static char *selected = "Energy Mode 0 - 32MHz / Primes";
+
+static GLIB_Context gc;
+
+typedef EMSTATUS (*drawString_TypeDef)(GLIB_Context *pContext, char *pString,
+                                       uint32_t sLength, int32_t x0,
+                                       int32_t y0, bool opaque);
+
+/***************************************************************************//**
+ * @brief Draw through glyph cache, with GLIB_drawString() parameters.
+ ******************************************************************************/
+static EMSTATUS drawCached(GLIB_Context *pContext, char *pString,
+                           uint32_t sLength, int32_t x0, int32_t y0,
+                           bool opaque)
+{
+  return TFTGLYPH_drawString(pContext, pString, sLength, x0, y0, opaque);
+}
+
+/***************************************************************************//**
+ * @brief Clear display and draw demo screen text, as tftemode.c does.
+ ******************************************************************************/
+static void drawScreen(drawString_TypeDef drawString)
+{
+  int i;
+
+  DMD_init(BC_SSD2119_BASE, BC_SSD2119_BASE + 2);
+  GLIB_contextInit(&gc);
+  TFTGLYPH_init();
+  GLIB_clear(&gc);
+
+  gc.foregroundColor = GLIB_rgbColor(200, 200, 200);
+  gc.backgroundColor = GLIB_rgbColor(0, 0, 0);
+  for (i = 0; i < 9; i++)
+  {
+    if (i == 7)
+    {
+      gc.foregroundColor = GLIB_rgbColor(200, 200, 100);
+    }
+    drawString(&gc, description[i], strlen(description[i]), 0, descriptionY[i], 1);
+  }
+  gc.foregroundColor = GLIB_rgbColor(100, 200, 100);
+  gc.backgroundColor = GLIB_rgbColor(50, 50, 50);
+  drawString(&gc, selected, strlen(selected), 40, 150, 1);
+}
+
+static void drawPerPixel(void)
+{
+  drawScreen(GLIB_drawString);
+}
+
+static void drawGlyphCache(void)
+{
+  drawScreen(drawCached);
+}
+
+static const GOLDEN_Scene_TypeDef scenes[] =
+{
+  { "glib",  drawPerPixel,   0x16a960c8 },
+  { "glyph", drawGlyphCache, 0x16a960c8 },
+};
+
+/***************************************************************************//**
+ * @brief Main function
+ ******************************************************************************/
+int main(int argc, char *argv[])
+{
+  return GOLDEN_run("tftemode", scenes, sizeof(scenes) / sizeof(scenes[0]), argc, argv);
+}
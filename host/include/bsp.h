@@ -0,0 +1,68 @@
+/**************************************************************************//**
+ * @file
+ * @brief Host (Linux) emulation of board support package
+ * @author Energy Micro AS
+ * @version 3.20.0
+ ******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 Energy Micro AS, http://www.energymicro.com</b>
+ *******************************************************************************
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ * 4. The source and compiled code may only be used on Energy Micro "EFM32"
+ *    microcontrollers and "EFR4" radios.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: Energy Micro AS has no
+ * obligation to support this Software. Energy Micro AS is providing the
+ * Software "AS IS", with no express or implied warranties of any kind,
+ * including, but not limited to, any implied warranties of merchantability
+ * or fitness for any particular purpose or warranties against infringement
+ * of any proprietary rights of a third party.
+ *
+ * Energy Micro AS will not be liable for any consequential, incidental, or
+ * special damages, or any other relief, or for any claim by any third party,
+ * arising from your use of this Software.
+ *
+ *****************************************************************************/
+#ifndef __BSP_H
+#define __BSP_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+   Host (Linux) emulation of the board support functions referenced by the
+   TFT examples. The board controller always reports the display as given
+   to the EFM32 through SPI, so BSP_BC_CTRL_EBI is not defined and no DMA
+   to the display is used.
+*/
+
+#define BSP_DK
+#define BSP_BC_CTRL_SPI
+
+#define BSP_INIT_DEFAULT    0
+#define BC_SSD2119_BASE     0x84000000
+#define BC_AEMSTATE         0
+#define BC_BUS_CFG          1
+#define BC_BUS_CFG_FSMC     1
+
+static __inline int BSP_Init(int flags) { (void)flags; return 0; }
+static __inline uint16_t BSP_RegisterRead(int reg) { return (reg == BC_AEMSTATE) ? 1 : 0; }
+static __inline int BSP_LedsSet(uint32_t leds) { (void)leds; return 0; }
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
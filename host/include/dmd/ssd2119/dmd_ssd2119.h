@@ -0,0 +1,67 @@
+/**************************************************************************//**
+ * @file
+ * @brief Host (Linux) emulation of SSD2119 display driver
+ * @author Energy Micro AS
+ * @version 3.20.0
+ ******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 Energy Micro AS, http://www.energymicro.com</b>
+ *******************************************************************************
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ * 4. The source and compiled code may only be used on Energy Micro "EFM32"
+ *    microcontrollers and "EFR4" radios.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: Energy Micro AS has no
+ * obligation to support this Software. Energy Micro AS is providing the
+ * Software "AS IS", with no express or implied warranties of any kind,
+ * including, but not limited to, any implied warranties of merchantability
+ * or fitness for any particular purpose or warranties against infringement
+ * of any proprietary rights of a third party.
+ *
+ * Energy Micro AS will not be liable for any consequential, incidental, or
+ * special damages, or any other relief, or for any claim by any third party,
+ * arising from your use of this Software.
+ *
+ *****************************************************************************/
+#ifndef __DMD_SSD2119_H
+#define __DMD_SSD2119_H
+
+#include "glib/glib.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+   Host (Linux) emulation of the SSD2119 DMD driver interface, implemented
+   by dmdemu.c.
+*/
+
+#define DMD_OK                               0
+#define DMD_ERROR_DRIVER_NOT_INITIALIZED     1
+#define DMD_ERROR_DRIVER_ALREADY_INITIALIZED 2
+#define DMD_ERROR_PIXEL_OUT_OF_BOUNDS        3
+
+EMSTATUS DMD_init(uint32_t cmdRegAddr, uint32_t dataRegAddr);
+EMSTATUS DMD_flipDisplay(int horizontal, int vertical);
+EMSTATUS DMD_setClippingArea(uint16_t xStart, uint16_t yStart,
+                             uint16_t width, uint16_t height);
+EMSTATUS DMD_writeData(uint16_t x, uint16_t y, const uint8_t data[],
+                       uint32_t numPixels);
+EMSTATUS DMD_writeColor(uint16_t x, uint16_t y, uint8_t red,
+                        uint8_t green, uint8_t blue, uint32_t numPixels);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
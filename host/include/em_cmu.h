@@ -0,0 +1,60 @@
+/**************************************************************************//**
+ * @file
+ * @brief Host (Linux) emulation of clock management unit
+ * @author Energy Micro AS
+ * @version 3.20.0
+ ******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 Energy Micro AS, http://www.energymicro.com</b>
+ *******************************************************************************
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ * 4. The source and compiled code may only be used on Energy Micro "EFM32"
+ *    microcontrollers and "EFR4" radios.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: Energy Micro AS has no
+ * obligation to support this Software. Energy Micro AS is providing the
+ * Software "AS IS", with no express or implied warranties of any kind,
+ * including, but not limited to, any implied warranties of merchantability
+ * or fitness for any particular purpose or warranties against infringement
+ * of any proprietary rights of a third party.
+ *
+ * Energy Micro AS will not be liable for any consequential, incidental, or
+ * special damages, or any other relief, or for any claim by any third party,
+ * arising from your use of this Software.
+ *
+ *****************************************************************************/
+#ifndef __EM_CMU_H
+#define __EM_CMU_H
+
+#include <stdint.h>
+
+/*
+   Host (Linux) emulation of the clock functions referenced by the TFT
+   examples, core clock fixed at 32 MHz.
+*/
+
+typedef enum { cmuClock_HF, cmuClock_CORE } CMU_Clock_TypeDef;
+typedef enum { cmuSelect_HFXO } CMU_Select_TypeDef;
+
+static __inline void CMU_ClockSelectSet(CMU_Clock_TypeDef clock, CMU_Select_TypeDef ref)
+{
+  (void)clock;
+  (void)ref;
+}
+
+static __inline uint32_t CMU_ClockFreqGet(CMU_Clock_TypeDef clock)
+{
+  (void)clock;
+  return 32000000;
+}
+
+#endif
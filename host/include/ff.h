@@ -0,0 +1,159 @@
+/**************************************************************************//**
+ * @file
+ * @brief Host (Linux) emulation of the FatFS interface
+ * @author Energy Micro AS
+ * @version 3.20.0
+ ******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 Energy Micro AS, http://www.energymicro.com</b>
+ *******************************************************************************
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ * 4. The source and compiled code may only be used on Energy Micro "EFM32"
+ *    microcontrollers and "EFR4" radios.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: Energy Micro AS has no
+ * obligation to support this Software. Energy Micro AS is providing the
+ * Software "AS IS", with no express or implied warranties of any kind,
+ * including, but not limited to, any implied warranties of merchantability
+ * or fitness for any particular purpose or warranties against infringement
+ * of any proprietary rights of a third party.
+ *
+ * Energy Micro AS will not be liable for any consequential, incidental, or
+ * special damages, or any other relief, or for any claim by any third party,
+ * arising from your use of this Software.
+ *
+ *****************************************************************************/
+#ifndef __FF_H
+#define __FF_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+   Host (Linux) emulation of the FatFS interface used by the slideshow,
+   implemented by ffemu.c on a directory of the host, which is the root
+   directory of the emulated card. As on target, long file names are not
+   enabled: only files with 8.3 names are seen, names are matched without
+   regard to case, and files created get upper case names. Directory
+   entries are returned sorted by name, subdirectories are not supported.
+
+   FatFS sector accesses are counted, see ffemu.h, so that card traffic of
+   the slideshow can be turned into time on the host.
+*/
+
+typedef uint8_t  BYTE;
+typedef uint16_t WORD;
+typedef uint32_t DWORD;
+typedef unsigned int UINT;
+typedef char     TCHAR;
+
+typedef enum
+{
+  FR_OK = 0,
+  FR_DISK_ERR,
+  FR_INT_ERR,
+  FR_NOT_READY,
+  FR_NO_FILE,
+  FR_NO_PATH,
+  FR_INVALID_NAME,
+  FR_DENIED,
+  FR_EXIST,
+  FR_INVALID_OBJECT,
+  FR_WRITE_PROTECTED,
+  FR_INVALID_DRIVE,
+  FR_NOT_ENABLED,
+  FR_NO_FILESYSTEM,
+  FR_MKFS_ABORTED,
+  FR_TIMEOUT,
+  FR_LOCKED,
+  FR_NOT_ENOUGH_CORE,
+  FR_TOO_MANY_OPEN_FILES
+} FRESULT;
+
+/** File access modes */
+#define FA_READ          0x01
+#define FA_OPEN_EXISTING 0x00
+#define FA_WRITE         0x02
+#define FA_CREATE_NEW    0x04
+#define FA_CREATE_ALWAYS 0x08
+#define FA_OPEN_ALWAYS   0x10
+
+/** File attributes */
+#define AM_RDO  0x01
+#define AM_HID  0x02
+#define AM_SYS  0x04
+#define AM_VOL  0x08
+#define AM_DIR  0x10
+#define AM_ARC  0x20
+
+/** File system object */
+typedef struct
+{
+  BYTE mounted;
+} FATFS;
+
+/** File object */
+typedef struct
+{
+  FILE  *file;   /**< Host file, NULL when closed */
+  BYTE  flag;    /**< FA_READ and FA_WRITE as opened */
+  BYTE  dirty;   /**< Sector window written, not yet flushed */
+  DWORD fptr;    /**< File read/write pointer */
+  DWORD fsize;   /**< File size */
+  DWORD sect;    /**< Sector in file window, 0xffffffff if none */
+} FIL;
+
+/** Directory object */
+typedef struct
+{
+  void  *names;  /**< Sorted entry names, owned by ffemu.c */
+  UINT  count;   /**< Number of entries */
+  UINT  index;   /**< Next entry to read */
+} DIR;
+
+/** File status */
+typedef struct
+{
+  DWORD fsize;     /**< File size */
+  WORD  fdate;     /**< Last modified date */
+  WORD  ftime;     /**< Last modified time */
+  BYTE  fattrib;   /**< Attributes */
+  TCHAR fname[13]; /**< 8.3 name, zero terminated */
+} FILINFO;
+
+#define f_eof(fp)   (((fp)->fptr == (fp)->fsize) ? 1 : 0)
+#define f_tell(fp)  ((fp)->fptr)
+#define f_size(fp)  ((fp)->fsize)
+
+FRESULT f_mount(BYTE vol, FATFS *fs);
+FRESULT f_open(FIL *fp, const TCHAR *path, BYTE mode);
+FRESULT f_read(FIL *fp, void *buff, UINT btr, UINT *br);
+FRESULT f_write(FIL *fp, const void *buff, UINT btw, UINT *bw);
+FRESULT f_lseek(FIL *fp, DWORD ofs);
+FRESULT f_truncate(FIL *fp);
+FRESULT f_sync(FIL *fp);
+FRESULT f_close(FIL *fp);
+FRESULT f_opendir(DIR *dj, const TCHAR *path);
+FRESULT f_readdir(DIR *dj, FILINFO *fno);
+FRESULT f_stat(const TCHAR *path, FILINFO *fno);
+FRESULT f_unlink(const TCHAR *path);
+TCHAR *f_gets(TCHAR *buff, int len, FIL *fp);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,79 @@
+/**************************************************************************//**
+ * @file
+ * @brief Host (Linux) emulation of the GLIB BMP decoder
+ * @author Energy Micro AS
+ * @version 3.20.0
+ ******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 Energy Micro AS, http://www.energymicro.com</b>
+ *******************************************************************************
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ * 4. The source and compiled code may only be used on Energy Micro "EFM32"
+ *    microcontrollers and "EFR4" radios.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: Energy Micro AS has no
+ * obligation to support this Software. Energy Micro AS is providing the
+ * Software "AS IS", with no express or implied warranties of any kind,
+ * including, but not limited to, any implied warranties of merchantability
+ * or fitness for any particular purpose or warranties against infringement
+ * of any proprietary rights of a third party.
+ *
+ * Energy Micro AS will not be liable for any consequential, incidental, or
+ * special damages, or any other relief, or for any claim by any third party,
+ * arising from your use of this Software.
+ *
+ *****************************************************************************/
+#ifndef __BMP_H
+#define __BMP_H
+
+#include <stdint.h>
+#include "glib/glib.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+   Host (Linux) emulation of the GLIB BMP decoder, implemented by
+   bmpemu.c. Uncompressed 24 bit and 8 bit palette images are decoded, in
+   file order, that is bottom row first, to 24 bit RGB pixels. File data
+   is read through the callback given to BMP_init(), in the same pieces as
+   on target: headers, palette, and then pixels of at most one row at a
+   time followed by the row padding.
+*/
+
+#define BMP_OK                              0
+#define BMP_ERROR_IO                        1
+#define BMP_ERROR_HEADER_SIZE_MISMATCH      2
+#define BMP_ERROR_ENCODING_NOT_SUPPORTED    3
+#define BMP_ERROR_FILE_NOT_RESET            4
+#define BMP_ERROR_MODULE_NOT_INITIALIZED    5
+#define BMP_ERROR_INVALID_ARGUMENT          6
+#define BMP_ERROR_PALETTE_SIZE_TOO_SMALL    7
+#define BMP_END_OF_FILE                     8
+#define BMP_ERROR_BUFFER_TOO_SMALL          9
+#define BMP_ERROR_INVALID_BMP               10
+
+EMSTATUS BMP_init(uint8_t *palette, uint32_t paletteSize,
+                  EMSTATUS (*fp)(uint8_t buffer[], uint32_t bufLength,
+                                 uint32_t bytesToRead));
+EMSTATUS BMP_reset(void);
+EMSTATUS BMP_readRgbData(uint8_t buffer[], uint32_t bufLength,
+                         uint32_t *pixelsRead);
+int32_t BMP_getWidth(void);
+int32_t BMP_getHeight(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
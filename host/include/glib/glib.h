@@ -0,0 +1,92 @@
+/**************************************************************************//**
+ * @file
+ * @brief Host (Linux) emulation of GLIB graphics library
+ * @author Energy Micro AS
+ * @version 3.20.0
+ ******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 Energy Micro AS, http://www.energymicro.com</b>
+ *******************************************************************************
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ * 4. The source and compiled code may only be used on Energy Micro "EFM32"
+ *    microcontrollers and "EFR4" radios.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: Energy Micro AS has no
+ * obligation to support this Software. Energy Micro AS is providing the
+ * Software "AS IS", with no express or implied warranties of any kind,
+ * including, but not limited to, any implied warranties of merchantability
+ * or fitness for any particular purpose or warranties against infringement
+ * of any proprietary rights of a third party.
+ *
+ * Energy Micro AS will not be liable for any consequential, incidental, or
+ * special damages, or any other relief, or for any claim by any third party,
+ * arising from your use of this Software.
+ *
+ *****************************************************************************/
+#ifndef __GLIB_H
+#define __GLIB_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+   Host (Linux) emulation of the GLIB functions used by the TFT examples,
+   drawing through the emulated DMD driver (dmdemu.c). Text and pixels are
+   drawn one pixel per DMD call, filled rectangles with one DMD call, as
+   GLIB does on target.
+*/
+
+typedef uint32_t EMSTATUS;
+
+#define GLIB_OK                        0
+#define GLIB_ERROR_INVALID_CHAR        0x100
+#define GLIB_ERROR_PIXEL_OUT_OF_BOUNDS 0x101
+#define GLIB_ERROR_INVALID_REGION      0x102
+
+typedef struct
+{
+  int32_t xMin;
+  int32_t yMin;
+  int32_t xMax;
+  int32_t yMax;
+} GLIB_Rectangle;
+
+typedef struct
+{
+  uint32_t       foregroundColor;
+  uint32_t       backgroundColor;
+  GLIB_Rectangle clippingRegion;
+} GLIB_Context;
+
+EMSTATUS GLIB_contextInit(GLIB_Context *pContext);
+uint32_t GLIB_rgbColor(uint8_t red, uint8_t green, uint8_t blue);
+EMSTATUS GLIB_clear(GLIB_Context *pContext);
+EMSTATUS GLIB_setClippingRegion(GLIB_Context *pContext, const GLIB_Rectangle *pRect);
+EMSTATUS GLIB_resetClippingRegion(GLIB_Context *pContext);
+EMSTATUS GLIB_resetDisplayClippingArea(GLIB_Context *pContext);
+EMSTATUS GLIB_drawPixelColor(GLIB_Context *pContext, int32_t x, int32_t y, uint32_t color);
+EMSTATUS GLIB_drawPixelRGB(int32_t x, int32_t y, uint8_t red, uint8_t green, uint8_t blue);
+EMSTATUS GLIB_drawRectFilled(GLIB_Context *pContext, const GLIB_Rectangle *pRect);
+EMSTATUS GLIB_drawChar(GLIB_Context *pContext, char myChar, int32_t x, int32_t y,
+                       bool opaque);
+EMSTATUS GLIB_drawString(GLIB_Context *pContext, char *pString, uint32_t sLength,
+                         int32_t x0, int32_t y0, bool opaque);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
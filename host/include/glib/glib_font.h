@@ -0,0 +1,64 @@
+/**************************************************************************//**
+ * @file
+ * @brief Host (Linux) emulation of GLIB font
+ * @author Energy Micro AS
+ * @version 3.20.0
+ ******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2012 Energy Micro AS, http://www.energymicro.com</b>
+ *******************************************************************************
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ * 4. The source and compiled code may only be used on Energy Micro "EFM32"
+ *    microcontrollers and "EFR4" radios.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: Energy Micro AS has no
+ * obligation to support this Software. Energy Micro AS is providing the
+ * Software "AS IS", with no express or implied warranties of any kind,
+ * including, but not limited to, any implied warranties of merchantability
+ * or fitness for any particular purpose or warranties against infringement
+ * of any proprietary rights of a third party.
+ *
+ * Energy Micro AS will not be liable for any consequential, incidental, or
+ * special damages, or any other relief, or for any claim by any third party,
+ * arising from your use of this Software.
+ *
+ *****************************************************************************/
+#ifndef __GLIB_FONT_H
+#define __GLIB_FONT_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+   Host (Linux) emulation of the GLIB 8x8 font: one byte per character and
+   pixel row, bit 0 leftmost, rows FONT_BITS_LINE_SKIP bytes apart. The
+   GLIB font bitmaps are not part of this kit, so glibemu.c makes up a
+   distinct bitmap for every character, with space left blank.
+*/
+
+#define FONT_WIDTH           8
+#define FONT_HEIGHT          8
+#define FONT_ASCII_START     ' '
+#define FONT_CHARACTERS      100
+#define FONT_BITS_MASK       0x1
+#define FONT_BITS_LINE_SKIP  FONT_CHARACTERS
+
+extern uint8_t fontBits[FONT_CHARACTERS * FONT_HEIGHT];
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif